@@ -0,0 +1,132 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "bench_util.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+uint64_t bench_now_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ull + (remainder * 1000000000ull) / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// Nearest-rank percentile on sorted samples
+static double percentile(const double *sorted, uint32_t count, double p) {
+    uint32_t rank = (uint32_t)(p / 100.0 * (double)count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+bench_summary_t bench_summarize(double *samples, uint32_t sample_count) {
+    bench_summary_t summary = {0};
+    if (sample_count == 0) return summary;
+
+    qsort(samples, sample_count, sizeof(samples[0]), compare_doubles);
+
+    double total = 0.0;
+    for (uint32_t i = 0; i < sample_count; ++i) {
+        total += samples[i];
+    }
+
+    summary.min = samples[0];
+    summary.max = samples[sample_count - 1];
+    summary.mean = total / (double)sample_count;
+    summary.p50 = percentile(samples, sample_count, 50.0);
+    summary.p90 = percentile(samples, sample_count, 90.0);
+    summary.p95 = percentile(samples, sample_count, 95.0);
+    summary.p99 = percentile(samples, sample_count, 99.0);
+
+    return summary;
+}
+
+bench_summary_t bench_run(const bench_config_t *config, bench_fn_t fn, void *user_data, uint32_t batch) {
+    for (uint32_t i = 0; i < config->warmup; ++i) {
+        fn(user_data, batch);
+    }
+
+    double *samples = malloc(sizeof(double) * config->samples);
+    if (!samples) {
+        fprintf(stderr, "Out of memory for benchmark samples\n");
+        exit(1);
+    }
+
+    for (uint32_t i = 0; i < config->samples; ++i) {
+        uint64_t start = bench_now_ns();
+        fn(user_data, batch);
+        uint64_t end = bench_now_ns();
+
+        samples[i] = (double)(end - start) / (double)batch;
+    }
+
+    bench_summary_t summary = bench_summarize(samples, config->samples);
+    free(samples);
+
+    return summary;
+}
+
+void bench_json_begin(FILE *out) {
+    fprintf(out, "  \"benchmarks\": [\n");
+}
+
+void bench_json_end(FILE *out) {
+    fprintf(out, "  ]\n");
+}
+
+void bench_json_summary(FILE *out, const char *name, uint32_t batch, uint32_t samples, const bench_summary_t *summary, bool last) {
+    fprintf(out,
+            "    {\"name\": \"%s\", \"unit\": \"ns\", \"batch\": %u, \"samples\": %u, "
+            "\"min\": %.1f, \"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p95\": %.1f, \"p99\": %.1f, \"max\": %.1f}%s\n",
+            name, batch, samples,
+            summary->min, summary->mean, summary->p50, summary->p90, summary->p95, summary->p99, summary->max,
+            last ? "" : ",");
+}
+
+bool bench_parse_u32(int argc, char **argv, int *index, const char *name, uint32_t *p_value) {
+    if (strcmp(argv[*index], name) != 0) return false;
+
+    if (*index + 1 >= argc) {
+        fprintf(stderr, "Missing value for %s\n", name);
+        exit(1);
+    }
+
+    char         *end = NULL;
+    unsigned long value = strtoul(argv[*index + 1], &end, 10);
+    if (!end || *end != '\0' || value == 0 || value > UINT32_MAX) {
+        fprintf(stderr, "Invalid value for %s: %s\n", name, argv[*index + 1]);
+        exit(1);
+    }
+
+    *p_value = (uint32_t)value;
+    *index += 1;
+    return true;
+}
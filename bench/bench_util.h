@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Timing, percentile and JSON helpers shared by the VRI benchmark programs.
+// Every sample is the time of one batch divided by the batch size, so very
+// cheap operations are not drowned out by the timer's own overhead.
+
+typedef void (*bench_fn_t)(void *user_data, uint32_t batch);
+
+typedef struct bench_summary {
+    double min;
+    double mean;
+    double p50;
+    double p90;
+    double p95;
+    double p99;
+    double max;
+} bench_summary_t;
+
+typedef struct bench_config {
+    uint32_t samples;
+    uint32_t warmup;
+} bench_config_t;
+
+uint64_t bench_now_ns(void);
+
+// Sorts `samples` in place
+bench_summary_t bench_summarize(double *samples, uint32_t sample_count);
+
+// Runs `fn` warmup + samples times and returns the per-operation summary in ns
+bench_summary_t bench_run(const bench_config_t *config, bench_fn_t fn, void *user_data, uint32_t batch);
+
+void bench_json_begin(FILE *out);
+void bench_json_end(FILE *out);
+void bench_json_summary(FILE *out, const char *name, uint32_t batch, uint32_t samples, const bench_summary_t *summary, bool last);
+
+// Parses "--name value" style unsigned options, returns false on malformed input
+bool bench_parse_u32(int argc, char **argv, int *index, const char *name, uint32_t *p_value);
@@ -0,0 +1,559 @@
+#include <vri/vri.h>
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Microbenchmarks for the VRI hot paths. Results are written as JSON so they
+// can be diffed between library versions, see README.md for the schema.
+
+#define MAX_COMMAND_BUFFERS 256
+#define BC_BLOCKS           256 // The BC benchmarks convert a strip of this many blocks
+#define MIP_SIZE            64  // The mip benchmarks filter the BC texels as a square of this size
+#define COLOR_TEXELS        1024 // Texels per color conversion
+#define WARM_PIPELINES      64   // Pipelines in the warm-up benchmark's manifest
+
+typedef struct bench_options {
+    bench_config_t config;
+    uint32_t       commands;        // Commands recorded per command buffer
+    uint32_t       command_buffers; // Command buffers per allocate/free and per submit
+    VriBackend     backend;
+    const char    *output_path;
+} bench_options_t;
+
+typedef struct bench_case {
+    const char *name;
+    bench_fn_t  fn;
+    uint32_t    batch;
+} bench_case_t;
+
+typedef struct bench_context {
+    const bench_options_t *options;
+    VriDeviceDesc          device_desc;
+    VriAdapterProps        adapter_props;
+    VriQueueDesc           queue_desc;
+    VriDevice              device;
+    VriQueue               queue;
+    VriCommandPool         command_pool;
+    VriCommandBuffer       command_buffers[MAX_COMMAND_BUFFERS];
+    VriPipeline            pipelines[2];
+    VriPipelineLibrary     libraries[2]; // Shaders, and the fragment output linked to them
+    VriShaderModule        shader_module;
+    uint8_t                shader_bytecode[4096];
+    void                  *p_manifest_data;
+    size_t                 manifest_size;
+    VriFence               fence;
+    uint64_t               fence_value;
+    uint8_t                bc_texels[BC_BLOCKS * 16 * 4];
+    uint8_t                bc_blocks[BC_BLOCKS * 16];
+    uint8_t                mip_texels[(MIP_SIZE / 2) * (MIP_SIZE / 2) * 4];
+    uint16_t               color_half_texels[COLOR_TEXELS * 4];
+    uint32_t               color_packed_texels[COLOR_TEXELS];
+} bench_context_t;
+
+static VriInputAssemblyDesc input_assembly_desc = {
+    .topology = VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+};
+
+static VriRasterizationStateDesc rasterization_state_desc = {
+    .fill_mode = VRI_FILL_MODE_FILL,
+    .cull_mode = VRI_CULL_MODE_BACK,
+    .front_face = VRI_FRONT_FACE_COUNTER_CLOCKWISE,
+};
+
+static VriMultisampleStateDesc multisample_state_desc = {
+    .sample_mask = 0xFFFFFFFF,
+    .sample_count = 1,
+};
+
+static VriShaderModuleDesc shader_desc = {
+    .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+    .p_entry_point = "main",
+};
+
+static VriGraphicsPipelineDesc pipeline_desc = {
+    .p_shaders = &shader_desc,
+    .shader_count = 1,
+    .p_input_assembly_state = &input_assembly_desc,
+    .p_rasterization_state = &rasterization_state_desc,
+    .p_multisample_state = &multisample_state_desc,
+};
+
+static void check(VriResult result, const char *what) {
+    if (VRI_ERROR(result)) {
+        fprintf(stderr, "%s failed (%d)\n", what, result);
+        exit(1);
+    }
+}
+
+static void bench_device_create(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    for (uint32_t i = 0; i < batch; ++i) {
+        VriDevice device = NULL;
+        check(vri_device_create(&ctx->device_desc, &device), "vri_device_create");
+        vri_device_destroy(device);
+    }
+}
+
+static void bench_command_buffers_allocate_free(void *user_data, uint32_t batch) {
+    bench_context_t             *ctx = user_data;
+    VriCommandBuffer             command_buffers[MAX_COMMAND_BUFFERS];
+    VriCommandBufferAllocateDesc desc = {
+        .command_pool = ctx->command_pool,
+        .command_buffer_count = ctx->options->command_buffers,
+    };
+
+    for (uint32_t i = 0; i < batch; ++i) {
+        check(vri_command_buffers_allocate(ctx->device, &desc, command_buffers), "vri_command_buffers_allocate");
+        vri_command_buffers_free(ctx->device, ctx->command_pool, desc.command_buffer_count, command_buffers);
+    }
+}
+
+static void record(bench_context_t *ctx, VriCommandBuffer command_buffer) {
+    VriCommandBufferBeginDesc begin_desc = {0};
+
+    vri_command_buffer_reset(command_buffer);
+    check(vri_command_buffer_begin(command_buffer, &begin_desc), "vri_command_buffer_begin");
+
+    // Alternate so no bind gets filtered as redundant
+    for (uint32_t i = 0; i < ctx->options->commands; ++i) {
+        vri_cmd_bind_pipeline(command_buffer, ctx->pipelines[i & 1]);
+    }
+
+    check(vri_command_buffer_end(command_buffer), "vri_command_buffer_end");
+}
+
+static void bench_command_buffer_record(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    for (uint32_t i = 0; i < batch; ++i) {
+        record(ctx, ctx->command_buffers[0]);
+    }
+}
+
+// Per command cost of the recording path, on a command buffer left recording by main
+static void bench_cmd_bind_pipeline(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    for (uint32_t i = 0; i < batch; ++i) {
+        vri_cmd_bind_pipeline(ctx->command_buffers[0], ctx->pipelines[i & 1]);
+    }
+}
+
+static void bench_queue_submit(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+
+    for (uint32_t i = 0; i < batch; ++i) {
+        VriFenceSignalDesc signal_desc = {
+            .fence = ctx->fence,
+            .value = ++ctx->fence_value,
+        };
+
+        VriQueueSubmitDesc submit_desc = {
+            .p_command_buffers = ctx->command_buffers,
+            .command_buffer_count = ctx->options->command_buffers,
+            .p_fences_signal = &signal_desc,
+            .fence_signal_count = 1,
+        };
+
+        check(vri_queue_submit(ctx->queue, &submit_desc, 1), "vri_queue_submit");
+    }
+}
+
+static void bench_fences_wait_signaled(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    uint64_t         value = ctx->fence_value;
+
+    for (uint32_t i = 0; i < batch; ++i) {
+        check(vri_fences_wait(ctx->device, &ctx->fence, &value, 1, true, UINT64_MAX), "vri_fences_wait");
+    }
+}
+
+static void bench_fences_wait_pending(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    uint64_t         value = ctx->fence_value + 1;
+
+    // Zero timeout: measures the cost of polling a fence the GPU hasn't reached
+    for (uint32_t i = 0; i < batch; ++i) {
+        if (vri_fences_wait(ctx->device, &ctx->fence, &value, 1, true, 0) != VRI_TIMEOUT) {
+            fprintf(stderr, "Pending fence unexpectedly signaled\n");
+            exit(1);
+        }
+    }
+}
+
+static void bench_pipeline_create(void *user_data, uint32_t batch) {
+    bench_context_t *ctx = user_data;
+    for (uint32_t i = 0; i < batch; ++i) {
+        VriPipeline pipeline = NULL;
+        check(vri_pipeline_create_graphics(ctx->device, &pipeline_desc, &pipeline), "vri_pipeline_create_graphics");
+        vri_pipeline_destroy(ctx->device, pipeline);
+    }
+}
+
+// Every create finds the module made in setup, so this is the deduplication hit path
+static void bench_shader_module_create(void *user_data, uint32_t batch) {
+    bench_context_t    *ctx = user_data;
+    VriShaderModuleDesc desc = {
+        .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+        .size = sizeof(ctx->shader_bytecode),
+        .p_bytecode = ctx->shader_bytecode,
+        .p_entry_point = "main",
+    };
+
+    for (uint32_t i = 0; i < batch; ++i) {
+        VriShaderModule shader_module = NULL;
+        check(vri_shader_module_create(ctx->device, &desc, &shader_module), "vri_shader_module_create");
+        vri_shader_module_destroy(ctx->device, shader_module);
+    }
+}
+
+// Warms up and releases a manifest of permutations of one module, on every core
+static void bench_pipelines_warm_up(void *user_data, uint32_t batch) {
+    bench_context_t      *ctx = user_data;
+    VriPipelineWarmUpDesc desc = {
+        .p_data = ctx->p_manifest_data,
+        .size = ctx->manifest_size,
+    };
+
+    for (uint32_t i = 0; i < batch; i += WARM_PIPELINES) {
+        check(vri_pipelines_warm_up(ctx->device, &desc), "vri_pipelines_warm_up");
+        vri_pipelines_warm_release(ctx->device);
+    }
+}
+
+static void bench_pipeline_link(void *user_data, uint32_t batch) {
+    bench_context_t    *ctx = user_data;
+    VriPipelineLinkDesc desc = {
+        .p_libraries = ctx->libraries,
+        .library_count = VRI_ARRAY_SIZE(ctx->libraries),
+    };
+
+    for (uint32_t i = 0; i < batch; ++i) {
+        VriPipeline pipeline = NULL;
+        check(vri_pipeline_link(ctx->device, &desc, &pipeline), "vri_pipeline_link");
+        vri_pipeline_destroy(ctx->device, pipeline);
+    }
+}
+
+// Per block cost of the CPU-side BC conversion, on a 4 texel high strip
+static void bc_convert(bench_context_t *ctx, VriFormat format, uint32_t batch, bool encode) {
+    uint32_t            block_size = vri_format_get_info(format)->block_size;
+    VriBlockConvertDesc desc = {
+        .format = format,
+        .width = batch * 4,
+        .height = 4,
+        .p_src = encode ? (const void *)ctx->bc_texels : ctx->bc_blocks,
+        .src_row_pitch = encode ? batch * 16 : batch * block_size,
+        .p_dst = encode ? (void *)ctx->bc_blocks : ctx->bc_texels,
+        .dst_row_pitch = encode ? batch * block_size : batch * 16,
+    };
+    check(encode ? vri_bc_encode(&desc) : vri_bc_decode(&desc), encode ? "vri_bc_encode" : "vri_bc_decode");
+}
+
+static void bench_bc1_encode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC1_UNORM, batch, true);
+}
+
+static void bench_bc1_decode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC1_UNORM, batch, false);
+}
+
+static void bench_bc3_encode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC3_UNORM, batch, true);
+}
+
+static void bench_bc3_decode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC3_UNORM, batch, false);
+}
+
+static void bench_bc7_encode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC7_UNORM, batch, true);
+}
+
+static void bench_bc7_decode(void *user_data, uint32_t batch) {
+    bc_convert(user_data, VRI_FORMAT_BC7_UNORM, batch, false);
+}
+
+// Per destination texel cost of generating one sRGB mip level
+static void mip_generate(bench_context_t *ctx, VriMipFilter filter) {
+    VriMipGenerateDesc desc = {
+        .format = VRI_FORMAT_R8G8B8A8_SRGB,
+        .filter = filter,
+        .width = MIP_SIZE,
+        .height = MIP_SIZE,
+        .p_src = ctx->bc_texels,
+        .src_row_pitch = MIP_SIZE * 4,
+        .p_dst = ctx->mip_texels,
+        .dst_row_pitch = MIP_SIZE / 2 * 4,
+    };
+    check(vri_mip_generate(&desc), "vri_mip_generate");
+}
+
+static void bench_mip_generate_box(void *user_data, uint32_t batch) {
+    (void)batch;
+    mip_generate(user_data, VRI_MIP_FILTER_BOX);
+}
+
+static void bench_mip_generate_kaiser(void *user_data, uint32_t batch) {
+    (void)batch;
+    mip_generate(user_data, VRI_MIP_FILTER_KAISER);
+}
+
+// Per texel cost of the conversions an HDR capture runs, scRGB to HDR10 and HDR10 to sRGB
+static void color_convert(bench_context_t *ctx, bool to_hdr10) {
+    VriColorConvertDesc desc = {
+        .src_format = to_hdr10 ? VRI_FORMAT_R16G16B16A16_FLOAT : VRI_FORMAT_R10G10B10A2_UNORM,
+        .src_color_space = to_hdr10 ? VRI_COLORSPACE_EXTENDED_SRGB_LINEAR : VRI_COLORSPACE_HDR10_ST2084,
+        .dst_format = to_hdr10 ? VRI_FORMAT_R10G10B10A2_UNORM : VRI_FORMAT_R8G8B8A8_SRGB,
+        .dst_color_space = to_hdr10 ? VRI_COLORSPACE_HDR10_ST2084 : VRI_COLORSPACE_SRGB_NONLINEAR,
+        .width = COLOR_TEXELS,
+        .height = 1,
+        .p_src = to_hdr10 ? (const void *)ctx->color_half_texels : ctx->color_packed_texels,
+        .src_row_pitch = to_hdr10 ? COLOR_TEXELS * 8 : COLOR_TEXELS * 4,
+        .p_dst = to_hdr10 ? (void *)ctx->color_packed_texels : ctx->mip_texels,
+        .dst_row_pitch = COLOR_TEXELS * 4,
+    };
+    check(vri_color_convert(&desc), "vri_color_convert");
+}
+
+static void bench_color_convert_to_hdr10(void *user_data, uint32_t batch) {
+    (void)batch;
+    color_convert(user_data, true);
+}
+
+static void bench_color_convert_to_srgb(void *user_data, uint32_t batch) {
+    (void)batch;
+    color_convert(user_data, false);
+}
+
+static void setup(bench_context_t *ctx) {
+    uint32_t adapter_count = 1;
+    check(vri_adapters_enumerate(&ctx->adapter_props, &adapter_count), "vri_adapters_enumerate");
+
+    ctx->queue_desc = (VriQueueDesc){.type = VRI_QUEUE_TYPE_GRAPHICS, .count = 1};
+    ctx->device_desc = (VriDeviceDesc){
+        .backend = ctx->options->backend,
+        .p_adapter_props = &ctx->adapter_props,
+        .p_queue_descs = &ctx->queue_desc,
+        .queue_desc_count = 1,
+    };
+
+    check(vri_device_create(&ctx->device_desc, &ctx->device), "vri_device_create");
+    vri_device_get_queue(ctx->device, VRI_QUEUE_TYPE_GRAPHICS, 0, &ctx->queue);
+
+    VriCommandPoolDesc pool_desc = {
+        .queue_type = VRI_QUEUE_TYPE_GRAPHICS,
+        .flags = VRI_COMMAND_POOL_FLAG_BIT_RESET_COMMAND_BUFFER,
+    };
+    check(vri_command_pool_create(ctx->device, &pool_desc, &ctx->command_pool), "vri_command_pool_create");
+
+    VriCommandBufferAllocateDesc allocate_desc = {
+        .command_pool = ctx->command_pool,
+        .command_buffer_count = ctx->options->command_buffers,
+    };
+    check(vri_command_buffers_allocate(ctx->device, &allocate_desc, ctx->command_buffers), "vri_command_buffers_allocate");
+
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->pipelines); ++i) {
+        check(vri_pipeline_create_graphics(ctx->device, &pipeline_desc, &ctx->pipelines[i]), "vri_pipeline_create_graphics");
+    }
+
+    const VriPipelineLibraryFlags library_parts[] = {
+        VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT | VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION | VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER,
+        VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT,
+    };
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->libraries); ++i) {
+        VriPipelineLibraryDesc library_desc = {.parts = library_parts[i], .p_desc = &pipeline_desc};
+        check(vri_pipeline_library_create(ctx->device, &library_desc, &ctx->libraries[i]), "vri_pipeline_library_create");
+    }
+
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->shader_bytecode); ++i) {
+        ctx->shader_bytecode[i] = (uint8_t)(i * 31 + (i >> 8));
+    }
+    VriShaderModuleDesc shader_module_desc = {
+        .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+        .size = sizeof(ctx->shader_bytecode),
+        .p_bytecode = ctx->shader_bytecode,
+        .p_entry_point = "main",
+    };
+    check(vri_shader_module_create(ctx->device, &shader_module_desc, &ctx->shader_module), "vri_shader_module_create");
+
+    // Specialization constants make the permutations, every one a separate manifest entry
+    VriPipelineManifest manifest = NULL;
+    check(vri_pipeline_manifest_create(ctx->device, &manifest), "vri_pipeline_manifest_create");
+    for (uint32_t i = 0; i < WARM_PIPELINES; ++i) {
+        VriSpecializationConstant constant = {.constant_id = 0, .value = i};
+        VriShaderModuleDesc       stage = {
+            .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+            .p_specialization_constants = &constant,
+            .specialization_constant_count = 1,
+            .module = ctx->shader_module,
+        };
+        VriGraphicsPipelineDesc desc = {
+            .p_shaders = &stage,
+            .shader_count = 1,
+            .p_input_assembly_state = &input_assembly_desc,
+            .p_rasterization_state = &rasterization_state_desc,
+            .p_multisample_state = &multisample_state_desc,
+        };
+        VriPipeline pipeline = NULL;
+        check(vri_pipeline_create_graphics(ctx->device, &desc, &pipeline), "vri_pipeline_create_graphics");
+        vri_pipeline_destroy(ctx->device, pipeline);
+    }
+    check(vri_pipeline_manifest_get_data(manifest, &ctx->manifest_size, NULL), "vri_pipeline_manifest_get_data");
+    ctx->p_manifest_data = malloc(ctx->manifest_size);
+    if (!ctx->p_manifest_data) check(VRI_ERROR_OUT_OF_MEMORY, "malloc");
+    check(vri_pipeline_manifest_get_data(manifest, &ctx->manifest_size, ctx->p_manifest_data), "vri_pipeline_manifest_get_data");
+    vri_pipeline_manifest_destroy(ctx->device, manifest);
+
+    ctx->fence_value = 1;
+    check(vri_fence_create(ctx->device, ctx->fence_value, &ctx->fence), "vri_fence_create");
+
+    // Smooth gradients with some noise, so blocks get distinct endpoints like real content
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->bc_texels); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        ctx->bc_texels[i] = (uint8_t)(i / 4 + (i & 3) * 64 + (seed >> 29));
+    }
+
+    // scRGB halves from 1/64 to 16 times reference white
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->color_half_texels); ++i) {
+        ctx->color_half_texels[i] = (uint16_t)(0x2400 + i * 0x2800 / VRI_ARRAY_SIZE(ctx->color_half_texels));
+    }
+}
+
+static void teardown(bench_context_t *ctx) {
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->pipelines); ++i) {
+        vri_pipeline_destroy(ctx->device, ctx->pipelines[i]);
+    }
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(ctx->libraries); ++i) {
+        vri_pipeline_library_destroy(ctx->device, ctx->libraries[i]);
+    }
+    vri_shader_module_destroy(ctx->device, ctx->shader_module);
+    free(ctx->p_manifest_data);
+    vri_fence_destroy(ctx->device, ctx->fence);
+    vri_command_buffers_free(ctx->device, ctx->command_pool, ctx->options->command_buffers, ctx->command_buffers);
+    vri_command_pool_destroy(ctx->device, ctx->command_pool);
+    vri_device_destroy(ctx->device);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--samples N] [--warmup N] [--commands N] [--command-buffers N] [--output FILE]\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    bench_options_t options = {
+        .config = {.samples = 1000, .warmup = 100},
+        .commands = 256,
+        .command_buffers = 16,
+        .backend = VRI_BACKEND_NONE,
+        .output_path = NULL,
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        if (bench_parse_u32(argc, argv, &i, "--samples", &options.config.samples)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--warmup", &options.config.warmup)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--commands", &options.commands)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--command-buffers", &options.command_buffers)) continue;
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+            continue;
+        }
+
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (options.command_buffers > MAX_COMMAND_BUFFERS) {
+        fprintf(stderr, "--command-buffers is limited to %d\n", MAX_COMMAND_BUFFERS);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (options.output_path) {
+        out = fopen(options.output_path, "w");
+        if (!out) {
+            fprintf(stderr, "Couldn't open %s\n", options.output_path);
+            return 1;
+        }
+    }
+
+    bench_context_t ctx = {.options = &options};
+    setup(&ctx);
+
+    // Pre-record so the submit benchmark only measures the submission itself
+    for (uint32_t i = 0; i < options.command_buffers; ++i) {
+        record(&ctx, ctx.command_buffers[i]);
+    }
+
+    const bench_config_t *config = &options.config;
+    const bench_case_t    benchmarks[] = {
+        {"device_create_destroy", bench_device_create, 1},
+        {"command_buffers_allocate_free", bench_command_buffers_allocate_free, 1},
+        {"command_buffer_record", bench_command_buffer_record, 1},
+        {"cmd_bind_pipeline", bench_cmd_bind_pipeline, 256},
+        {"queue_submit", bench_queue_submit, 1},
+        {"fences_wait_signaled", bench_fences_wait_signaled, 64},
+        {"fences_wait_pending", bench_fences_wait_pending, 64},
+        {"pipeline_create_graphics", bench_pipeline_create, 1},
+        {"pipeline_link", bench_pipeline_link, 1},
+        {"shader_module_create", bench_shader_module_create, 1},
+        {"pipelines_warm_up", bench_pipelines_warm_up, WARM_PIPELINES},
+        {"bc1_encode", bench_bc1_encode, BC_BLOCKS},
+        {"bc1_decode", bench_bc1_decode, BC_BLOCKS},
+        {"bc3_encode", bench_bc3_encode, BC_BLOCKS},
+        {"bc3_decode", bench_bc3_decode, BC_BLOCKS},
+        {"bc7_encode", bench_bc7_encode, BC_BLOCKS},
+        {"bc7_decode", bench_bc7_decode, BC_BLOCKS},
+        {"mip_generate_box", bench_mip_generate_box, (MIP_SIZE / 2) * (MIP_SIZE / 2)},
+        {"mip_generate_kaiser", bench_mip_generate_kaiser, (MIP_SIZE / 2) * (MIP_SIZE / 2)},
+        {"color_convert_to_hdr10", bench_color_convert_to_hdr10, COLOR_TEXELS},
+        {"color_convert_to_srgb", bench_color_convert_to_srgb, COLOR_TEXELS},
+    };
+    bench_summary_t summaries[VRI_ARRAY_SIZE(benchmarks)];
+
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(benchmarks); ++i) {
+        // The record benchmark leaves command buffer 0 executable, re-record before submitting
+        if (benchmarks[i].fn == bench_queue_submit) {
+            record(&ctx, ctx.command_buffers[0]);
+        }
+
+        VriCommandBufferBeginDesc begin_desc = {0};
+        if (benchmarks[i].fn == bench_cmd_bind_pipeline) {
+            vri_command_buffer_reset(ctx.command_buffers[0]);
+            check(vri_command_buffer_begin(ctx.command_buffers[0], &begin_desc), "vri_command_buffer_begin");
+        }
+
+        summaries[i] = bench_run(config, benchmarks[i].fn, &ctx, benchmarks[i].batch);
+
+        if (benchmarks[i].fn == bench_cmd_bind_pipeline) {
+            check(vri_command_buffer_end(ctx.command_buffers[0]), "vri_command_buffer_end");
+        }
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"program\": \"vri-bench\",\n");
+    fprintf(out, "  \"vri_version\": \"%u.%u.%u\",\n", VRI_VERSION_MAJOR(VRI_HEADER_VERSION), VRI_VERSION_MINOR(VRI_HEADER_VERSION), VRI_VERSION_PATCH(VRI_HEADER_VERSION));
+    fprintf(out, "  \"backend\": %d,\n", (int)options.backend);
+#if VRI_SINGLE_BACKEND
+    fprintf(out, "  \"dispatch\": \"direct\",\n");
+#else
+    fprintf(out, "  \"dispatch\": \"table\",\n");
+#endif
+    fprintf(out, "  \"config\": {\"samples\": %u, \"warmup\": %u, \"commands\": %u, \"command_buffers\": %u},\n",
+            config->samples, config->warmup, options.commands, options.command_buffers);
+
+    bench_json_begin(out);
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(benchmarks); ++i) {
+        bench_json_summary(out, benchmarks[i].name, benchmarks[i].batch, config->samples, &summaries[i], i + 1 == VRI_ARRAY_SIZE(benchmarks));
+    }
+    bench_json_end(out);
+    fprintf(out, "}\n");
+
+    teardown(&ctx);
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
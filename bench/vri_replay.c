@@ -0,0 +1,888 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <vri/vri.h>
+
+#include "bench_util.h"
+#include "vri_capture_format.h"
+#include "vri_serialize.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+// Replays a trace written by the capture layer. The trace is memory-mapped and
+// decoded in place: blobs such as shader bytecode are handed to the backend
+// straight out of the mapping. Every present ends a frame, and the CPU time
+// between presents is reported in the same JSON layout as the benchmarks.
+
+#define REPLAY_SCRATCH_SIZE (1u << 20)
+
+typedef enum {
+    PACING_FAST,     // Issue every call as soon as the previous one returns
+    PACING_ORIGINAL, // Hold every call back until its captured timestamp
+} pacing_t;
+
+typedef struct replay_options {
+    const char *trace_path;
+    VriBackend  backend;
+    pacing_t    pacing;
+    uint32_t    loops;
+    const char *output_path;
+} replay_options_t;
+
+typedef struct blob {
+    const void *p_data;
+    size_t      size;
+} blob_t;
+
+typedef struct replay {
+    const uint8_t *p_trace;
+    size_t         trace_size;
+    VriBackend     backend;
+    VriDevice      device;
+    blob_t        *blobs;
+    uint32_t       blob_capacity;
+    void         **handles;
+    uint32_t       handle_capacity;
+    double        *frame_samples;
+    uint32_t       frame_count;
+    uint32_t       frame_capacity;
+    uint64_t       frame_start;
+    uint64_t       record_count;
+    uint8_t       *p_scratch;
+#if defined(_WIN32)
+    HWND hwnd;
+#endif
+} replay_t;
+
+static void fail(const char *what) {
+    fprintf(stderr, "%s\n", what);
+    exit(1);
+}
+
+static void check(VriResult result, const char *what) {
+    if (VRI_ERROR(result)) {
+        fprintf(stderr, "%s failed (%d)\n", what, result);
+        exit(1);
+    }
+}
+
+static void *grow_array(void *array, uint32_t *p_capacity, uint32_t required, size_t element_size) {
+    if (required < *p_capacity) return array;
+
+    uint32_t capacity = *p_capacity ? *p_capacity : 256;
+    while (capacity <= required) {
+        capacity *= 2;
+    }
+
+    uint8_t *grown = realloc(array, capacity * element_size);
+    if (!grown) fail("Out of memory");
+    memset(grown + *p_capacity * element_size, 0, (capacity - *p_capacity) * element_size);
+
+    *p_capacity = capacity;
+    return grown;
+}
+
+static const void *resolve_blob(void *p_user_data, uint32_t id, size_t *p_size) {
+    replay_t *replay = p_user_data;
+    if (id >= replay->blob_capacity) return NULL;
+
+    *p_size = replay->blobs[id].size;
+    return replay->blobs[id].p_data;
+}
+
+static void *resolve_handle(void *p_user_data, uint32_t id) {
+    replay_t *replay = p_user_data;
+    return id < replay->handle_capacity ? replay->handles[id] : NULL;
+}
+
+static void set_handle(replay_t *replay, uint32_t id, void *p_handle) {
+    if (!id) return;
+    replay->handles = grow_array(replay->handles, &replay->handle_capacity, id, sizeof(void *));
+    replay->handles[id] = p_handle;
+}
+
+// Frames are timed present to present, the first present only starts the clock
+static void end_frame(replay_t *replay) {
+    uint64_t now = bench_now_ns();
+    if (!replay->frame_start) {
+        replay->frame_start = now;
+        return;
+    }
+
+    replay->frame_samples = grow_array(replay->frame_samples, &replay->frame_capacity, replay->frame_count, sizeof(double));
+    replay->frame_samples[replay->frame_count++] = (double)(now - replay->frame_start);
+    replay->frame_start = now;
+}
+
+#if defined(_WIN32)
+// D3D11 swapchains need a window, the trace can't carry one
+static HWND replay_window(replay_t *replay, uint32_t width, uint32_t height) {
+    if (replay->hwnd) return replay->hwnd;
+
+    WNDCLASSA window_class = {
+        .lpfnWndProc = DefWindowProcA,
+        .hInstance = GetModuleHandleA(NULL),
+        .lpszClassName = "vri-replay",
+    };
+    RegisterClassA(&window_class);
+
+    replay->hwnd = CreateWindowA("vri-replay", "vri-replay", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT,
+                                 (int)width, (int)height, NULL, NULL, window_class.hInstance, NULL);
+    return replay->hwnd;
+}
+#endif
+
+static void replay_device_create(replay_t *replay, VriReader *reader) {
+    if (replay->device) fail("Trace creates a second device");
+
+    vri_read_u32(reader); // Captured backend, replay uses its own
+    vri_read_u32(reader); // Captured validation, replay runs without
+
+    VriQueueDesc queue_descs[VRI_QUEUE_TYPE_COUNT];
+    uint32_t     queue_desc_count = 0;
+    uint32_t     queue_ids[VRI_QUEUE_TYPE_COUNT][MAX_QUEUES_PER_TYPE] = {{0}};
+
+    for (uint32_t i = 0; i < VRI_QUEUE_TYPE_COUNT; ++i) {
+        uint32_t count = vri_read_u32(reader);
+        for (uint32_t j = 0; j < count; ++j) {
+            uint32_t id = vri_read_u32(reader);
+            if (j < VRI_ARRAY_SIZE(queue_ids[i])) queue_ids[i][j] = id;
+        }
+        if (count) {
+            queue_descs[queue_desc_count++] = (VriQueueDesc){.type = (VriQueueType)i, .count = VRI_MIN(count, (uint32_t)MAX_QUEUES_PER_TYPE)};
+        }
+    }
+
+    VriAdapterProps adapter_props;
+    uint32_t        adapter_count = 1;
+    check(vri_adapters_enumerate(&adapter_props, &adapter_count), "vri_adapters_enumerate");
+
+    VriDeviceDesc device_desc = {
+        .backend = replay->backend,
+        .p_adapter_props = &adapter_props,
+        .p_queue_descs = queue_descs,
+        .queue_desc_count = queue_desc_count,
+    };
+    check(vri_device_create(&device_desc, &replay->device), "vri_device_create");
+
+    for (uint32_t i = 0; i < queue_desc_count; ++i) {
+        for (uint32_t j = 0; j < queue_descs[i].count; ++j) {
+            VriQueue queue;
+            vri_device_get_queue(replay->device, queue_descs[i].type, j, &queue);
+            set_handle(replay, queue_ids[queue_descs[i].type][j], queue);
+        }
+    }
+}
+
+static const VriFenceWaitDesc *read_fence_values(VriReader *reader, uint32_t *p_count) {
+    *p_count = vri_read_u32(reader);
+    VriFenceWaitDesc *fences = vri_reader_scratch(reader, sizeof(VriFenceWaitDesc) * *p_count);
+    for (uint32_t i = 0; fences && i < *p_count; ++i) {
+        fences[i].fence = (VriFence)vri_read_handle(reader);
+        fences[i].value = vri_read_u64(reader);
+    }
+    return fences;
+}
+
+static void read_texture_location(VriReader *reader, VriTextureLocation *p_location) {
+    p_location->mip_level = vri_read_u32(reader);
+    p_location->array_layer = vri_read_u32(reader);
+    p_location->x = vri_read_u32(reader);
+    p_location->y = vri_read_u32(reader);
+    p_location->z = vri_read_u32(reader);
+}
+
+static void replay_record(replay_t *replay, const VriCaptureRecordHeader *header, const uint8_t *p_payload) {
+    VriReaderCallbacks callbacks = {
+        .pfn_resolve_blob = resolve_blob,
+        .pfn_resolve_handle = resolve_handle,
+        .p_user_data = replay,
+    };
+    VriReader reader;
+    vri_reader_init(&reader, p_payload, header->size, replay->p_scratch, REPLAY_SCRATCH_SIZE, &callbacks);
+
+    VriDevice device = replay->device;
+    if (header->op > VRI_CAPTURE_OP_DEVICE_CREATE && !device) fail("Trace uses the device before creating it");
+
+    switch ((VriCaptureOp)header->op) {
+    case VRI_CAPTURE_OP_BLOB: {
+        uint32_t id = vri_read_u32(&reader);
+        vri_read_u32(&reader);
+        uint64_t size = vri_read_u64(&reader);
+        replay->blobs = grow_array(replay->blobs, &replay->blob_capacity, id, sizeof(blob_t));
+        replay->blobs[id].p_data = vri_read_bytes(&reader, (size_t)size);
+        replay->blobs[id].size = (size_t)size;
+        break;
+    }
+    case VRI_CAPTURE_OP_DEVICE_CREATE:
+        replay_device_create(replay, &reader);
+        break;
+    case VRI_CAPTURE_OP_DEVICE_DESTROY:
+        vri_device_destroy(device);
+        replay->device = NULL;
+        break;
+    case VRI_CAPTURE_OP_COMMAND_POOL_CREATE: {
+        VriCommandPoolDesc desc;
+        desc.queue_type = (VriQueueType)vri_read_u32(&reader);
+        desc.flags = vri_read_u32(&reader);
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriCommandPool command_pool;
+        check(vri_command_pool_create(device, &desc, &command_pool), "vri_command_pool_create");
+        set_handle(replay, id, command_pool);
+        break;
+    }
+    case VRI_CAPTURE_OP_COMMAND_POOL_DESTROY:
+        vri_command_pool_destroy(device, (VriCommandPool)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_COMMAND_POOL_RESET: {
+        VriCommandPool command_pool = (VriCommandPool)vri_read_handle(&reader);
+        vri_command_pool_reset(device, command_pool, vri_read_u32(&reader));
+        break;
+    }
+    case VRI_CAPTURE_OP_COMMAND_BUFFERS_ALLOCATE: {
+        VriCommandBufferAllocateDesc desc;
+        desc.command_pool = (VriCommandPool)vri_read_handle(&reader);
+        desc.command_buffer_count = vri_read_u32(&reader);
+        const uint32_t   *ids = vri_read_bytes(&reader, sizeof(uint32_t) * desc.command_buffer_count);
+        VriCommandBuffer *command_buffers = vri_reader_scratch(&reader, sizeof(VriCommandBuffer) * desc.command_buffer_count);
+        if (!ids || !command_buffers || !desc.command_buffer_count || !ids[0]) break;
+
+        check(vri_command_buffers_allocate(device, &desc, command_buffers), "vri_command_buffers_allocate");
+        for (uint32_t i = 0; i < desc.command_buffer_count; ++i) {
+            set_handle(replay, ids[i], command_buffers[i]);
+        }
+        break;
+    }
+    case VRI_CAPTURE_OP_COMMAND_BUFFERS_FREE: {
+        VriCommandPool    command_pool = (VriCommandPool)vri_read_handle(&reader);
+        uint32_t          count = vri_read_u32(&reader);
+        VriCommandBuffer *command_buffers = vri_reader_scratch(&reader, sizeof(VriCommandBuffer) * count);
+        for (uint32_t i = 0; command_buffers && i < count; ++i) {
+            command_buffers[i] = vri_read_handle(&reader);
+        }
+        if (command_buffers) vri_command_buffers_free(device, command_pool, count, command_buffers);
+        break;
+    }
+    case VRI_CAPTURE_OP_PIPELINE_LAYOUT_CREATE: {
+        VriPipelineLayoutDesc desc = {0};
+        VriPipelineLayout     pipeline_layout = VRI_NULL_HANDLE;
+        check(vri_pipeline_layout_create(device, &desc, &pipeline_layout), "vri_pipeline_layout_create");
+        break;
+    }
+    case VRI_CAPTURE_OP_PIPELINE_CREATE_GRAPHICS: {
+        VriGraphicsPipelineDesc desc;
+        check(vri_read_graphics_pipeline_desc(&reader, &desc), "Decoding a graphics pipeline");
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriPipeline pipeline;
+        check(vri_pipeline_create_graphics(device, &desc, &pipeline), "vri_pipeline_create_graphics");
+        set_handle(replay, id, pipeline);
+        break;
+    }
+    case VRI_CAPTURE_OP_PIPELINE_CREATE_COMPUTE: {
+        VriComputePipelineDesc desc;
+        check(vri_read_compute_pipeline_desc(&reader, &desc), "Decoding a compute pipeline");
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriPipeline pipeline;
+        check(vri_pipeline_create_compute(device, &desc, &pipeline), "vri_pipeline_create_compute");
+        set_handle(replay, id, pipeline);
+        break;
+    }
+    case VRI_CAPTURE_OP_PIPELINE_DESTROY:
+        vri_pipeline_destroy(device, (VriPipeline)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_PIPELINE_LIBRARY_CREATE: {
+        VriGraphicsPipelineDesc desc;
+        VriPipelineLibraryFlags parts = vri_read_u32(&reader);
+        check(vri_read_graphics_pipeline_desc(&reader, &desc), "Decoding a pipeline library");
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriPipelineLibraryDesc library_desc = {.parts = parts, .p_desc = &desc};
+        VriPipelineLibrary     library;
+        check(vri_pipeline_library_create(device, &library_desc, &library), "vri_pipeline_library_create");
+        set_handle(replay, id, library);
+        break;
+    }
+    case VRI_CAPTURE_OP_PIPELINE_LIBRARY_DESTROY:
+        vri_pipeline_library_destroy(device, (VriPipelineLibrary)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_PIPELINE_LINK: {
+        VriPipelineLinkDesc desc = {.library_count = vri_read_u32(&reader)};
+        VriPipelineLibrary *libraries = vri_reader_scratch(&reader, sizeof(VriPipelineLibrary) * desc.library_count);
+        if (desc.library_count && !libraries) fail("Linked libraries don't fit in the replay scratch memory");
+        for (uint32_t i = 0; i < desc.library_count; ++i) {
+            libraries[i] = (VriPipelineLibrary)vri_read_handle(&reader);
+        }
+        desc.p_libraries = libraries;
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriPipeline pipeline;
+        check(vri_pipeline_link(device, &desc, &pipeline), "vri_pipeline_link");
+        set_handle(replay, id, pipeline);
+        break;
+    }
+    case VRI_CAPTURE_OP_SHADER_MODULE_CREATE: {
+        VriShaderModuleDesc desc;
+        check(vri_read_shader_module_desc(&reader, &desc), "Decoding a shader module");
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriShaderModule shader_module;
+        check(vri_shader_module_create(device, &desc, &shader_module), "vri_shader_module_create");
+        set_handle(replay, id, shader_module);
+        break;
+    }
+    case VRI_CAPTURE_OP_SHADER_MODULE_DESTROY:
+        vri_shader_module_destroy(device, (VriShaderModule)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_TEXTURE_CREATE: {
+        VriTextureDesc desc;
+        desc.type = (VriTextureType)vri_read_u32(&reader);
+        desc.format = (VriFormat)vri_read_u32(&reader);
+        desc.width = vri_read_u32(&reader);
+        desc.height = vri_read_u32(&reader);
+        desc.depth = vri_read_u32(&reader);
+        desc.usage = vri_read_u32(&reader);
+        desc.sample_count = vri_read_u32(&reader);
+        desc.mip_count = vri_read_u32(&reader);
+        desc.layer_count = vri_read_u32(&reader);
+        desc.memory_type = (VriMemoryType)vri_read_u32(&reader);
+
+        uint32_t            initial_data_count = vri_read_u32(&reader);
+        VriSubresourceData *initial_data = vri_reader_scratch(&reader, sizeof(VriSubresourceData) * initial_data_count);
+        if (initial_data_count && !initial_data) fail("Texture initial data doesn't fit in the replay scratch memory");
+        for (uint32_t i = 0; i < initial_data_count; ++i) {
+            size_t size = 0;
+            initial_data[i].row_pitch = vri_read_u32(&reader);
+            initial_data[i].slice_pitch = vri_read_u32(&reader);
+            initial_data[i].p_data = vri_read_blob(&reader, &size);
+        }
+        desc.p_initial_data = initial_data_count ? initial_data : NULL;
+
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriTexture texture;
+        check(vri_texture_create(device, &desc, &texture), "vri_texture_create");
+        set_handle(replay, id, texture);
+        break;
+    }
+    case VRI_CAPTURE_OP_TEXTURE_DESTROY:
+        vri_texture_destroy(device, (VriTexture)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_TILE_HEAP_CREATE: {
+        VriTileHeapDesc desc = {.tile_count = vri_read_u32(&reader)};
+        uint32_t        id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriTileHeap tile_heap;
+        check(vri_tile_heap_create(device, &desc, &tile_heap), "vri_tile_heap_create");
+        set_handle(replay, id, tile_heap);
+        break;
+    }
+    case VRI_CAPTURE_OP_TILE_HEAP_DESTROY:
+        vri_tile_heap_destroy(device, (VriTileHeap)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_FENCE_CREATE: {
+        uint64_t initial_value = vri_read_u64(&reader);
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriFence fence;
+        check(vri_fence_create(device, initial_value, &fence), "vri_fence_create");
+        set_handle(replay, id, fence);
+        break;
+    }
+    case VRI_CAPTURE_OP_FENCE_DESTROY:
+        vri_fence_destroy(device, (VriFence)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_FENCE_GET_VALUE:
+        vri_fence_get_value(device, (VriFence)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_FENCES_WAIT: {
+        uint32_t  count = vri_read_u32(&reader);
+        VriBool   wait_all = vri_read_u32(&reader) != 0;
+        uint64_t  timeout_ns = vri_read_u64(&reader);
+        VriFence *fences = vri_reader_scratch(&reader, sizeof(VriFence) * count);
+        uint64_t *values = vri_reader_scratch(&reader, sizeof(uint64_t) * count);
+        if (count && (!fences || !values)) break;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            fences[i] = (VriFence)vri_read_handle(&reader);
+            values[i] = vri_read_u64(&reader);
+        }
+        vri_fences_wait(device, fences, values, count, wait_all, timeout_ns);
+        break;
+    }
+    case VRI_CAPTURE_OP_SWAPCHAIN_CREATE: {
+        VriWindowDesc    window_desc = {0};
+        VriSwapchainDesc desc;
+
+        // Read one field at a time, initializer lists don't order their side effects
+        desc.p_window_desc = &window_desc;
+        desc.width = vri_read_u32(&reader);
+        desc.height = vri_read_u32(&reader);
+        desc.format = (VriFormat)vri_read_u32(&reader);
+        desc.color_space = (VriColorSpace)vri_read_u32(&reader);
+        desc.flags = (VriSwapchainFlagBits)vri_read_u32(&reader);
+        desc.texture_count = (uint8_t)vri_read_u32(&reader);
+        desc.frames_in_flight = (uint8_t)vri_read_u32(&reader);
+        VriBool headless = vri_read_u32(&reader) != 0;
+        desc.present_mode = (VriPresentMode)vri_read_u32(&reader);
+        desc.refresh_rate = vri_read_u32(&reader);
+        uint32_t id = vri_read_u32(&reader);
+        if (!id) break;
+
+        if (headless) {
+            desc.p_window_desc = NULL;
+        } else {
+#if defined(_WIN32)
+            window_desc.p_hwnd = replay_window(replay, desc.width, desc.height);
+#endif
+        }
+
+        VriSwapchain swapchain;
+        check(vri_swapchain_create(device, &desc, &swapchain), "vri_swapchain_create");
+        set_handle(replay, id, swapchain);
+        break;
+    }
+    case VRI_CAPTURE_OP_SWAPCHAIN_DESTROY:
+        vri_swapchain_destroy(device, (VriSwapchain)vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_SWAPCHAIN_ACQUIRE_NEXT_IMAGE: {
+        VriSwapchain swapchain = (VriSwapchain)vri_read_handle(&reader);
+        VriFence     fence = (VriFence)vri_read_handle(&reader);
+        uint64_t     signal_value = vri_read_u64(&reader);
+        uint32_t     image_index;
+        vri_swapchain_acquire_next_image(device, swapchain, fence, signal_value, &image_index);
+        break;
+    }
+    case VRI_CAPTURE_OP_SWAPCHAIN_GET_TEXTURE: {
+        VriSwapchain swapchain = (VriSwapchain)vri_read_handle(&reader);
+        uint32_t     image_index = vri_read_u32(&reader);
+        uint32_t     id = vri_read_u32(&reader);
+        if (!id) break;
+
+        VriTexture texture;
+        check(vri_swapchain_get_texture(device, swapchain, image_index, &texture), "vri_swapchain_get_texture");
+        set_handle(replay, id, texture);
+        break;
+    }
+    case VRI_CAPTURE_OP_SWAPCHAIN_PRESENT: {
+        VriSwapchain swapchain = (VriSwapchain)vri_read_handle(&reader);
+        vri_swapchain_present(device, swapchain, (VriFence)vri_read_handle(&reader));
+        end_frame(replay);
+        break;
+    }
+    case VRI_CAPTURE_OP_COMMAND_BUFFER_BEGIN: {
+        VriCommandBuffer          command_buffer = vri_read_handle(&reader);
+        VriCommandBufferBeginDesc desc = {.usage = vri_read_u32(&reader)};
+        vri_command_buffer_begin(command_buffer, &desc);
+        break;
+    }
+    case VRI_CAPTURE_OP_COMMAND_BUFFER_END:
+        vri_command_buffer_end(vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_COMMAND_BUFFER_RESET:
+        vri_command_buffer_reset(vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_CMD_BIND_PIPELINE: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        vri_cmd_bind_pipeline(command_buffer, (VriPipeline)vri_read_handle(&reader));
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_UPDATE_TEXTURE: {
+        VriCommandBuffer     command_buffer = vri_read_handle(&reader);
+        VriTexture           texture = vri_read_handle(&reader);
+        VriTextureUpdateDesc desc;
+        desc.mip_level = vri_read_u32(&reader);
+        desc.array_layer = vri_read_u32(&reader);
+        desc.x = vri_read_u32(&reader);
+        desc.y = vri_read_u32(&reader);
+        desc.z = vri_read_u32(&reader);
+        desc.width = vri_read_u32(&reader);
+        desc.height = vri_read_u32(&reader);
+        desc.depth = vri_read_u32(&reader);
+        desc.data.row_pitch = vri_read_u32(&reader);
+        desc.data.slice_pitch = vri_read_u32(&reader);
+
+        size_t size = 0;
+        desc.data.p_data = vri_read_blob(&reader, &size);
+        vri_cmd_update_texture(command_buffer, texture, &desc);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_GENERATE_MIPS: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        VriTexture       texture = vri_read_handle(&reader);
+        vri_cmd_generate_mips(command_buffer, texture);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_COPY_TEXTURE: {
+        VriCommandBuffer   command_buffer = vri_read_handle(&reader);
+        VriTexture         src = vri_read_handle(&reader);
+        VriTexture         dst = vri_read_handle(&reader);
+        VriTextureCopyDesc desc;
+        read_texture_location(&reader, &desc.src);
+        read_texture_location(&reader, &desc.dst);
+        desc.width = vri_read_u32(&reader);
+        desc.height = vri_read_u32(&reader);
+        desc.depth = vri_read_u32(&reader);
+        vri_cmd_copy_texture(command_buffer, src, dst, &desc);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_SET_VIEWPORT: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        uint32_t         first_viewport = vri_read_u32(&reader);
+        uint32_t         viewport_count = vri_read_u32(&reader);
+        VriViewport     *viewports = vri_reader_scratch(&reader, sizeof(VriViewport) * viewport_count);
+        if (viewport_count && !viewports) fail("Viewports don't fit in the replay scratch memory");
+
+        for (uint32_t i = 0; i < viewport_count; ++i) {
+            viewports[i].x = vri_read_f32(&reader);
+            viewports[i].y = vri_read_f32(&reader);
+            viewports[i].width = vri_read_f32(&reader);
+            viewports[i].height = vri_read_f32(&reader);
+            viewports[i].min_depth = vri_read_f32(&reader);
+            viewports[i].max_depth = vri_read_f32(&reader);
+        }
+        vri_cmd_set_viewport(command_buffer, first_viewport, viewport_count, viewports);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_SET_SCISSOR: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        uint32_t         first_scissor = vri_read_u32(&reader);
+        uint32_t         scissor_count = vri_read_u32(&reader);
+        VriRect2D       *scissors = vri_reader_scratch(&reader, sizeof(VriRect2D) * scissor_count);
+        if (scissor_count && !scissors) fail("Scissors don't fit in the replay scratch memory");
+
+        for (uint32_t i = 0; i < scissor_count; ++i) {
+            scissors[i].x = (int32_t)vri_read_u32(&reader);
+            scissors[i].y = (int32_t)vri_read_u32(&reader);
+            scissors[i].width = vri_read_u32(&reader);
+            scissors[i].height = vri_read_u32(&reader);
+        }
+        vri_cmd_set_scissor(command_buffer, first_scissor, scissor_count, scissors);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_SET_STENCIL_REFERENCE: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        vri_cmd_set_stencil_reference(command_buffer, vri_read_u32(&reader));
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_SET_BLEND_CONSTANTS: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        float            blend_constants[4];
+        for (uint32_t i = 0; i < 4; ++i) {
+            blend_constants[i] = vri_read_f32(&reader);
+        }
+        vri_cmd_set_blend_constants(command_buffer, blend_constants);
+        break;
+    }
+    case VRI_CAPTURE_OP_CMD_SET_DEPTH_BIAS: {
+        VriCommandBuffer command_buffer = vri_read_handle(&reader);
+        float            constant_factor = vri_read_f32(&reader);
+        float            clamp = vri_read_f32(&reader);
+        float            slope_factor = vri_read_f32(&reader);
+        vri_cmd_set_depth_bias(command_buffer, constant_factor, clamp, slope_factor);
+        break;
+    }
+    case VRI_CAPTURE_OP_QUEUE_SUBMIT: {
+        VriQueue            queue = vri_read_handle(&reader);
+        uint32_t            submit_count = vri_read_u32(&reader);
+        VriQueueSubmitDesc *submits = vri_reader_scratch(&reader, sizeof(VriQueueSubmitDesc) * submit_count);
+        if (submit_count && !submits) fail("Queue submit doesn't fit in the replay scratch memory");
+
+        for (uint32_t i = 0; i < submit_count; ++i) {
+            uint32_t          command_buffer_count = vri_read_u32(&reader);
+            VriCommandBuffer *command_buffers = vri_reader_scratch(&reader, sizeof(VriCommandBuffer) * command_buffer_count);
+            for (uint32_t j = 0; command_buffers && j < command_buffer_count; ++j) {
+                command_buffers[j] = vri_read_handle(&reader);
+            }
+
+            submits[i].p_command_buffers = command_buffers;
+            submits[i].command_buffer_count = command_buffer_count;
+            submits[i].p_fences_wait = read_fence_values(&reader, &submits[i].fence_wait_count);
+            submits[i].p_fences_signal = read_fence_values(&reader, &submits[i].fence_signal_count);
+        }
+        if (reader.overflow) fail("Malformed queue submit record");
+
+        vri_queue_submit(queue, submits, submit_count);
+        break;
+    }
+    case VRI_CAPTURE_OP_QUEUE_WAIT_IDLE:
+        vri_queue_wait_idle(vri_read_handle(&reader));
+        break;
+    case VRI_CAPTURE_OP_QUEUE_PRESENT: {
+        VriQueue            queue = vri_read_handle(&reader);
+        VriQueuePresentDesc desc = {0};
+
+        desc.swapchain_count = vri_read_u32(&reader);
+        VriSwapchain *swapchains = vri_reader_scratch(&reader, sizeof(VriSwapchain) * desc.swapchain_count);
+        desc.p_image_indices = vri_reader_scratch(&reader, sizeof(uint32_t) * desc.swapchain_count);
+        for (uint32_t i = 0; swapchains && desc.p_image_indices && i < desc.swapchain_count; ++i) {
+            swapchains[i] = (VriSwapchain)vri_read_handle(&reader);
+            desc.p_image_indices[i] = vri_read_u32(&reader);
+        }
+        desc.p_swapchains = swapchains;
+
+        desc.wait_fence_count = vri_read_u32(&reader);
+        desc.p_wait_fences = vri_reader_scratch(&reader, sizeof(VriFence) * desc.wait_fence_count);
+        desc.p_wait_values = vri_reader_scratch(&reader, sizeof(uint64_t) * desc.wait_fence_count);
+        for (uint32_t i = 0; desc.p_wait_fences && desc.p_wait_values && i < desc.wait_fence_count; ++i) {
+            desc.p_wait_fences[i] = (VriFence)vri_read_handle(&reader);
+            desc.p_wait_values[i] = vri_read_u64(&reader);
+        }
+        if (reader.overflow) fail("Malformed queue present record");
+
+        vri_queue_present(queue, &desc);
+        end_frame(replay);
+        break;
+    }
+    case VRI_CAPTURE_OP_QUEUE_BIND_SPARSE: {
+        VriQueue           queue = vri_read_handle(&reader);
+        uint32_t           bind_count = vri_read_u32(&reader);
+        VriSparseBindDesc *binds = vri_reader_scratch(&reader, sizeof(VriSparseBindDesc) * bind_count);
+        if (bind_count && !binds) fail("Sparse bind doesn't fit in the replay scratch memory");
+
+        for (uint32_t i = 0; i < bind_count; ++i) {
+            binds[i].texture = (VriTexture)vri_read_handle(&reader);
+            binds[i].mip_level = vri_read_u32(&reader);
+            binds[i].x = vri_read_u32(&reader);
+            binds[i].y = vri_read_u32(&reader);
+            binds[i].width = vri_read_u32(&reader);
+            binds[i].height = vri_read_u32(&reader);
+            binds[i].heap = (VriTileHeap)vri_read_handle(&reader);
+            binds[i].heap_offset = vri_read_u32(&reader);
+        }
+        if (reader.overflow) fail("Malformed sparse bind record");
+
+        vri_queue_bind_sparse(queue, binds, bind_count);
+        break;
+    }
+    default:
+        // Newer ops than this build knows about, skipping keeps old replayers usable
+        break;
+    }
+
+    if (reader.overflow) fail("Malformed record in trace");
+    replay->record_count++;
+}
+
+static void replay_trace(replay_t *replay, pacing_t pacing) {
+    const VriCaptureFileHeader *file_header = (const VriCaptureFileHeader *)replay->p_trace;
+    uint64_t                    offset = file_header->header_size;
+    uint64_t                    loop_start = bench_now_ns();
+
+    replay->frame_start = 0;
+
+    while (offset + sizeof(VriCaptureRecordHeader) <= replay->trace_size) {
+        const VriCaptureRecordHeader *header = (const VriCaptureRecordHeader *)(replay->p_trace + offset);
+        const uint8_t                *p_payload = (const uint8_t *)(header + 1);
+
+        offset += sizeof(*header);
+        if (header->size > replay->trace_size - offset) fail("Trace is truncated");
+        offset += VRI_CAPTURE_ALIGN(header->size);
+
+        if (pacing == PACING_ORIGINAL && header->op != VRI_CAPTURE_OP_BLOB) {
+            uint64_t target = loop_start + header->time_ns;
+            while (bench_now_ns() < target) {
+            }
+        }
+
+        replay_record(replay, header, p_payload);
+    }
+
+    // A trace cut short by a crash still gets its device cleaned up
+    if (replay->device) {
+        vri_device_destroy(replay->device);
+        replay->device = NULL;
+    }
+}
+
+static const uint8_t *map_trace(const char *path, size_t *p_size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+
+    const uint8_t *p_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    *p_size = (size_t)size.QuadPart;
+    return p_data;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *p_data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_data == MAP_FAILED) return NULL;
+
+    *p_size = (size_t)st.st_size;
+    return p_data;
+#endif
+}
+
+static void unmap_trace(const uint8_t *p_data, size_t size) {
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(p_data);
+#else
+    munmap((void *)p_data, size);
+#endif
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s TRACE [--backend none|d3d11] [--pacing fast|original] [--loops N] [--output FILE]\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    replay_options_t options = {
+        .trace_path = NULL,
+        .backend = VRI_BACKEND_NONE,
+        .pacing = PACING_FAST,
+        .loops = 1,
+        .output_path = NULL,
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        if (bench_parse_u32(argc, argv, &i, "--loops", &options.loops)) continue;
+        if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (strcmp(name, "none") == 0) {
+                options.backend = VRI_BACKEND_NONE;
+            } else if (strcmp(name, "d3d11") == 0) {
+                options.backend = VRI_BACKEND_D3D11;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--pacing") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (strcmp(name, "fast") == 0) {
+                options.pacing = PACING_FAST;
+            } else if (strcmp(name, "original") == 0) {
+                options.pacing = PACING_ORIGINAL;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+            continue;
+        }
+        if (argv[i][0] != '-' && !options.trace_path) {
+            options.trace_path = argv[i];
+            continue;
+        }
+
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!options.trace_path) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    replay_t replay = {.backend = options.backend};
+    replay.p_trace = map_trace(options.trace_path, &replay.trace_size);
+    if (!replay.p_trace) {
+        fprintf(stderr, "Couldn't map %s\n", options.trace_path);
+        return 1;
+    }
+
+    const VriCaptureFileHeader *file_header = (const VriCaptureFileHeader *)replay.p_trace;
+    if (replay.trace_size < sizeof(*file_header) || memcmp(file_header->magic, VRI_CAPTURE_MAGIC, sizeof(file_header->magic)) != 0) {
+        fprintf(stderr, "%s is not a VRI trace\n", options.trace_path);
+        return 1;
+    }
+    if (file_header->version != VRI_CAPTURE_VERSION || file_header->header_size < sizeof(*file_header)) {
+        fprintf(stderr, "%s has unsupported trace version %u\n", options.trace_path, file_header->version);
+        return 1;
+    }
+
+    replay.p_scratch = malloc(REPLAY_SCRATCH_SIZE);
+    if (!replay.p_scratch) fail("Out of memory");
+
+    for (uint32_t i = 0; i < options.loops; ++i) {
+        replay_trace(&replay, options.pacing);
+    }
+
+    if (!replay.frame_count) {
+        fprintf(stderr, "%s contains no presents, there are no frames to time\n", options.trace_path);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (options.output_path) {
+        out = fopen(options.output_path, "w");
+        if (!out) {
+            fprintf(stderr, "Couldn't open %s\n", options.output_path);
+            return 1;
+        }
+    }
+
+    bench_summary_t frame_summary = bench_summarize(replay.frame_samples, replay.frame_count);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"config\": {\"trace\": \"%s\", \"pacing\": \"%s\", \"loops\": %u},\n",
+            options.trace_path, options.pacing == PACING_FAST ? "fast" : "original", options.loops);
+    fprintf(out, "  \"trace\": {\"bytes\": %llu, \"records\": %llu, \"frames\": %u},\n",
+            (unsigned long long)replay.trace_size, (unsigned long long)(replay.record_count / options.loops),
+            replay.frame_count / options.loops);
+    bench_json_begin(out);
+    bench_json_summary(out, "frame", 1, replay.frame_count, &frame_summary, true);
+    bench_json_end(out);
+    fprintf(out, "}\n");
+
+    if (out != stdout) fclose(out);
+
+    free(replay.p_scratch);
+    free(replay.frame_samples);
+    free(replay.handles);
+    free(replay.blobs);
+    unmap_trace(replay.p_trace, replay.trace_size);
+
+    return 0;
+}
@@ -0,0 +1,444 @@
+#include <vri/vri.h>
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// End-to-end frame benchmark. Builds a synthetic scene and drives it through
+// the same wait -> acquire -> record -> submit -> present loop as
+// examples/triangle, reporting CPU frame time and a per-phase breakdown.
+// The scene is generated from a fixed seed so runs are reproducible.
+
+#define MAX_FRAMES_IN_FLIGHT 3
+#define MAX_LAYERS           4
+#define FRAME_WIDTH          1920
+#define FRAME_HEIGHT         1080
+
+typedef enum {
+    PHASE_WAIT,
+    PHASE_ACQUIRE,
+    PHASE_RECORD,
+    PHASE_SUBMIT,
+    PHASE_PRESENT,
+    PHASE_COUNT,
+} phase_t;
+
+static const char *phase_names[PHASE_COUNT] = {
+    "frame_wait",
+    "frame_acquire",
+    "frame_record",
+    "frame_submit",
+    "frame_present",
+};
+
+typedef struct scene_options {
+    uint32_t    frames;
+    uint32_t    warmup_frames;
+    uint32_t    pipelines;
+    uint32_t    draws;
+    uint32_t    textures;
+    uint32_t    instancing;        // Draws merged into one instanced draw call
+    uint32_t    frames_in_flight;
+    uint32_t    seed;
+    const char *layers[MAX_LAYERS]; // Enabled on the device, e.g. to capture the run
+    uint32_t    layer_count;
+    const char *output_path;
+} scene_options_t;
+
+typedef struct draw_call {
+    uint32_t pipeline;
+    uint32_t texture;
+    uint32_t instance_count;
+} draw_call_t;
+
+typedef struct scene {
+    VriPipeline *pipelines;
+    VriTexture  *textures;
+    draw_call_t *draw_calls;
+    uint32_t     draw_call_count;
+} scene_t;
+
+static void check(VriResult result, const char *what) {
+    if (VRI_ERROR(result)) {
+        fprintf(stderr, "%s failed (%d)\n", what, result);
+        exit(1);
+    }
+}
+
+static void *checked_calloc(size_t count, size_t size) {
+    void *memory = calloc(count, size);
+    if (!memory) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return memory;
+}
+
+// xorshift32, so the scene layout doesn't depend on the C library's rand()
+static uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int compare_draw_calls(const void *a, const void *b) {
+    const draw_call_t *da = a;
+    const draw_call_t *db = b;
+    if (da->pipeline != db->pipeline) return (da->pipeline > db->pipeline) - (da->pipeline < db->pipeline);
+    return (da->texture > db->texture) - (da->texture < db->texture);
+}
+
+static void scene_create(VriDevice device, const scene_options_t *options, scene_t *scene) {
+    static const VriPrimitiveTopology topologies[] = {
+        VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
+        VRI_PRIMITIVE_TOPOLOGY_LINE_LIST,
+    };
+    static const VriCullMode cull_modes[] = {
+        VRI_CULL_MODE_BACK,
+        VRI_CULL_MODE_FRONT,
+        VRI_CULL_MODE_NONE,
+    };
+
+    scene->pipelines = checked_calloc(options->pipelines, sizeof(VriPipeline));
+    scene->textures = checked_calloc(options->textures, sizeof(VriTexture));
+
+    VriShaderModuleDesc shader_desc = {
+        .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+        .p_entry_point = "main",
+    };
+    VriMultisampleStateDesc multisample_state_desc = {
+        .sample_mask = 0xFFFFFFFF,
+        .sample_count = 1,
+    };
+
+    // Vary the fixed-function state so pipelines aren't trivially identical
+    for (uint32_t i = 0; i < options->pipelines; ++i) {
+        VriInputAssemblyDesc input_assembly_desc = {
+            .topology = topologies[i % VRI_ARRAY_SIZE(topologies)],
+        };
+        VriRasterizationStateDesc rasterization_state_desc = {
+            .fill_mode = VRI_FILL_MODE_FILL,
+            .cull_mode = cull_modes[(i / VRI_ARRAY_SIZE(topologies)) % VRI_ARRAY_SIZE(cull_modes)],
+            .front_face = VRI_FRONT_FACE_COUNTER_CLOCKWISE,
+        };
+        VriGraphicsPipelineDesc pipeline_desc = {
+            .p_shaders = &shader_desc,
+            .shader_count = 1,
+            .p_input_assembly_state = &input_assembly_desc,
+            .p_rasterization_state = &rasterization_state_desc,
+            .p_multisample_state = &multisample_state_desc,
+            .dynamic_states = VRI_DYNAMIC_STATE_FLAG_BIT_SCISSOR,
+        };
+        check(vri_pipeline_create_graphics(device, &pipeline_desc, &scene->pipelines[i]), "vri_pipeline_create_graphics");
+    }
+
+    for (uint32_t i = 0; i < options->textures; ++i) {
+        VriTextureDesc texture_desc = {
+            .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+            .format = VRI_FORMAT_R8G8B8A8_UNORM,
+            .width = 256,
+            .height = 256,
+            .depth = 1,
+            .usage = VRI_TEXTURE_USAGE_BIT_SHADER_RESOURCE,
+            .sample_count = 1,
+            .mip_count = 1,
+            .layer_count = 1,
+        };
+        check(vri_texture_create(device, &texture_desc, &scene->textures[i]), "vri_texture_create");
+    }
+
+    // Every `instancing` consecutive draws collapse into one instanced draw call
+    scene->draw_call_count = (options->draws + options->instancing - 1) / options->instancing;
+    scene->draw_calls = checked_calloc(scene->draw_call_count, sizeof(draw_call_t));
+
+    uint32_t random_state = options->seed;
+    uint32_t remaining = options->draws;
+    for (uint32_t i = 0; i < scene->draw_call_count; ++i) {
+        draw_call_t *draw_call = &scene->draw_calls[i];
+        draw_call->pipeline = next_random(&random_state) % options->pipelines;
+        draw_call->texture = next_random(&random_state) % options->textures;
+        draw_call->instance_count = remaining < options->instancing ? remaining : options->instancing;
+        remaining -= draw_call->instance_count;
+    }
+
+    // Sort by state like a real renderer would, so redundant binds are representative
+    qsort(scene->draw_calls, scene->draw_call_count, sizeof(draw_call_t), compare_draw_calls);
+}
+
+static void scene_destroy(VriDevice device, const scene_options_t *options, scene_t *scene) {
+    for (uint32_t i = 0; i < options->textures; ++i) {
+        vri_texture_destroy(device, scene->textures[i]);
+    }
+    for (uint32_t i = 0; i < options->pipelines; ++i) {
+        vri_pipeline_destroy(device, scene->pipelines[i]);
+    }
+
+    free(scene->draw_calls);
+    free(scene->textures);
+    free(scene->pipelines);
+}
+
+static void scene_record(const scene_t *scene, VriCommandBuffer command_buffer) {
+    VriViewport viewport = {0.0f, 0.0f, (float)FRAME_WIDTH, (float)FRAME_HEIGHT, 0.0f, 1.0f};
+    VriRect2D   scissor = {0, 0, FRAME_WIDTH, FRAME_HEIGHT};
+    vri_cmd_set_viewport(command_buffer, 0, 1, &viewport);
+    vri_cmd_set_scissor(command_buffer, 0, 1, &scissor);
+
+    // VRI doesn't expose draw or resource binding commands yet, so pipeline
+    // binds are the only per-draw work there is to record
+    for (uint32_t i = 0; i < scene->draw_call_count; ++i) {
+        vri_cmd_bind_pipeline(command_buffer, scene->pipelines[scene->draw_calls[i].pipeline]);
+    }
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--frames N] [--warmup-frames N] [--pipelines N] [--draws N] [--textures N]\n"
+            "          [--instancing N] [--frames-in-flight N] [--seed N] [--layer NAME]... [--output FILE]\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    scene_options_t options = {
+        .frames = 1000,
+        .warmup_frames = 100,
+        .pipelines = 64,
+        .draws = 10000,
+        .textures = 256,
+        .instancing = 4,
+        .frames_in_flight = 2,
+        .seed = 0x5EED,
+        .output_path = NULL,
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        if (bench_parse_u32(argc, argv, &i, "--frames", &options.frames)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--warmup-frames", &options.warmup_frames)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--pipelines", &options.pipelines)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--draws", &options.draws)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--textures", &options.textures)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--instancing", &options.instancing)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--frames-in-flight", &options.frames_in_flight)) continue;
+        if (bench_parse_u32(argc, argv, &i, "--seed", &options.seed)) continue;
+        if (strcmp(argv[i], "--layer") == 0 && i + 1 < argc && options.layer_count < MAX_LAYERS) {
+            options.layers[options.layer_count++] = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+            continue;
+        }
+
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (options.frames_in_flight > MAX_FRAMES_IN_FLIGHT) {
+        fprintf(stderr, "--frames-in-flight is limited to %d\n", MAX_FRAMES_IN_FLIGHT);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (options.output_path) {
+        out = fopen(options.output_path, "w");
+        if (!out) {
+            fprintf(stderr, "Couldn't open %s\n", options.output_path);
+            return 1;
+        }
+    }
+
+    // Device and per-frame objects, mirroring examples/triangle
+    VriAdapterProps adapter_props;
+    uint32_t        adapter_count = 1;
+    check(vri_adapters_enumerate(&adapter_props, &adapter_count), "vri_adapters_enumerate");
+
+    VriQueueDesc  queue_desc = {.type = VRI_QUEUE_TYPE_GRAPHICS, .count = 1};
+    VriDeviceDesc device_desc = {
+        .backend = VRI_BACKEND_NONE,
+        .p_adapter_props = &adapter_props,
+        .p_queue_descs = &queue_desc,
+        .queue_desc_count = 1,
+        .pp_enabled_layers = options.layers,
+        .enabled_layer_count = options.layer_count,
+    };
+
+    VriDevice device;
+    check(vri_device_create(&device_desc, &device), "vri_device_create");
+
+    VriQueue graphics_queue;
+    vri_device_get_queue(device, VRI_QUEUE_TYPE_GRAPHICS, 0, &graphics_queue);
+
+    // Headless and never waiting for a vblank, so frames are only as long as the CPU work
+    VriSwapchainDesc swapchain_desc = {
+        .width = FRAME_WIDTH,
+        .height = FRAME_HEIGHT,
+        .format = VRI_FORMAT_R8G8B8A8_UNORM,
+        .texture_count = 2,
+        .frames_in_flight = (uint8_t)options.frames_in_flight,
+        .present_mode = VRI_PRESENT_MODE_IMMEDIATE,
+    };
+    VriSwapchain swapchain;
+    check(vri_swapchain_create(device, &swapchain_desc, &swapchain), "vri_swapchain_create");
+
+    VriFence frame_fence;
+    VriFence image_available_fence;
+    check(vri_fence_create(device, 0, &frame_fence), "vri_fence_create");
+    check(vri_fence_create(device, 0, &image_available_fence), "vri_fence_create");
+
+    VriCommandPoolDesc pool_desc = {
+        .queue_type = VRI_QUEUE_TYPE_GRAPHICS,
+        .flags = VRI_COMMAND_POOL_FLAG_BIT_RESET_COMMAND_BUFFER,
+    };
+    VriCommandPool command_pool;
+    check(vri_command_pool_create(device, &pool_desc, &command_pool), "vri_command_pool_create");
+
+    VriCommandBuffer             command_buffers[MAX_FRAMES_IN_FLIGHT];
+    VriCommandBufferAllocateDesc allocate_desc = {
+        .command_pool = command_pool,
+        .command_buffer_count = options.frames_in_flight,
+    };
+    check(vri_command_buffers_allocate(device, &allocate_desc, command_buffers), "vri_command_buffers_allocate");
+
+    scene_t scene = {0};
+    scene_create(device, &options, &scene);
+
+    double *frame_samples = checked_calloc(options.frames, sizeof(double));
+    double *phase_samples[PHASE_COUNT];
+    for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+        phase_samples[i] = checked_calloc(options.frames, sizeof(double));
+    }
+
+    VriDeviceStatistics stats_before;
+
+    uint64_t frame_number = 0;
+    uint64_t frame_complete_counter = 0;
+    uint64_t image_acquire_counter = 0;
+    uint32_t current_frame = 0;
+
+    for (uint32_t frame = 0; frame < options.warmup_frames + options.frames; ++frame) {
+        if (frame == options.warmup_frames) {
+            vri_device_get_statistics(device, &stats_before);
+        }
+
+        uint64_t timestamps[PHASE_COUNT + 1];
+        timestamps[PHASE_WAIT] = bench_now_ns();
+
+        // Limit frames in flight
+        if (frame_number >= options.frames_in_flight) {
+            uint64_t wait_value = frame_number - options.frames_in_flight + 1;
+            check(vri_fences_wait(device, &frame_fence, &wait_value, 1, true, UINT64_MAX), "vri_fences_wait");
+        }
+
+        timestamps[PHASE_ACQUIRE] = bench_now_ns();
+
+        uint32_t image_index = 0;
+        uint64_t acquire_value = ++image_acquire_counter;
+        check(vri_swapchain_acquire_next_image(device, swapchain, image_available_fence, acquire_value, &image_index), "vri_swapchain_acquire_next_image");
+
+        timestamps[PHASE_RECORD] = bench_now_ns();
+
+        const VriCommandBuffer    command_buffer = command_buffers[current_frame];
+        VriCommandBufferBeginDesc begin_desc = {0};
+        vri_command_buffer_reset(command_buffer);
+        check(vri_command_buffer_begin(command_buffer, &begin_desc), "vri_command_buffer_begin");
+        scene_record(&scene, command_buffer);
+        check(vri_command_buffer_end(command_buffer), "vri_command_buffer_end");
+
+        timestamps[PHASE_SUBMIT] = bench_now_ns();
+
+        uint64_t           submit_signal_value = ++frame_complete_counter;
+        VriFenceWaitDesc   wait_desc = {.fence = image_available_fence, .value = acquire_value};
+        VriFenceSignalDesc signal_desc = {.fence = frame_fence, .value = submit_signal_value};
+        VriQueueSubmitDesc submit_desc = {
+            .command_buffer_count = 1,
+            .p_command_buffers = &command_buffer,
+            .fence_wait_count = 1,
+            .p_fences_wait = &wait_desc,
+            .fence_signal_count = 1,
+            .p_fences_signal = &signal_desc,
+        };
+        check(vri_queue_submit(graphics_queue, &submit_desc, 1), "vri_queue_submit");
+
+        timestamps[PHASE_PRESENT] = bench_now_ns();
+
+        VriQueuePresentDesc present_desc = {
+            .swapchain_count = 1,
+            .p_swapchains = &swapchain,
+            .p_image_indices = &image_index,
+            .wait_fence_count = 1,
+            .p_wait_fences = &frame_fence,
+            .p_wait_values = &submit_signal_value,
+        };
+        check(vri_queue_present(graphics_queue, &present_desc), "vri_queue_present");
+
+        timestamps[PHASE_COUNT] = bench_now_ns();
+
+        current_frame = (current_frame + 1) % options.frames_in_flight;
+        frame_number++;
+
+        if (frame >= options.warmup_frames) {
+            uint32_t sample = frame - options.warmup_frames;
+            frame_samples[sample] = (double)(timestamps[PHASE_COUNT] - timestamps[PHASE_WAIT]);
+            for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+                phase_samples[i][sample] = (double)(timestamps[i + 1] - timestamps[i]);
+            }
+        }
+    }
+
+    check(vri_queue_wait_idle(graphics_queue), "vri_queue_wait_idle");
+
+    VriDeviceStatistics stats_after;
+    vri_device_get_statistics(device, &stats_after);
+
+    bench_summary_t frame_summary = bench_summarize(frame_samples, options.frames);
+    bench_summary_t phase_summaries[PHASE_COUNT];
+    for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+        phase_summaries[i] = bench_summarize(phase_samples[i], options.frames);
+    }
+
+    uint64_t binds = stats_after.total.pipeline_binds - stats_before.total.pipeline_binds;
+    uint64_t redundant_binds = stats_after.total.pipeline_binds_redundant - stats_before.total.pipeline_binds_redundant;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"program\": \"vri-scene-bench\",\n");
+    fprintf(out, "  \"vri_version\": \"%u.%u.%u\",\n", VRI_VERSION_MAJOR(VRI_HEADER_VERSION), VRI_VERSION_MINOR(VRI_HEADER_VERSION), VRI_VERSION_PATCH(VRI_HEADER_VERSION));
+    fprintf(out, "  \"backend\": %d,\n", (int)device_desc.backend);
+    fprintf(out,
+            "  \"config\": {\"frames\": %u, \"warmup_frames\": %u, \"pipelines\": %u, \"draws\": %u, \"textures\": %u, "
+            "\"instancing\": %u, \"frames_in_flight\": %u, \"seed\": %u},\n",
+            options.frames, options.warmup_frames, options.pipelines, options.draws, options.textures,
+            options.instancing, options.frames_in_flight, options.seed);
+    fprintf(out, "  \"scene\": {\"draw_calls\": %u, \"pipeline_binds_per_frame\": %.1f, \"redundant_binds_per_frame\": %.1f},\n",
+            scene.draw_call_count, (double)binds / (double)options.frames, (double)redundant_binds / (double)options.frames);
+
+    bench_json_begin(out);
+    bench_json_summary(out, "frame", 1, options.frames, &frame_summary, false);
+    for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+        bench_json_summary(out, phase_names[i], 1, options.frames, &phase_summaries[i], i + 1 == PHASE_COUNT);
+    }
+    bench_json_end(out);
+    fprintf(out, "}\n");
+
+    for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+        free(phase_samples[i]);
+    }
+    free(frame_samples);
+
+    // Clean-up
+    scene_destroy(device, &options, &scene);
+    vri_command_buffers_free(device, command_pool, options.frames_in_flight, command_buffers);
+    vri_command_pool_destroy(device, command_pool);
+    vri_fence_destroy(device, image_available_fence);
+    vri_fence_destroy(device, frame_fence);
+    vri_swapchain_destroy(device, swapchain);
+    vri_device_destroy(device);
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -32,18 +32,53 @@ typedef bool     VriBool;
 VRI_DEFINE_HANDLE(VriDevice)
 VRI_DEFINE_HANDLE(VriQueue)
 VRI_DEFINE_HANDLE(VriCommandBuffer)
+VRI_DEFINE_HANDLE(VriUploadQueue)
+VRI_DEFINE_HANDLE(VriStreamQueue)
+VRI_DEFINE_HANDLE(VriEvictionManager)
+VRI_DEFINE_HANDLE(VriReadbackRing)
+VRI_DEFINE_HANDLE(VriPipelineManifest)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriCommandPool)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriFence)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriSwapchain)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriTexture)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriPipeline)
+VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriPipelineLibrary)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriPipelineLayout)
 VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriShaderModule)
+VRI_DEFINE_NON_DISPATCHABLE_HANDLE(VriTileHeap)
 
 #define VRI_TRUE                1
 #define VRI_FALSE               0
 #define VRI_SWAPCHAIN_SEMAPHORE ((uint64_t)-1)
 
+#define VRI_UPLOAD_QUEUE_DEFAULT_BATCH_SIZE (16ull * 1024 * 1024)
+#define VRI_UPLOAD_QUEUE_MAX_BATCHES        8
+
+#define VRI_STREAM_QUEUE_DEFAULT_STAGING_SIZE (4ull * 1024 * 1024)
+#define VRI_STREAM_QUEUE_DEFAULT_MAX_REQUESTS 256
+
+#define VRI_EVICTION_MANAGER_DEFAULT_MAX_RESOURCES 1024
+
+#define VRI_READBACK_RING_DEFAULT_SLOT_COUNT 3
+#define VRI_READBACK_RING_MAX_SLOTS          8
+
+#define VRI_TILE_SIZE (64u * 1024u) // Bytes of one sparse texture tile
+
+#define VRI_SWAPCHAIN_MAX_TEXTURES         8
+#define VRI_SWAPCHAIN_DEFAULT_REFRESH_RATE 60
+
+#define VRI_COLOR_DEFAULT_SDR_WHITE_NITS 203.0f // BT.2408 reference white
+
+#define VRI_MAX_VIEWPORTS 16 // Also the maximum number of scissor rectangles
+
+#define VRI_MAX_SPECIALIZATION_CONSTANTS        64 // Constant ids are below this
+#define VRI_SPECIALIZATION_CONSTANT_BUFFER_SLOT 13 // D3D11 register b13, see VriSpecializationConstant
+
+// Names of the built-in layers, for VriDeviceDesc::pp_enabled_layers
+#define VRI_LAYER_VALIDATION_NAME "VRI_LAYER_validation"
+#define VRI_LAYER_TRACE_NAME      "VRI_LAYER_trace"
+#define VRI_LAYER_CAPTURE_NAME    "VRI_LAYER_capture"
+
 #define VRI_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #define VRI_MIN(a, b)     ((a) < (b) ? (a) : (b))
 #define VRI_MAX(a, b)     ((a) > (b) ? (a) : (b))
@@ -97,13 +132,112 @@ typedef enum {
     VRI_GPU_VENDOR_MAX_ENUM = 0x7FFFFFFF
 } VriGpuVendor;
 
+// Values are stable, traces store them. New formats go at the end.
 typedef enum {
     VRI_FORMAT_UNDEFINED = 0,
     VRI_FORMAT_R8G8B8A8_UNORM,
+    VRI_FORMAT_R8G8B8A8_SRGB,
+    VRI_FORMAT_B8G8R8A8_UNORM,
+    VRI_FORMAT_B8G8R8A8_SRGB,
+    VRI_FORMAT_R8_UNORM,
+    VRI_FORMAT_R8G8_UNORM,
+    VRI_FORMAT_R10G10B10A2_UNORM,
+    VRI_FORMAT_R11G11B10_FLOAT,
+    VRI_FORMAT_R16_FLOAT,
+    VRI_FORMAT_R16G16_FLOAT,
+    VRI_FORMAT_R16G16B16A16_FLOAT,
+    VRI_FORMAT_R32_FLOAT,
+    VRI_FORMAT_R32G32_FLOAT,
+    VRI_FORMAT_R32G32B32_FLOAT,
+    VRI_FORMAT_R32G32B32A32_FLOAT,
+    VRI_FORMAT_R16_UINT,
+    VRI_FORMAT_R32_UINT,
+    VRI_FORMAT_D16_UNORM,
+    VRI_FORMAT_D24_UNORM_S8_UINT,
+    VRI_FORMAT_D32_FLOAT,
+    VRI_FORMAT_D32_FLOAT_S8_UINT,
+    VRI_FORMAT_BC1_UNORM,
+    VRI_FORMAT_BC1_SRGB,
+    VRI_FORMAT_BC2_UNORM,
+    VRI_FORMAT_BC2_SRGB,
+    VRI_FORMAT_BC3_UNORM,
+    VRI_FORMAT_BC3_SRGB,
+    VRI_FORMAT_BC4_UNORM,
+    VRI_FORMAT_BC4_SNORM,
+    VRI_FORMAT_BC5_UNORM,
+    VRI_FORMAT_BC5_SNORM,
+    VRI_FORMAT_BC6H_UFLOAT,
+    VRI_FORMAT_BC6H_SFLOAT,
+    VRI_FORMAT_BC7_UNORM,
+    VRI_FORMAT_BC7_SRGB,
     VRI_FORMAT_COUNT,
     VRI_FORMAT_MAX_ENUM = 0x7FFFFFFF
 } VriFormat;
 
+typedef enum {
+    VRI_FORMAT_ASPECT_FLAG_BIT_NONE = 0,
+    VRI_FORMAT_ASPECT_FLAG_BIT_COLOR = 1 << 0,
+    VRI_FORMAT_ASPECT_FLAG_BIT_DEPTH = 1 << 1,
+    VRI_FORMAT_ASPECT_FLAG_BIT_STENCIL = 1 << 2,
+} VriFormatAspectFlagBits;
+typedef VriFlags VriFormatAspectFlags;
+
+// Uncompressed formats are 1x1 blocks, so block_size is the texel size.
+// Formats of one family share their memory layout and can view each other's
+// data. The family is only the member that represents that layout, named
+// after its UNORM or FLOAT member, and says nothing about how the data is
+// read: R16_UINT and R32_UINT are in the R16_FLOAT and R32_FLOAT families.
+typedef struct {
+    uint8_t              block_size;
+    uint8_t              block_width;
+    uint8_t              block_height;
+    VriBool              srgb;
+    VriFormatAspectFlags aspects;
+    VriFormat            family;
+} VriFormatInfo;
+
+// CPU-side conversion between block-compressed data and RGBA8 texels. BC4
+// decodes to red and BC5 to red and green, the other channels are 0 and alpha
+// is 255. The SNORM formats take and give R8G8B8A8_SNORM texels instead, with
+// alpha at 127, and BC6H decodes to R16G16B16A16_FLOAT texels with alpha at
+// 1.0. Partial blocks at the right and bottom edge are clamped.
+typedef struct {
+    VriFormat   format; // The BC format, the sRGB and UNORM variants are the same bits
+    uint32_t    width;  // In texels
+    uint32_t    height;
+    const void *p_src;
+    uint32_t    src_row_pitch;
+    void       *p_dst;
+    uint32_t    dst_row_pitch;
+} VriBlockConvertDesc;
+
+typedef enum {
+    VRI_MIP_FILTER_BOX,    // 2x2 average
+    VRI_MIP_FILTER_KAISER, // 6x6 Kaiser-windowed sinc, sharper, at about four times the cost
+    VRI_MIP_FILTER_COUNT,
+    VRI_MIP_FILTER_MAX_ENUM = 0x7FFFFFFF
+} VriMipFilter;
+
+// One mip level generated on the CPU from the level above it, which is
+// width x height. The destination is max(width / 2, 1) x max(height / 2, 1).
+// Calls writing disjoint destination rows can run on different threads, so a
+// large level can be split across a job system with first_row and row_count,
+// or across thread_count threads of the call's own, which it joins before
+// returning. sRGB formats are filtered in linear space, alpha always is linear.
+typedef struct {
+    VriFormat    format; // 8 bit UNORM and SRGB, or 32 bit FLOAT formats
+    VriMipFilter filter;
+    uint32_t     width;
+    uint32_t     height;
+    const void  *p_src;
+    uint32_t     src_row_pitch;
+    void        *p_dst;
+    uint32_t     dst_row_pitch;
+    uint32_t     first_row; // Destination rows to write, a row_count of 0 writes the rest of the level
+    uint32_t     row_count;
+    uint32_t     thread_count; // Including the calling thread, 0 and 1 generate on the calling thread only
+} VriMipGenerateDesc;
+
 typedef enum {
     VRI_COLORSPACE_SRGB_NONLINEAR = 0,
     VRI_COLORSPACE_SRGB_LINEAR,
@@ -120,6 +254,37 @@ typedef enum {
     VRI_COLORSPACE_MAX_ENUM = 0x7FFFFFFF
 } VriColorSpace;
 
+// CPU-side conversion of texels between color spaces, for frames read back
+// from HDR swapchains, content converted on upload and the like. Linear 1.0 is
+// reference white in every color space: sdr_white_nits for HDR10, 75% signal
+// for HLG, which stays scene light without an OOTF. The format only says how
+// texels are stored, SRGB and UNORM variants are read the same and the curve
+// comes from the color space. UNORM destinations clamp to [0, 1]. A
+// conversion can run in place when both formats have the same texel size.
+typedef struct {
+    VriFormat     src_format; // R8G8B8A8 and B8G8R8A8 UNORM and SRGB, R10G10B10A2_UNORM, R16G16B16A16_FLOAT or R32G32B32A32_FLOAT
+    VriColorSpace src_color_space;
+    VriFormat     dst_format;
+    VriColorSpace dst_color_space;
+    uint32_t      width; // In texels
+    uint32_t      height;
+    const void   *p_src;
+    uint32_t      src_row_pitch;
+    void         *p_dst;
+    uint32_t      dst_row_pitch;
+    float         sdr_white_nits; // 0 means VRI_COLOR_DEFAULT_SDR_WHITE_NITS
+} VriColorConvertDesc;
+
+// How presented images reach the display of a headless swapchain, which has a
+// virtual vblank at refresh_rate instead of a monitor
+typedef enum {
+    VRI_PRESENT_MODE_FIFO,      // Every image is shown for at least one vblank, in order
+    VRI_PRESENT_MODE_MAILBOX,   // Shown on the next vblank, a newer present replaces a waiting image
+    VRI_PRESENT_MODE_IMMEDIATE, // Shown right away, without waiting for a vblank
+    VRI_PRESENT_MODE_COUNT,
+    VRI_PRESENT_MODE_MAX_ENUM = 0x7FFFFFFF
+} VriPresentMode;
+
 typedef enum {
     VRI_QUEUE_TYPE_GRAPHICS,
     VRI_QUEUE_TYPE_COMPUTE,
@@ -133,9 +298,19 @@ typedef enum {
     VRI_MEMORY_TYPE_GPU_ONLY, // DEVICE (D3D11: DEFAULT, no CPU access)
     VRI_MEMORY_TYPE_UPLOAD,   // DEVICE_UPLOAD/HOST_UPLOAD (D3D11: DYNAMIC, CPU_WRITE)
     VRI_MEMORY_TYPE_READBACK, // HOST_READBACK (D3D11: STAGING, CPU_READ)
+    VRI_MEMORY_TYPE_COUNT,
     VRI_MEMORY_TYPE_MAX_ENUM = 0x7FFFFFFF
 } VriMemoryType;
 
+// Where memory types live: GPU_ONLY in DEVICE_LOCAL, UPLOAD and READBACK in
+// SYSTEM. On integrated GPUs the driver decides how the two split.
+typedef enum {
+    VRI_MEMORY_HEAP_DEVICE_LOCAL = 0,
+    VRI_MEMORY_HEAP_SYSTEM = 1,
+    VRI_MEMORY_HEAP_COUNT,
+    VRI_MEMORY_HEAP_MAX_ENUM = 0x7FFFFFFF
+} VriMemoryHeap;
+
 typedef enum {
     VRI_TEXTURE_TYPE_TEXTURE_1D,
     VRI_TEXTURE_TYPE_TEXTURE_2D,
@@ -153,6 +328,28 @@ typedef enum {
     VRI_COMMAND_BUFFER_STATE_MAX_ENUM = 0x7FFFFFFF
 } VriCommandBufferState;
 
+typedef enum {
+    VRI_OBJECT_TYPE_DEVICE = 0,
+    VRI_OBJECT_TYPE_COMMAND_POOL = 1,
+    VRI_OBJECT_TYPE_COMMAND_BUFFER = 2,
+    VRI_OBJECT_TYPE_QUEUE = 3,
+    VRI_OBJECT_TYPE_PIPELINE_LAYOUT = 4,
+    VRI_OBJECT_TYPE_PIPELINE = 5,
+    VRI_OBJECT_TYPE_TEXTURE = 6,
+    VRI_OBJECT_TYPE_FENCE = 7,
+    VRI_OBJECT_TYPE_SWAPCHAIN = 8,
+    VRI_OBJECT_TYPE_SHADER_MODULE = 9,
+    VRI_OBJECT_TYPE_UPLOAD_QUEUE = 10,
+    VRI_OBJECT_TYPE_STREAM_QUEUE = 11,
+    VRI_OBJECT_TYPE_TILE_HEAP = 12,
+    VRI_OBJECT_TYPE_EVICTION_MANAGER = 13,
+    VRI_OBJECT_TYPE_READBACK_RING = 14,
+    VRI_OBJECT_TYPE_PIPELINE_LIBRARY = 15,
+    VRI_OBJECT_TYPE_PIPELINE_MANIFEST = 16,
+    VRI_OBJECT_TYPE_COUNT,
+    VRI_OBJECT_TYPE_MAX_ENUM = 0x7FFFFFFF
+} VriObjectType;
+
 typedef enum {
     VRI_PRIMITIVE_TOPOLOGY_POINT_LIST = 0,
     VRI_PRIMITIVE_TOPOLOGY_LINE_LIST = 1,
@@ -261,6 +458,8 @@ typedef enum {
     VRI_TEXTURE_USAGE_BIT_COLOR_ATTACHMENT = 1 << 2,
     VRI_TEXTURE_USAGE_BIT_DEPTH_STENCIL_ATTACHMENT = 1 << 3,
     VRI_TEXTURE_USAGE_BIT_SHADING_RATE_ATTACHMENT = 1 << 4,
+    VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS = 1 << 5, // Required by vri_cmd_generate_mips
+    VRI_TEXTURE_USAGE_BIT_SPARSE = 1 << 6,        // Created without memory, tiles are bound with vri_queue_bind_sparse
 } VriTextureUsageBits;
 typedef VriFlags VriTextureUsage;
 
@@ -303,18 +502,60 @@ typedef enum {
 } VriShaderStageFlagBits;
 typedef VriFlags VriShaderStageFlags;
 
+// Pipeline state that comes from the vri_cmd_set_* commands instead of the
+// pipeline desc, so one pipeline covers every value. Viewports always are
+// dynamic. Without the SCISSOR bit the pipeline has no scissor test.
+typedef enum {
+    VRI_DYNAMIC_STATE_FLAG_BIT_NONE = 0,
+    VRI_DYNAMIC_STATE_FLAG_BIT_SCISSOR = 1 << 0,
+    VRI_DYNAMIC_STATE_FLAG_BIT_STENCIL_REFERENCE = 1 << 1,
+    VRI_DYNAMIC_STATE_FLAG_BIT_BLEND_CONSTANTS = 1 << 2,
+    VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS = 1 << 3,
+} VriDynamicStateFlagBits;
+typedef VriFlags VriDynamicStateFlags;
+
+// The parts a graphics pipeline is linked from. A part only reads its own
+// members of VriGraphicsPipelineDesc, and the dynamic_states bits of its state:
+//   VERTEX_INPUT       p_input_assembly_state, p_vertex_input
+//   PRE_RASTERIZATION  vertex, tessellation and geometry shaders, p_rasterization_state
+//   FRAGMENT_SHADER    fragment shader, p_depth_stencil_state
+//   FRAGMENT_OUTPUT    p_color_blend_state, p_multisample_state
+typedef enum {
+    VRI_PIPELINE_LIBRARY_FLAG_BIT_NONE = 0,
+    VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT = 1 << 0,
+    VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION = 1 << 1,
+    VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER = 1 << 2,
+    VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT = 1 << 3,
+    VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL = 0xF,
+} VriPipelineLibraryFlagBits;
+typedef VriFlags VriPipelineLibraryFlags;
+
+// How long an allocation is expected to live, so applications can route
+// short-lived memory to an arena and keep it away from their general heap.
+// Every scope is a guarantee about when the memory is freed at the latest.
+typedef enum {
+    VRI_ALLOCATION_SCOPE_OBJECT = 0,    // Owned by one object, such as shader bytecode or texture memory, freed when that object is destroyed
+    VRI_ALLOCATION_SCOPE_COMMAND = 1,   // Recorded commands, freed when their command buffer is reset, begun again or freed
+    VRI_ALLOCATION_SCOPE_TRANSIENT = 2, // Freed before the call that allocated it returns
+    VRI_ALLOCATION_SCOPE_DEVICE = 3,    // Freed when the device is destroyed: the device, the slabs all objects are pooled in, layer data
+    VRI_ALLOCATION_SCOPE_MAX_ENUM = 0x7FFFFFFF
+} VriAllocationScope;
+
 typedef void (*PFN_VriMessageCallback)(
     VriMessageSeverity severity,
     const char        *p_message);
 
 typedef void *(*PFN_VriAllocationFunction)(
-    size_t size,
-    size_t alignment);
+    size_t             size,
+    size_t             alignment,
+    VriAllocationScope scope);
 
+// Receives the size, alignment and scope the memory was allocated with
 typedef void (*PFN_VriFreeFunction)(
-    void  *p_memory,
-    size_t size,
-    size_t alignment);
+    void              *p_memory,
+    size_t             size,
+    size_t             alignment,
+    VriAllocationScope scope);
 
 typedef struct {
     PFN_VriMessageCallback pfn_message_callback;
@@ -354,20 +595,109 @@ typedef struct {
     VriDebugCallback       debug_callback;
     VriAllocationCallback  allocation_callback;
     VriBool                enable_api_validation;
+    // Layers wrap the backend in the order given, the first one is called first
+    const char *const     *pp_enabled_layers;
+    uint32_t               enabled_layer_count;
 } VriDeviceDesc;
 
+// Texel data of one subresource, or of a region of one. Rows are row_pitch
+// bytes apart, depth slices slice_pitch bytes apart, so a 2D region is
+// slice_pitch bytes in total.
 typedef struct {
-    VriTextureType  type;
-    VriFormat       format;
-    uint32_t        width;
-    uint32_t        height;
-    uint32_t        depth;
-    VriTextureUsage usage;
-    uint32_t        sample_count;
-    uint32_t        mip_count;
-    uint32_t        layer_count;
+    const void *p_data;
+    uint32_t    row_pitch;
+    uint32_t    slice_pitch;
+} VriSubresourceData;
+
+typedef struct {
+    VriTextureType            type;
+    VriFormat                 format;
+    uint32_t                  width;
+    uint32_t                  height;
+    uint32_t                  depth;
+    VriTextureUsage           usage;
+    uint32_t                  sample_count;
+    uint32_t                  mip_count;
+    uint32_t                  layer_count;
+    const VriSubresourceData *p_initial_data; // NULL, or mip_count * layer_count entries, every mip of layer 0 first
+    VriMemoryType             memory_type;    // READBACK textures have no usage, they're copied to and mapped
 } VriTextureDesc;
 
+typedef struct {
+    uint32_t           mip_level;
+    uint32_t           array_layer;
+    uint32_t           x;
+    uint32_t           y;
+    uint32_t           z;
+    uint32_t           width;
+    uint32_t           height;
+    uint32_t           depth;
+    VriSubresourceData data;
+} VriTextureUpdateDesc;
+
+typedef struct {
+    uint32_t mip_level;
+    uint32_t array_layer;
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+} VriTextureLocation;
+
+// Both textures need the same format, and the region has to fit into both
+typedef struct {
+    VriTextureLocation src;
+    VriTextureLocation dst;
+    uint32_t           width;
+    uint32_t           height;
+    uint32_t           depth;
+} VriTextureCopyDesc;
+
+typedef struct {
+    float x;
+    float y;
+    float width;
+    float height;
+    float min_depth;
+    float max_depth;
+} VriViewport;
+
+typedef struct {
+    int32_t  x;
+    int32_t  y;
+    uint32_t width;
+    uint32_t height;
+} VriRect2D;
+
+typedef struct {
+    uint32_t tile_count;
+} VriTileHeapDesc;
+
+// How a sparse texture splits into tiles. Mips down to standard_mip_count
+// are grids of tile_width x tile_height texel tiles, the smaller mips after
+// them share packed_tile_count tiles that are bound as a unit. Tiles are
+// numbered mip by mip, row by row, and the packed tiles come last.
+typedef struct {
+    uint32_t tile_width;
+    uint32_t tile_height;
+    uint32_t standard_mip_count;
+    uint32_t packed_tile_count;
+    uint32_t tile_count;
+} VriTextureTiling;
+
+// A rectangle of tiles of one mip, bound to consecutive heap tiles row by
+// row. The packed mips are addressed as mip standard_mip_count, one row of
+// packed_tile_count tiles, and are bound all at once.
+typedef struct {
+    VriTexture  texture;
+    uint32_t    mip_level;
+    uint32_t    x; // In tiles
+    uint32_t    y;
+    uint32_t    width;
+    uint32_t    height;
+    VriTileHeap heap; // VRI_NULL_HANDLE unbinds the tiles
+    uint32_t    heap_offset;
+} VriSparseBindDesc;
+
 typedef struct {
     void *p_hwnd;
     void *p_connection;
@@ -377,6 +707,8 @@ typedef struct {
     void *p_caMetalLayer;
 } VriWindowDesc;
 
+// A NULL p_window_desc creates a headless swapchain, which renders into
+// texture_count offscreen images and paces presents with present_mode
 typedef struct {
     VriWindowDesc       *p_window_desc;
     uint32_t             width;
@@ -384,10 +716,23 @@ typedef struct {
     VriFormat            format;
     VriColorSpace        color_space;
     VriSwapchainFlagBits flags;
-    uint8_t              texture_count;
+    uint8_t              texture_count; // Up to VRI_SWAPCHAIN_MAX_TEXTURES, 0 for 2
     uint8_t              frames_in_flight;
+    VriPresentMode       present_mode;  // Headless only, windows use the VSYNC and ALLOW_TEARING flags
+    uint32_t             refresh_rate;  // Hz, 0 for VRI_SWAPCHAIN_DEFAULT_REFRESH_RATE. Headless only
 } VriSwapchainDesc;
 
+// Counters of a headless swapchain since it was created. The time between
+// shown images is the frame pacing a display would have seen
+typedef struct {
+    uint64_t present_count;
+    uint64_t display_count;     // Presents that were shown
+    uint64_t drop_count;        // MAILBOX presents replaced before they were shown
+    uint64_t repeat_count;      // Vblanks that had no new image and showed the last one again
+    uint64_t last_display_ns;   // vri_time_ns clock
+    uint64_t refresh_period_ns;
+} VriSwapchainStats;
+
 typedef struct {
     VriQueueType        queue_type;
     VriCommandPoolFlags flags;
@@ -402,6 +747,97 @@ typedef struct {
     VriCommandBufferUsage usage;
 } VriCommandBufferBeginDesc;
 
+// Uploads are recorded into a batch, which is submitted once it holds
+// batch_size bytes or on vri_upload_queue_flush, and signals the queue's fence
+typedef struct {
+    VriQueue queue;       // Usually a VRI_QUEUE_TYPE_TRANSFER queue
+    uint64_t batch_size;  // 0 for VRI_UPLOAD_QUEUE_DEFAULT_BATCH_SIZE
+    uint32_t batch_count; // Batches in flight before recording waits on the oldest, 0 for 2
+} VriUploadQueueDesc;
+
+typedef enum {
+    VRI_STREAM_STATUS_SUBMITTED = 0, // The copy is submitted, fence_value is when it's resident
+    VRI_STREAM_STATUS_CANCELLED = 1,
+    VRI_STREAM_STATUS_FAILED = 2, // The read or the upload failed
+    VRI_STREAM_STATUS_MAX_ENUM = 0x7FFFFFFF
+} VriStreamStatus;
+
+typedef void (*PFN_VriStreamCallback)(void *p_user_data, VriStreamStatus status, uint64_t fence_value);
+
+typedef struct {
+    VriUploadQueue upload_queue;
+    uint64_t       staging_size; // Largest single request, 0 for VRI_STREAM_QUEUE_DEFAULT_STAGING_SIZE
+    uint32_t       max_requests; // Pending at once and reading at once, 0 for VRI_STREAM_QUEUE_DEFAULT_MAX_REQUESTS
+} VriStreamQueueDesc;
+
+typedef struct {
+    intptr_t              file; // A HANDLE on Windows, opened with FILE_FLAG_OVERLAPPED to read in the background, a file descriptor elsewhere
+    uint64_t              offset;
+    VriTexture            texture;
+    VriTextureUpdateDesc  region;       // data.p_data is ignored, data.slice_pitch * depth bytes are read from offset
+    int32_t               priority;     // Higher streams first, equal priorities in request order
+    PFN_VriStreamCallback pfn_callback; // Optional, called once with the outcome
+    void                 *p_user_data;
+} VriStreamRequestDesc;
+
+// Budgets are what the OS lets the process use right now, and change as
+// other applications come and go
+typedef struct {
+    uint64_t budget;
+    uint64_t usage;
+} VriMemoryHeapBudget;
+
+typedef struct {
+    VriMemoryHeapBudget heaps[VRI_MEMORY_HEAP_COUNT];
+} VriMemoryBudget;
+
+// Called from vri_eviction_manager_update for every evicted texture, which is
+// no longer evictable afterwards. The callback usually destroys the texture or
+// hands it back to the streamer, and mustn't call into the eviction manager.
+typedef void (*PFN_VriEvictCallback)(void *p_user_data, VriTexture texture, uint64_t size);
+
+typedef struct {
+    VriMemoryHeap        heap;            // Watched heap, textures are counted against it
+    float                evict_threshold; // Usage / budget that starts evicting, 0 for 0.95
+    float                evict_target;    // Usage / budget evicting stops at, 0 for 0.85
+    uint32_t             max_resources;   // Evictable at once, 0 for VRI_EVICTION_MANAGER_DEFAULT_MAX_RESOURCES
+    PFN_VriEvictCallback pfn_evict;
+    void                *p_user_data;
+} VriEvictionManagerDesc;
+
+// Frames are copied into slot_count READBACK textures of the given size and
+// format, from the top left of mip 0, layer 0 of the source
+typedef struct {
+    VriQueue  queue;
+    uint32_t  width;
+    uint32_t  height;
+    VriFormat format;
+    uint32_t  slot_count; // Up to VRI_READBACK_RING_MAX_SLOTS, 0 for VRI_READBACK_RING_DEFAULT_SLOT_COUNT
+} VriReadbackRingDesc;
+
+// A mapped frame, readable from any thread until it's unmapped
+typedef struct {
+    uint64_t           frame_id;
+    uint32_t           width;
+    uint32_t           height;
+    VriFormat          format;
+    VriSubresourceData data;
+} VriReadbackFrame;
+
+// Reports warm-up progress, called from one warm-up thread at a time. The
+// others keep creating pipelines meanwhile, so a count can be skipped, but the
+// counts only grow and the last call reports total_count.
+typedef void (*PFN_VriPipelineWarmUpProgress)(void *p_user_data, uint32_t done_count, uint32_t total_count);
+
+// p_data is a manifest from vri_pipeline_manifest_get_data, usually saved by an earlier run
+typedef struct {
+    const void                   *p_data;
+    size_t                        size;
+    uint32_t                      thread_count; // Including the calling thread, 0 for one per CPU core
+    PFN_VriPipelineWarmUpProgress pfn_progress; // Optional
+    void                         *p_user_data;
+} VriPipelineWarmUpDesc;
+
 typedef struct {
     VriFence fence;
     uint64_t value;
@@ -417,6 +853,10 @@ typedef struct {
     VriCullMode  cull_mode;
     VriFrontFace front_face;
     VriBool      depth_clamp_enable;
+    VriBool      depth_bias_enable;
+    float        depth_bias_constant_factor; // Whole units of the depth format's resolution
+    float        depth_bias_clamp;
+    float        depth_bias_slope_factor;
 } VriRasterizationStateDesc;
 
 typedef struct {
@@ -454,17 +894,36 @@ typedef struct {
     uint32_t                    render_target_count;
     VriBool                     independent_blend_enable;
     VriBool                     alpha_to_coverage_enable;
+    float                       blend_constants[4];
 } VriColorBlendStateDesc;
 
 typedef struct {
     int placeholder;
 } VriPipelineLayoutDesc;
 
+// A value for the shader's specialization constant `constant_id`, as the bits of
+// a 32-bit bool, int or float. Backends whose bytecode has specialization
+// constants fold them in when the pipeline is created. D3D11 bytecode has none,
+// there the values are bound as a constant buffer at
+// VRI_SPECIALIZATION_CONSTANT_BUFFER_SLOT holding one uint per constant_id, so
+// shaders read constant_id N as element N of a uint array, and constants
+// without a value read 0 instead of their default.
+typedef struct {
+    uint32_t constant_id;
+    uint32_t value;
+} VriSpecializationConstant;
+
+// Describes a shader module, or a pipeline stage. A stage with a module uses
+// the module's bytecode and entry point instead of its own, and its stage has to
+// match the module's.
 typedef struct {
-    VriShaderStageFlagBits stage;
-    size_t                 size;
-    const void            *p_bytecode;
-    const char            *p_entry_point;
+    VriShaderStageFlagBits           stage;
+    size_t                           size;
+    const void                      *p_bytecode;
+    const char                      *p_entry_point;
+    const VriSpecializationConstant *p_specialization_constants; // Applied per pipeline, ids are unique
+    uint32_t                         specialization_constant_count;
+    VriShaderModule                  module; // Pipeline stages only, VRI_NULL_HANDLE to compile p_bytecode
 } VriShaderModuleDesc;
 
 typedef struct {
@@ -516,12 +975,24 @@ typedef struct {
     const VriDepthStencilStateDesc  *p_depth_stencil_state;
     const VriColorBlendStateDesc    *p_color_blend_state;
     const VriMultisampleStateDesc   *p_multisample_state;
+    VriDynamicStateFlags             dynamic_states;
 } VriGraphicsPipelineDesc;
 
 typedef struct {
     VriShaderModuleDesc *p_shader;
 } VriComputePipelineDesc;
 
+typedef struct {
+    VriPipelineLibraryFlags        parts;
+    const VriGraphicsPipelineDesc *p_desc;
+} VriPipelineLibraryDesc;
+
+// Every part has to come from exactly one of the libraries
+typedef struct {
+    const VriPipelineLibrary *p_libraries;
+    uint32_t                  library_count;
+} VriPipelineLinkDesc;
+
 typedef struct {
     const VriCommandBuffer   *p_command_buffers;
     uint32_t                  command_buffer_count;
@@ -541,19 +1012,75 @@ typedef struct {
     VriResult          *p_results; // Per-swapchain results (can be NULL)
 } VriQueuePresentDesc;
 
+// All counters are monotonic, so any two snapshots can be subtracted.
+// Average commands per command buffer is commands_recorded / command_buffers_recorded.
+typedef struct {
+    uint64_t command_buffers_recorded;
+    uint64_t command_buffers_submitted;
+    uint64_t queue_submits;
+    uint64_t commands_recorded;
+    uint64_t pipeline_binds;
+    uint64_t pipeline_binds_redundant; // Binds filtered out because the pipeline was already bound
+    uint64_t fence_waits;
+    uint64_t fence_waits_blocked; // Waits that actually had to block
+    uint64_t fence_wait_time_ns;  // Time spent blocked in fence waits
+    uint64_t presents;
+    uint64_t shader_module_reuses; // Shader module creates that returned an existing module
+    uint64_t pipeline_warm_hits;   // Pipeline creates that returned a pipeline from vri_pipelines_warm_up
+    uint64_t allocation_count[VRI_OBJECT_TYPE_COUNT];
+    uint64_t allocation_bytes[VRI_OBJECT_TYPE_COUNT];
+    uint64_t free_count[VRI_OBJECT_TYPE_COUNT];
+    uint64_t free_bytes[VRI_OBJECT_TYPE_COUNT];
+} VriStatisticsCounters;
+
+typedef struct {
+    VriStatisticsCounters total;      // Since device creation
+    VriStatisticsCounters last_frame; // Between the last two presents
+    uint64_t              frame_count;
+} VriDeviceStatistics;
+
+// Objects alive on a device, by type. Bytes are the storage of the objects
+// themselves, not of the API resources behind them. The device and its queues
+// are included.
+typedef struct {
+    uint64_t count[VRI_OBJECT_TYPE_COUNT];
+    uint64_t bytes[VRI_OBJECT_TYPE_COUNT];
+    uint64_t pool_bytes; // Slab memory held for objects, live and free slots
+} VriLiveObjects;
+
 typedef void (*PFN_VriDeviceDestroy)(VriDevice device);
+typedef VriResult (*PFN_VriDeviceQueryMemoryBudget)(VriDevice device, VriMemoryBudget *p_budget);
 typedef VriResult (*PFN_VriCommandPoolCreate)(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool);
 typedef void (*PFN_VriCommandPoolDestroy)(VriDevice device, VriCommandPool command_pool);
 typedef void (*PFN_VriCommandPoolReset)(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags);
 typedef VriResult (*PFN_VriCommandBuffersAllocate)(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers);
 typedef void (*PFN_VriCommandBuffersFree)(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers);
 typedef void (*PFN_VriCmdBindPipeline)(VriCommandBuffer command_buffer, VriPipeline pipeline);
+typedef void (*PFN_VriCmdUpdateTexture)(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc);
+typedef void (*PFN_VriCmdGenerateMips)(VriCommandBuffer command_buffer, VriTexture texture);
+typedef void (*PFN_VriCmdCopyTexture)(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc);
+typedef void (*PFN_VriCmdSetViewport)(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports);
+typedef void (*PFN_VriCmdSetScissor)(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors);
+typedef void (*PFN_VriCmdSetStencilReference)(VriCommandBuffer command_buffer, uint32_t reference);
+typedef void (*PFN_VriCmdSetBlendConstants)(VriCommandBuffer command_buffer, const float blend_constants[4]);
+typedef void (*PFN_VriCmdSetDepthBias)(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor);
 typedef VriResult (*PFN_VriShaderModuleCreate)(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module);
+typedef void (*PFN_VriShaderModuleDestroy)(VriDevice device, VriShaderModule shader_module);
 typedef VriResult (*PFN_VriPipelineLayoutCreate)(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout);
 typedef VriResult (*PFN_VriPipelineCreateGraphics)(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline);
 typedef VriResult (*PFN_VriPipelineCreateCompute)(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
+typedef void (*PFN_VriPipelineDestroy)(VriDevice device, VriPipeline pipeline);
+typedef VriResult (*PFN_VriPipelineLibraryCreate)(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library);
+typedef void (*PFN_VriPipelineLibraryDestroy)(VriDevice device, VriPipelineLibrary library);
+typedef VriResult (*PFN_VriPipelineLink)(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline);
 typedef VriResult (*PFN_VriTextureCreate)(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture);
 typedef void (*PFN_VriTextureDestroy)(VriDevice device, VriTexture texture);
+typedef void (*PFN_VriTextureGetTiling)(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling);
+typedef VriResult (*PFN_VriTextureGetTileFeedback)(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed);
+typedef VriResult (*PFN_VriTextureMap)(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data);
+typedef void (*PFN_VriTextureUnmap)(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer);
+typedef VriResult (*PFN_VriTileHeapCreate)(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap);
+typedef void (*PFN_VriTileHeapDestroy)(VriDevice device, VriTileHeap tile_heap);
 typedef VriResult (*PFN_VriFenceCreate)(VriDevice device, uint64_t initial_value, VriFence *p_fence);
 typedef void (*PFN_VriFenceDestroy)(VriDevice device, VriFence fence);
 typedef uint64_t (*PFN_VriFenceGetValue)(VriDevice device, VriFence fence);
@@ -562,6 +1089,8 @@ typedef VriResult (*PFN_VriSwapchainCreate)(VriDevice device, const VriSwapchain
 typedef void (*PFN_VriSwapchainDestroy)(VriDevice device, VriSwapchain swapchain);
 typedef VriResult (*PFN_VriSwapchainAcquireNextImage)(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index);
 typedef VriResult (*PFN_VriSwapchainPresent)(VriDevice device, VriSwapchain swapchain, VriFence fence);
+typedef VriResult (*PFN_VriSwapchainGetTexture)(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture);
+typedef VriResult (*PFN_VriSwapchainGetStats)(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats);
 
 VriResult vri_adapters_enumerate(
     VriAdapterProps *p_props,
@@ -570,6 +1099,26 @@ VriResult vri_adapters_enumerate(
 void vri_report_live_objects(
     void);
 
+// Never NULL, out of range formats get VRI_FORMAT_UNDEFINED's all-zero info
+const VriFormatInfo *vri_format_get_info(
+    VriFormat format);
+
+// Every BC format, VRI_ERROR_UNSUPPORTED for the others
+VriResult vri_bc_decode(
+    const VriBlockConvertDesc *p_desc);
+
+// BC1, BC3, BC4, BC5 and BC7, VRI_ERROR_UNSUPPORTED for the other formats.
+// BC7 is encoded in its single subset RGBA mode only.
+VriResult vri_bc_encode(
+    const VriBlockConvertDesc *p_desc);
+
+VriResult vri_mip_generate(
+    const VriMipGenerateDesc *p_desc);
+
+// VRI_ERROR_UNSUPPORTED for formats VriColorConvertDesc doesn't list
+VriResult vri_color_convert(
+    const VriColorConvertDesc *p_desc);
+
 VriResult vri_device_create(
     const VriDeviceDesc *p_desc,
     VriDevice           *p_device);
@@ -583,6 +1132,25 @@ void vri_device_get_queue(
     uint32_t     queue_index,
     VriQueue    *p_queue);
 
+// VRI_ERROR_UNSUPPORTED where the OS doesn't report budgets
+VriResult vri_device_query_memory_budget(
+    VriDevice        device,
+    VriMemoryBudget *p_budget);
+
+void vri_device_get_statistics(
+    VriDevice            device,
+    VriDeviceStatistics *p_statistics);
+
+void vri_device_get_live_objects(
+    VriDevice       device,
+    VriLiveObjects *p_live_objects);
+
+// Lists the objects created through the API and not yet destroyed via the
+// debug callback. Builds with VRI_ENABLE_OBJECT_TRACKING also print where each
+// one was created, as a return address to resolve with the debugger or addr2line.
+void vri_device_report_live_objects(
+    VriDevice device);
+
 VriResult vri_command_pool_create(
     VriDevice                 device,
     const VriCommandPoolDesc *p_desc,
@@ -612,6 +1180,67 @@ void vri_cmd_bind_pipeline(
     VriCommandBuffer command_buffer,
     VriPipeline      pipeline);
 
+// The data is copied while recording and can be released once this returns
+void vri_cmd_update_texture(
+    VriCommandBuffer            command_buffer,
+    VriTexture                  texture,
+    const VriTextureUpdateDesc *p_desc);
+
+// Fills every mip after the first from the one above it, on every layer. The
+// texture needs VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS and a renderable format.
+void vri_cmd_generate_mips(
+    VriCommandBuffer command_buffer,
+    VriTexture       texture);
+
+void vri_cmd_copy_texture(
+    VriCommandBuffer          command_buffer,
+    VriTexture                src,
+    VriTexture                dst,
+    const VriTextureCopyDesc *p_desc);
+
+// Dynamic state lasts until it's set again or the command buffer ends, across
+// pipeline binds. Pipelines without the matching VriDynamicStateFlagBits bit
+// use their own value and leave the dynamic one for the next pipeline.
+void vri_cmd_set_viewport(
+    VriCommandBuffer   command_buffer,
+    uint32_t           first_viewport,
+    uint32_t           viewport_count,
+    const VriViewport *p_viewports);
+
+void vri_cmd_set_scissor(
+    VriCommandBuffer command_buffer,
+    uint32_t         first_scissor,
+    uint32_t         scissor_count,
+    const VriRect2D *p_scissors);
+
+void vri_cmd_set_stencil_reference(
+    VriCommandBuffer command_buffer,
+    uint32_t         reference);
+
+void vri_cmd_set_blend_constants(
+    VriCommandBuffer command_buffer,
+    const float      blend_constants[4]);
+
+void vri_cmd_set_depth_bias(
+    VriCommandBuffer command_buffer,
+    float            constant_factor,
+    float            clamp,
+    float            slope_factor);
+
+// Shader modules are deduplicated device-wide by a hash of their stage, entry
+// point and bytecode. Creating a module that already exists returns it with
+// another reference, every create is matched by a vri_shader_module_destroy.
+// Specialization constants are given per pipeline and aren't part of a module.
+VriResult vri_shader_module_create(
+    VriDevice                  device,
+    const VriShaderModuleDesc *p_desc,
+    VriShaderModule           *p_shader_module);
+
+// Pipelines created from the module stay valid
+void vri_shader_module_destroy(
+    VriDevice       device,
+    VriShaderModule shader_module);
+
 VriResult vri_pipeline_layout_create(
     VriDevice                    device,
     const VriPipelineLayoutDesc *p_desc,
@@ -627,6 +1256,27 @@ VriResult vri_pipeline_create_compute(
     const VriComputePipelineDesc *p_desc,
     VriPipeline                  *p_pipeline);
 
+void vri_pipeline_destroy(
+    VriDevice   device,
+    VriPipeline pipeline);
+
+// Compiles the parts of a graphics pipeline once, so pipelines that share
+// them only pay for vri_pipeline_link
+VriResult vri_pipeline_library_create(
+    VriDevice                     device,
+    const VriPipelineLibraryDesc *p_desc,
+    VriPipelineLibrary           *p_library);
+
+// Pipelines linked from the library stay valid
+void vri_pipeline_library_destroy(
+    VriDevice          device,
+    VriPipelineLibrary library);
+
+VriResult vri_pipeline_link(
+    VriDevice                  device,
+    const VriPipelineLinkDesc *p_desc,
+    VriPipeline               *p_pipeline);
+
 VriResult vri_texture_create(
     VriDevice             device,
     const VriTextureDesc *p_desc,
@@ -636,6 +1286,46 @@ void vri_texture_destroy(
     VriDevice  device,
     VriTexture texture);
 
+// Only for textures created with VRI_TEXTURE_USAGE_BIT_SPARSE
+void vri_texture_get_tiling(
+    VriDevice         device,
+    VriTexture        texture,
+    VriTextureTiling *p_tiling);
+
+// Residency feedback: one byte per tile in VriTextureTiling order, non-zero
+// for the tiles the GPU accessed since the last call, which clears them.
+// VRI_ERROR_UNSUPPORTED where the backend can't observe accesses.
+VriResult vri_texture_get_tile_feedback(
+    VriDevice  device,
+    VriTexture texture,
+    uint32_t   tile_count,
+    uint8_t   *p_accessed);
+
+// Only for READBACK textures. Mapping doesn't wait for the GPU, so the copies
+// into the texture have to be known done, VRI_TIMEOUT if they're not.
+VriResult vri_texture_map(
+    VriDevice           device,
+    VriTexture          texture,
+    uint32_t            mip_level,
+    uint32_t            array_layer,
+    VriSubresourceData *p_data);
+
+void vri_texture_unmap(
+    VriDevice  device,
+    VriTexture texture,
+    uint32_t   mip_level,
+    uint32_t   array_layer);
+
+VriResult vri_tile_heap_create(
+    VriDevice              device,
+    const VriTileHeapDesc *p_desc,
+    VriTileHeap           *p_tile_heap);
+
+// Tiles still bound from the heap have to be rebound before the texture is used again
+void vri_tile_heap_destroy(
+    VriDevice   device,
+    VriTileHeap tile_heap);
+
 VriResult vri_fence_create(
     VriDevice device,
     uint64_t  initial_value,
@@ -666,6 +1356,8 @@ void vri_swapchain_destroy(
     VriDevice    device,
     VriSwapchain swapchain);
 
+// Headless swapchains wait for the vblank that frees an image. Acquiring
+// while every image but the shown one is acquired fails.
 VriResult vri_swapchain_acquire_next_image(
     VriDevice    device,
     VriSwapchain swapchain,
@@ -673,11 +1365,25 @@ VriResult vri_swapchain_acquire_next_image(
     uint64_t     signal_value,
     uint32_t    *p_image_index);
 
+// Headless swapchains present the image acquired last
 VriResult vri_swapchain_present(
     VriDevice    device,
     VriSwapchain swapchain,
     VriFence     fence);
 
+// The texture is owned by the swapchain and destroyed with it
+VriResult vri_swapchain_get_texture(
+    VriDevice    device,
+    VriSwapchain swapchain,
+    uint32_t     image_index,
+    VriTexture  *p_texture);
+
+// VRI_ERROR_UNSUPPORTED for swapchains with a window
+VriResult vri_swapchain_get_stats(
+    VriDevice          device,
+    VriSwapchain       swapchain,
+    VriSwapchainStats *p_stats);
+
 typedef VriResult (*PFN_VriCommandBufferBegin)(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc);
 typedef VriResult (*PFN_VriCommandBufferEnd)(VriCommandBuffer command_buffer);
 typedef VriResult (*PFN_VriCommandBufferReset)(VriCommandBuffer command_buffer);
@@ -695,6 +1401,7 @@ VriResult vri_command_buffer_reset(
 typedef VriResult (*PFN_VriQueueSubmit)(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count);
 typedef VriResult (*PFN_VriQueueWaitIdle)(VriQueue queue);
 typedef VriResult (*PFN_VriQueuePresent)(VriQueue queue, const VriQueuePresentDesc *p_present);
+typedef VriResult (*PFN_VriQueueBindSparse)(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count);
 
 VriResult vri_queue_submit(
     VriQueue                  queue,
@@ -708,6 +1415,171 @@ VriResult vri_queue_present(
     VriQueue                   queue,
     const VriQueuePresentDesc *p_present);
 
+// Ordered with the queue's submits: work submitted after the call sees the new
+// bindings. On D3D11 a texture maps to one heap at a time, binding tiles from
+// another heap unbinds the ones from the previous heap.
+VriResult vri_queue_bind_sparse(
+    VriQueue                 queue,
+    const VriSparseBindDesc *p_binds,
+    uint32_t                 bind_count);
+
+// Upload queues are externally synchronized, like command buffers
+VriResult vri_upload_queue_create(
+    VriDevice                 device,
+    const VriUploadQueueDesc *p_desc,
+    VriUploadQueue           *p_upload_queue);
+
+// Waits for every submitted batch and drops the one being recorded
+void vri_upload_queue_destroy(
+    VriDevice      device,
+    VriUploadQueue upload_queue);
+
+VriResult vri_upload_queue_update_texture(
+    VriUploadQueue              upload_queue,
+    VriTexture                  texture,
+    const VriTextureUpdateDesc *p_desc);
+
+// Submits the batch being recorded. *p_fence_value is what the upload queue's
+// fence reaches once everything uploaded so far is on the GPU.
+VriResult vri_upload_queue_flush(
+    VriUploadQueue upload_queue,
+    uint64_t      *p_fence_value);
+
+VriFence vri_upload_queue_get_fence(
+    VriUploadQueue upload_queue);
+
+// Stream queues read file ranges into their staging memory and record them
+// into an upload queue, highest priority first. They're externally
+// synchronized, and the upload queue shouldn't be used by anything else.
+VriResult vri_stream_queue_create(
+    VriDevice                 device,
+    const VriStreamQueueDesc *p_desc,
+    VriStreamQueue           *p_stream_queue);
+
+// Waits for the reads in flight, they and the pending requests are cancelled
+void vri_stream_queue_destroy(
+    VriDevice      device,
+    VriStreamQueue stream_queue);
+
+VriResult vri_stream_queue_request(
+    VriStreamQueue              stream_queue,
+    const VriStreamRequestDesc *p_desc,
+    uint64_t                   *p_request_id);
+
+// VRI_INCOMPLETE if the request isn't pending anymore
+VriResult vri_stream_queue_cancel(
+    VriStreamQueue stream_queue,
+    uint64_t       request_id);
+
+// Records the reads that completed since the last call, starts reading
+// pending requests until byte_budget bytes are in flight or the staging memory
+// is full, then flushes the upload queue. Reads stay in flight between calls,
+// and VRI_INCOMPLETE means some are, so the call should come again.
+// *p_fence_value is when everything recorded so far is resident.
+VriResult vri_stream_queue_process(
+    VriStreamQueue stream_queue,
+    uint64_t       byte_budget,
+    uint64_t      *p_fence_value);
+
+// Eviction managers keep a set of textures the application can do without and
+// evict the lowest priority ones when the watched heap nears its budget. They're
+// externally synchronized. Textures have to be removed before they're destroyed
+// by anything other than the eviction callback.
+VriResult vri_eviction_manager_create(
+    VriDevice                     device,
+    const VriEvictionManagerDesc *p_desc,
+    VriEvictionManager           *p_eviction_manager);
+
+void vri_eviction_manager_destroy(
+    VriDevice          device,
+    VriEvictionManager eviction_manager);
+
+// Lower priorities are evicted first, equal ones in the order they were last
+// set. Setting an evictable texture again updates its priority.
+VriResult vri_eviction_manager_set_evictable(
+    VriEvictionManager eviction_manager,
+    VriTexture         texture,
+    int32_t            priority);
+
+// VRI_INCOMPLETE if the texture isn't evictable
+VriResult vri_eviction_manager_remove(
+    VriEvictionManager eviction_manager,
+    VriTexture         texture);
+
+// Queries the budget, usually once a frame. Over the threshold, textures are
+// evicted until usage would be back at the target. *p_evicted_bytes is what
+// was evicted, VRI_INCOMPLETE if evicting everything wasn't enough.
+VriResult vri_eviction_manager_update(
+    VriEvictionManager eviction_manager,
+    uint64_t          *p_evicted_bytes);
+
+// Readback rings copy frames into CPU memory for encoders and the like.
+// Nothing ever waits: a frame is dropped with VRI_INCOMPLETE when the next
+// slot is still waiting to be mapped, and mapping returns VRI_INCOMPLETE
+// until the oldest copy is done. The ring is externally synchronized with
+// the queue it submits to.
+VriResult vri_readback_ring_create(
+    VriDevice                  device,
+    const VriReadbackRingDesc *p_desc,
+    VriReadbackRing           *p_readback_ring);
+
+void vri_readback_ring_destroy(
+    VriDevice       device,
+    VriReadbackRing readback_ring);
+
+// Submitted after everything already submitted to the queue
+VriResult vri_readback_ring_copy(
+    VriReadbackRing readback_ring,
+    VriTexture      texture,
+    uint64_t       *p_frame_id);
+
+// Maps the oldest copied frame. Frames can stay mapped while later ones are
+// mapped, every one of them until vri_readback_ring_unmap
+VriResult vri_readback_ring_map(
+    VriReadbackRing   readback_ring,
+    VriReadbackFrame *p_frame);
+
+// VRI_INCOMPLETE if the frame isn't mapped
+VriResult vri_readback_ring_unmap(
+    VriReadbackRing readback_ring,
+    uint64_t        frame_id);
+
+// Pipeline manifests record the desc of every graphics and compute pipeline
+// the device creates while they exist, once per distinct desc and with the
+// shader bytecode included. One manifest records at a time. Saved with the
+// application's data, it lets the next run create those pipelines with
+// vri_pipelines_warm_up before they're first used.
+VriResult vri_pipeline_manifest_create(
+    VriDevice            device,
+    VriPipelineManifest *p_manifest);
+
+void vri_pipeline_manifest_destroy(
+    VriDevice           device,
+    VriPipelineManifest manifest);
+
+// With p_data NULL, *p_size is set to the size of the manifest's data.
+// Otherwise up to *p_size bytes are written, VRI_INCOMPLETE if that's not all.
+VriResult vri_pipeline_manifest_get_data(
+    VriPipelineManifest manifest,
+    size_t             *p_size,
+    void               *p_data);
+
+// Creates every pipeline of a manifest on thread_count threads and returns
+// once they're all created. A later create with one of the recorded descs gets
+// the warm pipeline instead of compiling its own. The call blocks for the whole
+// warm-up, with the calling thread as one of the workers, so it belongs on a
+// loading thread of the application's: the render thread keeps drawing the
+// loading screen from pfn_progress's counts meanwhile. Pipelines that fail to
+// create are skipped, which returns VRI_INCOMPLETE.
+VriResult vri_pipelines_warm_up(
+    VriDevice                    device,
+    const VriPipelineWarmUpDesc *p_desc);
+
+// Destroys the warm pipelines no create asked for, which vri_device_destroy
+// also does. Not while a warm-up runs.
+void vri_pipelines_warm_release(
+    VriDevice device);
+
 #ifdef __cplusplus
 }
 #endif
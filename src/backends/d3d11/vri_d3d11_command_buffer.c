@@ -3,24 +3,33 @@
 #include "vri_d3d11_device.h"
 #include "vri_d3d11_pipeline.h"
 
+#include <string.h>
+
 #define COMMAND_BUFFER_OBJECT_SIZE (sizeof(struct VriCommandBuffer_T) + sizeof(VriD3D11CommandBuffer))
 
-static VriResult d3d11_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers);
-static void      d3d11_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers);
-static VriResult d3d11_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc);
-static VriResult d3d11_command_buffer_end(VriCommandBuffer command_buffer);
-static VriResult d3d11_command_buffer_reset(VriCommandBuffer command_buffer);
+static const VriD3D11Pipeline *d3d11_bound_graphics_pipeline(VriCommandBuffer command_buffer, VriDynamicStateFlags dynamic_state);
 
 void d3d11_register_command_buffer_functions(VriDeviceDispatchTable *table) {
     table->pfn_command_buffers_allocate = d3d11_command_buffers_allocate;
     table->pfn_command_buffers_free = d3d11_command_buffers_free;
 }
 
-static VriResult d3d11_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
+void d3d11_register_command_buffer_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
+    table->pfn_command_buffer_begin = d3d11_command_buffer_begin;
+    table->pfn_command_buffer_end = d3d11_command_buffer_end;
+    table->pfn_command_buffer_reset = d3d11_command_buffer_reset;
+    table->pfn_cmd_set_viewport = d3d11_cmd_set_viewport;
+    table->pfn_cmd_set_scissor = d3d11_cmd_set_scissor;
+    table->pfn_cmd_set_stencil_reference = d3d11_cmd_set_stencil_reference;
+    table->pfn_cmd_set_blend_constants = d3d11_cmd_set_blend_constants;
+    table->pfn_cmd_set_depth_bias = d3d11_cmd_set_depth_bias;
+}
+
+VriResult d3d11_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
     VriDebugCallback dbg = device->debug_callback;
 
     for (uint32_t i = 0; i < p_desc->command_buffer_count; ++i) {
-        VriCommandBuffer cmd = vri_object_allocate(device, &device->allocation_callback, COMMAND_BUFFER_OBJECT_SIZE, VRI_OBJECT_COMMAND_BUFFER);
+        VriCommandBuffer cmd = vri_object_allocate(device, &device->allocation_callback, COMMAND_BUFFER_OBJECT_SIZE, VRI_OBJECT_TYPE_COMMAND_BUFFER);
         if (!cmd) return VRI_ERROR_OUT_OF_MEMORY;
         cmd->p_backend_data = (VriD3D11CommandBuffer *)(cmd + 1);
 
@@ -41,17 +50,11 @@ static VriResult d3d11_command_buffers_allocate(VriDevice device, const VriComma
             return VRI_ERROR_UNSUPPORTED;
         }
 
-        // Fill up the dispatch table
-        // TODO: Move to a separate function
-        cmd->dispatch.pfn_command_buffer_begin = d3d11_command_buffer_begin;
-        cmd->dispatch.pfn_command_buffer_end = d3d11_command_buffer_end;
-        cmd->dispatch.pfn_command_buffer_reset = d3d11_command_buffer_reset;
+        // Layers may have wrapped the device's table, so always copy it from there
+        cmd->dispatch = device->command_buffer_dispatch;
 
-        // Fill from pipeline
-        d3d11_register_pipeline_functions_with_command_buffer(&cmd->dispatch);
-
-        cmd->state = VRI_COMMAND_BUFFER_STATE_INITIAL;
         impl->p_command_list = NULL;
+        impl->p_depth_bias_rasterizer_state = NULL;
         p_command_buffers[i] = cmd;
 
         COM_RELEASE(base_context);
@@ -60,51 +63,120 @@ static VriResult d3d11_command_buffers_allocate(VriDevice device, const VriComma
     return VRI_SUCCESS;
 }
 
-static void d3d11_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
+void d3d11_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
     (void)command_pool;
     for (uint32_t i = 0; i < command_buffer_count; i++) {
         VriD3D11CommandBuffer *impl = (VriD3D11CommandBuffer *)p_command_buffers[i]->p_backend_data;
 
         COM_SAFE_RELEASE(impl->p_deferred_context);
         COM_SAFE_RELEASE(impl->p_command_list);
+        COM_SAFE_RELEASE(impl->p_depth_bias_rasterizer_state);
 
-        device->allocation_callback.pfn_free(p_command_buffers[i], COMMAND_BUFFER_OBJECT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, p_command_buffers[i], COMMAND_BUFFER_OBJECT_SIZE);
     }
 }
 
-static VriResult d3d11_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
+VriResult d3d11_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
     (void)p_desc;
 
-    command_buffer->pipeline = NULL;
-
-    if (command_buffer->state != VRI_COMMAND_BUFFER_STATE_INITIAL &&
-        command_buffer->state != VRI_COMMAND_BUFFER_STATE_EXECUTABLE) {
-        return VRI_ERROR_INVALID_API_USAGE;
-    }
+    // The deferred context starts from default state, so does the dynamic state
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    cb->viewport_count = 0;
+    cb->scissor_count = 0;
+    cb->stencil_reference = 0;
+    memset(cb->blend_constants, 0, sizeof(cb->blend_constants));
+    cb->depth_bias_constant_factor = 0.0f;
+    cb->depth_bias_clamp = 0.0f;
+    cb->depth_bias_slope_factor = 0.0f;
 
-    command_buffer->state = VRI_COMMAND_BUFFER_STATE_RECORDING;
+    command_buffer->pipeline = NULL;
 
     return VRI_SUCCESS;
 }
 
-static VriResult d3d11_command_buffer_end(VriCommandBuffer command_buffer) {
-    if (command_buffer->state != VRI_COMMAND_BUFFER_STATE_RECORDING)
-        return VRI_ERROR_INVALID_API_USAGE;
-
+VriResult d3d11_command_buffer_end(VriCommandBuffer command_buffer) {
     VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
 
     HRESULT hr = cb->p_deferred_context->lpVtbl->FinishCommandList(cb->p_deferred_context, FALSE, &cb->p_command_list);
     if (FAILED(hr)) return VRI_ERROR_SYSTEM_FAILURE;
 
-    command_buffer->state = VRI_COMMAND_BUFFER_STATE_EXECUTABLE;
     return VRI_SUCCESS;
 }
 
-static VriResult d3d11_command_buffer_reset(VriCommandBuffer command_buffer) {
+VriResult d3d11_command_buffer_reset(VriCommandBuffer command_buffer) {
     VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
 
     COM_SAFE_RELEASE(cb->p_command_list);
-    command_buffer->state = VRI_COMMAND_BUFFER_STATE_INITIAL;
 
     return VRI_SUCCESS;
 }
+
+// RSSetViewports and RSSetScissorRects replace the whole array, so the ranges are merged into a copy first
+void d3d11_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+
+    for (uint32_t i = 0; i < viewport_count; ++i) {
+        cb->viewports[first_viewport + i] = (D3D11_VIEWPORT){
+            .TopLeftX = p_viewports[i].x,
+            .TopLeftY = p_viewports[i].y,
+            .Width = p_viewports[i].width,
+            .Height = p_viewports[i].height,
+            .MinDepth = p_viewports[i].min_depth,
+            .MaxDepth = p_viewports[i].max_depth,
+        };
+    }
+    cb->viewport_count = VRI_MAX(cb->viewport_count, first_viewport + viewport_count);
+
+    cb->p_deferred_context->lpVtbl->RSSetViewports(cb->p_deferred_context, cb->viewport_count, cb->viewports);
+}
+
+void d3d11_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+
+    for (uint32_t i = 0; i < scissor_count; ++i) {
+        cb->scissors[first_scissor + i] = (D3D11_RECT){
+            .left = p_scissors[i].x,
+            .top = p_scissors[i].y,
+            .right = p_scissors[i].x + (LONG)p_scissors[i].width,
+            .bottom = p_scissors[i].y + (LONG)p_scissors[i].height,
+        };
+    }
+    cb->scissor_count = VRI_MAX(cb->scissor_count, first_scissor + scissor_count);
+
+    cb->p_deferred_context->lpVtbl->RSSetScissorRects(cb->p_deferred_context, cb->scissor_count, cb->scissors);
+}
+
+void d3d11_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    cb->stencil_reference = reference;
+
+    const VriD3D11Pipeline *pipeline = d3d11_bound_graphics_pipeline(command_buffer, VRI_DYNAMIC_STATE_FLAG_BIT_STENCIL_REFERENCE);
+    if (pipeline) d3d11_cmd_apply_depth_stencil_state(command_buffer, pipeline);
+}
+
+void d3d11_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    memcpy(cb->blend_constants, blend_constants, sizeof(cb->blend_constants));
+
+    const VriD3D11Pipeline *pipeline = d3d11_bound_graphics_pipeline(command_buffer, VRI_DYNAMIC_STATE_FLAG_BIT_BLEND_CONSTANTS);
+    if (pipeline) d3d11_cmd_apply_blend_state(command_buffer, pipeline);
+}
+
+void d3d11_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    cb->depth_bias_constant_factor = constant_factor;
+    cb->depth_bias_clamp = clamp;
+    cb->depth_bias_slope_factor = slope_factor;
+
+    const VriD3D11Pipeline *pipeline = d3d11_bound_graphics_pipeline(command_buffer, VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS);
+    if (pipeline) d3d11_cmd_apply_rasterizer_state(command_buffer, pipeline);
+}
+
+// The bound pipeline if it takes the given state from the command buffer, otherwise the value waits for the next bind
+static const VriD3D11Pipeline *d3d11_bound_graphics_pipeline(VriCommandBuffer command_buffer, VriDynamicStateFlags dynamic_state) {
+    if (!command_buffer->pipeline) return NULL;
+
+    const VriD3D11Pipeline *pipeline = command_buffer->pipeline->p_backend_data;
+    if (pipeline->p_compute_shader || !(pipeline->dynamic_states & dynamic_state)) return NULL;
+    return pipeline;
+}
@@ -3,11 +3,33 @@
 
 #include "vri_d3d11_common.h"
 
+// Dynamic state is kept while recording, so pipelines bound later can pick it up
 typedef struct {
-    ID3D11DeviceContext4 *p_deferred_context;
-    ID3D11CommandList    *p_command_list;
+    ID3D11DeviceContext4  *p_deferred_context;
+    ID3D11CommandList     *p_command_list;
+    ID3D11RasterizerState *p_depth_bias_rasterizer_state; // The bound pipeline's rasterizer state with the dynamic depth bias
+    D3D11_VIEWPORT         viewports[VRI_MAX_VIEWPORTS];
+    D3D11_RECT             scissors[VRI_MAX_VIEWPORTS];
+    uint32_t               viewport_count;
+    uint32_t               scissor_count;
+    uint32_t               stencil_reference;
+    float                  blend_constants[4];
+    float                  depth_bias_constant_factor;
+    float                  depth_bias_clamp;
+    float                  depth_bias_slope_factor;
 } VriD3D11CommandBuffer;
 
-void d3d11_register_command_buffer_functions(VriDeviceDispatchTable *table);
+void      d3d11_register_command_buffer_functions(VriDeviceDispatchTable *table);
+void      d3d11_register_command_buffer_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+VriResult d3d11_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers);
+void      d3d11_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers);
+VriResult d3d11_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc);
+VriResult d3d11_command_buffer_end(VriCommandBuffer command_buffer);
+VriResult d3d11_command_buffer_reset(VriCommandBuffer command_buffer);
+void      d3d11_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports);
+void      d3d11_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors);
+void      d3d11_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference);
+void      d3d11_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]);
+void      d3d11_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor);
 
 #endif
@@ -3,6 +3,9 @@
 
 #include "vri_d3d11_common.h"
 
-void d3d11_register_command_pool_functions(VriDeviceDispatchTable *table);
+void      d3d11_register_command_pool_functions(VriDeviceDispatchTable *table);
+VriResult d3d11_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool);
+void      d3d11_command_pool_destroy(VriDevice device, VriCommandPool command_pool);
+void      d3d11_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags);
 
 #endif
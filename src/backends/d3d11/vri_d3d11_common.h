@@ -17,6 +17,13 @@
         }                                  \
     } while (0)
 
+#define COM_SAFE_ADDREF(obj)              \
+    do {                                  \
+        if ((obj)) {                      \
+            (obj)->lpVtbl->AddRef((obj)); \
+        }                                 \
+    } while (0)
+
 #define COM_IID_PPV_ARGS(type, ppType) \
     &IID_##type, (void **)(ppType)
 
@@ -32,24 +39,167 @@ const static VriDXGIFormatPair vri_to_dxgi[VRI_FORMAT_COUNT] = {
     [VRI_FORMAT_R8G8B8A8_UNORM] = {
         .typeless = DXGI_FORMAT_R8G8B8A8_TYPELESS,
         .typed = DXGI_FORMAT_R8G8B8A8_UNORM},
+    [VRI_FORMAT_R8G8B8A8_SRGB] = {
+        .typeless = DXGI_FORMAT_R8G8B8A8_TYPELESS,
+        .typed = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB},
+    [VRI_FORMAT_B8G8R8A8_UNORM] = {
+        .typeless = DXGI_FORMAT_B8G8R8A8_TYPELESS,
+        .typed = DXGI_FORMAT_B8G8R8A8_UNORM},
+    [VRI_FORMAT_B8G8R8A8_SRGB] = {
+        .typeless = DXGI_FORMAT_B8G8R8A8_TYPELESS,
+        .typed = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB},
+    [VRI_FORMAT_R8_UNORM] = {
+        .typeless = DXGI_FORMAT_R8_TYPELESS,
+        .typed = DXGI_FORMAT_R8_UNORM},
+    [VRI_FORMAT_R8G8_UNORM] = {
+        .typeless = DXGI_FORMAT_R8G8_TYPELESS,
+        .typed = DXGI_FORMAT_R8G8_UNORM},
+    [VRI_FORMAT_R10G10B10A2_UNORM] = {
+        .typeless = DXGI_FORMAT_R10G10B10A2_TYPELESS,
+        .typed = DXGI_FORMAT_R10G10B10A2_UNORM},
+    [VRI_FORMAT_R11G11B10_FLOAT] = {
+        .typeless = DXGI_FORMAT_R11G11B10_FLOAT,
+        .typed = DXGI_FORMAT_R11G11B10_FLOAT},
+    [VRI_FORMAT_R16_FLOAT] = {
+        .typeless = DXGI_FORMAT_R16_TYPELESS,
+        .typed = DXGI_FORMAT_R16_FLOAT},
+    [VRI_FORMAT_R16G16_FLOAT] = {
+        .typeless = DXGI_FORMAT_R16G16_TYPELESS,
+        .typed = DXGI_FORMAT_R16G16_FLOAT},
+    [VRI_FORMAT_R16G16B16A16_FLOAT] = {
+        .typeless = DXGI_FORMAT_R16G16B16A16_TYPELESS,
+        .typed = DXGI_FORMAT_R16G16B16A16_FLOAT},
+    [VRI_FORMAT_R32_FLOAT] = {
+        .typeless = DXGI_FORMAT_R32_TYPELESS,
+        .typed = DXGI_FORMAT_R32_FLOAT},
+    [VRI_FORMAT_R32G32_FLOAT] = {
+        .typeless = DXGI_FORMAT_R32G32_TYPELESS,
+        .typed = DXGI_FORMAT_R32G32_FLOAT},
+    [VRI_FORMAT_R32G32B32_FLOAT] = {
+        .typeless = DXGI_FORMAT_R32G32B32_TYPELESS,
+        .typed = DXGI_FORMAT_R32G32B32_FLOAT},
+    [VRI_FORMAT_R32G32B32A32_FLOAT] = {
+        .typeless = DXGI_FORMAT_R32G32B32A32_TYPELESS,
+        .typed = DXGI_FORMAT_R32G32B32A32_FLOAT},
+    [VRI_FORMAT_R16_UINT] = {
+        .typeless = DXGI_FORMAT_R16_TYPELESS,
+        .typed = DXGI_FORMAT_R16_UINT},
+    [VRI_FORMAT_R32_UINT] = {
+        .typeless = DXGI_FORMAT_R32_TYPELESS,
+        .typed = DXGI_FORMAT_R32_UINT},
+    [VRI_FORMAT_D16_UNORM] = {
+        .typeless = DXGI_FORMAT_R16_TYPELESS,
+        .typed = DXGI_FORMAT_D16_UNORM},
+    [VRI_FORMAT_D24_UNORM_S8_UINT] = {
+        .typeless = DXGI_FORMAT_R24G8_TYPELESS,
+        .typed = DXGI_FORMAT_D24_UNORM_S8_UINT},
+    [VRI_FORMAT_D32_FLOAT] = {
+        .typeless = DXGI_FORMAT_R32_TYPELESS,
+        .typed = DXGI_FORMAT_D32_FLOAT},
+    [VRI_FORMAT_D32_FLOAT_S8_UINT] = {
+        .typeless = DXGI_FORMAT_R32G8X24_TYPELESS,
+        .typed = DXGI_FORMAT_D32_FLOAT_S8X24_UINT},
+    [VRI_FORMAT_BC1_UNORM] = {
+        .typeless = DXGI_FORMAT_BC1_TYPELESS,
+        .typed = DXGI_FORMAT_BC1_UNORM},
+    [VRI_FORMAT_BC1_SRGB] = {
+        .typeless = DXGI_FORMAT_BC1_TYPELESS,
+        .typed = DXGI_FORMAT_BC1_UNORM_SRGB},
+    [VRI_FORMAT_BC2_UNORM] = {
+        .typeless = DXGI_FORMAT_BC2_TYPELESS,
+        .typed = DXGI_FORMAT_BC2_UNORM},
+    [VRI_FORMAT_BC2_SRGB] = {
+        .typeless = DXGI_FORMAT_BC2_TYPELESS,
+        .typed = DXGI_FORMAT_BC2_UNORM_SRGB},
+    [VRI_FORMAT_BC3_UNORM] = {
+        .typeless = DXGI_FORMAT_BC3_TYPELESS,
+        .typed = DXGI_FORMAT_BC3_UNORM},
+    [VRI_FORMAT_BC3_SRGB] = {
+        .typeless = DXGI_FORMAT_BC3_TYPELESS,
+        .typed = DXGI_FORMAT_BC3_UNORM_SRGB},
+    [VRI_FORMAT_BC4_UNORM] = {
+        .typeless = DXGI_FORMAT_BC4_TYPELESS,
+        .typed = DXGI_FORMAT_BC4_UNORM},
+    [VRI_FORMAT_BC4_SNORM] = {
+        .typeless = DXGI_FORMAT_BC4_TYPELESS,
+        .typed = DXGI_FORMAT_BC4_SNORM},
+    [VRI_FORMAT_BC5_UNORM] = {
+        .typeless = DXGI_FORMAT_BC5_TYPELESS,
+        .typed = DXGI_FORMAT_BC5_UNORM},
+    [VRI_FORMAT_BC5_SNORM] = {
+        .typeless = DXGI_FORMAT_BC5_TYPELESS,
+        .typed = DXGI_FORMAT_BC5_SNORM},
+    [VRI_FORMAT_BC6H_UFLOAT] = {
+        .typeless = DXGI_FORMAT_BC6H_TYPELESS,
+        .typed = DXGI_FORMAT_BC6H_UF16},
+    [VRI_FORMAT_BC6H_SFLOAT] = {
+        .typeless = DXGI_FORMAT_BC6H_TYPELESS,
+        .typed = DXGI_FORMAT_BC6H_SF16},
+    [VRI_FORMAT_BC7_UNORM] = {
+        .typeless = DXGI_FORMAT_BC7_TYPELESS,
+        .typed = DXGI_FORMAT_BC7_UNORM},
+    [VRI_FORMAT_BC7_SRGB] = {
+        .typeless = DXGI_FORMAT_BC7_TYPELESS,
+        .typed = DXGI_FORMAT_BC7_UNORM_SRGB},
 };
 
-const static VriFormat dxgi_to_vri[] = {
+// Typed formats only. A typeless format stands for its whole family, R32_TYPELESS
+// is R32_FLOAT, R32_UINT and D32_FLOAT alike, so there's no one format to map it to.
+const static VriFormat dxgi_to_vri[DXGI_FORMAT_BC7_UNORM_SRGB + 1] = {
     [DXGI_FORMAT_R8G8B8A8_UNORM] = VRI_FORMAT_R8G8B8A8_UNORM,
+    [DXGI_FORMAT_R8G8B8A8_UNORM_SRGB] = VRI_FORMAT_R8G8B8A8_SRGB,
+    [DXGI_FORMAT_B8G8R8A8_UNORM] = VRI_FORMAT_B8G8R8A8_UNORM,
+    [DXGI_FORMAT_B8G8R8A8_UNORM_SRGB] = VRI_FORMAT_B8G8R8A8_SRGB,
+    [DXGI_FORMAT_R8_UNORM] = VRI_FORMAT_R8_UNORM,
+    [DXGI_FORMAT_R8G8_UNORM] = VRI_FORMAT_R8G8_UNORM,
+    [DXGI_FORMAT_R10G10B10A2_UNORM] = VRI_FORMAT_R10G10B10A2_UNORM,
+    [DXGI_FORMAT_R11G11B10_FLOAT] = VRI_FORMAT_R11G11B10_FLOAT,
+    [DXGI_FORMAT_R16_FLOAT] = VRI_FORMAT_R16_FLOAT,
+    [DXGI_FORMAT_R16G16_FLOAT] = VRI_FORMAT_R16G16_FLOAT,
+    [DXGI_FORMAT_R16G16B16A16_FLOAT] = VRI_FORMAT_R16G16B16A16_FLOAT,
+    [DXGI_FORMAT_R32_FLOAT] = VRI_FORMAT_R32_FLOAT,
+    [DXGI_FORMAT_R32G32_FLOAT] = VRI_FORMAT_R32G32_FLOAT,
+    [DXGI_FORMAT_R32G32B32_FLOAT] = VRI_FORMAT_R32G32B32_FLOAT,
+    [DXGI_FORMAT_R32G32B32A32_FLOAT] = VRI_FORMAT_R32G32B32A32_FLOAT,
+    [DXGI_FORMAT_R16_UINT] = VRI_FORMAT_R16_UINT,
+    [DXGI_FORMAT_R32_UINT] = VRI_FORMAT_R32_UINT,
+    [DXGI_FORMAT_D16_UNORM] = VRI_FORMAT_D16_UNORM,
+    [DXGI_FORMAT_D24_UNORM_S8_UINT] = VRI_FORMAT_D24_UNORM_S8_UINT,
+    [DXGI_FORMAT_D32_FLOAT] = VRI_FORMAT_D32_FLOAT,
+    [DXGI_FORMAT_D32_FLOAT_S8X24_UINT] = VRI_FORMAT_D32_FLOAT_S8_UINT,
+    [DXGI_FORMAT_BC1_UNORM] = VRI_FORMAT_BC1_UNORM,
+    [DXGI_FORMAT_BC1_UNORM_SRGB] = VRI_FORMAT_BC1_SRGB,
+    [DXGI_FORMAT_BC2_UNORM] = VRI_FORMAT_BC2_UNORM,
+    [DXGI_FORMAT_BC2_UNORM_SRGB] = VRI_FORMAT_BC2_SRGB,
+    [DXGI_FORMAT_BC3_UNORM] = VRI_FORMAT_BC3_UNORM,
+    [DXGI_FORMAT_BC3_UNORM_SRGB] = VRI_FORMAT_BC3_SRGB,
+    [DXGI_FORMAT_BC4_UNORM] = VRI_FORMAT_BC4_UNORM,
+    [DXGI_FORMAT_BC4_SNORM] = VRI_FORMAT_BC4_SNORM,
+    [DXGI_FORMAT_BC5_UNORM] = VRI_FORMAT_BC5_UNORM,
+    [DXGI_FORMAT_BC5_SNORM] = VRI_FORMAT_BC5_SNORM,
+    [DXGI_FORMAT_BC6H_UF16] = VRI_FORMAT_BC6H_UFLOAT,
+    [DXGI_FORMAT_BC6H_SF16] = VRI_FORMAT_BC6H_SFLOAT,
+    [DXGI_FORMAT_BC7_UNORM] = VRI_FORMAT_BC7_UNORM,
+    [DXGI_FORMAT_BC7_UNORM_SRGB] = VRI_FORMAT_BC7_SRGB,
 };
 
-// Best attempt at translation
+// VRI creates every texture typeless and tags the resource with the VriFormat it
+// was created with, which is what wrapping the resource again reports
+const static GUID vri_d3d11_format_guid = {0x6b1f3c2a, 0x8d4e, 0x4f1a, {0x9c, 0x57, 0x2e, 0x41, 0xb8, 0x0d, 0x73, 0xa6}};
+
+// DXGI has no P3 primaries, no linear BT.2020 and HLG only for YCbCr video,
+// those get DXGI_COLOR_SPACE_CUSTOM and the swapchain keeps its default
 const static DXGI_COLOR_SPACE_TYPE vri_to_dxgi_color_space[VRI_COLORSPACE_COUNT] = {
     [VRI_COLORSPACE_SRGB_NONLINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709,
     [VRI_COLORSPACE_SRGB_LINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709,
     [VRI_COLORSPACE_BT709_NONLINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709,
     [VRI_COLORSPACE_BT709_LINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709,
-    [VRI_COLORSPACE_P3_NONLINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P2020,
-    [VRI_COLORSPACE_P3_LINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709,
+    [VRI_COLORSPACE_P3_NONLINEAR] = DXGI_COLOR_SPACE_CUSTOM,
+    [VRI_COLORSPACE_P3_LINEAR] = DXGI_COLOR_SPACE_CUSTOM,
     [VRI_COLORSPACE_BT2020_NONLINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P2020,
-    [VRI_COLORSPACE_BT2020_LINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709,
+    [VRI_COLORSPACE_BT2020_LINEAR] = DXGI_COLOR_SPACE_CUSTOM,
     [VRI_COLORSPACE_HDR10_ST2084] = DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020,
-    [VRI_COLORSPACE_HDR10_HLG] = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P2020,
+    [VRI_COLORSPACE_HDR10_HLG] = DXGI_COLOR_SPACE_CUSTOM,
     [VRI_COLORSPACE_EXTENDED_SRGB_LINEAR] = DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709,
 };
 
@@ -128,7 +278,8 @@ static inline const VriDXGIFormatPair *vri_to_dxgi_format(VriFormat format) {
 }
 
 static inline const VriFormat *vri_dxgi_format_to_vri(DXGI_FORMAT format) {
-    return &dxgi_to_vri[format];
+    static const VriFormat undefined = VRI_FORMAT_UNDEFINED;
+    return (uint32_t)format < ARRAYSIZE(dxgi_to_vri) ? &dxgi_to_vri[format] : &undefined;
 }
 
 static inline const DXGI_COLOR_SPACE_TYPE *vri_color_space_to_dxgi(VriColorSpace color_space) {
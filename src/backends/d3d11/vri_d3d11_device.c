@@ -8,6 +8,7 @@
 #include "vri_d3d11_queue.h"
 #include "vri_d3d11_swapchain.h"
 #include "vri_d3d11_texture.h"
+#include "vri_d3d11_tile_heap.h"
 
 #define DEVICE_STRUCT_SIZE (sizeof(struct VriDevice_T) + sizeof(VriD3D11Device))
 
@@ -18,7 +19,7 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
     VriDebugCallback dbg = p_desc->debug_callback;
 
     // Attempt to allocate the full internal struct
-    *p_device = vri_object_allocate(*p_device, &p_desc->allocation_callback, DEVICE_STRUCT_SIZE, VRI_OBJECT_DEVICE);
+    *p_device = vri_object_allocate(NULL, &p_desc->allocation_callback, DEVICE_STRUCT_SIZE, VRI_OBJECT_TYPE_DEVICE);
     if (!*p_device) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for device struct failed.");
         return VRI_ERROR_OUT_OF_MEMORY;
@@ -76,7 +77,7 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
 
     if (FAILED(hr)) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Failed to create D3D11 device. Check driver compatibility and installation.");
-        p_desc->allocation_callback.pfn_free(*p_device, DEVICE_STRUCT_SIZE, 8);
+        vri_object_free(*p_device, &p_desc->allocation_callback, *p_device, DEVICE_STRUCT_SIZE);
         return VRI_ERROR_SYSTEM_FAILURE;
     }
 
@@ -85,7 +86,7 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
     hr = base_device->lpVtbl->QueryInterface(base_device, COM_IID_PPV_ARGS(ID3D11Device5, &device5));
     if (FAILED(hr)) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Couldn't upgrade to ID3D11Device5. The system's D3D11 version is too old.");
-        p_desc->allocation_callback.pfn_free(*p_device, DEVICE_STRUCT_SIZE, 8);
+        vri_object_free(*p_device, &p_desc->allocation_callback, *p_device, DEVICE_STRUCT_SIZE);
         base_device->lpVtbl->Release(base_device);
         base_context->lpVtbl->Release(base_context);
         return VRI_ERROR_UNSUPPORTED;
@@ -96,7 +97,7 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
     hr = base_context->lpVtbl->QueryInterface(base_context, COM_IID_PPV_ARGS(ID3D11DeviceContext4, &context4));
     if (FAILED(hr)) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Couldn't upgrade to ID3D11DeviceContext4. The system's D3D11 version is too old.");
-        p_desc->allocation_callback.pfn_free(*p_device, DEVICE_STRUCT_SIZE, 8);
+        vri_object_free(*p_device, &p_desc->allocation_callback, *p_device, DEVICE_STRUCT_SIZE);
         device5->lpVtbl->Release(device5);
         base_device->lpVtbl->Release(base_device);
         base_context->lpVtbl->Release(base_context);
@@ -127,6 +128,20 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
         }
     }
 
+    // Fill up the dispatch table
+    d3d11_register_device_functions(&(*p_device)->dispatch);
+    d3d11_register_command_pool_functions(&(*p_device)->dispatch);
+    d3d11_register_command_buffer_functions(&(*p_device)->dispatch);
+    d3d11_register_texture_functions(&(*p_device)->dispatch);
+    d3d11_register_tile_heap_functions(&(*p_device)->dispatch);
+    d3d11_register_fence_functions(&(*p_device)->dispatch);
+    d3d11_register_swapchain_functions(&(*p_device)->dispatch);
+    d3d11_register_pipeline_functions_with_device(&(*p_device)->dispatch);
+    d3d11_register_command_buffer_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    d3d11_register_pipeline_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    d3d11_register_texture_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    d3d11_register_queue_functions(&(*p_device)->queue_dispatch);
+
     // Create queues
     for (uint32_t i = 0; i < p_desc->queue_desc_count; ++i) {
         const VriQueueDesc *qdesc = &p_desc->p_queue_descs[i];
@@ -151,14 +166,15 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
     internal_state->p_device = device5;
     internal_state->p_immediate_context = context4;
 
-    // Fill up the dispatch table
-    d3d11_register_device_functions(&(*p_device)->dispatch);
-    d3d11_register_command_pool_functions(&(*p_device)->dispatch);
-    d3d11_register_command_buffer_functions(&(*p_device)->dispatch);
-    d3d11_register_texture_functions(&(*p_device)->dispatch);
-    d3d11_register_fence_functions(&(*p_device)->dispatch);
-    d3d11_register_swapchain_functions(&(*p_device)->dispatch);
-    d3d11_register_pipeline_functions_with_device(&(*p_device)->dispatch);
+    D3D11_FEATURE_DATA_THREADING threading = {0};
+    if (SUCCEEDED(device5->lpVtbl->CheckFeatureSupport(device5, D3D11_FEATURE_THREADING, &threading, sizeof(threading)))) {
+        internal_state->driver_command_lists = threading.DriverCommandLists ? VRI_TRUE : VRI_FALSE;
+    }
+
+    D3D11_FEATURE_DATA_D3D11_OPTIONS1 options1 = {0};
+    if (SUCCEEDED(device5->lpVtbl->CheckFeatureSupport(device5, D3D11_FEATURE_D3D11_OPTIONS1, &options1, sizeof(options1)))) {
+        internal_state->tiled_resources = options1.TiledResourcesTier != D3D11_TILED_RESOURCES_NOT_SUPPORTED ? VRI_TRUE : VRI_FALSE;
+    }
 
     // Release remaining not needed resources
     COM_RELEASE(base_device);
@@ -167,7 +183,7 @@ VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device)
     return VRI_SUCCESS;
 }
 
-static void d3d11_device_destroy(VriDevice device) {
+void d3d11_device_destroy(VriDevice device) {
     if (device) {
         VriD3D11Device *internal_state = (VriD3D11Device *)device->p_backend_data;
 
@@ -186,11 +202,45 @@ static void d3d11_device_destroy(VriDevice device) {
             COM_SAFE_RELEASE(internal_state->p_device);
         }
 
+        // Objects the application never destroyed go with their pools
+        vri_shader_modules_destroy(device);
+        vri_object_pools_destroy(device);
+
         // Free the ENTIRE allocated block (device + internal_state)
-        device->allocation_callback.pfn_free(device, DEVICE_STRUCT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, device, DEVICE_STRUCT_SIZE);
     }
 }
 
+VriResult d3d11_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget) {
+    IDXGIAdapter *adapter = ((VriD3D11Device *)device->p_backend_data)->p_adapter;
+
+    // Budgets came with WDDM 2.0, older systems don't expose IDXGIAdapter3
+    IDXGIAdapter3 *adapter3 = NULL;
+    if (FAILED(adapter->lpVtbl->QueryInterface(adapter, COM_IID_PPV_ARGS(IDXGIAdapter3, &adapter3)))) {
+        return VRI_ERROR_UNSUPPORTED;
+    }
+
+    const DXGI_MEMORY_SEGMENT_GROUP segment_groups[VRI_MEMORY_HEAP_COUNT] = {
+        [VRI_MEMORY_HEAP_DEVICE_LOCAL] = DXGI_MEMORY_SEGMENT_GROUP_LOCAL,
+        [VRI_MEMORY_HEAP_SYSTEM] = DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL,
+    };
+
+    VriResult result = VRI_SUCCESS;
+    for (uint32_t i = 0; i < VRI_MEMORY_HEAP_COUNT; ++i) {
+        DXGI_QUERY_VIDEO_MEMORY_INFO info = {0};
+        if (FAILED(adapter3->lpVtbl->QueryVideoMemoryInfo(adapter3, 0, segment_groups[i], &info))) {
+            result = VRI_ERROR_SYSTEM_FAILURE;
+            break;
+        }
+        p_budget->heaps[i].budget = info.Budget;
+        p_budget->heaps[i].usage = info.CurrentUsage;
+    }
+
+    COM_RELEASE(adapter3);
+    return result;
+}
+
 static void d3d11_register_device_functions(VriDeviceDispatchTable *table) {
     table->pfn_device_destroy = d3d11_device_destroy;
+    table->pfn_device_query_memory_budget = d3d11_device_query_memory_budget;
 }
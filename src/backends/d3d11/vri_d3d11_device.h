@@ -7,6 +7,12 @@ typedef struct {
     ID3D11Device5        *p_device;
     ID3D11DeviceContext4 *p_immediate_context;
     IDXGIAdapter         *p_adapter;
+    VriBool               driver_command_lists; // Without them the runtime emulates deferred contexts
+    VriBool               tiled_resources;
 } VriD3D11Device;
 
+VriResult d3d11_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device);
+void      d3d11_device_destroy(VriDevice device);
+VriResult d3d11_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget);
+
 #endif
@@ -5,10 +5,6 @@
 
 #define FENCE_OBJECT_SIZE (sizeof(struct VriFence_T) + sizeof(VriD3D11Fence))
 
-static VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence);
-static void      d3d11_fence_destroy(VriDevice device, VriFence fence);
-static uint64_t  d3d11_fence_get_value(VriDevice device, VriFence fence);
-
 void d3d11_register_fence_functions(VriDeviceDispatchTable *table) {
     table->pfn_fence_create = d3d11_fence_create;
     table->pfn_fence_destroy = d3d11_fence_destroy;
@@ -16,11 +12,11 @@ void d3d11_register_fence_functions(VriDeviceDispatchTable *table) {
     table->pfn_fences_wait = d3d11_fences_wait;
 }
 
-static VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
+VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
     VriDebugCallback dbg = device->debug_callback;
 
     // Allocate fence
-    *p_fence = vri_object_allocate(device, &device->allocation_callback, FENCE_OBJECT_SIZE, VRI_OBJECT_FENCE);
+    *p_fence = vri_object_allocate(device, &device->allocation_callback, FENCE_OBJECT_SIZE, VRI_OBJECT_TYPE_FENCE);
     if (!*p_fence) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate fence");
         return VRI_ERROR_OUT_OF_MEMORY;
@@ -37,7 +33,7 @@ static VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, Vr
     HRESULT hr = d3d11_device->p_device->lpVtbl->CreateFence(d3d11_device->p_device, initial_value, D3D11_FENCE_FLAG_NONE, COM_IID_PPV_ARGS(ID3D11Fence, &d3d11_fence->p_fence));
     if (FAILED(hr)) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create D3D11 fence");
-        device->allocation_callback.pfn_free(*p_fence, FENCE_OBJECT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, *p_fence, FENCE_OBJECT_SIZE);
         *p_fence = NULL;
         return VRI_ERROR_SYSTEM_FAILURE;
     }
@@ -46,7 +42,7 @@ static VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, Vr
     if (!d3d11_fence->event) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create fence event");
         COM_RELEASE(d3d11_fence->p_fence);
-        device->allocation_callback.pfn_free(*p_fence, FENCE_OBJECT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, *p_fence, FENCE_OBJECT_SIZE);
         *p_fence = NULL;
         return VRI_ERROR_SYSTEM_FAILURE;
     }
@@ -54,7 +50,7 @@ static VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, Vr
     return VRI_SUCCESS;
 }
 
-static void d3d11_fence_destroy(VriDevice device, VriFence fence) {
+void d3d11_fence_destroy(VriDevice device, VriFence fence) {
     if (fence) {
         VriD3D11Fence *d3d11_fence = fence->p_backend_data;
         if (d3d11_fence->event) {
@@ -63,24 +59,22 @@ static void d3d11_fence_destroy(VriDevice device, VriFence fence) {
         COM_SAFE_RELEASE(d3d11_fence->p_fence);
 
         // Free fence struct
-        device->allocation_callback.pfn_free(fence, FENCE_OBJECT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, fence, FENCE_OBJECT_SIZE);
     }
 }
 
-static uint64_t d3d11_fence_get_value(VriDevice device, VriFence fence) {
+uint64_t d3d11_fence_get_value(VriDevice device, VriFence fence) {
     (void)device;
     VriD3D11Fence *f = fence->p_backend_data;
     return f->p_fence->lpVtbl->GetCompletedValue(f->p_fence);
 }
 
 VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
-    (void)device;
-
     if (fence_count == 0) {
         return VRI_SUCCESS;
     }
 
-    HANDLE *events_to_wait = device->allocation_callback.pfn_allocate(fence_count * sizeof(HANDLE), 8);
+    HANDLE *events_to_wait = device->allocation_callback.pfn_allocate(fence_count * sizeof(HANDLE), 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
     if (!events_to_wait) {
         return VRI_ERROR_OUT_OF_MEMORY;
     }
@@ -92,7 +86,7 @@ VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const ui
 
         if (d3d11_fence->lpVtbl->GetCompletedValue(d3d11_fence) >= p_values[i]) {
             if (!wait_all) {
-                device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8);
+                device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
                 return VRI_SUCCESS;
             }
 
@@ -101,7 +95,7 @@ VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const ui
 
         HRESULT hr = d3d11_fence->lpVtbl->SetEventOnCompletion(d3d11_fence, p_values[i], fence->event);
         if (FAILED(hr)) {
-            device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8);
+            device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
             return VRI_ERROR_SYSTEM_FAILURE;
         }
         events_to_wait[event_count++] = fence->event;
@@ -109,8 +103,12 @@ VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const ui
 
     VriResult res = VRI_SUCCESS;
     if (event_count > 0) {
-        DWORD timeout_ms = (timeout_ns == UINT64_MAX) ? INFINITE : (DWORD)(timeout_ns / 1000000ULL);
-        DWORD wait_result = WaitForMultipleObjectsEx(event_count, events_to_wait, (BOOL)wait_all, timeout_ms, FALSE);
+        DWORD    timeout_ms = (timeout_ns == UINT64_MAX) ? INFINITE : (DWORD)(timeout_ns / 1000000ULL);
+        uint64_t wait_start = vri_time_ns();
+        DWORD    wait_result = WaitForMultipleObjectsEx(event_count, events_to_wait, (BOOL)wait_all, timeout_ms, FALSE);
+
+        VRI_STAT_ADD(device, fence_waits_blocked, 1);
+        VRI_STAT_ADD(device, fence_wait_time_ns, vri_time_ns() - wait_start);
 
         if (wait_result >= WAIT_OBJECT_0 && wait_result < (WAIT_OBJECT_0 + event_count)) {
             res = VRI_SUCCESS;
@@ -120,7 +118,7 @@ VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const ui
             res = VRI_ERROR_SYSTEM_FAILURE;
         }
     }
-    device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8);
+    device->allocation_callback.pfn_free(events_to_wait, fence_count * sizeof(HANDLE), 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
     return res;
 }
 
@@ -11,5 +11,8 @@ typedef struct {
 void      d3d11_register_fence_functions(VriDeviceDispatchTable *table);
 VriResult d3d11_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns);
 VriResult d3d11_fence_signal(VriFence fence, uint64_t value);
+VriResult d3d11_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence);
+void      d3d11_fence_destroy(VriDevice device, VriFence fence);
+uint64_t  d3d11_fence_get_value(VriDevice device, VriFence fence);
 
 #endif
@@ -5,24 +5,58 @@
 #include "vri_d3d11_common.h"
 #include "vri_d3d11_device.h"
 
-#define PIPELINE_OBJECT_SIZE (sizeof(struct VriPipeline_T) + sizeof(VriD3D11Pipeline))
-
-static VriResult d3d11_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout);
-static VriResult d3d11_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline);
-static VriResult d3d11_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
-static void      d3d11_pipeline_bind(VriCommandBuffer command_buffer, VriPipeline pipeline);
+#include <string.h>
+
+#define PIPELINE_OBJECT_SIZE         (sizeof(struct VriPipeline_T) + sizeof(VriD3D11Pipeline))
+#define PIPELINE_LIBRARY_OBJECT_SIZE (sizeof(struct VriPipelineLibrary_T) + sizeof(VriD3D11PipelineLibrary))
+
+static VriResult                  d3d11_pipeline_build(VriDevice device, VriPipelineLibraryFlags parts, const VriGraphicsPipelineDesc *p_desc, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_shaders(VriDevice device, VriShaderStageFlags stages, const VriGraphicsPipelineDesc *p_desc, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_shader(VriDevice device, const VriShaderModuleDesc *p_shader, VriD3D11Pipeline *d3d11_pipeline);
+static HRESULT                    d3d11_shader_create(ID3D11Device5 *d3d11_device, VriShaderStageFlagBits stage, const void *p_bytecode, size_t size, VriD3D11ShaderModule *d3d11_shaders);
+static VriResult                  d3d11_shader_module_init(VriDevice device, VriShaderModule shader_module);
+static void                       d3d11_shader_module_deinit(VriDevice device, VriShaderModule shader_module);
+static VriResult                  d3d11_pipeline_create_specialization_buffer(VriDevice device, const VriShaderModuleDesc *p_shader, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_input_layout(VriDevice device, const D3D11_INPUT_ELEMENT_DESC *p_elements, uint32_t element_count, const void *p_bytecode, size_t bytecode_size, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_rasterizer_state(VriDevice device, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_blend_state(VriDevice device, const VriColorBlendStateDesc *p_color_blend_state, VriD3D11Pipeline *d3d11_pipeline);
+static VriResult                  d3d11_pipeline_create_depth_stencil_state(VriDevice device, const VriDepthStencilStateDesc *p_depth_stencil_state, VriD3D11Pipeline *d3d11_pipeline);
+static void                       d3d11_pipeline_release(VriD3D11Pipeline *d3d11_pipeline);
+static D3D11_INPUT_ELEMENT_DESC  *d3d11_input_elements_allocate(VriDevice device, const VriVertexInputDesc *p_vertex_input, VriAllocationScope scope, size_t *p_size);
+static const VriShaderModuleDesc *d3d11_vertex_shader(const VriGraphicsPipelineDesc *p_desc);
+static uint32_t                   d3d11_shader_stage_index(VriShaderStageFlagBits stage);
+static void                       d3d11_cmd_bind_specialization_buffers(ID3D11DeviceContext4 *context, const VriD3D11Pipeline *pipeline, const VriD3D11Pipeline *current_pipeline);
+static const float               *d3d11_blend_constants(const VriD3D11CommandBuffer *cb, const VriD3D11Pipeline *pipeline);
+static uint32_t                   d3d11_stencil_reference(const VriD3D11CommandBuffer *cb, const VriD3D11Pipeline *pipeline);
 
 void d3d11_register_pipeline_functions_with_device(VriDeviceDispatchTable *table) {
+    table->pfn_shader_module_create = d3d11_shader_module_create;
+    table->pfn_shader_module_destroy = d3d11_shader_module_destroy;
     table->pfn_pipeline_layout_create = d3d11_pipeline_layout_create;
     table->pfn_pipeline_create_graphics = d3d11_pipeline_create_graphics;
     table->pfn_pipeline_create_compute = d3d11_pipeline_create_compute;
+    table->pfn_pipeline_destroy = d3d11_pipeline_destroy;
+    table->pfn_pipeline_library_create = d3d11_pipeline_library_create;
+    table->pfn_pipeline_library_destroy = d3d11_pipeline_library_destroy;
+    table->pfn_pipeline_link = d3d11_pipeline_link;
 }
 
 void d3d11_register_pipeline_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
-    table->pfn_cmd_bind_pipeline = d3d11_pipeline_bind;
+    table->pfn_cmd_bind_pipeline = d3d11_cmd_bind_pipeline;
+}
+
+// The module's shader object is created once and shared by every pipeline that uses it
+VriResult d3d11_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    return vri_shader_module_acquire(device, p_desc, sizeof(VriD3D11ShaderModule), d3d11_shader_module_init, d3d11_shader_module_deinit, p_shader_module);
 }
 
-static VriResult d3d11_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
+void d3d11_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    if (shader_module) {
+        vri_shader_module_release(device, shader_module, sizeof(VriD3D11ShaderModule), d3d11_shader_module_deinit);
+    }
+}
+
+VriResult d3d11_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
     (void)device;
     (void)p_desc;
     (void)p_pipeline_layout;
@@ -30,11 +64,11 @@ static VriResult d3d11_pipeline_layout_create(VriDevice device, const VriPipelin
     return VRI_SUCCESS;
 }
 
-static VriResult d3d11_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+VriResult d3d11_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
     VriDebugCallback dbg = device->debug_callback;
 
     // Allocate pipeline internals
-    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_PIPELINE);
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
     if (!*p_pipeline) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
         return VRI_ERROR_OUT_OF_MEMORY;
@@ -43,289 +77,180 @@ static VriResult d3d11_pipeline_create_graphics(VriDevice device, const VriGraph
     (*p_pipeline)->p_backend_data = (VriD3D11Pipeline *)(*p_pipeline + 1);
     VriD3D11Pipeline *d3d11_pipeline = (*p_pipeline)->p_backend_data;
 
-    HRESULT        hr = E_FAIL;
-    VriResult      err = VRI_SUCCESS;
-    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+    VriResult err = d3d11_pipeline_build(device, VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL, p_desc, d3d11_pipeline);
+    if (VRI_ERROR(err)) {
+        d3d11_pipeline_release(d3d11_pipeline);
+        vri_object_free(device, &device->allocation_callback, *p_pipeline, PIPELINE_OBJECT_SIZE);
+        *p_pipeline = NULL;
+    }
 
-    const VriShaderModuleDesc *vertex_shader = NULL;
-
-    // Shaders
-    {
-        for (uint32_t i = 0; i < p_desc->shader_count; ++i) {
-            const VriShaderModuleDesc *shader_desc = (p_desc->p_shaders + i);
-
-            switch (shader_desc->stage) {
-                case VRI_SHADER_STAGE_FLAG_BIT_VERTEX: {
-                    vertex_shader = shader_desc;
-                    hr = d3d11_device->lpVtbl->CreateVertexShader(
-                        d3d11_device,
-                        shader_desc->p_bytecode,
-                        shader_desc->size,
-                        NULL,
-                        &d3d11_pipeline->p_vertex_shader);
-                } break;
-
-                case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_CONTROL: {
-                    hr = d3d11_device->lpVtbl->CreateHullShader(
-                        d3d11_device,
-                        shader_desc->p_bytecode,
-                        shader_desc->size,
-                        NULL,
-                        &d3d11_pipeline->p_hull_shader);
-                } break;
-
-                case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_EVALUATION: {
-                    hr = d3d11_device->lpVtbl->CreateDomainShader(
-                        d3d11_device,
-                        shader_desc->p_bytecode,
-                        shader_desc->size,
-                        NULL,
-                        &d3d11_pipeline->p_domain_shader);
-                } break;
-
-                case VRI_SHADER_STAGE_FLAG_BIT_GEOMETRY: {
-                    hr = d3d11_device->lpVtbl->CreateGeometryShader(
-                        d3d11_device,
-                        shader_desc->p_bytecode,
-                        shader_desc->size,
-                        NULL,
-                        &d3d11_pipeline->p_geometry_shader);
-                } break;
-
-                case VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT: {
-                    hr = d3d11_device->lpVtbl->CreatePixelShader(
-                        d3d11_device,
-                        shader_desc->p_bytecode,
-                        shader_desc->size,
-                        NULL,
-                        &d3d11_pipeline->p_pixel_shader);
-                } break;
-
-                default:
-                    device->allocation_callback.pfn_free(*p_pipeline, PIPELINE_OBJECT_SIZE, 8);
-                    return VRI_ERROR_INVALID_API_USAGE;
-            }
+    return err;
+}
 
-            if (FAILED(hr)) {
-                dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create shader for shader module");
-                err = VRI_ERROR_SYSTEM_FAILURE;
-                goto error;
-            }
-        }
-    }
+// D3D11 has no pipeline libraries. A library creates the shaders and state
+// objects of its parts up front, and keeps what the input layout and the
+// rasterizer state need from the parts it doesn't have, so linking only takes
+// references and creates those two when they span libraries.
+VriResult d3d11_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    VriDebugCallback dbg = device->debug_callback;
 
-    // Input Assembly State
-    {
-        d3d11_pipeline->topology = vri_topology_to_d3d11_topology(p_desc->p_input_assembly_state->topology);
+    *p_library = vri_object_allocate(device, &device->allocation_callback, PIPELINE_LIBRARY_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE_LIBRARY);
+    if (!*p_library) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline library object");
+        return VRI_ERROR_OUT_OF_MEMORY;
     }
 
-    // Vertex Input
-    {
-        if (p_desc->p_vertex_input) {
-            // Make sure we have vertex shader when we have vertex input
-            if (!vertex_shader) {
-                err = VRI_ERROR_INVALID_API_USAGE;
-                goto error;
-            }
+    (*p_library)->parts = p_desc->parts;
+    (*p_library)->p_backend_data = (VriD3D11PipelineLibrary *)(*p_library + 1);
+    VriD3D11PipelineLibrary       *d3d11_library = (*p_library)->p_backend_data;
+    const VriGraphicsPipelineDesc *pipeline_desc = p_desc->p_desc;
 
-            const VriVertexInputDesc *vdesc = p_desc->p_vertex_input;
+    VriResult err = d3d11_pipeline_build(device, p_desc->parts, pipeline_desc, &d3d11_library->state);
 
-            size_t                    elems_allocate_size = sizeof(D3D11_INPUT_ELEMENT_DESC) * vdesc->attribute_count;
-            D3D11_INPUT_ELEMENT_DESC *elems = device->allocation_callback.pfn_allocate(elems_allocate_size, 8);
-            if (!elems) {
+    VriPipelineLibraryFlags input_parts = p_desc->parts & (VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT | VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION);
+    if (VRI_OK(err) && input_parts == VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT && pipeline_desc->p_vertex_input) {
+        d3d11_library->p_elements = d3d11_input_elements_allocate(device, pipeline_desc->p_vertex_input, VRI_ALLOCATION_SCOPE_OBJECT, &d3d11_library->elements_size);
+        d3d11_library->element_count = pipeline_desc->p_vertex_input->attribute_count;
+        if (!d3d11_library->p_elements) err = VRI_ERROR_OUT_OF_MEMORY;
+    }
+    if (VRI_OK(err) && input_parts == VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) {
+        const VriShaderModuleDesc *vertex_shader = d3d11_vertex_shader(pipeline_desc);
+        if (vertex_shader) {
+            size_t      bytecode_size = 0;
+            const void *p_bytecode = vri_shader_bytecode(vertex_shader, &bytecode_size);
+
+            d3d11_library->p_vertex_bytecode = device->allocation_callback.pfn_allocate(bytecode_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+            if (d3d11_library->p_vertex_bytecode) {
+                memcpy(d3d11_library->p_vertex_bytecode, p_bytecode, bytecode_size);
+                d3d11_library->vertex_bytecode_size = bytecode_size;
+            } else {
                 err = VRI_ERROR_OUT_OF_MEMORY;
-                goto error;
-            }
-
-            for (uint32_t i = 0; i < vdesc->attribute_count; ++i) {
-                const VriVertexAttributeDesc *attr = &vdesc->p_attributes[i];
-                VriVertexInputRate            input_rate = vdesc->p_bindings[attr->binding].input_rate;
-
-                elems[i].SemanticName = attr->d3d.semantic_name; // NOTE: semantic_name might need to live as long as we need the input
-                elems[i].SemanticIndex = attr->d3d.semantic_index;
-                elems[i].Format = vri_to_dxgi_format(attr->format)->typed;
-                elems[i].InputSlot = attr->binding;
-                elems[i].AlignedByteOffset = attr->offset;
-                elems[i].InputSlotClass = input_rate == VRI_VERTEX_INPUT_RATE_VERTEX ? D3D11_INPUT_PER_VERTEX_DATA : D3D11_INPUT_PER_INSTANCE_DATA;
-                elems[i].InstanceDataStepRate = input_rate == VRI_VERTEX_INPUT_RATE_VERTEX ? 0 : 1;
-            }
-
-            hr = d3d11_device->lpVtbl->CreateInputLayout(
-                d3d11_device,
-                elems,
-                vdesc->attribute_count,
-                vertex_shader->p_bytecode,
-                vertex_shader->size,
-                &d3d11_pipeline->p_input_layout);
-
-            device->allocation_callback.pfn_free(elems, elems_allocate_size, 8);
-
-            if (FAILED(hr)) {
-                dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create input layout");
-                err = VRI_ERROR_SYSTEM_FAILURE;
-                goto error;
             }
         }
     }
 
-    // Rasterization State
-    {
-        const VriRasterizationStateDesc *rdesc = p_desc->p_rasterization_state;
+    if (VRI_ERROR(err)) {
+        d3d11_pipeline_library_destroy(device, *p_library);
+        *p_library = NULL;
+    }
 
-        D3D11_RASTERIZER_DESC rasterizer_desc = {
-            .FillMode = rdesc->fill_mode == VRI_FILL_MODE_FILL ? D3D11_FILL_SOLID : D3D11_FILL_WIREFRAME,
-            .CullMode = vri_cull_mode_to_d3d11(rdesc->cull_mode),
-            .FrontCounterClockwise = rdesc->front_face == VRI_FRONT_FACE_COUNTER_CLOCKWISE ? TRUE : FALSE,
-            .DepthClipEnable = rdesc->depth_clamp_enable ? FALSE : TRUE,
-            .MultisampleEnable = p_desc->p_multisample_state->sample_count > 1 ? TRUE : FALSE,
-        };
+    return err;
+}
+
+void d3d11_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    if (library) {
+        VriD3D11PipelineLibrary *d3d11_library = library->p_backend_data;
 
-        hr = d3d11_device->lpVtbl->CreateRasterizerState(d3d11_device, &rasterizer_desc, &d3d11_pipeline->p_rasterizer_state);
-        if (FAILED(hr)) {
-            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create rasterizer state");
-            err = VRI_ERROR_SYSTEM_FAILURE;
-            goto error;
+        d3d11_pipeline_release(&d3d11_library->state);
+        if (d3d11_library->p_elements) {
+            device->allocation_callback.pfn_free(d3d11_library->p_elements, d3d11_library->elements_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
         }
+        if (d3d11_library->p_vertex_bytecode) {
+            device->allocation_callback.pfn_free(d3d11_library->p_vertex_bytecode, d3d11_library->vertex_bytecode_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+
+        vri_object_free(device, &device->allocation_callback, library, PIPELINE_LIBRARY_OBJECT_SIZE);
     }
+}
 
-    // Blend State (OM)
-    {
-        // If user provided a color blend state, use it; otherwise create a default opaque write-through state.
-        D3D11_BLEND_DESC blend_desc = {
-            .AlphaToCoverageEnable = FALSE,
-            .IndependentBlendEnable = FALSE,
-        };
+VriResult d3d11_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    VriDebugCallback dbg = device->debug_callback;
 
-        if (p_desc->p_color_blend_state) {
-            const VriColorBlendStateDesc *cbs = p_desc->p_color_blend_state;
-            blend_desc.IndependentBlendEnable = cbs->independent_blend_enable ? TRUE : FALSE;
-            blend_desc.AlphaToCoverageEnable = cbs->alpha_to_coverage_enable ? TRUE : FALSE;
-
-            uint32_t rt_count = cbs->render_target_count ? cbs->render_target_count : 1;
-            rt_count = rt_count > D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT ? D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT : rt_count;
-
-            for (uint32_t i = 0; i < rt_count; ++i) {
-                const VriColorBlendAttachmentDesc *att = &cbs->render_targets[i];
-
-                D3D11_RENDER_TARGET_BLEND_DESC *rt = &blend_desc.RenderTarget[i];
-                rt->BlendEnable = att->blend_enable ? TRUE : FALSE;
-                rt->SrcBlend = vri_blend_factor_to_d3d11(att->src_color_blend_factor);
-                rt->DestBlend = vri_blend_factor_to_d3d11(att->dst_color_blend_factor);
-                rt->BlendOp = vri_blend_op_to_d3d11(att->color_blend_op);
-                rt->SrcBlendAlpha = vri_blend_factor_to_d3d11(att->src_alpha_blend_factor);
-                rt->DestBlendAlpha = vri_blend_factor_to_d3d11(att->dst_alpha_blend_factor);
-                rt->BlendOpAlpha = vri_blend_op_to_d3d11(att->alpha_blend_op);
-                rt->RenderTargetWriteMask = att->color_write_mask;
-            }
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
+    if (!*p_pipeline) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
 
-            d3d11_pipeline->render_target_count = rt_count;
-        } else {
-            // default: no blending, write all channels
-            blend_desc.RenderTarget[0].BlendEnable = FALSE;
-            blend_desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-            d3d11_pipeline->render_target_count = 1;
-        }
+    (*p_pipeline)->p_backend_data = (VriD3D11Pipeline *)(*p_pipeline + 1);
+    VriD3D11Pipeline *d3d11_pipeline = (*p_pipeline)->p_backend_data;
 
-        hr = d3d11_device->lpVtbl->CreateBlendState(d3d11_device, &blend_desc, &d3d11_pipeline->p_blend_state);
-        if (FAILED(hr)) {
-            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create blend state");
-            goto error;
-        }
+    const VriD3D11PipelineLibrary *vertex_input = NULL;
+    const VriD3D11PipelineLibrary *pre_rasterization = NULL;
 
-        // store a default sample mask (D3D11 uses sample mask on OMSetBlendState)
-        d3d11_pipeline->sample_mask = 0xFFFFFFFF;
-    }
+    for (uint32_t i = 0; i < p_desc->library_count; ++i) {
+        VriPipelineLibraryFlags        parts = p_desc->p_libraries[i]->parts;
+        const VriD3D11PipelineLibrary *library = p_desc->p_libraries[i]->p_backend_data;
+        const VriD3D11Pipeline        *state = &library->state;
 
-    // Depth-Stencil State
-    {
-        if (p_desc->p_depth_stencil_state) {
-            const VriDepthStencilStateDesc *dsdesc = p_desc->p_depth_stencil_state;
-
-            D3D11_DEPTH_STENCIL_DESC depth_stencil_desc = {
-                .DepthEnable = dsdesc->depth_test_enable ? TRUE : FALSE,
-                .DepthWriteMask = dsdesc->depth_write_enable ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO,
-                .DepthFunc = vri_compare_op_to_d3d11(dsdesc->depth_compare_op),
-
-                .StencilEnable = dsdesc->stencil_test_enable ? TRUE : FALSE,
-                .StencilReadMask = dsdesc->stencil_read_mask,
-                .StencilWriteMask = dsdesc->stencil_write_mask,
-
-                .FrontFace.StencilFailOp = vri_stencil_op_to_d3d11(dsdesc->front.fail_op),
-                .FrontFace.StencilDepthFailOp = vri_stencil_op_to_d3d11(dsdesc->front.depth_fail_op),
-                .FrontFace.StencilPassOp = vri_stencil_op_to_d3d11(dsdesc->front.pass_op),
-                .FrontFace.StencilFunc = vri_compare_op_to_d3d11(dsdesc->front.compare_op),
-
-                .BackFace.StencilFailOp = vri_stencil_op_to_d3d11(dsdesc->back.fail_op),
-                .BackFace.StencilDepthFailOp = vri_stencil_op_to_d3d11(dsdesc->back.depth_fail_op),
-                .BackFace.StencilPassOp = vri_stencil_op_to_d3d11(dsdesc->back.pass_op),
-                .BackFace.StencilFunc = vri_compare_op_to_d3d11(dsdesc->back.compare_op),
-            };
-
-            hr = d3d11_device->lpVtbl->CreateDepthStencilState(d3d11_device, &depth_stencil_desc, &d3d11_pipeline->p_depth_stencil_state);
-            if (FAILED(hr)) {
-                dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create depth stencil state");
-                err = VRI_ERROR_SYSTEM_FAILURE;
-                goto error;
-            }
+        d3d11_pipeline->dynamic_states |= state->dynamic_states;
 
-            d3d11_pipeline->stencil_ref = dsdesc->stencil_reference ? dsdesc->stencil_reference : 0;
-        } else {
-            // If no depth/stencil state supplied, create a default disabled depth/stencil state
-            D3D11_DEPTH_STENCIL_DESC dsd = {0};
-            dsd.DepthEnable = FALSE;
-            dsd.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
-            dsd.DepthFunc = D3D11_COMPARISON_ALWAYS;
-            dsd.StencilEnable = FALSE;
-
-            hr = d3d11_device->lpVtbl->CreateDepthStencilState(d3d11_device, &dsd, &d3d11_pipeline->p_depth_stencil_state);
-            if (FAILED(hr)) {
-                dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create default depth/stencil state");
-                goto error;
+        if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) {
+            vertex_input = library;
+            d3d11_pipeline->topology = state->topology;
+            d3d11_pipeline->p_input_layout = state->p_input_layout;
+        }
+        if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) {
+            pre_rasterization = library;
+            d3d11_pipeline->p_vertex_shader = state->p_vertex_shader;
+            d3d11_pipeline->p_hull_shader = state->p_hull_shader;
+            d3d11_pipeline->p_domain_shader = state->p_domain_shader;
+            d3d11_pipeline->p_geometry_shader = state->p_geometry_shader;
+            for (uint32_t stage = 0; stage < d3d11_shader_stage_index(VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT); ++stage) {
+                d3d11_pipeline->p_specialization_buffers[stage] = state->p_specialization_buffers[stage];
             }
-            d3d11_pipeline->stencil_ref = 0;
+            d3d11_pipeline->p_rasterizer_state = state->p_rasterizer_state;
+            d3d11_pipeline->rasterizer_desc = state->rasterizer_desc;
+        }
+        if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER) {
+            d3d11_pipeline->p_pixel_shader = state->p_pixel_shader;
+            d3d11_pipeline->p_specialization_buffers[d3d11_shader_stage_index(VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT)] =
+                state->p_specialization_buffers[d3d11_shader_stage_index(VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT)];
+            d3d11_pipeline->p_depth_stencil_state = state->p_depth_stencil_state;
+            d3d11_pipeline->stencil_ref = state->stencil_ref;
+        }
+        if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) {
+            d3d11_pipeline->p_blend_state = state->p_blend_state;
+            memcpy(d3d11_pipeline->blend_constants, state->blend_constants, sizeof(d3d11_pipeline->blend_constants));
+            d3d11_pipeline->sample_mask = state->sample_mask;
+            d3d11_pipeline->sample_count = state->sample_count;
+            d3d11_pipeline->sample_shading_enable = state->sample_shading_enable;
+            d3d11_pipeline->render_target_count = state->render_target_count;
         }
     }
 
-    // Multisample
-    {
-        if (p_desc->p_multisample_state) {
-            // D3D11 doesn't have a dedicated multisample state object like Vulkan.
-            // Sampling behavior is mostly determined at texture/RT creation. We still store sample_count.
-            d3d11_pipeline->sample_count = (UINT)p_desc->p_multisample_state->sample_count;
-            d3d11_pipeline->sample_shading_enable = p_desc->p_multisample_state->sample_shading_enable;
-            // alpha-to-coverage handled by blend_desc.AlphaToCoverageEnable above
+    // The libraries keep their references, so they can be destroyed before the pipeline
+    COM_SAFE_ADDREF(d3d11_pipeline->p_vertex_shader);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_hull_shader);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_domain_shader);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_geometry_shader);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_pixel_shader);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_input_layout);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_rasterizer_state);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_depth_stencil_state);
+    COM_SAFE_ADDREF(d3d11_pipeline->p_blend_state);
+    for (uint32_t i = 0; i < VRI_D3D11_SHADER_STAGE_COUNT; ++i) {
+        COM_SAFE_ADDREF(d3d11_pipeline->p_specialization_buffers[i]);
+    }
+
+    VriResult err = VRI_SUCCESS;
+    if (!d3d11_pipeline->p_input_layout && vertex_input && vertex_input->element_count) {
+        if (pre_rasterization && pre_rasterization->p_vertex_bytecode) {
+            err = d3d11_pipeline_create_input_layout(device, vertex_input->p_elements, vertex_input->element_count, pre_rasterization->p_vertex_bytecode,
+                                                     pre_rasterization->vertex_bytecode_size, d3d11_pipeline);
         } else {
-            d3d11_pipeline->sample_count = 1;
-            d3d11_pipeline->sample_shading_enable = 0;
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Vertex input needs a vertex shader to link against");
+            err = VRI_ERROR_INVALID_API_USAGE;
         }
     }
+    if (VRI_OK(err) && !d3d11_pipeline->p_rasterizer_state) {
+        err = d3d11_pipeline_create_rasterizer_state(device, d3d11_pipeline);
+    }
 
-    return VRI_SUCCESS;
-
-error:
-    // Release com objects in case they have been created
-    COM_SAFE_RELEASE(d3d11_pipeline->p_vertex_shader);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_input_layout);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_hull_shader);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_domain_shader);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_geometry_shader);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_pixel_shader);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_rasterizer_state);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_depth_stencil_state);
-    COM_SAFE_RELEASE(d3d11_pipeline->p_blend_state);
-
-    // Free pipeline object
-    device->allocation_callback.pfn_free(*p_pipeline, PIPELINE_OBJECT_SIZE, 8);
-    *p_pipeline = NULL;
+    if (VRI_ERROR(err)) {
+        d3d11_pipeline_release(d3d11_pipeline);
+        vri_object_free(device, &device->allocation_callback, *p_pipeline, PIPELINE_OBJECT_SIZE);
+        *p_pipeline = NULL;
+    }
 
     return err;
 }
 
-static VriResult d3d11_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+VriResult d3d11_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
     VriDebugCallback dbg = device->debug_callback;
 
     // Allocate pipeline internals
-    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_PIPELINE);
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
     if (!*p_pipeline) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
         return VRI_ERROR_OUT_OF_MEMORY;
@@ -333,30 +258,39 @@ static VriResult d3d11_pipeline_create_compute(VriDevice device, const VriComput
 
     (*p_pipeline)->p_backend_data = (VriD3D11Pipeline *)(*p_pipeline + 1);
     VriD3D11Pipeline *d3d11_pipeline = (*p_pipeline)->p_backend_data;
-    ID3D11Device5    *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
 
-    HRESULT hr = d3d11_device->lpVtbl->CreateComputeShader(
-        d3d11_device,
-        p_desc->p_shader[0].p_bytecode,
-        p_desc->p_shader[0].size,
-        NULL,
-        &d3d11_pipeline->p_compute_shader);
-
-    if (FAILED(hr)) {
-        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create compute shader for compute pipeline");
-        return VRI_ERROR_SYSTEM_FAILURE;
+    VriResult err = d3d11_pipeline_create_shader(device, p_desc->p_shader, d3d11_pipeline);
+    if (VRI_ERROR(err)) {
+        d3d11_pipeline_release(d3d11_pipeline);
+        vri_object_free(device, &device->allocation_callback, *p_pipeline, PIPELINE_OBJECT_SIZE);
+        *p_pipeline = NULL;
     }
 
-    return VRI_SUCCESS;
+    return err;
+}
+
+void d3d11_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    if (pipeline) {
+        d3d11_pipeline_release(pipeline->p_backend_data);
+        vri_object_free(device, &device->allocation_callback, pipeline, PIPELINE_OBJECT_SIZE);
+    }
 }
 
-static void d3d11_pipeline_bind(VriCommandBuffer command_buffer, VriPipeline pipeline) {
+void d3d11_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
     if (!pipeline) return;
 
-    ID3D11DeviceContext4 *deferred_context = ((VriD3D11CommandBuffer *)command_buffer->p_backend_data)->p_deferred_context;
-    VriPipeline           current_pipeline = command_buffer->pipeline;
-    VriD3D11Pipeline     *new_d3d11_pipeline = pipeline->p_backend_data;
-    VriD3D11Pipeline     *current_d3d11_pipeline = current_pipeline ? (VriD3D11Pipeline *)pipeline->p_backend_data : NULL;
+    VriPipeline current_pipeline = command_buffer->pipeline;
+    if (pipeline == current_pipeline) {
+        command_buffer->stats.pipeline_binds_redundant++;
+        return;
+    }
+
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    ID3D11DeviceContext4  *deferred_context = cb->p_deferred_context;
+    VriD3D11Pipeline      *new_d3d11_pipeline = pipeline->p_backend_data;
+    VriD3D11Pipeline      *current_d3d11_pipeline = current_pipeline ? (VriD3D11Pipeline *)current_pipeline->p_backend_data : NULL;
+
+    command_buffer->pipeline = pipeline;
 
     // Graphics Pipeline
     if (new_d3d11_pipeline->p_compute_shader == NULL) {
@@ -376,19 +310,24 @@ static void d3d11_pipeline_bind(VriCommandBuffer command_buffer, VriPipeline pip
         if (!current_pipeline || new_d3d11_pipeline->p_pixel_shader != current_d3d11_pipeline->p_pixel_shader) {
             deferred_context->lpVtbl->PSSetShader(deferred_context, new_d3d11_pipeline->p_pixel_shader, NULL, 0);
         }
+        d3d11_cmd_bind_specialization_buffers(deferred_context, new_d3d11_pipeline, current_d3d11_pipeline);
 
         // States
         if (!current_pipeline || new_d3d11_pipeline->topology != current_d3d11_pipeline->topology) {
             deferred_context->lpVtbl->IASetPrimitiveTopology(deferred_context, new_d3d11_pipeline->topology);
         }
-        if (!current_pipeline || new_d3d11_pipeline->p_rasterizer_state != current_d3d11_pipeline->p_rasterizer_state) {
-            deferred_context->lpVtbl->RSSetState(deferred_context, new_d3d11_pipeline->p_rasterizer_state);
+        // Dynamic values are compared as applied, so pipelines sharing a state object and its values skip the call
+        if (!current_pipeline || new_d3d11_pipeline->p_rasterizer_state != current_d3d11_pipeline->p_rasterizer_state ||
+            ((new_d3d11_pipeline->dynamic_states | current_d3d11_pipeline->dynamic_states) & VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS)) {
+            d3d11_cmd_apply_rasterizer_state(command_buffer, new_d3d11_pipeline);
         }
-        if (!current_pipeline || new_d3d11_pipeline->p_blend_state != current_d3d11_pipeline->p_blend_state) {
-            deferred_context->lpVtbl->OMSetBlendState(deferred_context, new_d3d11_pipeline->p_blend_state, NULL, 0xFFFFFFFF);
+        if (!current_pipeline || new_d3d11_pipeline->p_blend_state != current_d3d11_pipeline->p_blend_state ||
+            memcmp(d3d11_blend_constants(cb, new_d3d11_pipeline), d3d11_blend_constants(cb, current_d3d11_pipeline), sizeof(cb->blend_constants))) {
+            d3d11_cmd_apply_blend_state(command_buffer, new_d3d11_pipeline);
         }
-        if (!current_pipeline || new_d3d11_pipeline->p_depth_stencil_state != current_d3d11_pipeline->p_depth_stencil_state) {
-            deferred_context->lpVtbl->OMSetDepthStencilState(deferred_context, new_d3d11_pipeline->p_depth_stencil_state, 0);
+        if (!current_pipeline || new_d3d11_pipeline->p_depth_stencil_state != current_d3d11_pipeline->p_depth_stencil_state ||
+            d3d11_stencil_reference(cb, new_d3d11_pipeline) != d3d11_stencil_reference(cb, current_d3d11_pipeline)) {
+            d3d11_cmd_apply_depth_stencil_state(command_buffer, new_d3d11_pipeline);
         }
     }
     // Compute Pipeline
@@ -396,5 +335,460 @@ static void d3d11_pipeline_bind(VriCommandBuffer command_buffer, VriPipeline pip
         if (!current_pipeline || new_d3d11_pipeline->p_compute_shader != current_d3d11_pipeline->p_compute_shader) {
             deferred_context->lpVtbl->CSSetShader(deferred_context, new_d3d11_pipeline->p_compute_shader, NULL, 0);
         }
+        d3d11_cmd_bind_specialization_buffers(deferred_context, new_d3d11_pipeline, current_d3d11_pipeline);
+    }
+}
+
+void d3d11_cmd_apply_blend_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    cb->p_deferred_context->lpVtbl->OMSetBlendState(cb->p_deferred_context, pipeline->p_blend_state, d3d11_blend_constants(cb, pipeline), pipeline->sample_mask);
+}
+
+void d3d11_cmd_apply_depth_stencil_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    cb->p_deferred_context->lpVtbl->OMSetDepthStencilState(cb->p_deferred_context, pipeline->p_depth_stencil_state, d3d11_stencil_reference(cb, pipeline));
+}
+
+// D3D11 has no dynamic depth bias, the bias is part of the rasterizer state. The
+// runtime hands out the same object for identical descs, so recreating the state
+// for every bias is a lookup once a value has been seen.
+void d3d11_cmd_apply_rasterizer_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline) {
+    VriD3D11CommandBuffer *cb = command_buffer->p_backend_data;
+    ID3D11RasterizerState *rasterizer_state = pipeline->p_rasterizer_state;
+
+    if (pipeline->dynamic_states & VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS) {
+        VriDevice             device = command_buffer->base.p_device;
+        ID3D11Device5        *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+        D3D11_RASTERIZER_DESC rasterizer_desc = pipeline->rasterizer_desc;
+        rasterizer_desc.DepthBias = (INT)cb->depth_bias_constant_factor;
+        rasterizer_desc.DepthBiasClamp = cb->depth_bias_clamp;
+        rasterizer_desc.SlopeScaledDepthBias = cb->depth_bias_slope_factor;
+
+        ID3D11RasterizerState *depth_bias_state = NULL;
+        HRESULT                hr = d3d11_device->lpVtbl->CreateRasterizerState(d3d11_device, &rasterizer_desc, &depth_bias_state);
+        if (SUCCEEDED(hr)) {
+            COM_SAFE_RELEASE(cb->p_depth_bias_rasterizer_state);
+            cb->p_depth_bias_rasterizer_state = depth_bias_state;
+            rasterizer_state = depth_bias_state;
+        } else {
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create rasterizer state for the dynamic depth bias");
+        }
+    }
+
+    cb->p_deferred_context->lpVtbl->RSSetState(cb->p_deferred_context, rasterizer_state);
+}
+
+static const float *d3d11_blend_constants(const VriD3D11CommandBuffer *cb, const VriD3D11Pipeline *pipeline) {
+    return (pipeline->dynamic_states & VRI_DYNAMIC_STATE_FLAG_BIT_BLEND_CONSTANTS) ? cb->blend_constants : pipeline->blend_constants;
+}
+
+static uint32_t d3d11_stencil_reference(const VriD3D11CommandBuffer *cb, const VriD3D11Pipeline *pipeline) {
+    return (pipeline->dynamic_states & VRI_DYNAMIC_STATE_FLAG_BIT_STENCIL_REFERENCE) ? cb->stencil_reference : pipeline->stencil_ref;
+}
+
+// Creates the shaders and state objects of the given parts. The input layout and
+// the rasterizer state are only created when the desc has all the parts they read.
+static VriResult d3d11_pipeline_build(VriDevice device, VriPipelineLibraryFlags parts, const VriGraphicsPipelineDesc *p_desc, VriD3D11Pipeline *d3d11_pipeline) {
+    VriResult err = d3d11_pipeline_create_shaders(device, vri_pipeline_library_stages(parts), p_desc, d3d11_pipeline);
+    if (VRI_ERROR(err)) return err;
+
+    d3d11_pipeline->dynamic_states = p_desc->dynamic_states & vri_pipeline_library_dynamic_states(parts);
+
+    // Input Assembly State
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) {
+        d3d11_pipeline->topology = vri_topology_to_d3d11_topology(p_desc->p_input_assembly_state->topology);
+    }
+
+    // Vertex Input, validated against the vertex shader's input signature
+    if ((parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) && (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) && p_desc->p_vertex_input) {
+        // Make sure we have vertex shader when we have vertex input
+        const VriShaderModuleDesc *vertex_shader = d3d11_vertex_shader(p_desc);
+        if (!vertex_shader) return VRI_ERROR_INVALID_API_USAGE;
+
+        size_t                    elems_size = 0;
+        D3D11_INPUT_ELEMENT_DESC *elems = d3d11_input_elements_allocate(device, p_desc->p_vertex_input, VRI_ALLOCATION_SCOPE_TRANSIENT, &elems_size);
+        if (!elems) return VRI_ERROR_OUT_OF_MEMORY;
+
+        size_t      bytecode_size = 0;
+        const void *p_bytecode = vri_shader_bytecode(vertex_shader, &bytecode_size);
+        err = d3d11_pipeline_create_input_layout(device, elems, p_desc->p_vertex_input->attribute_count, p_bytecode, bytecode_size, d3d11_pipeline);
+        device->allocation_callback.pfn_free(elems, elems_size, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+        if (VRI_ERROR(err)) return err;
+    }
+
+    // Rasterization State, its multisample enable comes from the fragment output
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) {
+        const VriRasterizationStateDesc *rdesc = p_desc->p_rasterization_state;
+
+        D3D11_RASTERIZER_DESC rasterizer_desc = {
+            .FillMode = rdesc->fill_mode == VRI_FILL_MODE_FILL ? D3D11_FILL_SOLID : D3D11_FILL_WIREFRAME,
+            .CullMode = vri_cull_mode_to_d3d11(rdesc->cull_mode),
+            .FrontCounterClockwise = rdesc->front_face == VRI_FRONT_FACE_COUNTER_CLOCKWISE ? TRUE : FALSE,
+            .DepthClipEnable = rdesc->depth_clamp_enable ? FALSE : TRUE,
+            .ScissorEnable = (p_desc->dynamic_states & VRI_DYNAMIC_STATE_FLAG_BIT_SCISSOR) ? TRUE : FALSE,
+        };
+        if (rdesc->depth_bias_enable) {
+            rasterizer_desc.DepthBias = (INT)rdesc->depth_bias_constant_factor;
+            rasterizer_desc.DepthBiasClamp = rdesc->depth_bias_clamp;
+            rasterizer_desc.SlopeScaledDepthBias = rdesc->depth_bias_slope_factor;
+        }
+        d3d11_pipeline->rasterizer_desc = rasterizer_desc;
+    }
+
+    // Depth-Stencil State
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER) {
+        err = d3d11_pipeline_create_depth_stencil_state(device, p_desc->p_depth_stencil_state, d3d11_pipeline);
+        if (VRI_ERROR(err)) return err;
+    }
+
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) {
+        // Blend State (OM)
+        err = d3d11_pipeline_create_blend_state(device, p_desc->p_color_blend_state, d3d11_pipeline);
+        if (VRI_ERROR(err)) return err;
+
+        // Multisample
+        if (p_desc->p_multisample_state) {
+            // D3D11 doesn't have a dedicated multisample state object like Vulkan.
+            // Sampling behavior is mostly determined at texture/RT creation. We still store sample_count.
+            d3d11_pipeline->sample_count = (UINT)p_desc->p_multisample_state->sample_count;
+            d3d11_pipeline->sample_shading_enable = p_desc->p_multisample_state->sample_shading_enable;
+            // alpha-to-coverage handled by blend_desc.AlphaToCoverageEnable
+        } else {
+            d3d11_pipeline->sample_count = 1;
+            d3d11_pipeline->sample_shading_enable = 0;
+        }
+    }
+
+    if ((parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) && (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT)) {
+        err = d3d11_pipeline_create_rasterizer_state(device, d3d11_pipeline);
+        if (VRI_ERROR(err)) return err;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult d3d11_pipeline_create_shaders(VriDevice device, VriShaderStageFlags stages, const VriGraphicsPipelineDesc *p_desc, VriD3D11Pipeline *d3d11_pipeline) {
+    for (uint32_t i = 0; i < p_desc->shader_count; ++i) {
+        const VriShaderModuleDesc *shader_desc = (p_desc->p_shaders + i);
+        if (!(shader_desc->stage & stages)) continue;
+
+        VriResult err = d3d11_pipeline_create_shader(device, shader_desc, d3d11_pipeline);
+        if (VRI_ERROR(err)) return err;
+    }
+
+    return VRI_SUCCESS;
+}
+
+// Stages with a module share the module's shader object instead of creating their own
+static VriResult d3d11_pipeline_create_shader(VriDevice device, const VriShaderModuleDesc *p_shader, VriD3D11Pipeline *d3d11_pipeline) {
+    VriDebugCallback     dbg = device->debug_callback;
+    ID3D11Device5       *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+    VriD3D11ShaderModule shaders = {0};
+
+    if (p_shader->module) {
+        shaders = *(const VriD3D11ShaderModule *)p_shader->module->p_backend_data;
+    } else if (FAILED(d3d11_shader_create(d3d11_device, p_shader->stage, p_shader->p_bytecode, p_shader->size, &shaders))) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create shader for shader module");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    // Only the stage's shader is set. The pipeline holds its own reference to
+    // module shaders, so the module can be destroyed before the pipeline
+    if (shaders.p_vertex_shader) d3d11_pipeline->p_vertex_shader = shaders.p_vertex_shader;
+    if (shaders.p_hull_shader) d3d11_pipeline->p_hull_shader = shaders.p_hull_shader;
+    if (shaders.p_domain_shader) d3d11_pipeline->p_domain_shader = shaders.p_domain_shader;
+    if (shaders.p_geometry_shader) d3d11_pipeline->p_geometry_shader = shaders.p_geometry_shader;
+    if (shaders.p_pixel_shader) d3d11_pipeline->p_pixel_shader = shaders.p_pixel_shader;
+    if (shaders.p_compute_shader) d3d11_pipeline->p_compute_shader = shaders.p_compute_shader;
+    if (p_shader->module) {
+        COM_SAFE_ADDREF(shaders.p_vertex_shader);
+        COM_SAFE_ADDREF(shaders.p_hull_shader);
+        COM_SAFE_ADDREF(shaders.p_domain_shader);
+        COM_SAFE_ADDREF(shaders.p_geometry_shader);
+        COM_SAFE_ADDREF(shaders.p_pixel_shader);
+        COM_SAFE_ADDREF(shaders.p_compute_shader);
+    }
+
+    return d3d11_pipeline_create_specialization_buffer(device, p_shader, d3d11_pipeline);
+}
+
+static HRESULT d3d11_shader_create(ID3D11Device5 *d3d11_device, VriShaderStageFlagBits stage, const void *p_bytecode, size_t size, VriD3D11ShaderModule *d3d11_shaders) {
+    switch (stage) {
+        case VRI_SHADER_STAGE_FLAG_BIT_VERTEX:
+            return d3d11_device->lpVtbl->CreateVertexShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_vertex_shader);
+        case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_CONTROL:
+            return d3d11_device->lpVtbl->CreateHullShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_hull_shader);
+        case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_EVALUATION:
+            return d3d11_device->lpVtbl->CreateDomainShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_domain_shader);
+        case VRI_SHADER_STAGE_FLAG_BIT_GEOMETRY:
+            return d3d11_device->lpVtbl->CreateGeometryShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_geometry_shader);
+        case VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT:
+            return d3d11_device->lpVtbl->CreatePixelShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_pixel_shader);
+        case VRI_SHADER_STAGE_FLAG_BIT_COMPUTE:
+            return d3d11_device->lpVtbl->CreateComputeShader(d3d11_device, p_bytecode, size, NULL, &d3d11_shaders->p_compute_shader);
+        default:
+            return E_INVALIDARG;
+    }
+}
+
+static VriResult d3d11_shader_module_init(VriDevice device, VriShaderModule shader_module) {
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+
+    HRESULT hr = d3d11_shader_create(d3d11_device, shader_module->stage, shader_module->p_bytecode, shader_module->size, shader_module->p_backend_data);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create shader for shader module");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static void d3d11_shader_module_deinit(VriDevice device, VriShaderModule shader_module) {
+    VriD3D11ShaderModule *d3d11_shaders = shader_module->p_backend_data;
+    (void)device;
+
+    COM_SAFE_RELEASE(d3d11_shaders->p_vertex_shader);
+    COM_SAFE_RELEASE(d3d11_shaders->p_hull_shader);
+    COM_SAFE_RELEASE(d3d11_shaders->p_domain_shader);
+    COM_SAFE_RELEASE(d3d11_shaders->p_geometry_shader);
+    COM_SAFE_RELEASE(d3d11_shaders->p_pixel_shader);
+    COM_SAFE_RELEASE(d3d11_shaders->p_compute_shader);
+}
+
+static VriResult d3d11_pipeline_create_input_layout(VriDevice device, const D3D11_INPUT_ELEMENT_DESC *p_elements, uint32_t element_count, const void *p_bytecode, size_t bytecode_size, VriD3D11Pipeline *d3d11_pipeline) {
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+
+    HRESULT hr = d3d11_device->lpVtbl->CreateInputLayout(d3d11_device, p_elements, element_count, p_bytecode, bytecode_size, &d3d11_pipeline->p_input_layout);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create input layout");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult d3d11_pipeline_create_rasterizer_state(VriDevice device, VriD3D11Pipeline *d3d11_pipeline) {
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+
+    d3d11_pipeline->rasterizer_desc.MultisampleEnable = d3d11_pipeline->sample_count > 1 ? TRUE : FALSE;
+
+    HRESULT hr = d3d11_device->lpVtbl->CreateRasterizerState(d3d11_device, &d3d11_pipeline->rasterizer_desc, &d3d11_pipeline->p_rasterizer_state);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create rasterizer state");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult d3d11_pipeline_create_blend_state(VriDevice device, const VriColorBlendStateDesc *p_color_blend_state, VriD3D11Pipeline *d3d11_pipeline) {
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+
+    // If user provided a color blend state, use it; otherwise create a default opaque write-through state.
+    D3D11_BLEND_DESC blend_desc = {
+        .AlphaToCoverageEnable = FALSE,
+        .IndependentBlendEnable = FALSE,
+    };
+
+    if (p_color_blend_state) {
+        const VriColorBlendStateDesc *cbs = p_color_blend_state;
+        blend_desc.IndependentBlendEnable = cbs->independent_blend_enable ? TRUE : FALSE;
+        blend_desc.AlphaToCoverageEnable = cbs->alpha_to_coverage_enable ? TRUE : FALSE;
+        memcpy(d3d11_pipeline->blend_constants, cbs->blend_constants, sizeof(d3d11_pipeline->blend_constants));
+
+        uint32_t rt_count = cbs->render_target_count ? cbs->render_target_count : 1;
+        rt_count = rt_count > D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT ? D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT : rt_count;
+
+        for (uint32_t i = 0; i < rt_count; ++i) {
+            const VriColorBlendAttachmentDesc *att = &cbs->render_targets[i];
+
+            D3D11_RENDER_TARGET_BLEND_DESC *rt = &blend_desc.RenderTarget[i];
+            rt->BlendEnable = att->blend_enable ? TRUE : FALSE;
+            rt->SrcBlend = vri_blend_factor_to_d3d11(att->src_color_blend_factor);
+            rt->DestBlend = vri_blend_factor_to_d3d11(att->dst_color_blend_factor);
+            rt->BlendOp = vri_blend_op_to_d3d11(att->color_blend_op);
+            rt->SrcBlendAlpha = vri_blend_factor_to_d3d11(att->src_alpha_blend_factor);
+            rt->DestBlendAlpha = vri_blend_factor_to_d3d11(att->dst_alpha_blend_factor);
+            rt->BlendOpAlpha = vri_blend_op_to_d3d11(att->alpha_blend_op);
+            rt->RenderTargetWriteMask = att->color_write_mask;
+        }
+
+        d3d11_pipeline->render_target_count = rt_count;
+    } else {
+        // default: no blending, write all channels
+        blend_desc.RenderTarget[0].BlendEnable = FALSE;
+        blend_desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+        d3d11_pipeline->render_target_count = 1;
+    }
+
+    // store a default sample mask (D3D11 uses sample mask on OMSetBlendState)
+    d3d11_pipeline->sample_mask = 0xFFFFFFFF;
+
+    HRESULT hr = d3d11_device->lpVtbl->CreateBlendState(d3d11_device, &blend_desc, &d3d11_pipeline->p_blend_state);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create blend state");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult d3d11_pipeline_create_depth_stencil_state(VriDevice device, const VriDepthStencilStateDesc *p_depth_stencil_state, VriD3D11Pipeline *d3d11_pipeline) {
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+
+    // If no depth/stencil state supplied, create a default disabled depth/stencil state
+    D3D11_DEPTH_STENCIL_DESC depth_stencil_desc = {
+        .DepthEnable = FALSE,
+        .DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO,
+        .DepthFunc = D3D11_COMPARISON_ALWAYS,
+        .StencilEnable = FALSE,
+    };
+    d3d11_pipeline->stencil_ref = 0;
+
+    if (p_depth_stencil_state) {
+        const VriDepthStencilStateDesc *dsdesc = p_depth_stencil_state;
+
+        depth_stencil_desc = (D3D11_DEPTH_STENCIL_DESC){
+            .DepthEnable = dsdesc->depth_test_enable ? TRUE : FALSE,
+            .DepthWriteMask = dsdesc->depth_write_enable ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO,
+            .DepthFunc = vri_compare_op_to_d3d11(dsdesc->depth_compare_op),
+
+            .StencilEnable = dsdesc->stencil_test_enable ? TRUE : FALSE,
+            .StencilReadMask = dsdesc->stencil_read_mask,
+            .StencilWriteMask = dsdesc->stencil_write_mask,
+
+            .FrontFace.StencilFailOp = vri_stencil_op_to_d3d11(dsdesc->front.fail_op),
+            .FrontFace.StencilDepthFailOp = vri_stencil_op_to_d3d11(dsdesc->front.depth_fail_op),
+            .FrontFace.StencilPassOp = vri_stencil_op_to_d3d11(dsdesc->front.pass_op),
+            .FrontFace.StencilFunc = vri_compare_op_to_d3d11(dsdesc->front.compare_op),
+
+            .BackFace.StencilFailOp = vri_stencil_op_to_d3d11(dsdesc->back.fail_op),
+            .BackFace.StencilDepthFailOp = vri_stencil_op_to_d3d11(dsdesc->back.depth_fail_op),
+            .BackFace.StencilPassOp = vri_stencil_op_to_d3d11(dsdesc->back.pass_op),
+            .BackFace.StencilFunc = vri_compare_op_to_d3d11(dsdesc->back.compare_op),
+        };
+        d3d11_pipeline->stencil_ref = dsdesc->stencil_reference;
+    }
+
+    HRESULT hr = d3d11_device->lpVtbl->CreateDepthStencilState(d3d11_device, &depth_stencil_desc, &d3d11_pipeline->p_depth_stencil_state);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create depth stencil state");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static void d3d11_pipeline_release(VriD3D11Pipeline *d3d11_pipeline) {
+    COM_SAFE_RELEASE(d3d11_pipeline->p_vertex_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_hull_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_domain_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_geometry_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_pixel_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_compute_shader);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_input_layout);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_rasterizer_state);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_depth_stencil_state);
+    COM_SAFE_RELEASE(d3d11_pipeline->p_blend_state);
+    for (uint32_t i = 0; i < VRI_D3D11_SHADER_STAGE_COUNT; ++i) {
+        COM_SAFE_RELEASE(d3d11_pipeline->p_specialization_buffers[i]);
+    }
+}
+
+// Semantic names are copied behind the elements, so library elements outlive the desc
+static D3D11_INPUT_ELEMENT_DESC *d3d11_input_elements_allocate(VriDevice device, const VriVertexInputDesc *p_vertex_input, VriAllocationScope scope, size_t *p_size) {
+    size_t elems_size = sizeof(D3D11_INPUT_ELEMENT_DESC) * p_vertex_input->attribute_count;
+    size_t size = elems_size;
+    for (uint32_t i = 0; i < p_vertex_input->attribute_count; ++i) {
+        size += strlen(p_vertex_input->p_attributes[i].d3d.semantic_name) + 1;
+    }
+
+    D3D11_INPUT_ELEMENT_DESC *elems = device->allocation_callback.pfn_allocate(size, 8, scope);
+    if (!elems) return NULL;
+
+    char *p_names = (char *)elems + elems_size;
+    for (uint32_t i = 0; i < p_vertex_input->attribute_count; ++i) {
+        const VriVertexAttributeDesc *attr = &p_vertex_input->p_attributes[i];
+        VriVertexInputRate            input_rate = p_vertex_input->p_bindings[attr->binding].input_rate;
+        size_t                        name_size = strlen(attr->d3d.semantic_name) + 1;
+
+        memcpy(p_names, attr->d3d.semantic_name, name_size);
+        elems[i].SemanticName = p_names;
+        elems[i].SemanticIndex = attr->d3d.semantic_index;
+        elems[i].Format = vri_to_dxgi_format(attr->format)->typed;
+        elems[i].InputSlot = attr->binding;
+        elems[i].AlignedByteOffset = attr->offset;
+        elems[i].InputSlotClass = input_rate == VRI_VERTEX_INPUT_RATE_VERTEX ? D3D11_INPUT_PER_VERTEX_DATA : D3D11_INPUT_PER_INSTANCE_DATA;
+        elems[i].InstanceDataStepRate = input_rate == VRI_VERTEX_INPUT_RATE_VERTEX ? 0 : 1;
+        p_names += name_size;
+    }
+
+    *p_size = size;
+    return elems;
+}
+
+static const VriShaderModuleDesc *d3d11_vertex_shader(const VriGraphicsPipelineDesc *p_desc) {
+    for (uint32_t i = 0; i < p_desc->shader_count; ++i) {
+        if (p_desc->p_shaders[i].stage == VRI_SHADER_STAGE_FLAG_BIT_VERTEX) return &p_desc->p_shaders[i];
+    }
+    return NULL;
+}
+
+static uint32_t d3d11_shader_stage_index(VriShaderStageFlagBits stage) {
+    uint32_t index = 0;
+    while (stage > 1) {
+        stage >>= 1;
+        index++;
+    }
+    return index;
+}
+
+// D3D11 bytecode has no specialization constants, shaders read them from a
+// constant buffer instead. A pipeline's values never change, so it's immutable.
+static VriResult d3d11_pipeline_create_specialization_buffer(VriDevice device, const VriShaderModuleDesc *p_shader, VriD3D11Pipeline *d3d11_pipeline) {
+    if (!p_shader->specialization_constant_count) return VRI_SUCCESS;
+
+    uint32_t values[VRI_MAX_SPECIALIZATION_CONSTANTS] = {0};
+    uint32_t value_count = 0;
+    for (uint32_t i = 0; i < p_shader->specialization_constant_count; ++i) {
+        const VriSpecializationConstant *constant = &p_shader->p_specialization_constants[i];
+        values[constant->constant_id] = constant->value;
+        value_count = VRI_MAX(value_count, constant->constant_id + 1);
+    }
+
+    D3D11_BUFFER_DESC desc = {
+        .ByteWidth = (value_count * sizeof(uint32_t) + 15) & ~15u, // Constant buffers are sized in 16 byte registers
+        .Usage = D3D11_USAGE_IMMUTABLE,
+        .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+    };
+    D3D11_SUBRESOURCE_DATA data = {.pSysMem = values};
+
+    ID3D11Device5 *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+    ID3D11Buffer **pp_buffer = &d3d11_pipeline->p_specialization_buffers[d3d11_shader_stage_index(p_shader->stage)];
+    HRESULT        hr = d3d11_device->lpVtbl->CreateBuffer(d3d11_device, &desc, &data, pp_buffer);
+    if (FAILED(hr)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create specialization constant buffer");
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    return VRI_SUCCESS;
+}
+
+static void d3d11_cmd_bind_specialization_buffers(ID3D11DeviceContext4 *context, const VriD3D11Pipeline *pipeline, const VriD3D11Pipeline *current_pipeline) {
+    const UINT slot = VRI_SPECIALIZATION_CONSTANT_BUFFER_SLOT;
+
+    for (uint32_t i = 0; i < VRI_D3D11_SHADER_STAGE_COUNT; ++i) {
+        ID3D11Buffer *buffer = pipeline->p_specialization_buffers[i];
+        if (buffer == (current_pipeline ? current_pipeline->p_specialization_buffers[i] : NULL)) continue;
+
+        switch ((VriShaderStageFlagBits)(1u << i)) {
+            case VRI_SHADER_STAGE_FLAG_BIT_VERTEX: context->lpVtbl->VSSetConstantBuffers(context, slot, 1, &buffer); break;
+            case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_CONTROL: context->lpVtbl->HSSetConstantBuffers(context, slot, 1, &buffer); break;
+            case VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_EVALUATION: context->lpVtbl->DSSetConstantBuffers(context, slot, 1, &buffer); break;
+            case VRI_SHADER_STAGE_FLAG_BIT_GEOMETRY: context->lpVtbl->GSSetConstantBuffers(context, slot, 1, &buffer); break;
+            case VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT: context->lpVtbl->PSSetConstantBuffers(context, slot, 1, &buffer); break;
+            case VRI_SHADER_STAGE_FLAG_BIT_COMPUTE: context->lpVtbl->CSSetConstantBuffers(context, slot, 1, &buffer); break;
+            default: break;
+        }
     }
 }
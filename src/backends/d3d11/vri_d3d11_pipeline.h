@@ -3,6 +3,8 @@
 
 #include "vri_d3d11_common.h"
 
+#define VRI_D3D11_SHADER_STAGE_COUNT 6 // Vertex to compute, in VriShaderStageFlagBits order
+
 typedef struct {
     ID3D11VertexShader   *p_vertex_shader;
     ID3D11HullShader     *p_hull_shader;
@@ -23,8 +25,11 @@ typedef struct {
     ID3D11RasterizerState   *p_rasterizer_state;
     ID3D11DepthStencilState *p_depth_stencil_state;
     ID3D11BlendState        *p_blend_state;
+    ID3D11Buffer            *p_specialization_buffers[VRI_D3D11_SHADER_STAGE_COUNT]; // Specialization constants per stage
     D3D11_PRIMITIVE_TOPOLOGY topology;
-    D3D11_RASTERIZER_DESC    rasterizer_desc;
+    D3D11_RASTERIZER_DESC    rasterizer_desc; // Base of the rasterizer states created for a dynamic depth bias
+    VriDynamicStateFlags     dynamic_states;
+    float                    blend_constants[4];
     uint32_t                 sample_mask;
     uint32_t                 sample_count;
     uint32_t                 stencil_ref;
@@ -32,7 +37,31 @@ typedef struct {
     bool                     sample_shading_enable;
 } VriD3D11Pipeline;
 
-void d3d11_register_pipeline_functions_with_device(VriDeviceDispatchTable *table);
-void d3d11_register_pipeline_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+// The state objects of the library's parts, plus the input layout's half that
+// the library has when the vertex input and pre-rasterization parts are split
+typedef struct {
+    VriD3D11Pipeline          state;
+    D3D11_INPUT_ELEMENT_DESC *p_elements; // Vertex input, semantic names are stored behind the elements
+    size_t                    elements_size;
+    uint32_t                  element_count;
+    void                     *p_vertex_bytecode; // Pre-rasterization, for the input signature
+    size_t                    vertex_bytecode_size;
+} VriD3D11PipelineLibrary;
+
+void      d3d11_register_pipeline_functions_with_device(VriDeviceDispatchTable *table);
+void      d3d11_register_pipeline_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+VriResult d3d11_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module);
+void      d3d11_shader_module_destroy(VriDevice device, VriShaderModule shader_module);
+VriResult d3d11_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout);
+VriResult d3d11_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline);
+VriResult d3d11_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
+void      d3d11_pipeline_destroy(VriDevice device, VriPipeline pipeline);
+VriResult d3d11_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library);
+void      d3d11_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library);
+VriResult d3d11_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline);
+void      d3d11_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline);
+void      d3d11_cmd_apply_blend_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline);
+void      d3d11_cmd_apply_depth_stencil_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline);
+void      d3d11_cmd_apply_rasterizer_state(VriCommandBuffer command_buffer, const VriD3D11Pipeline *pipeline);
 
 #endif
@@ -4,16 +4,21 @@
 #include "vri_d3d11_device.h"
 #include "vri_d3d11_fence.h"
 #include "vri_d3d11_swapchain.h"
+#include "vri_d3d11_texture.h"
 
 #define QUEUE_STRUCT_SIZE (sizeof(struct VriQueue_T))
 
-static VriResult d3d11_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count);
-static VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc);
+void d3d11_register_queue_functions(VriQueueDispatchTable *table) {
+    table->pfn_queue_submit = d3d11_queue_submit;
+    table->pfn_queue_wait_idle = d3d11_queue_wait_idle;
+    table->pfn_queue_present = d3d11_queue_present;
+    table->pfn_queue_bind_sparse = d3d11_queue_bind_sparse;
+}
 
 VriResult d3d11_queue_create(VriDevice device, const VriAllocationCallback *allocation_callback, VriQueue *p_queue) {
     // Attempt to allocate the full internal struct
     size_t queue_size = QUEUE_STRUCT_SIZE;
-    *p_queue = vri_object_allocate(device, allocation_callback, queue_size, VRI_OBJECT_QUEUE);
+    *p_queue = vri_object_allocate(device, allocation_callback, queue_size, VRI_OBJECT_TYPE_QUEUE);
     if (!*p_queue) {
         return VRI_ERROR_OUT_OF_MEMORY;
     }
@@ -21,20 +26,19 @@ VriResult d3d11_queue_create(VriDevice device, const VriAllocationCallback *allo
     // NOTE: For D3D11 Queues there won't be any backends as we are storing the parent device
     // in the base field so we can just reach back to that for the immediate context which we'll need.
 
-    // TODO: Fill up dispatch table!
-    (*p_queue)->dispatch.pfn_queue_submit = d3d11_queue_submit;
-    (*p_queue)->dispatch.pfn_queue_present = d3d11_queue_present;
+    // The device fills its queue table before creating the queues
+    (*p_queue)->dispatch = device->queue_dispatch;
 
     return VRI_SUCCESS;
 }
 
 void d3d11_queue_destroy(VriDevice device, VriQueue queue) {
     if (queue) {
-        device->allocation_callback.pfn_free(queue, QUEUE_STRUCT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, queue, QUEUE_STRUCT_SIZE);
     }
 }
 
-static VriResult d3d11_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
+VriResult d3d11_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
     // For the d3d11 backend we need to fetch the immediate context from
     // the parent device as the VriQueue type is just an empty wrapper
     VriD3D11Device       *pd = (VriD3D11Device *)(queue->base.p_device->p_backend_data);
@@ -73,7 +77,31 @@ static VriResult d3d11_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_
     return VRI_SUCCESS;
 }
 
-static VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc) {
+VriResult d3d11_queue_wait_idle(VriQueue queue) {
+    VriD3D11Device       *pd = (VriD3D11Device *)(queue->base.p_device->p_backend_data);
+    ID3D11DeviceContext4 *immediate_ctx = pd->p_immediate_context;
+
+    // An event query completes once the GPU has finished everything issued before it
+    D3D11_QUERY_DESC query_desc = {.Query = D3D11_QUERY_EVENT};
+    ID3D11Query     *query = NULL;
+    HRESULT          hr = pd->p_device->lpVtbl->CreateQuery(pd->p_device, &query_desc, &query);
+    if (FAILED(hr)) {
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    immediate_ctx->lpVtbl->End(immediate_ctx, (ID3D11Asynchronous *)query);
+
+    // Without D3D11_ASYNC_GETDATA_DONOTFLUSH this also flushes the context
+    BOOL done = FALSE;
+    while ((hr = immediate_ctx->lpVtbl->GetData(immediate_ctx, (ID3D11Asynchronous *)query, &done, sizeof(done), 0)) == S_FALSE) {
+        SwitchToThread();
+    }
+
+    COM_SAFE_RELEASE(query);
+    return SUCCEEDED(hr) ? VRI_SUCCESS : VRI_ERROR_DEVICE_REMOVED;
+}
+
+VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc) {
     // Wait for timeline fences before presenting
     VriDevice device = queue->base.p_device;
     VriResult wait_result = d3d11_fences_wait(
@@ -95,7 +123,7 @@ static VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *
         VriSwapchain swapchain = p_present_desc->p_swapchains[i];
         uint32_t     image_index = p_present_desc->p_image_indices ? p_present_desc->p_image_indices[i] : 0;
 
-        VriResult present_result = d3d11_swapchain_present(swapchain, image_index);
+        VriResult present_result = d3d11_swapchain_present_image(swapchain, image_index);
 
         // Store per-swapchain result if requested
         if (p_present_desc->p_results) {
@@ -110,3 +138,12 @@ static VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *
 
     return overall_result;
 }
+
+VriResult d3d11_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    // Tile mapping updates go through the immediate context, ordered with the submits around them
+    ID3D11DeviceContext4 *context = ((VriD3D11Device *)queue->base.p_device->p_backend_data)->p_immediate_context;
+    for (uint32_t i = 0; i < bind_count; ++i) {
+        d3d11_texture_bind_tiles(context, &p_binds[i]);
+    }
+    return VRI_SUCCESS;
+}
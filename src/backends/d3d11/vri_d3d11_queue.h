@@ -3,7 +3,12 @@
 
 #include "vri_d3d11_common.h"
 
+void      d3d11_register_queue_functions(VriQueueDispatchTable *table);
 VriResult d3d11_queue_create(VriDevice device, const VriAllocationCallback *allocation_callback, VriQueue *p_queue);
 void      d3d11_queue_destroy(VriDevice device, VriQueue queue);
+VriResult d3d11_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count);
+VriResult d3d11_queue_wait_idle(VriQueue queue);
+VriResult d3d11_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc);
+VriResult d3d11_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count);
 
 #endif
@@ -6,19 +6,24 @@
 
 #define SWAPCHAIN_STRUCT_SIZE (sizeof(struct VriSwapchain_T) + sizeof(VriD3D11Swapchain))
 
-static VriResult swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain);
-static void      swapchain_destroy(VriDevice device, VriSwapchain swapchain);
-static VriResult swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index);
+static VriResult swapchain_create_headless(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain);
 
 void d3d11_register_swapchain_functions(VriDeviceDispatchTable *table) {
-    table->pfn_swapchain_create = swapchain_create;
-    table->pfn_swapchain_destroy = swapchain_destroy;
-    table->pfn_swapchain_acquire_next_image = swapchain_acquire_next_image;
+    table->pfn_swapchain_create = d3d11_swapchain_create;
+    table->pfn_swapchain_destroy = d3d11_swapchain_destroy;
+    table->pfn_swapchain_acquire_next_image = d3d11_swapchain_acquire_next_image;
+    table->pfn_swapchain_present = d3d11_swapchain_present;
+    table->pfn_swapchain_get_texture = d3d11_swapchain_get_texture;
+    table->pfn_swapchain_get_stats = d3d11_swapchain_get_stats;
 }
 
-static VriResult swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+VriResult d3d11_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
     VriDebugCallback dbg = device->debug_callback;
 
+    if (!p_desc->p_window_desc) {
+        return swapchain_create_headless(device, p_desc, p_swapchain);
+    }
+
     HWND hwnd = (HWND)p_desc->p_window_desc->p_hwnd;
     if (!hwnd) {
         return VRI_ERROR_INVALID_API_USAGE;
@@ -83,7 +88,11 @@ static VriResult swapchain_create(VriDevice device, const VriSwapchainDesc *p_de
     DXGI_COLOR_SPACE_TYPE color_space = *vri_color_space_to_dxgi(p_desc->color_space);
     uint32_t              color_space_support = 0;
 
-    hr = swapchain4->lpVtbl->CheckColorSpaceSupport(swapchain4, color_space, &color_space_support);
+    if (color_space == DXGI_COLOR_SPACE_CUSTOM) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_WARNING, "DXGI can't present this color space, convert with vri_color_convert");
+    } else {
+        hr = swapchain4->lpVtbl->CheckColorSpaceSupport(swapchain4, color_space, &color_space_support);
+    }
     if (SUCCEEDED(hr) && (color_space_support & DXGI_SWAP_CHAIN_COLOR_SPACE_SUPPORT_FLAG_PRESENT)) {
         hr = swapchain4->lpVtbl->SetColorSpace1(swapchain4, color_space);
         if (FAILED(hr)) {
@@ -118,7 +127,7 @@ static VriResult swapchain_create(VriDevice device, const VriSwapchainDesc *p_de
     }
 
     // We are allocating the swapchain here so we can allocate the texture together with it
-    *p_swapchain = vri_object_allocate(device, &device->allocation_callback, SWAPCHAIN_STRUCT_SIZE, VRI_OBJECT_SWAPCHAIN);
+    *p_swapchain = vri_object_allocate(device, &device->allocation_callback, SWAPCHAIN_STRUCT_SIZE, VRI_OBJECT_TYPE_SWAPCHAIN);
     if (!*p_swapchain) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for swapchain struct failed.");
         result = VRI_ERROR_OUT_OF_MEMORY;
@@ -133,12 +142,12 @@ static VriResult swapchain_create(VriDevice device, const VriSwapchainDesc *p_de
         hr = swapchain4->lpVtbl->GetBuffer(swapchain4, 0, COM_IID_PPV_ARGS(ID3D11Resource, &native_texture));
         if (FAILED(hr)) {
             dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to get buffer from swapchain");
-            device->allocation_callback.pfn_free((*p_swapchain), SWAPCHAIN_STRUCT_SIZE, 8);
+            vri_object_free(device, &device->allocation_callback, (*p_swapchain), SWAPCHAIN_STRUCT_SIZE);
             result = VRI_ERROR_SYSTEM_FAILURE;
             goto error;
         }
 
-        if (d3d11_texture_create_from_resource(device, &native_texture, &internal->texture) != VRI_SUCCESS) {
+        if (d3d11_texture_create_from_resource(device, &native_texture, &internal->textures[0]) != VRI_SUCCESS) {
             dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't create textures from swapchain's backbuffer");
             result = VRI_ERROR_SYSTEM_FAILURE;
             goto error;
@@ -167,12 +176,14 @@ error:
     return result;
 }
 
-static void swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
+void d3d11_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
     if (swapchain) {
         VriD3D11Swapchain *internal = (VriD3D11Swapchain *)swapchain->p_backend_data;
 
         if (internal) {
-            d3d11_texture_destroy(device, internal->texture);
+            for (uint32_t i = 0; i < VRI_SWAPCHAIN_MAX_TEXTURES; ++i) {
+                if (internal->textures[i]) d3d11_texture_destroy(device, internal->textures[i]);
+            }
 
             COM_SAFE_RELEASE(internal->p_swapchain);
             COM_SAFE_RELEASE(internal->p_factory2);
@@ -181,17 +192,21 @@ static void swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
             internal->p_hwnd = NULL;
         }
 
-        device->allocation_callback.pfn_free(swapchain, SWAPCHAIN_STRUCT_SIZE, 8);
+        vri_object_free(device, &device->allocation_callback, swapchain, SWAPCHAIN_STRUCT_SIZE);
     }
 }
 
-static VriResult swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
+VriResult d3d11_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
     (void)device;
-    (void)swapchain;
-    (void)fence;
+    VriD3D11Swapchain *internal = swapchain->p_backend_data;
 
-    // Always 0 for D3D11 as we only have a single image that we are allowed to touch
-    *p_image_index = 0;
+    if (internal->headless) {
+        VriResult result = vri_headless_presenter_acquire(&internal->presenter, p_image_index);
+        if (VRI_ERROR(result)) return result;
+    } else {
+        // Always 0 for windows as we only have a single image that we are allowed to touch
+        *p_image_index = 0;
+    }
 
     // If a fence was provided, bump it immediately
     if (fence != VRI_NULL_HANDLE) {
@@ -201,9 +216,22 @@ static VriResult swapchain_acquire_next_image(VriDevice device, VriSwapchain swa
     return VRI_SUCCESS;
 }
 
-VriResult d3d11_swapchain_present(VriSwapchain swapchain, uint32_t image_index) {
+VriResult d3d11_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
+    (void)device;
+    (void)fence;
+    VriD3D11Swapchain *internal = swapchain->p_backend_data;
+    return d3d11_swapchain_present_image(swapchain, internal->headless ? internal->presenter.last_acquired : 0);
+}
+
+VriResult d3d11_swapchain_present_image(VriSwapchain swapchain, uint32_t image_index) {
     VriD3D11Swapchain *internal = swapchain->p_backend_data;
 
+    if (internal->headless) {
+        VriResult result = vri_headless_presenter_present(&internal->presenter, image_index);
+        if (VRI_OK(result)) internal->present_id++;
+        return result;
+    }
+
     if (image_index >= 1) {
         return VRI_ERROR_INVALID_API_USAGE;
     }
@@ -229,3 +257,75 @@ VriResult d3d11_swapchain_present(VriSwapchain swapchain, uint32_t image_index)
             return VRI_ERROR_SYSTEM_FAILURE;
     }
 }
+
+VriResult d3d11_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    (void)device;
+    VriD3D11Swapchain *internal = swapchain->p_backend_data;
+
+    uint32_t texture_count = internal->headless ? internal->presenter.texture_count : 1;
+    if (image_index >= texture_count) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    *p_texture = internal->textures[image_index];
+    return VRI_SUCCESS;
+}
+
+VriResult d3d11_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats) {
+    (void)device;
+    VriD3D11Swapchain *internal = swapchain->p_backend_data;
+
+    // DXGI's frame statistics are only kept for fullscreen windows
+    if (!internal->headless) {
+        return VRI_ERROR_UNSUPPORTED;
+    }
+
+    *p_stats = internal->presenter.stats;
+    return VRI_SUCCESS;
+}
+
+static VriResult swapchain_create_headless(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    VriHeadlessPresenter presenter;
+    if (VRI_ERROR(vri_headless_presenter_init(&presenter, p_desc))) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Headless swapchain needs 2 to VRI_SWAPCHAIN_MAX_TEXTURES textures and a valid present mode");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    *p_swapchain = vri_object_allocate(device, &device->allocation_callback, SWAPCHAIN_STRUCT_SIZE, VRI_OBJECT_TYPE_SWAPCHAIN);
+    if (!*p_swapchain) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for swapchain struct failed.");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    VriD3D11Swapchain *internal = (VriD3D11Swapchain *)((*p_swapchain) + 1);
+    (*p_swapchain)->p_backend_data = internal;
+    internal->headless = VRI_TRUE;
+    internal->flags = p_desc->flags;
+    internal->presenter = presenter;
+
+    VriTextureDesc texture_desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = p_desc->format,
+        .width = p_desc->width,
+        .height = p_desc->height,
+        .depth = 1,
+        .usage = VRI_TEXTURE_USAGE_BIT_COLOR_ATTACHMENT,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+    };
+
+    for (uint32_t i = 0; i < presenter.texture_count; ++i) {
+        VriResult result = d3d11_texture_create(device, &texture_desc, &internal->textures[i]);
+        if (result != VRI_SUCCESS) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't create textures for the headless swapchain");
+            d3d11_swapchain_destroy(device, *p_swapchain);
+            *p_swapchain = NULL;
+            return result;
+        }
+    }
+
+    return VRI_SUCCESS;
+}
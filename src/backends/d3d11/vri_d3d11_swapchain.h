@@ -3,17 +3,26 @@
 
 #include "vri_d3d11_common.h"
 
+// Headless swapchains have no DXGI swapchain and cycle their own textures
 typedef struct {
-    IDXGISwapChain4 *p_swapchain;
-    IDXGIFactory2   *p_factory2;
-    void            *p_waitable_object;
-    uint32_t         flags;
-    void            *p_hwnd;
-    uint64_t         present_id;
-    VriTexture       texture;
+    IDXGISwapChain4     *p_swapchain;
+    IDXGIFactory2       *p_factory2;
+    void                *p_waitable_object;
+    uint32_t             flags;
+    void                *p_hwnd;
+    uint64_t             present_id;
+    VriBool              headless;
+    VriTexture           textures[VRI_SWAPCHAIN_MAX_TEXTURES]; // Windows only expose the first
+    VriHeadlessPresenter presenter;
 } VriD3D11Swapchain;
 
 void      d3d11_register_swapchain_functions(VriDeviceDispatchTable *table);
-VriResult d3d11_swapchain_present(VriSwapchain swapchain, uint32_t image_index);
+VriResult d3d11_swapchain_present_image(VriSwapchain swapchain, uint32_t image_index);
+VriResult d3d11_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain);
+void      d3d11_swapchain_destroy(VriDevice device, VriSwapchain swapchain);
+VriResult d3d11_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index);
+VriResult d3d11_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence);
+VriResult d3d11_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture);
+VriResult d3d11_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats);
 
 #endif
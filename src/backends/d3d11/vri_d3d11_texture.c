@@ -1,24 +1,36 @@
 #include "vri_d3d11_texture.h"
 
+#include "vri_d3d11_command_buffer.h"
 #include "vri_d3d11_common.h"
 #include "vri_d3d11_device.h"
+#include "vri_d3d11_tile_heap.h"
 
-static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture);
-static VriBool   fill_texture_details_from_resource(VriTexture texture, ID3D11Resource *resource);
-static size_t    get_texture_size(void);
+static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Resource *resource);
+static HRESULT create_mips_view(ID3D11Device5 *d3d11_device, ID3D11Resource *resource, const VriTextureDesc *p_desc, ID3D11ShaderResourceView **pp_view);
+static size_t  get_texture_size(void);
 
 void d3d11_register_texture_functions(VriDeviceDispatchTable *table) {
     table->pfn_texture_create = d3d11_texture_create;
     table->pfn_texture_destroy = d3d11_texture_destroy;
+    table->pfn_texture_get_tiling = d3d11_texture_get_tiling;
+    table->pfn_texture_get_tile_feedback = d3d11_texture_get_tile_feedback;
+    table->pfn_texture_map = d3d11_texture_map;
+    table->pfn_texture_unmap = d3d11_texture_unmap;
 }
 
-static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
+void d3d11_register_texture_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
+    table->pfn_cmd_update_texture = d3d11_cmd_update_texture;
+    table->pfn_cmd_generate_mips = d3d11_cmd_generate_mips;
+    table->pfn_cmd_copy_texture = d3d11_cmd_copy_texture;
+}
+
+VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
     ID3D11Device5   *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
     VriDebugCallback dbg = device->debug_callback;
 
     D3D11_USAGE usage = D3D11_USAGE_DEFAULT;
     uint32_t    cpu_access_flags = 0;
-    switch (p_desc->usage) {
+    switch (p_desc->memory_type) {
         case VRI_MEMORY_TYPE_GPU_ONLY:
             break;
         case VRI_MEMORY_TYPE_UPLOAD:
@@ -29,6 +41,8 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
             usage = D3D11_USAGE_STAGING;
             cpu_access_flags = D3D11_CPU_ACCESS_READ;
             break;
+        default:
+            break;
     }
 
     uint32_t bind_flags = 0;
@@ -41,8 +55,41 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
     if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_DEPTH_STENCIL_ATTACHMENT)
         bind_flags |= D3D11_BIND_DEPTH_STENCIL;
 
+    // GenerateMips renders each mip from a view of the whole resource
+    uint32_t misc_flags = 0;
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS) {
+        bind_flags |= D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+        misc_flags |= D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    }
+
+    // Tiled resources are created without memory, their tiles get mapped into tile pools
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        if (!((VriD3D11Device *)device->p_backend_data)->tiled_resources) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Sparse textures need a device with tiled resource support");
+            return VRI_ERROR_UNSUPPORTED;
+        }
+        misc_flags |= D3D11_RESOURCE_MISC_TILED;
+    }
+
     DXGI_FORMAT format = vri_to_dxgi_format(p_desc->format)->typeless;
 
+    // D3D11 indexes subresources the same way the initial data is laid out, mip + layer * mip_count
+    D3D11_SUBRESOURCE_DATA *initial_data = NULL;
+    uint32_t                subresource_count = p_desc->mip_count * (p_desc->type == VRI_TEXTURE_TYPE_TEXTURE_3D ? 1 : p_desc->layer_count);
+    if (p_desc->p_initial_data) {
+        initial_data = device->allocation_callback.pfn_allocate(sizeof(*initial_data) * subresource_count, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+        if (!initial_data) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for the texture's initial data");
+            return VRI_ERROR_OUT_OF_MEMORY;
+        }
+
+        for (uint32_t i = 0; i < subresource_count; ++i) {
+            initial_data[i].pSysMem = p_desc->p_initial_data[i].p_data;
+            initial_data[i].SysMemPitch = p_desc->p_initial_data[i].row_pitch;
+            initial_data[i].SysMemSlicePitch = p_desc->p_initial_data[i].slice_pitch;
+        }
+    }
+
     HRESULT         hr = E_FAIL;
     ID3D11Resource *texture_res = NULL;
     switch (p_desc->type) {
@@ -54,9 +101,10 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
                 .ArraySize = p_desc->layer_count,
                 .Usage = usage,
                 .CPUAccessFlags = cpu_access_flags,
-                .BindFlags = bind_flags};
+                .BindFlags = bind_flags,
+                .MiscFlags = misc_flags};
 
-            hr = d3d11_device->lpVtbl->CreateTexture1D(d3d11_device, &desc, NULL, (ID3D11Texture1D **)&texture_res);
+            hr = d3d11_device->lpVtbl->CreateTexture1D(d3d11_device, &desc, initial_data, (ID3D11Texture1D **)&texture_res);
         } break;
 
         case VRI_TEXTURE_TYPE_TEXTURE_2D: {
@@ -69,9 +117,10 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
                 .SampleDesc.Count = p_desc->sample_count,
                 .Usage = usage,
                 .CPUAccessFlags = cpu_access_flags,
-                .BindFlags = bind_flags};
+                .BindFlags = bind_flags,
+                .MiscFlags = misc_flags};
 
-            hr = d3d11_device->lpVtbl->CreateTexture2D(d3d11_device, &desc, NULL, (ID3D11Texture2D **)&texture_res);
+            hr = d3d11_device->lpVtbl->CreateTexture2D(d3d11_device, &desc, initial_data, (ID3D11Texture2D **)&texture_res);
         } break;
 
         case VRI_TEXTURE_TYPE_TEXTURE_3D: {
@@ -83,14 +132,25 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
                 .MipLevels = p_desc->mip_count,
                 .Usage = usage,
                 .CPUAccessFlags = cpu_access_flags,
-                .BindFlags = bind_flags};
+                .BindFlags = bind_flags,
+                .MiscFlags = misc_flags};
 
-            hr = d3d11_device->lpVtbl->CreateTexture3D(d3d11_device, &desc, NULL, (ID3D11Texture3D **)&texture_res);
+            hr = d3d11_device->lpVtbl->CreateTexture3D(d3d11_device, &desc, initial_data, (ID3D11Texture3D **)&texture_res);
         } break;
 
         default:
             dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Invalid texture type provided.");
-            return VRI_ERROR_INVALID_API_USAGE;
+            hr = E_INVALIDARG;
+            break;
+    }
+
+    if (initial_data) {
+        device->allocation_callback.pfn_free(initial_data, sizeof(*initial_data) * subresource_count, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+    }
+
+    if (hr == E_INVALIDARG) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create D3D11 Texture resource. The description is invalid.");
+        return VRI_ERROR_INVALID_API_USAGE;
     }
 
     if (FAILED(hr)) {
@@ -98,28 +158,48 @@ static VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_
         return (hr == E_OUTOFMEMORY) ? VRI_ERROR_OUT_OF_MEMORY : VRI_ERROR_SYSTEM_FAILURE;
     }
 
+    // Only the tag knows which format of the typeless family this is, wrapping the resource reads it back
+    texture_res->lpVtbl->SetPrivateData(texture_res, &vri_d3d11_format_guid, sizeof(p_desc->format), &p_desc->format);
+
+    ID3D11ShaderResourceView *mips_view = NULL;
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS) {
+        hr = create_mips_view(d3d11_device, texture_res, p_desc, &mips_view);
+        if (FAILED(hr)) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create the D3D11 view for generating the texture's mips.");
+            texture_res->lpVtbl->Release(texture_res);
+            return (hr == E_OUTOFMEMORY) ? VRI_ERROR_OUT_OF_MEMORY : VRI_ERROR_SYSTEM_FAILURE;
+        }
+    }
+
     // Allocate the new texture struct
     size_t tex_size = get_texture_size();
-    *p_texture = vri_object_allocate(device, &device->allocation_callback, tex_size, VRI_OBJECT_TEXTURE);
+    *p_texture = vri_object_allocate(device, &device->allocation_callback, tex_size, VRI_OBJECT_TYPE_TEXTURE);
     if (!*p_texture) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Texture struct");
+        COM_SAFE_RELEASE(mips_view);
         texture_res->lpVtbl->Release(texture_res);
         return VRI_ERROR_OUT_OF_MEMORY;
     }
 
     // Fill out the newly allocated OUT texture struct
     VriTextureDesc *tex_desc = &(*p_texture)->desc;
+    tex_desc->type = p_desc->type;
+    tex_desc->usage = p_desc->usage;
+    tex_desc->sample_count = p_desc->sample_count;
     tex_desc->width = p_desc->width;
     tex_desc->height = p_desc->height;
     tex_desc->depth = p_desc->depth;
     tex_desc->format = p_desc->format;
     tex_desc->mip_count = p_desc->mip_count;
     tex_desc->layer_count = p_desc->layer_count;
+    tex_desc->memory_type = p_desc->memory_type;
 
     // Add the internal data, as well
     (*p_texture)->p_backend_data = *p_texture + 1;
     VriD3D11Texture *internal_tex = (*p_texture)->p_backend_data;
     internal_tex->p_resource = texture_res;
+    internal_tex->p_mips_view = mips_view;
+    internal_tex->p_tile_pool = NULL;
 
     return VRI_SUCCESS;
 }
@@ -129,7 +209,7 @@ VriResult d3d11_texture_create_from_resource(VriDevice device, ID3D11Resource **
 
     // Allocate the new texture struct
     size_t tex_size = get_texture_size();
-    *p_texture = vri_object_allocate(device, &device->allocation_callback, tex_size, VRI_OBJECT_TEXTURE);
+    *p_texture = vri_object_allocate(device, &device->allocation_callback, tex_size, VRI_OBJECT_TYPE_TEXTURE);
     if (!*p_texture) {
         dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Texture struct");
         return VRI_ERROR_OUT_OF_MEMORY;
@@ -141,12 +221,14 @@ VriResult d3d11_texture_create_from_resource(VriDevice device, ID3D11Resource **
 
     // Attempt to fill out the details of the texture from the resource
     if (!fill_texture_details_from_resource(*p_texture, *resource)) {
-        device->allocation_callback.pfn_free(*p_texture, tex_size, 8);
+        vri_object_free(device, &device->allocation_callback, *p_texture, tex_size);
         return VRI_ERROR_INVALID_API_USAGE;
     }
 
     // Store the resource and take ownership
     internal_tex->p_resource = *resource;
+    internal_tex->p_mips_view = NULL;
+    internal_tex->p_tile_pool = NULL;
     *resource = NULL;
 
     return VRI_SUCCESS;
@@ -157,21 +239,190 @@ void d3d11_texture_destroy(VriDevice device, VriTexture p_texture) {
         VriD3D11Texture *internal = p_texture->p_backend_data;
 
         if (internal) {
+            COM_SAFE_RELEASE(internal->p_mips_view);
+            COM_SAFE_RELEASE(internal->p_tile_pool);
             COM_SAFE_RELEASE(internal->p_resource);
         }
 
         size_t tex_size = get_texture_size();
-        device->allocation_callback.pfn_free(p_texture, tex_size, 8);
+        vri_object_free(device, &device->allocation_callback, p_texture, tex_size);
     }
 }
 
+void d3d11_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling) {
+    ID3D11Device5  *d3d11_device = ((VriD3D11Device *)device->p_backend_data)->p_device;
+    ID3D11Resource *resource = ((VriD3D11Texture *)texture->p_backend_data)->p_resource;
+
+    UINT                  tile_count = 0;
+    D3D11_PACKED_MIP_DESC packed = {0};
+    D3D11_TILE_SHAPE      shape = {0};
+    UINT                  subresource_count = 0;
+    d3d11_device->lpVtbl->GetResourceTiling(d3d11_device, resource, &tile_count, &packed, &shape, &subresource_count, 0, NULL);
+
+    p_tiling->tile_width = shape.WidthInTexels;
+    p_tiling->tile_height = shape.HeightInTexels;
+    p_tiling->standard_mip_count = packed.NumStandardMips;
+    p_tiling->packed_tile_count = packed.NumTilesForPackedMips;
+    p_tiling->tile_count = tile_count;
+}
+
+VriResult d3d11_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed) {
+    // D3D11 has no sampler feedback, residency has to be tracked by the application
+    (void)device;
+    (void)texture;
+    (void)tile_count;
+    (void)p_accessed;
+    return VRI_ERROR_UNSUPPORTED;
+}
+
+void d3d11_texture_bind_tiles(ID3D11DeviceContext4 *context, const VriSparseBindDesc *p_bind) {
+    VriD3D11Texture *internal = p_bind->texture->p_backend_data;
+
+    // A tiled resource maps to one pool at a time, switching pools drops every earlier mapping
+    ID3D11Buffer *tile_pool = p_bind->heap ? ((VriD3D11TileHeap *)p_bind->heap->p_backend_data)->p_tile_pool : internal->p_tile_pool;
+    if (!tile_pool) return;
+    if (tile_pool != internal->p_tile_pool) {
+        COM_SAFE_RELEASE(internal->p_tile_pool);
+        tile_pool->lpVtbl->AddRef(tile_pool);
+        internal->p_tile_pool = tile_pool;
+    }
+
+    VriTextureTiling tiling = {0};
+    d3d11_texture_get_tiling(p_bind->texture->base.p_device, p_bind->texture, &tiling);
+
+    // The packed mips are addressed as a run of tiles from the first packed mip
+    D3D11_TILED_RESOURCE_COORDINATE coordinate = {.X = p_bind->x, .Y = p_bind->y, .Subresource = p_bind->mip_level};
+    D3D11_TILE_REGION_SIZE          region = {.NumTiles = p_bind->width * p_bind->height};
+    if (p_bind->mip_level < tiling.standard_mip_count) {
+        region.bUseBox = TRUE;
+        region.Width = p_bind->width;
+        region.Height = (UINT16)p_bind->height;
+        region.Depth = 1;
+    }
+
+    UINT range_flags = p_bind->heap ? 0 : D3D11_TILE_RANGE_NULL;
+    UINT start_offset = p_bind->heap_offset;
+    UINT range_tile_count = region.NumTiles;
+    context->lpVtbl->UpdateTileMappings(context, internal->p_resource, 1, &coordinate, &region, tile_pool, 1, &range_flags, &start_offset, &range_tile_count, 0);
+}
+
+void d3d11_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    ID3D11DeviceContext4 *deferred_context = ((VriD3D11CommandBuffer *)command_buffer->p_backend_data)->p_deferred_context;
+    VriD3D11Device       *d3d11_device = command_buffer->base.p_device->p_backend_data;
+    ID3D11Resource       *resource = ((VriD3D11Texture *)texture->p_backend_data)->p_resource;
+
+    const VriTextureDesc *desc = &texture->desc;
+    uint32_t              subresource = p_desc->mip_level + p_desc->array_layer * desc->mip_count;
+
+    D3D11_BOX box = {
+        .left = p_desc->x,
+        .top = p_desc->y,
+        .front = p_desc->z,
+        .right = p_desc->x + p_desc->width,
+        .bottom = p_desc->y + p_desc->height,
+        .back = p_desc->z + p_desc->depth,
+    };
+
+    // When the runtime emulates command lists it applies the box offset to the
+    // source pointer as well, so move the pointer back by that much beforehand
+    const uint8_t *src = p_desc->data.p_data;
+    if (!d3d11_device->driver_command_lists) {
+        const VriFormatInfo *info = VRI_FORMAT_INFO(desc->format);
+        src -= (size_t)box.front * p_desc->data.slice_pitch +
+               (size_t)(box.top / info->block_height) * p_desc->data.row_pitch +
+               (size_t)(box.left / info->block_width) * info->block_size;
+    }
+
+    deferred_context->lpVtbl->UpdateSubresource(deferred_context, resource, subresource, &box, src, p_desc->data.row_pitch, p_desc->data.slice_pitch);
+}
+
+VriResult d3d11_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    ID3D11DeviceContext4 *context = ((VriD3D11Device *)device->p_backend_data)->p_immediate_context;
+    ID3D11Resource       *resource = ((VriD3D11Texture *)texture->p_backend_data)->p_resource;
+    uint32_t              subresource = mip_level + array_layer * texture->desc.mip_count;
+
+    // Never blocks, a copy that's still going is reported instead
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    HRESULT                  hr = context->lpVtbl->Map(context, resource, subresource, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING) {
+        return VRI_TIMEOUT;
+    }
+    if (FAILED(hr)) {
+        return (hr == DXGI_ERROR_DEVICE_REMOVED) ? VRI_ERROR_DEVICE_REMOVED : VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    p_data->p_data = mapped.pData;
+    p_data->row_pitch = mapped.RowPitch;
+    p_data->slice_pitch = mapped.DepthPitch;
+    return VRI_SUCCESS;
+}
+
+void d3d11_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer) {
+    ID3D11DeviceContext4 *context = ((VriD3D11Device *)device->p_backend_data)->p_immediate_context;
+    ID3D11Resource       *resource = ((VriD3D11Texture *)texture->p_backend_data)->p_resource;
+
+    context->lpVtbl->Unmap(context, resource, mip_level + array_layer * texture->desc.mip_count);
+}
+
+void d3d11_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    ID3D11DeviceContext4 *deferred_context = ((VriD3D11CommandBuffer *)command_buffer->p_backend_data)->p_deferred_context;
+    ID3D11Resource       *src_resource = ((VriD3D11Texture *)src->p_backend_data)->p_resource;
+    ID3D11Resource       *dst_resource = ((VriD3D11Texture *)dst->p_backend_data)->p_resource;
+
+    D3D11_BOX box = {
+        .left = p_desc->src.x,
+        .top = p_desc->src.y,
+        .front = p_desc->src.z,
+        .right = p_desc->src.x + p_desc->width,
+        .bottom = p_desc->src.y + p_desc->height,
+        .back = p_desc->src.z + p_desc->depth,
+    };
+
+    deferred_context->lpVtbl->CopySubresourceRegion(deferred_context, dst_resource, p_desc->dst.mip_level + p_desc->dst.array_layer * dst->desc.mip_count,
+                                                    p_desc->dst.x, p_desc->dst.y, p_desc->dst.z, src_resource,
+                                                    p_desc->src.mip_level + p_desc->src.array_layer * src->desc.mip_count, &box);
+}
+
+void d3d11_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    ID3D11DeviceContext4     *deferred_context = ((VriD3D11CommandBuffer *)command_buffer->p_backend_data)->p_deferred_context;
+    ID3D11ShaderResourceView *view = ((VriD3D11Texture *)texture->p_backend_data)->p_mips_view;
+
+    deferred_context->lpVtbl->GenerateMips(deferred_context, view);
+}
+
+static HRESULT create_mips_view(ID3D11Device5 *d3d11_device, ID3D11Resource *resource, const VriTextureDesc *p_desc, ID3D11ShaderResourceView **pp_view) {
+    // The resource is typeless, so the view has to name the typed format and cover every mip and layer
+    D3D11_SHADER_RESOURCE_VIEW_DESC desc = {.Format = vri_to_dxgi_format(p_desc->format)->typed};
+    switch (p_desc->type) {
+        case VRI_TEXTURE_TYPE_TEXTURE_1D:
+            desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1DARRAY;
+            desc.Texture1DArray.MipLevels = p_desc->mip_count;
+            desc.Texture1DArray.ArraySize = p_desc->layer_count;
+            break;
+        case VRI_TEXTURE_TYPE_TEXTURE_2D:
+            desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+            desc.Texture2DArray.MipLevels = p_desc->mip_count;
+            desc.Texture2DArray.ArraySize = p_desc->layer_count;
+            break;
+        case VRI_TEXTURE_TYPE_TEXTURE_3D:
+            desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+            desc.Texture3D.MipLevels = p_desc->mip_count;
+            break;
+        default:
+            return E_INVALIDARG;
+    }
+
+    return d3d11_device->lpVtbl->CreateShaderResourceView(d3d11_device, resource, &desc, pp_view);
+}
+
 static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Resource *resource) {
     VriTextureDesc *texture_desc = &texture->desc;
 
     D3D11_RESOURCE_DIMENSION type = {0};
     resource->lpVtbl->GetType(resource, &type);
 
-    uint32_t bind_flags = 0;
+    uint32_t    bind_flags = 0;
+    DXGI_FORMAT dxgi_format = DXGI_FORMAT_UNKNOWN;
     if (type == D3D11_RESOURCE_DIMENSION_TEXTURE1D) {
         ID3D11Texture1D     *t = (ID3D11Texture1D *)resource;
         D3D11_TEXTURE1D_DESC desc = {0};
@@ -180,7 +431,7 @@ static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Reso
         bind_flags = desc.BindFlags;
 
         texture_desc->type = VRI_TEXTURE_TYPE_TEXTURE_1D;
-        texture_desc->format = *vri_dxgi_format_to_vri(desc.Format);
+        dxgi_format = desc.Format;
         texture_desc->width = desc.Width;
         texture_desc->height = 1;
         texture_desc->depth = 1;
@@ -195,7 +446,7 @@ static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Reso
         bind_flags = desc.BindFlags;
 
         texture_desc->type = VRI_TEXTURE_TYPE_TEXTURE_2D;
-        texture_desc->format = *vri_dxgi_format_to_vri(desc.Format);
+        dxgi_format = desc.Format;
         texture_desc->width = desc.Width;
         texture_desc->height = desc.Height;
         texture_desc->depth = 1;
@@ -210,7 +461,7 @@ static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Reso
         bind_flags = desc.BindFlags;
 
         texture_desc->type = VRI_TEXTURE_TYPE_TEXTURE_3D;
-        texture_desc->format = *vri_dxgi_format_to_vri(desc.Format);
+        dxgi_format = desc.Format;
         texture_desc->width = desc.Width;
         texture_desc->height = desc.Height;
         texture_desc->depth = desc.Depth;
@@ -231,6 +482,17 @@ static VriBool fill_texture_details_from_resource(VriTexture texture, ID3D11Reso
     if (bind_flags & D3D11_BIND_DEPTH_STENCIL)
         texture_desc->usage |= VRI_TEXTURE_USAGE_BIT_DEPTH_STENCIL_ATTACHMENT;
 
+    // Resources VRI created are typeless and tagged with their format. Anything
+    // else has to be typed, a typeless family doesn't say which member it holds.
+    UINT format_size = sizeof(texture_desc->format);
+    if (FAILED(resource->lpVtbl->GetPrivateData(resource, &vri_d3d11_format_guid, &format_size, &texture_desc->format)) || format_size != sizeof(texture_desc->format)) {
+        texture_desc->format = *vri_dxgi_format_to_vri(dxgi_format);
+    }
+    if (texture_desc->format == VRI_FORMAT_UNDEFINED) {
+        texture->base.p_device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Can't wrap a D3D11 texture with a typeless or unsupported format VRI didn't create it with");
+        return false;
+    }
+
     return true;
 }
 
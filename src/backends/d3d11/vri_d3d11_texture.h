@@ -4,11 +4,23 @@
 #include "vri_d3d11_common.h"
 
 typedef struct {
-    ID3D11Resource *p_resource;
+    ID3D11Resource           *p_resource;
+    ID3D11ShaderResourceView *p_mips_view; // Whole-resource view for GenerateMips, only with VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS
+    ID3D11Buffer             *p_tile_pool; // Referenced pool the tiles map to, only with VRI_TEXTURE_USAGE_BIT_SPARSE
 } VriD3D11Texture;
 
 void      d3d11_register_texture_functions(VriDeviceDispatchTable *table);
+void      d3d11_register_texture_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
 void      d3d11_texture_destroy(VriDevice device, VriTexture p_texture);
 VriResult d3d11_texture_create_from_resource(VriDevice device, ID3D11Resource **resource, VriTexture *p_texture);
+VriResult d3d11_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture);
+void      d3d11_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling);
+VriResult d3d11_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed);
+void      d3d11_texture_bind_tiles(ID3D11DeviceContext4 *context, const VriSparseBindDesc *p_bind);
+void      d3d11_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc);
+void      d3d11_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture);
+void      d3d11_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc);
+VriResult d3d11_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data);
+void      d3d11_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer);
 
 #endif
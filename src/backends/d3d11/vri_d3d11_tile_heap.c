@@ -0,0 +1,57 @@
+#include "vri_d3d11_tile_heap.h"
+
+#include "vri_d3d11_device.h"
+
+#define TILE_HEAP_OBJECT_SIZE (sizeof(struct VriTileHeap_T) + sizeof(VriD3D11TileHeap))
+
+void d3d11_register_tile_heap_functions(VriDeviceDispatchTable *table) {
+    table->pfn_tile_heap_create = d3d11_tile_heap_create;
+    table->pfn_tile_heap_destroy = d3d11_tile_heap_destroy;
+}
+
+VriResult d3d11_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    VriD3D11Device  *d3d11_device = device->p_backend_data;
+    VriDebugCallback dbg = device->debug_callback;
+
+    if (!d3d11_device->tiled_resources) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Tile heaps need a device with tiled resource support");
+        return VRI_ERROR_UNSUPPORTED;
+    }
+
+    // A D3D11 tile pool is a buffer whose memory is handed out in 64KB tiles
+    D3D11_BUFFER_DESC desc = {
+        .ByteWidth = p_desc->tile_count * VRI_TILE_SIZE,
+        .Usage = D3D11_USAGE_DEFAULT,
+        .MiscFlags = D3D11_RESOURCE_MISC_TILE_POOL,
+    };
+
+    ID3D11Buffer *tile_pool = NULL;
+    HRESULT       hr = d3d11_device->p_device->lpVtbl->CreateBuffer(d3d11_device->p_device, &desc, NULL, &tile_pool);
+    if (FAILED(hr)) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create D3D11 tile pool");
+        return (hr == E_OUTOFMEMORY) ? VRI_ERROR_OUT_OF_MEMORY : VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    *p_tile_heap = vri_object_allocate(device, &device->allocation_callback, TILE_HEAP_OBJECT_SIZE, VRI_OBJECT_TYPE_TILE_HEAP);
+    if (!*p_tile_heap) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Tile Heap struct");
+        COM_RELEASE(tile_pool);
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_tile_heap)->tile_count = p_desc->tile_count;
+    (*p_tile_heap)->p_backend_data = *p_tile_heap + 1;
+    ((VriD3D11TileHeap *)(*p_tile_heap)->p_backend_data)->p_tile_pool = tile_pool;
+
+    return VRI_SUCCESS;
+}
+
+void d3d11_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    if (tile_heap) {
+        // Textures mapped to the pool hold their own reference until they move off it
+        VriD3D11TileHeap *internal = tile_heap->p_backend_data;
+        COM_SAFE_RELEASE(internal->p_tile_pool);
+
+        vri_object_free(device, &device->allocation_callback, tile_heap, TILE_HEAP_OBJECT_SIZE);
+    }
+}
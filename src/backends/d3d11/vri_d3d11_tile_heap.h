@@ -0,0 +1,14 @@
+#ifndef VRI_D3D11_TILE_HEAP_H
+#define VRI_D3D11_TILE_HEAP_H
+
+#include "vri_d3d11_common.h"
+
+typedef struct {
+    ID3D11Buffer *p_tile_pool;
+} VriD3D11TileHeap;
+
+void      d3d11_register_tile_heap_functions(VriDeviceDispatchTable *table);
+VriResult d3d11_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap);
+void      d3d11_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap);
+
+#endif
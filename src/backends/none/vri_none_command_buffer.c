@@ -0,0 +1,148 @@
+#include "vri_none_command_buffer.h"
+
+#include "vri_none_pipeline.h"
+#include "vri_none_texture.h"
+
+#include <string.h>
+
+#define COMMAND_BUFFER_OBJECT_SIZE (sizeof(struct VriCommandBuffer_T) + sizeof(VriNoneCommandBuffer))
+
+static void release_copies(VriCommandBuffer command_buffer);
+
+void none_register_command_buffer_functions(VriDeviceDispatchTable *table) {
+    table->pfn_command_buffers_allocate = none_command_buffers_allocate;
+    table->pfn_command_buffers_free = none_command_buffers_free;
+}
+
+void none_register_command_buffer_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
+    table->pfn_command_buffer_begin = none_command_buffer_begin;
+    table->pfn_command_buffer_end = none_command_buffer_end;
+    table->pfn_command_buffer_reset = none_command_buffer_reset;
+    table->pfn_cmd_set_viewport = none_cmd_set_viewport;
+    table->pfn_cmd_set_scissor = none_cmd_set_scissor;
+    table->pfn_cmd_set_stencil_reference = none_cmd_set_stencil_reference;
+    table->pfn_cmd_set_blend_constants = none_cmd_set_blend_constants;
+    table->pfn_cmd_set_depth_bias = none_cmd_set_depth_bias;
+}
+
+VriResult none_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
+    for (uint32_t i = 0; i < p_desc->command_buffer_count; ++i) {
+        VriCommandBuffer cmd = vri_object_allocate(device, &device->allocation_callback, COMMAND_BUFFER_OBJECT_SIZE, VRI_OBJECT_TYPE_COMMAND_BUFFER);
+        if (!cmd) {
+            none_command_buffers_free(device, p_desc->command_pool, i, p_command_buffers);
+            return VRI_ERROR_OUT_OF_MEMORY;
+        }
+        cmd->p_backend_data = (VriNoneCommandBuffer *)(cmd + 1);
+
+        // Layers may have wrapped the device's table, so always copy it from there
+        cmd->dispatch = device->command_buffer_dispatch;
+
+        p_command_buffers[i] = cmd;
+    }
+
+    return VRI_SUCCESS;
+}
+
+void none_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
+    (void)command_pool;
+    for (uint32_t i = 0; i < command_buffer_count; i++) {
+        release_copies(p_command_buffers[i]);
+        vri_object_free(device, &device->allocation_callback, p_command_buffers[i], COMMAND_BUFFER_OBJECT_SIZE);
+    }
+}
+
+VriResult none_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
+    (void)p_desc;
+
+    // Dynamic state doesn't carry over from the last recording
+    release_copies(command_buffer);
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    memset(none_command_buffer, 0, sizeof(*none_command_buffer));
+    command_buffer->pipeline = NULL;
+
+    return VRI_SUCCESS;
+}
+
+VriResult none_command_buffer_end(VriCommandBuffer command_buffer) {
+    (void)command_buffer;
+    return VRI_SUCCESS;
+}
+
+VriResult none_command_buffer_reset(VriCommandBuffer command_buffer) {
+    ((VriNoneCommandBuffer *)command_buffer->p_backend_data)->command_count = 0;
+    release_copies(command_buffer);
+
+    return VRI_SUCCESS;
+}
+
+void none_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    memcpy(&none_command_buffer->viewports[first_viewport], p_viewports, sizeof(VriViewport) * viewport_count);
+}
+
+void none_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    memcpy(&none_command_buffer->scissors[first_scissor], p_scissors, sizeof(VriRect2D) * scissor_count);
+}
+
+void none_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    ((VriNoneCommandBuffer *)command_buffer->p_backend_data)->stencil_reference = reference;
+}
+
+void none_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    memcpy(none_command_buffer->blend_constants, blend_constants, sizeof(none_command_buffer->blend_constants));
+}
+
+void none_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    none_command_buffer->depth_bias_constant_factor = constant_factor;
+    none_command_buffer->depth_bias_clamp = clamp;
+    none_command_buffer->depth_bias_slope_factor = slope_factor;
+}
+
+void none_command_buffer_record_copy(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    VriDevice             device = command_buffer->base.p_device;
+
+    if (none_command_buffer->copy_count == none_command_buffer->copy_capacity) {
+        uint32_t     capacity = VRI_MAX(none_command_buffer->copy_capacity * 2, 8u);
+        VriNoneCopy *p_copies = device->allocation_callback.pfn_allocate(capacity * sizeof(VriNoneCopy), sizeof(void *), VRI_ALLOCATION_SCOPE_COMMAND);
+        if (!p_copies) {
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory to record a texture copy, it was dropped");
+            return;
+        }
+        if (none_command_buffer->copy_count) {
+            memcpy(p_copies, none_command_buffer->p_copies, none_command_buffer->copy_count * sizeof(VriNoneCopy));
+        }
+        uint32_t copy_count = none_command_buffer->copy_count;
+        release_copies(command_buffer);
+        none_command_buffer->p_copies = p_copies;
+        none_command_buffer->copy_count = copy_count;
+        none_command_buffer->copy_capacity = capacity;
+    }
+
+    VriNoneCopy *copy = &none_command_buffer->p_copies[none_command_buffer->copy_count++];
+    copy->src = src;
+    copy->dst = dst;
+    copy->desc = *p_desc;
+}
+
+void none_command_buffer_execute(VriCommandBuffer command_buffer) {
+    const VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    for (uint32_t i = 0; i < none_command_buffer->copy_count; ++i) {
+        const VriNoneCopy *copy = &none_command_buffer->p_copies[i];
+        none_texture_copy(copy->src, copy->dst, &copy->desc);
+    }
+}
+
+static void release_copies(VriCommandBuffer command_buffer) {
+    VriNoneCommandBuffer *none_command_buffer = command_buffer->p_backend_data;
+    if (none_command_buffer->p_copies) {
+        command_buffer->base.p_device->allocation_callback.pfn_free(none_command_buffer->p_copies, none_command_buffer->copy_capacity * sizeof(VriNoneCopy), sizeof(void *),
+                                                                    VRI_ALLOCATION_SCOPE_COMMAND);
+    }
+    none_command_buffer->p_copies = NULL;
+    none_command_buffer->copy_count = 0;
+    none_command_buffer->copy_capacity = 0;
+}
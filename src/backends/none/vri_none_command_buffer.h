@@ -0,0 +1,41 @@
+#ifndef VRI_NONE_COMMAND_BUFFER_H
+#define VRI_NONE_COMMAND_BUFFER_H
+
+#include "vri_none_common.h"
+
+typedef struct {
+    VriTexture         src;
+    VriTexture         dst;
+    VriTextureCopyDesc desc;
+} VriNoneCopy;
+
+typedef struct {
+    uint64_t     command_count;
+    VriNoneCopy *p_copies; // Carried out by the submit, in recording order
+    uint32_t     copy_count;
+    uint32_t     copy_capacity;
+    VriViewport  viewports[VRI_MAX_VIEWPORTS];
+    VriRect2D    scissors[VRI_MAX_VIEWPORTS];
+    uint32_t     stencil_reference;
+    float        blend_constants[4];
+    float        depth_bias_constant_factor;
+    float        depth_bias_clamp;
+    float        depth_bias_slope_factor;
+} VriNoneCommandBuffer;
+
+void      none_register_command_buffer_functions(VriDeviceDispatchTable *table);
+void      none_register_command_buffer_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+VriResult none_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers);
+void      none_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers);
+VriResult none_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc);
+VriResult none_command_buffer_end(VriCommandBuffer command_buffer);
+VriResult none_command_buffer_reset(VriCommandBuffer command_buffer);
+void      none_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports);
+void      none_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors);
+void      none_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference);
+void      none_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]);
+void      none_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor);
+void      none_command_buffer_record_copy(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc);
+void      none_command_buffer_execute(VriCommandBuffer command_buffer);
+
+#endif
@@ -0,0 +1,35 @@
+#include "vri_none_command_pool.h"
+
+void none_register_command_pool_functions(VriDeviceDispatchTable *table) {
+    table->pfn_command_pool_create = none_command_pool_create;
+    table->pfn_command_pool_destroy = none_command_pool_destroy;
+    table->pfn_command_pool_reset = none_command_pool_reset;
+}
+
+VriResult none_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool) {
+    (void)p_desc;
+    VriDebugCallback dbg = device->debug_callback;
+
+    size_t alloc_size = sizeof(struct VriCommandPool_T);
+    *p_command_pool = vri_object_allocate(device, &device->allocation_callback, alloc_size, VRI_OBJECT_TYPE_COMMAND_POOL);
+    if (!*p_command_pool) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate command pool");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    return VRI_SUCCESS;
+}
+
+void none_command_pool_destroy(VriDevice device, VriCommandPool command_pool) {
+    if (command_pool) {
+        size_t alloc_size = sizeof(struct VriCommandPool_T);
+        vri_object_free(device, &device->allocation_callback, command_pool, alloc_size);
+    }
+}
+
+void none_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags) {
+    // NOP
+    (void)device;
+    (void)command_pool;
+    (void)flags;
+}
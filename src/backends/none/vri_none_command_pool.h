@@ -0,0 +1,11 @@
+#ifndef VRI_NONE_COMMAND_POOL_H
+#define VRI_NONE_COMMAND_POOL_H
+
+#include "vri_none_common.h"
+
+void      none_register_command_pool_functions(VriDeviceDispatchTable *table);
+VriResult none_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool);
+void      none_command_pool_destroy(VriDevice device, VriCommandPool command_pool);
+void      none_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef VRI_BACKEND_NONE_COMMON_H
+#define VRI_BACKEND_NONE_COMMON_H
+
+// none_common.h
+// Internal helpers for the headless (none) backend.
+// Nothing is ever sent to a GPU: submissions retire immediately and fences are
+// plain CPU timelines, which makes this backend usable on machines without a display.
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../../core/vri_internal.h"
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <sched.h>
+#endif
+
+static inline void none_yield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+#endif
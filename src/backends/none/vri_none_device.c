@@ -0,0 +1,112 @@
+#include "vri_none_common.h"
+
+#include "vri_none_command_buffer.h"
+#include "vri_none_command_pool.h"
+#include "vri_none_device.h"
+#include "vri_none_fence.h"
+#include "vri_none_pipeline.h"
+#include "vri_none_queue.h"
+#include "vri_none_swapchain.h"
+#include "vri_none_texture.h"
+#include "vri_none_tile_heap.h"
+
+#define DEVICE_STRUCT_SIZE (sizeof(struct VriDevice_T) + sizeof(VriNoneDevice))
+
+// The headless adapter reports no memory, budgets are those of a mid-range GPU
+#define DEVICE_LOCAL_BUDGET (8ull * 1024 * 1024 * 1024)
+#define SYSTEM_BUDGET       (16ull * 1024 * 1024 * 1024)
+
+static void none_register_device_functions(VriDeviceDispatchTable *table);
+
+VriResult none_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device) {
+    // Convinience assignment for the debug messages
+    VriDebugCallback dbg = p_desc->debug_callback;
+
+    // Attempt to allocate the full internal struct
+    *p_device = vri_object_allocate(NULL, &p_desc->allocation_callback, DEVICE_STRUCT_SIZE, VRI_OBJECT_TYPE_DEVICE);
+    if (!*p_device) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for device struct failed.");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    // Backend data is after the main data
+    VriNoneDevice *internal_state = (VriNoneDevice *)((*p_device) + 1);
+    (*p_device)->p_backend_data = internal_state;
+
+    // Fill up the dispatch table
+    none_register_device_functions(&(*p_device)->dispatch);
+    none_register_command_pool_functions(&(*p_device)->dispatch);
+    none_register_command_buffer_functions(&(*p_device)->dispatch);
+    none_register_texture_functions(&(*p_device)->dispatch);
+    none_register_tile_heap_functions(&(*p_device)->dispatch);
+    none_register_fence_functions(&(*p_device)->dispatch);
+    none_register_swapchain_functions(&(*p_device)->dispatch);
+    none_register_pipeline_functions_with_device(&(*p_device)->dispatch);
+    none_register_command_buffer_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    none_register_pipeline_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    none_register_texture_functions_with_command_buffer(&(*p_device)->command_buffer_dispatch);
+    none_register_queue_functions(&(*p_device)->queue_dispatch);
+
+    // Create queues
+    for (uint32_t i = 0; i < p_desc->queue_desc_count; ++i) {
+        const VriQueueDesc *qdesc = &p_desc->p_queue_descs[i];
+        VriQueueType        type = qdesc->type;
+
+        uint32_t qcount = VRI_MIN(qdesc->count, MAX_QUEUES_PER_TYPE);
+        for (uint32_t j = 0; j < qcount; ++j) {
+            VriQueue queue = NULL;
+            if (VRI_ERROR(none_queue_create(*p_device, &p_desc->allocation_callback, &queue))) {
+                dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create requested queue");
+                return VRI_ERROR_SYSTEM_FAILURE;
+            }
+
+            queue->type = type;
+            (*p_device)->queues[type][j] = queue;
+        }
+        (*p_device)->queue_counts[type] = qcount;
+    }
+
+    // Fill out the known fields
+    (*p_device)->backend = VRI_BACKEND_NONE;
+
+    return VRI_SUCCESS;
+}
+
+void none_device_destroy(VriDevice device) {
+    if (device) {
+        for (uint32_t i = 0; i < VRI_QUEUE_TYPE_COUNT; ++i) {
+            uint32_t type_count = device->queue_counts[i];
+            for (uint32_t j = 0; j < type_count; ++j) {
+                none_queue_destroy(device, device->queues[i][j]);
+            }
+        }
+
+        // Objects the application never destroyed go with their pools
+        vri_shader_modules_destroy(device);
+        vri_object_pools_destroy(device);
+
+        // Free the ENTIRE allocated block (device + internal_state)
+        vri_object_free(device, &device->allocation_callback, device, DEVICE_STRUCT_SIZE);
+    }
+}
+
+VriResult none_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget) {
+    VriNoneDevice *internal_state = device->p_backend_data;
+
+    p_budget->heaps[VRI_MEMORY_HEAP_DEVICE_LOCAL].budget = device->adapter_props.vram ? device->adapter_props.vram : DEVICE_LOCAL_BUDGET;
+    p_budget->heaps[VRI_MEMORY_HEAP_SYSTEM].budget = device->adapter_props.shared_system_memory ? device->adapter_props.shared_system_memory : SYSTEM_BUDGET;
+    for (uint32_t i = 0; i < VRI_MEMORY_HEAP_COUNT; ++i) {
+        p_budget->heaps[i].usage = __atomic_load_n(&internal_state->memory_usage[i], __ATOMIC_RELAXED);
+    }
+    return VRI_SUCCESS;
+}
+
+void none_device_track_memory(VriDevice device, VriMemoryHeap heap, int64_t size) {
+    VriNoneDevice *internal_state = device->p_backend_data;
+    __atomic_fetch_add(&internal_state->memory_usage[heap], (uint64_t)size, __ATOMIC_RELAXED);
+}
+
+static void none_register_device_functions(VriDeviceDispatchTable *table) {
+    table->pfn_device_destroy = none_device_destroy;
+    table->pfn_device_query_memory_budget = none_device_query_memory_budget;
+}
@@ -0,0 +1,16 @@
+#ifndef VRI_NONE_DEVICE_H
+#define VRI_NONE_DEVICE_H
+
+#include "vri_none_common.h"
+
+typedef struct {
+    uint64_t submit_count;
+    uint64_t memory_usage[VRI_MEMORY_HEAP_COUNT]; // What the textures and tile heaps would take on a GPU
+} VriNoneDevice;
+
+VriResult none_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device);
+void      none_device_destroy(VriDevice device);
+VriResult none_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget);
+void      none_device_track_memory(VriDevice device, VriMemoryHeap heap, int64_t size);
+
+#endif
@@ -0,0 +1,97 @@
+#include "vri_none_fence.h"
+
+#define FENCE_OBJECT_SIZE (sizeof(struct VriFence_T) + sizeof(VriNoneFence))
+
+// Number of polls before a waiting thread starts yielding its time slice
+#define FENCE_SPIN_COUNT 64
+
+static VriBool fences_reached(const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all);
+
+void none_register_fence_functions(VriDeviceDispatchTable *table) {
+    table->pfn_fence_create = none_fence_create;
+    table->pfn_fence_destroy = none_fence_destroy;
+    table->pfn_fence_get_value = none_fence_get_value;
+    table->pfn_fences_wait = none_fences_wait;
+}
+
+VriResult none_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    // Allocate fence
+    *p_fence = vri_object_allocate(device, &device->allocation_callback, FENCE_OBJECT_SIZE, VRI_OBJECT_TYPE_FENCE);
+    if (!*p_fence) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate fence");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_fence)->p_backend_data = (VriNoneFence *)(*p_fence + 1);
+
+    VriNoneFence *none_fence = (*p_fence)->p_backend_data;
+    __atomic_store_n(&none_fence->value, initial_value, __ATOMIC_RELEASE);
+
+    return VRI_SUCCESS;
+}
+
+void none_fence_destroy(VriDevice device, VriFence fence) {
+    if (fence) {
+        vri_object_free(device, &device->allocation_callback, fence, FENCE_OBJECT_SIZE);
+    }
+}
+
+uint64_t none_fence_get_value(VriDevice device, VriFence fence) {
+    (void)device;
+    VriNoneFence *f = fence->p_backend_data;
+    return __atomic_load_n(&f->value, __ATOMIC_ACQUIRE);
+}
+
+VriResult none_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
+    if (fence_count == 0 || fences_reached(p_fences, p_values, fence_count, wait_all)) {
+        return VRI_SUCCESS;
+    }
+
+    if (timeout_ns == 0) {
+        return VRI_TIMEOUT;
+    }
+
+    // Only another thread signaling can complete the wait from here on
+    uint64_t wait_start = vri_time_ns();
+    uint64_t deadline = (timeout_ns == UINT64_MAX) ? UINT64_MAX : wait_start + timeout_ns;
+    uint32_t spin = 0;
+
+    VriResult res = VRI_SUCCESS;
+    while (!fences_reached(p_fences, p_values, fence_count, wait_all)) {
+        if (spin < FENCE_SPIN_COUNT) {
+            spin++;
+            continue;
+        }
+
+        if (vri_time_ns() >= deadline) {
+            res = VRI_TIMEOUT;
+            break;
+        }
+        none_yield();
+    }
+
+    VRI_STAT_ADD(device, fence_waits_blocked, 1);
+    VRI_STAT_ADD(device, fence_wait_time_ns, vri_time_ns() - wait_start);
+
+    return res;
+}
+
+VriResult none_fence_signal(VriFence fence, uint64_t value) {
+    VriNoneFence *none_fence = fence->p_backend_data;
+    __atomic_store_n(&none_fence->value, value, __ATOMIC_RELEASE);
+    return VRI_SUCCESS;
+}
+
+static VriBool fences_reached(const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all) {
+    for (uint32_t i = 0; i < fence_count; ++i) {
+        VriNoneFence *fence = p_fences[i]->p_backend_data;
+        VriBool       reached = __atomic_load_n(&fence->value, __ATOMIC_ACQUIRE) >= p_values[i];
+
+        if (reached && !wait_all) return true;
+        if (!reached && wait_all) return false;
+    }
+
+    return wait_all;
+}
@@ -0,0 +1,17 @@
+#ifndef VRI_NONE_FENCE_H
+#define VRI_NONE_FENCE_H
+
+#include "vri_none_common.h"
+
+typedef struct {
+    uint64_t value;
+} VriNoneFence;
+
+void      none_register_fence_functions(VriDeviceDispatchTable *table);
+VriResult none_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns);
+VriResult none_fence_signal(VriFence fence, uint64_t value);
+VriResult none_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence);
+void      none_fence_destroy(VriDevice device, VriFence fence);
+uint64_t  none_fence_get_value(VriDevice device, VriFence fence);
+
+#endif
@@ -0,0 +1,205 @@
+#include "vri_none_pipeline.h"
+
+#define PIPELINE_OBJECT_SIZE         (sizeof(struct VriPipeline_T) + sizeof(VriNonePipeline))
+#define PIPELINE_LIBRARY_OBJECT_SIZE (sizeof(struct VriPipelineLibrary_T) + sizeof(VriNonePipeline))
+
+static VriResult parts_create(VriDevice device, VriNonePipeline *none_pipeline, VriPipelineLibraryFlags parts, const VriGraphicsPipelineDesc *p_desc);
+static void      parts_release(VriDevice device, VriNonePipeline *none_pipeline);
+static void      merge_part(VriNonePipeline *none_pipeline, uint32_t index, VriNonePipelinePart *part);
+
+void none_register_pipeline_functions_with_device(VriDeviceDispatchTable *table) {
+    table->pfn_shader_module_create = none_shader_module_create;
+    table->pfn_shader_module_destroy = none_shader_module_destroy;
+    table->pfn_pipeline_layout_create = none_pipeline_layout_create;
+    table->pfn_pipeline_create_graphics = none_pipeline_create_graphics;
+    table->pfn_pipeline_create_compute = none_pipeline_create_compute;
+    table->pfn_pipeline_destroy = none_pipeline_destroy;
+    table->pfn_pipeline_library_create = none_pipeline_library_create;
+    table->pfn_pipeline_library_destroy = none_pipeline_library_destroy;
+    table->pfn_pipeline_link = none_pipeline_link;
+}
+
+void none_register_pipeline_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
+    table->pfn_cmd_bind_pipeline = none_cmd_bind_pipeline;
+}
+
+// Modules have no backend state here, the core keeps the bytecode
+VriResult none_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    return vri_shader_module_acquire(device, p_desc, 0, NULL, NULL, p_shader_module);
+}
+
+void none_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    if (shader_module) {
+        vri_shader_module_release(device, shader_module, 0, NULL);
+    }
+}
+
+VriResult none_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
+    (void)device;
+    (void)p_desc;
+    (void)p_pipeline_layout;
+
+    return VRI_SUCCESS;
+}
+
+VriResult none_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    // Allocate pipeline internals
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
+    if (!*p_pipeline) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_pipeline)->p_backend_data = (VriNonePipeline *)(*p_pipeline + 1);
+    VriResult result = parts_create(device, (*p_pipeline)->p_backend_data, VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL, p_desc);
+    if (VRI_ERROR(result)) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate the pipeline's state");
+        none_pipeline_destroy(device, *p_pipeline);
+        return result;
+    }
+
+    return VRI_SUCCESS;
+}
+
+VriResult none_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    // Allocate pipeline internals
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
+    if (!*p_pipeline) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_pipeline)->p_backend_data = (VriNonePipeline *)(*p_pipeline + 1);
+    VriNonePipeline *none_pipeline = (*p_pipeline)->p_backend_data;
+    none_pipeline->stages = p_desc->p_shader[0].stage;
+
+    return VRI_SUCCESS;
+}
+
+void none_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    if (pipeline) {
+        parts_release(device, pipeline->p_backend_data);
+        vri_object_free(device, &device->allocation_callback, pipeline, PIPELINE_OBJECT_SIZE);
+    }
+}
+
+void none_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
+    if (!pipeline) return;
+
+    if (pipeline == command_buffer->pipeline) {
+        command_buffer->stats.pipeline_binds_redundant++;
+        return;
+    }
+
+    command_buffer->pipeline = pipeline;
+}
+
+VriResult none_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    *p_library = vri_object_allocate(device, &device->allocation_callback, PIPELINE_LIBRARY_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE_LIBRARY);
+    if (!*p_library) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline library object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_library)->parts = p_desc->parts;
+    (*p_library)->p_backend_data = (VriNonePipeline *)(*p_library + 1);
+    VriResult result = parts_create(device, (*p_library)->p_backend_data, p_desc->parts, p_desc->p_desc);
+    if (VRI_ERROR(result)) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate the pipeline library's state");
+        none_pipeline_library_destroy(device, *p_library);
+        return result;
+    }
+
+    return VRI_SUCCESS;
+}
+
+void none_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    if (library) {
+        parts_release(device, library->p_backend_data);
+        vri_object_free(device, &device->allocation_callback, library, PIPELINE_LIBRARY_OBJECT_SIZE);
+    }
+}
+
+// Linking builds nothing, the pipeline takes a reference on each library's parts
+VriResult none_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    *p_pipeline = vri_object_allocate(device, &device->allocation_callback, PIPELINE_OBJECT_SIZE, VRI_OBJECT_TYPE_PIPELINE);
+    if (!*p_pipeline) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate pipeline object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_pipeline)->p_backend_data = (VriNonePipeline *)(*p_pipeline + 1);
+    VriNonePipeline *none_pipeline = (*p_pipeline)->p_backend_data;
+
+    for (uint32_t i = 0; i < p_desc->library_count; ++i) {
+        const VriNonePipeline *library = p_desc->p_libraries[i]->p_backend_data;
+        for (uint32_t j = 0; j < VRI_NONE_PIPELINE_PART_COUNT; ++j) {
+            if (!library->p_parts[j]) continue;
+
+            VRI_ATOMIC_ADD_U64(&library->p_parts[j]->ref_count, 1);
+            merge_part(none_pipeline, j, library->p_parts[j]);
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult parts_create(VriDevice device, VriNonePipeline *none_pipeline, VriPipelineLibraryFlags parts, const VriGraphicsPipelineDesc *p_desc) {
+    for (uint32_t i = 0; i < VRI_NONE_PIPELINE_PART_COUNT; ++i) {
+        VriPipelineLibraryFlags part_flag = (VriPipelineLibraryFlags)(1u << i);
+        if (!(parts & part_flag)) continue;
+
+        VriNonePipelinePart *part = device->allocation_callback.pfn_allocate(sizeof(VriNonePipelinePart), sizeof(uint64_t), VRI_ALLOCATION_SCOPE_OBJECT);
+        if (!part) return VRI_ERROR_OUT_OF_MEMORY;
+        *part = (VriNonePipelinePart){.ref_count = 1};
+
+        VriShaderStageFlags stages = vri_pipeline_library_stages(part_flag);
+        for (uint32_t j = 0; j < p_desc->shader_count; ++j) {
+            part->stages |= p_desc->p_shaders[j].stage & stages;
+        }
+        part->dynamic_states = p_desc->dynamic_states & vri_pipeline_library_dynamic_states(part_flag);
+
+        if (part_flag == VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) {
+            part->topology = p_desc->p_input_assembly_state->topology;
+        }
+        if (part_flag == VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) {
+            part->render_target_count = p_desc->p_color_blend_state ? VRI_MAX(p_desc->p_color_blend_state->render_target_count, 1) : 1;
+            part->sample_count = p_desc->p_multisample_state ? p_desc->p_multisample_state->sample_count : 1;
+        }
+
+        merge_part(none_pipeline, i, part);
+    }
+    return VRI_SUCCESS;
+}
+
+static void parts_release(VriDevice device, VriNonePipeline *none_pipeline) {
+    for (uint32_t i = 0; i < VRI_NONE_PIPELINE_PART_COUNT; ++i) {
+        VriNonePipelinePart *part = none_pipeline->p_parts[i];
+        if (part && VRI_ATOMIC_ADD_U64(&part->ref_count, (uint64_t)-1) == 1) {
+            device->allocation_callback.pfn_free(part, sizeof(VriNonePipelinePart), sizeof(uint64_t), VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+        none_pipeline->p_parts[i] = NULL;
+    }
+}
+
+// Parts only set the members they own
+static void merge_part(VriNonePipeline *none_pipeline, uint32_t index, VriNonePipelinePart *part) {
+    none_pipeline->p_parts[index] = part;
+    none_pipeline->stages |= part->stages;
+    none_pipeline->dynamic_states |= part->dynamic_states;
+    if ((1u << index) == VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) {
+        none_pipeline->topology = part->topology;
+    }
+    if ((1u << index) == VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) {
+        none_pipeline->render_target_count = part->render_target_count;
+        none_pipeline->sample_count = part->sample_count;
+    }
+}
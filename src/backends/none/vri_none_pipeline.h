@@ -0,0 +1,44 @@
+#ifndef VRI_NONE_PIPELINE_H
+#define VRI_NONE_PIPELINE_H
+
+#include "vri_none_common.h"
+
+#define VRI_NONE_PIPELINE_PART_COUNT 4 // One per VriPipelineLibraryFlagBits
+
+// The state of one library part. Creates build one for every part, the way the
+// D3D11 backend creates its state objects, and links reference the libraries'
+typedef struct {
+    uint64_t             ref_count;
+    VriShaderStageFlags  stages;
+    VriDynamicStateFlags dynamic_states;
+    VriPrimitiveTopology topology;            // Vertex input
+    uint32_t             render_target_count; // Fragment output
+    uint32_t             sample_count;        // Fragment output
+} VriNonePipelinePart;
+
+// Graphics pipelines and libraries hold their parts, NULL for the parts a
+// library doesn't have and for compute pipelines. The rest is what binding
+// needs, merged from the parts.
+typedef struct {
+    VriNonePipelinePart *p_parts[VRI_NONE_PIPELINE_PART_COUNT];
+    VriShaderStageFlags  stages;
+    VriPrimitiveTopology topology;
+    uint32_t             render_target_count;
+    uint32_t             sample_count;
+    VriDynamicStateFlags dynamic_states;
+} VriNonePipeline;
+
+void      none_register_pipeline_functions_with_device(VriDeviceDispatchTable *table);
+void      none_register_pipeline_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+VriResult none_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module);
+void      none_shader_module_destroy(VriDevice device, VriShaderModule shader_module);
+VriResult none_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout);
+VriResult none_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline);
+VriResult none_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
+void      none_pipeline_destroy(VriDevice device, VriPipeline pipeline);
+VriResult none_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library);
+void      none_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library);
+VriResult none_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline);
+void      none_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline);
+
+#endif
@@ -0,0 +1,117 @@
+#include "vri_none_queue.h"
+
+#include "vri_none_command_buffer.h"
+#include "vri_none_fence.h"
+#include "vri_none_swapchain.h"
+#include "vri_none_texture.h"
+
+#define QUEUE_STRUCT_SIZE (sizeof(struct VriQueue_T))
+
+void none_register_queue_functions(VriQueueDispatchTable *table) {
+    table->pfn_queue_submit = none_queue_submit;
+    table->pfn_queue_wait_idle = none_queue_wait_idle;
+    table->pfn_queue_present = none_queue_present;
+    table->pfn_queue_bind_sparse = none_queue_bind_sparse;
+}
+
+VriResult none_queue_create(VriDevice device, const VriAllocationCallback *allocation_callback, VriQueue *p_queue) {
+    // Attempt to allocate the full internal struct
+    *p_queue = vri_object_allocate(device, allocation_callback, QUEUE_STRUCT_SIZE, VRI_OBJECT_TYPE_QUEUE);
+    if (!*p_queue) {
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    // The device fills its queue table before creating the queues
+    (*p_queue)->dispatch = device->queue_dispatch;
+
+    return VRI_SUCCESS;
+}
+
+void none_queue_destroy(VriDevice device, VriQueue queue) {
+    if (queue) {
+        vri_object_free(device, &device->allocation_callback, queue, QUEUE_STRUCT_SIZE);
+    }
+}
+
+VriResult none_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
+    VriDevice device = queue->base.p_device;
+
+    for (uint32_t i = 0; i < submit_count; ++i) {
+        const VriQueueSubmitDesc *submit = &p_submits[i];
+
+        // --- PHASE 1: WAIT ---
+        // There is no GPU timeline to defer to, so waits happen on the submitting thread
+        for (uint32_t j = 0; j < submit->fence_wait_count; ++j) {
+            const VriFenceWaitDesc *wait = &submit->p_fences_wait[j];
+
+            VriResult res = none_fences_wait(device, &wait->fence, &wait->value, 1, true, UINT64_MAX);
+            if (res != VRI_SUCCESS) return res;
+        }
+
+        // --- PHASE 2: EXECUTE ---
+        // Copies are the only recorded work with a visible result, they retire here
+        for (uint32_t j = 0; j < submit->command_buffer_count; ++j) {
+            none_command_buffer_execute(submit->p_command_buffers[j]);
+        }
+
+        // --- PHASE 3: SIGNAL ---
+        for (uint32_t j = 0; j < submit->fence_signal_count; ++j) {
+            none_fence_signal(submit->p_fences_signal[j].fence, submit->p_fences_signal[j].value);
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+VriResult none_queue_wait_idle(VriQueue queue) {
+    // Submissions complete before vri_queue_submit returns
+    (void)queue;
+    return VRI_SUCCESS;
+}
+
+VriResult none_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc) {
+    // Wait for timeline fences before presenting
+    VriDevice device = queue->base.p_device;
+    VriResult wait_result = none_fences_wait(
+        device,
+        p_present_desc->p_wait_fences,
+        p_present_desc->p_wait_values,
+        p_present_desc->wait_fence_count,
+        true,
+        UINT64_MAX);
+
+    if (wait_result != VRI_SUCCESS) {
+        return wait_result;
+    }
+
+    VriResult overall_result = VRI_SUCCESS;
+
+    // Present each swapchain
+    for (uint32_t i = 0; i < p_present_desc->swapchain_count; ++i) {
+        VriSwapchain swapchain = p_present_desc->p_swapchains[i];
+        uint32_t     image_index = p_present_desc->p_image_indices ? p_present_desc->p_image_indices[i] : 0;
+
+        VriResult present_result = none_swapchain_present_image(swapchain, image_index);
+
+        // Store per-swapchain result if requested
+        if (p_present_desc->p_results) {
+            p_present_desc->p_results[i] = present_result;
+        }
+
+        // Update overall results with error priority
+        if (present_result != VRI_SUCCESS && overall_result == VRI_SUCCESS) {
+            overall_result = present_result;
+        }
+    }
+
+    return overall_result;
+}
+
+VriResult none_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    // Submits retire immediately, so the tables can change right away
+    (void)queue;
+    for (uint32_t i = 0; i < bind_count; ++i) {
+        none_texture_bind_tiles(&p_binds[i]);
+    }
+    return VRI_SUCCESS;
+}
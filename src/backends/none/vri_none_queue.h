@@ -0,0 +1,14 @@
+#ifndef VRI_NONE_QUEUE_H
+#define VRI_NONE_QUEUE_H
+
+#include "vri_none_common.h"
+
+void      none_register_queue_functions(VriQueueDispatchTable *table);
+VriResult none_queue_create(VriDevice device, const VriAllocationCallback *allocation_callback, VriQueue *p_queue);
+void      none_queue_destroy(VriDevice device, VriQueue queue);
+VriResult none_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count);
+VriResult none_queue_wait_idle(VriQueue queue);
+VriResult none_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present_desc);
+VriResult none_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count);
+
+#endif
@@ -0,0 +1,130 @@
+#include "vri_none_swapchain.h"
+
+#include "vri_none_fence.h"
+#include "vri_none_texture.h"
+
+#define SWAPCHAIN_STRUCT_SIZE (sizeof(struct VriSwapchain_T) + sizeof(VriNoneSwapchain))
+
+void none_register_swapchain_functions(VriDeviceDispatchTable *table) {
+    table->pfn_swapchain_create = none_swapchain_create;
+    table->pfn_swapchain_destroy = none_swapchain_destroy;
+    table->pfn_swapchain_acquire_next_image = none_swapchain_acquire_next_image;
+    table->pfn_swapchain_present = none_swapchain_present;
+    table->pfn_swapchain_get_texture = none_swapchain_get_texture;
+    table->pfn_swapchain_get_stats = none_swapchain_get_stats;
+}
+
+VriResult none_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    // A window's pacing comes from its flags, like it would with a display behind it
+    VriSwapchainDesc desc = *p_desc;
+    if (desc.p_window_desc) {
+        desc.present_mode = (desc.flags & VRI_SWAPCHAIN_FLAG_BIT_VSYNC) ? VRI_PRESENT_MODE_FIFO : VRI_PRESENT_MODE_IMMEDIATE;
+    }
+
+    VriHeadlessPresenter presenter;
+    if (VRI_ERROR(vri_headless_presenter_init(&presenter, &desc))) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Swapchain needs 2 to VRI_SWAPCHAIN_MAX_TEXTURES textures and a valid present mode");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    // There is nothing to present to, the window is only used for its flags
+    *p_swapchain = vri_object_allocate(device, &device->allocation_callback, SWAPCHAIN_STRUCT_SIZE, VRI_OBJECT_TYPE_SWAPCHAIN);
+    if (!*p_swapchain) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for swapchain struct failed.");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    VriNoneSwapchain *internal = (VriNoneSwapchain *)((*p_swapchain) + 1);
+    (*p_swapchain)->p_backend_data = internal;
+    internal->present_id = 0;
+    internal->flags = p_desc->flags;
+    internal->presenter = presenter;
+
+    VriTextureDesc texture_desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = p_desc->format,
+        .width = p_desc->width,
+        .height = p_desc->height,
+        .depth = 1,
+        .usage = VRI_TEXTURE_USAGE_BIT_COLOR_ATTACHMENT,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+    };
+
+    for (uint32_t i = 0; i < presenter.texture_count; ++i) {
+        VriResult result = none_texture_create(device, &texture_desc, &internal->textures[i]);
+        if (result != VRI_SUCCESS) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't create textures for the swapchain's images");
+            none_swapchain_destroy(device, *p_swapchain);
+            *p_swapchain = NULL;
+            return result;
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+void none_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
+    if (swapchain) {
+        VriNoneSwapchain *internal = (VriNoneSwapchain *)swapchain->p_backend_data;
+        for (uint32_t i = 0; i < internal->presenter.texture_count; ++i) {
+            if (internal->textures[i]) none_texture_destroy(device, internal->textures[i]);
+        }
+
+        vri_object_free(device, &device->allocation_callback, swapchain, SWAPCHAIN_STRUCT_SIZE);
+    }
+}
+
+VriResult none_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
+    (void)device;
+    VriNoneSwapchain *internal = swapchain->p_backend_data;
+
+    VriResult result = vri_headless_presenter_acquire(&internal->presenter, p_image_index);
+    if (VRI_ERROR(result)) return result;
+
+    // Nothing reads an image after it's replaced on display, so it's free as soon as it's acquired
+    if (fence != VRI_NULL_HANDLE) {
+        none_fence_signal(fence, signal_value);
+    }
+
+    return VRI_SUCCESS;
+}
+
+VriResult none_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
+    (void)device;
+    (void)fence;
+    VriNoneSwapchain *internal = swapchain->p_backend_data;
+    return none_swapchain_present_image(swapchain, internal->presenter.last_acquired);
+}
+
+VriResult none_swapchain_present_image(VriSwapchain swapchain, uint32_t image_index) {
+    VriNoneSwapchain *internal = swapchain->p_backend_data;
+
+    VriResult result = vri_headless_presenter_present(&internal->presenter, image_index);
+    if (VRI_ERROR(result)) return result;
+
+    internal->present_id++;
+    return VRI_SUCCESS;
+}
+
+VriResult none_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    (void)device;
+    VriNoneSwapchain *internal = swapchain->p_backend_data;
+
+    if (image_index >= internal->presenter.texture_count) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    *p_texture = internal->textures[image_index];
+    return VRI_SUCCESS;
+}
+
+VriResult none_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats) {
+    (void)device;
+    VriNoneSwapchain *internal = swapchain->p_backend_data;
+    *p_stats = internal->presenter.stats;
+    return VRI_SUCCESS;
+}
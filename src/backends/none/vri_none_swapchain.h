@@ -0,0 +1,23 @@
+#ifndef VRI_NONE_SWAPCHAIN_H
+#define VRI_NONE_SWAPCHAIN_H
+
+#include "vri_none_common.h"
+
+// Every swapchain is headless here, a window is ignored
+typedef struct {
+    uint32_t             flags;
+    uint64_t             present_id;
+    VriTexture           textures[VRI_SWAPCHAIN_MAX_TEXTURES];
+    VriHeadlessPresenter presenter;
+} VriNoneSwapchain;
+
+void      none_register_swapchain_functions(VriDeviceDispatchTable *table);
+VriResult none_swapchain_present_image(VriSwapchain swapchain, uint32_t image_index);
+VriResult none_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain);
+void      none_swapchain_destroy(VriDevice device, VriSwapchain swapchain);
+VriResult none_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index);
+VriResult none_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence);
+VriResult none_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture);
+VriResult none_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats);
+
+#endif
@@ -0,0 +1,293 @@
+#include "vri_none_texture.h"
+
+#include "vri_none_command_buffer.h"
+#include "vri_none_device.h"
+
+#include <string.h>
+
+#define TEXTURE_OBJECT_SIZE (sizeof(struct VriTexture_T) + sizeof(VriNoneTexture))
+
+// Sparse textures keep a tile table in place of memory. Binds only update the
+// table and recorded commands flag the tiles they touch, which is what
+// residency feedback reports. READBACK textures are the only ones with texel
+// memory, copies from textures without any leave the destination as it was.
+// Copies are kept by their command buffer and carried out at submit.
+
+static void          compute_tiling(const VriTextureDesc *p_desc, VriTextureTiling *p_tiling);
+static uint32_t      first_tile(const VriNoneTexture *texture, const VriTextureDesc *p_desc, uint32_t mip_level, uint32_t *p_columns);
+static void          mark_accessed(VriTexture texture, const VriTextureUpdateDesc *p_desc);
+static uint8_t      *subresource_memory(VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data);
+static VriMemoryHeap memory_heap(const VriTextureDesc *p_desc);
+
+void none_register_texture_functions(VriDeviceDispatchTable *table) {
+    table->pfn_texture_create = none_texture_create;
+    table->pfn_texture_destroy = none_texture_destroy;
+    table->pfn_texture_get_tiling = none_texture_get_tiling;
+    table->pfn_texture_get_tile_feedback = none_texture_get_tile_feedback;
+    table->pfn_texture_map = none_texture_map;
+    table->pfn_texture_unmap = none_texture_unmap;
+}
+
+void none_register_texture_functions_with_command_buffer(VriCommandBufferDispatchTable *table) {
+    table->pfn_cmd_update_texture = none_cmd_update_texture;
+    table->pfn_cmd_generate_mips = none_cmd_generate_mips;
+    table->pfn_cmd_copy_texture = none_cmd_copy_texture;
+}
+
+VriResult none_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
+    *p_texture = vri_object_allocate(device, &device->allocation_callback, TEXTURE_OBJECT_SIZE, VRI_OBJECT_TYPE_TEXTURE);
+    if (!*p_texture) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Texture struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    // The initial data only has to live for the duration of the call
+    (*p_texture)->desc = *p_desc;
+    (*p_texture)->desc.p_initial_data = NULL;
+    (*p_texture)->p_backend_data = *p_texture + 1;
+
+    VriNoneTexture *none_texture = (*p_texture)->p_backend_data;
+    *none_texture = (VriNoneTexture){0};
+
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        compute_tiling(p_desc, &none_texture->tiling);
+
+        // Tiles and their access flags share one allocation, every tile starts out unbound
+        size_t size = (sizeof(VriNoneTile) + 1) * none_texture->tiling.tile_count;
+        none_texture->p_tiles = device->allocation_callback.pfn_allocate(size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        if (!none_texture->p_tiles) {
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate the sparse Texture's tile table");
+            none_texture_destroy(device, *p_texture);
+            return VRI_ERROR_OUT_OF_MEMORY;
+        }
+        memset(none_texture->p_tiles, 0, size);
+        none_texture->p_accessed = (uint8_t *)(none_texture->p_tiles + none_texture->tiling.tile_count);
+    }
+
+    if (p_desc->memory_type == VRI_MEMORY_TYPE_READBACK) {
+        none_texture->memory_size = (size_t)vri_texture_size(p_desc);
+        none_texture->p_memory = device->allocation_callback.pfn_allocate(none_texture->memory_size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_OBJECT);
+        if (!none_texture->p_memory) {
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate the readback Texture's memory");
+            none_texture_destroy(device, *p_texture);
+            return VRI_ERROR_OUT_OF_MEMORY;
+        }
+        memset(none_texture->p_memory, 0, none_texture->memory_size);
+    }
+
+    none_device_track_memory(device, memory_heap(p_desc), (int64_t)vri_texture_size(p_desc));
+    return VRI_SUCCESS;
+}
+
+void none_texture_destroy(VriDevice device, VriTexture texture) {
+    if (texture) {
+        VriNoneTexture *none_texture = texture->p_backend_data;
+        if (none_texture->p_tiles) {
+            size_t size = (sizeof(VriNoneTile) + 1) * none_texture->tiling.tile_count;
+            device->allocation_callback.pfn_free(none_texture->p_tiles, size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+        if (none_texture->p_memory) {
+            device->allocation_callback.pfn_free(none_texture->p_memory, none_texture->memory_size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+        none_device_track_memory(device, memory_heap(&texture->desc), -(int64_t)vri_texture_size(&texture->desc));
+        vri_object_free(device, &device->allocation_callback, texture, TEXTURE_OBJECT_SIZE);
+    }
+}
+
+void none_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling) {
+    (void)device;
+    *p_tiling = ((VriNoneTexture *)texture->p_backend_data)->tiling;
+}
+
+VriResult none_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed) {
+    (void)device;
+    VriNoneTexture *none_texture = texture->p_backend_data;
+
+    uint32_t count = VRI_MIN(tile_count, none_texture->tiling.tile_count);
+    for (uint32_t i = 0; i < count; ++i) {
+        p_accessed[i] = __atomic_exchange_n(&none_texture->p_accessed[i], 0, __ATOMIC_RELAXED);
+    }
+    return VRI_SUCCESS;
+}
+
+void none_texture_bind_tiles(const VriSparseBindDesc *p_bind) {
+    VriNoneTexture *none_texture = p_bind->texture->p_backend_data;
+
+    uint32_t columns = 0;
+    uint32_t first = first_tile(none_texture, &p_bind->texture->desc, p_bind->mip_level, &columns);
+    uint32_t heap_tile = p_bind->heap_offset;
+
+    for (uint32_t y = 0; y < p_bind->height; ++y) {
+        VriNoneTile *row = &none_texture->p_tiles[first + (p_bind->y + y) * columns + p_bind->x];
+        for (uint32_t x = 0; x < p_bind->width; ++x) {
+            row[x].heap = p_bind->heap;
+            row[x].heap_tile = p_bind->heap ? heap_tile++ : 0;
+        }
+    }
+}
+
+void none_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    (void)command_buffer;
+    if (texture->desc.usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        mark_accessed(texture, p_desc);
+    }
+}
+
+void none_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    (void)command_buffer;
+
+    // Reads and writes every mip
+    VriNoneTexture *none_texture = texture->p_backend_data;
+    for (uint32_t i = 0; none_texture->p_accessed && i < none_texture->tiling.tile_count; ++i) {
+        __atomic_store_n(&none_texture->p_accessed[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+VriResult none_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    (void)device;
+
+    // Copies are done once vri_queue_submit returns, there's never anything to wait for
+    if (!subresource_memory(texture, mip_level, array_layer, p_data)) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    return VRI_SUCCESS;
+}
+
+void none_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer) {
+    (void)device;
+    (void)texture;
+    (void)mip_level;
+    (void)array_layer;
+}
+
+void none_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    none_command_buffer_record_copy(command_buffer, src, dst, p_desc);
+}
+
+void none_texture_copy(VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    if (src->desc.usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        VriTextureUpdateDesc region = {.mip_level = p_desc->src.mip_level, .x = p_desc->src.x, .y = p_desc->src.y, .width = p_desc->width, .height = p_desc->height};
+        mark_accessed(src, &region);
+    }
+    if (dst->desc.usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        VriTextureUpdateDesc region = {.mip_level = p_desc->dst.mip_level, .x = p_desc->dst.x, .y = p_desc->dst.y, .width = p_desc->width, .height = p_desc->height};
+        mark_accessed(dst, &region);
+    }
+
+    VriSubresourceData src_data, dst_data;
+    const uint8_t     *p_src = subresource_memory(src, p_desc->src.mip_level, p_desc->src.array_layer, &src_data);
+    uint8_t           *p_dst = subresource_memory(dst, p_desc->dst.mip_level, p_desc->dst.array_layer, &dst_data);
+    if (!p_src || !p_dst) return;
+
+    // Both have the same format, so rows of blocks line up
+    const VriFormatInfo *info = VRI_FORMAT_INFO(src->desc.format);
+    size_t               row_size = vri_format_row_pitch(src->desc.format, p_desc->width);
+    uint32_t             row_count = vri_format_row_count(src->desc.format, p_desc->height);
+    for (uint32_t z = 0; z < p_desc->depth; ++z) {
+        for (uint32_t row = 0; row < row_count; ++row) {
+            const uint8_t *p_src_row = p_src + (size_t)(p_desc->src.z + z) * src_data.slice_pitch + (size_t)(p_desc->src.y / info->block_height + row) * src_data.row_pitch +
+                                       (size_t)(p_desc->src.x / info->block_width) * info->block_size;
+            uint8_t *p_dst_row = p_dst + (size_t)(p_desc->dst.z + z) * dst_data.slice_pitch + (size_t)(p_desc->dst.y / info->block_height + row) * dst_data.row_pitch +
+                                 (size_t)(p_desc->dst.x / info->block_width) * info->block_size;
+            memcpy(p_dst_row, p_src_row, row_size);
+        }
+    }
+}
+
+static void compute_tiling(const VriTextureDesc *p_desc, VriTextureTiling *p_tiling) {
+    vri_format_tile_extent(p_desc->format, &p_tiling->tile_width, &p_tiling->tile_height);
+
+    // Mips stay standard while a whole tile fits, the rest are packed together
+    uint32_t mip = 0;
+    uint32_t standard_tiles = 0;
+    for (; mip < p_desc->mip_count; ++mip) {
+        uint32_t width = VRI_MAX(p_desc->width >> mip, 1u);
+        uint32_t height = VRI_MAX(p_desc->height >> mip, 1u);
+        if (width < p_tiling->tile_width || height < p_tiling->tile_height) break;
+
+        standard_tiles += ((width + p_tiling->tile_width - 1) / p_tiling->tile_width) * ((height + p_tiling->tile_height - 1) / p_tiling->tile_height);
+    }
+    p_tiling->standard_mip_count = mip;
+
+    uint64_t packed_size = 0;
+    for (; mip < p_desc->mip_count; ++mip) {
+        uint32_t width = VRI_MAX(p_desc->width >> mip, 1u);
+        uint32_t height = VRI_MAX(p_desc->height >> mip, 1u);
+        packed_size += (uint64_t)vri_format_row_pitch(p_desc->format, width) * vri_format_row_count(p_desc->format, height);
+    }
+    p_tiling->packed_tile_count = (uint32_t)((packed_size + VRI_TILE_SIZE - 1) / VRI_TILE_SIZE);
+    p_tiling->tile_count = standard_tiles + p_tiling->packed_tile_count;
+}
+
+// The packed mips are one row of packed_tile_count tiles after the standard ones
+static uint32_t first_tile(const VriNoneTexture *texture, const VriTextureDesc *p_desc, uint32_t mip_level, uint32_t *p_columns) {
+    const VriTextureTiling *tiling = &texture->tiling;
+
+    uint32_t first = 0;
+    for (uint32_t mip = 0; mip < tiling->standard_mip_count; ++mip) {
+        uint32_t columns = (VRI_MAX(p_desc->width >> mip, 1u) + tiling->tile_width - 1) / tiling->tile_width;
+        uint32_t rows = (VRI_MAX(p_desc->height >> mip, 1u) + tiling->tile_height - 1) / tiling->tile_height;
+        if (mip == mip_level) {
+            *p_columns = columns;
+            return first;
+        }
+        first += columns * rows;
+    }
+
+    *p_columns = tiling->packed_tile_count;
+    return first;
+}
+
+static void mark_accessed(VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    VriNoneTexture   *none_texture = texture->p_backend_data;
+    VriTextureTiling *tiling = &none_texture->tiling;
+
+    uint32_t columns = 0;
+    uint32_t first = first_tile(none_texture, &texture->desc, p_desc->mip_level, &columns);
+
+    uint32_t x0 = 0, y0 = 0, x1 = columns, y1 = 1;
+    if (p_desc->mip_level < tiling->standard_mip_count) {
+        x0 = p_desc->x / tiling->tile_width;
+        y0 = p_desc->y / tiling->tile_height;
+        x1 = (p_desc->x + p_desc->width + tiling->tile_width - 1) / tiling->tile_width;
+        y1 = (p_desc->y + p_desc->height + tiling->tile_height - 1) / tiling->tile_height;
+    }
+
+    for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t x = x0; x < x1; ++x) {
+            __atomic_store_n(&none_texture->p_accessed[first + y * columns + x], 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// NULL for textures without memory
+static uint8_t *subresource_memory(VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    VriNoneTexture       *none_texture = texture->p_backend_data;
+    const VriTextureDesc *desc = &texture->desc;
+    if (!none_texture->p_memory) return NULL;
+
+    size_t offset = 0;
+    size_t layer_size = 0;
+    for (uint32_t mip = 0; mip < desc->mip_count; ++mip) {
+        uint32_t width = VRI_MAX(desc->width >> mip, 1u);
+        uint32_t height = VRI_MAX(desc->height >> mip, 1u);
+        uint32_t depth = VRI_MAX(desc->depth >> mip, 1u);
+        uint32_t row_pitch = vri_format_row_pitch(desc->format, width);
+        uint32_t slice_pitch = row_pitch * vri_format_row_count(desc->format, height);
+        if (mip == mip_level) {
+            offset = layer_size;
+            p_data->row_pitch = row_pitch;
+            p_data->slice_pitch = slice_pitch;
+        }
+        layer_size += (size_t)slice_pitch * depth;
+    }
+
+    uint8_t *p_memory = none_texture->p_memory + (size_t)array_layer * layer_size + offset;
+    p_data->p_data = p_memory;
+    return p_memory;
+}
+
+// UPLOAD and READBACK memory is system memory, like on a discrete GPU
+static VriMemoryHeap memory_heap(const VriTextureDesc *p_desc) {
+    return p_desc->memory_type == VRI_MEMORY_TYPE_GPU_ONLY ? VRI_MEMORY_HEAP_DEVICE_LOCAL : VRI_MEMORY_HEAP_SYSTEM;
+}
@@ -0,0 +1,33 @@
+#ifndef VRI_NONE_TEXTURE_H
+#define VRI_NONE_TEXTURE_H
+
+#include "vri_none_common.h"
+
+typedef struct {
+    VriTileHeap heap;
+    uint32_t    heap_tile;
+} VriNoneTile;
+
+typedef struct {
+    VriTextureTiling tiling;
+    VriNoneTile     *p_tiles;    // Sparse textures only, one per tile
+    uint8_t         *p_accessed; // Sparse textures only, set by recorded commands until read back as feedback
+    uint8_t         *p_memory;   // READBACK textures only, every mip of layer 0 first
+    size_t           memory_size;
+} VriNoneTexture;
+
+void      none_register_texture_functions(VriDeviceDispatchTable *table);
+void      none_register_texture_functions_with_command_buffer(VriCommandBufferDispatchTable *table);
+VriResult none_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture);
+void      none_texture_destroy(VriDevice device, VriTexture texture);
+void      none_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling);
+VriResult none_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed);
+void      none_texture_bind_tiles(const VriSparseBindDesc *p_bind);
+void      none_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc);
+void      none_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture);
+void      none_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc);
+void      none_texture_copy(VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc); // Runs a recorded copy at submit
+VriResult none_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data);
+void      none_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer);
+
+#endif
@@ -0,0 +1,32 @@
+#include "vri_none_tile_heap.h"
+
+#include "vri_none_device.h"
+
+// Nothing ever reads texels here, so a heap is only its tile count
+#define TILE_HEAP_OBJECT_SIZE (sizeof(struct VriTileHeap_T))
+
+void none_register_tile_heap_functions(VriDeviceDispatchTable *table) {
+    table->pfn_tile_heap_create = none_tile_heap_create;
+    table->pfn_tile_heap_destroy = none_tile_heap_destroy;
+}
+
+VriResult none_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    *p_tile_heap = vri_object_allocate(device, &device->allocation_callback, TILE_HEAP_OBJECT_SIZE, VRI_OBJECT_TYPE_TILE_HEAP);
+    if (!*p_tile_heap) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Tile Heap struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    (*p_tile_heap)->tile_count = p_desc->tile_count;
+    (*p_tile_heap)->p_backend_data = NULL;
+    none_device_track_memory(device, VRI_MEMORY_HEAP_DEVICE_LOCAL, (int64_t)p_desc->tile_count * VRI_TILE_SIZE);
+
+    return VRI_SUCCESS;
+}
+
+void none_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    if (tile_heap) {
+        none_device_track_memory(device, VRI_MEMORY_HEAP_DEVICE_LOCAL, -(int64_t)tile_heap->tile_count * VRI_TILE_SIZE);
+        vri_object_free(device, &device->allocation_callback, tile_heap, TILE_HEAP_OBJECT_SIZE);
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef VRI_NONE_TILE_HEAP_H
+#define VRI_NONE_TILE_HEAP_H
+
+#include "vri_none_common.h"
+
+void      none_register_tile_heap_functions(VriDeviceDispatchTable *table);
+VriResult none_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap);
+void      none_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap);
+
+#endif
@@ -1,8 +1,21 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "vri/vri.h"
 #include "vri_internal.h"
+#include "vri_layer.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
 #if VRI_ENABLE_D3D11_SUPPORT
 #    include <d3d11_4.h>
 #    include <dxgidebug.h>
@@ -22,6 +35,12 @@
 #define VENDOR_MASK 0xFull
 #define VRAM_MASK   0x0FFFFFFFFFFFFFF0ull
 
+#if VRI_ENABLE_OBJECT_TRACKING
+#    define TRACK_CREATION(object) track_creation((object), VRI_RETURN_ADDRESS())
+#else
+#    define TRACK_CREATION(object) ((void)0)
+#endif
+
 // Forward declaration of backend functions so they don't have to be included
 extern VriResult none_device_create(
     const VriDeviceDesc *p_desc,
@@ -35,30 +54,269 @@ extern VriResult vk_device_create(
     const VriDeviceDesc *p_desc,
     VriDevice           *p_device);
 
+// With VRI_SINGLE_BACKEND the public functions call the one compiled in backend
+// directly instead of going through the dispatch tables, so the calls can be
+// inlined with LTO. Layers are installed into the dispatch tables, which makes
+// them unavailable in this mode.
+#if VRI_SINGLE_BACKEND
+#    if (VRI_ENABLE_D3D11_SUPPORT + VRI_ENABLE_D3D12_SUPPORT + VRI_ENABLE_VK_SUPPORT + VRI_ENABLE_NONE_SUPPORT) != 1
+#        error "VRI_SINGLE_BACKEND requires exactly one VRI_ENABLE_*_SUPPORT"
+#    elif VRI_ENABLE_D3D11_SUPPORT
+#        define BACKEND_FN(name) d3d11_##name
+#    elif VRI_ENABLE_NONE_SUPPORT
+#        define BACKEND_FN(name) none_##name
+#    else
+#        error "VRI_SINGLE_BACKEND isn't supported by the enabled backend"
+#    endif
+
+extern void      BACKEND_FN(device_destroy)(VriDevice device);
+extern VriResult BACKEND_FN(device_query_memory_budget)(VriDevice device, VriMemoryBudget *p_budget);
+extern VriResult BACKEND_FN(command_pool_create)(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool);
+extern void      BACKEND_FN(command_pool_destroy)(VriDevice device, VriCommandPool command_pool);
+extern void      BACKEND_FN(command_pool_reset)(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags);
+extern VriResult BACKEND_FN(command_buffers_allocate)(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers);
+extern void      BACKEND_FN(command_buffers_free)(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers);
+extern VriResult BACKEND_FN(shader_module_create)(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module);
+extern void      BACKEND_FN(shader_module_destroy)(VriDevice device, VriShaderModule shader_module);
+extern VriResult BACKEND_FN(pipeline_layout_create)(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout);
+extern VriResult BACKEND_FN(pipeline_create_graphics)(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline);
+extern VriResult BACKEND_FN(pipeline_create_compute)(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
+extern void      BACKEND_FN(pipeline_destroy)(VriDevice device, VriPipeline pipeline);
+extern VriResult BACKEND_FN(pipeline_library_create)(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library);
+extern void      BACKEND_FN(pipeline_library_destroy)(VriDevice device, VriPipelineLibrary library);
+extern VriResult BACKEND_FN(pipeline_link)(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline);
+extern VriResult BACKEND_FN(texture_create)(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture);
+extern void      BACKEND_FN(texture_destroy)(VriDevice device, VriTexture texture);
+extern void      BACKEND_FN(texture_get_tiling)(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling);
+extern VriResult BACKEND_FN(texture_get_tile_feedback)(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed);
+extern VriResult BACKEND_FN(texture_map)(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data);
+extern void      BACKEND_FN(texture_unmap)(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer);
+extern VriResult BACKEND_FN(tile_heap_create)(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap);
+extern void      BACKEND_FN(tile_heap_destroy)(VriDevice device, VriTileHeap tile_heap);
+extern VriResult BACKEND_FN(fence_create)(VriDevice device, uint64_t initial_value, VriFence *p_fence);
+extern void      BACKEND_FN(fence_destroy)(VriDevice device, VriFence fence);
+extern uint64_t  BACKEND_FN(fence_get_value)(VriDevice device, VriFence fence);
+extern VriResult BACKEND_FN(fences_wait)(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns);
+extern VriResult BACKEND_FN(swapchain_create)(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain);
+extern void      BACKEND_FN(swapchain_destroy)(VriDevice device, VriSwapchain swapchain);
+extern VriResult BACKEND_FN(swapchain_acquire_next_image)(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index);
+extern VriResult BACKEND_FN(swapchain_present)(VriDevice device, VriSwapchain swapchain, VriFence fence);
+extern VriResult BACKEND_FN(swapchain_get_texture)(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture);
+extern VriResult BACKEND_FN(swapchain_get_stats)(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats);
+extern VriResult BACKEND_FN(command_buffer_begin)(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc);
+extern VriResult BACKEND_FN(command_buffer_end)(VriCommandBuffer command_buffer);
+extern VriResult BACKEND_FN(command_buffer_reset)(VriCommandBuffer command_buffer);
+extern void      BACKEND_FN(cmd_bind_pipeline)(VriCommandBuffer command_buffer, VriPipeline pipeline);
+extern void      BACKEND_FN(cmd_update_texture)(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc);
+extern void      BACKEND_FN(cmd_generate_mips)(VriCommandBuffer command_buffer, VriTexture texture);
+extern void      BACKEND_FN(cmd_copy_texture)(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc);
+extern void      BACKEND_FN(cmd_set_viewport)(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports);
+extern void      BACKEND_FN(cmd_set_scissor)(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors);
+extern void      BACKEND_FN(cmd_set_stencil_reference)(VriCommandBuffer command_buffer, uint32_t reference);
+extern void      BACKEND_FN(cmd_set_blend_constants)(VriCommandBuffer command_buffer, const float blend_constants[4]);
+extern void      BACKEND_FN(cmd_set_depth_bias)(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor);
+extern VriResult BACKEND_FN(queue_submit)(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count);
+extern VriResult BACKEND_FN(queue_wait_idle)(VriQueue queue);
+extern VriResult BACKEND_FN(queue_present)(VriQueue queue, const VriQueuePresentDesc *p_present);
+extern VriResult BACKEND_FN(queue_bind_sparse)(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count);
+
+#    define DEVICE_CALL(device, name)                 BACKEND_FN(name)
+#    define COMMAND_BUFFER_CALL(command_buffer, name) BACKEND_FN(name)
+#    define QUEUE_CALL(queue, name)                   BACKEND_FN(name)
+#else
+#    define DEVICE_CALL(device, name)                 (device)->dispatch.pfn_##name
+#    define COMMAND_BUFFER_CALL(command_buffer, name) (command_buffer)->dispatch.pfn_##name
+#    define QUEUE_CALL(queue, name)                   (queue)->dispatch.pfn_##name
+#endif
+
 // Rest of the forward declarations
+#if (VRI_ENABLE_D3D11_SUPPORT || VRI_ENABLE_D3D12_SUPPORT)
 static VriGpuVendor get_vendor_from_id(uint32_t vendor_id);
 static int          sort_adapters(const void *a, const void *b);
-static void         setup_callbacks(VriDeviceDesc *p_desc);
-static void         finish_device_creation(VriDeviceDesc *p_desc, VriDevice *p_device);
-static void        *default_allocator_allocate(size_t size, size_t alignment);
-static void         default_allocator_free(void *p_memory, size_t size, size_t alignment);
-static void         default_message_callback(VriMessageSeverity severity, const char *p_message);
+#endif
+static void               setup_callbacks(VriDeviceDesc *p_desc);
+static void               finish_device_creation(VriDeviceDesc *p_desc, VriDevice *p_device);
+static void              *default_allocator_allocate(size_t size, size_t alignment, VriAllocationScope scope);
+static void               default_allocator_free(void *p_memory, size_t size, size_t alignment, VriAllocationScope scope);
+static void               default_message_callback(VriMessageSeverity severity, const char *p_message);
+static void               end_statistics_frame(VriDevice device);
+static VriBool            is_device_owned(VriObjectType type);
+static void               report_live_object(void *p_user_data, VriObjectBase *object);
+#if VRI_ENABLE_OBJECT_TRACKING
+static void               track_creation(void *object, const void *p_site);
+#endif
+static size_t             object_alignment(VriObjectType type);
 
 void vri_object_base_init(VriDevice device, VriObjectBase *base, VriObjectType type) {
     base->type = type;
+    base->capture_id = 0;
     base->p_device = device;
+#if VRI_ENABLE_OBJECT_TRACKING
+    base->p_create_site = NULL;
+#endif
 }
 
 void *vri_object_allocate(VriDevice device, const VriAllocationCallback *alloc, size_t size, VriObjectType type) {
-    void *ptr = alloc->pfn_allocate(size, 8);
-    if (ptr == NULL) return NULL;
+    // Everything but the device itself comes out of the device's pools
+    void    *ptr = NULL;
+    uint32_t generation = 0;
+    if (type == VRI_OBJECT_TYPE_DEVICE) {
+        ptr = alloc->pfn_allocate(size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_DEVICE);
+    } else {
+        ptr = vri_object_pool_allocate(&device->object_pools[type], alloc, size, object_alignment(type));
+
+        // The slot's generation survives its reuse, the device's memory is fresh and starts at 0
+        if (ptr) generation = ((VriObjectBase *)ptr)->generation;
+    }
+    if (ptr == NULL) {
+        if (type != VRI_OBJECT_TYPE_DEVICE && !vri_object_pool_owns(&device->object_pools[type], size)) {
+            char message[192];
+            snprintf(message, sizeof(message), "A %llu byte %s doesn't fit its pool's %llu byte slots, every object of a type has to be allocated at one size",
+                     (unsigned long long)size,
+                     vri_object_type_name(type), (unsigned long long)device->object_pools[type].slot_size);
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, message);
+        }
+        return NULL;
+    }
 
     memset(ptr, 0, size);
 
+    // The device is its own parent, which is also where its allocation gets counted
+    if (type == VRI_OBJECT_TYPE_DEVICE) {
+        device = (VriDevice)ptr;
+    }
+
     vri_object_base_init(device, (VriObjectBase *)ptr, type);
+    ((VriObjectBase *)ptr)->generation = generation;
+
+    VRI_STAT_ADD(device, allocation_count[type], 1);
+    VRI_STAT_ADD(device, allocation_bytes[type], size);
+
     return ptr;
 }
 
+void vri_object_free(VriDevice device, const VriAllocationCallback *alloc, void *object, size_t size) {
+    VriObjectType type = ((VriObjectBase *)object)->type;
+
+    VRI_STAT_ADD(device, free_count[type], 1);
+    VRI_STAT_ADD(device, free_bytes[type], size);
+
+    if (type != VRI_OBJECT_TYPE_DEVICE && vri_object_pool_owns(&device->object_pools[type], size)) {
+        vri_object_pool_free(&device->object_pools[type], object);
+    } else {
+        alloc->pfn_free(object, size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_DEVICE);
+    }
+}
+
+const char *vri_object_type_name(VriObjectType type) {
+    static const char *names[VRI_OBJECT_TYPE_COUNT] = {
+        [VRI_OBJECT_TYPE_DEVICE] = "device",
+        [VRI_OBJECT_TYPE_COMMAND_POOL] = "command pool",
+        [VRI_OBJECT_TYPE_COMMAND_BUFFER] = "command buffer",
+        [VRI_OBJECT_TYPE_QUEUE] = "queue",
+        [VRI_OBJECT_TYPE_PIPELINE_LAYOUT] = "pipeline layout",
+        [VRI_OBJECT_TYPE_PIPELINE] = "pipeline",
+        [VRI_OBJECT_TYPE_TEXTURE] = "texture",
+        [VRI_OBJECT_TYPE_FENCE] = "fence",
+        [VRI_OBJECT_TYPE_SWAPCHAIN] = "swapchain",
+        [VRI_OBJECT_TYPE_SHADER_MODULE] = "shader module",
+        [VRI_OBJECT_TYPE_UPLOAD_QUEUE] = "upload queue",
+        [VRI_OBJECT_TYPE_STREAM_QUEUE] = "stream queue",
+        [VRI_OBJECT_TYPE_TILE_HEAP] = "tile heap",
+        [VRI_OBJECT_TYPE_EVICTION_MANAGER] = "eviction manager",
+        [VRI_OBJECT_TYPE_READBACK_RING] = "readback ring",
+        [VRI_OBJECT_TYPE_PIPELINE_LIBRARY] = "pipeline library",
+        [VRI_OBJECT_TYPE_PIPELINE_MANIFEST] = "pipeline manifest",
+    };
+    return (uint32_t)type < VRI_OBJECT_TYPE_COUNT ? names[type] : "unknown object";
+}
+
+uint64_t vri_live_objects_report(VriDevice device, VriMessageSeverity severity) {
+    VriLiveObjects live;
+    vri_device_get_live_objects(device, &live);
+
+    // The device and its queues live exactly as long as the device, they're never a leak
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        if (!is_device_owned((VriObjectType)i)) {
+            count += live.count[i];
+            bytes += live.bytes[i];
+        }
+    }
+    if (!count) return 0;
+
+    PFN_VriMessageCallback pfn_message = device->debug_callback.pfn_message_callback;
+    char                   message[256];
+
+    snprintf(message, sizeof(message), "[Live objects] %llu objects, %llu bytes", (unsigned long long)count, (unsigned long long)bytes);
+    pfn_message(severity, message);
+
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        if (is_device_owned((VriObjectType)i) || !live.count[i]) continue;
+
+        snprintf(message, sizeof(message), "[Live objects]   %s: %llu, %llu bytes", vri_object_type_name((VriObjectType)i),
+                 (unsigned long long)live.count[i], (unsigned long long)live.bytes[i]);
+        pfn_message(severity, message);
+
+        vri_object_pool_for_each(&device->object_pools[i], report_live_object, &severity);
+    }
+
+    return count;
+}
+
+uint64_t vri_time_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Split to avoid overflowing on long uptimes
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ull + (remainder * 1000000000ull) / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void vri_spinlock_lock(VriSpinlock *lock) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    while (_InterlockedExchange(&lock->locked, 1)) {
+        while (lock->locked) {
+            _mm_pause();
+        }
+    }
+#else
+    while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED)) {
+        }
+    }
+#endif
+}
+
+VriBool vri_spinlock_try_lock(VriSpinlock *lock) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return !lock->locked && !_InterlockedExchange(&lock->locked, 1);
+#else
+    return !__atomic_load_n(&lock->locked, __ATOMIC_RELAXED) && !__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void vri_spinlock_unlock(VriSpinlock *lock) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchange(&lock->locked, 0);
+#else
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+#endif
+}
+
 #if (VRI_ENABLE_D3D11_SUPPORT || VRI_ENABLE_D3D12_SUPPORT)
 static VriResult d3d_enum_adapters(VriAdapterProps *p_descs, uint32_t *p_desc_count) {
     IDXGIFactory4 *dxgi_factory = NULL;
@@ -182,10 +440,20 @@ VriResult vri_adapters_enumerate(VriAdapterProps *p_descs, uint32_t *p_desc_coun
             *p_desc_count = 1;
         }
 
+        // A single headless adapter with every queue type available
+        if (*p_desc_count == 1) {
+            p_descs[0] = (VriAdapterProps){0};
+            for (uint32_t i = 0; i < VRI_QUEUE_TYPE_COUNT; ++i) {
+                p_descs[0].queue_count[i] = MAX_QUEUES_PER_TYPE;
+            }
+        }
+
         result = VRI_SUCCESS;
     }
 #endif
 
+    (void)p_descs;
+    (void)p_desc_count;
     return result;
 }
 
@@ -200,13 +468,18 @@ void vri_report_live_objects(void) {
 }
 
 VriResult vri_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device) {
-    VriResult result = VRI_SUCCESS;
+    VriResult result = VRI_ERROR_UNSUPPORTED;
 
     VriDeviceDesc mod_desc = *p_desc;
     setup_callbacks(&mod_desc);
 
+    // Reject unknown layers before the backend gets to create anything
+    result = vri_layers_validate(&mod_desc);
+    if (VRI_ERROR(result)) return result;
+    result = VRI_ERROR_UNSUPPORTED;
+
 #if VRI_ENABLE_NONE_SUPPORT
-    if (mod_desc.gpu_api == VRI_GPU_API_NONE)
+    if (mod_desc.backend == VRI_BACKEND_NONE)
         result = none_device_create(&mod_desc, p_device);
 #endif
 
@@ -229,6 +502,20 @@ VriResult vri_device_create(const VriDeviceDesc *p_desc, VriDevice *p_device) {
 
     finish_device_creation(&mod_desc, p_device);
 
+#if VRI_SINGLE_BACKEND
+    if (mod_desc.enabled_layer_count || mod_desc.enable_api_validation) {
+        mod_desc.debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_WARNING, "Layers aren't available with VRI_SINGLE_BACKEND, none were installed");
+    }
+#else
+    result = vri_layers_install(&mod_desc, *p_device);
+    if (VRI_ERROR(result)) {
+        vri_device_destroy(*p_device);
+        *p_device = NULL;
+        return result;
+    }
+#endif
+
+    TRACK_CREATION(*p_device);
     return VRI_SUCCESS;
 }
 
@@ -241,112 +528,340 @@ void vri_device_get_queue(VriDevice device, VriQueueType queue_type, uint32_t qu
     }
 }
 
+VriResult vri_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget) {
+    return DEVICE_CALL(device, device_query_memory_budget)(device, p_budget);
+}
+
+void vri_device_get_statistics(VriDevice device, VriDeviceStatistics *p_statistics) {
+    // The counter structs are nothing but uint64_t, so they can be walked as arrays
+    const uint32_t  counter_count = sizeof(VriStatisticsCounters) / sizeof(uint64_t);
+    const uint64_t *total = (const uint64_t *)&device->stats;
+    const uint64_t *last_frame = (const uint64_t *)&device->stats_last_frame;
+    uint64_t       *out_total = (uint64_t *)&p_statistics->total;
+    uint64_t       *out_last_frame = (uint64_t *)&p_statistics->last_frame;
+
+    for (uint32_t i = 0; i < counter_count; ++i) {
+        out_total[i] = VRI_ATOMIC_LOAD_U64(&total[i]);
+        out_last_frame[i] = VRI_ATOMIC_LOAD_U64(&last_frame[i]);
+    }
+
+    p_statistics->frame_count = VRI_ATOMIC_LOAD_U64(&device->stats_frame_count);
+}
+
+void vri_device_get_live_objects(VriDevice device, VriLiveObjects *p_live_objects) {
+    const VriStatisticsCounters *stats = &device->stats;
+
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        p_live_objects->count[i] = VRI_ATOMIC_LOAD_U64(&stats->allocation_count[i]) - VRI_ATOMIC_LOAD_U64(&stats->free_count[i]);
+        p_live_objects->bytes[i] = VRI_ATOMIC_LOAD_U64(&stats->allocation_bytes[i]) - VRI_ATOMIC_LOAD_U64(&stats->free_bytes[i]);
+    }
+
+    p_live_objects->pool_bytes = 0;
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        p_live_objects->pool_bytes += vri_object_pool_reserved_bytes(&device->object_pools[i]);
+    }
+}
+
+void vri_device_report_live_objects(VriDevice device) {
+    if (!vri_live_objects_report(device, VRI_MESSAGE_SEVERITY_INFO)) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_INFO, "[Live objects] None");
+    }
+}
+
 // Calling Device table
 void vri_device_destroy(VriDevice device) {
-    device->dispatch.pfn_device_destroy(device);
+    vri_pipelines_warm_release(device);
+    DEVICE_CALL(device, device_destroy)(device);
 }
 
 VriResult vri_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool) {
-    return device->dispatch.pfn_command_pool_create(device, p_desc, p_command_pool);
+    VriResult result = DEVICE_CALL(device, command_pool_create)(device, p_desc, p_command_pool);
+    if (VRI_OK(result)) TRACK_CREATION(*p_command_pool);
+    return result;
 }
 
 void vri_command_pool_destroy(VriDevice device, VriCommandPool command_pool) {
-    device->dispatch.pfn_command_pool_destroy(device, command_pool);
+    DEVICE_CALL(device, command_pool_destroy)(device, command_pool);
 }
 
 void vri_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags) {
-    device->dispatch.pfn_command_pool_reset(device, command_pool, flags);
+    DEVICE_CALL(device, command_pool_reset)(device, command_pool, flags);
 }
 
 VriResult vri_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
-    return device->dispatch.pfn_command_buffers_allocate(device, p_desc, p_command_buffers);
+    VriResult result = DEVICE_CALL(device, command_buffers_allocate)(device, p_desc, p_command_buffers);
+    if (VRI_OK(result)) {
+        for (uint32_t i = 0; i < p_desc->command_buffer_count; ++i) {
+            TRACK_CREATION(p_command_buffers[i]);
+        }
+    }
+    return result;
 }
 
 void vri_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
-    device->dispatch.pfn_command_buffers_free(device, command_pool, command_buffer_count, p_command_buffers);
+    DEVICE_CALL(device, command_buffers_free)(device, command_pool, command_buffer_count, p_command_buffers);
+}
+
+VriResult vri_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    VriResult result = DEVICE_CALL(device, shader_module_create)(device, p_desc, p_shader_module);
+    if (VRI_OK(result)) TRACK_CREATION(*p_shader_module);
+    return result;
+}
+
+void vri_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    DEVICE_CALL(device, shader_module_destroy)(device, shader_module);
 }
 
 VriResult vri_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
-    return device->dispatch.pfn_pipeline_layout_create(device, p_desc, p_pipeline_layout);
+    return DEVICE_CALL(device, pipeline_layout_create)(device, p_desc, p_pipeline_layout);
 }
 
+// Descs are only hashed while a pipeline manifest records or warm pipelines are left
 VriResult vri_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
-    return device->dispatch.pfn_pipeline_create_graphics(device, p_desc, p_pipeline);
+    uint64_t  hash = VRI_ATOMIC_LOAD_U64(&device->pipeline_manifest.active) ? vri_pipeline_manifest_hash_graphics(device, p_desc) : 0;
+    VriResult result = VRI_SUCCESS;
+    if (!hash || !vri_pipeline_warm_take(device, hash, p_pipeline)) {
+        result = DEVICE_CALL(device, pipeline_create_graphics)(device, p_desc, p_pipeline);
+        if (VRI_OK(result)) TRACK_CREATION(*p_pipeline);
+    }
+    if (VRI_OK(result) && hash) vri_pipeline_manifest_record_graphics(device, hash, p_desc);
+    return result;
 }
 
 VriResult vri_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
-    return device->dispatch.pfn_pipeline_create_compute(device, p_desc, p_pipeline);
+    uint64_t  hash = VRI_ATOMIC_LOAD_U64(&device->pipeline_manifest.active) ? vri_pipeline_manifest_hash_compute(device, p_desc) : 0;
+    VriResult result = VRI_SUCCESS;
+    if (!hash || !vri_pipeline_warm_take(device, hash, p_pipeline)) {
+        result = DEVICE_CALL(device, pipeline_create_compute)(device, p_desc, p_pipeline);
+        if (VRI_OK(result)) TRACK_CREATION(*p_pipeline);
+    }
+    if (VRI_OK(result) && hash) vri_pipeline_manifest_record_compute(device, hash, p_desc);
+    return result;
+}
+
+VriResult vri_warm_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = DEVICE_CALL(device, pipeline_create_graphics)(device, p_desc, p_pipeline);
+    if (VRI_OK(result)) TRACK_CREATION(*p_pipeline);
+    return result;
+}
+
+VriResult vri_warm_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = DEVICE_CALL(device, pipeline_create_compute)(device, p_desc, p_pipeline);
+    if (VRI_OK(result)) TRACK_CREATION(*p_pipeline);
+    return result;
+}
+
+void vri_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    DEVICE_CALL(device, pipeline_destroy)(device, pipeline);
+}
+
+VriResult vri_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    VriResult result = DEVICE_CALL(device, pipeline_library_create)(device, p_desc, p_library);
+    if (VRI_OK(result)) TRACK_CREATION(*p_library);
+    return result;
+}
+
+void vri_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    DEVICE_CALL(device, pipeline_library_destroy)(device, library);
+}
+
+VriResult vri_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = DEVICE_CALL(device, pipeline_link)(device, p_desc, p_pipeline);
+    if (VRI_OK(result)) TRACK_CREATION(*p_pipeline);
+    return result;
 }
 
 VriResult vri_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
-    return device->dispatch.pfn_texture_create(device, p_desc, p_texture);
+    VriResult result = DEVICE_CALL(device, texture_create)(device, p_desc, p_texture);
+    if (VRI_OK(result)) TRACK_CREATION(*p_texture);
+    return result;
 }
 
 void vri_texture_destroy(VriDevice device, VriTexture texture) {
-    device->dispatch.pfn_texture_destroy(device, texture);
+    DEVICE_CALL(device, texture_destroy)(device, texture);
+}
+
+void vri_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling) {
+    DEVICE_CALL(device, texture_get_tiling)(device, texture, p_tiling);
+}
+
+VriResult vri_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed) {
+    return DEVICE_CALL(device, texture_get_tile_feedback)(device, texture, tile_count, p_accessed);
+}
+
+VriResult vri_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    return DEVICE_CALL(device, texture_map)(device, texture, mip_level, array_layer, p_data);
+}
+
+void vri_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer) {
+    DEVICE_CALL(device, texture_unmap)(device, texture, mip_level, array_layer);
+}
+
+VriResult vri_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    VriResult result = DEVICE_CALL(device, tile_heap_create)(device, p_desc, p_tile_heap);
+    if (VRI_OK(result)) TRACK_CREATION(*p_tile_heap);
+    return result;
+}
+
+void vri_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    DEVICE_CALL(device, tile_heap_destroy)(device, tile_heap);
 }
 
 VriResult vri_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
-    return device->dispatch.pfn_fence_create(device, initial_value, p_fence);
+    VriResult result = DEVICE_CALL(device, fence_create)(device, initial_value, p_fence);
+    if (VRI_OK(result)) TRACK_CREATION(*p_fence);
+    return result;
 }
 
 void vri_fence_destroy(VriDevice device, VriFence fence) {
-    device->dispatch.pfn_fence_destroy(device, fence);
+    DEVICE_CALL(device, fence_destroy)(device, fence);
 }
 
 uint64_t vri_fence_get_value(VriDevice device, VriFence fence) {
-    return device->dispatch.pfn_fence_get_value(device, fence);
+    return DEVICE_CALL(device, fence_get_value)(device, fence);
 }
 
 VriResult vri_fences_wait(VriDevice device, VriFence *p_fences, uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
-    return device->dispatch.pfn_fences_wait(device, p_fences, p_values, fence_count, wait_all, timeout_ns);
+    VRI_STAT_ADD(device, fence_waits, 1);
+    return DEVICE_CALL(device, fences_wait)(device, p_fences, p_values, fence_count, wait_all, timeout_ns);
 }
 
 VriResult vri_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
-    return device->dispatch.pfn_swapchain_create(device, p_desc, p_swapchain);
+    VriResult result = DEVICE_CALL(device, swapchain_create)(device, p_desc, p_swapchain);
+    if (VRI_OK(result)) TRACK_CREATION(*p_swapchain);
+    return result;
 }
 
 void vri_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
-    device->dispatch.pfn_swapchain_destroy(device, swapchain);
+    DEVICE_CALL(device, swapchain_destroy)(device, swapchain);
 }
 
 VriResult vri_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
-    return device->dispatch.pfn_swapchain_acquire_next_image(device, swapchain, fence, signal_value, p_image_index);
+    return DEVICE_CALL(device, swapchain_acquire_next_image)(device, swapchain, fence, signal_value, p_image_index);
 }
 
 VriResult vri_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
-    return device->dispatch.pfn_swapchain_present(device, swapchain, fence);
+    VriResult result = DEVICE_CALL(device, swapchain_present)(device, swapchain, fence);
+    if (VRI_OK(result)) {
+        VRI_STAT_ADD(device, presents, 1);
+        end_statistics_frame(device);
+    }
+    return result;
+}
+
+VriResult vri_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    return DEVICE_CALL(device, swapchain_get_texture)(device, swapchain, image_index, p_texture);
+}
+
+VriResult vri_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats) {
+    return DEVICE_CALL(device, swapchain_get_stats)(device, swapchain, p_stats);
 }
 
 // Calling Command Buffer table
 VriResult vri_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
-    return command_buffer->dispatch.pfn_command_buffer_begin(command_buffer, p_desc);
+    command_buffer->stats = (VriCommandBufferStatistics){0};
+    return COMMAND_BUFFER_CALL(command_buffer, command_buffer_begin)(command_buffer, p_desc);
 }
 
 VriResult vri_command_buffer_end(VriCommandBuffer command_buffer) {
-    return command_buffer->dispatch.pfn_command_buffer_end(command_buffer);
+    VriResult result = COMMAND_BUFFER_CALL(command_buffer, command_buffer_end)(command_buffer);
+    if (VRI_OK(result)) {
+        // Fold the per command buffer counters into the device in one go
+        VriDevice                   device = command_buffer->base.p_device;
+        VriCommandBufferStatistics *stats = &command_buffer->stats;
+
+        VRI_STAT_ADD(device, command_buffers_recorded, 1);
+        VRI_STAT_ADD(device, commands_recorded, stats->command_count);
+        VRI_STAT_ADD(device, pipeline_binds, stats->pipeline_binds);
+        VRI_STAT_ADD(device, pipeline_binds_redundant, stats->pipeline_binds_redundant);
+    }
+    return result;
 }
 
 VriResult vri_command_buffer_reset(VriCommandBuffer command_buffer) {
-    return command_buffer->dispatch.pfn_command_buffer_reset(command_buffer);
+    return COMMAND_BUFFER_CALL(command_buffer, command_buffer_reset)(command_buffer);
 }
 
 void vri_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
-    command_buffer->dispatch.pfn_cmd_bind_pipeline(command_buffer, pipeline);
+    command_buffer->stats.command_count++;
+    command_buffer->stats.pipeline_binds++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_bind_pipeline)(command_buffer, pipeline);
+}
+
+void vri_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_update_texture)(command_buffer, texture, p_desc);
+}
+
+void vri_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_generate_mips)(command_buffer, texture);
+}
+
+void vri_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_copy_texture)(command_buffer, src, dst, p_desc);
+}
+
+void vri_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_set_viewport)(command_buffer, first_viewport, viewport_count, p_viewports);
+}
+
+void vri_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_set_scissor)(command_buffer, first_scissor, scissor_count, p_scissors);
+}
+
+void vri_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_set_stencil_reference)(command_buffer, reference);
+}
+
+void vri_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_set_blend_constants)(command_buffer, blend_constants);
+}
+
+void vri_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    command_buffer->stats.command_count++;
+    COMMAND_BUFFER_CALL(command_buffer, cmd_set_depth_bias)(command_buffer, constant_factor, clamp, slope_factor);
 }
 
 VriResult vri_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
-    return queue->dispatch.pfn_queue_submit(queue, p_submits, submit_count);
+    VriResult result = QUEUE_CALL(queue, queue_submit)(queue, p_submits, submit_count);
+    if (VRI_OK(result)) {
+        uint64_t command_buffer_count = 0;
+        for (uint32_t i = 0; i < submit_count; ++i) {
+            command_buffer_count += p_submits[i].command_buffer_count;
+        }
+
+        VriDevice device = queue->base.p_device;
+        VRI_STAT_ADD(device, queue_submits, submit_count);
+        VRI_STAT_ADD(device, command_buffers_submitted, command_buffer_count);
+    }
+    return result;
 }
 
 VriResult vri_queue_wait_idle(VriQueue queue) {
-    return queue->dispatch.pfn_queue_wait_idle(queue);
+    return QUEUE_CALL(queue, queue_wait_idle)(queue);
 }
 
 VriResult vri_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present) {
-    return queue->dispatch.pfn_queue_present(queue, p_present);
+    VriResult result = QUEUE_CALL(queue, queue_present)(queue, p_present);
+    if (VRI_OK(result)) {
+        VriDevice device = queue->base.p_device;
+        VRI_STAT_ADD(device, presents, p_present->swapchain_count);
+        end_statistics_frame(device);
+    }
+    return result;
 }
 
+VriResult vri_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    return QUEUE_CALL(queue, queue_bind_sparse)(queue, p_binds, bind_count);
+}
+
+#if (VRI_ENABLE_D3D11_SUPPORT || VRI_ENABLE_D3D12_SUPPORT)
 static VriGpuVendor get_vendor_from_id(uint32_t vendor_id) {
     switch (vendor_id) {
         case 0x10DE:
@@ -380,6 +895,8 @@ static int sort_adapters(const void *a, const void *b) {
     return 0;
 }
 
+#endif
+
 static void setup_callbacks(VriDeviceDesc *p_desc) {
     if (!p_desc->allocation_callback.pfn_allocate || !p_desc->allocation_callback.pfn_free) {
         p_desc->allocation_callback.pfn_allocate = default_allocator_allocate;
@@ -394,19 +911,42 @@ static void setup_callbacks(VriDeviceDesc *p_desc) {
 static void finish_device_creation(VriDeviceDesc *p_desc, VriDevice *p_device) {
     (*p_device)->allocation_callback = p_desc->allocation_callback;
     (*p_device)->debug_callback = p_desc->debug_callback;
-    (*p_device)->adapter_props = *p_desc->p_adapter_props;
+    if (p_desc->p_adapter_props) {
+        (*p_device)->adapter_props = *p_desc->p_adapter_props;
+    }
     (*p_device)->enable_api_validation = p_desc->enable_api_validation;
 }
 
-static void *default_allocator_allocate(size_t size, size_t alignment) {
-    (void)alignment;
-    return malloc(size);
+// Command buffers are recorded on different threads and write their statistics
+// shards on every command, so they get a cache line each
+static size_t object_alignment(VriObjectType type) {
+    return type == VRI_OBJECT_TYPE_COMMAND_BUFFER ? VRI_CACHE_LINE_SIZE : 16;
+}
+
+static void *default_allocator_allocate(size_t size, size_t alignment, VriAllocationScope scope) {
+    (void)scope;
+
+    // Both aligned allocators want at least pointer alignment, and a power of two
+    alignment = VRI_MAX(alignment, sizeof(void *));
+    if (alignment & (alignment - 1)) return NULL;
+
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void *p_memory = NULL;
+    return posix_memalign(&p_memory, alignment, size) == 0 ? p_memory : NULL;
+#endif
 }
 
-static void default_allocator_free(void *p_memory, size_t size, size_t alignment) {
+static void default_allocator_free(void *p_memory, size_t size, size_t alignment, VriAllocationScope scope) {
     (void)size;
     (void)alignment;
+    (void)scope;
+#if defined(_WIN32)
+    _aligned_free(p_memory);
+#else
     free(p_memory);
+#endif
 }
 
 static void default_message_callback(VriMessageSeverity severity, const char *p_message) {
@@ -414,3 +954,53 @@ static void default_message_callback(VriMessageSeverity severity, const char *p_
     (void)p_message;
     // NO-OP
 }
+
+// Called once per present, so the per-frame numbers are just the difference
+// between the running totals at the last two frame boundaries.
+static void end_statistics_frame(VriDevice device) {
+    const uint32_t  counter_count = sizeof(VriStatisticsCounters) / sizeof(uint64_t);
+    const uint64_t *total = (const uint64_t *)&device->stats;
+    uint64_t       *frame_start = (uint64_t *)&device->stats_frame_start;
+    uint64_t       *last_frame = (uint64_t *)&device->stats_last_frame;
+
+    // Presents on other threads can end a frame at the same time, each takes
+    // the boundary the other left. Counters only grow, so a delta that would
+    // wrap means the other thread published a later boundary first.
+    for (uint32_t i = 0; i < counter_count; ++i) {
+        uint64_t now = VRI_ATOMIC_LOAD_U64(&total[i]);
+        uint64_t start = VRI_ATOMIC_EXCHANGE_U64(&frame_start[i], now);
+        VRI_ATOMIC_STORE_U64(&last_frame[i], now >= start ? now - start : 0);
+    }
+
+    VRI_ATOMIC_ADD_U64(&device->stats_frame_count, 1);
+}
+
+static VriBool is_device_owned(VriObjectType type) {
+    return type == VRI_OBJECT_TYPE_DEVICE || type == VRI_OBJECT_TYPE_QUEUE;
+}
+
+static void report_live_object(void *p_user_data, VriObjectBase *object) {
+    VriMessageSeverity severity = *(const VriMessageSeverity *)p_user_data;
+    char               message[256];
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    if (object->p_create_site) {
+        snprintf(message, sizeof(message), "[Live objects]     %s %p, created at %p", vri_object_type_name(object->type), (void *)object,
+                 (void *)(uintptr_t)object->p_create_site);
+    } else {
+        snprintf(message, sizeof(message), "[Live objects]     %s %p, created internally", vri_object_type_name(object->type), (void *)object);
+    }
+#else
+    snprintf(message, sizeof(message), "[Live objects]     %s %p", vri_object_type_name(object->type), (void *)object);
+#endif
+
+    object->p_device->debug_callback.pfn_message_callback(severity, message);
+}
+
+#if VRI_ENABLE_OBJECT_TRACKING
+static void track_creation(void *object, const void *p_site) {
+    if (object) {
+        ((VriObjectBase *)object)->p_create_site = p_site;
+    }
+}
+#endif
@@ -0,0 +1,935 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <string.h>
+
+// CPU-side BC1 to BC7 conversion. A block is always worked on as sixteen
+// texels in a local array, and the inner loops run over all sixteen without
+// branches, so the compiler can vectorize them. That gets the baseline ISA the
+// library is built for, SSE2 on x64, so with GCC and Clang on x86 the costly
+// encoders are compiled a second time for AVX2 and picked at run time on CPUs
+// that have it. Edge blocks are padded by clamping on the way in and only
+// write the texels inside the image on the way out.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define BC_AVX2        1
+#    define BC_INLINE      __attribute__((always_inline)) inline
+#    define BC_TARGET_AVX2 __attribute__((target("avx2")))
+#    define BC_HAS_AVX2()  __builtin_cpu_supports("avx2")
+#    define BC_ENCODER(name, avx2) ((avx2) ? bc_encode_##name##_avx2 : bc_encode_##name)
+#else
+#    define BC_AVX2        0
+#    define BC_INLINE      inline
+#    define BC_HAS_AVX2()  VRI_FALSE
+#    define BC_ENCODER(name, avx2) ((void)(avx2), bc_encode_##name)
+#endif
+
+#define BC_TEXELS 16
+
+typedef void (*PFN_BcBlock)(const uint8_t *p_block, uint8_t *p_texels);
+
+// A 128 bit block read or written from its least significant bit up
+typedef struct {
+    uint64_t low;
+    uint64_t high;
+    uint32_t offset;
+} BcBits;
+
+// BC6H endpoint fields: the w, x, y and z endpoints of the format's
+// description, red, green and blue for each, then the partition
+enum {
+    BC6H_RW,
+    BC6H_GW,
+    BC6H_BW,
+    BC6H_RX,
+    BC6H_GX,
+    BC6H_BX,
+    BC6H_RY,
+    BC6H_GY,
+    BC6H_BY,
+    BC6H_RZ,
+    BC6H_GZ,
+    BC6H_BZ,
+    BC6H_D,
+    BC6H_FIELD_COUNT
+};
+
+// count bits of the stream that land in field from bit shift up
+typedef struct {
+    uint8_t field;
+    uint8_t shift;
+    uint8_t count;
+} Bc6hRun;
+
+typedef struct {
+    uint8_t mode;        // Two mode bits for the first two modes, five for the rest
+    uint8_t transformed; // Endpoints after the first are stored as deltas from it
+    uint8_t endpoint_bits;
+    uint8_t delta_bits[3];
+    Bc6hRun runs[24]; // The fields after the mode bits in stream order, up to a run of 0 bits
+} Bc6hMode;
+
+typedef struct {
+    uint8_t subsets;
+    uint8_t partition_bits;
+    uint8_t rotation_bits;
+    uint8_t selector_bits; // Mode 4's choice of which index set the color uses
+    uint8_t color_bits;
+    uint8_t alpha_bits;
+    uint8_t endpoint_pbits; // One p-bit per endpoint
+    uint8_t shared_pbits;   // One p-bit per subset
+    uint8_t index_bits;
+    uint8_t index2_bits; // Second index set, for alpha unless the selector swaps them
+} Bc7Mode;
+
+#define RUN(field, shift, count) {BC6H_##field, shift, count}
+
+// The bit layouts of the fourteen BC6H modes, from the D3D11 functional spec
+static const Bc6hMode bc6h_modes[] = {
+    {0, 1, 10, {5, 5, 5}, {RUN(GY, 4, 1), RUN(BY, 4, 1), RUN(BZ, 4, 1), RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 5), RUN(GZ, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 5), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 5), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 5), RUN(BZ, 2, 1), RUN(RZ, 0, 5), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {1, 1, 7, {6, 6, 6}, {RUN(GY, 5, 1), RUN(GZ, 4, 1), RUN(GZ, 5, 1), RUN(RW, 0, 7), RUN(BZ, 0, 1), RUN(BZ, 1, 1), RUN(BY, 4, 1), RUN(GW, 0, 7), RUN(BY, 5, 1), RUN(BZ, 2, 1), RUN(GY, 4, 1), RUN(BW, 0, 7), RUN(BZ, 3, 1), RUN(BZ, 5, 1), RUN(BZ, 4, 1), RUN(RX, 0, 6), RUN(GY, 0, 4), RUN(GX, 0, 6), RUN(GZ, 0, 4), RUN(BX, 0, 6), RUN(BY, 0, 4), RUN(RY, 0, 6), RUN(RZ, 0, 6), RUN(D, 0, 5)}},
+    {2, 1, 11, {5, 4, 4}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 5), RUN(RW, 10, 1), RUN(GY, 0, 4), RUN(GX, 0, 4), RUN(GW, 10, 1), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 4), RUN(BW, 10, 1), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 5), RUN(BZ, 2, 1), RUN(RZ, 0, 5), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {6, 1, 11, {4, 5, 4}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 4), RUN(RW, 10, 1), RUN(GZ, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 5), RUN(GW, 10, 1), RUN(GZ, 0, 4), RUN(BX, 0, 4), RUN(BW, 10, 1), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 4), RUN(BZ, 0, 1), RUN(BZ, 2, 1), RUN(RZ, 0, 4), RUN(GY, 4, 1), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {10, 1, 11, {4, 4, 5}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 4), RUN(RW, 10, 1), RUN(BY, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 4), RUN(GW, 10, 1), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 5), RUN(BW, 10, 1), RUN(BY, 0, 4), RUN(RY, 0, 4), RUN(BZ, 1, 1), RUN(BZ, 2, 1), RUN(RZ, 0, 4), RUN(BZ, 4, 1), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {14, 1, 9, {5, 5, 5}, {RUN(RW, 0, 9), RUN(BY, 4, 1), RUN(GW, 0, 9), RUN(GY, 4, 1), RUN(BW, 0, 9), RUN(BZ, 4, 1), RUN(RX, 0, 5), RUN(GZ, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 5), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 5), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 5), RUN(BZ, 2, 1), RUN(RZ, 0, 5), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {18, 1, 8, {6, 5, 5}, {RUN(RW, 0, 8), RUN(GZ, 4, 1), RUN(BY, 4, 1), RUN(GW, 0, 8), RUN(BZ, 2, 1), RUN(GY, 4, 1), RUN(BW, 0, 8), RUN(BZ, 3, 1), RUN(BZ, 4, 1), RUN(RX, 0, 6), RUN(GY, 0, 4), RUN(GX, 0, 5), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 5), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 6), RUN(RZ, 0, 6), RUN(D, 0, 5)}},
+    {22, 1, 8, {5, 6, 5}, {RUN(RW, 0, 8), RUN(BZ, 0, 1), RUN(BY, 4, 1), RUN(GW, 0, 8), RUN(GY, 5, 1), RUN(GY, 4, 1), RUN(BW, 0, 8), RUN(GZ, 5, 1), RUN(BZ, 4, 1), RUN(RX, 0, 5), RUN(GZ, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 6), RUN(GZ, 0, 4), RUN(BX, 0, 5), RUN(BZ, 1, 1), RUN(BY, 0, 4), RUN(RY, 0, 5), RUN(BZ, 2, 1), RUN(RZ, 0, 5), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {26, 1, 8, {5, 5, 6}, {RUN(RW, 0, 8), RUN(BZ, 1, 1), RUN(BY, 4, 1), RUN(GW, 0, 8), RUN(BY, 5, 1), RUN(GY, 4, 1), RUN(BW, 0, 8), RUN(BZ, 5, 1), RUN(BZ, 4, 1), RUN(RX, 0, 5), RUN(GZ, 4, 1), RUN(GY, 0, 4), RUN(GX, 0, 5), RUN(BZ, 0, 1), RUN(GZ, 0, 4), RUN(BX, 0, 6), RUN(BY, 0, 4), RUN(RY, 0, 5), RUN(BZ, 2, 1), RUN(RZ, 0, 5), RUN(BZ, 3, 1), RUN(D, 0, 5)}},
+    {30, 0, 6, {6, 6, 6}, {RUN(RW, 0, 6), RUN(GZ, 4, 1), RUN(BZ, 0, 1), RUN(BZ, 1, 1), RUN(BY, 4, 1), RUN(GW, 0, 6), RUN(GY, 5, 1), RUN(BY, 5, 1), RUN(BZ, 2, 1), RUN(GY, 4, 1), RUN(BW, 0, 6), RUN(GZ, 5, 1), RUN(BZ, 3, 1), RUN(BZ, 5, 1), RUN(BZ, 4, 1), RUN(RX, 0, 6), RUN(GY, 0, 4), RUN(GX, 0, 6), RUN(GZ, 0, 4), RUN(BX, 0, 6), RUN(BY, 0, 4), RUN(RY, 0, 6), RUN(RZ, 0, 6), RUN(D, 0, 5)}},
+    {3, 0, 10, {10, 10, 10}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 10), RUN(GX, 0, 10), RUN(BX, 0, 10)}},
+    {7, 1, 11, {9, 9, 9}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 9), RUN(RW, 10, 1), RUN(GX, 0, 9), RUN(GW, 10, 1), RUN(BX, 0, 9), RUN(BW, 10, 1)}},
+    {11, 1, 12, {8, 8, 8}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 8), RUN(RW, 11, 1), RUN(RW, 10, 1), RUN(GX, 0, 8), RUN(GW, 11, 1), RUN(GW, 10, 1), RUN(BX, 0, 8), RUN(BW, 11, 1), RUN(BW, 10, 1)}},
+    // The high bits of the last mode's first endpoint come most significant first
+    {15, 1, 16, {4, 4, 4}, {RUN(RW, 0, 10), RUN(GW, 0, 10), RUN(BW, 0, 10), RUN(RX, 0, 4), RUN(RW, 15, 1), RUN(RW, 14, 1), RUN(RW, 13, 1), RUN(RW, 12, 1), RUN(RW, 11, 1), RUN(RW, 10, 1),
+                            RUN(GX, 0, 4), RUN(GW, 15, 1), RUN(GW, 14, 1), RUN(GW, 13, 1), RUN(GW, 12, 1), RUN(GW, 11, 1), RUN(GW, 10, 1),
+                            RUN(BX, 0, 4), RUN(BW, 15, 1), RUN(BW, 14, 1), RUN(BW, 13, 1), RUN(BW, 12, 1), RUN(BW, 11, 1), RUN(BW, 10, 1)}},
+};
+
+#undef RUN
+
+static const Bc7Mode bc7_modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+// Two subset partitions shared by BC6H and BC7, bit i set where texel i is in the second subset
+static const uint16_t bc_partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Three subset partitions, two bits per texel
+static const uint32_t bc_partitions3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// The texel whose index drops its top bit, for the second subset of a two
+// subset partition and the second and third of a three subset one. The
+// first subset's is always texel 0.
+static const uint8_t bc_anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+static const uint8_t bc_anchors3[64][2] = {
+    {3, 15}, {3, 8}, {15, 8}, {15, 3}, {8, 15}, {3, 15}, {15, 3}, {15, 8}, {8, 15}, {8, 15}, {6, 15}, {6, 15}, {6, 15}, {5, 15}, {3, 15}, {3, 8},
+    {3, 15}, {3, 8}, {8, 15}, {15, 3}, {3, 15}, {3, 8}, {6, 15}, {10, 8}, {5, 3}, {8, 15}, {8, 6}, {6, 10}, {8, 15}, {5, 15}, {15, 10}, {15, 8},
+    {8, 15}, {15, 3}, {3, 15}, {5, 10}, {6, 10}, {10, 8}, {8, 9}, {15, 10}, {15, 6}, {3, 15}, {15, 8}, {5, 15}, {15, 3}, {15, 6}, {15, 6}, {15, 8},
+    {3, 15}, {15, 3}, {5, 15}, {5, 15}, {5, 15}, {8, 15}, {5, 15}, {10, 15}, {5, 15}, {10, 15}, {8, 15}, {13, 15}, {15, 3}, {12, 15}, {3, 15}, {3, 8},
+};
+
+// Interpolation weights in 64ths for two, three and four bit indices
+static const uint8_t bc_weights2[4] = {0, 21, 43, 64};
+static const uint8_t bc_weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static const uint8_t bc_weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+static void     bc_decode_bc1(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc2(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc3(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc4(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc4_snorm(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc5(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc5_snorm(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc6h_ufloat(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc6h_sfloat(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_decode_bc7(const uint8_t *p_block, uint8_t *p_texels);
+static void     bc_encode_bc1(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc3(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc4(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc4_snorm(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc5(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc5_snorm(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_bc7(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_decode_color(const uint8_t *p_block, uint8_t *p_texels, VriBool four_color);
+static void     bc_decode_channel(const uint8_t *p_block, uint8_t *p_texels, uint32_t channel, VriBool snorm);
+static void     bc_decode_bc6h(const uint8_t *p_block, uint8_t *p_texels, VriBool is_signed);
+static void     bc_encode_color(const uint8_t *p_texels, uint8_t *p_block);
+static void     bc_encode_channel(const uint8_t *p_texels, uint32_t channel, VriBool snorm, uint8_t *p_block);
+static void     bc_encode_bc7_block(const uint8_t *p_texels, uint8_t *p_block);
+static VriBool  bc_check_desc(const VriBlockConvertDesc *p_desc);
+static uint16_t bc_pack_565(uint32_t r, uint32_t g, uint32_t b);
+static void     bc_unpack_565(uint16_t color, uint8_t *p_rgb);
+static void     bc_bits_load(BcBits *p_bits, const uint8_t *p_block);
+static void     bc_bits_store(const BcBits *p_bits, uint8_t *p_block);
+static uint32_t bc_bits_read(BcBits *p_bits, uint32_t count);
+static void     bc_bits_write(BcBits *p_bits, uint32_t value, uint32_t count);
+static int32_t  bc_divide_round(int32_t value, int32_t divisor);
+static int32_t  bc_sign_extend(int32_t value, uint32_t bits);
+static int32_t  bc6h_unquantize(int32_t value, uint32_t bits, VriBool is_signed);
+
+#if BC_AVX2
+// The costly encoders again with their helpers inlined, compiled for AVX2
+static BC_TARGET_AVX2 void bc_encode_bc1_avx2(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_color(p_texels, p_block);
+}
+
+static BC_TARGET_AVX2 void bc_encode_bc3_avx2(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 3, VRI_FALSE, p_block);
+    bc_encode_color(p_texels, p_block + 8);
+}
+
+static BC_TARGET_AVX2 void bc_encode_bc7_avx2(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_bc7_block(p_texels, p_block);
+}
+#endif
+
+VriResult vri_bc_decode(const VriBlockConvertDesc *p_desc) {
+    if (!bc_check_desc(p_desc)) return VRI_ERROR_INVALID_API_USAGE;
+
+    PFN_BcBlock pfn_decode;
+    uint32_t    texel_size = 4;
+    switch (p_desc->format) {
+        case VRI_FORMAT_BC1_UNORM:
+        case VRI_FORMAT_BC1_SRGB: pfn_decode = bc_decode_bc1; break;
+        case VRI_FORMAT_BC2_UNORM:
+        case VRI_FORMAT_BC2_SRGB: pfn_decode = bc_decode_bc2; break;
+        case VRI_FORMAT_BC3_UNORM:
+        case VRI_FORMAT_BC3_SRGB: pfn_decode = bc_decode_bc3; break;
+        case VRI_FORMAT_BC4_UNORM: pfn_decode = bc_decode_bc4; break;
+        case VRI_FORMAT_BC4_SNORM: pfn_decode = bc_decode_bc4_snorm; break;
+        case VRI_FORMAT_BC5_UNORM: pfn_decode = bc_decode_bc5; break;
+        case VRI_FORMAT_BC5_SNORM: pfn_decode = bc_decode_bc5_snorm; break;
+        case VRI_FORMAT_BC6H_UFLOAT:
+            pfn_decode = bc_decode_bc6h_ufloat;
+            texel_size = 8;
+            break;
+        case VRI_FORMAT_BC6H_SFLOAT:
+            pfn_decode = bc_decode_bc6h_sfloat;
+            texel_size = 8;
+            break;
+        case VRI_FORMAT_BC7_UNORM:
+        case VRI_FORMAT_BC7_SRGB: pfn_decode = bc_decode_bc7; break;
+        default: return VRI_ERROR_UNSUPPORTED;
+    }
+
+    uint32_t block_size = VRI_FORMAT_INFO(p_desc->format)->block_size;
+    uint8_t  texels[BC_TEXELS * 8];
+
+    for (uint32_t y = 0; y < p_desc->height; y += 4) {
+        const uint8_t *p_src = (const uint8_t *)p_desc->p_src + (size_t)(y / 4) * p_desc->src_row_pitch;
+        uint32_t       rows = VRI_MIN(p_desc->height - y, 4u);
+
+        for (uint32_t x = 0; x < p_desc->width; x += 4) {
+            pfn_decode(p_src + (size_t)(x / 4) * block_size, texels);
+
+            uint32_t columns = VRI_MIN(p_desc->width - x, 4u);
+            for (uint32_t row = 0; row < rows; ++row) {
+                uint8_t *p_dst = (uint8_t *)p_desc->p_dst + (size_t)(y + row) * p_desc->dst_row_pitch + (size_t)x * texel_size;
+                memcpy(p_dst, &texels[row * 4 * texel_size], columns * texel_size);
+            }
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+VriResult vri_bc_encode(const VriBlockConvertDesc *p_desc) {
+    if (!bc_check_desc(p_desc)) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriBool     avx2 = BC_HAS_AVX2();
+    PFN_BcBlock pfn_encode;
+    switch (p_desc->format) {
+        case VRI_FORMAT_BC1_UNORM:
+        case VRI_FORMAT_BC1_SRGB: pfn_encode = BC_ENCODER(bc1, avx2); break;
+        case VRI_FORMAT_BC3_UNORM:
+        case VRI_FORMAT_BC3_SRGB: pfn_encode = BC_ENCODER(bc3, avx2); break;
+        case VRI_FORMAT_BC4_UNORM: pfn_encode = bc_encode_bc4; break;
+        case VRI_FORMAT_BC4_SNORM: pfn_encode = bc_encode_bc4_snorm; break;
+        case VRI_FORMAT_BC5_UNORM: pfn_encode = bc_encode_bc5; break;
+        case VRI_FORMAT_BC5_SNORM: pfn_encode = bc_encode_bc5_snorm; break;
+        case VRI_FORMAT_BC7_UNORM:
+        case VRI_FORMAT_BC7_SRGB: pfn_encode = BC_ENCODER(bc7, avx2); break;
+        default: return VRI_ERROR_UNSUPPORTED;
+    }
+
+    uint32_t block_size = VRI_FORMAT_INFO(p_desc->format)->block_size;
+    uint8_t  texels[BC_TEXELS * 4];
+
+    for (uint32_t y = 0; y < p_desc->height; y += 4) {
+        uint8_t *p_dst = (uint8_t *)p_desc->p_dst + (size_t)(y / 4) * p_desc->dst_row_pitch;
+
+        for (uint32_t x = 0; x < p_desc->width; x += 4) {
+            // Texels past the edge repeat the last row and column, so they don't widen the endpoints
+            VriBool inside = x + 4 <= p_desc->width;
+            for (uint32_t row = 0; row < 4; ++row) {
+                uint32_t       src_y = VRI_MIN(y + row, p_desc->height - 1);
+                const uint8_t *p_src = (const uint8_t *)p_desc->p_src + (size_t)src_y * p_desc->src_row_pitch;
+                if (inside) {
+                    memcpy(&texels[row * 16], p_src + (size_t)x * 4, 16);
+                    continue;
+                }
+                for (uint32_t column = 0; column < 4; ++column) {
+                    uint32_t src_x = VRI_MIN(x + column, p_desc->width - 1);
+                    memcpy(&texels[(row * 4 + column) * 4], p_src + (size_t)src_x * 4, 4);
+                }
+            }
+
+            pfn_encode(texels, p_dst + (size_t)(x / 4) * block_size);
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+static void bc_decode_bc1(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_color(p_block, p_texels, VRI_FALSE);
+}
+
+static void bc_decode_bc2(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_color(p_block + 8, p_texels, VRI_TRUE);
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        uint32_t alpha = (p_block[i / 2] >> ((i & 1) * 4)) & 0xF;
+        p_texels[i * 4 + 3] = (uint8_t)(alpha * 17);
+    }
+}
+
+static void bc_decode_bc3(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_color(p_block + 8, p_texels, VRI_TRUE);
+    bc_decode_channel(p_block, p_texels, 3, VRI_FALSE);
+}
+
+static void bc_decode_bc4(const uint8_t *p_block, uint8_t *p_texels) {
+    memset(p_texels, 0, BC_TEXELS * 4);
+    bc_decode_channel(p_block, p_texels, 0, VRI_FALSE);
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        p_texels[i * 4 + 3] = 255;
+    }
+}
+
+// SNORM texels are two's complement bytes, with alpha at 127 for 1.0
+static void bc_decode_bc4_snorm(const uint8_t *p_block, uint8_t *p_texels) {
+    memset(p_texels, 0, BC_TEXELS * 4);
+    bc_decode_channel(p_block, p_texels, 0, VRI_TRUE);
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        p_texels[i * 4 + 3] = 127;
+    }
+}
+
+static void bc_decode_bc5(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_bc4(p_block, p_texels);
+    bc_decode_channel(p_block + 8, p_texels, 1, VRI_FALSE);
+}
+
+static void bc_decode_bc5_snorm(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_bc4_snorm(p_block, p_texels);
+    bc_decode_channel(p_block + 8, p_texels, 1, VRI_TRUE);
+}
+
+static void bc_decode_bc6h_ufloat(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_bc6h(p_block, p_texels, VRI_FALSE);
+}
+
+static void bc_decode_bc6h_sfloat(const uint8_t *p_block, uint8_t *p_texels) {
+    bc_decode_bc6h(p_block, p_texels, VRI_TRUE);
+}
+
+// Reserved modes decode to zero in every channel, alpha included
+static void bc_decode_bc7(const uint8_t *p_block, uint8_t *p_texels) {
+    uint32_t mode_index = 0;
+    while (mode_index < 8 && !(p_block[0] >> mode_index & 1)) {
+        ++mode_index;
+    }
+    if (mode_index == 8) {
+        memset(p_texels, 0, BC_TEXELS * 4);
+        return;
+    }
+
+    const Bc7Mode *mode = &bc7_modes[mode_index];
+    BcBits         bits;
+    bc_bits_load(&bits, p_block);
+    bits.offset = mode_index + 1;
+
+    uint32_t partition = bc_bits_read(&bits, mode->partition_bits);
+    uint32_t rotation = bc_bits_read(&bits, mode->rotation_bits);
+    uint32_t selector = bc_bits_read(&bits, mode->selector_bits);
+
+    // Every channel of every endpoint, then the p-bits
+    uint32_t endpoint_count = mode->subsets * 2u;
+    uint32_t endpoints[6][4];
+    for (uint32_t c = 0; c < 4; ++c) {
+        uint32_t channel_bits = c < 3 ? mode->color_bits : mode->alpha_bits;
+        for (uint32_t e = 0; e < endpoint_count; ++e) {
+            endpoints[e][c] = bc_bits_read(&bits, channel_bits);
+        }
+    }
+
+    uint32_t pbits[6] = {0};
+    if (mode->endpoint_pbits || mode->shared_pbits) {
+        for (uint32_t e = 0; e < endpoint_count; ++e) {
+            pbits[e] = mode->shared_pbits && (e & 1) ? pbits[e - 1] : bc_bits_read(&bits, 1);
+        }
+    }
+    VriBool has_pbits = mode->endpoint_pbits || mode->shared_pbits;
+
+    // Expanded to 8 bits by repeating the top bits in the bottom ones
+    for (uint32_t c = 0; c < 4; ++c) {
+        uint32_t channel_bits = c < 3 ? mode->color_bits : mode->alpha_bits;
+        for (uint32_t e = 0; e < endpoint_count; ++e) {
+            if (!channel_bits) {
+                endpoints[e][c] = 255;
+                continue;
+            }
+            uint32_t value = has_pbits ? endpoints[e][c] << 1 | pbits[e] : endpoints[e][c];
+            uint32_t value_bits = channel_bits + (has_pbits ? 1 : 0);
+            value <<= 8 - value_bits;
+            endpoints[e][c] = value | value >> value_bits;
+        }
+    }
+
+    uint32_t subsets[BC_TEXELS];
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        subsets[i] = mode->subsets == 2 ? (uint32_t)(bc_partitions2[partition] >> i & 1) : mode->subsets == 3 ? bc_partitions3[partition] >> (i * 2) & 3 : 0;
+    }
+
+    // Each subset's anchor texel stores its index without the top bit
+    uint32_t anchors[3] = {0, 0, 0};
+    if (mode->subsets == 2) {
+        anchors[1] = bc_anchors2[partition];
+    } else if (mode->subsets == 3) {
+        anchors[1] = bc_anchors3[partition][0];
+        anchors[2] = bc_anchors3[partition][1];
+    }
+
+    uint32_t indices[BC_TEXELS];
+    uint32_t indices2[BC_TEXELS];
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        indices[i] = bc_bits_read(&bits, mode->index_bits - (i == anchors[subsets[i]] ? 1 : 0));
+    }
+    for (uint32_t i = 0; i < BC_TEXELS && mode->index2_bits; ++i) {
+        indices2[i] = bc_bits_read(&bits, mode->index2_bits - (i == 0 ? 1 : 0));
+    }
+
+    const uint8_t *weights[5] = {NULL, NULL, bc_weights2, bc_weights3, bc_weights4};
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        const uint32_t *p_e0 = endpoints[subsets[i] * 2];
+        const uint32_t *p_e1 = endpoints[subsets[i] * 2 + 1];
+
+        uint32_t color_weight = weights[mode->index_bits][indices[i]];
+        uint32_t alpha_weight = color_weight;
+        if (mode->index2_bits) {
+            uint32_t weight2 = weights[mode->index2_bits][indices2[i]];
+            alpha_weight = selector ? color_weight : weight2;
+            color_weight = selector ? weight2 : color_weight;
+        }
+
+        uint8_t *p_texel = &p_texels[i * 4];
+        for (uint32_t c = 0; c < 4; ++c) {
+            uint32_t weight = c < 3 ? color_weight : alpha_weight;
+            p_texel[c] = (uint8_t)(((64 - weight) * p_e0[c] + weight * p_e1[c] + 32) >> 6);
+        }
+
+        // Rotation swaps alpha with red, green or blue
+        if (rotation) {
+            uint8_t swap = p_texel[rotation - 1];
+            p_texel[rotation - 1] = p_texel[3];
+            p_texel[3] = swap;
+        }
+    }
+}
+
+static void bc_encode_bc1(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_color(p_texels, p_block);
+}
+
+static void bc_encode_bc3(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 3, VRI_FALSE, p_block);
+    bc_encode_color(p_texels, p_block + 8);
+}
+
+static void bc_encode_bc4(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 0, VRI_FALSE, p_block);
+}
+
+static void bc_encode_bc4_snorm(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 0, VRI_TRUE, p_block);
+}
+
+static void bc_encode_bc5(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 0, VRI_FALSE, p_block);
+    bc_encode_channel(p_texels, 1, VRI_FALSE, p_block + 8);
+}
+
+static void bc_encode_bc5_snorm(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_channel(p_texels, 0, VRI_TRUE, p_block);
+    bc_encode_channel(p_texels, 1, VRI_TRUE, p_block + 8);
+}
+
+static void bc_encode_bc7(const uint8_t *p_texels, uint8_t *p_block) {
+    bc_encode_bc7_block(p_texels, p_block);
+}
+
+// BC2 and BC3 color blocks always use four colors, BC1 switches to three
+// colors and transparent black when the first endpoint isn't the larger one
+static void bc_decode_color(const uint8_t *p_block, uint8_t *p_texels, VriBool four_color) {
+    uint16_t c0 = (uint16_t)(p_block[0] | p_block[1] << 8);
+    uint16_t c1 = (uint16_t)(p_block[2] | p_block[3] << 8);
+    uint32_t indices = (uint32_t)p_block[4] | (uint32_t)p_block[5] << 8 | (uint32_t)p_block[6] << 16 | (uint32_t)p_block[7] << 24;
+
+    uint8_t palette[4][4];
+    bc_unpack_565(c0, palette[0]);
+    bc_unpack_565(c1, palette[1]);
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+
+    if (four_color || c0 > c1) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    } else {
+        for (uint32_t c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((palette[0][c] + palette[1][c] + 1) / 2);
+        }
+        palette[2][3] = 255;
+        memset(palette[3], 0, 4);
+    }
+
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        memcpy(&p_texels[i * 4], palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+// Eight interpolated values when the first endpoint is larger, otherwise six
+
+// Eight interpolated values when the first endpoint is larger, otherwise six
+// plus both ends of the range. SNORM endpoints are two's complement, with -128
+// read as -127 since both mean -1.0.
+static void bc_decode_channel(const uint8_t *p_block, uint8_t *p_texels, uint32_t channel, VriBool snorm) {
+    int32_t  a0 = snorm ? VRI_MAX((int8_t)p_block[0], -127) : p_block[0];
+    int32_t  a1 = snorm ? VRI_MAX((int8_t)p_block[1], -127) : p_block[1];
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < 6; ++i) {
+        indices |= (uint64_t)p_block[2 + i] << (i * 8);
+    }
+
+    int32_t palette[8] = {a0, a1};
+    if (a0 > a1) {
+        for (int32_t i = 2; i < 8; ++i) {
+            palette[i] = bc_divide_round((8 - i) * a0 + (i - 1) * a1, 7);
+        }
+    } else {
+        for (int32_t i = 2; i < 6; ++i) {
+            palette[i] = bc_divide_round((6 - i) * a0 + (i - 1) * a1, 5);
+        }
+        palette[6] = snorm ? -127 : 0;
+        palette[7] = snorm ? 127 : 255;
+    }
+
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        p_texels[i * 4 + channel] = (uint8_t)palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+// Decodes to RGBA16 float texels with alpha at 1.0. Reserved modes decode to
+// zero in every channel.
+static void bc_decode_bc6h(const uint8_t *p_block, uint8_t *p_texels, VriBool is_signed) {
+    BcBits bits;
+    bc_bits_load(&bits, p_block);
+    uint32_t mode_bits = bc_bits_read(&bits, 2);
+    if (mode_bits > 1) {
+        mode_bits |= bc_bits_read(&bits, 3) << 2;
+    }
+
+    const Bc6hMode *mode = NULL;
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(bc6h_modes) && !mode; ++i) {
+        mode = bc6h_modes[i].mode == mode_bits ? &bc6h_modes[i] : NULL;
+    }
+    if (!mode) {
+        memset(p_texels, 0, BC_TEXELS * 8);
+        return;
+    }
+
+    int32_t fields[BC6H_FIELD_COUNT] = {0};
+    for (uint32_t r = 0; r < VRI_ARRAY_SIZE(mode->runs) && mode->runs[r].count; ++r) {
+        const Bc6hRun *p_run = &mode->runs[r];
+        fields[p_run->field] |= (int32_t)(bc_bits_read(&bits, p_run->count) << p_run->shift);
+    }
+
+    // Modes ending in 11 have one region of two endpoints and four bit indices,
+    // the others two regions and three bit indices
+    VriBool  two_regions = (mode_bits & 3) != 3;
+    uint32_t endpoint_count = two_regions ? 4 : 2;
+    uint32_t partition = (uint32_t)fields[BC6H_D];
+    int32_t  mask = (1 << mode->endpoint_bits) - 1;
+
+    int32_t endpoints[4][3];
+    for (uint32_t c = 0; c < 3; ++c) {
+        int32_t base = is_signed ? bc_sign_extend(fields[c], mode->endpoint_bits) : fields[c];
+        for (uint32_t e = 1; e < endpoint_count; ++e) {
+            int32_t value = fields[e * 3 + c];
+            if (mode->transformed) {
+                value = (base + bc_sign_extend(value, mode->delta_bits[c])) & mask;
+            }
+            value = is_signed ? bc_sign_extend(value, mode->endpoint_bits) : value;
+            endpoints[e][c] = bc6h_unquantize(value, mode->endpoint_bits, is_signed);
+        }
+        endpoints[0][c] = bc6h_unquantize(base, mode->endpoint_bits, is_signed);
+    }
+
+    uint32_t       index_bits = two_regions ? 3 : 4;
+    uint32_t       anchor = two_regions ? bc_anchors2[partition] : 0;
+    const uint8_t *p_weights = two_regions ? bc_weights3 : bc_weights4;
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        uint32_t region = two_regions ? (uint32_t)(bc_partitions2[partition] >> i & 1) : 0;
+        int32_t  weight = p_weights[bc_bits_read(&bits, index_bits - (i == 0 || i == anchor ? 1 : 0))];
+
+        // Interpolated, then scaled to the largest half magnitude, sign and magnitude for SFLOAT
+        uint16_t half[4] = {0, 0, 0, 0x3C00};
+        for (uint32_t c = 0; c < 3; ++c) {
+            int32_t value = (endpoints[region * 2][c] * (64 - weight) + endpoints[region * 2 + 1][c] * weight + 32) >> 6;
+            if (!is_signed) {
+                half[c] = (uint16_t)((value * 31) >> 6);
+            } else {
+                half[c] = (uint16_t)(value < 0 ? 0x8000 | (-value * 31) >> 5 : (value * 31) >> 5);
+            }
+        }
+        memcpy(&p_texels[i * 8], half, sizeof(half));
+    }
+}
+
+// Range fit: the endpoints are the corners of the block's color bounding box,
+// pulled in by a sixteenth of its size, and every texel takes the nearest of
+// the four palette colors
+static BC_INLINE void bc_encode_color(const uint8_t *p_texels, uint8_t *p_block) {
+    uint8_t min[3] = {255, 255, 255};
+    uint8_t max[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            min[c] = VRI_MIN(min[c], p_texels[i * 4 + c]);
+            max[c] = VRI_MAX(max[c], p_texels[i * 4 + c]);
+        }
+    }
+
+    for (uint32_t c = 0; c < 3; ++c) {
+        uint32_t inset = (uint32_t)(max[c] - min[c]) >> 4;
+        min[c] = (uint8_t)(min[c] + inset);
+        max[c] = (uint8_t)(max[c] - inset);
+    }
+
+    // Of the box's four diagonals, take the one green and blue run along with red
+    int32_t covariance[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        int32_t r = p_texels[i * 4 + 0] * 2 - (min[0] + max[0]);
+        covariance[1] += r * (p_texels[i * 4 + 1] * 2 - (min[1] + max[1]));
+        covariance[2] += r * (p_texels[i * 4 + 2] * 2 - (min[2] + max[2]));
+    }
+    for (uint32_t c = 1; c < 3; ++c) {
+        if (covariance[c] < 0) {
+            uint8_t swap = min[c];
+            min[c] = max[c];
+            max[c] = swap;
+        }
+    }
+
+    uint16_t c0 = bc_pack_565(max[0], max[1], max[2]);
+    uint16_t c1 = bc_pack_565(min[0], min[1], min[2]);
+
+    // The larger endpoint goes first so the block stays in four color mode
+    if (c0 < c1) {
+        uint16_t swap = c0;
+        c0 = c1;
+        c1 = swap;
+    }
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        uint8_t palette[4][4];
+        bc_unpack_565(c0, palette[0]);
+        bc_unpack_565(c1, palette[1]);
+        for (uint32_t c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+
+        // Palette entries outside, texels inside, so the inner loop runs across all sixteen at once
+        uint32_t best[BC_TEXELS] = {0};
+        int32_t  best_distance[BC_TEXELS];
+        for (uint32_t p = 0; p < 4; ++p) {
+            for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+                int32_t dr = p_texels[i * 4 + 0] - palette[p][0];
+                int32_t dg = p_texels[i * 4 + 1] - palette[p][1];
+                int32_t db = p_texels[i * 4 + 2] - palette[p][2];
+                int32_t distance = dr * dr + dg * dg + db * db;
+                VriBool closer = p == 0 || distance < best_distance[i];
+                best[i] = closer ? p : best[i];
+                best_distance[i] = closer ? distance : best_distance[i];
+            }
+        }
+        for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+            indices |= best[i] << (i * 2);
+        }
+    }
+
+    p_block[0] = (uint8_t)(c0 & 0xFF);
+    p_block[1] = (uint8_t)(c0 >> 8);
+    p_block[2] = (uint8_t)(c1 & 0xFF);
+    p_block[3] = (uint8_t)(c1 >> 8);
+    for (uint32_t i = 0; i < 4; ++i) {
+        p_block[4 + i] = (uint8_t)(indices >> (i * 8));
+    }
+}
+
+// Always the eight value mode, with the channel's maximum as the first
+// endpoint. SNORM channels are fitted offset by 128, which the interpolation
+// doesn't notice, with -128 clamped to -127.
+static BC_INLINE void bc_encode_channel(const uint8_t *p_texels, uint32_t channel, VriBool snorm, uint8_t *p_block) {
+    uint32_t values[BC_TEXELS];
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        values[i] = snorm ? (uint32_t)(VRI_MAX((int8_t)p_texels[i * 4 + channel], -127) + 128) : p_texels[i * 4 + channel];
+    }
+
+    uint32_t min = 255;
+    uint32_t max = 0;
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        min = VRI_MIN(min, values[i]);
+        max = VRI_MAX(max, values[i]);
+    }
+
+    uint64_t indices = 0;
+    uint32_t range = max - min;
+    if (range) {
+        // A 16.16 reciprocal instead of dividing every texel, divisions don't vectorize
+        uint32_t scale = (7u << 16) / range;
+        for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+            // Position along min..max in sevenths, index 0 is max, 1 is min and 2..7 step down from max
+            uint32_t step = VRI_MIN(((values[i] - min) * scale + (1u << 15)) >> 16, 7u);
+            uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            indices |= index << (i * 3);
+        }
+    }
+
+    uint32_t offset = snorm ? 128 : 0;
+    p_block[0] = (uint8_t)(max - offset);
+    p_block[1] = (uint8_t)(min - offset);
+    for (uint32_t i = 0; i < 6; ++i) {
+        p_block[2 + i] = (uint8_t)(indices >> (i * 8));
+    }
+}
+
+// Mode 6 only: one subset of RGBA endpoints at seven bits plus a p-bit each,
+// and four bit indices. The endpoints are a range fit over all four channels
+// like BC1's, and every texel takes the nearest of the sixteen palette colors.
+static BC_INLINE void bc_encode_bc7_block(const uint8_t *p_texels, uint8_t *p_block) {
+    int32_t min[4] = {255, 255, 255, 255};
+    int32_t max[4] = {0, 0, 0, 0};
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            min[c] = VRI_MIN(min[c], (int32_t)p_texels[i * 4 + c]);
+            max[c] = VRI_MAX(max[c], (int32_t)p_texels[i * 4 + c]);
+        }
+    }
+
+    for (uint32_t c = 0; c < 4; ++c) {
+        int32_t inset = (max[c] - min[c]) >> 4;
+        min[c] += inset;
+        max[c] -= inset;
+    }
+
+    // Of the box's diagonals, take the one green, blue and alpha run along with red
+    int32_t covariance[4] = {0, 0, 0, 0};
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        int32_t r = p_texels[i * 4 + 0] * 2 - (min[0] + max[0]);
+        for (uint32_t c = 1; c < 4; ++c) {
+            covariance[c] += r * (p_texels[i * 4 + c] * 2 - (min[c] + max[c]));
+        }
+    }
+    for (uint32_t c = 1; c < 4; ++c) {
+        if (covariance[c] < 0) {
+            int32_t swap = min[c];
+            min[c] = max[c];
+            max[c] = swap;
+        }
+    }
+
+    // Each endpoint's p-bit is shared by its four channels, take whichever lands closer
+    const int32_t *p_targets[2] = {max, min};
+    uint32_t       quantized[2][4];
+    uint32_t       pbits[2];
+    for (uint32_t e = 0; e < 2; ++e) {
+        uint32_t best_error = UINT32_MAX;
+        for (uint32_t p = 0; p < 2; ++p) {
+            uint32_t candidate[4];
+            uint32_t error = 0;
+            for (uint32_t c = 0; c < 4; ++c) {
+                candidate[c] = VRI_MIN((uint32_t)(p_targets[e][c] + 1 - (int32_t)p) >> 1, 127u);
+                int32_t difference = (int32_t)(candidate[c] * 2 + p) - p_targets[e][c];
+                error += (uint32_t)(difference * difference);
+            }
+            if (error < best_error) {
+                best_error = error;
+                memcpy(quantized[e], candidate, sizeof(candidate));
+                pbits[e] = p;
+            }
+        }
+    }
+
+    int32_t palette[16][4];
+    for (uint32_t p = 0; p < 16; ++p) {
+        int32_t weight = bc_weights4[p];
+        for (uint32_t c = 0; c < 4; ++c) {
+            int32_t e0 = (int32_t)(quantized[0][c] * 2 + pbits[0]);
+            int32_t e1 = (int32_t)(quantized[1][c] * 2 + pbits[1]);
+            palette[p][c] = ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+        }
+    }
+
+    // Palette entries outside, texels inside, so the inner loop runs across all sixteen at once
+    uint32_t best[BC_TEXELS] = {0};
+    int32_t  best_distance[BC_TEXELS];
+    for (uint32_t p = 0; p < 16; ++p) {
+        for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+            int32_t dr = p_texels[i * 4 + 0] - palette[p][0];
+            int32_t dg = p_texels[i * 4 + 1] - palette[p][1];
+            int32_t db = p_texels[i * 4 + 2] - palette[p][2];
+            int32_t da = p_texels[i * 4 + 3] - palette[p][3];
+            int32_t distance = dr * dr + dg * dg + db * db + da * da;
+            VriBool closer = p == 0 || distance < best_distance[i];
+            best[i] = closer ? p : best[i];
+            best_distance[i] = closer ? distance : best_distance[i];
+        }
+    }
+
+    // Texel 0 is the anchor and stores three bits, swapping the endpoints mirrors the palette
+    VriBool swap = best[0] >= 8;
+    uint32_t first = swap ? 1 : 0;
+
+    BcBits bits = {0, 0, 0};
+    bc_bits_write(&bits, 1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c) {
+        bc_bits_write(&bits, quantized[first][c], 7);
+        bc_bits_write(&bits, quantized[first ^ 1][c], 7);
+    }
+    bc_bits_write(&bits, pbits[first], 1);
+    bc_bits_write(&bits, pbits[first ^ 1], 1);
+    for (uint32_t i = 0; i < BC_TEXELS; ++i) {
+        bc_bits_write(&bits, swap ? 15 - best[i] : best[i], i == 0 ? 3 : 4);
+    }
+    bc_bits_store(&bits, p_block);
+}
+
+static VriBool bc_check_desc(const VriBlockConvertDesc *p_desc) {
+    return p_desc->p_src && p_desc->p_dst && p_desc->width && p_desc->height && p_desc->format < VRI_FORMAT_COUNT;
+}
+
+static uint16_t bc_pack_565(uint32_t r, uint32_t g, uint32_t b) {
+    return (uint16_t)(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+static void bc_unpack_565(uint16_t color, uint8_t *p_rgb) {
+    uint32_t r = (color >> 11) & 0x1F;
+    uint32_t g = (color >> 5) & 0x3F;
+    uint32_t b = color & 0x1F;
+    p_rgb[0] = (uint8_t)(r << 3 | r >> 2);
+    p_rgb[1] = (uint8_t)(g << 2 | g >> 4);
+    p_rgb[2] = (uint8_t)(b << 3 | b >> 2);
+}
+
+static void bc_bits_load(BcBits *p_bits, const uint8_t *p_block) {
+    p_bits->low = 0;
+    p_bits->high = 0;
+    p_bits->offset = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        p_bits->low |= (uint64_t)p_block[i] << (i * 8);
+        p_bits->high |= (uint64_t)p_block[8 + i] << (i * 8);
+    }
+}
+
+static void bc_bits_store(const BcBits *p_bits, uint8_t *p_block) {
+    for (uint32_t i = 0; i < 8; ++i) {
+        p_block[i] = (uint8_t)(p_bits->low >> (i * 8));
+        p_block[8 + i] = (uint8_t)(p_bits->high >> (i * 8));
+    }
+}
+
+static uint32_t bc_bits_read(BcBits *p_bits, uint32_t count) {
+    uint64_t value;
+    if (p_bits->offset >= 64) {
+        value = p_bits->high >> (p_bits->offset - 64);
+    } else if (p_bits->offset == 0) {
+        value = p_bits->low;
+    } else {
+        value = p_bits->low >> p_bits->offset | p_bits->high << (64 - p_bits->offset);
+    }
+    p_bits->offset += count;
+    return (uint32_t)(value & (((uint64_t)1 << count) - 1));
+}
+
+static void bc_bits_write(BcBits *p_bits, uint32_t value, uint32_t count) {
+    if (p_bits->offset >= 64) {
+        p_bits->high |= (uint64_t)value << (p_bits->offset - 64);
+    } else {
+        p_bits->low |= (uint64_t)value << p_bits->offset;
+        if (p_bits->offset + count > 64) {
+            p_bits->high |= (uint64_t)value >> (64 - p_bits->offset);
+        }
+    }
+    p_bits->offset += count;
+}
+
+// Rounds halves away from zero
+static int32_t bc_divide_round(int32_t value, int32_t divisor) {
+    return (value + (value < 0 ? -divisor : divisor) / 2) / divisor;
+}
+
+static int32_t bc_sign_extend(int32_t value, uint32_t bits) {
+    value &= (1 << bits) - 1;
+    return value >= 1 << (bits - 1) ? value - (1 << bits) : value;
+}
+
+// Scales a BC6H endpoint to 16 bits, or to 15 bits plus sign for SFLOAT
+static int32_t bc6h_unquantize(int32_t value, uint32_t bits, VriBool is_signed) {
+    if (!is_signed) {
+        if (bits >= 15 || value == 0) return value;
+        if (value == (1 << bits) - 1) return 0xFFFF;
+        return ((value << 16) + 0x8000) >> bits;
+    }
+
+    if (bits >= 16) return value;
+    int32_t magnitude = value < 0 ? -value : value;
+    int32_t result;
+    if (magnitude == 0) {
+        result = 0;
+    } else if (magnitude >= (1 << (bits - 1)) - 1) {
+        result = 0x7FFF;
+    } else {
+        result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+    }
+    return value < 0 ? -result : result;
+}
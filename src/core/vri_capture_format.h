@@ -0,0 +1,83 @@
+#ifndef VRI_CAPTURE_FORMAT_H
+#define VRI_CAPTURE_FORMAT_H
+
+#include <stdint.h>
+
+// On-disk layout of the traces written by the capture layer and read by
+// vri-replay. A trace is a VriCaptureFileHeader followed by records, each a
+// VriCaptureRecordHeader and its payload, padded so every record starts on an
+// 8 byte boundary. Payloads are vri_serialize encodings: little-endian words,
+// with handles and byte blobs replaced by ids. Ids are dense and start at 1,
+// 0 always means "no handle" or "no data".
+
+#define VRI_CAPTURE_MAGIC   "VRITRACE"
+#define VRI_CAPTURE_VERSION 10
+
+#define VRI_CAPTURE_ALIGN(size) (((size) + 7) & ~(uint64_t)7)
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t header_size; // Offset of the first record
+} VriCaptureFileHeader;
+
+typedef struct {
+    uint16_t op;
+    uint16_t flags;   // Reserved, 0
+    uint32_t size;    // Payload bytes following this header, without padding
+    uint64_t time_ns; // Since the device was created
+} VriCaptureRecordHeader;
+
+// Payloads, in order. Output handles are recorded as the id the object was
+// given, which is 0 if the call failed.
+typedef enum {
+    VRI_CAPTURE_OP_BLOB = 1,                         // u32 id, u32 0, u64 size, bytes. Written before the first record using it
+    VRI_CAPTURE_OP_DEVICE_CREATE,                    // u32 backend, u32 validation, per queue type: u32 count, count x queue
+    VRI_CAPTURE_OP_DEVICE_DESTROY,                   // -
+    VRI_CAPTURE_OP_COMMAND_POOL_CREATE,              // u32 queue_type, u32 flags, pool
+    VRI_CAPTURE_OP_COMMAND_POOL_DESTROY,             // pool
+    VRI_CAPTURE_OP_COMMAND_POOL_RESET,               // pool, u32 flags
+    VRI_CAPTURE_OP_COMMAND_BUFFERS_ALLOCATE,         // pool, u32 count, count x command buffer
+    VRI_CAPTURE_OP_COMMAND_BUFFERS_FREE,             // pool, u32 count, count x command buffer
+    VRI_CAPTURE_OP_PIPELINE_LAYOUT_CREATE,           // pipeline layout
+    VRI_CAPTURE_OP_PIPELINE_CREATE_GRAPHICS,         // graphics pipeline desc, pipeline
+    VRI_CAPTURE_OP_PIPELINE_CREATE_COMPUTE,          // compute pipeline desc, pipeline
+    VRI_CAPTURE_OP_PIPELINE_DESTROY,                 // pipeline
+    VRI_CAPTURE_OP_TEXTURE_CREATE,                   // u32 x 10 (VriTextureDesc in declaration order), u32 n, n x (u32 row_pitch, u32 slice_pitch, blob), texture
+    VRI_CAPTURE_OP_TEXTURE_DESTROY,                  // texture
+    VRI_CAPTURE_OP_FENCE_CREATE,                     // u64 initial_value, fence
+    VRI_CAPTURE_OP_FENCE_DESTROY,                    // fence
+    VRI_CAPTURE_OP_FENCE_GET_VALUE,                  // fence
+    VRI_CAPTURE_OP_FENCES_WAIT,                      // u32 count, u32 wait_all, u64 timeout_ns, count x (fence, u64 value)
+    VRI_CAPTURE_OP_SWAPCHAIN_CREATE,                 // u32 width, height, format, color_space, flags, texture_count, frames_in_flight, headless, present_mode, refresh_rate, swapchain
+    VRI_CAPTURE_OP_SWAPCHAIN_DESTROY,                // swapchain
+    VRI_CAPTURE_OP_SWAPCHAIN_ACQUIRE_NEXT_IMAGE,     // swapchain, fence, u64 signal_value
+    VRI_CAPTURE_OP_SWAPCHAIN_PRESENT,                // swapchain, fence. Ends a frame
+    VRI_CAPTURE_OP_COMMAND_BUFFER_BEGIN,             // command buffer, u32 usage
+    VRI_CAPTURE_OP_COMMAND_BUFFER_END,               // command buffer
+    VRI_CAPTURE_OP_COMMAND_BUFFER_RESET,             // command buffer
+    VRI_CAPTURE_OP_CMD_BIND_PIPELINE,                // command buffer, pipeline
+    VRI_CAPTURE_OP_QUEUE_SUBMIT,                     // queue, u32 count, per submit: u32 n, n x command buffer, u32 n, n x (fence, u64), u32 n, n x (fence, u64)
+    VRI_CAPTURE_OP_QUEUE_WAIT_IDLE,                  // queue
+    VRI_CAPTURE_OP_QUEUE_PRESENT,                    // queue, u32 n, n x (swapchain, u32 image), u32 n, n x (fence, u64). Ends a frame
+    VRI_CAPTURE_OP_CMD_UPDATE_TEXTURE,               // command buffer, texture, u32 x 8 (VriTextureUpdateDesc region), u32 row_pitch, u32 slice_pitch, blob
+    VRI_CAPTURE_OP_CMD_GENERATE_MIPS,                // command buffer, texture
+    VRI_CAPTURE_OP_TILE_HEAP_CREATE,                 // u32 tile_count, tile heap
+    VRI_CAPTURE_OP_TILE_HEAP_DESTROY,                // tile heap
+    VRI_CAPTURE_OP_QUEUE_BIND_SPARSE,                // queue, u32 n, n x (texture, u32 mip_level, x, y, width, height, tile heap, u32 heap_offset)
+    VRI_CAPTURE_OP_SWAPCHAIN_GET_TEXTURE,            // swapchain, u32 image_index, texture
+    VRI_CAPTURE_OP_CMD_COPY_TEXTURE,                 // command buffer, src, dst, u32 x 13 (VriTextureCopyDesc in declaration order)
+    VRI_CAPTURE_OP_CMD_SET_VIEWPORT,                 // command buffer, u32 first, u32 n, n x f32 x 6 (VriViewport in declaration order)
+    VRI_CAPTURE_OP_CMD_SET_SCISSOR,                  // command buffer, u32 first, u32 n, n x (u32 x, y, width, height)
+    VRI_CAPTURE_OP_CMD_SET_STENCIL_REFERENCE,        // command buffer, u32 reference
+    VRI_CAPTURE_OP_CMD_SET_BLEND_CONSTANTS,          // command buffer, f32 x 4
+    VRI_CAPTURE_OP_CMD_SET_DEPTH_BIAS,               // command buffer, f32 constant_factor, f32 clamp, f32 slope_factor
+    VRI_CAPTURE_OP_PIPELINE_LIBRARY_CREATE,          // u32 parts, graphics pipeline desc, pipeline library
+    VRI_CAPTURE_OP_PIPELINE_LIBRARY_DESTROY,         // pipeline library
+    VRI_CAPTURE_OP_PIPELINE_LINK,                    // u32 n, n x pipeline library, pipeline
+    VRI_CAPTURE_OP_SHADER_MODULE_CREATE,             // shader desc, shader module
+    VRI_CAPTURE_OP_SHADER_MODULE_DESTROY,            // shader module
+    VRI_CAPTURE_OP_COUNT,
+} VriCaptureOp;
+
+#endif
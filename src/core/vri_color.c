@@ -0,0 +1,579 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define COLOR_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define COLOR_SSE2 0
+#endif
+
+// CPU-side color space conversion. A row is converted a tile at a time: texels
+// are loaded into planar floats, the source curve is decoded, the primaries
+// are converted with one 3x3 matrix and the destination curve is encoded.
+// The curves run four lanes at a time on SSE2, with polynomial log2 and exp2
+// in place of powf, which neither vectorizes nor inlines, accurate to a few
+// float ulps over the range the curves use.
+
+#define COLOR_TILE_WIDTH 64
+
+#define COLOR_HLG_A               0.17883277f
+#define COLOR_HLG_B               0.28466892f
+#define COLOR_HLG_C               0.55991073f
+#define COLOR_HLG_REFERENCE_WHITE 0.26496256f // Scene light of a 75% HLG signal
+
+#define COLOR_PQ_M1        0.1593017578125f
+#define COLOR_PQ_M2        78.84375f
+#define COLOR_PQ_C1        0.8359375f
+#define COLOR_PQ_C2        18.8515625f
+#define COLOR_PQ_C3        18.6875f
+#define COLOR_PQ_PEAK_NITS 10000.0f
+
+typedef enum {
+    COLOR_CURVE_LINEAR,
+    COLOR_CURVE_SRGB,
+    COLOR_CURVE_BT709, // Also BT.2020's SDR curve
+    COLOR_CURVE_PQ,
+    COLOR_CURVE_HLG,
+} ColorCurve;
+
+typedef enum {
+    COLOR_GAMUT_BT709, // Also sRGB's primaries
+    COLOR_GAMUT_P3,    // Display P3, D65 white
+    COLOR_GAMUT_BT2020,
+    COLOR_GAMUT_COUNT,
+} ColorGamut;
+
+typedef enum {
+    COLOR_LAYOUT_RGBA8,
+    COLOR_LAYOUT_BGRA8,
+    COLOR_LAYOUT_RGB10A2,
+    COLOR_LAYOUT_RGBA16F,
+    COLOR_LAYOUT_RGBA32F,
+} ColorLayout;
+
+typedef struct {
+    ColorCurve curve;
+    ColorGamut gamut;
+} ColorSpaceInfo;
+
+static const ColorSpaceInfo color_spaces[VRI_COLORSPACE_COUNT] = {
+    [VRI_COLORSPACE_SRGB_NONLINEAR] = {COLOR_CURVE_SRGB, COLOR_GAMUT_BT709},
+    [VRI_COLORSPACE_SRGB_LINEAR] = {COLOR_CURVE_LINEAR, COLOR_GAMUT_BT709},
+    [VRI_COLORSPACE_BT709_NONLINEAR] = {COLOR_CURVE_BT709, COLOR_GAMUT_BT709},
+    [VRI_COLORSPACE_BT709_LINEAR] = {COLOR_CURVE_LINEAR, COLOR_GAMUT_BT709},
+    [VRI_COLORSPACE_P3_NONLINEAR] = {COLOR_CURVE_SRGB, COLOR_GAMUT_P3},
+    [VRI_COLORSPACE_P3_LINEAR] = {COLOR_CURVE_LINEAR, COLOR_GAMUT_P3},
+    [VRI_COLORSPACE_BT2020_NONLINEAR] = {COLOR_CURVE_BT709, COLOR_GAMUT_BT2020},
+    [VRI_COLORSPACE_BT2020_LINEAR] = {COLOR_CURVE_LINEAR, COLOR_GAMUT_BT2020},
+    [VRI_COLORSPACE_HDR10_ST2084] = {COLOR_CURVE_PQ, COLOR_GAMUT_BT2020},
+    [VRI_COLORSPACE_HDR10_HLG] = {COLOR_CURVE_HLG, COLOR_GAMUT_BT2020},
+    [VRI_COLORSPACE_EXTENDED_SRGB_LINEAR] = {COLOR_CURVE_LINEAR, COLOR_GAMUT_BT709},
+};
+
+// CIE xy of the red, green and blue primaries, all share the D65 white point
+static const double color_primaries[COLOR_GAMUT_COUNT][3][2] = {
+    [COLOR_GAMUT_BT709] = {{0.640, 0.330}, {0.300, 0.600}, {0.150, 0.060}},
+    [COLOR_GAMUT_P3] = {{0.680, 0.320}, {0.265, 0.690}, {0.150, 0.060}},
+    [COLOR_GAMUT_BT2020] = {{0.708, 0.292}, {0.170, 0.797}, {0.131, 0.046}},
+};
+
+static const double color_white_point[2] = {0.3127, 0.3290};
+
+static VriBool color_layout_init(VriFormat format, ColorLayout *p_layout);
+static void    color_gamut_matrix(ColorGamut src, ColorGamut dst, float matrix[3][3]);
+static void    color_gamut_to_xyz(ColorGamut gamut, double matrix[3][3]);
+static void    color_invert(double matrix[3][3], double inverse[3][3]);
+static void    color_load(ColorLayout layout, const uint8_t *p_src, uint32_t count, float *p_rgb, float *p_alpha);
+static void    color_store(ColorLayout layout, const float *p_rgb, const float *p_alpha, uint32_t count, uint8_t *p_dst);
+static void    color_decode(ColorCurve curve, float pq_scale, float *p_values, uint32_t count);
+static void    color_encode(ColorCurve curve, float pq_scale, float *p_values, uint32_t count);
+static void    color_transform(float matrix[3][3], float *p_rgb, uint32_t count);
+
+VriResult vri_color_convert(const VriColorConvertDesc *p_desc) {
+    if (!p_desc->p_src || !p_desc->p_dst || !p_desc->width || !p_desc->height || p_desc->src_color_space >= VRI_COLORSPACE_COUNT ||
+        p_desc->dst_color_space >= VRI_COLORSPACE_COUNT || p_desc->sdr_white_nits < 0.0f) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    ColorLayout src_layout, dst_layout;
+    if (!color_layout_init(p_desc->src_format, &src_layout) || !color_layout_init(p_desc->dst_format, &dst_layout)) {
+        return VRI_ERROR_UNSUPPORTED;
+    }
+
+    ColorSpaceInfo src = color_spaces[p_desc->src_color_space];
+    ColorSpaceInfo dst = color_spaces[p_desc->dst_color_space];
+    size_t         src_texel_size = VRI_FORMAT_INFO(p_desc->src_format)->block_size;
+    size_t         dst_texel_size = VRI_FORMAT_INFO(p_desc->dst_format)->block_size;
+
+    // PQ is absolute, so reference white needs a luminance
+    float white_nits = p_desc->sdr_white_nits ? p_desc->sdr_white_nits : VRI_COLOR_DEFAULT_SDR_WHITE_NITS;
+    float pq_scale = white_nits / COLOR_PQ_PEAK_NITS;
+
+    // Between the same curve and primaries only the storage changes
+    VriBool same_curve = src.curve == dst.curve;
+    VriBool same_gamut = src.gamut == dst.gamut;
+    float   matrix[3][3];
+    if (!same_gamut) color_gamut_matrix(src.gamut, dst.gamut, matrix);
+
+    float rgb[COLOR_TILE_WIDTH * 3];
+    float alpha[COLOR_TILE_WIDTH];
+
+    for (uint32_t y = 0; y < p_desc->height; ++y) {
+        const uint8_t *p_src = (const uint8_t *)p_desc->p_src + (size_t)y * p_desc->src_row_pitch;
+        uint8_t       *p_dst = (uint8_t *)p_desc->p_dst + (size_t)y * p_desc->dst_row_pitch;
+
+        for (uint32_t x = 0; x < p_desc->width; x += COLOR_TILE_WIDTH) {
+            uint32_t count = VRI_MIN(p_desc->width - x, (uint32_t)COLOR_TILE_WIDTH);
+
+            color_load(src_layout, p_src + x * src_texel_size, count, rgb, alpha);
+            if (!same_curve || !same_gamut) {
+                color_decode(src.curve, pq_scale, rgb, COLOR_TILE_WIDTH * 3);
+                if (!same_gamut) color_transform(matrix, rgb, count);
+                color_encode(dst.curve, pq_scale, rgb, COLOR_TILE_WIDTH * 3);
+            }
+            color_store(dst_layout, rgb, alpha, count, p_dst + x * dst_texel_size);
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+static inline uint32_t color_float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float color_bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Four lanes of floats. SSE2 is the x64 baseline, elsewhere the lanes are
+// plain arrays the compiler is left to vectorize. Masks are all ones or all
+// zeros per lane, as the SSE2 comparisons return them
+#if COLOR_SSE2
+typedef __m128 ColorVec;
+
+static inline ColorVec color_set(float value) { return _mm_set1_ps(value); }
+static inline ColorVec color_load4(const float *p_values) { return _mm_loadu_ps(p_values); }
+static inline void     color_store4(float *p_values, ColorVec v) { _mm_storeu_ps(p_values, v); }
+static inline ColorVec color_add(ColorVec a, ColorVec b) { return _mm_add_ps(a, b); }
+static inline ColorVec color_sub(ColorVec a, ColorVec b) { return _mm_sub_ps(a, b); }
+static inline ColorVec color_mul(ColorVec a, ColorVec b) { return _mm_mul_ps(a, b); }
+static inline ColorVec color_div(ColorVec a, ColorVec b) { return _mm_div_ps(a, b); }
+static inline ColorVec color_min(ColorVec a, ColorVec b) { return _mm_min_ps(a, b); }
+static inline ColorVec color_max(ColorVec a, ColorVec b) { return _mm_max_ps(a, b); }
+static inline ColorVec color_sqrt(ColorVec v) { return _mm_sqrt_ps(v); }
+static inline ColorVec color_le(ColorVec a, ColorVec b) { return _mm_cmple_ps(a, b); }
+static inline ColorVec color_select(ColorVec mask, ColorVec a, ColorVec b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline ColorVec color_abs(ColorVec v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+static inline ColorVec color_copy_sign(ColorVec magnitude, ColorVec sign) { return _mm_or_ps(magnitude, _mm_and_ps(_mm_set1_ps(-0.0f), sign)); }
+
+// Mantissa in [1, 2) of a positive normal float, and its unbiased exponent
+static inline ColorVec color_split(ColorVec v, ColorVec *p_exponent) {
+    __m128i bits = _mm_castps_si128(v);
+    *p_exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    return _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x7FFFFF)), _mm_set1_epi32(0x3F800000)));
+}
+
+static inline ColorVec color_round(ColorVec v) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(v)); }
+
+// 2^v for whole v in [-126, 127]
+static inline ColorVec color_pow2(ColorVec v) {
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(v), _mm_set1_epi32(127)), 23));
+}
+#else
+typedef struct {
+    float lanes[4];
+} ColorVec;
+
+#    define COLOR_LANES(expression)                     \
+        ColorVec result;                                \
+        for (uint32_t i = 0; i < 4; ++i) {              \
+            result.lanes[i] = (expression);             \
+        }                                               \
+        return result
+
+static inline ColorVec color_set(float value) { COLOR_LANES(value); }
+static inline ColorVec color_load4(const float *p_values) { COLOR_LANES(p_values[i]); }
+static inline void     color_store4(float *p_values, ColorVec v) { memcpy(p_values, v.lanes, sizeof(v.lanes)); }
+static inline ColorVec color_add(ColorVec a, ColorVec b) { COLOR_LANES(a.lanes[i] + b.lanes[i]); }
+static inline ColorVec color_sub(ColorVec a, ColorVec b) { COLOR_LANES(a.lanes[i] - b.lanes[i]); }
+static inline ColorVec color_mul(ColorVec a, ColorVec b) { COLOR_LANES(a.lanes[i] * b.lanes[i]); }
+static inline ColorVec color_div(ColorVec a, ColorVec b) { COLOR_LANES(a.lanes[i] / b.lanes[i]); }
+static inline ColorVec color_min(ColorVec a, ColorVec b) { COLOR_LANES(VRI_MIN(a.lanes[i], b.lanes[i])); }
+static inline ColorVec color_max(ColorVec a, ColorVec b) { COLOR_LANES(VRI_MAX(a.lanes[i], b.lanes[i])); }
+static inline ColorVec color_sqrt(ColorVec v) { COLOR_LANES(sqrtf(v.lanes[i])); }
+static inline ColorVec color_le(ColorVec a, ColorVec b) { COLOR_LANES(color_bits_float(a.lanes[i] <= b.lanes[i] ? 0xFFFFFFFFu : 0u)); }
+static inline ColorVec color_select(ColorVec mask, ColorVec a, ColorVec b) { COLOR_LANES(color_float_bits(mask.lanes[i]) ? a.lanes[i] : b.lanes[i]); }
+static inline ColorVec color_abs(ColorVec v) { COLOR_LANES(fabsf(v.lanes[i])); }
+static inline ColorVec color_copy_sign(ColorVec magnitude, ColorVec sign) { COLOR_LANES(sign.lanes[i] < 0.0f ? -magnitude.lanes[i] : magnitude.lanes[i]); }
+
+static inline ColorVec color_split(ColorVec v, ColorVec *p_exponent) {
+    ColorVec result;
+    for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t bits = color_float_bits(v.lanes[i]);
+        p_exponent->lanes[i] = (float)((int32_t)(bits >> 23) - 127);
+        result.lanes[i] = color_bits_float((bits & 0x7FFFFF) | 0x3F800000);
+    }
+    return result;
+}
+
+static inline ColorVec color_round(ColorVec v) { COLOR_LANES((float)(int32_t)(v.lanes[i] + 126.5f) - 126.0f); }
+static inline ColorVec color_pow2(ColorVec v) { COLOR_LANES(color_bits_float((uint32_t)((int32_t)v.lanes[i] + 127) << 23)); }
+
+#    undef COLOR_LANES
+#endif
+
+// log2 of positive normal floats: the exponent plus the atanh series of the
+// mantissa, centered on 1 so five terms reach float precision
+static inline ColorVec color_log2(ColorVec v) {
+    ColorVec exponent;
+    ColorVec mantissa = color_split(v, &exponent);
+
+    ColorVec high = color_le(color_set(1.41421356f), mantissa);
+    mantissa = color_select(high, color_mul(mantissa, color_set(0.5f)), mantissa);
+    exponent = color_select(high, color_add(exponent, color_set(1.0f)), exponent);
+
+    ColorVec t = color_div(color_sub(mantissa, color_set(1.0f)), color_add(mantissa, color_set(1.0f)));
+    ColorVec t2 = color_mul(t, t);
+    ColorVec series = color_add(color_mul(t2, color_set(0.320598898f)), color_set(0.412198583f));
+    series = color_add(color_mul(t2, series), color_set(0.577078016f));
+    series = color_add(color_mul(t2, series), color_set(0.961796694f));
+    series = color_add(color_mul(t2, series), color_set(2.88539008f));
+    return color_add(exponent, color_mul(t, series));
+}
+
+// 2^v, split into a whole power built in the exponent bits and the Taylor
+// series of the fraction in [-0.5, 0.5]. Clamped to the normal float range
+static inline ColorVec color_exp2(ColorVec v) {
+    v = color_min(color_max(v, color_set(-126.0f)), color_set(127.0f));
+
+    ColorVec whole = color_round(v);
+    ColorVec f = color_sub(v, whole);
+    ColorVec series = color_add(color_mul(f, color_set(0.000154035304f)), color_set(0.00133335581f));
+    series = color_add(color_mul(f, series), color_set(0.00961812911f));
+    series = color_add(color_mul(f, series), color_set(0.0555041087f));
+    series = color_add(color_mul(f, series), color_set(0.240226507f));
+    series = color_add(color_mul(f, series), color_set(0.693147181f));
+    series = color_add(color_mul(f, series), color_set(1.0f));
+    return color_mul(series, color_pow2(whole));
+}
+
+// x^y, 0 where x isn't positive
+static inline ColorVec color_pow(ColorVec x, float y) {
+    ColorVec result = color_exp2(color_mul(color_set(y), color_log2(color_max(x, color_set(FLT_MIN)))));
+    return color_select(color_le(x, color_set(0.0f)), color_set(0.0f), result);
+}
+
+static VriBool color_layout_init(VriFormat format, ColorLayout *p_layout) {
+    switch (format) {
+        case VRI_FORMAT_R8G8B8A8_UNORM:
+        case VRI_FORMAT_R8G8B8A8_SRGB:
+            *p_layout = COLOR_LAYOUT_RGBA8;
+            return VRI_TRUE;
+        case VRI_FORMAT_B8G8R8A8_UNORM:
+        case VRI_FORMAT_B8G8R8A8_SRGB:
+            *p_layout = COLOR_LAYOUT_BGRA8;
+            return VRI_TRUE;
+        case VRI_FORMAT_R10G10B10A2_UNORM:
+            *p_layout = COLOR_LAYOUT_RGB10A2;
+            return VRI_TRUE;
+        case VRI_FORMAT_R16G16B16A16_FLOAT:
+            *p_layout = COLOR_LAYOUT_RGBA16F;
+            return VRI_TRUE;
+        case VRI_FORMAT_R32G32B32A32_FLOAT:
+            *p_layout = COLOR_LAYOUT_RGBA32F;
+            return VRI_TRUE;
+        default:
+            return VRI_FALSE;
+    }
+}
+
+// Linear src RGB to XYZ, then XYZ to linear dst RGB
+static void color_gamut_matrix(ColorGamut src, ColorGamut dst, float matrix[3][3]) {
+    double src_to_xyz[3][3], dst_to_xyz[3][3], xyz_to_dst[3][3];
+    color_gamut_to_xyz(src, src_to_xyz);
+    color_gamut_to_xyz(dst, dst_to_xyz);
+    color_invert(dst_to_xyz, xyz_to_dst);
+
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t column = 0; column < 3; ++column) {
+            double sum = 0.0;
+            for (uint32_t i = 0; i < 3; ++i) {
+                sum += xyz_to_dst[row][i] * src_to_xyz[i][column];
+            }
+            matrix[row][column] = (float)sum;
+        }
+    }
+}
+
+// The primaries' XYZ at unit luminance, scaled so that RGB 1, 1, 1 is the white point
+static void color_gamut_to_xyz(ColorGamut gamut, double matrix[3][3]) {
+    double primaries[3][3], inverse[3][3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        double x = color_primaries[gamut][i][0];
+        double y = color_primaries[gamut][i][1];
+        primaries[0][i] = x / y;
+        primaries[1][i] = 1.0;
+        primaries[2][i] = (1.0 - x - y) / y;
+    }
+    color_invert(primaries, inverse);
+
+    double white[3] = {
+        color_white_point[0] / color_white_point[1],
+        1.0,
+        (1.0 - color_white_point[0] - color_white_point[1]) / color_white_point[1],
+    };
+    for (uint32_t column = 0; column < 3; ++column) {
+        double scale = inverse[column][0] * white[0] + inverse[column][1] * white[1] + inverse[column][2] * white[2];
+        for (uint32_t row = 0; row < 3; ++row) {
+            matrix[row][column] = primaries[row][column] * scale;
+        }
+    }
+}
+
+static void color_invert(double matrix[3][3], double inverse[3][3]) {
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t column = 0; column < 3; ++column) {
+            // Cofactors of the transpose, the cyclic indices take care of the signs
+            uint32_t r0 = (column + 1) % 3, r1 = (column + 2) % 3;
+            uint32_t c0 = (row + 1) % 3, c1 = (row + 2) % 3;
+            inverse[row][column] = matrix[r0][c0] * matrix[r1][c1] - matrix[r0][c1] * matrix[r1][c0];
+        }
+    }
+
+    double determinant = matrix[0][0] * inverse[0][0] + matrix[0][1] * inverse[1][0] + matrix[0][2] * inverse[2][0];
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t column = 0; column < 3; ++column) {
+            inverse[row][column] /= determinant;
+        }
+    }
+}
+
+static inline float color_half_to_float(uint16_t half) {
+    // Shifted into place, multiplying by 2^112 rebiases normals and denormals alike
+    uint32_t magnitude = (uint32_t)(half & 0x7FFF) << 13;
+    float    value = color_bits_float(magnitude) * color_bits_float(0x77800000);
+    uint32_t bits = color_float_bits(value) | (magnitude >= (0x7C00u << 13) ? 0x7F800000u : 0u);
+    return color_bits_float(bits | (uint32_t)(half & 0x8000) << 16);
+}
+
+static inline uint16_t color_float_to_half(float value) {
+    uint32_t bits = color_float_bits(value);
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    // Overflow to infinity, NaN stays NaN
+    uint32_t special = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+
+    // Denormals: adding 0.5 aligns the mantissa to the half's and rounds it to nearest even
+    uint32_t denormal = color_float_bits(color_bits_float(bits) + 0.5f) - 0x3F000000u;
+
+    // Normals: rebias, then round the 13 dropped bits to nearest even
+    uint32_t normal = (bits + ((uint32_t)(15 - 127) << 23) + 0xFFFu + ((bits >> 13) & 1u)) >> 13;
+
+    uint32_t half = bits >= 0x47800000u ? special : bits < 0x38800000u ? denormal : normal;
+    return (uint16_t)(half | sign >> 16);
+}
+
+// Planar RGB, red at 0, green at COLOR_TILE_WIDTH and blue at twice that
+static void color_load(ColorLayout layout, const uint8_t *p_src, uint32_t count, float *p_rgb, float *p_alpha) {
+    float *p_r = p_rgb, *p_g = p_rgb + COLOR_TILE_WIDTH, *p_b = p_rgb + COLOR_TILE_WIDTH * 2;
+
+    switch (layout) {
+        case COLOR_LAYOUT_RGBA8:
+        case COLOR_LAYOUT_BGRA8: {
+            uint32_t red = layout == COLOR_LAYOUT_RGBA8 ? 0 : 2;
+            for (uint32_t i = 0; i < count; ++i) {
+                p_r[i] = (float)p_src[i * 4 + red] * (1.0f / 255.0f);
+                p_g[i] = (float)p_src[i * 4 + 1] * (1.0f / 255.0f);
+                p_b[i] = (float)p_src[i * 4 + (2 - red)] * (1.0f / 255.0f);
+                p_alpha[i] = (float)p_src[i * 4 + 3] * (1.0f / 255.0f);
+            }
+            break;
+        }
+        case COLOR_LAYOUT_RGB10A2:
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t texel;
+                memcpy(&texel, p_src + i * 4, sizeof(texel));
+                p_r[i] = (float)(texel & 0x3FF) * (1.0f / 1023.0f);
+                p_g[i] = (float)((texel >> 10) & 0x3FF) * (1.0f / 1023.0f);
+                p_b[i] = (float)((texel >> 20) & 0x3FF) * (1.0f / 1023.0f);
+                p_alpha[i] = (float)(texel >> 30) * (1.0f / 3.0f);
+            }
+            break;
+        case COLOR_LAYOUT_RGBA16F:
+            for (uint32_t i = 0; i < count; ++i) {
+                uint16_t texel[4];
+                memcpy(texel, p_src + i * 8, sizeof(texel));
+                p_r[i] = color_half_to_float(texel[0]);
+                p_g[i] = color_half_to_float(texel[1]);
+                p_b[i] = color_half_to_float(texel[2]);
+                p_alpha[i] = color_half_to_float(texel[3]);
+            }
+            break;
+        case COLOR_LAYOUT_RGBA32F:
+            for (uint32_t i = 0; i < count; ++i) {
+                float texel[4];
+                memcpy(texel, p_src + i * 16, sizeof(texel));
+                p_r[i] = texel[0];
+                p_g[i] = texel[1];
+                p_b[i] = texel[2];
+                p_alpha[i] = texel[3];
+            }
+            break;
+    }
+
+    // The curves run over whole tiles, keep the unused tail finite
+    for (uint32_t i = count; i < COLOR_TILE_WIDTH; ++i) {
+        p_r[i] = p_g[i] = p_b[i] = 0.0f;
+    }
+}
+
+static void color_store(ColorLayout layout, const float *p_rgb, const float *p_alpha, uint32_t count, uint8_t *p_dst) {
+    const float *p_r = p_rgb, *p_g = p_rgb + COLOR_TILE_WIDTH, *p_b = p_rgb + COLOR_TILE_WIDTH * 2;
+
+    switch (layout) {
+        case COLOR_LAYOUT_RGBA8:
+        case COLOR_LAYOUT_BGRA8: {
+            uint32_t red = layout == COLOR_LAYOUT_RGBA8 ? 0 : 2;
+            for (uint32_t i = 0; i < count; ++i) {
+                p_dst[i * 4 + red] = (uint8_t)(VRI_MIN(VRI_MAX(p_r[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+                p_dst[i * 4 + 1] = (uint8_t)(VRI_MIN(VRI_MAX(p_g[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+                p_dst[i * 4 + (2 - red)] = (uint8_t)(VRI_MIN(VRI_MAX(p_b[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+                p_dst[i * 4 + 3] = (uint8_t)(VRI_MIN(VRI_MAX(p_alpha[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+            }
+            break;
+        }
+        case COLOR_LAYOUT_RGB10A2:
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t r = (uint32_t)(VRI_MIN(VRI_MAX(p_r[i], 0.0f), 1.0f) * 1023.0f + 0.5f);
+                uint32_t g = (uint32_t)(VRI_MIN(VRI_MAX(p_g[i], 0.0f), 1.0f) * 1023.0f + 0.5f);
+                uint32_t b = (uint32_t)(VRI_MIN(VRI_MAX(p_b[i], 0.0f), 1.0f) * 1023.0f + 0.5f);
+                uint32_t a = (uint32_t)(VRI_MIN(VRI_MAX(p_alpha[i], 0.0f), 1.0f) * 3.0f + 0.5f);
+                uint32_t texel = r | g << 10 | b << 20 | a << 30;
+                memcpy(p_dst + i * 4, &texel, sizeof(texel));
+            }
+            break;
+        case COLOR_LAYOUT_RGBA16F:
+            for (uint32_t i = 0; i < count; ++i) {
+                uint16_t texel[4] = {color_float_to_half(p_r[i]), color_float_to_half(p_g[i]), color_float_to_half(p_b[i]), color_float_to_half(p_alpha[i])};
+                memcpy(p_dst + i * 8, texel, sizeof(texel));
+            }
+            break;
+        case COLOR_LAYOUT_RGBA32F:
+            for (uint32_t i = 0; i < count; ++i) {
+                float texel[4] = {p_r[i], p_g[i], p_b[i], p_alpha[i]};
+                memcpy(p_dst + i * 16, texel, sizeof(texel));
+            }
+            break;
+    }
+}
+
+// To linear, 1.0 at reference white. The SDR curves are mirrored for the
+// negative values of extended ranges. count is a multiple of 4
+static void color_decode(ColorCurve curve, float pq_scale, float *p_values, uint32_t count) {
+    if (curve == COLOR_CURVE_LINEAR) return;
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        ColorVec v = color_load4(&p_values[i]);
+        ColorVec value = color_abs(v);
+
+        switch (curve) {
+            case COLOR_CURVE_LINEAR:
+                break;
+            case COLOR_CURVE_SRGB: {
+                ColorVec low = color_mul(value, color_set(1.0f / 12.92f));
+                ColorVec high = color_pow(color_mul(color_add(value, color_set(0.055f)), color_set(1.0f / 1.055f)), 2.4f);
+                v = color_copy_sign(color_select(color_le(value, color_set(0.04045f)), low, high), v);
+                break;
+            }
+            case COLOR_CURVE_BT709: {
+                ColorVec low = color_mul(value, color_set(1.0f / 4.5f));
+                ColorVec high = color_pow(color_mul(color_add(value, color_set(0.099f)), color_set(1.0f / 1.099f)), 1.0f / 0.45f);
+                v = color_copy_sign(color_select(color_le(value, color_set(0.081f)), low, high), v);
+                break;
+            }
+            case COLOR_CURVE_PQ: {
+                ColorVec power = color_pow(color_min(color_max(v, color_set(0.0f)), color_set(1.0f)), 1.0f / COLOR_PQ_M2);
+                ColorVec ratio = color_div(color_max(color_sub(power, color_set(COLOR_PQ_C1)), color_set(0.0f)),
+                                           color_sub(color_set(COLOR_PQ_C2), color_mul(color_set(COLOR_PQ_C3), power)));
+                v = color_mul(color_pow(ratio, 1.0f / COLOR_PQ_M1), color_set(1.0f / pq_scale));
+                break;
+            }
+            case COLOR_CURVE_HLG: {
+                value = color_max(v, color_set(0.0f));
+                ColorVec low = color_mul(color_mul(value, value), color_set(1.0f / 3.0f));
+                // exp((E' - c) / a) as a power of two
+                ColorVec high = color_exp2(color_mul(color_sub(value, color_set(COLOR_HLG_C)), color_set(1.0f / (COLOR_HLG_A * 0.693147181f))));
+                high = color_mul(color_add(high, color_set(COLOR_HLG_B)), color_set(1.0f / 12.0f));
+                v = color_mul(color_select(color_le(value, color_set(0.5f)), low, high), color_set(1.0f / COLOR_HLG_REFERENCE_WHITE));
+                break;
+            }
+        }
+
+        color_store4(&p_values[i], v);
+    }
+}
+
+static void color_encode(ColorCurve curve, float pq_scale, float *p_values, uint32_t count) {
+    if (curve == COLOR_CURVE_LINEAR) return;
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        ColorVec v = color_load4(&p_values[i]);
+        ColorVec value = color_abs(v);
+
+        switch (curve) {
+            case COLOR_CURVE_LINEAR:
+                break;
+            case COLOR_CURVE_SRGB: {
+                ColorVec low = color_mul(value, color_set(12.92f));
+                ColorVec high = color_sub(color_mul(color_pow(value, 1.0f / 2.4f), color_set(1.055f)), color_set(0.055f));
+                v = color_copy_sign(color_select(color_le(value, color_set(0.0031308f)), low, high), v);
+                break;
+            }
+            case COLOR_CURVE_BT709: {
+                ColorVec low = color_mul(value, color_set(4.5f));
+                ColorVec high = color_sub(color_mul(color_pow(value, 0.45f), color_set(1.099f)), color_set(0.099f));
+                v = color_copy_sign(color_select(color_le(value, color_set(0.018f)), low, high), v);
+                break;
+            }
+            case COLOR_CURVE_PQ: {
+                ColorVec power = color_pow(color_min(color_max(color_mul(v, color_set(pq_scale)), color_set(0.0f)), color_set(1.0f)), COLOR_PQ_M1);
+                ColorVec ratio = color_div(color_add(color_set(COLOR_PQ_C1), color_mul(color_set(COLOR_PQ_C2), power)),
+                                           color_add(color_set(1.0f), color_mul(color_set(COLOR_PQ_C3), power)));
+                v = color_pow(ratio, COLOR_PQ_M2);
+                break;
+            }
+            case COLOR_CURVE_HLG: {
+                value = color_max(color_mul(v, color_set(COLOR_HLG_REFERENCE_WHITE)), color_set(0.0f));
+                ColorVec low = color_sqrt(color_mul(value, color_set(3.0f)));
+                // a * ln(12E - b) + c, the log's argument only matters above 1 / 12
+                ColorVec high = color_log2(color_max(color_sub(color_mul(value, color_set(12.0f)), color_set(COLOR_HLG_B)), color_set(FLT_MIN)));
+                high = color_add(color_mul(high, color_set(COLOR_HLG_A * 0.693147181f)), color_set(COLOR_HLG_C));
+                v = color_select(color_le(value, color_set(1.0f / 12.0f)), low, high);
+                break;
+            }
+        }
+
+        color_store4(&p_values[i], v);
+    }
+}
+
+static void color_transform(float matrix[3][3], float *p_rgb, uint32_t count) {
+    float *p_r = p_rgb, *p_g = p_rgb + COLOR_TILE_WIDTH, *p_b = p_rgb + COLOR_TILE_WIDTH * 2;
+    for (uint32_t i = 0; i < count; ++i) {
+        float r = p_r[i], g = p_g[i], b = p_b[i];
+        p_r[i] = matrix[0][0] * r + matrix[0][1] * g + matrix[0][2] * b;
+        p_g[i] = matrix[1][0] * r + matrix[1][1] * g + matrix[1][2] * b;
+        p_b[i] = matrix[2][0] * r + matrix[2][1] * g + matrix[2][2] * b;
+    }
+}
@@ -0,0 +1,135 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Budget-driven eviction. Evictable textures are kept unordered, marking one
+// is a lookup and an append. They are only sorted when the watched heap goes
+// over the threshold, which is rare enough that the sort isn't worth keeping up.
+
+#define EVICTION_DEFAULT_THRESHOLD 0.95f
+#define EVICTION_DEFAULT_TARGET    0.85f
+
+static int32_t eviction_find(VriEvictionManager eviction_manager, VriTexture texture);
+static int     eviction_compare(const void *a, const void *b);
+
+VriResult vri_eviction_manager_create(VriDevice device, const VriEvictionManagerDesc *p_desc, VriEvictionManager *p_eviction_manager) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    float threshold = p_desc->evict_threshold > 0.0f ? p_desc->evict_threshold : EVICTION_DEFAULT_THRESHOLD;
+    float target = p_desc->evict_target > 0.0f ? p_desc->evict_target : EVICTION_DEFAULT_TARGET;
+    if (!p_desc->pfn_evict || (uint32_t)p_desc->heap >= VRI_MEMORY_HEAP_COUNT || target > threshold) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Eviction manager needs an eviction callback, a valid heap and a target at or below the threshold");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    VriEvictionManager eviction_manager = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriEvictionManager_T), VRI_OBJECT_TYPE_EVICTION_MANAGER);
+    if (!eviction_manager) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Eviction Manager struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    eviction_manager->base.p_create_site = VRI_RETURN_ADDRESS();
+#endif
+    eviction_manager->desc = *p_desc;
+    eviction_manager->desc.evict_threshold = threshold;
+    eviction_manager->desc.evict_target = target;
+    eviction_manager->desc.max_resources = p_desc->max_resources ? p_desc->max_resources : VRI_EVICTION_MANAGER_DEFAULT_MAX_RESOURCES;
+
+    VriAllocationCallback *alloc = &device->allocation_callback;
+    eviction_manager->p_resources = alloc->pfn_allocate(sizeof(VriEvictable) * eviction_manager->desc.max_resources, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!eviction_manager->p_resources) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate the Eviction Manager's resource list");
+        vri_eviction_manager_destroy(device, eviction_manager);
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    *p_eviction_manager = eviction_manager;
+    return VRI_SUCCESS;
+}
+
+void vri_eviction_manager_destroy(VriDevice device, VriEvictionManager eviction_manager) {
+    if (!eviction_manager) return;
+
+    VriAllocationCallback *alloc = &device->allocation_callback;
+    if (eviction_manager->p_resources) {
+        alloc->pfn_free(eviction_manager->p_resources, sizeof(VriEvictable) * eviction_manager->desc.max_resources, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+
+    vri_object_free(device, alloc, eviction_manager, sizeof(struct VriEvictionManager_T));
+}
+
+VriResult vri_eviction_manager_set_evictable(VriEvictionManager eviction_manager, VriTexture texture, int32_t priority) {
+    int32_t index = eviction_find(eviction_manager, texture);
+    if (index < 0) {
+        if (eviction_manager->resource_count == eviction_manager->desc.max_resources) {
+            return VRI_ERROR_OUT_OF_MEMORY;
+        }
+        index = (int32_t)eviction_manager->resource_count++;
+        eviction_manager->p_resources[index].texture = texture;
+        eviction_manager->p_resources[index].size = vri_texture_size(&texture->desc);
+    }
+
+    eviction_manager->p_resources[index].priority = priority;
+    eviction_manager->p_resources[index].sequence = eviction_manager->next_sequence++;
+    return VRI_SUCCESS;
+}
+
+VriResult vri_eviction_manager_remove(VriEvictionManager eviction_manager, VriTexture texture) {
+    int32_t index = eviction_find(eviction_manager, texture);
+    if (index < 0) return VRI_INCOMPLETE;
+
+    eviction_manager->p_resources[index] = eviction_manager->p_resources[--eviction_manager->resource_count];
+    return VRI_SUCCESS;
+}
+
+VriResult vri_eviction_manager_update(VriEvictionManager eviction_manager, uint64_t *p_evicted_bytes) {
+    if (p_evicted_bytes) *p_evicted_bytes = 0;
+
+    VriMemoryBudget budget = {0};
+    VriResult       result = vri_device_query_memory_budget(eviction_manager->base.p_device, &budget);
+    if (VRI_ERROR(result)) return result;
+
+    const VriMemoryHeapBudget *heap = &budget.heaps[eviction_manager->desc.heap];
+    if ((double)heap->usage <= (double)heap->budget * eviction_manager->desc.evict_threshold) {
+        return VRI_SUCCESS;
+    }
+
+    // Lowest priority and least recently marked first
+    VriEvictable *resources = eviction_manager->p_resources;
+    uint32_t      count = eviction_manager->resource_count;
+    qsort(resources, count, sizeof(VriEvictable), eviction_compare);
+
+    uint64_t target = (uint64_t)((double)heap->budget * eviction_manager->desc.evict_target);
+    uint64_t excess = heap->usage - target;
+    uint64_t evicted = 0;
+    uint32_t evicted_count = 0;
+    while (evicted < excess && evicted_count < count) {
+        evicted += resources[evicted_count++].size;
+    }
+
+    for (uint32_t i = 0; i < evicted_count; ++i) {
+        eviction_manager->desc.pfn_evict(eviction_manager->desc.p_user_data, resources[i].texture, resources[i].size);
+    }
+    memmove(resources, resources + evicted_count, sizeof(VriEvictable) * (count - evicted_count));
+    eviction_manager->resource_count = count - evicted_count;
+
+    if (p_evicted_bytes) *p_evicted_bytes = evicted;
+    return evicted < excess ? VRI_INCOMPLETE : VRI_SUCCESS;
+}
+
+static int32_t eviction_find(VriEvictionManager eviction_manager, VriTexture texture) {
+    for (uint32_t i = 0; i < eviction_manager->resource_count; ++i) {
+        if (eviction_manager->p_resources[i].texture == texture) return (int32_t)i;
+    }
+    return -1;
+}
+
+static int eviction_compare(const void *a, const void *b) {
+    const VriEvictable *x = a;
+    const VriEvictable *y = b;
+    if (x->priority != y->priority) return x->priority < y->priority ? -1 : 1;
+    return x->sequence < y->sequence ? -1 : (x->sequence > y->sequence);
+}
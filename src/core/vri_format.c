@@ -0,0 +1,57 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+// Everything size related is a lookup in this table, so it's indexed by the
+// format directly and has an entry for every format, UNDEFINED being all zero
+
+#define COLOR   VRI_FORMAT_ASPECT_FLAG_BIT_COLOR
+#define DEPTH   VRI_FORMAT_ASPECT_FLAG_BIT_DEPTH
+#define STENCIL VRI_FORMAT_ASPECT_FLAG_BIT_STENCIL
+
+#define TEXEL(size, aspects, family) {(size), 1, 1, VRI_FALSE, (aspects), VRI_FORMAT_##family}
+#define TEXEL_SRGB(size, family)     {(size), 1, 1, VRI_TRUE, COLOR, VRI_FORMAT_##family}
+#define BLOCK(size, family)          {(size), 4, 4, VRI_FALSE, COLOR, VRI_FORMAT_##family}
+#define BLOCK_SRGB(size, family)     {(size), 4, 4, VRI_TRUE, COLOR, VRI_FORMAT_##family}
+
+const VriFormatInfo vri_format_infos[VRI_FORMAT_COUNT] = {
+    [VRI_FORMAT_UNDEFINED] = {0},
+    [VRI_FORMAT_R8G8B8A8_UNORM] = TEXEL(4, COLOR, R8G8B8A8_UNORM),
+    [VRI_FORMAT_R8G8B8A8_SRGB] = TEXEL_SRGB(4, R8G8B8A8_UNORM),
+    [VRI_FORMAT_B8G8R8A8_UNORM] = TEXEL(4, COLOR, B8G8R8A8_UNORM),
+    [VRI_FORMAT_B8G8R8A8_SRGB] = TEXEL_SRGB(4, B8G8R8A8_UNORM),
+    [VRI_FORMAT_R8_UNORM] = TEXEL(1, COLOR, R8_UNORM),
+    [VRI_FORMAT_R8G8_UNORM] = TEXEL(2, COLOR, R8G8_UNORM),
+    [VRI_FORMAT_R10G10B10A2_UNORM] = TEXEL(4, COLOR, R10G10B10A2_UNORM),
+    [VRI_FORMAT_R11G11B10_FLOAT] = TEXEL(4, COLOR, R11G11B10_FLOAT),
+    [VRI_FORMAT_R16_FLOAT] = TEXEL(2, COLOR, R16_FLOAT),
+    [VRI_FORMAT_R16G16_FLOAT] = TEXEL(4, COLOR, R16G16_FLOAT),
+    [VRI_FORMAT_R16G16B16A16_FLOAT] = TEXEL(8, COLOR, R16G16B16A16_FLOAT),
+    [VRI_FORMAT_R32_FLOAT] = TEXEL(4, COLOR, R32_FLOAT),
+    [VRI_FORMAT_R32G32_FLOAT] = TEXEL(8, COLOR, R32G32_FLOAT),
+    [VRI_FORMAT_R32G32B32_FLOAT] = TEXEL(12, COLOR, R32G32B32_FLOAT),
+    [VRI_FORMAT_R32G32B32A32_FLOAT] = TEXEL(16, COLOR, R32G32B32A32_FLOAT),
+    [VRI_FORMAT_R16_UINT] = TEXEL(2, COLOR, R16_FLOAT),
+    [VRI_FORMAT_R32_UINT] = TEXEL(4, COLOR, R32_FLOAT),
+    [VRI_FORMAT_D16_UNORM] = TEXEL(2, DEPTH, D16_UNORM),
+    [VRI_FORMAT_D24_UNORM_S8_UINT] = TEXEL(4, DEPTH | STENCIL, D24_UNORM_S8_UINT),
+    [VRI_FORMAT_D32_FLOAT] = TEXEL(4, DEPTH, D32_FLOAT),
+    [VRI_FORMAT_D32_FLOAT_S8_UINT] = TEXEL(8, DEPTH | STENCIL, D32_FLOAT_S8_UINT),
+    [VRI_FORMAT_BC1_UNORM] = BLOCK(8, BC1_UNORM),
+    [VRI_FORMAT_BC1_SRGB] = BLOCK_SRGB(8, BC1_UNORM),
+    [VRI_FORMAT_BC2_UNORM] = BLOCK(16, BC2_UNORM),
+    [VRI_FORMAT_BC2_SRGB] = BLOCK_SRGB(16, BC2_UNORM),
+    [VRI_FORMAT_BC3_UNORM] = BLOCK(16, BC3_UNORM),
+    [VRI_FORMAT_BC3_SRGB] = BLOCK_SRGB(16, BC3_UNORM),
+    [VRI_FORMAT_BC4_UNORM] = BLOCK(8, BC4_UNORM),
+    [VRI_FORMAT_BC4_SNORM] = BLOCK(8, BC4_UNORM),
+    [VRI_FORMAT_BC5_UNORM] = BLOCK(16, BC5_UNORM),
+    [VRI_FORMAT_BC5_SNORM] = BLOCK(16, BC5_UNORM),
+    [VRI_FORMAT_BC6H_UFLOAT] = BLOCK(16, BC6H_UFLOAT),
+    [VRI_FORMAT_BC6H_SFLOAT] = BLOCK(16, BC6H_UFLOAT),
+    [VRI_FORMAT_BC7_UNORM] = BLOCK(16, BC7_UNORM),
+    [VRI_FORMAT_BC7_SRGB] = BLOCK_SRGB(16, BC7_UNORM),
+};
+
+const VriFormatInfo *vri_format_get_info(VriFormat format) {
+    return VRI_FORMAT_INFO((uint32_t)format < VRI_FORMAT_COUNT ? format : VRI_FORMAT_UNDEFINED);
+}
@@ -0,0 +1,154 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+// Headless swapchains. An image goes from available to acquired, to queued
+// when it's presented and to displayed on a vblank of a virtual clock ticking
+// at the refresh rate. It becomes available again once the next image is
+// displayed. The clock is only looked at when the swapchain is used, vblanks
+// that passed in between are caught up with on the next acquire or present.
+
+#define HEADLESS_DEFAULT_TEXTURE_COUNT 2
+
+static void headless_advance(VriHeadlessPresenter *presenter, uint64_t now);
+static void headless_display(VriHeadlessPresenter *presenter, uint32_t image_index, uint64_t time_ns);
+static void headless_sleep_until(uint64_t time_ns);
+
+VriResult vri_headless_presenter_init(VriHeadlessPresenter *presenter, const VriSwapchainDesc *p_desc) {
+    uint32_t texture_count = p_desc->texture_count ? p_desc->texture_count : HEADLESS_DEFAULT_TEXTURE_COUNT;
+    uint32_t refresh_rate = p_desc->refresh_rate ? p_desc->refresh_rate : VRI_SWAPCHAIN_DEFAULT_REFRESH_RATE;
+
+    // One image is always on display, so a single one could never be acquired again
+    if (texture_count < 2 || texture_count > VRI_SWAPCHAIN_MAX_TEXTURES || (uint32_t)p_desc->present_mode >= VRI_PRESENT_MODE_COUNT) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    *presenter = (VriHeadlessPresenter){
+        .present_mode = p_desc->present_mode,
+        .texture_count = texture_count,
+        .displayed = UINT32_MAX,
+        .last_acquired = UINT32_MAX,
+        .stats.refresh_period_ns = 1000000000ull / refresh_rate,
+    };
+    presenter->next_vblank_ns = vri_time_ns() + presenter->stats.refresh_period_ns;
+
+    return VRI_SUCCESS;
+}
+
+VriResult vri_headless_presenter_acquire(VriHeadlessPresenter *presenter, uint32_t *p_image_index) {
+    for (;;) {
+        headless_advance(presenter, vri_time_ns());
+
+        for (uint32_t i = 0; i < presenter->texture_count; ++i) {
+            uint32_t image = (presenter->next_acquire + i) % presenter->texture_count;
+            if (presenter->states[image] != VRI_HEADLESS_IMAGE_AVAILABLE) continue;
+
+            presenter->states[image] = VRI_HEADLESS_IMAGE_ACQUIRED;
+            presenter->last_acquired = image;
+            presenter->next_acquire = (image + 1) % presenter->texture_count;
+            *p_image_index = image;
+            return VRI_SUCCESS;
+        }
+
+        // Only a vblank showing a queued image frees one, without any waiting would never end
+        if (!presenter->queue_count) return VRI_ERROR_INVALID_API_USAGE;
+        headless_sleep_until(presenter->next_vblank_ns);
+    }
+}
+
+VriResult vri_headless_presenter_present(VriHeadlessPresenter *presenter, uint32_t image_index) {
+    if (image_index >= presenter->texture_count || presenter->states[image_index] != VRI_HEADLESS_IMAGE_ACQUIRED) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    uint64_t now = vri_time_ns();
+    headless_advance(presenter, now);
+
+    presenter->stats.present_count++;
+    if (presenter->last_acquired == image_index) presenter->last_acquired = UINT32_MAX;
+
+    switch (presenter->present_mode) {
+        case VRI_PRESENT_MODE_IMMEDIATE:
+            headless_display(presenter, image_index, now);
+            return VRI_SUCCESS;
+        case VRI_PRESENT_MODE_MAILBOX:
+            // The mailbox holds one image, the one waiting in it is never shown
+            if (presenter->queue_count) {
+                presenter->states[presenter->queue[0]] = VRI_HEADLESS_IMAGE_AVAILABLE;
+                presenter->queue_count = 0;
+                presenter->stats.drop_count++;
+            }
+            break;
+        default:
+            break;
+    }
+
+    presenter->states[image_index] = VRI_HEADLESS_IMAGE_QUEUED;
+    presenter->queue[presenter->queue_count++] = (uint8_t)image_index;
+    return VRI_SUCCESS;
+}
+
+static void headless_advance(VriHeadlessPresenter *presenter, uint64_t now) {
+    uint64_t period = presenter->stats.refresh_period_ns;
+
+    // Every vblank shows the oldest queued image
+    while (presenter->queue_count && presenter->next_vblank_ns <= now) {
+        uint32_t image = presenter->queue[0];
+        memmove(presenter->queue, presenter->queue + 1, --presenter->queue_count);
+        headless_display(presenter, image, presenter->next_vblank_ns);
+        presenter->next_vblank_ns += period;
+    }
+
+    // The rest had nothing new and showed the same image again
+    if (presenter->next_vblank_ns <= now) {
+        uint64_t missed = (now - presenter->next_vblank_ns) / period + 1;
+        if (presenter->present_mode != VRI_PRESENT_MODE_IMMEDIATE && presenter->displayed != UINT32_MAX) {
+            presenter->stats.repeat_count += missed;
+        }
+        presenter->next_vblank_ns += missed * period;
+    }
+}
+
+static void headless_display(VriHeadlessPresenter *presenter, uint32_t image_index, uint64_t time_ns) {
+    if (presenter->displayed != UINT32_MAX) {
+        presenter->states[presenter->displayed] = VRI_HEADLESS_IMAGE_AVAILABLE;
+    }
+    presenter->states[image_index] = VRI_HEADLESS_IMAGE_DISPLAYED;
+    presenter->displayed = image_index;
+
+    presenter->stats.display_count++;
+    presenter->stats.last_display_ns = time_ns;
+}
+
+static void headless_sleep_until(uint64_t time_ns) {
+    uint64_t now;
+    while ((now = vri_time_ns()) < time_ns) {
+#if defined(_WIN32)
+        // Sleep is only good to a scheduler tick, the last millisecond is yielded away
+        uint64_t remaining_ms = (time_ns - now) / 1000000;
+        if (remaining_ms > 1) {
+            Sleep((DWORD)(remaining_ms - 1));
+        } else {
+            SwitchToThread();
+        }
+#else
+        uint64_t        remaining = time_ns - now;
+        struct timespec ts = {
+            .tv_sec = (time_t)(remaining / 1000000000ull),
+            .tv_nsec = (long)(remaining % 1000000000ull),
+        };
+        nanosleep(&ts, NULL);
+#endif
+    }
+}
@@ -4,36 +4,79 @@
 #include "vri/vri.h"
 
 #define MAX_QUEUES_PER_TYPE 4
+#define VRI_CACHE_LINE_SIZE 64
 
-typedef enum {
-    VRI_OBJECT_DEVICE,
-    VRI_OBJECT_COMMAND_POOL,
-    VRI_OBJECT_COMMAND_BUFFER,
-    VRI_OBJECT_QUEUE,
-    VRI_OBJECT_PIPELINE_LAYOUT,
-    VRI_OBJECT_PIPELINE,
-    VRI_OBJECT_TEXTURE,
-    VRI_OBJECT_FENCE,
-    VRI_OBJECT_SWAPCHAIN,
-} VriObjectType;
+// Relaxed atomics for the statistics counters. Nothing is ordered against them,
+// they only need to not tear and not lose increments.
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define VRI_ATOMIC_ADD_U64(ptr, value)      _InterlockedExchangeAdd64((volatile long long *)(ptr), (long long)(value))
+#    define VRI_ATOMIC_LOAD_U64(ptr)            ((uint64_t)_InterlockedOr64((volatile long long *)(ptr), 0))
+#    define VRI_ATOMIC_STORE_U64(ptr, value)    _InterlockedExchange64((volatile long long *)(ptr), (long long)(value))
+#    define VRI_ATOMIC_EXCHANGE_U64(ptr, value) ((uint64_t)_InterlockedExchange64((volatile long long *)(ptr), (long long)(value)))
+#else
+#    define VRI_ATOMIC_ADD_U64(ptr, value)      __atomic_fetch_add((ptr), (uint64_t)(value), __ATOMIC_RELAXED)
+#    define VRI_ATOMIC_LOAD_U64(ptr)            __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#    define VRI_ATOMIC_STORE_U64(ptr, value)    __atomic_store_n((ptr), (uint64_t)(value), __ATOMIC_RELAXED)
+#    define VRI_ATOMIC_EXCHANGE_U64(ptr, value) __atomic_exchange_n((ptr), (uint64_t)(value), __ATOMIC_RELAXED)
+#endif
+
+#define VRI_STAT_ADD(device, counter, value) VRI_ATOMIC_ADD_U64(&(device)->stats.counter, (value))
+
+// Debug builds remember the call site that created every object, for the live object report
+#if !defined(VRI_ENABLE_OBJECT_TRACKING) && defined(_DEBUG)
+#    define VRI_ENABLE_OBJECT_TRACKING 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    define VRI_RETURN_ADDRESS() _ReturnAddress()
+#else
+#    define VRI_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+// For short critical sections only, waiters spin instead of sleeping
+typedef struct {
+    volatile long locked;
+} VriSpinlock;
+
+// Type of a pooled slot whose object was destroyed
+#define VRI_OBJECT_TYPE_DESTROYED ((VriObjectType)0x7FFFFFFE)
 
 typedef struct {
     VriObjectType       type;
+    uint32_t            capture_id; // Assigned by the capture layer, 0 if the object was never captured
     struct VriDevice_T *p_device;
+    uint32_t            generation; // Bumped whenever the slot is freed, references taken before can tell the object is gone
+#if VRI_ENABLE_OBJECT_TRACKING
+    const void         *p_create_site; // Return address of the vri_* call that created the object, NULL if created internally
+#endif
 } VriObjectBase;
 
 typedef struct {
     PFN_VriDeviceDestroy             pfn_device_destroy;
+    PFN_VriDeviceQueryMemoryBudget   pfn_device_query_memory_budget;
     PFN_VriCommandPoolCreate         pfn_command_pool_create;
     PFN_VriCommandPoolDestroy        pfn_command_pool_destroy;
     PFN_VriCommandPoolReset          pfn_command_pool_reset;
     PFN_VriCommandBuffersAllocate    pfn_command_buffers_allocate;
     PFN_VriCommandBuffersFree        pfn_command_buffers_free;
+    PFN_VriShaderModuleCreate        pfn_shader_module_create;
+    PFN_VriShaderModuleDestroy       pfn_shader_module_destroy;
     PFN_VriPipelineLayoutCreate      pfn_pipeline_layout_create;
     PFN_VriPipelineCreateGraphics    pfn_pipeline_create_graphics;
     PFN_VriPipelineCreateCompute     pfn_pipeline_create_compute;
+    PFN_VriPipelineDestroy           pfn_pipeline_destroy;
+    PFN_VriPipelineLibraryCreate     pfn_pipeline_library_create;
+    PFN_VriPipelineLibraryDestroy    pfn_pipeline_library_destroy;
+    PFN_VriPipelineLink              pfn_pipeline_link;
     PFN_VriTextureCreate             pfn_texture_create;
     PFN_VriTextureDestroy            pfn_texture_destroy;
+    PFN_VriTextureGetTiling          pfn_texture_get_tiling;
+    PFN_VriTextureGetTileFeedback    pfn_texture_get_tile_feedback;
+    PFN_VriTextureMap                pfn_texture_map;
+    PFN_VriTextureUnmap              pfn_texture_unmap;
+    PFN_VriTileHeapCreate            pfn_tile_heap_create;
+    PFN_VriTileHeapDestroy           pfn_tile_heap_destroy;
     PFN_VriFenceCreate               pfn_fence_create;
     PFN_VriFenceDestroy              pfn_fence_destroy;
     PFN_VriFenceGetValue             pfn_fence_get_value;
@@ -42,32 +85,127 @@ typedef struct {
     PFN_VriSwapchainDestroy          pfn_swapchain_destroy;
     PFN_VriSwapchainAcquireNextImage pfn_swapchain_acquire_next_image;
     PFN_VriSwapchainPresent          pfn_swapchain_present;
+    PFN_VriSwapchainGetTexture       pfn_swapchain_get_texture;
+    PFN_VriSwapchainGetStats         pfn_swapchain_get_stats;
 } VriDeviceDispatchTable;
 
 typedef struct {
-    PFN_VriCommandBufferBegin pfn_command_buffer_begin;
-    PFN_VriCommandBufferEnd   pfn_command_buffer_end;
-    PFN_VriCommandBufferReset pfn_command_buffer_reset;
-    PFN_VriCmdBindPipeline    pfn_cmd_bind_pipeline;
+    PFN_VriCommandBufferBegin     pfn_command_buffer_begin;
+    PFN_VriCommandBufferEnd       pfn_command_buffer_end;
+    PFN_VriCommandBufferReset     pfn_command_buffer_reset;
+    PFN_VriCmdBindPipeline        pfn_cmd_bind_pipeline;
+    PFN_VriCmdUpdateTexture       pfn_cmd_update_texture;
+    PFN_VriCmdGenerateMips        pfn_cmd_generate_mips;
+    PFN_VriCmdCopyTexture         pfn_cmd_copy_texture;
+    PFN_VriCmdSetViewport         pfn_cmd_set_viewport;
+    PFN_VriCmdSetScissor          pfn_cmd_set_scissor;
+    PFN_VriCmdSetStencilReference pfn_cmd_set_stencil_reference;
+    PFN_VriCmdSetBlendConstants   pfn_cmd_set_blend_constants;
+    PFN_VriCmdSetDepthBias        pfn_cmd_set_depth_bias;
 } VriCommandBufferDispatchTable;
 
+// Recording is externally synchronized, so command buffers count into plain fields
+// and only fold them into the device's atomics once, at vri_command_buffer_end.
+typedef struct {
+    uint64_t command_count;
+    uint64_t pipeline_binds;
+    uint64_t pipeline_binds_redundant;
+} VriCommandBufferStatistics;
+
 typedef struct {
-    PFN_VriQueueSubmit   pfn_queue_submit;
-    PFN_VriQueueWaitIdle pfn_queue_wait_idle;
-    PFN_VriQueuePresent  pfn_queue_present;
+    PFN_VriQueueSubmit     pfn_queue_submit;
+    PFN_VriQueueWaitIdle   pfn_queue_wait_idle;
+    PFN_VriQueuePresent    pfn_queue_present;
+    PFN_VriQueueBindSparse pfn_queue_bind_sparse;
 } VriQueueDispatchTable;
 
+typedef enum {
+    VRI_LAYER_ID_VALIDATION,
+    VRI_LAYER_ID_TRACE,
+    VRI_LAYER_ID_CAPTURE,
+    VRI_LAYER_ID_COUNT,
+} VriLayerId;
+
+// What an installed layer forwards to. Each layer has a fixed slot in the device,
+// so its entry points reach the next table without any lookup.
+typedef struct {
+    VriBool                       enabled;
+    VriDeviceDispatchTable        next_device;
+    VriCommandBufferDispatchTable next_command_buffer;
+    VriQueueDispatchTable         next_queue;
+    void                         *p_layer_data;
+} VriLayerLink;
+
+#define VRI_LAYER_LINK(device, id) (&(device)->layers[(id)])
+
+typedef struct VriObjectSlab VriObjectSlab;
+
+// Per-device, per-type object storage. Slots are a fixed size, set by the first
+// allocation, and live in slabs that are only released with the device. With a
+// quarantine, freed slots queue up behind that many other free slots before
+// they're reused, so stale handles keep pointing at a destroyed object.
+typedef struct {
+    VriSpinlock           lock;
+    size_t                slot_size;
+    VriObjectSlab        *p_slabs;
+    void                 *p_free;      // Handed out first
+    void                 *p_free_tail; // Freed slots go here while quarantining
+    uint32_t              free_count;
+    uint32_t              quarantine;
+    uint32_t              live_count;
+    size_t                reserved_bytes; // All slabs, live and free slots
+    size_t                alignment;
+    VriAllocationCallback allocator; // What the slabs were allocated with
+} VriObjectPool;
+
+// Device-wide shader modules by content hash, chained per bucket
+typedef struct {
+    VriSpinlock      lock;
+    VriShaderModule *p_buckets;
+    uint32_t         bucket_count; // Power of two, 0 until the first module
+    uint32_t         count;
+} VriShaderModuleTable;
+
+// A warm pipeline by desc hash. Taken entries keep their hash and lose their
+// pipeline, so probing goes on past them.
+typedef struct {
+    uint64_t    hash;
+    VriPipeline pipeline;
+} VriWarmPipeline;
+
+// The recording pipeline manifest and the warm pipelines, open addressed by hash
+typedef struct {
+    VriSpinlock         lock;
+    uint64_t            active; // Atomic, nonzero while anything needs desc hashes, creates don't hash otherwise
+    VriPipelineManifest recording;
+    VriWarmPipeline    *p_warm;
+    uint32_t            warm_capacity; // Power of two
+    uint32_t            warm_count;    // Entries still holding a pipeline
+} VriPipelineManifestState;
+
+typedef void (*PFN_VriObjectVisit)(void *p_user_data, VriObjectBase *object);
+
 struct VriDevice_T {
-    VriObjectBase          base;
-    VriDeviceDispatchTable dispatch;
-    VriBackend             backend;
-    VriAllocationCallback  allocation_callback;
-    VriDebugCallback       debug_callback;
-    VriAdapterProps        adapter_props;
-    VriQueue               queues[VRI_QUEUE_TYPE_COUNT][MAX_QUEUES_PER_TYPE];
-    uint32_t               queue_counts[VRI_QUEUE_TYPE_COUNT];
-    VriBool                enable_api_validation;
-    void                  *p_backend_data;
+    VriObjectBase                 base;
+    VriDeviceDispatchTable        dispatch;
+    VriCommandBufferDispatchTable command_buffer_dispatch; // Copied into every allocated command buffer
+    VriQueueDispatchTable         queue_dispatch;          // Copied into every queue
+    VriLayerLink                  layers[VRI_LAYER_ID_COUNT];
+    VriBackend                    backend;
+    VriAllocationCallback         allocation_callback;
+    VriDebugCallback              debug_callback;
+    VriAdapterProps               adapter_props;
+    VriQueue                      queues[VRI_QUEUE_TYPE_COUNT][MAX_QUEUES_PER_TYPE];
+    uint32_t                      queue_counts[VRI_QUEUE_TYPE_COUNT];
+    VriBool                       enable_api_validation;
+    VriStatisticsCounters         stats;
+    VriStatisticsCounters         stats_frame_start;
+    VriStatisticsCounters         stats_last_frame;
+    uint64_t                      stats_frame_count;
+    VriObjectPool                 object_pools[VRI_OBJECT_TYPE_COUNT];
+    VriShaderModuleTable          shader_modules;
+    VriPipelineManifestState      pipeline_manifest;
+    void                         *p_backend_data;
 };
 
 struct VriCommandPool_T {
@@ -75,11 +213,21 @@ struct VriCommandPool_T {
     void         *p_backend_data;
 };
 
+// An object a recorded command uses, with the generation it had when recorded
+typedef struct {
+    const VriObjectBase *object;
+    uint32_t             generation;
+} VriObjectRef;
+
 struct VriCommandBuffer_T {
     VriObjectBase                 base;
     VriCommandBufferDispatchTable dispatch;
-    VriCommandBufferState         state;
+    VriCommandBufferState         state; // Only tracked by the validation layer
+    VriObjectRef                 *p_refs; // Only tracked by the validation layer, checked at submit
+    uint32_t                      ref_count;
+    uint32_t                      ref_capacity;
     VriPipeline                   pipeline;
+    VriCommandBufferStatistics    stats;
     void                         *p_backend_data;
 };
 
@@ -96,8 +244,15 @@ struct VriTexture_T {
     void          *p_backend_data;
 };
 
+struct VriTileHeap_T {
+    VriObjectBase base;
+    uint32_t      tile_count;
+    void         *p_backend_data;
+};
+
 struct VriFence_T {
     VriObjectBase base;
+    uint64_t      last_signaled_value; // Only tracked by the validation layer
     void         *p_backend_data;
 };
 
@@ -111,13 +266,271 @@ struct VriPipeline_T {
     void         *p_backend_data;
 };
 
+struct VriPipelineLibrary_T {
+    VriObjectBase           base;
+    VriPipelineLibraryFlags parts;
+    void                   *p_backend_data;
+};
+
+// The bytecode and entry point are copies owned by the module, so modules
+// can be compared byte for byte and backends can read them after creation
 struct VriShaderModule_T {
-    VriObjectBase base;
-    void         *p_backend_data;
+    VriObjectBase          base;
+    VriShaderModule        p_next; // In its hash bucket
+    uint64_t               hash;
+    uint32_t               ref_count; // Guarded by the shader module table's lock
+    VriShaderStageFlagBits stage;
+    size_t                 size;
+    const void            *p_bytecode;
+    const char            *p_entry_point;
+    void                  *p_backend_data;
+};
+
+typedef struct {
+    VriCommandBuffer command_buffer;
+    uint64_t         fence_value; // Signaled when the batch's last submit is done, 0 if never submitted
+} VriUploadBatch;
+
+// Built on the public API, so every backend and layer sees uploads as plain
+// command buffers, submits and fence waits
+struct VriUploadQueue_T {
+    VriObjectBase  base;
+    VriQueue       queue;
+    VriCommandPool command_pool;
+    VriFence       fence;
+    uint64_t       fence_value; // Last value submitted
+    uint64_t       batch_size;
+    uint64_t       recorded_bytes;
+    uint32_t       batch_count;
+    uint32_t       batch_index;
+    VriBool        recording;
+    VriUploadBatch batches[VRI_UPLOAD_QUEUE_MAX_BATCHES];
+};
+
+typedef struct {
+    VriStreamRequestDesc desc;
+    uint64_t             id; // Also orders equal priorities
+} VriStreamRequest;
+
+// A request being read into its part of the staging ring
+typedef struct {
+    VriStreamRequest request;
+    uint64_t         staging_offset;
+    uint64_t         size;
+    uint64_t         done; // Bytes read so far
+    VriBool          complete;
+    VriBool          failed;
+} VriStreamRead;
+
+typedef struct VriStreamIo VriStreamIo; // The platform's asynchronous reads, private to vri_stream.c
+
+struct VriStreamQueue_T {
+    VriObjectBase     base;
+    VriUploadQueue    upload_queue;
+    uint8_t          *p_staging; // Ring the reads in flight land in, recorded from there once complete
+    uint64_t          staging_size;
+    VriStreamRequest *p_pending;  // Binary max-heap
+    VriStreamRequest *p_streamed; // Waiting for the flush that gives them a fence value
+    VriStreamRead    *p_reads;    // In flight, circular from read_first in the order they started
+    VriStreamIo      *p_io;       // NULL where every read completes as it's started
+    uint32_t          pending_count;
+    uint32_t          read_first;
+    uint32_t          read_count;
+    uint32_t          max_requests; // Also the most reads in flight
+    uint64_t          next_id;
+};
+
+typedef struct {
+    VriTexture texture;
+    uint64_t   size;
+    int32_t    priority;
+    uint64_t   sequence; // Orders equal priorities, oldest first
+} VriEvictable;
+
+struct VriEvictionManager_T {
+    VriObjectBase          base;
+    VriEvictionManagerDesc desc;
+    VriEvictable          *p_resources; // Unordered, only sorted when evicting
+    uint32_t               resource_count;
+    uint64_t               next_sequence;
+};
+
+typedef enum {
+    VRI_READBACK_SLOT_FREE,
+    VRI_READBACK_SLOT_COPYING, // Submitted, mapped once fence_value is reached
+    VRI_READBACK_SLOT_MAPPED,
+} VriReadbackSlotState;
+
+typedef struct {
+    VriTexture           texture;
+    VriCommandBuffer     command_buffer;
+    uint64_t             fence_value;
+    uint64_t             frame_id;
+    VriReadbackSlotState state;
+} VriReadbackSlot;
+
+// Built on the public API like the upload queue. Slots are copied into and
+// mapped in ring order, so the next one to copy into and the oldest one to
+// map are all the state there is besides the slots themselves.
+struct VriReadbackRing_T {
+    VriObjectBase       base;
+    VriReadbackRingDesc desc;
+    VriCommandPool      command_pool;
+    VriFence            fence;
+    uint64_t            fence_value; // Last value submitted
+    uint64_t            next_frame_id;
+    uint32_t            copy_slot;
+    uint32_t            map_slot;
+    VriReadbackSlot     slots[VRI_READBACK_RING_MAX_SLOTS];
 };
 
 void  vri_object_base_init(VriDevice device, VriObjectBase *base, VriObjectType type);
 void *vri_object_allocate(VriDevice device, const VriAllocationCallback *alloc, size_t size, VriObjectType type);
-void  vri_object_free(VriDevice device, const VriAllocationCallback *alloc, void *object);
+void  vri_object_free(VriDevice device, const VriAllocationCallback *alloc, void *object, size_t size);
+
+const char *vri_object_type_name(VriObjectType type);
+
+extern const VriFormatInfo vri_format_infos[VRI_FORMAT_COUNT];
+
+// Unchecked, for formats that already went through validation
+#define VRI_FORMAT_INFO(format) (&vri_format_infos[(format)])
+
+// Bytes in one row of blocks, and rows of blocks, of a region of the format
+static inline uint32_t vri_format_row_pitch(VriFormat format, uint32_t width) {
+    const VriFormatInfo *info = VRI_FORMAT_INFO(format);
+    return (width + info->block_width - 1) / info->block_width * info->block_size;
+}
+
+static inline uint32_t vri_format_row_count(VriFormat format, uint32_t height) {
+    const VriFormatInfo *info = VRI_FORMAT_INFO(format);
+    return (height + info->block_height - 1) / info->block_height;
+}
+
+// Texels covered by one standard 2D tile: VRI_TILE_SIZE bytes of blocks, as
+// square as a power of two allows with the extra factor of two going to width
+static inline void vri_format_tile_extent(VriFormat format, uint32_t *p_width, uint32_t *p_height) {
+    const VriFormatInfo *info = VRI_FORMAT_INFO(format);
+    uint32_t             blocks = VRI_TILE_SIZE / info->block_size;
+    uint32_t             height = 1;
+    while (height * height * 4 <= blocks) height *= 2;
+    *p_width = blocks / height * info->block_width;
+    *p_height = height * info->block_height;
+}
+
+// Bytes a texture's texels take, as a budget estimate. Sparse textures have
+// none of their own, their memory is counted with the tile heaps.
+static inline uint64_t vri_texture_size(const VriTextureDesc *p_desc) {
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_SPARSE) return 0;
+
+    uint64_t size = 0;
+    for (uint32_t mip = 0; mip < p_desc->mip_count; ++mip) {
+        uint32_t width = VRI_MAX(p_desc->width >> mip, 1u);
+        uint32_t height = VRI_MAX(p_desc->height >> mip, 1u);
+        uint32_t depth = VRI_MAX(p_desc->depth >> mip, 1u);
+        size += (uint64_t)vri_format_row_pitch(p_desc->format, width) * vri_format_row_count(p_desc->format, height) * depth;
+    }
+    return size * VRI_MAX(p_desc->layer_count, 1u) * VRI_MAX(p_desc->sample_count, 1u);
+}
+
+// Shader stages and dynamic state owned by pipeline library parts, following
+// the desc members each part reads (see VriPipelineLibraryFlagBits)
+static inline VriShaderStageFlags vri_pipeline_library_stages(VriPipelineLibraryFlags parts) {
+    VriShaderStageFlags stages = 0;
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) {
+        stages |= VRI_SHADER_STAGE_FLAG_BIT_VERTEX | VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_CONTROL | VRI_SHADER_STAGE_FLAG_BIT_TESSELATION_EVALUATION |
+                  VRI_SHADER_STAGE_FLAG_BIT_GEOMETRY;
+    }
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER) stages |= VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT;
+    return stages;
+}
+
+static inline VriDynamicStateFlags vri_pipeline_library_dynamic_states(VriPipelineLibraryFlags parts) {
+    VriDynamicStateFlags states = 0;
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) states |= VRI_DYNAMIC_STATE_FLAG_BIT_SCISSOR | VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS;
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER) states |= VRI_DYNAMIC_STATE_FLAG_BIT_STENCIL_REFERENCE;
+    if (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) states |= VRI_DYNAMIC_STATE_FLAG_BIT_BLEND_CONSTANTS;
+    return states;
+}
+
+// Image cycling of headless swapchains, shared by the backends, which own the
+// textures and signal the acquire fences. Swapchains are externally synchronized.
+typedef enum {
+    VRI_HEADLESS_IMAGE_AVAILABLE,
+    VRI_HEADLESS_IMAGE_ACQUIRED,
+    VRI_HEADLESS_IMAGE_QUEUED,
+    VRI_HEADLESS_IMAGE_DISPLAYED,
+} VriHeadlessImageState;
+
+typedef struct {
+    VriPresentMode    present_mode;
+    uint32_t          texture_count;
+    uint64_t          next_vblank_ns;
+    uint8_t           states[VRI_SWAPCHAIN_MAX_TEXTURES];
+    uint8_t           queue[VRI_SWAPCHAIN_MAX_TEXTURES]; // Presented images waiting for a vblank, oldest first
+    uint32_t          queue_count;
+    uint32_t          displayed;     // UINT32_MAX until the first image is shown
+    uint32_t          last_acquired; // UINT32_MAX when no image is acquired
+    uint32_t          next_acquire;
+    VriSwapchainStats stats;
+} VriHeadlessPresenter;
+
+VriResult vri_headless_presenter_init(VriHeadlessPresenter *presenter, const VriSwapchainDesc *p_desc);
+VriResult vri_headless_presenter_acquire(VriHeadlessPresenter *presenter, uint32_t *p_image_index);
+VriResult vri_headless_presenter_present(VriHeadlessPresenter *presenter, uint32_t image_index);
+
+// Shader module deduplication, shared by the backends. Acquire returns the
+// module matching the desc with another reference, or allocates one with
+// backend_data_size bytes of backend data and has pfn_init create the backend's
+// part. Release drops a reference and has pfn_deinit destroy the backend's part
+// with the last one. The backends pass the same size and functions to both.
+typedef VriResult (*PFN_VriShaderModuleInit)(VriDevice device, VriShaderModule shader_module);
+typedef void (*PFN_VriShaderModuleDeinit)(VriDevice device, VriShaderModule shader_module);
+
+VriResult vri_shader_module_acquire(VriDevice device, const VriShaderModuleDesc *p_desc, size_t backend_data_size, PFN_VriShaderModuleInit pfn_init, PFN_VriShaderModuleDeinit pfn_deinit, VriShaderModule *p_shader_module);
+void      vri_shader_module_release(VriDevice device, VriShaderModule shader_module, size_t backend_data_size, PFN_VriShaderModuleDeinit pfn_deinit);
+void      vri_shader_modules_destroy(VriDevice device); // Called by the backends right before destroying the object pools
+
+// The bytecode a pipeline stage compiles, its module's when it has one
+static inline const void *vri_shader_bytecode(const VriShaderModuleDesc *p_shader, size_t *p_size) {
+    *p_size = p_shader->module ? p_shader->module->size : p_shader->size;
+    return p_shader->module ? p_shader->module->p_bytecode : p_shader->p_bytecode;
+}
+
+// Pipeline manifest hooks of the public pipeline creates. The hashes are 0
+// while no manifest records and no warm pipelines are left, and for descs that
+// can't be recorded, which skips the rest. A taken warm pipeline is recorded too.
+uint64_t  vri_pipeline_manifest_hash_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc);
+uint64_t  vri_pipeline_manifest_hash_compute(VriDevice device, const VriComputePipelineDesc *p_desc);
+void      vri_pipeline_manifest_record_graphics(VriDevice device, uint64_t hash, const VriGraphicsPipelineDesc *p_desc);
+void      vri_pipeline_manifest_record_compute(VriDevice device, uint64_t hash, const VriComputePipelineDesc *p_desc);
+VriBool   vri_pipeline_warm_take(VriDevice device, uint64_t hash, VriPipeline *p_pipeline);
+VriResult vri_warm_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline); // Without the hooks, for warm-up
+VriResult vri_warm_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline);
+
+uint64_t    vri_live_objects_report(VriDevice device, VriMessageSeverity severity); // Returns how many objects were reported
+
+void   *vri_object_pool_allocate(VriObjectPool *pool, const VriAllocationCallback *alloc, size_t size, size_t alignment);
+void    vri_object_pool_free(VriObjectPool *pool, void *object);
+VriBool vri_object_pool_owns(const VriObjectPool *pool, size_t size);
+size_t  vri_object_pool_reserved_bytes(VriObjectPool *pool);
+void    vri_object_pool_for_each(VriObjectPool *pool, PFN_VriObjectVisit pfn_visit, void *p_user_data);
+void    vri_object_pool_destroy(VriObjectPool *pool); // Gives every slab back, live objects included
+void    vri_object_pools_quarantine(VriDevice device); // Tracking builds and the validation layer hold freed slots back from reuse
+void    vri_object_pools_destroy(VriDevice device);    // Called by the backends right before freeing the device
+
+uint64_t vri_time_ns(void);
+
+void    vri_spinlock_lock(VriSpinlock *lock);
+VriBool vri_spinlock_try_lock(VriSpinlock *lock); // Never waits, VRI_FALSE if another thread holds the lock
+void    vri_spinlock_unlock(VriSpinlock *lock);
+
+#define VRI_MAX_WORKER_THREADS 64
+
+typedef void (*PFN_VriThreadRun)(void *p_user_data);
+
+// Runs pfn_run on up to thread_count threads, the calling thread included, and
+// returns once every one of them returned
+void     vri_threads_run(uint32_t thread_count, PFN_VriThreadRun pfn_run, void *p_user_data);
+uint32_t vri_cpu_count(void);
 
 #endif
@@ -0,0 +1,77 @@
+#include "vri_layer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const VriLayer *const builtin_layers[] = {
+    &vri_validation_layer,
+    &vri_trace_layer,
+    &vri_capture_layer,
+};
+
+static const VriLayer *find_layer(const char *p_name);
+static VriResult       install_layer(VriDevice device, const VriLayer *layer);
+
+VriResult vri_layers_validate(const VriDeviceDesc *p_desc) {
+    for (uint32_t i = 0; i < p_desc->enabled_layer_count; ++i) {
+        const char *p_name = p_desc->pp_enabled_layers[i];
+        if (!p_name || !find_layer(p_name)) {
+            char message[256];
+            snprintf(message, sizeof(message), "Unknown layer requested: %s", p_name ? p_name : "(null)");
+            p_desc->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, message);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+VriResult vri_layers_install(const VriDeviceDesc *p_desc, VriDevice device) {
+    VriResult result = VRI_SUCCESS;
+
+    // Installed back to front, so the first layer named is the outermost one
+    for (uint32_t i = p_desc->enabled_layer_count; i-- > 0 && VRI_OK(result);) {
+        result = install_layer(device, find_layer(p_desc->pp_enabled_layers[i]));
+    }
+
+    // Validation goes on top of everything, so it sees exactly what the application passed
+    if (VRI_OK(result) && p_desc->enable_api_validation) {
+        result = install_layer(device, &vri_validation_layer);
+    }
+
+    if (VRI_ERROR(result)) return result;
+
+    // The queues were created by the backend before any layer was installed
+    if (p_desc->enabled_layer_count || p_desc->enable_api_validation) {
+        for (uint32_t i = 0; i < VRI_QUEUE_TYPE_COUNT; ++i) {
+            for (uint32_t j = 0; j < device->queue_counts[i]; ++j) {
+                device->queues[i][j]->dispatch = device->queue_dispatch;
+            }
+        }
+    }
+
+    return VRI_SUCCESS;
+}
+
+static VriResult install_layer(VriDevice device, const VriLayer *layer) {
+    VriLayerLink *link = VRI_LAYER_LINK(device, layer->id);
+
+    // Naming a layer twice doesn't stack it
+    if (link->enabled) return VRI_SUCCESS;
+
+    link->next_device = device->dispatch;
+    link->next_command_buffer = device->command_buffer_dispatch;
+    link->next_queue = device->queue_dispatch;
+    link->enabled = VRI_TRUE;
+
+    return layer->pfn_install(device, &device->dispatch, &device->command_buffer_dispatch, &device->queue_dispatch);
+}
+
+static const VriLayer *find_layer(const char *p_name) {
+    for (uint32_t i = 0; i < VRI_ARRAY_SIZE(builtin_layers); ++i) {
+        if (strcmp(builtin_layers[i]->p_name, p_name) == 0) {
+            return builtin_layers[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,38 @@
+#ifndef VRI_LAYER_H
+#define VRI_LAYER_H
+
+#include "vri_internal.h"
+
+// A layer is installed once, at device creation. Before its install function
+// runs, the current tables are copied into its VriLayerLink as the "next" tables,
+// after which the layer overwrites whichever entries it wants to intercept.
+// Layers which aren't enabled are never part of the call path.
+typedef VriResult (*PFN_VriLayerInstall)(
+    VriDevice                      device,
+    VriDeviceDispatchTable        *p_device_table,
+    VriCommandBufferDispatchTable *p_command_buffer_table,
+    VriQueueDispatchTable         *p_queue_table);
+
+typedef struct {
+    const char         *p_name;
+    VriLayerId          id;
+    PFN_VriLayerInstall pfn_install;
+} VriLayer;
+
+// Intercept an entry only if the backend implements it, so wrapping never
+// turns a missing function into a call through NULL
+#define VRI_LAYER_WRAP(table, member, function) \
+    do {                                        \
+        if ((table)->member) {                  \
+            (table)->member = (function);       \
+        }                                       \
+    } while (0)
+
+extern const VriLayer vri_validation_layer;
+extern const VriLayer vri_trace_layer;
+extern const VriLayer vri_capture_layer;
+
+VriResult vri_layers_validate(const VriDeviceDesc *p_desc);
+VriResult vri_layers_install(const VriDeviceDesc *p_desc, VriDevice device);
+
+#endif
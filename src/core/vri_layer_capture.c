@@ -0,0 +1,968 @@
+#if defined(_WIN32) && !defined(_CRT_SECURE_NO_WARNINGS)
+#    define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "vri_capture_format.h"
+#include "vri_layer.h"
+#include "vri_serialize.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Serializes every call into a binary trace which vri-replay can play back
+// against any backend. Calls are forwarded unchanged; objects are given dense
+// ids as they are created and shader bytecode and strings are written once,
+// as blob records, no matter how many pipelines use them. The file is set by
+// the VRI_CAPTURE_PATH environment variable.
+
+#define NEXT(device) VRI_LAYER_LINK((device), VRI_LAYER_ID_CAPTURE)
+
+#define CAPTURE_DEFAULT_PATH   "vri_capture.trace"
+#define CAPTURE_FILE_BUFFER    (1u << 20)
+#define CAPTURE_BLOB_MIN_TABLE 64
+
+// Blobs are deduplicated by their 64-bit hash and size alone, the bytes aren't
+// kept around to compare against
+typedef struct {
+    uint64_t hash;
+    uint64_t size;
+    uint32_t id; // 0 marks an empty slot
+} CaptureBlobEntry;
+
+typedef struct {
+    VriAllocationCallback allocator;
+    VriDebugCallback      debug_callback;
+    FILE                 *file;
+    char                 *p_file_buffer;
+    VriSpinlock           lock; // Guards everything below, records are written whole under it
+    VriWriter             writer;
+    uint64_t              start_ns;
+    uint32_t              next_handle_id;
+    uint32_t              next_blob_id;
+    CaptureBlobEntry     *p_blobs;
+    uint32_t              blob_capacity; // Power of two
+    uint32_t              blob_count;
+    VriBool               failed;
+} CaptureData;
+
+static VriResult capture_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table);
+
+const VriLayer vri_capture_layer = {
+    .p_name = VRI_LAYER_CAPTURE_NAME,
+    .id = VRI_LAYER_ID_CAPTURE,
+    .pfn_install = capture_install,
+};
+
+static void capture_fail(CaptureData *data, const char *p_message) {
+    if (!data->failed) {
+        data->failed = VRI_TRUE;
+        data->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, p_message);
+    }
+}
+
+static void write_file(CaptureData *data, const void *p_data, size_t size) {
+    if (data->failed) return;
+    if (fwrite(p_data, 1, size, data->file) != size) {
+        capture_fail(data, "Capture layer couldn't write to the trace file, capture stopped");
+    }
+}
+
+static void write_padding(CaptureData *data, uint64_t size) {
+    static const uint8_t zeros[8] = {0};
+    write_file(data, zeros, (size_t)(VRI_CAPTURE_ALIGN(size) - size));
+}
+
+static VriBool blob_table_grow(CaptureData *data) {
+    uint32_t          capacity = data->blob_capacity ? data->blob_capacity * 2 : CAPTURE_BLOB_MIN_TABLE;
+    CaptureBlobEntry *p_blobs = data->allocator.pfn_allocate(sizeof(CaptureBlobEntry) * capacity, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    if (!p_blobs) return VRI_FALSE;
+
+    memset(p_blobs, 0, sizeof(CaptureBlobEntry) * capacity);
+    for (uint32_t i = 0; i < data->blob_capacity; ++i) {
+        CaptureBlobEntry *entry = &data->p_blobs[i];
+        if (!entry->id) continue;
+
+        uint32_t slot = (uint32_t)entry->hash & (capacity - 1);
+        while (p_blobs[slot].id) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        p_blobs[slot] = *entry;
+    }
+
+    if (data->p_blobs) {
+        data->allocator.pfn_free(data->p_blobs, sizeof(CaptureBlobEntry) * data->blob_capacity, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    }
+    data->p_blobs = p_blobs;
+    data->blob_capacity = capacity;
+    return VRI_TRUE;
+}
+
+// Called while a record is being encoded, so the blob lands in the file before it
+static uint32_t intern_blob(void *p_user_data, const void *p_data, size_t size) {
+    CaptureData *data = p_user_data;
+    uint64_t     hash = vri_hash_bytes(VRI_HASH_SEED, p_data, size);
+
+    // Keep the load under a half, a table that can't grow just stops deduplicating
+    VriBool dedup = data->blob_count * 2 < data->blob_capacity || blob_table_grow(data);
+    if (dedup) {
+        uint32_t slot = (uint32_t)hash & (data->blob_capacity - 1);
+        while (data->p_blobs[slot].id) {
+            if (data->p_blobs[slot].hash == hash && data->p_blobs[slot].size == size) {
+                return data->p_blobs[slot].id;
+            }
+            slot = (slot + 1) & (data->blob_capacity - 1);
+        }
+
+        data->p_blobs[slot] = (CaptureBlobEntry){.hash = hash, .size = size, .id = data->next_blob_id};
+        data->blob_count++;
+    }
+
+    uint32_t               id = data->next_blob_id++;
+    uint32_t               blob_header[4] = {id, 0, (uint32_t)(size & 0xffffffffu), (uint32_t)((uint64_t)size >> 32)};
+    VriCaptureRecordHeader header = {
+        .op = VRI_CAPTURE_OP_BLOB,
+        .size = (uint32_t)(sizeof(blob_header) + size),
+        .time_ns = vri_time_ns() - data->start_ns,
+    };
+
+    write_file(data, &header, sizeof(header));
+    write_file(data, blob_header, sizeof(blob_header));
+    write_file(data, p_data, size);
+    write_padding(data, header.size);
+
+    return id;
+}
+
+static uint32_t intern_handle(void *p_user_data, const void *p_handle) {
+    (void)p_user_data;
+    return ((const VriObjectBase *)p_handle)->capture_id;
+}
+
+// Takes the lock, which is held until end_record
+static VriWriter *begin_record(CaptureData *data) {
+    static const uint8_t placeholder[sizeof(VriCaptureRecordHeader)] = {0};
+
+    vri_spinlock_lock(&data->lock);
+    vri_writer_reset(&data->writer);
+    vri_write_bytes(&data->writer, placeholder, sizeof(placeholder));
+    return &data->writer;
+}
+
+static void end_record(CaptureData *data, VriCaptureOp op) {
+    VriWriter *writer = &data->writer;
+
+    if (writer->out_of_memory) {
+        capture_fail(data, "Capture layer ran out of memory, capture stopped");
+    } else if (!data->failed) {
+        VriCaptureRecordHeader header = {
+            .op = (uint16_t)op,
+            .size = (uint32_t)(writer->size - sizeof(header)),
+            .time_ns = vri_time_ns() - data->start_ns,
+        };
+        memcpy(writer->p_data, &header, sizeof(header));
+
+        write_file(data, writer->p_data, writer->size);
+        write_padding(data, writer->size);
+    }
+
+    vri_spinlock_unlock(&data->lock);
+}
+
+// Only called between begin_record and end_record
+static void assign_id(CaptureData *data, VriObjectBase *base) {
+    base->capture_id = data->next_handle_id++;
+}
+
+static void write_created(CaptureData *data, VriResult result, void *p_object) {
+    if (VRI_OK(result) && p_object) {
+        assign_id(data, p_object);
+        vri_write_handle(&data->writer, p_object);
+    } else {
+        vri_write_u32(&data->writer, 0);
+    }
+}
+
+static CaptureData *capture_data(VriDevice device) {
+    return NEXT(device)->p_layer_data;
+}
+
+static void capture_close(CaptureData *data) {
+    VriAllocationCallback allocator = data->allocator;
+
+    if (data->file) {
+        if (fclose(data->file) != 0) {
+            capture_fail(data, "Capture layer couldn't flush the trace file");
+        }
+    }
+    if (data->p_file_buffer) {
+        allocator.pfn_free(data->p_file_buffer, CAPTURE_FILE_BUFFER, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    }
+    if (data->p_blobs) {
+        allocator.pfn_free(data->p_blobs, sizeof(CaptureBlobEntry) * data->blob_capacity, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    }
+    vri_writer_destroy(&data->writer);
+    allocator.pfn_free(data, sizeof(*data), 8, VRI_ALLOCATION_SCOPE_DEVICE);
+}
+
+static void capture_device_destroy(VriDevice device) {
+    CaptureData *data = capture_data(device);
+
+    begin_record(data);
+    end_record(data, VRI_CAPTURE_OP_DEVICE_DESTROY);
+
+    NEXT(device)->next_device.pfn_device_destroy(device);
+    capture_close(data);
+}
+
+static VriResult capture_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_command_pool_create(device, p_desc, p_command_pool);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->queue_type);
+    vri_write_u32(writer, p_desc->flags);
+    write_created(data, result, *p_command_pool);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_POOL_CREATE);
+
+    return result;
+}
+
+static void capture_command_pool_destroy(VriDevice device, VriCommandPool command_pool) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_pool);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_POOL_DESTROY);
+
+    NEXT(device)->next_device.pfn_command_pool_destroy(device, command_pool);
+}
+
+static void capture_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_pool);
+    vri_write_u32(writer, flags);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_POOL_RESET);
+
+    NEXT(device)->next_device.pfn_command_pool_reset(device, command_pool, flags);
+}
+
+static VriResult capture_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_command_buffers_allocate(device, p_desc, p_command_buffers);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, p_desc->command_pool);
+    vri_write_u32(writer, p_desc->command_buffer_count);
+    for (uint32_t i = 0; i < p_desc->command_buffer_count; ++i) {
+        write_created(data, result, VRI_OK(result) ? p_command_buffers[i] : NULL);
+    }
+    end_record(data, VRI_CAPTURE_OP_COMMAND_BUFFERS_ALLOCATE);
+
+    return result;
+}
+
+static void capture_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_pool);
+    vri_write_u32(writer, command_buffer_count);
+    for (uint32_t i = 0; i < command_buffer_count; ++i) {
+        vri_write_handle(writer, p_command_buffers[i]);
+    }
+    end_record(data, VRI_CAPTURE_OP_COMMAND_BUFFERS_FREE);
+
+    NEXT(device)->next_device.pfn_command_buffers_free(device, command_pool, command_buffer_count, p_command_buffers);
+}
+
+// A create that returns an existing module gets a new id, replay deduplicates
+// the same way, so every id still names the module it was recorded with
+static VriResult capture_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_shader_module_create(device, p_desc, p_shader_module);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_shader_module_desc(writer, p_desc);
+    write_created(data, result, *p_shader_module);
+    end_record(data, VRI_CAPTURE_OP_SHADER_MODULE_CREATE);
+
+    return result;
+}
+
+static void capture_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, shader_module);
+    end_record(data, VRI_CAPTURE_OP_SHADER_MODULE_DESTROY);
+
+    NEXT(device)->next_device.pfn_shader_module_destroy(device, shader_module);
+}
+
+static VriResult capture_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
+    CaptureData *data = capture_data(device);
+
+    // Pipeline layouts don't have an object behind them yet, the backends hand
+    // back nothing, so there is no id to give out either
+    *p_pipeline_layout = VRI_NULL_HANDLE;
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_layout_create(device, p_desc, p_pipeline_layout);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, 0);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_LAYOUT_CREATE);
+
+    return result;
+}
+
+static VriResult capture_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_pipeline_create_graphics(device, p_desc, p_pipeline);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_graphics_pipeline_desc(writer, p_desc);
+    write_created(data, result, *p_pipeline);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_CREATE_GRAPHICS);
+
+    return result;
+}
+
+static VriResult capture_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_pipeline_create_compute(device, p_desc, p_pipeline);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_compute_pipeline_desc(writer, p_desc);
+    write_created(data, result, *p_pipeline);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_CREATE_COMPUTE);
+
+    return result;
+}
+
+static void capture_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, pipeline);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_DESTROY);
+
+    NEXT(device)->next_device.pfn_pipeline_destroy(device, pipeline);
+}
+
+static VriResult capture_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_pipeline_library_create(device, p_desc, p_library);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->parts);
+    vri_write_graphics_pipeline_desc(writer, p_desc->p_desc);
+    write_created(data, result, *p_library);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_LIBRARY_CREATE);
+
+    return result;
+}
+
+static void capture_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, library);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_LIBRARY_DESTROY);
+
+    NEXT(device)->next_device.pfn_pipeline_library_destroy(device, library);
+}
+
+static VriResult capture_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_pipeline_link(device, p_desc, p_pipeline);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->library_count);
+    for (uint32_t i = 0; i < p_desc->library_count; ++i) {
+        vri_write_handle(writer, p_desc->p_libraries[i]);
+    }
+    write_created(data, result, *p_pipeline);
+    end_record(data, VRI_CAPTURE_OP_PIPELINE_LINK);
+
+    return result;
+}
+
+static VriResult capture_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_texture_create(device, p_desc, p_texture);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->type);
+    vri_write_u32(writer, p_desc->format);
+    vri_write_u32(writer, p_desc->width);
+    vri_write_u32(writer, p_desc->height);
+    vri_write_u32(writer, p_desc->depth);
+    vri_write_u32(writer, p_desc->usage);
+    vri_write_u32(writer, p_desc->sample_count);
+    vri_write_u32(writer, p_desc->mip_count);
+    vri_write_u32(writer, p_desc->layer_count);
+    vri_write_u32(writer, p_desc->memory_type);
+
+    // Every subresource is slice_pitch bytes per depth slice of its mip
+    uint32_t initial_data_count = 0;
+    if (p_desc->p_initial_data) {
+        initial_data_count = p_desc->mip_count * (p_desc->type == VRI_TEXTURE_TYPE_TEXTURE_3D ? 1 : p_desc->layer_count);
+    }
+    vri_write_u32(writer, initial_data_count);
+    for (uint32_t i = 0; i < initial_data_count; ++i) {
+        const VriSubresourceData *initial_data = &p_desc->p_initial_data[i];
+        uint32_t                  depth = VRI_MAX(p_desc->depth >> (i % p_desc->mip_count), 1u);
+        vri_write_u32(writer, initial_data->row_pitch);
+        vri_write_u32(writer, initial_data->slice_pitch);
+        vri_write_blob(writer, initial_data->p_data, (size_t)initial_data->slice_pitch * depth);
+    }
+
+    write_created(data, result, *p_texture);
+    end_record(data, VRI_CAPTURE_OP_TEXTURE_CREATE);
+
+    return result;
+}
+
+static void capture_texture_destroy(VriDevice device, VriTexture texture) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, texture);
+    end_record(data, VRI_CAPTURE_OP_TEXTURE_DESTROY);
+
+    NEXT(device)->next_device.pfn_texture_destroy(device, texture);
+}
+
+static VriResult capture_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_tile_heap_create(device, p_desc, p_tile_heap);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->tile_count);
+    write_created(data, result, *p_tile_heap);
+    end_record(data, VRI_CAPTURE_OP_TILE_HEAP_CREATE);
+
+    return result;
+}
+
+static void capture_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, tile_heap);
+    end_record(data, VRI_CAPTURE_OP_TILE_HEAP_DESTROY);
+
+    NEXT(device)->next_device.pfn_tile_heap_destroy(device, tile_heap);
+}
+
+static VriResult capture_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_fence_create(device, initial_value, p_fence);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u64(writer, initial_value);
+    write_created(data, result, *p_fence);
+    end_record(data, VRI_CAPTURE_OP_FENCE_CREATE);
+
+    return result;
+}
+
+static void capture_fence_destroy(VriDevice device, VriFence fence) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, fence);
+    end_record(data, VRI_CAPTURE_OP_FENCE_DESTROY);
+
+    NEXT(device)->next_device.pfn_fence_destroy(device, fence);
+}
+
+static uint64_t capture_fence_get_value(VriDevice device, VriFence fence) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, fence);
+    end_record(data, VRI_CAPTURE_OP_FENCE_GET_VALUE);
+
+    return NEXT(device)->next_device.pfn_fence_get_value(device, fence);
+}
+
+static VriResult capture_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, fence_count);
+    vri_write_u32(writer, wait_all);
+    vri_write_u64(writer, timeout_ns);
+    for (uint32_t i = 0; i < fence_count; ++i) {
+        vri_write_handle(writer, p_fences[i]);
+        vri_write_u64(writer, p_values[i]);
+    }
+    end_record(data, VRI_CAPTURE_OP_FENCES_WAIT);
+
+    return NEXT(device)->next_device.pfn_fences_wait(device, p_fences, p_values, fence_count, wait_all, timeout_ns);
+}
+
+static VriResult capture_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_swapchain_create(device, p_desc, p_swapchain);
+
+    // The window can't be captured, replay brings its own
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, p_desc->width);
+    vri_write_u32(writer, p_desc->height);
+    vri_write_u32(writer, p_desc->format);
+    vri_write_u32(writer, p_desc->color_space);
+    vri_write_u32(writer, p_desc->flags);
+    vri_write_u32(writer, p_desc->texture_count);
+    vri_write_u32(writer, p_desc->frames_in_flight);
+    vri_write_u32(writer, p_desc->p_window_desc == NULL);
+    vri_write_u32(writer, p_desc->present_mode);
+    vri_write_u32(writer, p_desc->refresh_rate);
+    write_created(data, result, *p_swapchain);
+    end_record(data, VRI_CAPTURE_OP_SWAPCHAIN_CREATE);
+
+    return result;
+}
+
+static void capture_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, swapchain);
+    end_record(data, VRI_CAPTURE_OP_SWAPCHAIN_DESTROY);
+
+    NEXT(device)->next_device.pfn_swapchain_destroy(device, swapchain);
+}
+
+static VriResult capture_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, swapchain);
+    vri_write_handle(writer, fence);
+    vri_write_u64(writer, signal_value);
+    end_record(data, VRI_CAPTURE_OP_SWAPCHAIN_ACQUIRE_NEXT_IMAGE);
+
+    return NEXT(device)->next_device.pfn_swapchain_acquire_next_image(device, swapchain, fence, signal_value, p_image_index);
+}
+
+static VriResult capture_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, swapchain);
+    vri_write_handle(writer, fence);
+    end_record(data, VRI_CAPTURE_OP_SWAPCHAIN_PRESENT);
+
+    return NEXT(device)->next_device.pfn_swapchain_present(device, swapchain, fence);
+}
+
+static VriResult capture_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    CaptureData *data = capture_data(device);
+    VriResult    result = NEXT(device)->next_device.pfn_swapchain_get_texture(device, swapchain, image_index, p_texture);
+
+    // Swapchain textures are never created through the API, this is where they get their id
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, swapchain);
+    vri_write_u32(writer, image_index);
+    write_created(data, result, *p_texture);
+    end_record(data, VRI_CAPTURE_OP_SWAPCHAIN_GET_TEXTURE);
+
+    return result;
+}
+
+static VriResult capture_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_u32(writer, p_desc ? p_desc->usage : 0);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_BUFFER_BEGIN);
+
+    return NEXT(device)->next_command_buffer.pfn_command_buffer_begin(command_buffer, p_desc);
+}
+
+static VriResult capture_command_buffer_end(VriCommandBuffer command_buffer) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_BUFFER_END);
+
+    return NEXT(device)->next_command_buffer.pfn_command_buffer_end(command_buffer);
+}
+
+static VriResult capture_command_buffer_reset(VriCommandBuffer command_buffer) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    end_record(data, VRI_CAPTURE_OP_COMMAND_BUFFER_RESET);
+
+    return NEXT(device)->next_command_buffer.pfn_command_buffer_reset(command_buffer);
+}
+
+static void capture_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_handle(writer, pipeline);
+    end_record(data, VRI_CAPTURE_OP_CMD_BIND_PIPELINE);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_bind_pipeline(command_buffer, pipeline);
+}
+
+static void capture_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_handle(writer, texture);
+    vri_write_u32(writer, p_desc->mip_level);
+    vri_write_u32(writer, p_desc->array_layer);
+    vri_write_u32(writer, p_desc->x);
+    vri_write_u32(writer, p_desc->y);
+    vri_write_u32(writer, p_desc->z);
+    vri_write_u32(writer, p_desc->width);
+    vri_write_u32(writer, p_desc->height);
+    vri_write_u32(writer, p_desc->depth);
+    vri_write_u32(writer, p_desc->data.row_pitch);
+    vri_write_u32(writer, p_desc->data.slice_pitch);
+    vri_write_blob(writer, p_desc->data.p_data, (size_t)p_desc->data.slice_pitch * p_desc->depth);
+    end_record(data, VRI_CAPTURE_OP_CMD_UPDATE_TEXTURE);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_update_texture(command_buffer, texture, p_desc);
+}
+
+static void capture_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_handle(writer, texture);
+    end_record(data, VRI_CAPTURE_OP_CMD_GENERATE_MIPS);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_generate_mips(command_buffer, texture);
+}
+
+static void write_texture_location(VriWriter *writer, const VriTextureLocation *p_location) {
+    vri_write_u32(writer, p_location->mip_level);
+    vri_write_u32(writer, p_location->array_layer);
+    vri_write_u32(writer, p_location->x);
+    vri_write_u32(writer, p_location->y);
+    vri_write_u32(writer, p_location->z);
+}
+
+static void capture_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_handle(writer, src);
+    vri_write_handle(writer, dst);
+    write_texture_location(writer, &p_desc->src);
+    write_texture_location(writer, &p_desc->dst);
+    vri_write_u32(writer, p_desc->width);
+    vri_write_u32(writer, p_desc->height);
+    vri_write_u32(writer, p_desc->depth);
+    end_record(data, VRI_CAPTURE_OP_CMD_COPY_TEXTURE);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_copy_texture(command_buffer, src, dst, p_desc);
+}
+
+static void capture_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_u32(writer, first_viewport);
+    vri_write_u32(writer, viewport_count);
+    for (uint32_t i = 0; i < viewport_count; ++i) {
+        vri_write_f32(writer, p_viewports[i].x);
+        vri_write_f32(writer, p_viewports[i].y);
+        vri_write_f32(writer, p_viewports[i].width);
+        vri_write_f32(writer, p_viewports[i].height);
+        vri_write_f32(writer, p_viewports[i].min_depth);
+        vri_write_f32(writer, p_viewports[i].max_depth);
+    }
+    end_record(data, VRI_CAPTURE_OP_CMD_SET_VIEWPORT);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_viewport(command_buffer, first_viewport, viewport_count, p_viewports);
+}
+
+static void capture_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_u32(writer, first_scissor);
+    vri_write_u32(writer, scissor_count);
+    for (uint32_t i = 0; i < scissor_count; ++i) {
+        vri_write_u32(writer, (uint32_t)p_scissors[i].x);
+        vri_write_u32(writer, (uint32_t)p_scissors[i].y);
+        vri_write_u32(writer, p_scissors[i].width);
+        vri_write_u32(writer, p_scissors[i].height);
+    }
+    end_record(data, VRI_CAPTURE_OP_CMD_SET_SCISSOR);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_scissor(command_buffer, first_scissor, scissor_count, p_scissors);
+}
+
+static void capture_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_u32(writer, reference);
+    end_record(data, VRI_CAPTURE_OP_CMD_SET_STENCIL_REFERENCE);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_stencil_reference(command_buffer, reference);
+}
+
+static void capture_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    for (uint32_t i = 0; i < 4; ++i) {
+        vri_write_f32(writer, blend_constants[i]);
+    }
+    end_record(data, VRI_CAPTURE_OP_CMD_SET_BLEND_CONSTANTS);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_blend_constants(command_buffer, blend_constants);
+}
+
+static void capture_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    VriDevice    device = command_buffer->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, command_buffer);
+    vri_write_f32(writer, constant_factor);
+    vri_write_f32(writer, clamp);
+    vri_write_f32(writer, slope_factor);
+    end_record(data, VRI_CAPTURE_OP_CMD_SET_DEPTH_BIAS);
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_depth_bias(command_buffer, constant_factor, clamp, slope_factor);
+}
+
+static void write_fence_values(VriWriter *writer, const VriFenceWaitDesc *p_fences, uint32_t count) {
+    vri_write_u32(writer, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        vri_write_handle(writer, p_fences[i].fence);
+        vri_write_u64(writer, p_fences[i].value);
+    }
+}
+
+static VriResult capture_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
+    VriDevice    device = queue->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, queue);
+    vri_write_u32(writer, submit_count);
+    for (uint32_t i = 0; i < submit_count; ++i) {
+        const VriQueueSubmitDesc *submit = &p_submits[i];
+
+        vri_write_u32(writer, submit->command_buffer_count);
+        for (uint32_t j = 0; j < submit->command_buffer_count; ++j) {
+            vri_write_handle(writer, submit->p_command_buffers[j]);
+        }
+        write_fence_values(writer, submit->p_fences_wait, submit->fence_wait_count);
+        write_fence_values(writer, submit->p_fences_signal, submit->fence_signal_count);
+    }
+    end_record(data, VRI_CAPTURE_OP_QUEUE_SUBMIT);
+
+    return NEXT(device)->next_queue.pfn_queue_submit(queue, p_submits, submit_count);
+}
+
+static VriResult capture_queue_wait_idle(VriQueue queue) {
+    VriDevice    device = queue->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, queue);
+    end_record(data, VRI_CAPTURE_OP_QUEUE_WAIT_IDLE);
+
+    return NEXT(device)->next_queue.pfn_queue_wait_idle(queue);
+}
+
+static VriResult capture_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present) {
+    VriDevice    device = queue->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, queue);
+    vri_write_u32(writer, p_present->swapchain_count);
+    for (uint32_t i = 0; i < p_present->swapchain_count; ++i) {
+        vri_write_handle(writer, p_present->p_swapchains[i]);
+        vri_write_u32(writer, p_present->p_image_indices ? p_present->p_image_indices[i] : 0);
+    }
+    vri_write_u32(writer, p_present->wait_fence_count);
+    for (uint32_t i = 0; i < p_present->wait_fence_count; ++i) {
+        vri_write_handle(writer, p_present->p_wait_fences[i]);
+        vri_write_u64(writer, p_present->p_wait_values[i]);
+    }
+    end_record(data, VRI_CAPTURE_OP_QUEUE_PRESENT);
+
+    return NEXT(device)->next_queue.pfn_queue_present(queue, p_present);
+}
+
+static VriResult capture_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    VriDevice    device = queue->base.p_device;
+    CaptureData *data = capture_data(device);
+
+    VriWriter *writer = begin_record(data);
+    vri_write_handle(writer, queue);
+    vri_write_u32(writer, bind_count);
+    for (uint32_t i = 0; i < bind_count; ++i) {
+        vri_write_handle(writer, p_binds[i].texture);
+        vri_write_u32(writer, p_binds[i].mip_level);
+        vri_write_u32(writer, p_binds[i].x);
+        vri_write_u32(writer, p_binds[i].y);
+        vri_write_u32(writer, p_binds[i].width);
+        vri_write_u32(writer, p_binds[i].height);
+        vri_write_handle(writer, p_binds[i].heap);
+        vri_write_u32(writer, p_binds[i].heap_offset);
+    }
+    end_record(data, VRI_CAPTURE_OP_QUEUE_BIND_SPARSE);
+
+    return NEXT(device)->next_queue.pfn_queue_bind_sparse(queue, p_binds, bind_count);
+}
+
+static VriResult capture_open(VriDevice device, CaptureData *data) {
+    const char *p_path = getenv("VRI_CAPTURE_PATH");
+    if (!p_path || !*p_path) {
+        p_path = CAPTURE_DEFAULT_PATH;
+    }
+
+    data->file = fopen(p_path, "wb");
+    if (!data->file) {
+        char message[512];
+        snprintf(message, sizeof(message), "Capture layer couldn't open %s for writing", p_path);
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, message);
+        return VRI_ERROR_SYSTEM_FAILURE;
+    }
+
+    // Records are small and frequent, a big buffer keeps them out of the kernel
+    data->p_file_buffer = data->allocator.pfn_allocate(CAPTURE_FILE_BUFFER, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    if (data->p_file_buffer) {
+        setvbuf(data->file, data->p_file_buffer, _IOFBF, CAPTURE_FILE_BUFFER);
+    }
+
+    VriCaptureFileHeader header = {
+        .version = VRI_CAPTURE_VERSION,
+        .header_size = sizeof(VriCaptureFileHeader),
+    };
+    memcpy(header.magic, VRI_CAPTURE_MAGIC, sizeof(header.magic));
+    write_file(data, &header, sizeof(header));
+
+    return data->failed ? VRI_ERROR_SYSTEM_FAILURE : VRI_SUCCESS;
+}
+
+static VriResult capture_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table) {
+    CaptureData *data = device->allocation_callback.pfn_allocate(sizeof(CaptureData), 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    if (!data) {
+        device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_FATAL, "Allocation for the capture layer failed.");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(data, 0, sizeof(*data));
+    data->allocator = device->allocation_callback;
+    data->debug_callback = device->debug_callback;
+    data->start_ns = vri_time_ns();
+    data->next_handle_id = 1;
+    data->next_blob_id = 1;
+
+    VriWriterCallbacks callbacks = {
+        .pfn_intern_blob = intern_blob,
+        .pfn_intern_handle = intern_handle,
+        .p_user_data = data,
+    };
+    vri_writer_init(&data->writer, &data->allocator, VRI_ALLOCATION_SCOPE_DEVICE, &callbacks);
+
+    VriResult result = capture_open(device, data);
+    if (VRI_ERROR(result)) {
+        capture_close(data);
+        return result;
+    }
+
+    NEXT(device)->p_layer_data = data;
+
+    // The device and its queues already exist, so they're the first thing in the trace
+    VriWriter *writer = begin_record(data);
+    vri_write_u32(writer, device->backend);
+    vri_write_u32(writer, device->enable_api_validation);
+    for (uint32_t i = 0; i < VRI_QUEUE_TYPE_COUNT; ++i) {
+        vri_write_u32(writer, device->queue_counts[i]);
+        for (uint32_t j = 0; j < device->queue_counts[i]; ++j) {
+            assign_id(data, &device->queues[i][j]->base);
+            vri_write_handle(writer, device->queues[i][j]);
+        }
+    }
+    end_record(data, VRI_CAPTURE_OP_DEVICE_CREATE);
+
+    VRI_LAYER_WRAP(p_device_table, pfn_device_destroy, capture_device_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_create, capture_command_pool_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_destroy, capture_command_pool_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_reset, capture_command_pool_reset);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_allocate, capture_command_buffers_allocate);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_free, capture_command_buffers_free);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_create, capture_shader_module_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_destroy, capture_shader_module_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_layout_create, capture_pipeline_layout_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_graphics, capture_pipeline_create_graphics);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_compute, capture_pipeline_create_compute);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_destroy, capture_pipeline_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_create, capture_pipeline_library_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_destroy, capture_pipeline_library_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_link, capture_pipeline_link);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_create, capture_texture_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_destroy, capture_texture_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_create, capture_tile_heap_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_destroy, capture_tile_heap_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_create, capture_fence_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_destroy, capture_fence_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_get_value, capture_fence_get_value);
+    VRI_LAYER_WRAP(p_device_table, pfn_fences_wait, capture_fences_wait);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_create, capture_swapchain_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_destroy, capture_swapchain_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_acquire_next_image, capture_swapchain_acquire_next_image);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_present, capture_swapchain_present);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_get_texture, capture_swapchain_get_texture);
+
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_begin, capture_command_buffer_begin);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_end, capture_command_buffer_end);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_reset, capture_command_buffer_reset);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_bind_pipeline, capture_cmd_bind_pipeline);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_update_texture, capture_cmd_update_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_generate_mips, capture_cmd_generate_mips);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_copy_texture, capture_cmd_copy_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_viewport, capture_cmd_set_viewport);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_scissor, capture_cmd_set_scissor);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_stencil_reference, capture_cmd_set_stencil_reference);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_blend_constants, capture_cmd_set_blend_constants);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_depth_bias, capture_cmd_set_depth_bias);
+
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_submit, capture_queue_submit);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_wait_idle, capture_queue_wait_idle);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_present, capture_queue_present);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_bind_sparse, capture_queue_bind_sparse);
+
+    return VRI_SUCCESS;
+}
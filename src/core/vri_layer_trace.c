@@ -0,0 +1,414 @@
+#include "vri_layer.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+// Logs every call with its arguments and result through the device's debug
+// callback at INFO severity, then forwards it unchanged.
+
+#define NEXT(device) VRI_LAYER_LINK((device), VRI_LAYER_ID_TRACE)
+#define H(handle)    ((void *)(uintptr_t)(handle))
+
+// Output handles are only written on success, failed creates log NULL instead
+#define CREATED(result, handle) ((result) == VRI_SUCCESS ? H(handle) : NULL)
+
+static VriResult trace_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table);
+
+const VriLayer vri_trace_layer = {
+    .p_name = VRI_LAYER_TRACE_NAME,
+    .id = VRI_LAYER_ID_TRACE,
+    .pfn_install = trace_install,
+};
+
+static void trace(VriDevice device, const char *p_format, ...) {
+    char    message[256];
+    va_list args;
+
+    va_start(args, p_format);
+    vsnprintf(message, sizeof(message), p_format, args);
+    va_end(args);
+
+    device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_INFO, message);
+}
+
+static void trace_device_destroy(VriDevice device) {
+    trace(device, "vri_device_destroy(device=%p)", H(device));
+    NEXT(device)->next_device.pfn_device_destroy(device);
+}
+
+static VriResult trace_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget) {
+    VriResult result = NEXT(device)->next_device.pfn_device_query_memory_budget(device, p_budget);
+    if (VRI_OK(result)) {
+        const VriMemoryHeapBudget *local = &p_budget->heaps[VRI_MEMORY_HEAP_DEVICE_LOCAL];
+        trace(device, "vri_device_query_memory_budget(device=%p) -> %d, device local %llu / %llu bytes", H(device), result, (unsigned long long)local->usage,
+              (unsigned long long)local->budget);
+    } else {
+        trace(device, "vri_device_query_memory_budget(device=%p) -> %d", H(device), result);
+    }
+    return result;
+}
+
+static VriResult trace_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool) {
+    VriResult result = NEXT(device)->next_device.pfn_command_pool_create(device, p_desc, p_command_pool);
+    trace(device, "vri_command_pool_create(queue_type=%d, flags=0x%x) -> %d, %p", p_desc->queue_type, p_desc->flags, result, CREATED(result, *p_command_pool));
+    return result;
+}
+
+static void trace_command_pool_destroy(VriDevice device, VriCommandPool command_pool) {
+    trace(device, "vri_command_pool_destroy(command_pool=%p)", H(command_pool));
+    NEXT(device)->next_device.pfn_command_pool_destroy(device, command_pool);
+}
+
+static void trace_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags) {
+    trace(device, "vri_command_pool_reset(command_pool=%p, flags=0x%x)", H(command_pool), flags);
+    NEXT(device)->next_device.pfn_command_pool_reset(device, command_pool, flags);
+}
+
+static VriResult trace_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
+    VriResult result = NEXT(device)->next_device.pfn_command_buffers_allocate(device, p_desc, p_command_buffers);
+    trace(device, "vri_command_buffers_allocate(command_pool=%p, count=%u) -> %d", H(p_desc->command_pool), p_desc->command_buffer_count, result);
+    return result;
+}
+
+static void trace_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
+    trace(device, "vri_command_buffers_free(command_pool=%p, count=%u)", H(command_pool), command_buffer_count);
+    NEXT(device)->next_device.pfn_command_buffers_free(device, command_pool, command_buffer_count, p_command_buffers);
+}
+
+static VriResult trace_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    VriResult result = NEXT(device)->next_device.pfn_shader_module_create(device, p_desc, p_shader_module);
+    trace(device, "vri_shader_module_create(stage=0x%x, size=%llu) -> %d, %p", p_desc->stage, (unsigned long long)p_desc->size, result, CREATED(result, *p_shader_module));
+    return result;
+}
+
+static void trace_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    trace(device, "vri_shader_module_destroy(shader_module=%p)", H(shader_module));
+    NEXT(device)->next_device.pfn_shader_module_destroy(device, shader_module);
+}
+
+static VriResult trace_pipeline_layout_create(VriDevice device, const VriPipelineLayoutDesc *p_desc, VriPipelineLayout *p_pipeline_layout) {
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_layout_create(device, p_desc, p_pipeline_layout);
+    trace(device, "vri_pipeline_layout_create() -> %d, %p", result, CREATED(result, *p_pipeline_layout));
+    return result;
+}
+
+static VriResult trace_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_create_graphics(device, p_desc, p_pipeline);
+    trace(device, "vri_pipeline_create_graphics(shader_count=%u, dynamic_states=0x%x) -> %d, %p", p_desc->shader_count, p_desc->dynamic_states, result,
+          CREATED(result, *p_pipeline));
+    return result;
+}
+
+static VriResult trace_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_create_compute(device, p_desc, p_pipeline);
+    trace(device, "vri_pipeline_create_compute() -> %d, %p", result, CREATED(result, *p_pipeline));
+    return result;
+}
+
+static void trace_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    trace(device, "vri_pipeline_destroy(pipeline=%p)", H(pipeline));
+    NEXT(device)->next_device.pfn_pipeline_destroy(device, pipeline);
+}
+
+static VriResult trace_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_library_create(device, p_desc, p_library);
+    trace(device, "vri_pipeline_library_create(parts=0x%x, shader_count=%u) -> %d, %p", p_desc->parts, p_desc->p_desc->shader_count, result, CREATED(result, *p_library));
+    return result;
+}
+
+static void trace_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    trace(device, "vri_pipeline_library_destroy(library=%p)", H(library));
+    NEXT(device)->next_device.pfn_pipeline_library_destroy(device, library);
+}
+
+static VriResult trace_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    VriResult result = NEXT(device)->next_device.pfn_pipeline_link(device, p_desc, p_pipeline);
+    trace(device, "vri_pipeline_link(library_count=%u) -> %d, %p", p_desc->library_count, result, CREATED(result, *p_pipeline));
+    return result;
+}
+
+static VriResult trace_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
+    VriResult result = NEXT(device)->next_device.pfn_texture_create(device, p_desc, p_texture);
+    trace(device, "vri_texture_create(format=%d, %ux%ux%u, mips=%u, layers=%u, memory_type=%d, initial_data=%s) -> %d, %p",
+          p_desc->format, p_desc->width, p_desc->height, p_desc->depth, p_desc->mip_count, p_desc->layer_count, p_desc->memory_type,
+          p_desc->p_initial_data ? "yes" : "no", result, CREATED(result, *p_texture));
+    return result;
+}
+
+static void trace_texture_destroy(VriDevice device, VriTexture texture) {
+    trace(device, "vri_texture_destroy(texture=%p)", H(texture));
+    NEXT(device)->next_device.pfn_texture_destroy(device, texture);
+}
+
+static void trace_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling) {
+    NEXT(device)->next_device.pfn_texture_get_tiling(device, texture, p_tiling);
+    trace(device, "vri_texture_get_tiling(texture=%p) -> %ux%u tiles, standard_mips=%u, packed_tiles=%u, tile_count=%u", H(texture), p_tiling->tile_width,
+          p_tiling->tile_height, p_tiling->standard_mip_count, p_tiling->packed_tile_count, p_tiling->tile_count);
+}
+
+static VriResult trace_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed) {
+    VriResult result = NEXT(device)->next_device.pfn_texture_get_tile_feedback(device, texture, tile_count, p_accessed);
+    trace(device, "vri_texture_get_tile_feedback(texture=%p, tile_count=%u) -> %d", H(texture), tile_count, result);
+    return result;
+}
+
+static VriResult trace_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    VriResult result = NEXT(device)->next_device.pfn_texture_map(device, texture, mip_level, array_layer, p_data);
+    trace(device, "vri_texture_map(texture=%p, mip=%u, layer=%u) -> %d, %p", H(texture), mip_level, array_layer, result, result == VRI_SUCCESS ? p_data->p_data : NULL);
+    return result;
+}
+
+static void trace_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer) {
+    trace(device, "vri_texture_unmap(texture=%p, mip=%u, layer=%u)", H(texture), mip_level, array_layer);
+    NEXT(device)->next_device.pfn_texture_unmap(device, texture, mip_level, array_layer);
+}
+
+static VriResult trace_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    VriResult result = NEXT(device)->next_device.pfn_tile_heap_create(device, p_desc, p_tile_heap);
+    trace(device, "vri_tile_heap_create(tile_count=%u) -> %d, %p", p_desc->tile_count, result, CREATED(result, *p_tile_heap));
+    return result;
+}
+
+static void trace_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    trace(device, "vri_tile_heap_destroy(tile_heap=%p)", H(tile_heap));
+    NEXT(device)->next_device.pfn_tile_heap_destroy(device, tile_heap);
+}
+
+static VriResult trace_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
+    VriResult result = NEXT(device)->next_device.pfn_fence_create(device, initial_value, p_fence);
+    trace(device, "vri_fence_create(initial_value=%llu) -> %d, %p", (unsigned long long)initial_value, result, CREATED(result, *p_fence));
+    return result;
+}
+
+static void trace_fence_destroy(VriDevice device, VriFence fence) {
+    trace(device, "vri_fence_destroy(fence=%p)", H(fence));
+    NEXT(device)->next_device.pfn_fence_destroy(device, fence);
+}
+
+static uint64_t trace_fence_get_value(VriDevice device, VriFence fence) {
+    uint64_t value = NEXT(device)->next_device.pfn_fence_get_value(device, fence);
+    trace(device, "vri_fence_get_value(fence=%p) -> %llu", H(fence), (unsigned long long)value);
+    return value;
+}
+
+static VriResult trace_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
+    VriResult result = NEXT(device)->next_device.pfn_fences_wait(device, p_fences, p_values, fence_count, wait_all, timeout_ns);
+    trace(device, "vri_fences_wait(count=%u, first=%p@%llu, wait_all=%d, timeout_ns=%llu) -> %d",
+          fence_count, fence_count ? H(p_fences[0]) : NULL, fence_count ? (unsigned long long)p_values[0] : 0ull,
+          wait_all, (unsigned long long)timeout_ns, result);
+    return result;
+}
+
+static VriResult trace_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_create(device, p_desc, p_swapchain);
+    trace(device, "vri_swapchain_create(%ux%u, format=%d, textures=%u, %s, present_mode=%d) -> %d, %p",
+          p_desc->width, p_desc->height, p_desc->format, p_desc->texture_count, p_desc->p_window_desc ? "window" : "headless",
+          p_desc->present_mode, result, CREATED(result, *p_swapchain));
+    return result;
+}
+
+static void trace_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
+    trace(device, "vri_swapchain_destroy(swapchain=%p)", H(swapchain));
+    NEXT(device)->next_device.pfn_swapchain_destroy(device, swapchain);
+}
+
+static VriResult trace_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_acquire_next_image(device, swapchain, fence, signal_value, p_image_index);
+    if (result == VRI_SUCCESS || result == VRI_SUBOPTIMAL) {
+        trace(device, "vri_swapchain_acquire_next_image(swapchain=%p, fence=%p@%llu) -> %d, %u",
+              H(swapchain), H(fence), (unsigned long long)signal_value, result, *p_image_index);
+    } else {
+        trace(device, "vri_swapchain_acquire_next_image(swapchain=%p, fence=%p@%llu) -> %d", H(swapchain), H(fence), (unsigned long long)signal_value, result);
+    }
+    return result;
+}
+
+static VriResult trace_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_present(device, swapchain, fence);
+    trace(device, "vri_swapchain_present(swapchain=%p, fence=%p) -> %d", H(swapchain), H(fence), result);
+    return result;
+}
+
+static VriResult trace_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_get_texture(device, swapchain, image_index, p_texture);
+    trace(device, "vri_swapchain_get_texture(swapchain=%p, image_index=%u) -> %d, %p", H(swapchain), image_index, result,
+          CREATED(result, *p_texture));
+    return result;
+}
+
+static VriResult trace_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats) {
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_get_stats(device, swapchain, p_stats);
+    if (VRI_OK(result)) {
+        trace(device, "vri_swapchain_get_stats(swapchain=%p) -> %d, %llu presents, %llu displayed, %llu dropped, %llu repeated", H(swapchain), result,
+              (unsigned long long)p_stats->present_count, (unsigned long long)p_stats->display_count, (unsigned long long)p_stats->drop_count,
+              (unsigned long long)p_stats->repeat_count);
+    } else {
+        trace(device, "vri_swapchain_get_stats(swapchain=%p) -> %d", H(swapchain), result);
+    }
+    return result;
+}
+
+static VriResult trace_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
+    VriDevice device = command_buffer->base.p_device;
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_begin(command_buffer, p_desc);
+    trace(device, "vri_command_buffer_begin(command_buffer=%p) -> %d", H(command_buffer), result);
+    return result;
+}
+
+static VriResult trace_command_buffer_end(VriCommandBuffer command_buffer) {
+    VriDevice device = command_buffer->base.p_device;
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_end(command_buffer);
+    trace(device, "vri_command_buffer_end(command_buffer=%p) -> %d", H(command_buffer), result);
+    return result;
+}
+
+static VriResult trace_command_buffer_reset(VriCommandBuffer command_buffer) {
+    VriDevice device = command_buffer->base.p_device;
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_reset(command_buffer);
+    trace(device, "vri_command_buffer_reset(command_buffer=%p) -> %d", H(command_buffer), result);
+    return result;
+}
+
+static void trace_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_bind_pipeline(command_buffer=%p, pipeline=%p)", H(command_buffer), H(pipeline));
+    NEXT(device)->next_command_buffer.pfn_cmd_bind_pipeline(command_buffer, pipeline);
+}
+
+static void trace_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_update_texture(command_buffer=%p, texture=%p, mip=%u, layer=%u, (%u, %u, %u) %ux%ux%u)", H(command_buffer), H(texture),
+          p_desc->mip_level, p_desc->array_layer, p_desc->x, p_desc->y, p_desc->z, p_desc->width, p_desc->height, p_desc->depth);
+    NEXT(device)->next_command_buffer.pfn_cmd_update_texture(command_buffer, texture, p_desc);
+}
+
+static void trace_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_generate_mips(command_buffer=%p, texture=%p)", H(command_buffer), H(texture));
+    NEXT(device)->next_command_buffer.pfn_cmd_generate_mips(command_buffer, texture);
+}
+
+static void trace_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_copy_texture(command_buffer=%p, src=%p, dst=%p, %ux%ux%u)", H(command_buffer), H(src), H(dst), p_desc->width, p_desc->height,
+          p_desc->depth);
+    NEXT(device)->next_command_buffer.pfn_cmd_copy_texture(command_buffer, src, dst, p_desc);
+}
+
+static void trace_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_set_viewport(command_buffer=%p, first_viewport=%u, viewport_count=%u)", H(command_buffer), first_viewport, viewport_count);
+    NEXT(device)->next_command_buffer.pfn_cmd_set_viewport(command_buffer, first_viewport, viewport_count, p_viewports);
+}
+
+static void trace_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_set_scissor(command_buffer=%p, first_scissor=%u, scissor_count=%u)", H(command_buffer), first_scissor, scissor_count);
+    NEXT(device)->next_command_buffer.pfn_cmd_set_scissor(command_buffer, first_scissor, scissor_count, p_scissors);
+}
+
+static void trace_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_set_stencil_reference(command_buffer=%p, reference=%u)", H(command_buffer), reference);
+    NEXT(device)->next_command_buffer.pfn_cmd_set_stencil_reference(command_buffer, reference);
+}
+
+static void trace_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_set_blend_constants(command_buffer=%p, (%g, %g, %g, %g))", H(command_buffer), blend_constants[0], blend_constants[1],
+          blend_constants[2], blend_constants[3]);
+    NEXT(device)->next_command_buffer.pfn_cmd_set_blend_constants(command_buffer, blend_constants);
+}
+
+static void trace_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    VriDevice device = command_buffer->base.p_device;
+    trace(device, "vri_cmd_set_depth_bias(command_buffer=%p, constant_factor=%g, clamp=%g, slope_factor=%g)", H(command_buffer), constant_factor, clamp,
+          slope_factor);
+    NEXT(device)->next_command_buffer.pfn_cmd_set_depth_bias(command_buffer, constant_factor, clamp, slope_factor);
+}
+
+static VriResult trace_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
+    VriDevice device = queue->base.p_device;
+    VriResult result = NEXT(device)->next_queue.pfn_queue_submit(queue, p_submits, submit_count);
+    trace(device, "vri_queue_submit(queue=%p, submit_count=%u) -> %d", H(queue), submit_count, result);
+    return result;
+}
+
+static VriResult trace_queue_wait_idle(VriQueue queue) {
+    VriDevice device = queue->base.p_device;
+    VriResult result = NEXT(device)->next_queue.pfn_queue_wait_idle(queue);
+    trace(device, "vri_queue_wait_idle(queue=%p) -> %d", H(queue), result);
+    return result;
+}
+
+static VriResult trace_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present) {
+    VriDevice device = queue->base.p_device;
+    VriResult result = NEXT(device)->next_queue.pfn_queue_present(queue, p_present);
+    trace(device, "vri_queue_present(queue=%p, swapchain_count=%u) -> %d", H(queue), p_present->swapchain_count, result);
+    return result;
+}
+
+static VriResult trace_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    VriDevice device = queue->base.p_device;
+    VriResult result = NEXT(device)->next_queue.pfn_queue_bind_sparse(queue, p_binds, bind_count);
+    trace(device, "vri_queue_bind_sparse(queue=%p, bind_count=%u) -> %d", H(queue), bind_count, result);
+    return result;
+}
+
+static VriResult trace_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table) {
+    VRI_LAYER_WRAP(p_device_table, pfn_device_destroy, trace_device_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_device_query_memory_budget, trace_device_query_memory_budget);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_create, trace_command_pool_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_destroy, trace_command_pool_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_reset, trace_command_pool_reset);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_allocate, trace_command_buffers_allocate);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_free, trace_command_buffers_free);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_create, trace_shader_module_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_destroy, trace_shader_module_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_layout_create, trace_pipeline_layout_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_graphics, trace_pipeline_create_graphics);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_compute, trace_pipeline_create_compute);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_destroy, trace_pipeline_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_create, trace_pipeline_library_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_destroy, trace_pipeline_library_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_link, trace_pipeline_link);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_create, trace_texture_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_destroy, trace_texture_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_get_tiling, trace_texture_get_tiling);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_get_tile_feedback, trace_texture_get_tile_feedback);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_map, trace_texture_map);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_unmap, trace_texture_unmap);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_create, trace_tile_heap_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_destroy, trace_tile_heap_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_create, trace_fence_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_destroy, trace_fence_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_get_value, trace_fence_get_value);
+    VRI_LAYER_WRAP(p_device_table, pfn_fences_wait, trace_fences_wait);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_create, trace_swapchain_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_destroy, trace_swapchain_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_acquire_next_image, trace_swapchain_acquire_next_image);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_present, trace_swapchain_present);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_get_texture, trace_swapchain_get_texture);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_get_stats, trace_swapchain_get_stats);
+
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_begin, trace_command_buffer_begin);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_end, trace_command_buffer_end);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_reset, trace_command_buffer_reset);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_bind_pipeline, trace_cmd_bind_pipeline);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_update_texture, trace_cmd_update_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_generate_mips, trace_cmd_generate_mips);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_copy_texture, trace_cmd_copy_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_viewport, trace_cmd_set_viewport);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_scissor, trace_cmd_set_scissor);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_stencil_reference, trace_cmd_set_stencil_reference);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_blend_constants, trace_cmd_set_blend_constants);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_depth_bias, trace_cmd_set_depth_bias);
+
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_submit, trace_queue_submit);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_wait_idle, trace_queue_wait_idle);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_present, trace_queue_present);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_bind_sparse, trace_queue_bind_sparse);
+
+    trace(device, "Trace layer installed on device %p", H(device));
+    return VRI_SUCCESS;
+}
@@ -0,0 +1,1068 @@
+#include "vri_layer.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// API usage validation. Installed when VriDeviceDesc::enable_api_validation is
+// set, otherwise none of these checks are on the call path. Invalid calls are
+// reported through the debug callback and are not forwarded to the backend, so
+// an invalid enum never reaches a backend lookup table.
+
+#define NEXT(device)   VRI_LAYER_LINK((device), VRI_LAYER_ID_VALIDATION)
+#define OBJECT(handle) ((const VriObjectBase *)(uintptr_t)(handle))
+
+static VriResult validation_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table);
+
+const VriLayer vri_validation_layer = {
+    .p_name = VRI_LAYER_VALIDATION_NAME,
+    .id = VRI_LAYER_ID_VALIDATION,
+    .pfn_install = validation_install,
+};
+
+static void report(VriDevice device, VriMessageSeverity severity, const char *p_function, const char *p_format, ...) {
+    char    message[512];
+    int     length = snprintf(message, sizeof(message), "[Validation] %s: ", p_function);
+    va_list args;
+
+    va_start(args, p_format);
+    vsnprintf(message + length, sizeof(message) - (size_t)length, p_format, args);
+    va_end(args);
+
+    device->debug_callback.pfn_message_callback(severity, message);
+}
+
+// Handles must be non-NULL, of the expected type and created from the same device
+static VriBool check_object(VriDevice device, const VriObjectBase *object, VriObjectType type, const char *p_function, const char *p_parameter) {
+    if (!object) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s is NULL", p_parameter);
+        return VRI_FALSE;
+    }
+    if (object->type == VRI_OBJECT_TYPE_DESTROYED) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s was already destroyed", p_parameter);
+        return VRI_FALSE;
+    }
+    if (object->type != type) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s is not a %s", p_parameter, vri_object_type_name(type));
+        return VRI_FALSE;
+    }
+    if (object->p_device != device) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s belongs to a different device", p_parameter);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+// Same as check_object, but destroying VRI_NULL_HANDLE is allowed
+static VriBool check_optional_object(VriDevice device, const VriObjectBase *object, VriObjectType type, const char *p_function, const char *p_parameter) {
+    return !object || check_object(device, object, type, p_function, p_parameter);
+}
+
+static VriBool check_enum(VriDevice device, uint32_t value, uint32_t count, const char *p_function, const char *p_parameter) {
+    if (value >= count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s is out of range (%u, expected < %u)", p_parameter, value, count);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+static VriBool check_pointer(VriDevice device, const void *pointer, const char *p_function, const char *p_parameter) {
+    if (!pointer) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s is NULL", p_parameter);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+// Pitches are required even for 2D data, slice_pitch is also the size of a 2D subresource
+static VriBool check_subresource_data(VriDevice device, const VriSubresourceData *p_data, const char *p_function, const char *p_parameter) {
+    if (!p_data->p_data || !p_data->row_pitch || p_data->slice_pitch < p_data->row_pitch) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s needs p_data, a row_pitch and a slice_pitch of at least row_pitch", p_parameter);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+// A non-empty region of one subresource, aligned to the format's blocks except where it ends at the edge of the mip
+static VriBool check_texture_region(VriDevice device, VriTexture texture, const VriTextureLocation *p_location, uint32_t region_width, uint32_t region_height,
+                                    uint32_t region_depth, const char *p_function) {
+    const VriTextureDesc *desc = &texture->desc;
+    if (p_location->mip_level >= desc->mip_count || p_location->array_layer >= desc->layer_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "mip %u, layer %u is outside the texture (%u mips, %u layers)", p_location->mip_level,
+               p_location->array_layer, desc->mip_count, desc->layer_count);
+        return VRI_FALSE;
+    }
+
+    uint32_t width = VRI_MAX(desc->width >> p_location->mip_level, 1u);
+    uint32_t height = VRI_MAX(desc->height >> p_location->mip_level, 1u);
+    uint32_t depth = VRI_MAX(desc->depth >> p_location->mip_level, 1u);
+    if (!region_width || !region_height || !region_depth || (uint64_t)p_location->x + region_width > width ||
+        (uint64_t)p_location->y + region_height > height || (uint64_t)p_location->z + region_depth > depth) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "region (%u, %u, %u) %ux%ux%u is empty or outside mip %u (%ux%ux%u)", p_location->x, p_location->y,
+               p_location->z, region_width, region_height, region_depth, p_location->mip_level, width, height, depth);
+        return VRI_FALSE;
+    }
+
+    const VriFormatInfo *info = VRI_FORMAT_INFO(desc->format);
+    if (p_location->x % info->block_width || p_location->y % info->block_height ||
+        (region_width % info->block_width && p_location->x + region_width != width) ||
+        (region_height % info->block_height && p_location->y + region_height != height)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "region isn't aligned to the format's %ux%u blocks", info->block_width, info->block_height);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+static const char *command_buffer_state_name(VriCommandBufferState state) {
+    switch (state) {
+        case VRI_COMMAND_BUFFER_STATE_INITIAL:
+            return "initial";
+        case VRI_COMMAND_BUFFER_STATE_RECORDING:
+            return "recording";
+        case VRI_COMMAND_BUFFER_STATE_EXECUTABLE:
+            return "executable";
+        case VRI_COMMAND_BUFFER_STATE_PENDING:
+            return "pending";
+        default:
+            return "invalid";
+    }
+}
+
+static VriBool check_command_buffer_state(VriCommandBuffer command_buffer, VriCommandBufferState expected, const char *p_function) {
+    if (command_buffer->state != expected) {
+        report(command_buffer->base.p_device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "command buffer is %s, expected %s",
+               command_buffer_state_name(command_buffer->state), command_buffer_state_name(expected));
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+// Timeline fences may only move forward. The highest value anything has been
+// asked to signal is kept on the fence, which also catches waits that can never finish.
+static VriBool check_fence_signal(VriDevice device, VriFence fence, uint64_t value, const char *p_function) {
+    uint64_t last = VRI_ATOMIC_LOAD_U64(&fence->last_signaled_value);
+    if (value <= last) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "fence signal value %llu is not greater than the previously signaled %llu",
+               (unsigned long long)value, (unsigned long long)last);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+// Records the objects a command uses, so a submit can tell one was destroyed after it was recorded
+static void track_ref(VriCommandBuffer command_buffer, const VriObjectBase *object) {
+    VriDevice device = command_buffer->base.p_device;
+    for (uint32_t i = command_buffer->ref_count; i-- > 0;) {
+        if (command_buffer->p_refs[i].object == object) return;
+    }
+
+    if (command_buffer->ref_count == command_buffer->ref_capacity) {
+        const VriAllocationCallback *alloc = &device->allocation_callback;
+        uint32_t                     capacity = VRI_MAX(command_buffer->ref_capacity * 2, 16u);
+        VriObjectRef                *p_refs = alloc->pfn_allocate(capacity * sizeof(VriObjectRef), sizeof(void *), VRI_ALLOCATION_SCOPE_COMMAND);
+        if (!p_refs) return;
+        if (command_buffer->ref_count) {
+            memcpy(p_refs, command_buffer->p_refs, command_buffer->ref_count * sizeof(VriObjectRef));
+        }
+        if (command_buffer->p_refs) {
+            alloc->pfn_free(command_buffer->p_refs, command_buffer->ref_capacity * sizeof(VriObjectRef), sizeof(void *), VRI_ALLOCATION_SCOPE_COMMAND);
+        }
+        command_buffer->p_refs = p_refs;
+        command_buffer->ref_capacity = capacity;
+    }
+
+    VriObjectRef *ref = &command_buffer->p_refs[command_buffer->ref_count++];
+    ref->object = object;
+    ref->generation = object->generation;
+}
+
+static void release_refs(VriCommandBuffer command_buffer) {
+    if (command_buffer->p_refs) {
+        command_buffer->base.p_device->allocation_callback.pfn_free(command_buffer->p_refs, command_buffer->ref_capacity * sizeof(VriObjectRef), sizeof(void *),
+                                                                    VRI_ALLOCATION_SCOPE_COMMAND);
+    }
+    command_buffer->p_refs = NULL;
+    command_buffer->ref_count = 0;
+    command_buffer->ref_capacity = 0;
+}
+
+static void release_live_refs(void *p_user_data, VriObjectBase *object) {
+    (void)p_user_data;
+    release_refs((VriCommandBuffer)object);
+}
+
+// A slot freed and reused since recording has a newer generation, even when it now holds an object of the same type
+static VriBool check_refs(VriDevice device, VriCommandBuffer command_buffer, const char *p_function) {
+    for (uint32_t i = 0; i < command_buffer->ref_count; ++i) {
+        const VriObjectRef *ref = &command_buffer->p_refs[i];
+        if (ref->object->generation != ref->generation) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "command buffer uses a %s that was destroyed after it was recorded",
+                   ref->object->type == VRI_OBJECT_TYPE_DESTROYED ? "object" : vri_object_type_name(ref->object->type));
+            return VRI_FALSE;
+        }
+    }
+    return VRI_TRUE;
+}
+
+static void track_fence_signal(VriFence fence, uint64_t value) {
+    VRI_ATOMIC_STORE_U64(&fence->last_signaled_value, value);
+}
+
+static VriBool check_shader(VriDevice device, const VriShaderModuleDesc *p_shader, const char *p_function) {
+    const VriShaderStageFlagBits stage = p_shader->stage;
+    if (stage == VRI_SHADER_STAGE_FLAG_BIT_NONE || (stage & (stage - 1)) != 0 || stage > VRI_SHADER_STAGE_FLAG_BIT_COMPUTE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "shader stage 0x%x must be exactly one stage bit", (uint32_t)stage);
+        return VRI_FALSE;
+    }
+    if (p_shader->module) {
+        if (!check_object(device, OBJECT(p_shader->module), VRI_OBJECT_TYPE_SHADER_MODULE, p_function, "module")) return VRI_FALSE;
+        if (p_shader->module->stage != stage) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "shader stage 0x%x doesn't match its module's 0x%x", (uint32_t)stage, (uint32_t)p_shader->module->stage);
+            return VRI_FALSE;
+        }
+    }
+
+    if (!p_shader->specialization_constant_count) return VRI_TRUE;
+    if (!check_pointer(device, p_shader->p_specialization_constants, p_function, "p_specialization_constants")) return VRI_FALSE;
+
+    // One bit per constant id, VRI_MAX_SPECIALIZATION_CONSTANTS is 64
+    uint64_t specialized = 0;
+    for (uint32_t i = 0; i < p_shader->specialization_constant_count; ++i) {
+        uint32_t id = p_shader->p_specialization_constants[i].constant_id;
+        if (id >= VRI_MAX_SPECIALIZATION_CONSTANTS) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "constant_id %u must be below %u", id, VRI_MAX_SPECIALIZATION_CONSTANTS);
+            return VRI_FALSE;
+        }
+        if (specialized & (1ull << id)) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "constant_id %u is specialized more than once", id);
+            return VRI_FALSE;
+        }
+        specialized |= 1ull << id;
+    }
+    return VRI_TRUE;
+}
+
+static VriBool check_stencil_op(VriDevice device, const VriStencilOpDesc *p_op, const char *p_function, const char *p_face) {
+    char name[64];
+    snprintf(name, sizeof(name), "p_depth_stencil_state->%s", p_face);
+
+    if (p_op->fail_op >= VRI_STENCIL_OP_COUNT || p_op->depth_fail_op >= VRI_STENCIL_OP_COUNT || p_op->pass_op >= VRI_STENCIL_OP_COUNT) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s has a stencil op out of range", name);
+        return VRI_FALSE;
+    }
+    return check_enum(device, p_op->compare_op, VRI_COMPARE_COUNT, p_function, name);
+}
+
+// Only the members read by the given pipeline library parts are checked, a
+// complete pipeline has all of them
+static VriBool check_graphics_pipeline_desc(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipelineLibraryFlags parts, const char *fn) {
+    VriBool vertex_input = (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT) != 0;
+    VriBool pre_rasterization = (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION) != 0;
+    VriBool fragment_shader = (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER) != 0;
+    VriBool fragment_output = (parts & VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT) != 0;
+
+    if (!check_pointer(device, p_desc, fn, "p_desc")) return VRI_FALSE;
+    if (vertex_input && !check_pointer(device, p_desc->p_input_assembly_state, fn, "p_input_assembly_state")) return VRI_FALSE;
+    if (pre_rasterization && !check_pointer(device, p_desc->p_rasterization_state, fn, "p_rasterization_state")) return VRI_FALSE;
+    if (fragment_output && !check_pointer(device, p_desc->p_multisample_state, fn, "p_multisample_state")) return VRI_FALSE;
+    if (p_desc->shader_count && !check_pointer(device, p_desc->p_shaders, fn, "p_shaders")) return VRI_FALSE;
+
+    for (uint32_t i = 0; i < p_desc->shader_count; ++i) {
+        if (!check_shader(device, &p_desc->p_shaders[i], fn)) return VRI_FALSE;
+        if (p_desc->p_shaders[i].stage == VRI_SHADER_STAGE_FLAG_BIT_COMPUTE) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_shaders[%u] is a compute shader", i);
+            return VRI_FALSE;
+        }
+    }
+
+    if (vertex_input && !check_enum(device, p_desc->p_input_assembly_state->topology, VRI_PRIMITIVE_TOPOLOGY_COUNT, fn, "topology")) return VRI_FALSE;
+
+    const VriDynamicStateFlags dynamic_states = VRI_DYNAMIC_STATE_FLAG_BIT_SCISSOR | VRI_DYNAMIC_STATE_FLAG_BIT_STENCIL_REFERENCE |
+                                                VRI_DYNAMIC_STATE_FLAG_BIT_BLEND_CONSTANTS | VRI_DYNAMIC_STATE_FLAG_BIT_DEPTH_BIAS;
+    if (p_desc->dynamic_states & ~dynamic_states) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "dynamic_states has unknown bits 0x%x", p_desc->dynamic_states & ~dynamic_states);
+        return VRI_FALSE;
+    }
+
+    if (pre_rasterization) {
+        const VriRasterizationStateDesc *raster = p_desc->p_rasterization_state;
+        if (!check_enum(device, raster->fill_mode, VRI_FILL_MODE_POINT + 1, fn, "fill_mode")) return VRI_FALSE;
+        if (!check_enum(device, raster->cull_mode, VRI_CULL_MODE_COUNT, fn, "cull_mode")) return VRI_FALSE;
+        if (!check_enum(device, raster->front_face, VRI_FRONT_FACE_CLOCKWISE + 1, fn, "front_face")) return VRI_FALSE;
+    }
+
+    if (vertex_input && p_desc->p_vertex_input) {
+        const VriVertexInputDesc *input = p_desc->p_vertex_input;
+        for (uint32_t i = 0; i < input->attribute_count; ++i) {
+            const VriVertexAttributeDesc *attr = &input->p_attributes[i];
+            if (!check_enum(device, attr->format, VRI_FORMAT_COUNT, fn, "vertex attribute format")) return VRI_FALSE;
+            if (!check_enum(device, attr->binding, input->binding_count, fn, "vertex attribute binding")) return VRI_FALSE;
+        }
+    }
+
+    if (fragment_shader && p_desc->p_depth_stencil_state) {
+        const VriDepthStencilStateDesc *ds = p_desc->p_depth_stencil_state;
+        if (!check_enum(device, ds->depth_compare_op, VRI_COMPARE_COUNT, fn, "depth_compare_op")) return VRI_FALSE;
+        if (!check_stencil_op(device, &ds->front, fn, "front")) return VRI_FALSE;
+        if (!check_stencil_op(device, &ds->back, fn, "back")) return VRI_FALSE;
+    }
+
+    if (fragment_output && p_desc->p_color_blend_state) {
+        const VriColorBlendStateDesc *blend = p_desc->p_color_blend_state;
+        if (blend->render_target_count > VRI_ARRAY_SIZE(blend->render_targets)) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "render_target_count %u exceeds %u",
+                   blend->render_target_count, (uint32_t)VRI_ARRAY_SIZE(blend->render_targets));
+            return VRI_FALSE;
+        }
+
+        for (uint32_t i = 0; i < blend->render_target_count; ++i) {
+            const VriColorBlendAttachmentDesc *rt = &blend->render_targets[i];
+            if (rt->src_color_blend_factor >= VRI_BLEND_COUNT || rt->dst_color_blend_factor >= VRI_BLEND_COUNT ||
+                rt->src_alpha_blend_factor >= VRI_BLEND_COUNT || rt->dst_alpha_blend_factor >= VRI_BLEND_COUNT) {
+                report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "render_targets[%u] has a blend factor out of range", i);
+                return VRI_FALSE;
+            }
+            if (rt->color_blend_op >= VRI_BLEND_OP_COUNT || rt->alpha_blend_op >= VRI_BLEND_OP_COUNT) {
+                report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "render_targets[%u] has a blend op out of range", i);
+                return VRI_FALSE;
+            }
+        }
+    }
+
+    return VRI_TRUE;
+}
+
+// Destroying the device with objects still alive leaks whatever backs them, list them while they can still be found
+static void validation_device_destroy(VriDevice device) {
+    if (vri_live_objects_report(device, VRI_MESSAGE_SEVERITY_WARNING)) {
+        report(device, VRI_MESSAGE_SEVERITY_WARNING, "vri_device_destroy", "device destroyed with the objects above still alive");
+    }
+    vri_object_pool_for_each(&device->object_pools[VRI_OBJECT_TYPE_COMMAND_BUFFER], release_live_refs, NULL);
+    NEXT(device)->next_device.pfn_device_destroy(device);
+}
+
+static VriResult validation_device_query_memory_budget(VriDevice device, VriMemoryBudget *p_budget) {
+    if (!check_pointer(device, p_budget, "vri_device_query_memory_budget", "p_budget")) return VRI_ERROR_INVALID_API_USAGE;
+    return NEXT(device)->next_device.pfn_device_query_memory_budget(device, p_budget);
+}
+
+static VriResult validation_command_pool_create(VriDevice device, const VriCommandPoolDesc *p_desc, VriCommandPool *p_command_pool) {
+    const char *fn = "vri_command_pool_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_command_pool, fn, "p_command_pool")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->queue_type, VRI_QUEUE_TYPE_COUNT, fn, "queue_type")) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_command_pool_create(device, p_desc, p_command_pool);
+}
+
+static void validation_command_pool_destroy(VriDevice device, VriCommandPool command_pool) {
+    if (!check_optional_object(device, OBJECT(command_pool), VRI_OBJECT_TYPE_COMMAND_POOL, "vri_command_pool_destroy", "command_pool")) return;
+    NEXT(device)->next_device.pfn_command_pool_destroy(device, command_pool);
+}
+
+static void validation_command_pool_reset(VriDevice device, VriCommandPool command_pool, VriCommandPoolResetFlags flags) {
+    if (!check_object(device, OBJECT(command_pool), VRI_OBJECT_TYPE_COMMAND_POOL, "vri_command_pool_reset", "command_pool")) return;
+    NEXT(device)->next_device.pfn_command_pool_reset(device, command_pool, flags);
+}
+
+static VriResult validation_command_buffers_allocate(VriDevice device, const VriCommandBufferAllocateDesc *p_desc, VriCommandBuffer *p_command_buffers) {
+    const char *fn = "vri_command_buffers_allocate";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_command_buffers, fn, "p_command_buffers")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_object(device, OBJECT(p_desc->command_pool), VRI_OBJECT_TYPE_COMMAND_POOL, fn, "p_desc->command_pool")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_device.pfn_command_buffers_allocate(device, p_desc, p_command_buffers);
+    if (VRI_OK(result)) {
+        for (uint32_t i = 0; i < p_desc->command_buffer_count; ++i) {
+            p_command_buffers[i]->state = VRI_COMMAND_BUFFER_STATE_INITIAL;
+        }
+    }
+    return result;
+}
+
+static void validation_command_buffers_free(VriDevice device, VriCommandPool command_pool, uint32_t command_buffer_count, const VriCommandBuffer *p_command_buffers) {
+    const char *fn = "vri_command_buffers_free";
+    if (!check_object(device, OBJECT(command_pool), VRI_OBJECT_TYPE_COMMAND_POOL, fn, "command_pool")) return;
+    for (uint32_t i = 0; i < command_buffer_count; ++i) {
+        if (!check_object(device, OBJECT(p_command_buffers[i]), VRI_OBJECT_TYPE_COMMAND_BUFFER, fn, "p_command_buffers[i]")) return;
+    }
+
+    for (uint32_t i = 0; i < command_buffer_count; ++i) {
+        release_refs(p_command_buffers[i]);
+    }
+    NEXT(device)->next_device.pfn_command_buffers_free(device, command_pool, command_buffer_count, p_command_buffers);
+}
+
+static VriResult validation_shader_module_create(VriDevice device, const VriShaderModuleDesc *p_desc, VriShaderModule *p_shader_module) {
+    const char *fn = "vri_shader_module_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_shader_module, fn, "p_shader_module")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_pointer(device, p_desc->p_bytecode, fn, "p_desc->p_bytecode")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!p_desc->size) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "size must not be 0");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (p_desc->module || p_desc->specialization_constant_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "module and specialization constants are only given for pipeline stages");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (!check_shader(device, p_desc, fn)) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_shader_module_create(device, p_desc, p_shader_module);
+}
+
+static void validation_shader_module_destroy(VriDevice device, VriShaderModule shader_module) {
+    if (!check_optional_object(device, OBJECT(shader_module), VRI_OBJECT_TYPE_SHADER_MODULE, "vri_shader_module_destroy", "shader_module")) return;
+    NEXT(device)->next_device.pfn_shader_module_destroy(device, shader_module);
+}
+
+static VriResult validation_pipeline_create_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    if (!check_pointer(device, p_pipeline, "vri_pipeline_create_graphics", "p_pipeline")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_graphics_pipeline_desc(device, p_desc, VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL, "vri_pipeline_create_graphics")) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_pipeline_create_graphics(device, p_desc, p_pipeline);
+}
+
+static VriResult validation_pipeline_create_compute(VriDevice device, const VriComputePipelineDesc *p_desc, VriPipeline *p_pipeline) {
+    const char *fn = "vri_pipeline_create_compute";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_pipeline, fn, "p_pipeline")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_pointer(device, p_desc->p_shader, fn, "p_shader")) return VRI_ERROR_INVALID_API_USAGE;
+    if (p_desc->p_shader->stage != VRI_SHADER_STAGE_FLAG_BIT_COMPUTE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_shader is not a compute shader");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (!check_shader(device, p_desc->p_shader, fn)) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_pipeline_create_compute(device, p_desc, p_pipeline);
+}
+
+static void validation_pipeline_destroy(VriDevice device, VriPipeline pipeline) {
+    if (!check_optional_object(device, OBJECT(pipeline), VRI_OBJECT_TYPE_PIPELINE, "vri_pipeline_destroy", "pipeline")) return;
+    NEXT(device)->next_device.pfn_pipeline_destroy(device, pipeline);
+}
+
+static VriResult validation_pipeline_library_create(VriDevice device, const VriPipelineLibraryDesc *p_desc, VriPipelineLibrary *p_library) {
+    const char *fn = "vri_pipeline_library_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_library, fn, "p_library")) return VRI_ERROR_INVALID_API_USAGE;
+
+    if (!p_desc->parts || (p_desc->parts & ~(VriPipelineLibraryFlags)VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "parts 0x%x is empty or has unknown bits", p_desc->parts);
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (!check_graphics_pipeline_desc(device, p_desc->p_desc, p_desc->parts, fn)) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_pipeline_library_create(device, p_desc, p_library);
+}
+
+static void validation_pipeline_library_destroy(VriDevice device, VriPipelineLibrary library) {
+    if (!check_optional_object(device, OBJECT(library), VRI_OBJECT_TYPE_PIPELINE_LIBRARY, "vri_pipeline_library_destroy", "library")) return;
+    NEXT(device)->next_device.pfn_pipeline_library_destroy(device, library);
+}
+
+// Every part has to come from exactly one library
+static VriResult validation_pipeline_link(VriDevice device, const VriPipelineLinkDesc *p_desc, VriPipeline *p_pipeline) {
+    const char *fn = "vri_pipeline_link";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_pipeline, fn, "p_pipeline")) return VRI_ERROR_INVALID_API_USAGE;
+    if (p_desc->library_count && !check_pointer(device, p_desc->p_libraries, fn, "p_libraries")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriPipelineLibraryFlags parts = 0;
+    for (uint32_t i = 0; i < p_desc->library_count; ++i) {
+        if (!check_object(device, OBJECT(p_desc->p_libraries[i]), VRI_OBJECT_TYPE_PIPELINE_LIBRARY, fn, "p_libraries[i]")) return VRI_ERROR_INVALID_API_USAGE;
+        if (parts & p_desc->p_libraries[i]->parts) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_libraries[%u] has parts 0x%x already linked from another library", i, parts & p_desc->p_libraries[i]->parts);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        parts |= p_desc->p_libraries[i]->parts;
+    }
+    if (parts != VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "libraries are missing parts 0x%x", VRI_PIPELINE_LIBRARY_FLAG_BITS_ALL & ~parts);
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    return NEXT(device)->next_device.pfn_pipeline_link(device, p_desc, p_pipeline);
+}
+
+static VriResult validation_texture_create(VriDevice device, const VriTextureDesc *p_desc, VriTexture *p_texture) {
+    const char *fn = "vri_texture_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_texture, fn, "p_texture")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->type, VRI_TEXTURE_TYPE_TEXTURE_CUBE + 1, fn, "type")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->format, VRI_FORMAT_COUNT, fn, "format")) return VRI_ERROR_INVALID_API_USAGE;
+    if (p_desc->format == VRI_FORMAT_UNDEFINED) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "format is VRI_FORMAT_UNDEFINED");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (!p_desc->width || !p_desc->height || !p_desc->depth || !p_desc->mip_count || !p_desc->layer_count || !p_desc->sample_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "width, height, depth, mip_count, layer_count and sample_count must all be non-zero");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    const VriFormatInfo *info = VRI_FORMAT_INFO(p_desc->format);
+    if (p_desc->width % info->block_width || p_desc->height % info->block_height) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "%ux%u isn't a multiple of the format's %ux%u blocks", p_desc->width, p_desc->height, info->block_width,
+               info->block_height);
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (info->block_width > 1 && (p_desc->usage & (VRI_TEXTURE_USAGE_BIT_COLOR_ATTACHMENT | VRI_TEXTURE_USAGE_BIT_DEPTH_STENCIL_ATTACHMENT))) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "block-compressed formats can't be attachments");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if ((p_desc->usage & VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS) && (info->block_width > 1 || !(info->aspects & VRI_FORMAT_ASPECT_FLAG_BIT_COLOR))) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "mips can only be generated for uncompressed color formats");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (p_desc->usage & VRI_TEXTURE_USAGE_BIT_SPARSE) {
+        if (p_desc->type != VRI_TEXTURE_TYPE_TEXTURE_2D || p_desc->layer_count > 1 || p_desc->sample_count > 1 || p_desc->p_initial_data) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "sparse textures must be single-layer, single-sampled 2D textures without initial data");
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        if (info->block_size & (info->block_size - 1)) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "sparse textures need a format with a power of two block size");
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+    if (!check_enum(device, p_desc->memory_type, VRI_MEMORY_TYPE_COUNT, fn, "memory_type")) return VRI_ERROR_INVALID_API_USAGE;
+    if (p_desc->memory_type == VRI_MEMORY_TYPE_READBACK && (p_desc->usage || p_desc->sample_count > 1 || p_desc->p_initial_data)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "READBACK textures are single-sampled and have no usage or initial data");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (p_desc->p_initial_data) {
+        if (p_desc->sample_count > 1) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "multisampled textures can't have initial data");
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        uint32_t count = p_desc->mip_count * (p_desc->type == VRI_TEXTURE_TYPE_TEXTURE_3D ? 1 : p_desc->layer_count);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!check_subresource_data(device, &p_desc->p_initial_data[i], fn, "p_initial_data[i]")) return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+
+    return NEXT(device)->next_device.pfn_texture_create(device, p_desc, p_texture);
+}
+
+static void validation_texture_destroy(VriDevice device, VriTexture texture) {
+    if (!check_optional_object(device, OBJECT(texture), VRI_OBJECT_TYPE_TEXTURE, "vri_texture_destroy", "texture")) return;
+    NEXT(device)->next_device.pfn_texture_destroy(device, texture);
+}
+
+static VriBool check_sparse_texture(VriDevice device, VriTexture texture, const char *p_function, const char *p_parameter) {
+    if (!check_object(device, OBJECT(texture), VRI_OBJECT_TYPE_TEXTURE, p_function, p_parameter)) return VRI_FALSE;
+    if (!(texture->desc.usage & VRI_TEXTURE_USAGE_BIT_SPARSE)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%s wasn't created with VRI_TEXTURE_USAGE_BIT_SPARSE", p_parameter);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+static void validation_texture_get_tiling(VriDevice device, VriTexture texture, VriTextureTiling *p_tiling) {
+    const char *fn = "vri_texture_get_tiling";
+    if (!check_sparse_texture(device, texture, fn, "texture") || !check_pointer(device, p_tiling, fn, "p_tiling")) return;
+    NEXT(device)->next_device.pfn_texture_get_tiling(device, texture, p_tiling);
+}
+
+static VriResult validation_texture_get_tile_feedback(VriDevice device, VriTexture texture, uint32_t tile_count, uint8_t *p_accessed) {
+    const char *fn = "vri_texture_get_tile_feedback";
+    if (!check_sparse_texture(device, texture, fn, "texture") || !check_pointer(device, p_accessed, fn, "p_accessed")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriTextureTiling tiling = {0};
+    NEXT(device)->next_device.pfn_texture_get_tiling(device, texture, &tiling);
+    if (tile_count != tiling.tile_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "tile_count is %u, the texture has %u tiles", tile_count, tiling.tile_count);
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    return NEXT(device)->next_device.pfn_texture_get_tile_feedback(device, texture, tile_count, p_accessed);
+}
+
+static VriBool check_mappable(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, const char *p_function) {
+    if (!check_object(device, OBJECT(texture), VRI_OBJECT_TYPE_TEXTURE, p_function, "texture")) return VRI_FALSE;
+    if (texture->desc.memory_type != VRI_MEMORY_TYPE_READBACK) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "only READBACK textures can be mapped");
+        return VRI_FALSE;
+    }
+    if (mip_level >= texture->desc.mip_count || array_layer >= texture->desc.layer_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "mip %u, layer %u is outside the texture (%u mips, %u layers)", mip_level, array_layer,
+               texture->desc.mip_count, texture->desc.layer_count);
+        return VRI_FALSE;
+    }
+    return VRI_TRUE;
+}
+
+static VriResult validation_texture_map(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer, VriSubresourceData *p_data) {
+    const char *fn = "vri_texture_map";
+    if (!check_mappable(device, texture, mip_level, array_layer, fn) || !check_pointer(device, p_data, fn, "p_data")) return VRI_ERROR_INVALID_API_USAGE;
+    return NEXT(device)->next_device.pfn_texture_map(device, texture, mip_level, array_layer, p_data);
+}
+
+static void validation_texture_unmap(VriDevice device, VriTexture texture, uint32_t mip_level, uint32_t array_layer) {
+    if (!check_mappable(device, texture, mip_level, array_layer, "vri_texture_unmap")) return;
+    NEXT(device)->next_device.pfn_texture_unmap(device, texture, mip_level, array_layer);
+}
+
+static VriResult validation_tile_heap_create(VriDevice device, const VriTileHeapDesc *p_desc, VriTileHeap *p_tile_heap) {
+    const char *fn = "vri_tile_heap_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_tile_heap, fn, "p_tile_heap")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!p_desc->tile_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "tile_count must be non-zero");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    return NEXT(device)->next_device.pfn_tile_heap_create(device, p_desc, p_tile_heap);
+}
+
+static void validation_tile_heap_destroy(VriDevice device, VriTileHeap tile_heap) {
+    if (!check_optional_object(device, OBJECT(tile_heap), VRI_OBJECT_TYPE_TILE_HEAP, "vri_tile_heap_destroy", "tile_heap")) return;
+    NEXT(device)->next_device.pfn_tile_heap_destroy(device, tile_heap);
+}
+
+static VriResult validation_fence_create(VriDevice device, uint64_t initial_value, VriFence *p_fence) {
+    if (!check_pointer(device, p_fence, "vri_fence_create", "p_fence")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_device.pfn_fence_create(device, initial_value, p_fence);
+    if (VRI_OK(result)) {
+        track_fence_signal(*p_fence, initial_value);
+    }
+    return result;
+}
+
+static void validation_fence_destroy(VriDevice device, VriFence fence) {
+    if (!check_optional_object(device, OBJECT(fence), VRI_OBJECT_TYPE_FENCE, "vri_fence_destroy", "fence")) return;
+    NEXT(device)->next_device.pfn_fence_destroy(device, fence);
+}
+
+static uint64_t validation_fence_get_value(VriDevice device, VriFence fence) {
+    if (!check_object(device, OBJECT(fence), VRI_OBJECT_TYPE_FENCE, "vri_fence_get_value", "fence")) return 0;
+    return NEXT(device)->next_device.pfn_fence_get_value(device, fence);
+}
+
+static VriResult validation_fences_wait(VriDevice device, const VriFence *p_fences, const uint64_t *p_values, uint32_t fence_count, VriBool wait_all, uint64_t timeout_ns) {
+    const char *fn = "vri_fences_wait";
+    if (fence_count && (!check_pointer(device, p_fences, fn, "p_fences") || !check_pointer(device, p_values, fn, "p_values"))) return VRI_ERROR_INVALID_API_USAGE;
+
+    for (uint32_t i = 0; i < fence_count; ++i) {
+        if (!check_object(device, OBJECT(p_fences[i]), VRI_OBJECT_TYPE_FENCE, fn, "p_fences[i]")) return VRI_ERROR_INVALID_API_USAGE;
+
+        uint64_t last = VRI_ATOMIC_LOAD_U64(&p_fences[i]->last_signaled_value);
+        if (p_values[i] > last && timeout_ns == UINT64_MAX) {
+            report(device, VRI_MESSAGE_SEVERITY_WARNING, fn, "waiting without a timeout for value %llu, but nothing has been submitted to signal more than %llu",
+                   (unsigned long long)p_values[i], (unsigned long long)last);
+        }
+    }
+
+    return NEXT(device)->next_device.pfn_fences_wait(device, p_fences, p_values, fence_count, wait_all, timeout_ns);
+}
+
+static VriResult validation_swapchain_create(VriDevice device, const VriSwapchainDesc *p_desc, VriSwapchain *p_swapchain) {
+    const char *fn = "vri_swapchain_create";
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_pointer(device, p_swapchain, fn, "p_swapchain")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->format, VRI_FORMAT_COUNT, fn, "format")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->color_space, VRI_COLORSPACE_COUNT, fn, "color_space")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_enum(device, p_desc->present_mode, VRI_PRESENT_MODE_COUNT, fn, "present_mode")) return VRI_ERROR_INVALID_API_USAGE;
+
+    // Without a window the swapchain is headless and owns all of its images
+    if (!p_desc->p_window_desc) {
+        if (!p_desc->width || !p_desc->height) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "headless swapchains have no window to take their size from, width and height can't be 0");
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        if (p_desc->texture_count == 1 || p_desc->texture_count > VRI_SWAPCHAIN_MAX_TEXTURES) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "headless swapchains need 2 to %u textures, got %u", VRI_SWAPCHAIN_MAX_TEXTURES, p_desc->texture_count);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+
+    return NEXT(device)->next_device.pfn_swapchain_create(device, p_desc, p_swapchain);
+}
+
+static void validation_swapchain_destroy(VriDevice device, VriSwapchain swapchain) {
+    if (!check_optional_object(device, OBJECT(swapchain), VRI_OBJECT_TYPE_SWAPCHAIN, "vri_swapchain_destroy", "swapchain")) return;
+    NEXT(device)->next_device.pfn_swapchain_destroy(device, swapchain);
+}
+
+static VriResult validation_swapchain_acquire_next_image(VriDevice device, VriSwapchain swapchain, VriFence fence, uint64_t signal_value, uint32_t *p_image_index) {
+    const char *fn = "vri_swapchain_acquire_next_image";
+    if (!check_object(device, OBJECT(swapchain), VRI_OBJECT_TYPE_SWAPCHAIN, fn, "swapchain")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_pointer(device, p_image_index, fn, "p_image_index")) return VRI_ERROR_INVALID_API_USAGE;
+    if (fence != VRI_NULL_HANDLE) {
+        if (!check_object(device, OBJECT(fence), VRI_OBJECT_TYPE_FENCE, fn, "fence")) return VRI_ERROR_INVALID_API_USAGE;
+        if (!check_fence_signal(device, fence, signal_value, fn)) return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_acquire_next_image(device, swapchain, fence, signal_value, p_image_index);
+    if (result == VRI_ERROR_INVALID_API_USAGE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "every image that isn't on display is already acquired, present one first");
+    }
+    if (VRI_OK(result) && fence != VRI_NULL_HANDLE) {
+        track_fence_signal(fence, signal_value);
+    }
+    return result;
+}
+
+static VriResult validation_swapchain_present(VriDevice device, VriSwapchain swapchain, VriFence fence) {
+    const char *fn = "vri_swapchain_present";
+    if (!check_object(device, OBJECT(swapchain), VRI_OBJECT_TYPE_SWAPCHAIN, fn, "swapchain")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_optional_object(device, OBJECT(fence), VRI_OBJECT_TYPE_FENCE, fn, "fence")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_present(device, swapchain, fence);
+    if (result == VRI_ERROR_INVALID_API_USAGE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "no image is acquired");
+    }
+    return result;
+}
+
+static VriResult validation_swapchain_get_texture(VriDevice device, VriSwapchain swapchain, uint32_t image_index, VriTexture *p_texture) {
+    const char *fn = "vri_swapchain_get_texture";
+    if (!check_object(device, OBJECT(swapchain), VRI_OBJECT_TYPE_SWAPCHAIN, fn, "swapchain")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_pointer(device, p_texture, fn, "p_texture")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_device.pfn_swapchain_get_texture(device, swapchain, image_index, p_texture);
+    if (result == VRI_ERROR_INVALID_API_USAGE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "image_index %u is out of range", image_index);
+    }
+    return result;
+}
+
+static VriResult validation_swapchain_get_stats(VriDevice device, VriSwapchain swapchain, VriSwapchainStats *p_stats) {
+    const char *fn = "vri_swapchain_get_stats";
+    if (!check_object(device, OBJECT(swapchain), VRI_OBJECT_TYPE_SWAPCHAIN, fn, "swapchain")) return VRI_ERROR_INVALID_API_USAGE;
+    if (!check_pointer(device, p_stats, fn, "p_stats")) return VRI_ERROR_INVALID_API_USAGE;
+
+    return NEXT(device)->next_device.pfn_swapchain_get_stats(device, swapchain, p_stats);
+}
+
+static VriResult validation_command_buffer_begin(VriCommandBuffer command_buffer, const VriCommandBufferBeginDesc *p_desc) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_command_buffer_begin";
+
+    // Beginning an executable command buffer implicitly resets it
+    if (command_buffer->state != VRI_COMMAND_BUFFER_STATE_INITIAL && command_buffer->state != VRI_COMMAND_BUFFER_STATE_EXECUTABLE) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "command buffer is %s, expected initial or executable", command_buffer_state_name(command_buffer->state));
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (!check_pointer(device, p_desc, fn, "p_desc")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_begin(command_buffer, p_desc);
+    if (VRI_OK(result)) {
+        command_buffer->state = VRI_COMMAND_BUFFER_STATE_RECORDING;
+        release_refs(command_buffer);
+    }
+    return result;
+}
+
+static VriResult validation_command_buffer_end(VriCommandBuffer command_buffer) {
+    VriDevice device = command_buffer->base.p_device;
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, "vri_command_buffer_end")) return VRI_ERROR_INVALID_API_USAGE;
+
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_end(command_buffer);
+    command_buffer->state = VRI_OK(result) ? VRI_COMMAND_BUFFER_STATE_EXECUTABLE : VRI_COMMAND_BUFFER_STATE_INVALID;
+    return result;
+}
+
+static VriResult validation_command_buffer_reset(VriCommandBuffer command_buffer) {
+    VriDevice device = command_buffer->base.p_device;
+
+    VriResult result = NEXT(device)->next_command_buffer.pfn_command_buffer_reset(command_buffer);
+    if (VRI_OK(result)) {
+        command_buffer->state = VRI_COMMAND_BUFFER_STATE_INITIAL;
+        release_refs(command_buffer);
+    }
+    return result;
+}
+
+static void validation_cmd_bind_pipeline(VriCommandBuffer command_buffer, VriPipeline pipeline) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_bind_pipeline";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_object(device, OBJECT(pipeline), VRI_OBJECT_TYPE_PIPELINE, fn, "pipeline")) return;
+
+    track_ref(command_buffer, OBJECT(pipeline));
+    NEXT(device)->next_command_buffer.pfn_cmd_bind_pipeline(command_buffer, pipeline);
+}
+
+static void validation_cmd_update_texture(VriCommandBuffer command_buffer, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_update_texture";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_object(device, OBJECT(texture), VRI_OBJECT_TYPE_TEXTURE, fn, "texture")) return;
+    if (!check_pointer(device, p_desc, fn, "p_desc") || !check_subresource_data(device, &p_desc->data, fn, "p_desc->data")) return;
+
+    const VriTextureDesc *desc = &texture->desc;
+    VriTextureLocation    location = {p_desc->mip_level, p_desc->array_layer, p_desc->x, p_desc->y, p_desc->z};
+    if (!check_texture_region(device, texture, &location, p_desc->width, p_desc->height, p_desc->depth, fn)) return;
+    if (desc->memory_type == VRI_MEMORY_TYPE_READBACK) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "READBACK textures can only be copied to");
+        return;
+    }
+    if (p_desc->data.row_pitch < vri_format_row_pitch(desc->format, p_desc->width)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "row_pitch %u is less than the %u bytes of a row", p_desc->data.row_pitch,
+               vri_format_row_pitch(desc->format, p_desc->width));
+        return;
+    }
+
+    track_ref(command_buffer, OBJECT(texture));
+    NEXT(device)->next_command_buffer.pfn_cmd_update_texture(command_buffer, texture, p_desc);
+}
+
+static void validation_cmd_generate_mips(VriCommandBuffer command_buffer, VriTexture texture) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_generate_mips";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_object(device, OBJECT(texture), VRI_OBJECT_TYPE_TEXTURE, fn, "texture")) return;
+
+    const VriTextureDesc *desc = &texture->desc;
+    if (!(desc->usage & VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS)) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "texture wasn't created with VRI_TEXTURE_USAGE_BIT_GENERATE_MIPS");
+        return;
+    }
+    if (desc->sample_count > 1) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "multisampled textures have no mips");
+        return;
+    }
+    if (desc->mip_count == 1) {
+        report(device, VRI_MESSAGE_SEVERITY_WARNING, fn, "texture has a single mip, there is nothing to generate");
+    }
+
+    track_ref(command_buffer, OBJECT(texture));
+    NEXT(device)->next_command_buffer.pfn_cmd_generate_mips(command_buffer, texture);
+}
+
+static void validation_cmd_copy_texture(VriCommandBuffer command_buffer, VriTexture src, VriTexture dst, const VriTextureCopyDesc *p_desc) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_copy_texture";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_object(device, OBJECT(src), VRI_OBJECT_TYPE_TEXTURE, fn, "src") || !check_object(device, OBJECT(dst), VRI_OBJECT_TYPE_TEXTURE, fn, "dst")) return;
+    if (!check_pointer(device, p_desc, fn, "p_desc")) return;
+
+    if (src == dst) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "src and dst are the same texture");
+        return;
+    }
+    if (src->desc.format != dst->desc.format || src->desc.sample_count != dst->desc.sample_count) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "src and dst need the same format and sample count");
+        return;
+    }
+    if (!check_texture_region(device, src, &p_desc->src, p_desc->width, p_desc->height, p_desc->depth, fn)) return;
+    if (!check_texture_region(device, dst, &p_desc->dst, p_desc->width, p_desc->height, p_desc->depth, fn)) return;
+
+    track_ref(command_buffer, OBJECT(src));
+    track_ref(command_buffer, OBJECT(dst));
+    NEXT(device)->next_command_buffer.pfn_cmd_copy_texture(command_buffer, src, dst, p_desc);
+}
+
+// Viewports and scissors share the range check, both arrays have VRI_MAX_VIEWPORTS entries
+static VriBool check_viewport_range(VriDevice device, uint32_t first, uint32_t count, const void *p_array, const char *p_function, const char *p_parameter) {
+    if (!count || first >= VRI_MAX_VIEWPORTS || count > VRI_MAX_VIEWPORTS - first) {
+        report(device, VRI_MESSAGE_SEVERITY_ERROR, p_function, "%u entries from %u don't fit into %u", count, first, VRI_MAX_VIEWPORTS);
+        return VRI_FALSE;
+    }
+    return check_pointer(device, p_array, p_function, p_parameter);
+}
+
+static void validation_cmd_set_viewport(VriCommandBuffer command_buffer, uint32_t first_viewport, uint32_t viewport_count, const VriViewport *p_viewports) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_set_viewport";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_viewport_range(device, first_viewport, viewport_count, p_viewports, fn, "p_viewports")) return;
+
+    for (uint32_t i = 0; i < viewport_count; ++i) {
+        const VriViewport *viewport = &p_viewports[i];
+        if (!(viewport->width > 0.0f) || !(viewport->height > 0.0f)) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_viewports[%u] is empty", i);
+            return;
+        }
+        if (!(viewport->min_depth >= 0.0f && viewport->min_depth <= 1.0f) || !(viewport->max_depth >= 0.0f && viewport->max_depth <= 1.0f)) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_viewports[%u] has a depth range outside of [0, 1]", i);
+            return;
+        }
+    }
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_viewport(command_buffer, first_viewport, viewport_count, p_viewports);
+}
+
+static void validation_cmd_set_scissor(VriCommandBuffer command_buffer, uint32_t first_scissor, uint32_t scissor_count, const VriRect2D *p_scissors) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_set_scissor";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_viewport_range(device, first_scissor, scissor_count, p_scissors, fn, "p_scissors")) return;
+
+    for (uint32_t i = 0; i < scissor_count; ++i) {
+        const VriRect2D *scissor = &p_scissors[i];
+        if (scissor->x < 0 || scissor->y < 0 || (int64_t)scissor->x + scissor->width > INT32_MAX || (int64_t)scissor->y + scissor->height > INT32_MAX) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_scissors[%u] has a negative offset or ends past INT32_MAX", i);
+            return;
+        }
+    }
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_scissor(command_buffer, first_scissor, scissor_count, p_scissors);
+}
+
+static void validation_cmd_set_stencil_reference(VriCommandBuffer command_buffer, uint32_t reference) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_set_stencil_reference";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (reference > 0xFF) {
+        report(device, VRI_MESSAGE_SEVERITY_WARNING, fn, "reference %u has more than 8 bits, only the low 8 are used", reference);
+    }
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_stencil_reference(command_buffer, reference);
+}
+
+static void validation_cmd_set_blend_constants(VriCommandBuffer command_buffer, const float blend_constants[4]) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_set_blend_constants";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+    if (!check_pointer(device, blend_constants, fn, "blend_constants")) return;
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_blend_constants(command_buffer, blend_constants);
+}
+
+static void validation_cmd_set_depth_bias(VriCommandBuffer command_buffer, float constant_factor, float clamp, float slope_factor) {
+    VriDevice   device = command_buffer->base.p_device;
+    const char *fn = "vri_cmd_set_depth_bias";
+    if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_RECORDING, fn)) return;
+
+    NEXT(device)->next_command_buffer.pfn_cmd_set_depth_bias(command_buffer, constant_factor, clamp, slope_factor);
+}
+
+static VriResult validation_queue_submit(VriQueue queue, const VriQueueSubmitDesc *p_submits, uint32_t submit_count) {
+    VriDevice   device = queue->base.p_device;
+    const char *fn = "vri_queue_submit";
+    if (submit_count && !check_pointer(device, p_submits, fn, "p_submits")) return VRI_ERROR_INVALID_API_USAGE;
+
+    for (uint32_t i = 0; i < submit_count; ++i) {
+        const VriQueueSubmitDesc *submit = &p_submits[i];
+
+        for (uint32_t j = 0; j < submit->command_buffer_count; ++j) {
+            VriCommandBuffer command_buffer = submit->p_command_buffers[j];
+            if (!check_object(device, OBJECT(command_buffer), VRI_OBJECT_TYPE_COMMAND_BUFFER, fn, "p_command_buffers[i]")) return VRI_ERROR_INVALID_API_USAGE;
+            if (!check_command_buffer_state(command_buffer, VRI_COMMAND_BUFFER_STATE_EXECUTABLE, fn)) return VRI_ERROR_INVALID_API_USAGE;
+            if (!check_refs(device, command_buffer, fn)) return VRI_ERROR_INVALID_API_USAGE;
+        }
+
+        for (uint32_t j = 0; j < submit->fence_wait_count; ++j) {
+            if (!check_object(device, OBJECT(submit->p_fences_wait[j].fence), VRI_OBJECT_TYPE_FENCE, fn, "p_fences_wait[i].fence")) return VRI_ERROR_INVALID_API_USAGE;
+        }
+
+        for (uint32_t j = 0; j < submit->fence_signal_count; ++j) {
+            const VriFenceSignalDesc *signal = &submit->p_fences_signal[j];
+            if (!check_object(device, OBJECT(signal->fence), VRI_OBJECT_TYPE_FENCE, fn, "p_fences_signal[i].fence")) return VRI_ERROR_INVALID_API_USAGE;
+            if (!check_fence_signal(device, signal->fence, signal->value, fn)) return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+
+    VriResult result = NEXT(device)->next_queue.pfn_queue_submit(queue, p_submits, submit_count);
+    if (VRI_OK(result)) {
+        for (uint32_t i = 0; i < submit_count; ++i) {
+            for (uint32_t j = 0; j < p_submits[i].fence_signal_count; ++j) {
+                track_fence_signal(p_submits[i].p_fences_signal[j].fence, p_submits[i].p_fences_signal[j].value);
+            }
+        }
+    }
+    return result;
+}
+
+static VriResult validation_queue_present(VriQueue queue, const VriQueuePresentDesc *p_present) {
+    VriDevice   device = queue->base.p_device;
+    const char *fn = "vri_queue_present";
+    if (!check_pointer(device, p_present, fn, "p_present")) return VRI_ERROR_INVALID_API_USAGE;
+
+    for (uint32_t i = 0; i < p_present->swapchain_count; ++i) {
+        if (!check_object(device, OBJECT(p_present->p_swapchains[i]), VRI_OBJECT_TYPE_SWAPCHAIN, fn, "p_swapchains[i]")) return VRI_ERROR_INVALID_API_USAGE;
+    }
+    for (uint32_t i = 0; i < p_present->wait_fence_count; ++i) {
+        if (!check_object(device, OBJECT(p_present->p_wait_fences[i]), VRI_OBJECT_TYPE_FENCE, fn, "p_wait_fences[i]")) return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    return NEXT(device)->next_queue.pfn_queue_present(queue, p_present);
+}
+
+static VriResult validation_queue_bind_sparse(VriQueue queue, const VriSparseBindDesc *p_binds, uint32_t bind_count) {
+    VriDevice   device = queue->base.p_device;
+    const char *fn = "vri_queue_bind_sparse";
+    if (bind_count && !check_pointer(device, p_binds, fn, "p_binds")) return VRI_ERROR_INVALID_API_USAGE;
+
+    for (uint32_t i = 0; i < bind_count; ++i) {
+        const VriSparseBindDesc *bind = &p_binds[i];
+        if (!check_sparse_texture(device, bind->texture, fn, "p_binds[i].texture")) return VRI_ERROR_INVALID_API_USAGE;
+        if (!check_optional_object(device, OBJECT(bind->heap), VRI_OBJECT_TYPE_TILE_HEAP, fn, "p_binds[i].heap")) return VRI_ERROR_INVALID_API_USAGE;
+
+        VriTextureTiling tiling = {0};
+        NEXT(device)->next_device.pfn_texture_get_tiling(device, bind->texture, &tiling);
+
+        // The packed mips are a single row that is only bound whole
+        uint32_t columns = tiling.packed_tile_count;
+        uint32_t rows = 1;
+        if (bind->mip_level < tiling.standard_mip_count) {
+            columns = (VRI_MAX(bind->texture->desc.width >> bind->mip_level, 1u) + tiling.tile_width - 1) / tiling.tile_width;
+            rows = (VRI_MAX(bind->texture->desc.height >> bind->mip_level, 1u) + tiling.tile_height - 1) / tiling.tile_height;
+        } else if (bind->mip_level > tiling.standard_mip_count || bind->x || bind->y || bind->width != tiling.packed_tile_count || bind->height != 1) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_binds[%u] must be a standard mip, or mip %u with all %u packed tiles", i, tiling.standard_mip_count,
+                   tiling.packed_tile_count);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        if (!bind->width || !bind->height || bind->x + bind->width > columns || bind->y + bind->height > rows) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_binds[%u] is empty or outside mip %u's %ux%u tiles", i, bind->mip_level, columns, rows);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+        if (bind->heap && (uint64_t)bind->heap_offset + bind->width * bind->height > bind->heap->tile_count) {
+            report(device, VRI_MESSAGE_SEVERITY_ERROR, fn, "p_binds[%u] needs %u tiles from heap tile %u, the heap has %u", i, bind->width * bind->height, bind->heap_offset,
+                   bind->heap->tile_count);
+            return VRI_ERROR_INVALID_API_USAGE;
+        }
+    }
+
+    return NEXT(device)->next_queue.pfn_queue_bind_sparse(queue, p_binds, bind_count);
+}
+
+static VriResult validation_install(VriDevice device, VriDeviceDispatchTable *p_device_table, VriCommandBufferDispatchTable *p_command_buffer_table, VriQueueDispatchTable *p_queue_table) {
+    VRI_LAYER_WRAP(p_device_table, pfn_device_destroy, validation_device_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_device_query_memory_budget, validation_device_query_memory_budget);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_create, validation_command_pool_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_destroy, validation_command_pool_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_pool_reset, validation_command_pool_reset);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_allocate, validation_command_buffers_allocate);
+    VRI_LAYER_WRAP(p_device_table, pfn_command_buffers_free, validation_command_buffers_free);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_create, validation_shader_module_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_shader_module_destroy, validation_shader_module_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_graphics, validation_pipeline_create_graphics);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_create_compute, validation_pipeline_create_compute);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_destroy, validation_pipeline_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_create, validation_pipeline_library_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_library_destroy, validation_pipeline_library_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_pipeline_link, validation_pipeline_link);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_create, validation_texture_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_destroy, validation_texture_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_get_tiling, validation_texture_get_tiling);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_get_tile_feedback, validation_texture_get_tile_feedback);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_map, validation_texture_map);
+    VRI_LAYER_WRAP(p_device_table, pfn_texture_unmap, validation_texture_unmap);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_create, validation_tile_heap_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_tile_heap_destroy, validation_tile_heap_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_create, validation_fence_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_destroy, validation_fence_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_fence_get_value, validation_fence_get_value);
+    VRI_LAYER_WRAP(p_device_table, pfn_fences_wait, validation_fences_wait);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_create, validation_swapchain_create);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_destroy, validation_swapchain_destroy);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_acquire_next_image, validation_swapchain_acquire_next_image);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_present, validation_swapchain_present);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_get_texture, validation_swapchain_get_texture);
+    VRI_LAYER_WRAP(p_device_table, pfn_swapchain_get_stats, validation_swapchain_get_stats);
+
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_begin, validation_command_buffer_begin);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_end, validation_command_buffer_end);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_command_buffer_reset, validation_command_buffer_reset);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_bind_pipeline, validation_cmd_bind_pipeline);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_update_texture, validation_cmd_update_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_generate_mips, validation_cmd_generate_mips);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_copy_texture, validation_cmd_copy_texture);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_viewport, validation_cmd_set_viewport);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_scissor, validation_cmd_set_scissor);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_stencil_reference, validation_cmd_set_stencil_reference);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_blend_constants, validation_cmd_set_blend_constants);
+    VRI_LAYER_WRAP(p_command_buffer_table, pfn_cmd_set_depth_bias, validation_cmd_set_depth_bias);
+
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_submit, validation_queue_submit);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_present, validation_queue_present);
+    VRI_LAYER_WRAP(p_queue_table, pfn_queue_bind_sparse, validation_queue_bind_sparse);
+
+    // Freed slots aren't reused straight away, so a stale handle keeps failing its checks instead of aliasing a new object
+    vri_object_pools_quarantine(device);
+
+    report(device, VRI_MESSAGE_SEVERITY_INFO, "vri_device_create", "validation layer enabled");
+    return VRI_SUCCESS;
+}
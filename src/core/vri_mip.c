@@ -0,0 +1,316 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+// CPU-side mip generation. Both filters are separable: for a tile of
+// destination texels the source rows under the filter are first blended into
+// one row of linear floats, which is then filtered horizontally. Texels stay
+// interleaved, so both passes are plain loops over channel-sized float runs
+// the compiler can vectorize. Samples past the edge clamp to it.
+
+#define MIP_MAX_TAPS     6
+#define MIP_MAX_CHANNELS 4
+#define MIP_TILE_WIDTH   64 // Destination texels filtered per tile, bounds the row buffer on the stack
+#define MIP_KAISER_ALPHA 4.0f
+#define MIP_BAND_ROWS    8 // Destination rows a worker claims at a time
+
+typedef struct {
+    int32_t  first; // Offset of the first tap from twice the destination coordinate
+    uint32_t count;
+    float    weights[MIP_MAX_TAPS];
+} MipKernel;
+
+typedef struct {
+    uint32_t     channels;
+    VriBool      is_float;
+    VriBool      srgb;
+    float        unorm_to_linear[256];
+    const float *p_to_linear[MIP_MAX_CHANNELS];
+} MipFormat;
+
+typedef struct {
+    const VriMipGenerateDesc *p_desc;
+    const MipFormat          *p_format;
+    const MipKernel          *p_kernel;
+    uint32_t                  last_row;
+    uint64_t                  next_row; // Atomic
+} MipJob;
+
+// Linear value of every sRGB code
+static const float mip_srgb_to_linear[256] = {
+    0.0f, 0.000303526991f, 0.000607053982f, 0.000910580973f, 0.00121410796f, 0.00151763496f, 0.00182116195f, 0.00212468882f, 0.00242821593f, 0.0027317428f,
+    0.00303526991f, 0.00334653584f, 0.00367650739f, 0.00402471703f, 0.00439144205f, 0.00477695325f, 0.00518151652f, 0.00560539169f, 0.00604883302f,
+    0.00651209056f, 0.00699541019f, 0.00749903219f, 0.00802319311f, 0.00856812578f, 0.00913405884f, 0.00972121768f, 0.010329823f, 0.0109600937f, 0.0116122449f,
+    0.012286488f, 0.0129830325f, 0.0137020834f, 0.0144438436f, 0.0152085144f, 0.0159962941f, 0.0168073755f, 0.0176419541f, 0.01850022f, 0.0193823613f,
+    0.0202885624f, 0.0212190095f, 0.0221738853f, 0.0231533665f, 0.0241576321f, 0.0251868591f, 0.0262412224f, 0.0273208916f, 0.02842604f, 0.0295568351f,
+    0.0307134446f, 0.0318960324f, 0.0331047662f, 0.0343398079f, 0.0356013142f, 0.0368894488f, 0.0382043719f, 0.0395462364f, 0.0409151986f, 0.0423114114f,
+    0.043735031f, 0.045186203f, 0.0466650873f, 0.0481718257f, 0.0497065671f, 0.0512694567f, 0.0528606474f, 0.054480277f, 0.0561284907f, 0.0578054301f,
+    0.0595112368f, 0.0612460524f, 0.0630100146f, 0.064803265f, 0.0666259378f, 0.0684781671f, 0.0703600943f, 0.0722718537f, 0.0742135718f, 0.0761853829f,
+    0.078187421f, 0.0802198201f, 0.0822827071f, 0.0843762085f, 0.0865004584f, 0.0886555836f, 0.0908417106f, 0.0930589661f, 0.0953074694f, 0.097587347f,
+    0.0998987257f, 0.102241732f, 0.104616486f, 0.107023105f, 0.10946171f, 0.111932427f, 0.114435375f, 0.116970666f, 0.119538426f, 0.122138776f, 0.124771819f,
+    0.127437681f, 0.130136475f, 0.13286832f, 0.135633335f, 0.138431609f, 0.141263291f, 0.144128472f, 0.147027269f, 0.149959788f, 0.152926147f, 0.155926466f,
+    0.158960834f, 0.162029371f, 0.165132195f, 0.168269396f, 0.171441108f, 0.174647406f, 0.177888423f, 0.18116425f, 0.18447499f, 0.187820777f, 0.191201687f,
+    0.194617838f, 0.198069319f, 0.20155625f, 0.205078736f, 0.208636865f, 0.212230757f, 0.215860501f, 0.219526201f, 0.223227963f, 0.226965874f, 0.230740055f,
+    0.23455058f, 0.238397568f, 0.242281124f, 0.246201321f, 0.25015828f, 0.254152089f, 0.258182853f, 0.262250662f, 0.266355604f, 0.270497799f, 0.274677306f,
+    0.278894275f, 0.283148736f, 0.287440836f, 0.291770637f, 0.296138257f, 0.300543785f, 0.304987311f, 0.309468925f, 0.313988715f, 0.318546772f, 0.323143214f,
+    0.327778101f, 0.332451522f, 0.337163627f, 0.341914415f, 0.346704066f, 0.351532608f, 0.356400132f, 0.361306787f, 0.366252601f, 0.371237695f, 0.376262128f,
+    0.38132602f, 0.386429429f, 0.391572475f, 0.396755219f, 0.401977777f, 0.407240212f, 0.412542611f, 0.417885065f, 0.423267663f, 0.428690493f, 0.434153646f,
+    0.439657182f, 0.445201188f, 0.450785786f, 0.456411034f, 0.462076992f, 0.467783809f, 0.473531485f, 0.479320168f, 0.48514995f, 0.491020858f, 0.496932983f,
+    0.502886474f, 0.50888133f, 0.514917672f, 0.520995557f, 0.527115107f, 0.533276379f, 0.539479494f, 0.545724452f, 0.55201143f, 0.558340371f, 0.564711511f,
+    0.571124852f, 0.577580452f, 0.584078431f, 0.590618849f, 0.597201765f, 0.603827357f, 0.610495567f, 0.617206573f, 0.623960376f, 0.630757153f, 0.637596846f,
+    0.644479692f, 0.651405632f, 0.658374846f, 0.665387273f, 0.672443151f, 0.679542482f, 0.686685324f, 0.693871737f, 0.701101899f, 0.708375752f, 0.715693474f,
+    0.723055124f, 0.730460763f, 0.73791039f, 0.745404184f, 0.752942204f, 0.760524511f, 0.768151164f, 0.775822222f, 0.783537805f, 0.791297913f, 0.799102724f,
+    0.806952238f, 0.814846575f, 0.822785735f, 0.830769897f, 0.838799f, 0.846873224f, 0.854992628f, 0.863157213f, 0.871367097f, 0.8796224f, 0.887923121f,
+    0.896269381f, 0.904661179f, 0.913098633f, 0.921581864f, 0.930110872f, 0.938685715f, 0.947306514f, 0.955973327f, 0.964686275f, 0.973445296f, 0.982250571f,
+    0.991102099f, 1.0f,
+};
+
+// Linear value of the midpoint between sRGB codes i and i + 1. Rounding happens
+// in sRGB space, so that is where a linear value starts encoding to i + 1
+static const float mip_srgb_thresholds[255] = {
+    0.000151763496f, 0.000455290487f, 0.000758817478f, 0.00106234441f, 0.0013658714f, 0.00166939839f, 0.00197292538f, 0.00227645249f, 0.00257997937f,
+    0.00288350624f, 0.00318830088f, 0.00350925932f, 0.00384831498f, 0.00420574797f, 0.00458183279f, 0.00497683743f, 0.00539102405f, 0.00582465064f,
+    0.00627796957f, 0.00675122766f, 0.00724466844f, 0.00775853032f, 0.00829304848f, 0.00884845294f, 0.00942497049f, 0.0100228256f, 0.010642237f, 0.011283421f,
+    0.0119465925f, 0.0126319602f, 0.0133397318f, 0.0140701123f, 0.0148233026f, 0.0155995032f, 0.0163989104f, 0.0172217153f, 0.0180681143f, 0.0189382937f,
+    0.0198324434f, 0.0207507443f, 0.0216933824f, 0.0226605386f, 0.0236523896f, 0.0246691145f, 0.0257108882f, 0.0267778821f, 0.0278702695f, 0.0289882198f,
+    0.0301319025f, 0.0313014798f, 0.0324971229f, 0.0337189883f, 0.0349672437f, 0.0362420455f, 0.0375435539f, 0.0388719253f, 0.04022732f, 0.041609887f,
+    0.0430197865f, 0.0444571637f, 0.0459221713f, 0.0474149622f, 0.0489356853f, 0.0504844859f, 0.0520615056f, 0.0536668971f, 0.055300802f, 0.0569633618f,
+    0.0586547181f, 0.0603750125f, 0.0621243827f, 0.0639029741f, 0.0657109171f, 0.0675483495f, 0.0694154128f, 0.0713122338f, 0.0732389539f, 0.0751957074f,
+    0.0771826133f, 0.0791998208f, 0.0812474415f, 0.0833256245f, 0.085434489f, 0.0875741541f, 0.089744769f, 0.091946438f, 0.0941793025f, 0.0964434743f,
+    0.098739095f, 0.101066269f, 0.10342513f, 0.105815805f, 0.108238399f, 0.110693045f, 0.113179862f, 0.115698971f, 0.118250482f, 0.120834522f, 0.123451203f,
+    0.126100644f, 0.128782958f, 0.131498262f, 0.134246677f, 0.137028307f, 0.13984327f, 0.142691687f, 0.145573661f, 0.148489311f, 0.151438728f, 0.15442206f,
+    0.157439381f, 0.160490826f, 0.163576499f, 0.166696489f, 0.169850931f, 0.173039913f, 0.176263571f, 0.179521978f, 0.182815254f, 0.186143503f, 0.189506829f,
+    0.192905352f, 0.196339145f, 0.199808344f, 0.203313038f, 0.206853345f, 0.210429341f, 0.214041144f, 0.217688844f, 0.22137256f, 0.225092396f, 0.228848428f,
+    0.232640758f, 0.236469507f, 0.240334779f, 0.244236633f, 0.248175204f, 0.252150565f, 0.256162852f, 0.260212123f, 0.264298469f, 0.268422037f, 0.272582889f,
+    0.276781112f, 0.281016797f, 0.285290092f, 0.289601028f, 0.293949723f, 0.298336297f, 0.30276081f, 0.30722335f, 0.311724037f, 0.31626296f, 0.32084018f,
+    0.325455844f, 0.330109984f, 0.334802747f, 0.339534163f, 0.344304383f, 0.349113464f, 0.353961498f, 0.358848572f, 0.363774776f, 0.368740231f, 0.373744965f,
+    0.378789127f, 0.383872777f, 0.388996005f, 0.3941589f, 0.399361521f, 0.404604018f, 0.40988642f, 0.415208817f, 0.420571357f, 0.425974041f, 0.431417018f,
+    0.436900347f, 0.442424119f, 0.447988421f, 0.453593314f, 0.459238917f, 0.464925289f, 0.470652521f, 0.476420701f, 0.482229918f, 0.488080233f, 0.493971765f,
+    0.499904543f, 0.505878687f, 0.511894286f, 0.517951429f, 0.524050117f, 0.530190527f, 0.536372721f, 0.542596757f, 0.548862696f, 0.555170655f, 0.561520696f,
+    0.567912877f, 0.574347317f, 0.580824137f, 0.587343335f, 0.593904972f, 0.600509226f, 0.607156098f, 0.613845706f, 0.62057811f, 0.62735337f, 0.634171605f,
+    0.641032875f, 0.647937238f, 0.654884815f, 0.661875665f, 0.668909788f, 0.675987363f, 0.683108449f, 0.690273106f, 0.697481334f, 0.704733372f, 0.712029159f,
+    0.719368815f, 0.72675246f, 0.734180033f, 0.741651773f, 0.749167681f, 0.756727815f, 0.764332294f, 0.77198112f, 0.779674411f, 0.787412286f, 0.795194745f,
+    0.803021908f, 0.810893834f, 0.818810523f, 0.826772213f, 0.834778786f, 0.842830479f, 0.850927293f, 0.859069228f, 0.867256522f, 0.875489056f, 0.883767068f,
+    0.892090559f, 0.900459588f, 0.908874214f, 0.917334557f, 0.925840616f, 0.934392571f, 0.942990363f, 0.951634169f, 0.960324049f, 0.969060004f, 0.977842152f,
+    0.986670554f, 0.995545268f,
+};
+
+static VriBool mip_format_init(VriFormat format, MipFormat *p_format);
+static void    mip_kernel_init(VriMipFilter filter, MipKernel *p_kernel);
+static float   mip_bessel_i0(float x);
+static void    mip_load_row(const MipFormat *p_format, const uint8_t *p_src, int32_t first_texel, uint32_t texel_count, uint32_t width, float *p_row);
+static void    mip_store_row(const MipFormat *p_format, const float *p_row, uint32_t texel_count, uint8_t *p_dst);
+static void    mip_generate_rows(const VriMipGenerateDesc *p_desc, const MipFormat *p_format, const MipKernel *p_kernel, uint32_t first_row, uint32_t last_row);
+static void    mip_run(void *p_job);
+
+VriResult vri_mip_generate(const VriMipGenerateDesc *p_desc) {
+    if (!p_desc->p_src || !p_desc->p_dst || !p_desc->width || !p_desc->height || p_desc->filter >= VRI_MIP_FILTER_COUNT) {
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    MipFormat format;
+    if (!mip_format_init(p_desc->format, &format)) return VRI_ERROR_UNSUPPORTED;
+
+    MipKernel kernel;
+    mip_kernel_init(p_desc->filter, &kernel);
+
+    uint32_t dst_height = VRI_MAX(p_desc->height / 2, 1u);
+    if (p_desc->first_row >= dst_height) return VRI_ERROR_INVALID_API_USAGE;
+
+    uint32_t last_row = p_desc->row_count ? VRI_MIN(p_desc->first_row + p_desc->row_count, dst_height) : dst_height;
+
+    // Workers claim bands of rows, rows never depend on each other
+    uint32_t band_count = (last_row - p_desc->first_row + MIP_BAND_ROWS - 1) / MIP_BAND_ROWS;
+    uint32_t thread_count = VRI_MIN(p_desc->thread_count, band_count);
+    if (thread_count > 1) {
+        MipJob job = {p_desc, &format, &kernel, last_row, p_desc->first_row};
+        vri_threads_run(thread_count, mip_run, &job);
+    } else {
+        mip_generate_rows(p_desc, &format, &kernel, p_desc->first_row, last_row);
+    }
+
+    return VRI_SUCCESS;
+}
+
+static void mip_generate_rows(const VriMipGenerateDesc *p_desc, const MipFormat *p_format, const MipKernel *p_kernel, uint32_t first_row, uint32_t last_row) {
+    uint32_t dst_width = VRI_MAX(p_desc->width / 2, 1u);
+    size_t   texel_size = VRI_FORMAT_INFO(p_desc->format)->block_size;
+
+    // One tile spans twice its destination width in source texels, plus the taps hanging over either side
+    float source[(MIP_TILE_WIDTH * 2 + MIP_MAX_TAPS) * MIP_MAX_CHANNELS];
+    float blended[(MIP_TILE_WIDTH * 2 + MIP_MAX_TAPS) * MIP_MAX_CHANNELS];
+    float filtered[MIP_TILE_WIDTH * MIP_MAX_CHANNELS];
+
+    for (uint32_t y = first_row; y < last_row; ++y) {
+        uint8_t *p_dst = (uint8_t *)p_desc->p_dst + (size_t)y * p_desc->dst_row_pitch;
+
+        for (uint32_t x = 0; x < dst_width; x += MIP_TILE_WIDTH) {
+            uint32_t tile_width = VRI_MIN(dst_width - x, (uint32_t)MIP_TILE_WIDTH);
+            int32_t  first_texel = (int32_t)(x * 2) + p_kernel->first;
+            uint32_t source_count = tile_width * 2 + p_kernel->count - 2;
+            uint32_t value_count = source_count * p_format->channels;
+
+            // Vertical pass over the tile's source columns
+            memset(blended, 0, sizeof(float) * value_count);
+            for (uint32_t tap = 0; tap < p_kernel->count; ++tap) {
+                int32_t  src_y = (int32_t)(y * 2) + p_kernel->first + (int32_t)tap;
+                uint32_t clamped_y = (uint32_t)VRI_MIN(VRI_MAX(src_y, 0), (int32_t)p_desc->height - 1);
+
+                const uint8_t *p_src = (const uint8_t *)p_desc->p_src + (size_t)clamped_y * p_desc->src_row_pitch;
+                mip_load_row(p_format, p_src, first_texel, source_count, p_desc->width, source);
+
+                float weight = p_kernel->weights[tap];
+                for (uint32_t i = 0; i < value_count; ++i) {
+                    blended[i] += source[i] * weight;
+                }
+            }
+
+            // Horizontal pass, destination texel i starts at source texel 2i of the tile
+            memset(filtered, 0, sizeof(float) * tile_width * p_format->channels);
+            for (uint32_t tap = 0; tap < p_kernel->count; ++tap) {
+                float weight = p_kernel->weights[tap];
+                for (uint32_t i = 0; i < tile_width; ++i) {
+                    const float *p_in = &blended[(i * 2 + tap) * p_format->channels];
+                    float       *p_out = &filtered[i * p_format->channels];
+                    for (uint32_t c = 0; c < p_format->channels; ++c) {
+                        p_out[c] += p_in[c] * weight;
+                    }
+                }
+            }
+
+            mip_store_row(p_format, filtered, tile_width, p_dst + x * texel_size);
+        }
+    }
+}
+
+static void mip_run(void *p_job) {
+    MipJob  *job = p_job;
+    uint64_t row;
+    while ((row = VRI_ATOMIC_ADD_U64(&job->next_row, MIP_BAND_ROWS)) < job->last_row) {
+        mip_generate_rows(job->p_desc, job->p_format, job->p_kernel, (uint32_t)row, VRI_MIN((uint32_t)row + MIP_BAND_ROWS, job->last_row));
+    }
+}
+
+static VriBool mip_format_init(VriFormat format, MipFormat *p_format) {
+    const VriFormatInfo *info = VRI_FORMAT_INFO(format);
+    switch (format) {
+        case VRI_FORMAT_R8_UNORM:
+        case VRI_FORMAT_R8G8_UNORM:
+        case VRI_FORMAT_R8G8B8A8_UNORM:
+        case VRI_FORMAT_R8G8B8A8_SRGB:
+        case VRI_FORMAT_B8G8R8A8_UNORM:
+        case VRI_FORMAT_B8G8R8A8_SRGB:
+            p_format->channels = info->block_size;
+            p_format->is_float = VRI_FALSE;
+            break;
+        case VRI_FORMAT_R32_FLOAT:
+        case VRI_FORMAT_R32G32_FLOAT:
+        case VRI_FORMAT_R32G32B32_FLOAT:
+        case VRI_FORMAT_R32G32B32A32_FLOAT:
+            p_format->channels = info->block_size / sizeof(float);
+            p_format->is_float = VRI_TRUE;
+            break;
+        default:
+            return VRI_FALSE;
+    }
+
+    p_format->srgb = info->srgb;
+    if (p_format->is_float) return VRI_TRUE;
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        p_format->unorm_to_linear[i] = (float)i / 255.0f;
+    }
+    for (uint32_t c = 0; c < MIP_MAX_CHANNELS; ++c) {
+        // Alpha stays linear in sRGB formats
+        p_format->p_to_linear[c] = p_format->srgb && c < 3 ? mip_srgb_to_linear : p_format->unorm_to_linear;
+    }
+
+    return VRI_TRUE;
+}
+
+// Weights are symmetric around the destination texel's center, which sits
+// between source texels 2x and 2x + 1
+static void mip_kernel_init(VriMipFilter filter, MipKernel *p_kernel) {
+    if (filter == VRI_MIP_FILTER_BOX) {
+        p_kernel->first = 0;
+        p_kernel->count = 2;
+        p_kernel->weights[0] = 0.5f;
+        p_kernel->weights[1] = 0.5f;
+        return;
+    }
+
+    // A sinc cut off at half the source rate, windowed to the three source texels on either side
+    p_kernel->first = -2;
+    p_kernel->count = MIP_MAX_TAPS;
+
+    const float pi = 3.14159265358979f;
+    float       radius = (float)MIP_MAX_TAPS / 2.0f;
+    float       sum = 0.0f;
+    for (uint32_t tap = 0; tap < MIP_MAX_TAPS; ++tap) {
+        float distance = (float)tap - 2.5f;
+        float sinc = sinf(pi * distance / 2.0f) / (pi * distance / 2.0f);
+        float ratio = distance / radius;
+        float window = mip_bessel_i0(MIP_KAISER_ALPHA * sqrtf(1.0f - ratio * ratio)) / mip_bessel_i0(MIP_KAISER_ALPHA);
+
+        p_kernel->weights[tap] = sinc * window;
+        sum += p_kernel->weights[tap];
+    }
+    for (uint32_t tap = 0; tap < MIP_MAX_TAPS; ++tap) {
+        p_kernel->weights[tap] /= sum;
+    }
+}
+
+static float mip_bessel_i0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (uint32_t k = 1; k < 16; ++k) {
+        term *= (x / (2.0f * (float)k)) * (x / (2.0f * (float)k));
+        sum += term;
+    }
+    return sum;
+}
+
+static void mip_load_row(const MipFormat *p_format, const uint8_t *p_src, int32_t first_texel, uint32_t texel_count, uint32_t width, float *p_row) {
+    uint32_t channels = p_format->channels;
+
+    for (uint32_t i = 0; i < texel_count; ++i) {
+        int32_t  x = first_texel + (int32_t)i;
+        uint32_t clamped_x = (uint32_t)VRI_MIN(VRI_MAX(x, 0), (int32_t)width - 1);
+
+        if (p_format->is_float) {
+            memcpy(&p_row[i * channels], p_src + (size_t)clamped_x * channels * sizeof(float), channels * sizeof(float));
+            continue;
+        }
+
+        const uint8_t *p_texel = p_src + (size_t)clamped_x * channels;
+        for (uint32_t c = 0; c < channels; ++c) {
+            p_row[i * channels + c] = p_format->p_to_linear[c][p_texel[c]];
+        }
+    }
+}
+
+static void mip_store_row(const MipFormat *p_format, const float *p_row, uint32_t texel_count, uint8_t *p_dst) {
+    uint32_t value_count = texel_count * p_format->channels;
+
+    if (p_format->is_float) {
+        memcpy(p_dst, p_row, value_count * sizeof(float));
+        return;
+    }
+
+    for (uint32_t i = 0; i < value_count; ++i) {
+        float value = VRI_MIN(VRI_MAX(p_row[i], 0.0f), 1.0f);
+
+        if (p_format->srgb && i % 4 < 3) {
+            // Branch-free binary search for the first threshold above the value
+            uint32_t code = 0;
+            for (uint32_t step = 128; step; step >>= 1) {
+                code += (code + step - 1 < 255 && mip_srgb_thresholds[code + step - 1] <= value) ? step : 0;
+            }
+            p_dst[i] = (uint8_t)code;
+        } else {
+            p_dst[i] = (uint8_t)(value * 255.0f + 0.5f);
+        }
+    }
+}
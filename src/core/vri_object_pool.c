@@ -0,0 +1,171 @@
+#include "vri_internal.h"
+
+#include <string.h>
+
+// Objects of one type are carved out of slabs owned by the device, so
+// creating and destroying them is a freelist push or pop instead of a trip
+// through the application's allocator, and objects of a type sit next to each
+// other in memory. Slabs are only given back when the device is destroyed, so
+// they're allocated in VRI_ALLOCATION_SCOPE_DEVICE whatever the type.
+
+#define POOL_SLAB_TARGET_SIZE (16u * 1024u)
+#define POOL_MIN_SLOTS        8u
+#define POOL_QUARANTINE_SLOTS 64u
+
+struct VriObjectSlab {
+    struct VriObjectSlab *p_next;
+    size_t                size;
+    uint32_t              slot_count;
+};
+
+#define POOL_ALIGN(size, alignment) (((size) + (alignment) - 1) & ~(size_t)((alignment) - 1))
+
+// A free slot keeps its base, marked destroyed with its generation bumped, and
+// links to the next free slot through the first pointer after it
+#define POOL_FREE_LINK(slot) (*(void **)((uint8_t *)(slot) + sizeof(VriObjectBase)))
+
+static VriBool pool_grow(VriObjectPool *pool, const VriAllocationCallback *alloc);
+
+// Slots start after the header, rounded up so every slot stays aligned
+static size_t slab_header_size(const VriObjectPool *pool) {
+    return POOL_ALIGN(sizeof(VriObjectSlab), pool->alignment);
+}
+
+static uint8_t *slab_slots(const VriObjectPool *pool, VriObjectSlab *slab) {
+    return (uint8_t *)slab + slab_header_size(pool);
+}
+
+void *vri_object_pool_allocate(VriObjectPool *pool, const VriAllocationCallback *alloc, size_t size, size_t alignment) {
+    vri_spinlock_lock(&pool->lock);
+
+    // The first allocation decides the slot layout, every backend allocates a type at one size
+    if (!pool->slot_size) {
+        size_t minimum = sizeof(VriObjectBase) + sizeof(void *);
+        pool->slot_size = POOL_ALIGN(VRI_MAX(size, minimum), alignment);
+        pool->alignment = alignment;
+        pool->allocator = *alloc;
+#if VRI_ENABLE_OBJECT_TRACKING
+        pool->quarantine = POOL_QUARANTINE_SLOTS;
+#endif
+    }
+
+    // Quarantined slots are only reused when the allocator can't give a new slab
+    void *slot = NULL;
+    if (size <= pool->slot_size && (pool->free_count > pool->quarantine || pool_grow(pool, alloc) || pool->free_count)) {
+        slot = pool->p_free;
+        pool->p_free = POOL_FREE_LINK(slot);
+        if (!pool->p_free) pool->p_free_tail = NULL;
+        pool->free_count--;
+        pool->live_count++;
+    }
+
+    vri_spinlock_unlock(&pool->lock);
+    return slot;
+}
+
+void vri_object_pool_free(VriObjectPool *pool, void *object) {
+    VriObjectBase *base = object;
+
+    // Stale handles to the slot now fail every type check
+    base->type = VRI_OBJECT_TYPE_DESTROYED;
+    base->p_device = NULL;
+    base->generation++;
+
+    // Without a quarantine the slot that was just freed, still in cache, is reused first
+    vri_spinlock_lock(&pool->lock);
+    if (pool->quarantine) {
+        POOL_FREE_LINK(object) = NULL;
+        if (pool->p_free_tail) {
+            POOL_FREE_LINK(pool->p_free_tail) = object;
+        } else {
+            pool->p_free = object;
+        }
+        pool->p_free_tail = object;
+    } else {
+        POOL_FREE_LINK(object) = pool->p_free;
+        if (!pool->p_free) pool->p_free_tail = object;
+        pool->p_free = object;
+    }
+    pool->free_count++;
+    pool->live_count--;
+    vri_spinlock_unlock(&pool->lock);
+}
+
+VriBool vri_object_pool_owns(const VriObjectPool *pool, size_t size) {
+    return pool->slot_size && size <= pool->slot_size;
+}
+
+size_t vri_object_pool_reserved_bytes(VriObjectPool *pool) {
+    vri_spinlock_lock(&pool->lock);
+    size_t bytes = pool->reserved_bytes;
+    vri_spinlock_unlock(&pool->lock);
+    return bytes;
+}
+
+void vri_object_pool_for_each(VriObjectPool *pool, PFN_VriObjectVisit pfn_visit, void *p_user_data) {
+    vri_spinlock_lock(&pool->lock);
+    for (VriObjectSlab *slab = pool->p_slabs; slab; slab = slab->p_next) {
+        uint8_t *slots = slab_slots(pool, slab);
+        for (uint32_t i = 0; i < slab->slot_count; ++i) {
+            VriObjectBase *base = (VriObjectBase *)(slots + i * pool->slot_size);
+            if (base->type != VRI_OBJECT_TYPE_DESTROYED) {
+                pfn_visit(p_user_data, base);
+            }
+        }
+    }
+    vri_spinlock_unlock(&pool->lock);
+}
+
+void vri_object_pools_quarantine(VriDevice device) {
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        vri_spinlock_lock(&device->object_pools[i].lock);
+        device->object_pools[i].quarantine = POOL_QUARANTINE_SLOTS;
+        vri_spinlock_unlock(&device->object_pools[i].lock);
+    }
+}
+
+void vri_object_pool_destroy(VriObjectPool *pool) {
+    VriObjectSlab *slab = pool->p_slabs;
+    while (slab) {
+        VriObjectSlab *p_next = slab->p_next;
+        pool->allocator.pfn_free(slab, slab->size, pool->alignment, VRI_ALLOCATION_SCOPE_DEVICE);
+        slab = p_next;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+}
+
+void vri_object_pools_destroy(VriDevice device) {
+    for (uint32_t i = 0; i < VRI_OBJECT_TYPE_COUNT; ++i) {
+        vri_object_pool_destroy(&device->object_pools[i]);
+    }
+}
+
+static VriBool pool_grow(VriObjectPool *pool, const VriAllocationCallback *alloc) {
+    uint32_t slot_count = (uint32_t)VRI_MAX(POOL_SLAB_TARGET_SIZE / pool->slot_size, POOL_MIN_SLOTS);
+    size_t   size = slab_header_size(pool) + pool->slot_size * slot_count;
+
+    VriObjectSlab *slab = alloc->pfn_allocate(size, pool->alignment, VRI_ALLOCATION_SCOPE_DEVICE);
+    if (!slab) return VRI_FALSE;
+
+    slab->p_next = pool->p_slabs;
+    slab->size = size;
+    slab->slot_count = slot_count;
+    pool->p_slabs = slab;
+    pool->reserved_bytes += size;
+
+    // Thread the new slots onto the front of the freelist back to front, so
+    // they're handed out in address order and ahead of quarantined slots
+    uint8_t *slots = slab_slots(pool, slab);
+    for (uint32_t i = slot_count; i-- > 0;) {
+        VriObjectBase *base = (VriObjectBase *)(slots + i * pool->slot_size);
+        base->type = VRI_OBJECT_TYPE_DESTROYED;
+        base->generation = 0;
+        POOL_FREE_LINK(base) = pool->p_free;
+        if (!pool->p_free) pool->p_free_tail = base;
+        pool->p_free = base;
+    }
+    pool->free_count += slot_count;
+
+    return VRI_TRUE;
+}
@@ -0,0 +1,701 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+#include "vri_serialize.h"
+
+#include <string.h>
+
+// Pipeline manifests and warm-up. While a manifest records, every pipeline
+// create hashes its desc and the first create of each hash appends the
+// serialized desc to the manifest, shader bytecode and strings stored once as
+// blobs. Stages using a shader module are recorded with the module's bytecode,
+// handles aren't recorded at all, so a manifest holds everything needed to
+// create its pipelines on a later run. Warm-up decodes the descs on a few
+// threads, creates the pipelines and keeps them by hash until a create with the
+// same desc takes them.
+//
+// Data layout, all words little-endian:
+//   u32 magic, u32 version, u32 blob count, u32 pipeline count
+//   per blob:     u32 size, the bytes padded to 4
+//   per pipeline: u64 desc hash, u32 kind, u32 size, the serialized desc
+
+#define MANIFEST_MAGIC          0x4D505256u // "VRPM"
+#define MANIFEST_VERSION        1u
+#define MANIFEST_HEADER_SIZE    16u
+#define MANIFEST_MAX_SHADERS    6u // One per graphics stage
+#define MANIFEST_INITIAL_SLOTS  64u
+#define WARM_UP_SCRATCH_SIZE    (16u * 1024u)
+
+typedef enum {
+    MANIFEST_KIND_GRAPHICS = 0,
+    MANIFEST_KIND_COMPUTE = 1,
+} ManifestKind;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t offset; // Of the bytes in the blob writer, after their size
+    uint32_t size;
+} ManifestBlob;
+
+struct VriPipelineManifest_T {
+    VriObjectBase base;
+    VriWriter     blobs;
+    VriWriter     records;
+    ManifestBlob *p_blobs; // Indexed by id - 1
+    uint32_t      blob_count;
+    uint32_t      blob_capacity;
+    uint32_t     *p_blob_slots; // Open addressed blob ids, 0 for empty
+    uint32_t      blob_slot_count;
+    uint64_t     *p_pipeline_slots; // Open addressed desc hashes, 0 for empty
+    uint32_t      pipeline_slot_count;
+    uint32_t      pipeline_count;
+};
+
+typedef struct {
+    const void *p_data;
+    size_t      size;
+} WarmUpBlob;
+
+typedef struct {
+    uint64_t     hash;
+    ManifestKind kind;
+    uint32_t     size;
+    const void  *p_data;
+} WarmUpEntry;
+
+typedef struct {
+    VriDevice                    device;
+    const VriPipelineWarmUpDesc *p_desc;
+    const WarmUpBlob            *p_blobs;
+    uint32_t                     blob_count;
+    const WarmUpEntry           *p_entries;
+    uint32_t                     entry_count;
+    uint64_t                     next_entry;   // Atomic
+    uint64_t                     failed_count; // Atomic
+    uint64_t                     done_count;   // Atomic
+    VriSpinlock                  reporter;     // Held by the thread calling pfn_progress
+    uint64_t                     reported_count;
+} WarmUpJob;
+
+static VriBool     manifest_resolve_shaders(const VriShaderModuleDesc *p_shaders, uint32_t shader_count, VriShaderModuleDesc *p_resolved);
+static uint64_t    manifest_hash(VriDevice device, ManifestKind kind, const void *p_desc);
+static uint32_t    manifest_hash_blob(void *p_user_data, const void *p_data, size_t size);
+static void        manifest_write_desc(VriWriter *writer, ManifestKind kind, const void *p_desc);
+static void        manifest_record(VriDevice device, uint64_t hash, ManifestKind kind, const void *p_desc);
+static uint32_t    manifest_intern_blob(void *p_user_data, const void *p_data, size_t size);
+static VriBool     manifest_grow_pipeline_slots(VriPipelineManifest manifest, const VriAllocationCallback *alloc);
+static VriBool     manifest_grow_blob_slots(VriPipelineManifest manifest, const VriAllocationCallback *alloc);
+static void        manifest_update_active(VriPipelineManifestState *state);
+static VriResult   warm_up_parse(const VriPipelineWarmUpDesc *p_desc, WarmUpBlob *p_blobs, uint32_t blob_count, WarmUpEntry *p_entries, uint32_t entry_count);
+static void        warm_up_run(void *p_job);
+static void        warm_up_report(WarmUpJob *job);
+static VriBool     warm_up_entry(WarmUpJob *job, const WarmUpEntry *entry, void *p_scratch);
+static const void *warm_up_resolve_blob(void *p_user_data, uint32_t id, size_t *p_size);
+static void        warm_up_insert(VriDevice device, uint64_t hash, VriPipeline pipeline);
+
+VriResult vri_pipeline_manifest_create(VriDevice device, VriPipelineManifest *p_manifest) {
+    VriDebugCallback          dbg = device->debug_callback;
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+
+    VriPipelineManifest manifest = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriPipelineManifest_T), VRI_OBJECT_TYPE_PIPELINE_MANIFEST);
+    if (!manifest) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Pipeline Manifest struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    manifest->base.p_create_site = VRI_RETURN_ADDRESS();
+#endif
+    VriWriterCallbacks blob_callbacks = {.pfn_intern_blob = manifest_intern_blob, .p_user_data = manifest};
+    vri_writer_init(&manifest->blobs, &device->allocation_callback, VRI_ALLOCATION_SCOPE_OBJECT, NULL);
+    vri_writer_init(&manifest->records, &device->allocation_callback, VRI_ALLOCATION_SCOPE_OBJECT, &blob_callbacks);
+
+    vri_spinlock_lock(&state->lock);
+    VriBool busy = state->recording != NULL;
+    if (!busy) {
+        state->recording = manifest;
+        manifest_update_active(state);
+    }
+    vri_spinlock_unlock(&state->lock);
+
+    if (busy) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Another pipeline manifest is already recording");
+        vri_object_free(device, &device->allocation_callback, manifest, sizeof(struct VriPipelineManifest_T));
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    *p_manifest = manifest;
+    return VRI_SUCCESS;
+}
+
+void vri_pipeline_manifest_destroy(VriDevice device, VriPipelineManifest manifest) {
+    if (!manifest) return;
+
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+    VriAllocationCallback    *alloc = &device->allocation_callback;
+
+    vri_spinlock_lock(&state->lock);
+    if (state->recording == manifest) {
+        state->recording = NULL;
+        manifest_update_active(state);
+    }
+    vri_spinlock_unlock(&state->lock);
+
+    vri_writer_destroy(&manifest->blobs);
+    vri_writer_destroy(&manifest->records);
+    if (manifest->p_blobs) {
+        alloc->pfn_free(manifest->p_blobs, sizeof(ManifestBlob) * manifest->blob_capacity, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    if (manifest->p_blob_slots) {
+        alloc->pfn_free(manifest->p_blob_slots, sizeof(uint32_t) * manifest->blob_slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    if (manifest->p_pipeline_slots) {
+        alloc->pfn_free(manifest->p_pipeline_slots, sizeof(uint64_t) * manifest->pipeline_slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    vri_object_free(device, alloc, manifest, sizeof(struct VriPipelineManifest_T));
+}
+
+VriResult vri_pipeline_manifest_get_data(VriPipelineManifest manifest, size_t *p_size, void *p_data) {
+    VriPipelineManifestState *state = &manifest->base.p_device->pipeline_manifest;
+
+    // Recording appends under the same lock
+    vri_spinlock_lock(&state->lock);
+    size_t   size = MANIFEST_HEADER_SIZE + manifest->blobs.size + manifest->records.size;
+    uint32_t header[4] = {MANIFEST_MAGIC, MANIFEST_VERSION, manifest->blob_count, manifest->pipeline_count};
+
+    VriResult result = VRI_SUCCESS;
+    if (p_data) {
+        if (*p_size >= size) {
+            uint8_t *p_out = p_data;
+            memcpy(p_out, header, MANIFEST_HEADER_SIZE);
+            if (manifest->blobs.size) memcpy(p_out + MANIFEST_HEADER_SIZE, manifest->blobs.p_data, manifest->blobs.size);
+            if (manifest->records.size) memcpy(p_out + MANIFEST_HEADER_SIZE + manifest->blobs.size, manifest->records.p_data, manifest->records.size);
+        } else {
+            // A partial manifest is useless, nothing is written
+            result = VRI_INCOMPLETE;
+        }
+    }
+    vri_spinlock_unlock(&state->lock);
+
+    if (!p_data || VRI_OK(result)) *p_size = size;
+    return result;
+}
+
+VriResult vri_pipelines_warm_up(VriDevice device, const VriPipelineWarmUpDesc *p_desc) {
+    VriDebugCallback          dbg = device->debug_callback;
+    VriAllocationCallback    *alloc = &device->allocation_callback;
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+
+    uint32_t header[4] = {0};
+    if (p_desc->p_data && p_desc->size >= MANIFEST_HEADER_SIZE) memcpy(header, p_desc->p_data, MANIFEST_HEADER_SIZE);
+    if (header[0] != MANIFEST_MAGIC || header[1] != MANIFEST_VERSION) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Pipeline warm-up data isn't a pipeline manifest of this version");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    uint32_t blob_count = header[2];
+    uint32_t entry_count = header[3];
+    if (!entry_count) return VRI_SUCCESS;
+
+    // Every blob and entry takes at least 4 and 16 bytes, which bounds the counts before anything is allocated
+    if ((uint64_t)blob_count * 4 + (uint64_t)entry_count * 16 > p_desc->size - MANIFEST_HEADER_SIZE) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Pipeline manifest data is truncated");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    uint32_t warm_capacity = MANIFEST_INITIAL_SLOTS;
+    while (warm_capacity < entry_count * 2) {
+        warm_capacity *= 2;
+    }
+
+    size_t blobs_size = sizeof(WarmUpBlob) * (blob_count ? blob_count : 1);
+    size_t entries_size = sizeof(WarmUpEntry) * entry_count;
+    size_t warm_size = sizeof(VriWarmPipeline) * warm_capacity;
+
+    WarmUpBlob      *p_blobs = alloc->pfn_allocate(blobs_size, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+    WarmUpEntry     *p_entries = alloc->pfn_allocate(entries_size, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+    VriWarmPipeline *p_warm = alloc->pfn_allocate(warm_size, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    VriResult        result = p_blobs && p_entries && p_warm ? VRI_SUCCESS : VRI_ERROR_OUT_OF_MEMORY;
+    if (VRI_ERROR(result)) dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate the pipeline warm-up tables");
+
+    if (VRI_OK(result)) {
+        result = warm_up_parse(p_desc, p_blobs, blob_count, p_entries, entry_count);
+        if (VRI_ERROR(result)) dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Pipeline manifest data is malformed");
+    }
+
+    // Warm pipelines nobody took yet would be lost with their table
+    VriWarmPipeline *p_old = NULL;
+    uint32_t         old_capacity = 0;
+    if (VRI_OK(result)) {
+        memset(p_warm, 0, warm_size);
+
+        vri_spinlock_lock(&state->lock);
+        if (state->warm_count) {
+            result = VRI_ERROR_INVALID_API_USAGE;
+        } else {
+            p_old = state->p_warm;
+            old_capacity = state->warm_capacity;
+            state->p_warm = p_warm;
+            state->warm_capacity = warm_capacity;
+            p_warm = NULL;
+        }
+        vri_spinlock_unlock(&state->lock);
+
+        if (VRI_ERROR(result)) dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Pipelines of an earlier warm-up are still warm, vri_pipelines_warm_release them first");
+    }
+
+    if (p_old) alloc->pfn_free(p_old, sizeof(VriWarmPipeline) * old_capacity, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    if (p_warm) alloc->pfn_free(p_warm, warm_size, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+
+    if (VRI_OK(result)) {
+        WarmUpJob job = {
+            .device = device,
+            .p_desc = p_desc,
+            .p_blobs = p_blobs,
+            .blob_count = blob_count,
+            .p_entries = p_entries,
+            .entry_count = entry_count,
+        };
+
+        uint32_t thread_count = p_desc->thread_count ? p_desc->thread_count : vri_cpu_count();
+        vri_threads_run(VRI_MIN(thread_count, entry_count), warm_up_run, &job);
+
+        if (job.failed_count) result = VRI_INCOMPLETE;
+    }
+
+    if (p_blobs) alloc->pfn_free(p_blobs, blobs_size, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+    if (p_entries) alloc->pfn_free(p_entries, entries_size, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+    return result;
+}
+
+void vri_pipelines_warm_release(VriDevice device) {
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+
+    vri_spinlock_lock(&state->lock);
+    VriWarmPipeline *p_warm = state->p_warm;
+    uint32_t         warm_capacity = state->warm_capacity;
+    state->p_warm = NULL;
+    state->warm_capacity = 0;
+    state->warm_count = 0;
+    manifest_update_active(state);
+    vri_spinlock_unlock(&state->lock);
+
+    if (!p_warm) return;
+
+    for (uint32_t i = 0; i < warm_capacity; ++i) {
+        if (p_warm[i].pipeline) vri_pipeline_destroy(device, p_warm[i].pipeline);
+    }
+    device->allocation_callback.pfn_free(p_warm, sizeof(VriWarmPipeline) * warm_capacity, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+}
+
+uint64_t vri_pipeline_manifest_hash_graphics(VriDevice device, const VriGraphicsPipelineDesc *p_desc) {
+    VriShaderModuleDesc     shaders[MANIFEST_MAX_SHADERS];
+    VriGraphicsPipelineDesc desc;
+    if (p_desc->shader_count > MANIFEST_MAX_SHADERS || !manifest_resolve_shaders(p_desc->p_shaders, p_desc->shader_count, shaders)) return 0;
+
+    // pipeline_layout is const, so the desc is copied rather than assigned
+    memcpy(&desc, p_desc, sizeof(desc));
+    desc.p_shaders = shaders;
+    return manifest_hash(device, MANIFEST_KIND_GRAPHICS, &desc);
+}
+
+uint64_t vri_pipeline_manifest_hash_compute(VriDevice device, const VriComputePipelineDesc *p_desc) {
+    VriShaderModuleDesc    shader;
+    VriComputePipelineDesc desc = {.p_shader = p_desc->p_shader ? &shader : NULL};
+    if (p_desc->p_shader && !manifest_resolve_shaders(p_desc->p_shader, 1, &shader)) return 0;
+    return manifest_hash(device, MANIFEST_KIND_COMPUTE, &desc);
+}
+
+void vri_pipeline_manifest_record_graphics(VriDevice device, uint64_t hash, const VriGraphicsPipelineDesc *p_desc) {
+    VriShaderModuleDesc     shaders[MANIFEST_MAX_SHADERS];
+    VriGraphicsPipelineDesc desc;
+    if (!manifest_resolve_shaders(p_desc->p_shaders, p_desc->shader_count, shaders)) return;
+
+    memcpy(&desc, p_desc, sizeof(desc));
+    desc.p_shaders = shaders;
+    manifest_record(device, hash, MANIFEST_KIND_GRAPHICS, &desc);
+}
+
+void vri_pipeline_manifest_record_compute(VriDevice device, uint64_t hash, const VriComputePipelineDesc *p_desc) {
+    VriShaderModuleDesc    shader;
+    VriComputePipelineDesc desc = {.p_shader = p_desc->p_shader ? &shader : NULL};
+    if (p_desc->p_shader && !manifest_resolve_shaders(p_desc->p_shader, 1, &shader)) return;
+    manifest_record(device, hash, MANIFEST_KIND_COMPUTE, &desc);
+}
+
+VriBool vri_pipeline_warm_take(VriDevice device, uint64_t hash, VriPipeline *p_pipeline) {
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+    VriBool                   taken = VRI_FALSE;
+
+    vri_spinlock_lock(&state->lock);
+    uint32_t mask = state->warm_capacity - 1;
+    for (uint32_t i = 0; state->p_warm && i < state->warm_capacity; ++i) {
+        VriWarmPipeline *slot = &state->p_warm[(hash + i) & mask];
+        if (!slot->hash) break;
+        if (slot->hash != hash || !slot->pipeline) continue;
+
+        *p_pipeline = slot->pipeline;
+        slot->pipeline = VRI_NULL_HANDLE;
+        state->warm_count--;
+        manifest_update_active(state);
+        taken = VRI_TRUE;
+        break;
+    }
+    vri_spinlock_unlock(&state->lock);
+
+    if (taken) VRI_STAT_ADD(device, pipeline_warm_hits, 1);
+    return taken;
+}
+
+// Stages using a module take the module's bytecode and entry point, false when the desc can't be recorded
+static VriBool manifest_resolve_shaders(const VriShaderModuleDesc *p_shaders, uint32_t shader_count, VriShaderModuleDesc *p_resolved) {
+    if (shader_count > MANIFEST_MAX_SHADERS || (shader_count && !p_shaders)) return VRI_FALSE;
+
+    for (uint32_t i = 0; i < shader_count; ++i) {
+        p_resolved[i] = p_shaders[i];
+        if (p_shaders[i].module) {
+            p_resolved[i].p_bytecode = p_shaders[i].module->p_bytecode;
+            p_resolved[i].size = p_shaders[i].module->size;
+            p_resolved[i].p_entry_point = p_shaders[i].module->p_entry_point;
+            p_resolved[i].module = VRI_NULL_HANDLE;
+        }
+    }
+    return VRI_TRUE;
+}
+
+// The serialized desc with every blob folded in by content, so the hash is the same in every run
+static uint64_t manifest_hash(VriDevice device, ManifestKind kind, const void *p_desc) {
+    uint64_t           blob_hash = VRI_HASH_SEED;
+    VriWriterCallbacks callbacks = {.pfn_intern_blob = manifest_hash_blob, .p_user_data = &blob_hash};
+    VriWriter          writer;
+    vri_writer_init(&writer, &device->allocation_callback, VRI_ALLOCATION_SCOPE_TRANSIENT, &callbacks);
+    manifest_write_desc(&writer, kind, p_desc);
+
+    uint64_t hash = 0;
+    if (!writer.out_of_memory) {
+        uint32_t kind_word = kind;
+        hash = vri_hash_bytes(blob_hash, &kind_word, sizeof(kind_word));
+        hash = vri_hash_bytes(hash, writer.p_data, writer.size);
+        if (!hash) hash = 1;
+    }
+    vri_writer_destroy(&writer);
+    return hash;
+}
+
+static uint32_t manifest_hash_blob(void *p_user_data, const void *p_data, size_t size) {
+    uint64_t *p_hash = p_user_data;
+    uint64_t  size_word = size;
+    *p_hash = vri_hash_bytes(*p_hash, &size_word, sizeof(size_word));
+    *p_hash = vri_hash_bytes(*p_hash, p_data, size);
+    return 1;
+}
+
+static void manifest_write_desc(VriWriter *writer, ManifestKind kind, const void *p_desc) {
+    if (kind == MANIFEST_KIND_GRAPHICS) {
+        vri_write_graphics_pipeline_desc(writer, p_desc);
+    } else {
+        vri_write_compute_pipeline_desc(writer, p_desc);
+    }
+}
+
+static void manifest_record(VriDevice device, uint64_t hash, ManifestKind kind, const void *p_desc) {
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+
+    vri_spinlock_lock(&state->lock);
+    VriPipelineManifest manifest = state->recording;
+
+    // Keeping the pipeline slots at most half full leaves every probe an empty slot to stop at
+    uint64_t *p_slot = NULL;
+    if (manifest && (manifest->pipeline_count * 2 < manifest->pipeline_slot_count || manifest_grow_pipeline_slots(manifest, &device->allocation_callback))) {
+        uint32_t mask = manifest->pipeline_slot_count - 1;
+        for (uint32_t i = 0;; ++i) {
+            p_slot = &manifest->p_pipeline_slots[(hash + i) & mask];
+            if (!*p_slot) break;
+            if (*p_slot == hash) {
+                p_slot = NULL;
+                break;
+            }
+        }
+    }
+
+    if (p_slot) {
+        VriWriter *records = &manifest->records;
+        size_t     start = records->size;
+        vri_write_u64(records, hash);
+        vri_write_u32(records, kind);
+        vri_write_u32(records, 0);
+        manifest_write_desc(records, kind, p_desc);
+
+        // Blobs interned before running out of memory stay, unreferenced
+        if (!records->out_of_memory && !manifest->blobs.out_of_memory) {
+            uint32_t size = (uint32_t)(records->size - start - 16);
+            memcpy(records->p_data + start + 12, &size, sizeof(size));
+            *p_slot = hash;
+            manifest->pipeline_count++;
+        } else {
+            records->size = start;
+            records->out_of_memory = VRI_FALSE;
+            manifest->blobs.out_of_memory = VRI_FALSE;
+            device->debug_callback.pfn_message_callback(VRI_MESSAGE_SEVERITY_WARNING, "Failed to record a pipeline in the pipeline manifest");
+        }
+    }
+    vri_spinlock_unlock(&state->lock);
+}
+
+// Called with the state's lock held while a desc is recorded
+static uint32_t manifest_intern_blob(void *p_user_data, const void *p_data, size_t size) {
+    VriPipelineManifest    manifest = p_user_data;
+    VriAllocationCallback *alloc = &manifest->base.p_device->allocation_callback;
+    VriWriter             *blobs = &manifest->blobs;
+
+    if (size > UINT32_MAX || blobs->size + size > UINT32_MAX) {
+        blobs->out_of_memory = VRI_TRUE;
+        return 0;
+    }
+    if (manifest->blob_count * 2 >= manifest->blob_slot_count && !manifest_grow_blob_slots(manifest, alloc)) {
+        blobs->out_of_memory = VRI_TRUE;
+        return 0;
+    }
+
+    uint64_t  hash = vri_hash_bytes(VRI_HASH_SEED, p_data, size);
+    uint32_t  mask = manifest->blob_slot_count - 1;
+    uint32_t *p_slot = NULL;
+    for (uint32_t i = 0;; ++i) {
+        p_slot = &manifest->p_blob_slots[(hash + i) & mask];
+        if (!*p_slot) break;
+
+        const ManifestBlob *blob = &manifest->p_blobs[*p_slot - 1];
+        if (blob->hash == hash && blob->size == size && memcmp(blobs->p_data + blob->offset, p_data, size) == 0) return *p_slot;
+    }
+
+    if (manifest->blob_count == manifest->blob_capacity) {
+        uint32_t      capacity = manifest->blob_capacity ? manifest->blob_capacity * 2 : MANIFEST_INITIAL_SLOTS;
+        ManifestBlob *p_blobs = alloc->pfn_allocate(sizeof(ManifestBlob) * capacity, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        if (!p_blobs) {
+            blobs->out_of_memory = VRI_TRUE;
+            return 0;
+        }
+        if (manifest->p_blobs) {
+            memcpy(p_blobs, manifest->p_blobs, sizeof(ManifestBlob) * manifest->blob_count);
+            alloc->pfn_free(manifest->p_blobs, sizeof(ManifestBlob) * manifest->blob_capacity, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+        manifest->p_blobs = p_blobs;
+        manifest->blob_capacity = capacity;
+    }
+
+    static const uint8_t padding[3] = {0};
+    size_t               start = blobs->size;
+    vri_write_u32(blobs, (uint32_t)size);
+    size_t offset = blobs->size;
+    vri_write_bytes(blobs, p_data, size);
+    vri_write_bytes(blobs, padding, (4 - (size & 3)) & 3);
+    if (blobs->out_of_memory) {
+        blobs->size = start;
+        return 0;
+    }
+
+    ManifestBlob *blob = &manifest->p_blobs[manifest->blob_count++];
+    blob->hash = hash;
+    blob->offset = (uint32_t)offset;
+    blob->size = (uint32_t)size;
+    *p_slot = manifest->blob_count;
+    return manifest->blob_count;
+}
+
+static VriBool manifest_grow_pipeline_slots(VriPipelineManifest manifest, const VriAllocationCallback *alloc) {
+    uint32_t  slot_count = manifest->pipeline_slot_count ? manifest->pipeline_slot_count * 2 : MANIFEST_INITIAL_SLOTS;
+    uint64_t *p_slots = alloc->pfn_allocate(sizeof(uint64_t) * slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!p_slots) return VRI_FALSE;
+    memset(p_slots, 0, sizeof(uint64_t) * slot_count);
+
+    for (uint32_t i = 0; i < manifest->pipeline_slot_count; ++i) {
+        uint64_t hash = manifest->p_pipeline_slots[i];
+        if (!hash) continue;
+
+        uint32_t slot = (uint32_t)hash & (slot_count - 1);
+        while (p_slots[slot]) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        p_slots[slot] = hash;
+    }
+
+    if (manifest->p_pipeline_slots) {
+        alloc->pfn_free(manifest->p_pipeline_slots, sizeof(uint64_t) * manifest->pipeline_slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    manifest->p_pipeline_slots = p_slots;
+    manifest->pipeline_slot_count = slot_count;
+    return VRI_TRUE;
+}
+
+static VriBool manifest_grow_blob_slots(VriPipelineManifest manifest, const VriAllocationCallback *alloc) {
+    uint32_t  slot_count = manifest->blob_slot_count ? manifest->blob_slot_count * 2 : MANIFEST_INITIAL_SLOTS;
+    uint32_t *p_slots = alloc->pfn_allocate(sizeof(uint32_t) * slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!p_slots) return VRI_FALSE;
+    memset(p_slots, 0, sizeof(uint32_t) * slot_count);
+
+    for (uint32_t id = 1; id <= manifest->blob_count; ++id) {
+        uint32_t slot = (uint32_t)manifest->p_blobs[id - 1].hash & (slot_count - 1);
+        while (p_slots[slot]) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        p_slots[slot] = id;
+    }
+
+    if (manifest->p_blob_slots) {
+        alloc->pfn_free(manifest->p_blob_slots, sizeof(uint32_t) * manifest->blob_slot_count, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    manifest->p_blob_slots = p_slots;
+    manifest->blob_slot_count = slot_count;
+    return VRI_TRUE;
+}
+
+// Called with the state's lock held
+static void manifest_update_active(VriPipelineManifestState *state) {
+    VRI_ATOMIC_STORE_U64(&state->active, (state->recording ? 1u : 0u) + state->warm_count);
+}
+
+// Splits the data after the header into blobs and entries
+static VriResult warm_up_parse(const VriPipelineWarmUpDesc *p_desc, WarmUpBlob *p_blobs, uint32_t blob_count, WarmUpEntry *p_entries, uint32_t entry_count) {
+    VriReader reader;
+    vri_reader_init(&reader, p_desc->p_data, p_desc->size, NULL, 0, NULL);
+    vri_read_bytes(&reader, MANIFEST_HEADER_SIZE);
+
+    for (uint32_t i = 0; i < blob_count; ++i) {
+        uint32_t size = vri_read_u32(&reader);
+        p_blobs[i].size = size;
+        p_blobs[i].p_data = vri_read_bytes(&reader, size);
+        vri_read_bytes(&reader, (4 - (size & 3)) & 3);
+    }
+
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        p_entries[i].hash = vri_read_u64(&reader);
+        p_entries[i].kind = (ManifestKind)vri_read_u32(&reader);
+        p_entries[i].size = vri_read_u32(&reader);
+        p_entries[i].p_data = vri_read_bytes(&reader, p_entries[i].size);
+        if (!p_entries[i].hash || p_entries[i].kind > MANIFEST_KIND_COMPUTE) return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    return reader.overflow ? VRI_ERROR_INVALID_API_USAGE : VRI_SUCCESS;
+}
+
+// Workers claim entries one at a time, so slow pipelines don't hold up a whole share
+static void warm_up_run(void *p_job) {
+    WarmUpJob             *job = p_job;
+    VriAllocationCallback *alloc = &job->device->allocation_callback;
+    void                  *p_scratch = alloc->pfn_allocate(WARM_UP_SCRATCH_SIZE, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+
+    uint64_t index;
+    while ((index = VRI_ATOMIC_ADD_U64(&job->next_entry, 1)) < job->entry_count) {
+        if (!p_scratch || !warm_up_entry(job, &job->p_entries[index], p_scratch)) {
+            VRI_ATOMIC_ADD_U64(&job->failed_count, 1);
+        }
+
+        VRI_ATOMIC_ADD_U64(&job->done_count, 1);
+        if (job->p_desc->pfn_progress) warm_up_report(job);
+    }
+
+    if (p_scratch) alloc->pfn_free(p_scratch, WARM_UP_SCRATCH_SIZE, 8, VRI_ALLOCATION_SCOPE_TRANSIENT);
+}
+
+// Whichever worker gets the reporter calls pfn_progress, the others go back to
+// work instead of waiting for the callback. The reporter checks the count
+// again after letting go, so the last count is always reported.
+static void warm_up_report(WarmUpJob *job) {
+    while (vri_spinlock_try_lock(&job->reporter)) {
+        uint64_t done_count = VRI_ATOMIC_LOAD_U64(&job->done_count);
+        if (done_count > job->reported_count) {
+            job->reported_count = done_count;
+            job->p_desc->pfn_progress(job->p_desc->p_user_data, (uint32_t)done_count, job->entry_count);
+        }
+        vri_spinlock_unlock(&job->reporter);
+
+        if (VRI_ATOMIC_LOAD_U64(&job->done_count) == done_count) break;
+    }
+}
+
+// Stages get a shader module each, so stages shared between the manifest's pipelines compile once
+static VriBool warm_up_entry(WarmUpJob *job, const WarmUpEntry *entry, void *p_scratch) {
+    VriDevice          device = job->device;
+    VriReaderCallbacks callbacks = {.pfn_resolve_blob = warm_up_resolve_blob, .p_user_data = job};
+    VriReader          reader;
+    vri_reader_init(&reader, entry->p_data, entry->size, p_scratch, WARM_UP_SCRATCH_SIZE, &callbacks);
+
+    VriGraphicsPipelineDesc graphics_desc;
+    VriComputePipelineDesc  compute_desc;
+    VriShaderModuleDesc    *p_shaders = NULL;
+    uint32_t                shader_count = 0;
+    VriResult               result;
+    if (entry->kind == MANIFEST_KIND_GRAPHICS) {
+        result = vri_read_graphics_pipeline_desc(&reader, &graphics_desc);
+        p_shaders = graphics_desc.p_shaders;
+        shader_count = graphics_desc.shader_count;
+    } else {
+        result = vri_read_compute_pipeline_desc(&reader, &compute_desc);
+        p_shaders = compute_desc.p_shader;
+        shader_count = compute_desc.p_shader ? 1 : 0;
+    }
+    if (VRI_ERROR(result) || shader_count > MANIFEST_MAX_SHADERS) return VRI_FALSE;
+
+    VriShaderModule modules[MANIFEST_MAX_SHADERS] = {0};
+    for (uint32_t i = 0; VRI_OK(result) && i < shader_count; ++i) {
+        if (!p_shaders[i].p_bytecode) continue;
+
+        VriShaderModuleDesc module_desc = {
+            .stage = p_shaders[i].stage,
+            .size = p_shaders[i].size,
+            .p_bytecode = p_shaders[i].p_bytecode,
+            .p_entry_point = p_shaders[i].p_entry_point,
+        };
+        result = vri_shader_module_create(device, &module_desc, &modules[i]);
+        p_shaders[i].module = modules[i];
+    }
+
+    VriPipeline pipeline = VRI_NULL_HANDLE;
+    if (VRI_OK(result)) {
+        if (entry->kind == MANIFEST_KIND_GRAPHICS) {
+            result = vri_warm_pipeline_create_graphics(device, &graphics_desc, &pipeline);
+        } else {
+            result = vri_warm_pipeline_create_compute(device, &compute_desc, &pipeline);
+        }
+    }
+
+    // The pipeline holds on to what it needs of its modules
+    for (uint32_t i = 0; i < shader_count; ++i) {
+        if (modules[i]) vri_shader_module_destroy(device, modules[i]);
+    }
+
+    if (VRI_ERROR(result)) return VRI_FALSE;
+    warm_up_insert(device, entry->hash, pipeline);
+    return VRI_TRUE;
+}
+
+static const void *warm_up_resolve_blob(void *p_user_data, uint32_t id, size_t *p_size) {
+    const WarmUpJob *job = p_user_data;
+    if (id > job->blob_count) return NULL;
+
+    *p_size = job->p_blobs[id - 1].size;
+    return job->p_blobs[id - 1].p_data;
+}
+
+// A pipeline whose hash is still warm, or that finds no slot, is destroyed again
+static void warm_up_insert(VriDevice device, uint64_t hash, VriPipeline pipeline) {
+    VriPipelineManifestState *state = &device->pipeline_manifest;
+    VriBool                   inserted = VRI_FALSE;
+
+    vri_spinlock_lock(&state->lock);
+    uint32_t mask = state->warm_capacity - 1;
+    for (uint32_t i = 0; state->p_warm && i < state->warm_capacity; ++i) {
+        VriWarmPipeline *slot = &state->p_warm[(hash + i) & mask];
+        if (slot->hash && slot->hash != hash) continue;
+        if (slot->pipeline) break;
+
+        slot->hash = hash;
+        slot->pipeline = pipeline;
+        state->warm_count++;
+        manifest_update_active(state);
+        inserted = VRI_TRUE;
+        break;
+    }
+    vri_spinlock_unlock(&state->lock);
+
+    if (!inserted) vri_pipeline_destroy(device, pipeline);
+}
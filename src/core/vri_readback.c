@@ -0,0 +1,191 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+// Frame readback. Every slot is a READBACK texture with its own command
+// buffer, and every copy signals the next value of one fence. Slots are only
+// reused once the application unmapped them, which it can only do after the
+// copy finished, so neither copying nor mapping ever has to wait.
+
+VriResult vri_readback_ring_create(VriDevice device, const VriReadbackRingDesc *p_desc, VriReadbackRing *p_readback_ring) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    uint32_t slot_count = p_desc->slot_count ? p_desc->slot_count : VRI_READBACK_RING_DEFAULT_SLOT_COUNT;
+    if (!p_desc->queue || !p_desc->width || !p_desc->height || slot_count > VRI_READBACK_RING_MAX_SLOTS) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Readback ring needs a queue, a size and at most VRI_READBACK_RING_MAX_SLOTS slots");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    VriReadbackRing readback_ring = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriReadbackRing_T), VRI_OBJECT_TYPE_READBACK_RING);
+    if (!readback_ring) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Readback Ring struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    readback_ring->base.p_create_site = VRI_RETURN_ADDRESS();
+#endif
+    readback_ring->desc = *p_desc;
+    readback_ring->desc.slot_count = slot_count;
+    readback_ring->next_frame_id = 1;
+
+    VriCommandPoolDesc pool_desc = {
+        .queue_type = p_desc->queue->type,
+        .flags = VRI_COMMAND_POOL_FLAG_BIT_RESET_COMMAND_BUFFER,
+    };
+    VriResult result = vri_command_pool_create(device, &pool_desc, &readback_ring->command_pool);
+
+    VriCommandBuffer command_buffers[VRI_READBACK_RING_MAX_SLOTS] = {0};
+    if (VRI_OK(result)) {
+        VriCommandBufferAllocateDesc allocate_desc = {
+            .command_pool = readback_ring->command_pool,
+            .command_buffer_count = slot_count,
+        };
+        result = vri_command_buffers_allocate(device, &allocate_desc, command_buffers);
+    }
+
+    VriTextureDesc texture_desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = p_desc->format,
+        .width = p_desc->width,
+        .height = p_desc->height,
+        .depth = 1,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+        .memory_type = VRI_MEMORY_TYPE_READBACK,
+    };
+    for (uint32_t i = 0; VRI_OK(result) && i < slot_count; ++i) {
+        readback_ring->slots[i].command_buffer = command_buffers[i];
+        result = vri_texture_create(device, &texture_desc, &readback_ring->slots[i].texture);
+    }
+    if (VRI_OK(result)) {
+        result = vri_fence_create(device, 0, &readback_ring->fence);
+    }
+    if (VRI_ERROR(result)) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create the Readback Ring's textures, command buffers and fence");
+        vri_readback_ring_destroy(device, readback_ring);
+        return result;
+    }
+
+    *p_readback_ring = readback_ring;
+    return VRI_SUCCESS;
+}
+
+void vri_readback_ring_destroy(VriDevice device, VriReadbackRing readback_ring) {
+    if (!readback_ring) return;
+
+    if (readback_ring->fence) {
+        uint64_t value = readback_ring->fence_value;
+        vri_fences_wait(device, &readback_ring->fence, &value, 1, VRI_TRUE, UINT64_MAX);
+        vri_fence_destroy(device, readback_ring->fence);
+    }
+
+    for (uint32_t i = 0; i < readback_ring->desc.slot_count; ++i) {
+        VriReadbackSlot *slot = &readback_ring->slots[i];
+        if (slot->state == VRI_READBACK_SLOT_MAPPED) {
+            vri_texture_unmap(device, slot->texture, 0, 0);
+        }
+        if (slot->texture) {
+            vri_texture_destroy(device, slot->texture);
+        }
+        if (slot->command_buffer) {
+            vri_command_buffer_reset(slot->command_buffer);
+            vri_command_buffers_free(device, readback_ring->command_pool, 1, &slot->command_buffer);
+        }
+    }
+    if (readback_ring->command_pool) {
+        vri_command_pool_destroy(device, readback_ring->command_pool);
+    }
+
+    vri_object_free(device, &device->allocation_callback, readback_ring, sizeof(struct VriReadbackRing_T));
+}
+
+VriResult vri_readback_ring_copy(VriReadbackRing readback_ring, VriTexture texture, uint64_t *p_frame_id) {
+    VriReadbackSlot *slot = &readback_ring->slots[readback_ring->copy_slot];
+
+    // The frame the slot holds hasn't been read yet, this one is dropped rather than waited for
+    if (slot->state != VRI_READBACK_SLOT_FREE) {
+        return VRI_INCOMPLETE;
+    }
+
+    // A free slot's last copy is done, it was mapped after it
+    VriResult result = VRI_SUCCESS;
+    if (slot->fence_value) {
+        result = vri_command_buffer_reset(slot->command_buffer);
+        if (VRI_ERROR(result)) return result;
+    }
+
+    VriCommandBufferBeginDesc begin_desc = {.usage = VRI_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    result = vri_command_buffer_begin(slot->command_buffer, &begin_desc);
+    if (VRI_ERROR(result)) return result;
+
+    VriTextureCopyDesc copy = {
+        .width = readback_ring->desc.width,
+        .height = readback_ring->desc.height,
+        .depth = 1,
+    };
+    vri_cmd_copy_texture(slot->command_buffer, texture, slot->texture, &copy);
+
+    result = vri_command_buffer_end(slot->command_buffer);
+    if (VRI_ERROR(result)) return result;
+
+    VriFenceSignalDesc signal = {
+        .fence = readback_ring->fence,
+        .value = readback_ring->fence_value + 1,
+    };
+    VriQueueSubmitDesc submit = {
+        .p_command_buffers = &slot->command_buffer,
+        .command_buffer_count = 1,
+        .p_fences_signal = &signal,
+        .fence_signal_count = 1,
+    };
+    result = vri_queue_submit(readback_ring->desc.queue, &submit, 1);
+    if (VRI_ERROR(result)) return result;
+
+    readback_ring->fence_value = signal.value;
+    slot->fence_value = signal.value;
+    slot->frame_id = readback_ring->next_frame_id++;
+    slot->state = VRI_READBACK_SLOT_COPYING;
+    readback_ring->copy_slot = (readback_ring->copy_slot + 1) % readback_ring->desc.slot_count;
+
+    if (p_frame_id) *p_frame_id = slot->frame_id;
+    return VRI_SUCCESS;
+}
+
+VriResult vri_readback_ring_map(VriReadbackRing readback_ring, VriReadbackFrame *p_frame) {
+    VriDevice        device = readback_ring->base.p_device;
+    VriReadbackSlot *slot = &readback_ring->slots[readback_ring->map_slot];
+
+    if (slot->state != VRI_READBACK_SLOT_COPYING || vri_fence_get_value(device, readback_ring->fence) < slot->fence_value) {
+        return VRI_INCOMPLETE;
+    }
+
+    VriSubresourceData data;
+    VriResult          result = vri_texture_map(device, slot->texture, 0, 0, &data);
+    if (result == VRI_TIMEOUT) return VRI_INCOMPLETE;
+    if (VRI_ERROR(result)) return result;
+
+    slot->state = VRI_READBACK_SLOT_MAPPED;
+    readback_ring->map_slot = (readback_ring->map_slot + 1) % readback_ring->desc.slot_count;
+
+    *p_frame = (VriReadbackFrame){
+        .frame_id = slot->frame_id,
+        .width = readback_ring->desc.width,
+        .height = readback_ring->desc.height,
+        .format = readback_ring->desc.format,
+        .data = data,
+    };
+    return VRI_SUCCESS;
+}
+
+VriResult vri_readback_ring_unmap(VriReadbackRing readback_ring, uint64_t frame_id) {
+    for (uint32_t i = 0; i < readback_ring->desc.slot_count; ++i) {
+        VriReadbackSlot *slot = &readback_ring->slots[i];
+        if (slot->state == VRI_READBACK_SLOT_MAPPED && slot->frame_id == frame_id) {
+            vri_texture_unmap(readback_ring->base.p_device, slot->texture, 0, 0);
+            slot->state = VRI_READBACK_SLOT_FREE;
+            return VRI_SUCCESS;
+        }
+    }
+    return VRI_INCOMPLETE;
+}
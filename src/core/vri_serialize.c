@@ -0,0 +1,498 @@
+#include "vri_serialize.h"
+
+#include <string.h>
+
+#define WRITER_MIN_CAPACITY 256
+
+enum {
+    PIPELINE_STATE_BIT_INPUT_ASSEMBLY = 1 << 0,
+    PIPELINE_STATE_BIT_VERTEX_INPUT = 1 << 1,
+    PIPELINE_STATE_BIT_RASTERIZATION = 1 << 2,
+    PIPELINE_STATE_BIT_DEPTH_STENCIL = 1 << 3,
+    PIPELINE_STATE_BIT_COLOR_BLEND = 1 << 4,
+    PIPELINE_STATE_BIT_MULTISAMPLE = 1 << 5,
+};
+
+static VriBool writer_reserve(VriWriter *writer, size_t size);
+static void    write_shader(VriWriter *writer, const VriShaderModuleDesc *p_shader);
+static VriBool read_shader(VriReader *reader, VriShaderModuleDesc *p_shader);
+static void    write_stencil_op(VriWriter *writer, const VriStencilOpDesc *p_op);
+static void    read_stencil_op(VriReader *reader, VriStencilOpDesc *p_op);
+
+void vri_writer_init(VriWriter *writer, const VriAllocationCallback *p_allocator, VriAllocationScope scope, const VriWriterCallbacks *p_callbacks) {
+    memset(writer, 0, sizeof(*writer));
+    writer->p_allocator = p_allocator;
+    writer->scope = scope;
+    if (p_callbacks) {
+        writer->callbacks = *p_callbacks;
+    }
+}
+
+void vri_writer_reset(VriWriter *writer) {
+    writer->size = 0;
+    writer->out_of_memory = VRI_FALSE;
+}
+
+void vri_writer_destroy(VriWriter *writer) {
+    if (writer->p_data) {
+        writer->p_allocator->pfn_free(writer->p_data, writer->capacity, 8, writer->scope);
+    }
+    memset(writer, 0, sizeof(*writer));
+}
+
+void vri_write_bytes(VriWriter *writer, const void *p_data, size_t size) {
+    if (!writer_reserve(writer, size)) return;
+    memcpy(writer->p_data + writer->size, p_data, size);
+    writer->size += size;
+}
+
+void vri_write_u32(VriWriter *writer, uint32_t value) {
+    vri_write_bytes(writer, &value, sizeof(value));
+}
+
+void vri_write_u64(VriWriter *writer, uint64_t value) {
+    vri_write_bytes(writer, &value, sizeof(value));
+}
+
+void vri_write_f32(VriWriter *writer, float value) {
+    vri_write_bytes(writer, &value, sizeof(value));
+}
+
+// Blob id 0 is reserved for "no data"
+void vri_write_blob(VriWriter *writer, const void *p_data, size_t size) {
+    uint32_t id = 0;
+    if (p_data && size && writer->callbacks.pfn_intern_blob) {
+        id = writer->callbacks.pfn_intern_blob(writer->callbacks.p_user_data, p_data, size);
+    }
+    vri_write_u32(writer, id);
+}
+
+// Strings are interned with their terminator, so readers can hand them out in place
+void vri_write_string(VriWriter *writer, const char *p_string) {
+    vri_write_blob(writer, p_string, p_string ? strlen(p_string) + 1 : 0);
+}
+
+void vri_write_handle(VriWriter *writer, const void *p_handle) {
+    uint32_t id = 0;
+    if (p_handle && writer->callbacks.pfn_intern_handle) {
+        id = writer->callbacks.pfn_intern_handle(writer->callbacks.p_user_data, p_handle);
+    }
+    vri_write_u32(writer, id);
+}
+
+void vri_write_graphics_pipeline_desc(VriWriter *writer, const VriGraphicsPipelineDesc *p_desc) {
+    uint32_t present = (p_desc->p_input_assembly_state ? PIPELINE_STATE_BIT_INPUT_ASSEMBLY : 0) |
+                       (p_desc->p_vertex_input ? PIPELINE_STATE_BIT_VERTEX_INPUT : 0) |
+                       (p_desc->p_rasterization_state ? PIPELINE_STATE_BIT_RASTERIZATION : 0) |
+                       (p_desc->p_depth_stencil_state ? PIPELINE_STATE_BIT_DEPTH_STENCIL : 0) |
+                       (p_desc->p_color_blend_state ? PIPELINE_STATE_BIT_COLOR_BLEND : 0) |
+                       (p_desc->p_multisample_state ? PIPELINE_STATE_BIT_MULTISAMPLE : 0);
+
+    vri_write_handle(writer, (const void *)(uintptr_t)p_desc->pipeline_layout);
+    vri_write_u32(writer, present);
+    vri_write_u32(writer, p_desc->dynamic_states);
+
+    vri_write_u32(writer, p_desc->shader_count);
+    for (uint32_t i = 0; i < p_desc->shader_count; ++i) {
+        write_shader(writer, &p_desc->p_shaders[i]);
+    }
+
+    if (p_desc->p_input_assembly_state) {
+        vri_write_u32(writer, p_desc->p_input_assembly_state->topology);
+    }
+
+    if (p_desc->p_vertex_input) {
+        const VriVertexInputDesc *vi = p_desc->p_vertex_input;
+        vri_write_u32(writer, vi->binding_count);
+        vri_write_u32(writer, vi->attribute_count);
+
+        for (uint32_t i = 0; i < vi->binding_count; ++i) {
+            vri_write_u32(writer, vi->p_bindings[i].binding_slot);
+            vri_write_u32(writer, vi->p_bindings[i].stride);
+            vri_write_u32(writer, vi->p_bindings[i].input_rate);
+        }
+
+        for (uint32_t i = 0; i < vi->attribute_count; ++i) {
+            const VriVertexAttributeDesc *attr = &vi->p_attributes[i];
+            vri_write_string(writer, attr->d3d.semantic_name);
+            vri_write_u32(writer, attr->d3d.semantic_index);
+            vri_write_u32(writer, attr->vk.location);
+            vri_write_u32(writer, attr->binding);
+            vri_write_u32(writer, attr->format);
+            vri_write_u32(writer, attr->offset);
+        }
+    }
+
+    if (p_desc->p_rasterization_state) {
+        const VriRasterizationStateDesc *rs = p_desc->p_rasterization_state;
+        vri_write_u32(writer, rs->fill_mode);
+        vri_write_u32(writer, rs->cull_mode);
+        vri_write_u32(writer, rs->front_face);
+        vri_write_u32(writer, rs->depth_clamp_enable);
+        vri_write_u32(writer, rs->depth_bias_enable);
+        vri_write_f32(writer, rs->depth_bias_constant_factor);
+        vri_write_f32(writer, rs->depth_bias_clamp);
+        vri_write_f32(writer, rs->depth_bias_slope_factor);
+    }
+
+    if (p_desc->p_depth_stencil_state) {
+        const VriDepthStencilStateDesc *ds = p_desc->p_depth_stencil_state;
+        vri_write_u32(writer, ds->depth_test_enable);
+        vri_write_u32(writer, ds->depth_write_enable);
+        vri_write_u32(writer, ds->depth_compare_op);
+        vri_write_u32(writer, ds->stencil_test_enable);
+        vri_write_u32(writer, ds->stencil_read_mask);
+        vri_write_u32(writer, ds->stencil_write_mask);
+        write_stencil_op(writer, &ds->front);
+        write_stencil_op(writer, &ds->back);
+        vri_write_u32(writer, ds->stencil_reference);
+    }
+
+    if (p_desc->p_color_blend_state) {
+        const VriColorBlendStateDesc *cb = p_desc->p_color_blend_state;
+        uint32_t                      count = VRI_MIN(cb->render_target_count, (uint32_t)VRI_ARRAY_SIZE(cb->render_targets));
+
+        vri_write_u32(writer, count);
+        vri_write_u32(writer, cb->independent_blend_enable);
+        vri_write_u32(writer, cb->alpha_to_coverage_enable);
+        for (uint32_t i = 0; i < 4; ++i) {
+            vri_write_f32(writer, cb->blend_constants[i]);
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const VriColorBlendAttachmentDesc *rt = &cb->render_targets[i];
+            vri_write_u32(writer, rt->blend_enable);
+            vri_write_u32(writer, rt->src_color_blend_factor);
+            vri_write_u32(writer, rt->dst_color_blend_factor);
+            vri_write_u32(writer, rt->color_blend_op);
+            vri_write_u32(writer, rt->src_alpha_blend_factor);
+            vri_write_u32(writer, rt->dst_alpha_blend_factor);
+            vri_write_u32(writer, rt->alpha_blend_op);
+            vri_write_u32(writer, rt->color_write_mask);
+        }
+    }
+
+    if (p_desc->p_multisample_state) {
+        const VriMultisampleStateDesc *ms = p_desc->p_multisample_state;
+        vri_write_u32(writer, ms->sample_mask);
+        vri_write_u32(writer, ms->sample_count);
+        vri_write_f32(writer, ms->min_sample_shading);
+        vri_write_u32(writer, ms->sample_shading_enable);
+        vri_write_u32(writer, ms->alpha_to_coverage_enable);
+        vri_write_u32(writer, ms->alpha_to_one_enable);
+    }
+}
+
+void vri_write_compute_pipeline_desc(VriWriter *writer, const VriComputePipelineDesc *p_desc) {
+    vri_write_u32(writer, p_desc->p_shader ? 1 : 0);
+    if (p_desc->p_shader) {
+        write_shader(writer, p_desc->p_shader);
+    }
+}
+
+void vri_write_shader_module_desc(VriWriter *writer, const VriShaderModuleDesc *p_desc) {
+    write_shader(writer, p_desc);
+}
+
+void vri_reader_init(VriReader *reader, const void *p_data, size_t size, void *p_scratch, size_t scratch_capacity, const VriReaderCallbacks *p_callbacks) {
+    memset(reader, 0, sizeof(*reader));
+    reader->p_data = p_data;
+    reader->size = size;
+    reader->p_scratch = p_scratch;
+    reader->scratch_capacity = scratch_capacity;
+    if (p_callbacks) {
+        reader->callbacks = *p_callbacks;
+    }
+}
+
+const void *vri_read_bytes(VriReader *reader, size_t size) {
+    if (reader->overflow || size > reader->size - reader->offset) {
+        reader->overflow = VRI_TRUE;
+        return NULL;
+    }
+
+    const void *p_data = reader->p_data + reader->offset;
+    reader->offset += size;
+    return p_data;
+}
+
+uint32_t vri_read_u32(VriReader *reader) {
+    uint32_t    value = 0;
+    const void *p_data = vri_read_bytes(reader, sizeof(value));
+    if (p_data) memcpy(&value, p_data, sizeof(value));
+    return value;
+}
+
+uint64_t vri_read_u64(VriReader *reader) {
+    uint64_t    value = 0;
+    const void *p_data = vri_read_bytes(reader, sizeof(value));
+    if (p_data) memcpy(&value, p_data, sizeof(value));
+    return value;
+}
+
+float vri_read_f32(VriReader *reader) {
+    float       value = 0.0f;
+    const void *p_data = vri_read_bytes(reader, sizeof(value));
+    if (p_data) memcpy(&value, p_data, sizeof(value));
+    return value;
+}
+
+const void *vri_read_blob(VriReader *reader, size_t *p_size) {
+    uint32_t id = vri_read_u32(reader);
+    *p_size = 0;
+    if (!id || !reader->callbacks.pfn_resolve_blob) return NULL;
+    return reader->callbacks.pfn_resolve_blob(reader->callbacks.p_user_data, id, p_size);
+}
+
+const char *vri_read_string(VriReader *reader) {
+    size_t size = 0;
+    return vri_read_blob(reader, &size);
+}
+
+void *vri_read_handle(VriReader *reader) {
+    uint32_t id = vri_read_u32(reader);
+    if (!id || !reader->callbacks.pfn_resolve_handle) return NULL;
+    return reader->callbacks.pfn_resolve_handle(reader->callbacks.p_user_data, id);
+}
+
+void *vri_reader_scratch(VriReader *reader, size_t size) {
+    size_t aligned = (size + 7) & ~(size_t)7;
+    if (aligned > reader->scratch_capacity - reader->scratch_used) {
+        reader->overflow = VRI_TRUE;
+        return NULL;
+    }
+
+    void *p_memory = reader->p_scratch + reader->scratch_used;
+    reader->scratch_used += aligned;
+    memset(p_memory, 0, size);
+    return p_memory;
+}
+
+VriResult vri_read_graphics_pipeline_desc(VriReader *reader, VriGraphicsPipelineDesc *p_desc) {
+    VriPipelineLayout layout = (VriPipelineLayout)(uintptr_t)vri_read_handle(reader);
+    uint32_t          present = vri_read_u32(reader);
+    uint32_t          dynamic_states = vri_read_u32(reader);
+    uint32_t          shader_count = vri_read_u32(reader);
+
+    VriShaderModuleDesc *shaders = NULL;
+    if (shader_count) {
+        shaders = vri_reader_scratch(reader, sizeof(VriShaderModuleDesc) * shader_count);
+        if (!shaders) return VRI_ERROR_OUT_OF_MEMORY;
+        for (uint32_t i = 0; i < shader_count; ++i) {
+            if (!read_shader(reader, &shaders[i])) return VRI_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    VriInputAssemblyDesc *ia = NULL;
+    if (present & PIPELINE_STATE_BIT_INPUT_ASSEMBLY) {
+        if (!(ia = vri_reader_scratch(reader, sizeof(*ia)))) return VRI_ERROR_OUT_OF_MEMORY;
+        ia->topology = (VriPrimitiveTopology)vri_read_u32(reader);
+    }
+
+    VriVertexInputDesc *vi = NULL;
+    if (present & PIPELINE_STATE_BIT_VERTEX_INPUT) {
+        if (!(vi = vri_reader_scratch(reader, sizeof(*vi)))) return VRI_ERROR_OUT_OF_MEMORY;
+        vi->binding_count = vri_read_u32(reader);
+        vi->attribute_count = vri_read_u32(reader);
+
+        VriVertexBindingDesc   *bindings = vri_reader_scratch(reader, sizeof(*bindings) * vi->binding_count);
+        VriVertexAttributeDesc *attributes = vri_reader_scratch(reader, sizeof(*attributes) * vi->attribute_count);
+        if ((vi->binding_count && !bindings) || (vi->attribute_count && !attributes)) return VRI_ERROR_OUT_OF_MEMORY;
+
+        for (uint32_t i = 0; i < vi->binding_count; ++i) {
+            bindings[i].binding_slot = vri_read_u32(reader);
+            bindings[i].stride = vri_read_u32(reader);
+            bindings[i].input_rate = (VriVertexInputRate)vri_read_u32(reader);
+        }
+
+        for (uint32_t i = 0; i < vi->attribute_count; ++i) {
+            attributes[i].d3d.semantic_name = vri_read_string(reader);
+            attributes[i].d3d.semantic_index = vri_read_u32(reader);
+            attributes[i].vk.location = vri_read_u32(reader);
+            attributes[i].binding = vri_read_u32(reader);
+            attributes[i].format = (VriFormat)vri_read_u32(reader);
+            attributes[i].offset = vri_read_u32(reader);
+        }
+
+        vi->p_bindings = bindings;
+        vi->p_attributes = attributes;
+    }
+
+    VriRasterizationStateDesc *rs = NULL;
+    if (present & PIPELINE_STATE_BIT_RASTERIZATION) {
+        if (!(rs = vri_reader_scratch(reader, sizeof(*rs)))) return VRI_ERROR_OUT_OF_MEMORY;
+        rs->fill_mode = (VriFillMode)vri_read_u32(reader);
+        rs->cull_mode = (VriCullMode)vri_read_u32(reader);
+        rs->front_face = (VriFrontFace)vri_read_u32(reader);
+        rs->depth_clamp_enable = vri_read_u32(reader) != 0;
+        rs->depth_bias_enable = vri_read_u32(reader) != 0;
+        rs->depth_bias_constant_factor = vri_read_f32(reader);
+        rs->depth_bias_clamp = vri_read_f32(reader);
+        rs->depth_bias_slope_factor = vri_read_f32(reader);
+    }
+
+    VriDepthStencilStateDesc *ds = NULL;
+    if (present & PIPELINE_STATE_BIT_DEPTH_STENCIL) {
+        if (!(ds = vri_reader_scratch(reader, sizeof(*ds)))) return VRI_ERROR_OUT_OF_MEMORY;
+        ds->depth_test_enable = vri_read_u32(reader) != 0;
+        ds->depth_write_enable = vri_read_u32(reader) != 0;
+        ds->depth_compare_op = (VriCompareOp)vri_read_u32(reader);
+        ds->stencil_test_enable = vri_read_u32(reader) != 0;
+        ds->stencil_read_mask = (uint8_t)vri_read_u32(reader);
+        ds->stencil_write_mask = (uint8_t)vri_read_u32(reader);
+        read_stencil_op(reader, &ds->front);
+        read_stencil_op(reader, &ds->back);
+        ds->stencil_reference = vri_read_u32(reader);
+    }
+
+    VriColorBlendStateDesc *cb = NULL;
+    if (present & PIPELINE_STATE_BIT_COLOR_BLEND) {
+        if (!(cb = vri_reader_scratch(reader, sizeof(*cb)))) return VRI_ERROR_OUT_OF_MEMORY;
+        cb->render_target_count = VRI_MIN(vri_read_u32(reader), (uint32_t)VRI_ARRAY_SIZE(cb->render_targets));
+        cb->independent_blend_enable = vri_read_u32(reader) != 0;
+        cb->alpha_to_coverage_enable = vri_read_u32(reader) != 0;
+        for (uint32_t i = 0; i < 4; ++i) {
+            cb->blend_constants[i] = vri_read_f32(reader);
+        }
+
+        for (uint32_t i = 0; i < cb->render_target_count; ++i) {
+            VriColorBlendAttachmentDesc *rt = &cb->render_targets[i];
+            rt->blend_enable = vri_read_u32(reader) != 0;
+            rt->src_color_blend_factor = (VriBlendFactor)vri_read_u32(reader);
+            rt->dst_color_blend_factor = (VriBlendFactor)vri_read_u32(reader);
+            rt->color_blend_op = (VriBlendOp)vri_read_u32(reader);
+            rt->src_alpha_blend_factor = (VriBlendFactor)vri_read_u32(reader);
+            rt->dst_alpha_blend_factor = (VriBlendFactor)vri_read_u32(reader);
+            rt->alpha_blend_op = (VriBlendOp)vri_read_u32(reader);
+            rt->color_write_mask = (uint8_t)vri_read_u32(reader);
+        }
+    }
+
+    VriMultisampleStateDesc *ms = NULL;
+    if (present & PIPELINE_STATE_BIT_MULTISAMPLE) {
+        if (!(ms = vri_reader_scratch(reader, sizeof(*ms)))) return VRI_ERROR_OUT_OF_MEMORY;
+        ms->sample_mask = vri_read_u32(reader);
+        ms->sample_count = vri_read_u32(reader);
+        ms->min_sample_shading = vri_read_f32(reader);
+        ms->sample_shading_enable = vri_read_u32(reader) != 0;
+        ms->alpha_to_coverage_enable = vri_read_u32(reader) != 0;
+        ms->alpha_to_one_enable = vri_read_u32(reader) != 0;
+    }
+
+    if (reader->overflow) return VRI_ERROR_INVALID_API_USAGE;
+
+    // The layout member is const, so the desc can only be built by initialization
+    VriGraphicsPipelineDesc desc = {
+        .pipeline_layout = layout,
+        .p_shaders = shaders,
+        .shader_count = shader_count,
+        .p_input_assembly_state = ia,
+        .p_vertex_input = vi,
+        .p_rasterization_state = rs,
+        .p_depth_stencil_state = ds,
+        .p_color_blend_state = cb,
+        .p_multisample_state = ms,
+        .dynamic_states = dynamic_states,
+    };
+    memcpy(p_desc, &desc, sizeof(desc));
+
+    return VRI_SUCCESS;
+}
+
+VriResult vri_read_compute_pipeline_desc(VriReader *reader, VriComputePipelineDesc *p_desc) {
+    p_desc->p_shader = NULL;
+
+    if (vri_read_u32(reader)) {
+        p_desc->p_shader = vri_reader_scratch(reader, sizeof(VriShaderModuleDesc));
+        if (!p_desc->p_shader || !read_shader(reader, p_desc->p_shader)) return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    return reader->overflow ? VRI_ERROR_INVALID_API_USAGE : VRI_SUCCESS;
+}
+
+VriResult vri_read_shader_module_desc(VriReader *reader, VriShaderModuleDesc *p_desc) {
+    if (!read_shader(reader, p_desc)) return VRI_ERROR_OUT_OF_MEMORY;
+    return reader->overflow ? VRI_ERROR_INVALID_API_USAGE : VRI_SUCCESS;
+}
+
+// 64-bit FNV-1a, chain calls by passing the previous result as `hash`
+uint64_t vri_hash_bytes(uint64_t hash, const void *p_data, size_t size) {
+    const uint8_t *bytes = p_data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static VriBool writer_reserve(VriWriter *writer, size_t size) {
+    if (writer->out_of_memory) return VRI_FALSE;
+    if (writer->size + size <= writer->capacity) return VRI_TRUE;
+
+    size_t capacity = writer->capacity ? writer->capacity : WRITER_MIN_CAPACITY;
+    while (capacity < writer->size + size) {
+        capacity *= 2;
+    }
+
+    uint8_t *p_data = writer->p_allocator->pfn_allocate(capacity, 8, writer->scope);
+    if (!p_data) {
+        writer->out_of_memory = VRI_TRUE;
+        return VRI_FALSE;
+    }
+
+    if (writer->p_data) {
+        memcpy(p_data, writer->p_data, writer->size);
+        writer->p_allocator->pfn_free(writer->p_data, writer->capacity, 8, writer->scope);
+    }
+
+    writer->p_data = p_data;
+    writer->capacity = capacity;
+    return VRI_TRUE;
+}
+
+static void write_shader(VriWriter *writer, const VriShaderModuleDesc *p_shader) {
+    vri_write_u32(writer, p_shader->stage);
+    vri_write_blob(writer, p_shader->p_bytecode, p_shader->size);
+    vri_write_string(writer, p_shader->p_entry_point);
+    vri_write_handle(writer, (const void *)(uintptr_t)p_shader->module);
+
+    vri_write_u32(writer, p_shader->specialization_constant_count);
+    for (uint32_t i = 0; i < p_shader->specialization_constant_count; ++i) {
+        vri_write_u32(writer, p_shader->p_specialization_constants[i].constant_id);
+        vri_write_u32(writer, p_shader->p_specialization_constants[i].value);
+    }
+}
+
+// False when the specialization constants don't fit in the scratch memory
+static VriBool read_shader(VriReader *reader, VriShaderModuleDesc *p_shader) {
+    p_shader->stage = (VriShaderStageFlagBits)vri_read_u32(reader);
+    p_shader->p_bytecode = vri_read_blob(reader, &p_shader->size);
+    p_shader->p_entry_point = vri_read_string(reader);
+    p_shader->module = (VriShaderModule)(uintptr_t)vri_read_handle(reader);
+
+    uint32_t                   count = vri_read_u32(reader);
+    VriSpecializationConstant *constants = NULL;
+    if (count && !(constants = vri_reader_scratch(reader, sizeof(*constants) * count))) return VRI_FALSE;
+    for (uint32_t i = 0; i < count; ++i) {
+        constants[i].constant_id = vri_read_u32(reader);
+        constants[i].value = vri_read_u32(reader);
+    }
+    p_shader->p_specialization_constants = constants;
+    p_shader->specialization_constant_count = count;
+
+    return VRI_TRUE;
+}
+
+static void write_stencil_op(VriWriter *writer, const VriStencilOpDesc *p_op) {
+    vri_write_u32(writer, p_op->fail_op);
+    vri_write_u32(writer, p_op->depth_fail_op);
+    vri_write_u32(writer, p_op->pass_op);
+    vri_write_u32(writer, p_op->compare_op);
+}
+
+static void read_stencil_op(VriReader *reader, VriStencilOpDesc *p_op) {
+    p_op->fail_op = (VriStencilOp)vri_read_u32(reader);
+    p_op->depth_fail_op = (VriStencilOp)vri_read_u32(reader);
+    p_op->pass_op = (VriStencilOp)vri_read_u32(reader);
+    p_op->compare_op = (VriCompareOp)vri_read_u32(reader);
+}
@@ -0,0 +1,76 @@
+#ifndef VRI_SERIALIZE_H
+#define VRI_SERIALIZE_H
+
+#include "vri_internal.h"
+
+// Flat little-endian encoding of VRI descriptors. Everything is written as
+// 32 or 64 bit words, byte blobs (shader bytecode, strings) and handles are
+// replaced by ids handed out by the owner of the writer, so the same encoding
+// serves capture traces and anything else that needs to persist descriptors.
+
+typedef struct {
+    uint32_t (*pfn_intern_blob)(void *p_user_data, const void *p_data, size_t size);
+    uint32_t (*pfn_intern_handle)(void *p_user_data, const void *p_handle);
+    void *p_user_data;
+} VriWriterCallbacks;
+
+typedef struct {
+    uint8_t                     *p_data;
+    size_t                       size;
+    size_t                       capacity;
+    VriBool                      out_of_memory;
+    const VriAllocationCallback *p_allocator;
+    VriAllocationScope           scope;
+    VriWriterCallbacks           callbacks;
+} VriWriter;
+
+typedef struct {
+    const void *(*pfn_resolve_blob)(void *p_user_data, uint32_t id, size_t *p_size);
+    void *(*pfn_resolve_handle)(void *p_user_data, uint32_t id);
+    void *p_user_data;
+} VriReaderCallbacks;
+
+typedef struct {
+    const uint8_t     *p_data;
+    size_t             size;
+    size_t             offset;
+    VriBool            overflow; // Set once anything reads past the end, values read after that are 0
+    uint8_t           *p_scratch;
+    size_t             scratch_capacity;
+    size_t             scratch_used;
+    VriReaderCallbacks callbacks;
+} VriReader;
+
+void vri_writer_init(VriWriter *writer, const VriAllocationCallback *p_allocator, VriAllocationScope scope, const VriWriterCallbacks *p_callbacks);
+void vri_writer_reset(VriWriter *writer);
+void vri_writer_destroy(VriWriter *writer);
+void vri_write_u32(VriWriter *writer, uint32_t value);
+void vri_write_u64(VriWriter *writer, uint64_t value);
+void vri_write_f32(VriWriter *writer, float value);
+void vri_write_bytes(VriWriter *writer, const void *p_data, size_t size);
+void vri_write_blob(VriWriter *writer, const void *p_data, size_t size);
+void vri_write_string(VriWriter *writer, const char *p_string);
+void vri_write_handle(VriWriter *writer, const void *p_handle);
+void vri_write_graphics_pipeline_desc(VriWriter *writer, const VriGraphicsPipelineDesc *p_desc);
+void vri_write_compute_pipeline_desc(VriWriter *writer, const VriComputePipelineDesc *p_desc);
+void vri_write_shader_module_desc(VriWriter *writer, const VriShaderModuleDesc *p_desc);
+
+// Arrays in decoded descriptors live in the scratch memory, which the caller owns
+void        vri_reader_init(VriReader *reader, const void *p_data, size_t size, void *p_scratch, size_t scratch_capacity, const VriReaderCallbacks *p_callbacks);
+uint32_t    vri_read_u32(VriReader *reader);
+uint64_t    vri_read_u64(VriReader *reader);
+float       vri_read_f32(VriReader *reader);
+const void *vri_read_bytes(VriReader *reader, size_t size);
+const void *vri_read_blob(VriReader *reader, size_t *p_size);
+const char *vri_read_string(VriReader *reader);
+void       *vri_read_handle(VriReader *reader);
+void       *vri_reader_scratch(VriReader *reader, size_t size);
+VriResult   vri_read_graphics_pipeline_desc(VriReader *reader, VriGraphicsPipelineDesc *p_desc);
+VriResult   vri_read_compute_pipeline_desc(VriReader *reader, VriComputePipelineDesc *p_desc);
+VriResult   vri_read_shader_module_desc(VriReader *reader, VriShaderModuleDesc *p_desc);
+
+uint64_t vri_hash_bytes(uint64_t hash, const void *p_data, size_t size);
+
+#define VRI_HASH_SEED 0xcbf29ce484222325ull
+
+#endif
@@ -0,0 +1,190 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+#include "vri_serialize.h"
+
+#include <string.h>
+
+// Shader module deduplication. Modules live in a chained hash table keyed by a
+// hash of their stage, entry point and bytecode, and are reference counted, so
+// creating the same shader twice shares one backend shader object. The backend
+// shader is created outside the table's lock, a module that lost the race to
+// another thread creating the same shader is thrown away again.
+
+#define SHADER_MODULE_INITIAL_BUCKET_COUNT 64
+
+static uint64_t        shader_module_hash(const VriShaderModuleDesc *p_desc);
+static VriShaderModule shader_module_find(VriShaderModuleTable *table, uint64_t hash, const VriShaderModuleDesc *p_desc);
+static VriBool         shader_module_insert(VriDevice device, VriShaderModule shader_module);
+static void            shader_module_free(VriDevice device, VriShaderModule shader_module, size_t backend_data_size);
+
+VriResult vri_shader_module_acquire(VriDevice device, const VriShaderModuleDesc *p_desc, size_t backend_data_size, PFN_VriShaderModuleInit pfn_init, PFN_VriShaderModuleDeinit pfn_deinit, VriShaderModule *p_shader_module) {
+    VriDebugCallback      dbg = device->debug_callback;
+    VriShaderModuleTable *table = &device->shader_modules;
+
+    uint64_t hash = shader_module_hash(p_desc);
+
+    vri_spinlock_lock(&table->lock);
+    VriShaderModule existing = shader_module_find(table, hash, p_desc);
+    if (existing) existing->ref_count++;
+    vri_spinlock_unlock(&table->lock);
+
+    if (existing) {
+        VRI_STAT_ADD(device, shader_module_reuses, 1);
+        *p_shader_module = existing;
+        return VRI_SUCCESS;
+    }
+
+    VriShaderModule shader_module = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriShaderModule_T) + backend_data_size, VRI_OBJECT_TYPE_SHADER_MODULE);
+    if (!shader_module) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate shader module object");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    // The bytecode and the entry point share one allocation
+    size_t entry_point_size = p_desc->p_entry_point ? strlen(p_desc->p_entry_point) + 1 : 0;
+    char  *p_copy = device->allocation_callback.pfn_allocate(p_desc->size + entry_point_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!p_copy) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to allocate shader module bytecode");
+        vri_object_free(device, &device->allocation_callback, shader_module, sizeof(struct VriShaderModule_T) + backend_data_size);
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(p_copy, p_desc->p_bytecode, p_desc->size);
+    if (entry_point_size) memcpy(p_copy + p_desc->size, p_desc->p_entry_point, entry_point_size);
+
+    shader_module->hash = hash;
+    shader_module->ref_count = 1;
+    shader_module->stage = p_desc->stage;
+    shader_module->size = p_desc->size;
+    shader_module->p_bytecode = p_copy;
+    shader_module->p_entry_point = entry_point_size ? p_copy + p_desc->size : NULL;
+    shader_module->p_backend_data = backend_data_size ? (void *)(shader_module + 1) : NULL;
+
+    VriResult result = pfn_init ? pfn_init(device, shader_module) : VRI_SUCCESS;
+    if (VRI_ERROR(result)) {
+        shader_module_free(device, shader_module, backend_data_size);
+        return result;
+    }
+
+    // Another thread may have created the same module in the meantime
+    vri_spinlock_lock(&table->lock);
+    existing = shader_module_find(table, hash, p_desc);
+    if (existing) {
+        existing->ref_count++;
+    } else if (!shader_module_insert(device, shader_module)) {
+        result = VRI_ERROR_OUT_OF_MEMORY;
+    }
+    vri_spinlock_unlock(&table->lock);
+
+    if (existing || VRI_ERROR(result)) {
+        if (pfn_deinit) pfn_deinit(device, shader_module);
+        shader_module_free(device, shader_module, backend_data_size);
+        if (VRI_ERROR(result)) {
+            dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to grow the shader module table");
+            return result;
+        }
+        VRI_STAT_ADD(device, shader_module_reuses, 1);
+        shader_module = existing;
+    }
+
+    *p_shader_module = shader_module;
+    return VRI_SUCCESS;
+}
+
+void vri_shader_module_release(VriDevice device, VriShaderModule shader_module, size_t backend_data_size, PFN_VriShaderModuleDeinit pfn_deinit) {
+    VriShaderModuleTable *table = &device->shader_modules;
+
+    vri_spinlock_lock(&table->lock);
+    VriBool last = --shader_module->ref_count == 0;
+    if (last) {
+        VriShaderModule *p_link = &table->p_buckets[shader_module->hash & (table->bucket_count - 1)];
+        while (*p_link != shader_module) {
+            p_link = &(*p_link)->p_next;
+        }
+        *p_link = shader_module->p_next;
+        table->count--;
+    }
+    vri_spinlock_unlock(&table->lock);
+
+    if (last) {
+        if (pfn_deinit) pfn_deinit(device, shader_module);
+        shader_module_free(device, shader_module, backend_data_size);
+    }
+}
+
+void vri_shader_modules_destroy(VriDevice device) {
+    VriShaderModuleTable *table = &device->shader_modules;
+
+    // Modules the application never destroyed go with their pools, their bytecode goes here
+    for (uint32_t i = 0; i < table->bucket_count; ++i) {
+        for (VriShaderModule it = table->p_buckets[i]; it; it = it->p_next) {
+            size_t entry_point_size = it->p_entry_point ? strlen(it->p_entry_point) + 1 : 0;
+            device->allocation_callback.pfn_free((void *)it->p_bytecode, it->size + entry_point_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        }
+    }
+    if (table->p_buckets) {
+        device->allocation_callback.pfn_free(table->p_buckets, sizeof(VriShaderModule) * table->bucket_count, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+static uint64_t shader_module_hash(const VriShaderModuleDesc *p_desc) {
+    uint64_t hash = vri_hash_bytes(VRI_HASH_SEED, &p_desc->stage, sizeof(p_desc->stage));
+    if (p_desc->p_entry_point) {
+        hash = vri_hash_bytes(hash, p_desc->p_entry_point, strlen(p_desc->p_entry_point));
+    }
+    return vri_hash_bytes(hash, p_desc->p_bytecode, p_desc->size);
+}
+
+static VriShaderModule shader_module_find(VriShaderModuleTable *table, uint64_t hash, const VriShaderModuleDesc *p_desc) {
+    if (!table->bucket_count) return NULL;
+
+    for (VriShaderModule it = table->p_buckets[hash & (table->bucket_count - 1)]; it; it = it->p_next) {
+        if (it->hash != hash || it->stage != p_desc->stage || it->size != p_desc->size) continue;
+        if ((it->p_entry_point == NULL) != (p_desc->p_entry_point == NULL)) continue;
+        if (it->p_entry_point && strcmp(it->p_entry_point, p_desc->p_entry_point) != 0) continue;
+        if (memcmp(it->p_bytecode, p_desc->p_bytecode, p_desc->size) != 0) continue;
+        return it;
+    }
+    return NULL;
+}
+
+// Called with the table's lock held, doubles the buckets once there are more modules than buckets
+static VriBool shader_module_insert(VriDevice device, VriShaderModule shader_module) {
+    VriShaderModuleTable  *table = &device->shader_modules;
+    VriAllocationCallback *alloc = &device->allocation_callback;
+
+    if (table->count >= table->bucket_count) {
+        uint32_t         bucket_count = table->bucket_count ? table->bucket_count * 2 : SHADER_MODULE_INITIAL_BUCKET_COUNT;
+        VriShaderModule *p_buckets = alloc->pfn_allocate(sizeof(VriShaderModule) * bucket_count, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+        if (!p_buckets) return VRI_FALSE;
+        memset(p_buckets, 0, sizeof(VriShaderModule) * bucket_count);
+
+        for (uint32_t i = 0; i < table->bucket_count; ++i) {
+            VriShaderModule it = table->p_buckets[i];
+            while (it) {
+                VriShaderModule next = it->p_next;
+                it->p_next = p_buckets[it->hash & (bucket_count - 1)];
+                p_buckets[it->hash & (bucket_count - 1)] = it;
+                it = next;
+            }
+        }
+
+        if (table->p_buckets) {
+            alloc->pfn_free(table->p_buckets, sizeof(VriShaderModule) * table->bucket_count, 8, VRI_ALLOCATION_SCOPE_DEVICE);
+        }
+        table->p_buckets = p_buckets;
+        table->bucket_count = bucket_count;
+    }
+
+    VriShaderModule *p_bucket = &table->p_buckets[shader_module->hash & (table->bucket_count - 1)];
+    shader_module->p_next = *p_bucket;
+    *p_bucket = shader_module;
+    table->count++;
+    return VRI_TRUE;
+}
+
+static void shader_module_free(VriDevice device, VriShaderModule shader_module, size_t backend_data_size) {
+    size_t entry_point_size = shader_module->p_entry_point ? strlen(shader_module->p_entry_point) + 1 : 0;
+    device->allocation_callback.pfn_free((void *)shader_module->p_bytecode, shader_module->size + entry_point_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    vri_object_free(device, &device->allocation_callback, shader_module, sizeof(struct VriShaderModule_T) + backend_data_size);
+}
@@ -0,0 +1,603 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#    define _DEFAULT_SOURCE // syscall
+#endif
+
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <errno.h>
+#    include <unistd.h>
+#    if defined(__linux__) && defined(__has_include)
+#        if __has_include(<linux/io_uring.h>)
+#            include <linux/io_uring.h>
+#            include <sys/mman.h>
+#            include <sys/syscall.h>
+#            include <sys/uio.h>
+#        endif
+#    endif
+#endif
+
+// io_uring where the kernel headers have it, built with VRI_ENABLE_IO_URING=0
+// every read is a pread
+#if !defined(VRI_ENABLE_IO_URING)
+#    if defined(IORING_ENTER_GETEVENTS) && defined(__NR_io_uring_setup)
+#        define VRI_ENABLE_IO_URING 1
+#    else
+#        define VRI_ENABLE_IO_URING 0
+#    endif
+#endif
+
+// Asset streaming on top of an upload queue. Pending requests wait in a heap
+// until vri_stream_queue_process starts reading them, straight into a ring of
+// staging memory, and a read is recorded from where it landed by the first
+// process call that finds it complete, so the application never holds a copy
+// of the data. The reads of one call are started together and stay in flight
+// between calls: on Linux as one io_uring submission, on Windows as
+// overlapped ReadFile calls. Where neither is available, or io_uring can't be
+// set up, every read is a positional read that completes as it's started.
+
+#if VRI_ENABLE_IO_URING
+struct VriStreamIo {
+    int                  ring;
+    uint32_t            *p_sq_tail;
+    uint32_t            *p_sq_mask;
+    uint32_t            *p_sq_array;
+    uint32_t            *p_cq_head;
+    uint32_t            *p_cq_tail;
+    uint32_t            *p_cq_mask;
+    struct io_uring_sqe *p_sqes;
+    struct io_uring_cqe *p_cqes;
+    void                *p_sq_ring;
+    void                *p_cq_ring; // The same mapping as the SQ ring on kernels with IORING_FEAT_SINGLE_MMAP
+    size_t               sq_ring_size;
+    size_t               cq_ring_size;
+    size_t               sqes_size;
+    uint32_t             unsubmitted; // Queued since the last io_uring_enter
+    struct iovec        *p_iovecs;    // One per read slot, the kernel reads them at submission
+};
+#elif defined(_WIN32)
+struct VriStreamIo {
+    OVERLAPPED *p_overlapped; // One per read slot, each with its own event
+    VriBool    *p_pending;    // Whether the slot's ReadFile is still running
+};
+#endif
+
+static VriResult stream_io_create(VriStreamQueue stream_queue);
+static void      stream_io_destroy(VriDevice device, VriStreamQueue stream_queue);
+static void      stream_io_start(VriStreamQueue stream_queue, uint32_t slot);
+static void      stream_io_submit(VriStreamQueue stream_queue);
+static void      stream_io_poll(VriStreamQueue stream_queue, VriBool wait);
+static void      stream_read_progress(VriStreamQueue stream_queue, uint32_t slot, int64_t result);
+#if !defined(_WIN32)
+static VriBool stream_read_sync(intptr_t file, uint64_t offset, void *p_data, size_t size);
+#endif
+static VriBool   stream_staging_allocate(VriStreamQueue stream_queue, uint64_t size, uint64_t *p_offset);
+static void      stream_record_complete(VriStreamQueue stream_queue, uint32_t *p_streamed_count);
+static VriBool   stream_request_before(const VriStreamRequest *a, const VriStreamRequest *b);
+static void      stream_heap_push(VriStreamQueue stream_queue, const VriStreamRequest *request);
+static void      stream_heap_remove(VriStreamQueue stream_queue, uint32_t index);
+static void      stream_notify(const VriStreamRequest *request, VriStreamStatus status, uint64_t fence_value);
+
+VriResult vri_stream_queue_create(VriDevice device, const VriStreamQueueDesc *p_desc, VriStreamQueue *p_stream_queue) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    if (!p_desc->upload_queue) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Stream queue needs an upload queue");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    VriStreamQueue stream_queue = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriStreamQueue_T), VRI_OBJECT_TYPE_STREAM_QUEUE);
+    if (!stream_queue) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Stream Queue struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    stream_queue->base.p_create_site = VRI_RETURN_ADDRESS();
+#endif
+    stream_queue->upload_queue = p_desc->upload_queue;
+    stream_queue->staging_size = p_desc->staging_size ? p_desc->staging_size : VRI_STREAM_QUEUE_DEFAULT_STAGING_SIZE;
+    stream_queue->max_requests = p_desc->max_requests ? p_desc->max_requests : VRI_STREAM_QUEUE_DEFAULT_MAX_REQUESTS;
+    stream_queue->next_id = 1;
+
+    // Pending and streamed requests share one allocation, a request is only ever
+    // in one of them. A process call records up to twice max_requests, it starts
+    // no more reads once it recorded more than max_requests.
+    VriAllocationCallback *alloc = &device->allocation_callback;
+    stream_queue->p_pending = alloc->pfn_allocate(sizeof(VriStreamRequest) * stream_queue->max_requests * 3, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    stream_queue->p_reads = alloc->pfn_allocate(sizeof(VriStreamRead) * stream_queue->max_requests, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    stream_queue->p_staging = alloc->pfn_allocate((size_t)stream_queue->staging_size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!stream_queue->p_pending || !stream_queue->p_reads || !stream_queue->p_staging) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate the Stream Queue's request and staging memory");
+        vri_stream_queue_destroy(device, stream_queue);
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+    stream_queue->p_streamed = stream_queue->p_pending + stream_queue->max_requests;
+
+    if (VRI_ERROR(stream_io_create(stream_queue))) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate the Stream Queue's asynchronous reads");
+        vri_stream_queue_destroy(device, stream_queue);
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    *p_stream_queue = stream_queue;
+    return VRI_SUCCESS;
+}
+
+void vri_stream_queue_destroy(VriDevice device, VriStreamQueue stream_queue) {
+    if (!stream_queue) return;
+
+    // The staging memory can't go while the OS is still writing to it
+    while (stream_queue->p_io && stream_queue->read_count) {
+        stream_io_submit(stream_queue);
+        stream_io_poll(stream_queue, VRI_TRUE);
+        while (stream_queue->read_count && stream_queue->p_reads[stream_queue->read_first].complete) {
+            stream_notify(&stream_queue->p_reads[stream_queue->read_first].request, VRI_STREAM_STATUS_CANCELLED, 0);
+            stream_queue->read_first = (stream_queue->read_first + 1) % stream_queue->max_requests;
+            stream_queue->read_count--;
+        }
+    }
+    for (uint32_t i = 0; i < stream_queue->read_count; ++i) {
+        stream_notify(&stream_queue->p_reads[(stream_queue->read_first + i) % stream_queue->max_requests].request, VRI_STREAM_STATUS_CANCELLED, 0);
+    }
+    for (uint32_t i = 0; i < stream_queue->pending_count; ++i) {
+        stream_notify(&stream_queue->p_pending[i], VRI_STREAM_STATUS_CANCELLED, 0);
+    }
+
+    stream_io_destroy(device, stream_queue);
+
+    VriAllocationCallback *alloc = &device->allocation_callback;
+    if (stream_queue->p_pending) {
+        alloc->pfn_free(stream_queue->p_pending, sizeof(VriStreamRequest) * stream_queue->max_requests * 3, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    if (stream_queue->p_reads) {
+        alloc->pfn_free(stream_queue->p_reads, sizeof(VriStreamRead) * stream_queue->max_requests, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+    if (stream_queue->p_staging) {
+        alloc->pfn_free(stream_queue->p_staging, (size_t)stream_queue->staging_size, VRI_CACHE_LINE_SIZE, VRI_ALLOCATION_SCOPE_OBJECT);
+    }
+
+    vri_object_free(device, alloc, stream_queue, sizeof(struct VriStreamQueue_T));
+}
+
+VriResult vri_stream_queue_request(VriStreamQueue stream_queue, const VriStreamRequestDesc *p_desc, uint64_t *p_request_id) {
+    VriDebugCallback dbg = stream_queue->base.p_device->debug_callback;
+
+    uint64_t size = (uint64_t)p_desc->region.data.slice_pitch * p_desc->region.depth;
+    if (!size || size > stream_queue->staging_size) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Stream request is empty or larger than the Stream Queue's staging memory");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+    if (stream_queue->pending_count == stream_queue->max_requests) {
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    VriStreamRequest request = {.desc = *p_desc, .id = stream_queue->next_id++};
+    stream_heap_push(stream_queue, &request);
+
+    if (p_request_id) *p_request_id = request.id;
+    return VRI_SUCCESS;
+}
+
+VriResult vri_stream_queue_cancel(VriStreamQueue stream_queue, uint64_t request_id) {
+    for (uint32_t i = 0; i < stream_queue->pending_count; ++i) {
+        if (stream_queue->p_pending[i].id == request_id) {
+            VriStreamRequest request = stream_queue->p_pending[i];
+            stream_heap_remove(stream_queue, i);
+            stream_notify(&request, VRI_STREAM_STATUS_CANCELLED, 0);
+            return VRI_SUCCESS;
+        }
+    }
+    return VRI_INCOMPLETE;
+}
+
+VriResult vri_stream_queue_process(VriStreamQueue stream_queue, uint64_t byte_budget, uint64_t *p_fence_value) {
+    uint32_t streamed_count = 0;
+    uint64_t started_bytes = 0;
+
+    // Reads that completed since the last call are recorded first, which frees their staging memory
+    stream_record_complete(stream_queue, &streamed_count);
+
+    // A request is read whole, so the one crossing the budget still starts.
+    // The highest priority request waits for staging memory rather than
+    // letting smaller ones past it. Each round of reads is one submission, and
+    // reads that complete straight away make room for another round, as long
+    // as the streamed requests still have room for what it records.
+    VriBool started = VRI_TRUE;
+    while (started && streamed_count <= stream_queue->max_requests) {
+        started = VRI_FALSE;
+        while (stream_queue->pending_count && started_bytes < byte_budget && stream_queue->read_count < stream_queue->max_requests) {
+            uint64_t size = (uint64_t)stream_queue->p_pending[0].desc.region.data.slice_pitch * stream_queue->p_pending[0].desc.region.depth;
+            uint64_t staging_offset;
+            if (!stream_staging_allocate(stream_queue, size, &staging_offset)) break;
+
+            uint32_t       slot = (stream_queue->read_first + stream_queue->read_count++) % stream_queue->max_requests;
+            VriStreamRead *read = &stream_queue->p_reads[slot];
+            *read = (VriStreamRead){.request = stream_queue->p_pending[0], .staging_offset = staging_offset, .size = size};
+            stream_heap_remove(stream_queue, 0);
+
+            stream_io_start(stream_queue, slot);
+            started_bytes += size;
+            started = VRI_TRUE;
+        }
+
+        stream_io_submit(stream_queue);
+        stream_record_complete(stream_queue, &streamed_count);
+    }
+
+    uint64_t  fence_value = 0;
+    VriResult result = vri_upload_queue_flush(stream_queue->upload_queue, &fence_value);
+
+    for (uint32_t i = 0; i < streamed_count; ++i) {
+        stream_notify(&stream_queue->p_streamed[i], VRI_OK(result) ? VRI_STREAM_STATUS_SUBMITTED : VRI_STREAM_STATUS_FAILED, fence_value);
+    }
+
+    if (p_fence_value) *p_fence_value = fence_value;
+    return VRI_OK(result) && stream_queue->read_count ? VRI_INCOMPLETE : result;
+}
+
+#if VRI_ENABLE_IO_URING
+static VriResult stream_io_create(VriStreamQueue stream_queue) {
+    VriAllocationCallback *alloc = &stream_queue->base.p_device->allocation_callback;
+    size_t                 io_size = sizeof(VriStreamIo) + sizeof(struct iovec) * stream_queue->max_requests;
+
+    VriStreamIo *io = alloc->pfn_allocate(io_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!io) return VRI_ERROR_OUT_OF_MEMORY;
+    memset(io, 0, sizeof(*io));
+    io->p_iovecs = (struct iovec *)(io + 1);
+
+    // Room for every read in flight, so neither ring can overflow. Kernels
+    // without io_uring, or sandboxes that forbid it, fall back to pread.
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    long ring = syscall(__NR_io_uring_setup, stream_queue->max_requests, &params);
+    if (ring < 0) {
+        alloc->pfn_free(io, io_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        return VRI_SUCCESS;
+    }
+    io->ring = (int)ring;
+
+    io->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    io->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        io->sq_ring_size = io->cq_ring_size = VRI_MAX(io->sq_ring_size, io->cq_ring_size);
+    }
+    io->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    io->p_sq_ring = mmap(NULL, io->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, io->ring, IORING_OFF_SQ_RING);
+    io->p_cq_ring = io->p_sq_ring;
+    if (io->p_sq_ring != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        io->p_cq_ring = mmap(NULL, io->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, io->ring, IORING_OFF_CQ_RING);
+    }
+    io->p_sqes = mmap(NULL, io->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, io->ring, IORING_OFF_SQES);
+    if (io->p_sq_ring == MAP_FAILED || io->p_cq_ring == MAP_FAILED || io->p_sqes == MAP_FAILED) {
+        if (io->p_sqes != MAP_FAILED) munmap(io->p_sqes, io->sqes_size);
+        if (io->p_cq_ring != MAP_FAILED && io->p_cq_ring != io->p_sq_ring) munmap(io->p_cq_ring, io->cq_ring_size);
+        if (io->p_sq_ring != MAP_FAILED) munmap(io->p_sq_ring, io->sq_ring_size);
+        close(io->ring);
+        alloc->pfn_free(io, io_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+        return VRI_SUCCESS;
+    }
+
+    uint8_t *p_sq = io->p_sq_ring;
+    uint8_t *p_cq = io->p_cq_ring;
+    io->p_sq_tail = (uint32_t *)(p_sq + params.sq_off.tail);
+    io->p_sq_mask = (uint32_t *)(p_sq + params.sq_off.ring_mask);
+    io->p_sq_array = (uint32_t *)(p_sq + params.sq_off.array);
+    io->p_cq_head = (uint32_t *)(p_cq + params.cq_off.head);
+    io->p_cq_tail = (uint32_t *)(p_cq + params.cq_off.tail);
+    io->p_cq_mask = (uint32_t *)(p_cq + params.cq_off.ring_mask);
+    io->p_cqes = (struct io_uring_cqe *)(p_cq + params.cq_off.cqes);
+
+    stream_queue->p_io = io;
+    return VRI_SUCCESS;
+}
+
+static void stream_io_destroy(VriDevice device, VriStreamQueue stream_queue) {
+    VriStreamIo *io = stream_queue->p_io;
+    if (!io) return;
+
+    munmap(io->p_sqes, io->sqes_size);
+    if (io->p_cq_ring != io->p_sq_ring) munmap(io->p_cq_ring, io->cq_ring_size);
+    munmap(io->p_sq_ring, io->sq_ring_size);
+    close(io->ring);
+    device->allocation_callback.pfn_free(io, sizeof(VriStreamIo) + sizeof(struct iovec) * stream_queue->max_requests, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+}
+
+// Queues the rest of the slot's read, io_uring_enter submits it with the others
+static void stream_io_start(VriStreamQueue stream_queue, uint32_t slot) {
+    VriStreamIo   *io = stream_queue->p_io;
+    VriStreamRead *read = &stream_queue->p_reads[slot];
+    if (!io) {
+        stream_read_progress(stream_queue, slot, stream_read_sync(read->request.desc.file, read->request.desc.offset, stream_queue->p_staging + read->staging_offset, (size_t)read->size) ? (int64_t)read->size : -1);
+        return;
+    }
+
+    io->p_iovecs[slot].iov_base = stream_queue->p_staging + read->staging_offset + read->done;
+    io->p_iovecs[slot].iov_len = (size_t)(read->size - read->done);
+
+    // Only this thread writes the SQ tail, the kernel reads it
+    uint32_t             tail = *io->p_sq_tail;
+    uint32_t             index = tail & *io->p_sq_mask;
+    struct io_uring_sqe *sqe = &io->p_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = (int)read->request.desc.file;
+    sqe->addr = (uint64_t)(uintptr_t)&io->p_iovecs[slot];
+    sqe->len = 1;
+    sqe->off = read->request.desc.offset + read->done;
+    sqe->user_data = slot;
+    io->p_sq_array[index] = index;
+    __atomic_store_n(io->p_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    io->unsubmitted++;
+}
+
+static void stream_io_submit(VriStreamQueue stream_queue) {
+    VriStreamIo *io = stream_queue->p_io;
+    while (io && io->unsubmitted) {
+        long submitted = syscall(__NR_io_uring_enter, io->ring, io->unsubmitted, 0, 0, NULL, 0);
+        if (submitted < 0 && errno == EINTR) continue;
+        if (submitted <= 0) return; // Still queued, the next call submits them
+        io->unsubmitted -= (uint32_t)submitted;
+    }
+}
+
+static void stream_io_poll(VriStreamQueue stream_queue, VriBool wait) {
+    VriStreamIo *io = stream_queue->p_io;
+    if (!io) return;
+
+    // Anything still queued is submitted by the same call that waits
+    if (wait) {
+        long submitted = syscall(__NR_io_uring_enter, io->ring, io->unsubmitted, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (submitted > 0) io->unsubmitted -= (uint32_t)submitted;
+    }
+
+    uint32_t head = *io->p_cq_head;
+    uint32_t tail = __atomic_load_n(io->p_cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe *cqe = &io->p_cqes[head & *io->p_cq_mask];
+        uint32_t                   slot = (uint32_t)cqe->user_data;
+        int32_t                    result = cqe->res;
+
+        // Only the CQ entry is released here, the slot may queue its next read first
+        if (result == -EINTR || result == -EAGAIN) {
+            stream_io_start(stream_queue, slot);
+        } else {
+            stream_read_progress(stream_queue, slot, result);
+        }
+    }
+    __atomic_store_n(io->p_cq_head, head, __ATOMIC_RELEASE);
+    stream_io_submit(stream_queue);
+}
+#elif defined(_WIN32)
+static VriResult stream_io_create(VriStreamQueue stream_queue) {
+    VriAllocationCallback *alloc = &stream_queue->base.p_device->allocation_callback;
+    uint32_t               slot_count = stream_queue->max_requests;
+    size_t                 io_size = sizeof(VriStreamIo) + (sizeof(OVERLAPPED) + sizeof(VriBool)) * slot_count;
+
+    VriStreamIo *io = alloc->pfn_allocate(io_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+    if (!io) return VRI_ERROR_OUT_OF_MEMORY;
+    memset(io, 0, io_size);
+    io->p_overlapped = (OVERLAPPED *)(io + 1);
+    io->p_pending = (VriBool *)(io->p_overlapped + slot_count);
+    stream_queue->p_io = io;
+
+    for (uint32_t i = 0; i < slot_count; ++i) {
+        io->p_overlapped[i].hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (!io->p_overlapped[i].hEvent) return VRI_ERROR_OUT_OF_MEMORY;
+    }
+    return VRI_SUCCESS;
+}
+
+static void stream_io_destroy(VriDevice device, VriStreamQueue stream_queue) {
+    VriStreamIo *io = stream_queue->p_io;
+    if (!io) return;
+
+    for (uint32_t i = 0; i < stream_queue->max_requests; ++i) {
+        if (io->p_overlapped[i].hEvent) CloseHandle(io->p_overlapped[i].hEvent);
+    }
+    size_t io_size = sizeof(VriStreamIo) + (sizeof(OVERLAPPED) + sizeof(VriBool)) * stream_queue->max_requests;
+    device->allocation_callback.pfn_free(io, io_size, 8, VRI_ALLOCATION_SCOPE_OBJECT);
+}
+
+// Handles opened with FILE_FLAG_OVERLAPPED read in the background, others
+// complete inside ReadFile
+static void stream_io_start(VriStreamQueue stream_queue, uint32_t slot) {
+    VriStreamIo   *io = stream_queue->p_io;
+    VriStreamRead *read = &stream_queue->p_reads[slot];
+    OVERLAPPED    *overlapped = &io->p_overlapped[slot];
+
+    uint64_t offset = read->request.desc.offset + read->done;
+    overlapped->Internal = 0;
+    overlapped->InternalHigh = 0;
+    overlapped->Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped->OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD chunk = (DWORD)VRI_MIN(read->size - read->done, (uint64_t)0x80000000u);
+    if (ReadFile((HANDLE)read->request.desc.file, stream_queue->p_staging + read->staging_offset + read->done, chunk, NULL, overlapped) ||
+        GetLastError() == ERROR_IO_PENDING) {
+        io->p_pending[slot] = VRI_TRUE;
+    } else {
+        stream_read_progress(stream_queue, slot, -1);
+    }
+}
+
+static void stream_io_submit(VriStreamQueue stream_queue) {
+    (void)stream_queue; // Every ReadFile is already running
+}
+
+static void stream_io_poll(VriStreamQueue stream_queue, VriBool wait) {
+    VriStreamIo *io = stream_queue->p_io;
+    for (uint32_t i = 0; i < stream_queue->read_count; ++i) {
+        uint32_t slot = (stream_queue->read_first + i) % stream_queue->max_requests;
+        if (!io->p_pending[slot]) continue;
+
+        VriStreamRead *read = &stream_queue->p_reads[slot];
+        DWORD          bytes_read = 0;
+        if (GetOverlappedResult((HANDLE)read->request.desc.file, &io->p_overlapped[slot], &bytes_read, wait)) {
+            io->p_pending[slot] = VRI_FALSE;
+            stream_read_progress(stream_queue, slot, bytes_read);
+        } else if (GetLastError() != ERROR_IO_INCOMPLETE) {
+            io->p_pending[slot] = VRI_FALSE;
+            stream_read_progress(stream_queue, slot, -1);
+        }
+    }
+}
+#else
+static VriResult stream_io_create(VriStreamQueue stream_queue) {
+    (void)stream_queue;
+    return VRI_SUCCESS;
+}
+
+static void stream_io_destroy(VriDevice device, VriStreamQueue stream_queue) {
+    (void)device;
+    (void)stream_queue;
+}
+
+static void stream_io_start(VriStreamQueue stream_queue, uint32_t slot) {
+    VriStreamRead *read = &stream_queue->p_reads[slot];
+    stream_read_progress(stream_queue, slot, stream_read_sync(read->request.desc.file, read->request.desc.offset, stream_queue->p_staging + read->staging_offset, (size_t)read->size) ? (int64_t)read->size : -1);
+}
+
+static void stream_io_submit(VriStreamQueue stream_queue) {
+    (void)stream_queue;
+}
+
+static void stream_io_poll(VriStreamQueue stream_queue, VriBool wait) {
+    (void)stream_queue;
+    (void)wait;
+}
+#endif
+
+// Counts what a read got and starts the rest of a short one. Nothing at all
+// means the file ends before the range does.
+static void stream_read_progress(VriStreamQueue stream_queue, uint32_t slot, int64_t result) {
+    VriStreamRead *read = &stream_queue->p_reads[slot];
+    if (result <= 0) {
+        read->failed = VRI_TRUE;
+        read->complete = VRI_TRUE;
+        return;
+    }
+
+    read->done += (uint64_t)result;
+    if (read->done < read->size) {
+        stream_io_start(stream_queue, slot);
+    } else {
+        read->complete = VRI_TRUE;
+    }
+}
+
+#if !defined(_WIN32)
+static VriBool stream_read_sync(intptr_t file, uint64_t offset, void *p_data, size_t size) {
+    uint8_t *p_bytes = p_data;
+    while (size) {
+        ssize_t bytes_read = pread((int)file, p_bytes, size, (off_t)offset);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read <= 0) return VRI_FALSE;
+        p_bytes += bytes_read;
+        offset += (uint64_t)bytes_read;
+        size -= (size_t)bytes_read;
+    }
+    return VRI_TRUE;
+}
+#endif
+
+// Reads take contiguous ranges of the staging ring and give them back in the
+// order they started, the free space is after the newest read and before the oldest
+static VriBool stream_staging_allocate(VriStreamQueue stream_queue, uint64_t size, uint64_t *p_offset) {
+    if (!stream_queue->read_count) {
+        *p_offset = 0;
+        return size <= stream_queue->staging_size;
+    }
+
+    const VriStreamRead *oldest = &stream_queue->p_reads[stream_queue->read_first];
+    const VriStreamRead *newest = &stream_queue->p_reads[(stream_queue->read_first + stream_queue->read_count - 1) % stream_queue->max_requests];
+    uint64_t             head = oldest->staging_offset;
+    uint64_t             tail = newest->staging_offset + newest->size;
+
+    if (tail > head) {
+        if (stream_queue->staging_size - tail >= size) {
+            *p_offset = tail;
+            return VRI_TRUE;
+        }
+        *p_offset = 0;
+        return head >= size;
+    }
+    *p_offset = tail;
+    return head - tail >= size;
+}
+
+// Records the complete reads at the front, a read that finished early waits
+// for the ones that started before it so the staging ring frees in order
+static void stream_record_complete(VriStreamQueue stream_queue, uint32_t *p_streamed_count) {
+    stream_io_poll(stream_queue, VRI_FALSE);
+
+    while (stream_queue->read_count && stream_queue->p_reads[stream_queue->read_first].complete) {
+        VriStreamRead *read = &stream_queue->p_reads[stream_queue->read_first];
+        stream_queue->read_first = (stream_queue->read_first + 1) % stream_queue->max_requests;
+        stream_queue->read_count--;
+
+        VriTextureUpdateDesc region = read->request.desc.region;
+        region.data.p_data = stream_queue->p_staging + read->staging_offset;
+        if (read->failed || VRI_ERROR(vri_upload_queue_update_texture(stream_queue->upload_queue, read->request.desc.texture, &region))) {
+            stream_notify(&read->request, VRI_STREAM_STATUS_FAILED, 0);
+            continue;
+        }
+        stream_queue->p_streamed[(*p_streamed_count)++] = read->request;
+    }
+}
+
+static VriBool stream_request_before(const VriStreamRequest *a, const VriStreamRequest *b) {
+    return a->desc.priority > b->desc.priority || (a->desc.priority == b->desc.priority && a->id < b->id);
+}
+
+static void stream_heap_push(VriStreamQueue stream_queue, const VriStreamRequest *request) {
+    VriStreamRequest *heap = stream_queue->p_pending;
+    uint32_t          index = stream_queue->pending_count++;
+
+    while (index) {
+        uint32_t parent = (index - 1) / 2;
+        if (!stream_request_before(request, &heap[parent])) break;
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = *request;
+}
+
+static void stream_heap_remove(VriStreamQueue stream_queue, uint32_t index) {
+    VriStreamRequest *heap = stream_queue->p_pending;
+    VriStreamRequest  last = heap[--stream_queue->pending_count];
+    uint32_t          count = stream_queue->pending_count;
+    if (index == count) return;
+
+    // The last request takes the hole, then moves up or down to where it belongs
+    while (index) {
+        uint32_t parent = (index - 1) / 2;
+        if (!stream_request_before(&last, &heap[parent])) break;
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    for (;;) {
+        uint32_t child = index * 2 + 1;
+        if (child >= count) break;
+        if (child + 1 < count && stream_request_before(&heap[child + 1], &heap[child])) child++;
+        if (!stream_request_before(&heap[child], &last)) break;
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = last;
+}
+
+static void stream_notify(const VriStreamRequest *request, VriStreamStatus status, uint64_t fence_value) {
+    if (request->desc.pfn_callback) {
+        request->desc.pfn_callback(request->desc.p_user_data, status, fence_value);
+    }
+}
@@ -0,0 +1,76 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "vri_internal.h"
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <pthread.h>
+#    include <unistd.h>
+#endif
+
+// Short-lived worker threads for the few CPU-heavy jobs the library splits up,
+// pipeline warm-up and mip generation. Nothing is pooled: the threads live for
+// one call, which is long enough that starting them doesn't show.
+
+typedef struct {
+    PFN_VriThreadRun pfn_run;
+    void            *p_user_data;
+} ThreadStart;
+
+#if defined(_WIN32)
+static DWORD WINAPI thread_main(LPVOID p_start) {
+    const ThreadStart *start = p_start;
+    start->pfn_run(start->p_user_data);
+    return 0;
+}
+#else
+static void *thread_main(void *p_start) {
+    const ThreadStart *start = p_start;
+    start->pfn_run(start->p_user_data);
+    return NULL;
+}
+#endif
+
+void vri_threads_run(uint32_t thread_count, PFN_VriThreadRun pfn_run, void *p_user_data) {
+    ThreadStart start = {pfn_run, p_user_data};
+    thread_count = VRI_MIN(thread_count, VRI_MAX_WORKER_THREADS);
+
+    // The calling thread is one of the workers, threads that fail to start leave their share to the others
+#if defined(_WIN32)
+    HANDLE   threads[VRI_MAX_WORKER_THREADS];
+    uint32_t started = 0;
+    for (uint32_t i = 1; i < thread_count; ++i) {
+        HANDLE thread = CreateThread(NULL, 0, thread_main, &start, 0, NULL);
+        if (thread) threads[started++] = thread;
+    }
+    pfn_run(p_user_data);
+    for (uint32_t i = 0; i < started; ++i) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+#else
+    pthread_t threads[VRI_MAX_WORKER_THREADS];
+    uint32_t  started = 0;
+    for (uint32_t i = 1; i < thread_count; ++i) {
+        if (pthread_create(&threads[started], NULL, thread_main, &start) == 0) started++;
+    }
+    pfn_run(p_user_data);
+    for (uint32_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+#endif
+}
+
+uint32_t vri_cpu_count(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+#endif
+}
@@ -0,0 +1,162 @@
+#include "vri/vri.h"
+#include "vri_internal.h"
+
+// Batched texture uploads. Updates are recorded into one of a few command
+// buffers, which is submitted once it holds batch_size bytes or on a flush.
+// Every submit signals the next value of one fence, so reusing a batch only
+// has to wait for the value its own last submit signaled.
+
+#define UPLOAD_QUEUE_DEFAULT_BATCH_COUNT 2
+
+static VriResult upload_queue_begin_batch(VriUploadQueue upload_queue);
+
+VriResult vri_upload_queue_create(VriDevice device, const VriUploadQueueDesc *p_desc, VriUploadQueue *p_upload_queue) {
+    VriDebugCallback dbg = device->debug_callback;
+
+    uint32_t batch_count = p_desc->batch_count ? p_desc->batch_count : UPLOAD_QUEUE_DEFAULT_BATCH_COUNT;
+    if (!p_desc->queue || batch_count > VRI_UPLOAD_QUEUE_MAX_BATCHES) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Upload queue needs a queue and at most VRI_UPLOAD_QUEUE_MAX_BATCHES batches");
+        return VRI_ERROR_INVALID_API_USAGE;
+    }
+
+    VriUploadQueue upload_queue = vri_object_allocate(device, &device->allocation_callback, sizeof(struct VriUploadQueue_T), VRI_OBJECT_TYPE_UPLOAD_QUEUE);
+    if (!upload_queue) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Couldn't allocate memory for Upload Queue struct");
+        return VRI_ERROR_OUT_OF_MEMORY;
+    }
+
+#if VRI_ENABLE_OBJECT_TRACKING
+    upload_queue->base.p_create_site = VRI_RETURN_ADDRESS();
+#endif
+    upload_queue->queue = p_desc->queue;
+    upload_queue->batch_size = p_desc->batch_size ? p_desc->batch_size : VRI_UPLOAD_QUEUE_DEFAULT_BATCH_SIZE;
+    upload_queue->batch_count = batch_count;
+
+    VriCommandPoolDesc pool_desc = {
+        .queue_type = p_desc->queue->type,
+        .flags = VRI_COMMAND_POOL_FLAG_BIT_RESET_COMMAND_BUFFER,
+    };
+    VriResult result = vri_command_pool_create(device, &pool_desc, &upload_queue->command_pool);
+
+    VriCommandBuffer command_buffers[VRI_UPLOAD_QUEUE_MAX_BATCHES] = {0};
+    if (VRI_OK(result)) {
+        VriCommandBufferAllocateDesc allocate_desc = {
+            .command_pool = upload_queue->command_pool,
+            .command_buffer_count = batch_count,
+        };
+        result = vri_command_buffers_allocate(device, &allocate_desc, command_buffers);
+    }
+    if (VRI_OK(result)) {
+        for (uint32_t i = 0; i < batch_count; ++i) {
+            upload_queue->batches[i].command_buffer = command_buffers[i];
+        }
+        result = vri_fence_create(device, 0, &upload_queue->fence);
+    }
+    if (VRI_ERROR(result)) {
+        dbg.pfn_message_callback(VRI_MESSAGE_SEVERITY_ERROR, "Failed to create the Upload Queue's command buffers and fence");
+        vri_upload_queue_destroy(device, upload_queue);
+        return result;
+    }
+
+    *p_upload_queue = upload_queue;
+    return VRI_SUCCESS;
+}
+
+void vri_upload_queue_destroy(VriDevice device, VriUploadQueue upload_queue) {
+    if (!upload_queue) return;
+
+    if (upload_queue->fence) {
+        uint64_t value = upload_queue->fence_value;
+        vri_fences_wait(device, &upload_queue->fence, &value, 1, VRI_TRUE, UINT64_MAX);
+        vri_fence_destroy(device, upload_queue->fence);
+    }
+
+    if (upload_queue->command_pool) {
+        for (uint32_t i = 0; i < upload_queue->batch_count; ++i) {
+            VriCommandBuffer command_buffer = upload_queue->batches[i].command_buffer;
+            if (!command_buffer) continue;
+
+            // A batch that was never flushed is ended so its backend state is released like the rest
+            if (upload_queue->recording && i == upload_queue->batch_index) {
+                vri_command_buffer_end(command_buffer);
+            }
+            vri_command_buffer_reset(command_buffer);
+            vri_command_buffers_free(device, upload_queue->command_pool, 1, &command_buffer);
+        }
+        vri_command_pool_destroy(device, upload_queue->command_pool);
+    }
+
+    vri_object_free(device, &device->allocation_callback, upload_queue, sizeof(struct VriUploadQueue_T));
+}
+
+VriResult vri_upload_queue_update_texture(VriUploadQueue upload_queue, VriTexture texture, const VriTextureUpdateDesc *p_desc) {
+    if (!upload_queue->recording) {
+        VriResult result = upload_queue_begin_batch(upload_queue);
+        if (VRI_ERROR(result)) return result;
+    }
+
+    vri_cmd_update_texture(upload_queue->batches[upload_queue->batch_index].command_buffer, texture, p_desc);
+
+    // The command buffer keeps its own copy of the data, so that's what a batch is measured in
+    upload_queue->recorded_bytes += (uint64_t)p_desc->data.slice_pitch * p_desc->depth;
+    if (upload_queue->recorded_bytes >= upload_queue->batch_size) {
+        return vri_upload_queue_flush(upload_queue, NULL);
+    }
+    return VRI_SUCCESS;
+}
+
+VriResult vri_upload_queue_flush(VriUploadQueue upload_queue, uint64_t *p_fence_value) {
+    if (upload_queue->recording) {
+        VriUploadBatch *batch = &upload_queue->batches[upload_queue->batch_index];
+
+        upload_queue->recording = VRI_FALSE;
+        VriResult result = vri_command_buffer_end(batch->command_buffer);
+        if (VRI_ERROR(result)) return result;
+
+        VriFenceSignalDesc signal = {
+            .fence = upload_queue->fence,
+            .value = upload_queue->fence_value + 1,
+        };
+        VriQueueSubmitDesc submit = {
+            .p_command_buffers = &batch->command_buffer,
+            .command_buffer_count = 1,
+            .p_fences_signal = &signal,
+            .fence_signal_count = 1,
+        };
+        result = vri_queue_submit(upload_queue->queue, &submit, 1);
+        if (VRI_ERROR(result)) return result;
+
+        upload_queue->fence_value = signal.value;
+        batch->fence_value = signal.value;
+        upload_queue->batch_index = (upload_queue->batch_index + 1) % upload_queue->batch_count;
+        upload_queue->recorded_bytes = 0;
+    }
+
+    if (p_fence_value) *p_fence_value = upload_queue->fence_value;
+    return VRI_SUCCESS;
+}
+
+VriFence vri_upload_queue_get_fence(VriUploadQueue upload_queue) {
+    return upload_queue->fence;
+}
+
+static VriResult upload_queue_begin_batch(VriUploadQueue upload_queue) {
+    VriDevice       device = upload_queue->base.p_device;
+    VriUploadBatch *batch = &upload_queue->batches[upload_queue->batch_index];
+
+    // Only blocks once every batch is in flight
+    if (batch->fence_value) {
+        VriResult result = vri_fences_wait(device, &upload_queue->fence, &batch->fence_value, 1, VRI_TRUE, UINT64_MAX);
+        if (VRI_ERROR(result)) return result;
+
+        result = vri_command_buffer_reset(batch->command_buffer);
+        if (VRI_ERROR(result)) return result;
+    }
+
+    VriCommandBufferBeginDesc begin_desc = {.usage = VRI_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    VriResult                 result = vri_command_buffer_begin(batch->command_buffer, &begin_desc);
+    if (VRI_ERROR(result)) return result;
+
+    upload_queue->recording = VRI_TRUE;
+    return VRI_SUCCESS;
+}
@@ -0,0 +1,255 @@
+#include "test_util.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// BC conversion: encode then decode stays within an error bound per format,
+// SNORM keeps its sign, and hand-built BC6H and BC7 blocks decode to the
+// values the format's description gives them.
+
+#define SIZE 64 // Texels per side of the test images, 16 x 16 blocks
+
+typedef struct {
+    double rms;
+    int    max;
+} Error;
+
+static uint8_t texels[SIZE * SIZE * 4];
+static uint8_t decoded[SIZE * SIZE * 8];
+static uint8_t blocks[SIZE / 4 * SIZE / 4 * 16];
+
+// Smooth gradients in every channel with a little noise on top, the kind of content range fits are meant for
+static void fill_texels(uint32_t seed) {
+    for (uint32_t y = 0; y < SIZE; ++y) {
+        for (uint32_t x = 0; x < SIZE; ++x) {
+            uint8_t *p_texel = &texels[(y * SIZE + x) * 4];
+            for (uint32_t c = 0; c < 4; ++c) {
+                seed = seed * 1664525u + 1013904223u;
+                int32_t value = (int32_t)((x * (c + 1) + y * (4 - c)) * 255 / (SIZE * 5)) + (int32_t)(seed >> 29) - 4;
+                p_texel[c] = (uint8_t)VRI_MIN(VRI_MAX(value, 0), 255);
+            }
+        }
+    }
+}
+
+static VriBlockConvertDesc convert_desc(VriFormat format, uint32_t width, uint32_t height, VriBool encode) {
+    uint32_t block_row_pitch = (width + 3) / 4 * vri_format_get_info(format)->block_size;
+    return (VriBlockConvertDesc){
+        .format = format,
+        .width = width,
+        .height = height,
+        .p_src = encode ? (const void *)texels : blocks,
+        .src_row_pitch = encode ? width * 4 : block_row_pitch,
+        .p_dst = encode ? (void *)blocks : decoded,
+        .dst_row_pitch = encode ? block_row_pitch : width * 4,
+    };
+}
+
+static Error round_trip(VriFormat format, uint32_t channel_count, VriBool snorm) {
+    VriBlockConvertDesc encode = convert_desc(format, SIZE, SIZE, VRI_TRUE);
+    VriBlockConvertDesc decode = convert_desc(format, SIZE, SIZE, VRI_FALSE);
+    TEST_CHECK_RESULT(vri_bc_encode(&encode));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+
+    Error  error = {0.0, 0};
+    double sum = 0.0;
+    for (uint32_t i = 0; i < SIZE * SIZE; ++i) {
+        for (uint32_t c = 0; c < channel_count; ++c) {
+            int32_t expected = snorm ? VRI_MAX((int8_t)texels[i * 4 + c], -127) : texels[i * 4 + c];
+            int32_t actual = snorm ? (int8_t)decoded[i * 4 + c] : decoded[i * 4 + c];
+            int32_t difference = abs(actual - expected);
+            error.max = VRI_MAX(error.max, difference);
+            sum += (double)difference * difference;
+        }
+    }
+    error.rms = sqrt(sum / (SIZE * SIZE * channel_count));
+    return error;
+}
+
+static void test_round_trips(void) {
+    fill_texels(1);
+
+    Error bc1 = round_trip(VRI_FORMAT_BC1_UNORM, 3, VRI_FALSE);
+    TEST_CHECK(bc1.rms < 4.0 && bc1.max <= 16);
+    Error bc3 = round_trip(VRI_FORMAT_BC3_SRGB, 4, VRI_FALSE);
+    TEST_CHECK(bc3.rms < 4.0 && bc3.max <= 16);
+    Error bc4 = round_trip(VRI_FORMAT_BC4_UNORM, 1, VRI_FALSE);
+    TEST_CHECK(bc4.rms < 1.0 && bc4.max <= 2);
+    Error bc5 = round_trip(VRI_FORMAT_BC5_UNORM, 2, VRI_FALSE);
+    TEST_CHECK(bc5.rms < 1.0 && bc5.max <= 2);
+    Error bc7 = round_trip(VRI_FORMAT_BC7_UNORM, 4, VRI_FALSE);
+    TEST_CHECK(bc7.rms < 3.0 && bc7.max <= 12);
+
+    // The same gradients shifted down to -128..127, so blocks straddle zero and -128
+    for (uint32_t i = 0; i < SIZE * SIZE * 4; ++i) {
+        texels[i] = (uint8_t)(texels[i] ^ 0x80);
+    }
+    Error bc4_snorm = round_trip(VRI_FORMAT_BC4_SNORM, 1, VRI_TRUE);
+    TEST_CHECK(bc4_snorm.rms < 1.0 && bc4_snorm.max <= 2);
+    Error bc5_snorm = round_trip(VRI_FORMAT_BC5_SNORM, 2, VRI_TRUE);
+    TEST_CHECK(bc5_snorm.rms < 1.0 && bc5_snorm.max <= 2);
+    TEST_CHECK(decoded[3] == 127 && decoded[2] == 0);
+}
+
+// A flat block is a single palette color, exact for BC4 and within a p-bit for BC7
+static void test_flat_blocks(void) {
+    for (uint32_t i = 0; i < 16; ++i) {
+        texels[i * 4 + 0] = 200;
+        texels[i * 4 + 1] = 0x80; // -128
+        texels[i * 4 + 2] = 33;
+        texels[i * 4 + 3] = 77;
+    }
+
+    VriBlockConvertDesc encode = convert_desc(VRI_FORMAT_BC5_SNORM, 4, 4, VRI_TRUE);
+    VriBlockConvertDesc decode = convert_desc(VRI_FORMAT_BC5_SNORM, 4, 4, VRI_FALSE);
+    TEST_CHECK_RESULT(vri_bc_encode(&encode));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+    for (uint32_t i = 0; i < 16; ++i) {
+        TEST_CHECK((int8_t)decoded[i * 4] == (int8_t)200 && (int8_t)decoded[i * 4 + 1] == -127);
+    }
+
+    encode.format = decode.format = VRI_FORMAT_BC7_SRGB;
+    TEST_CHECK_RESULT(vri_bc_encode(&encode));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+    for (uint32_t i = 0; i < 16 * 4; ++i) {
+        TEST_CHECK(abs(decoded[i] - texels[i]) <= 1);
+    }
+}
+
+static void write_bits(uint8_t *p_block, uint32_t *p_offset, uint32_t value, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i, ++*p_offset) {
+        p_block[*p_offset / 8] = (uint8_t)(p_block[*p_offset / 8] | ((value >> i) & 1) << (*p_offset % 8));
+    }
+}
+
+// Every endpoint of every subset at one color decodes to that color whatever
+// the partition and indices, for each of the eight BC7 modes
+static void test_bc7_modes(void) {
+    // Subsets, partition bits, rotation and index selection bits, color and alpha bits, p-bits per endpoint or per subset, index bits
+    static const uint8_t modes[8][9] = {
+        {3, 4, 0, 4, 0, 1, 0, 3, 0}, {2, 6, 0, 6, 0, 0, 1, 3, 0}, {3, 6, 0, 5, 0, 0, 0, 2, 0}, {2, 6, 0, 7, 0, 1, 0, 2, 0},
+        {1, 0, 3, 5, 6, 0, 0, 2, 3}, {1, 0, 2, 7, 8, 0, 0, 2, 2}, {1, 0, 0, 7, 7, 1, 0, 4, 0}, {2, 6, 0, 5, 5, 1, 0, 2, 0},
+    };
+    uint32_t seed = 7;
+    for (uint32_t m = 0; m < 8; ++m) {
+        const uint8_t *mode = modes[m];
+        uint8_t        block[16] = {0};
+        uint32_t       offset = 0;
+        seed = seed * 1664525u + 1013904223u;
+
+        // All ones in every endpoint bit and p-bit is white, green gets all ones but its top bit
+        write_bits(block, &offset, 1u << m, m + 1);
+        write_bits(block, &offset, seed >> 16, mode[1]);
+        write_bits(block, &offset, 0, mode[2]);
+        uint32_t endpoint_count = mode[0] * 2u;
+        for (uint32_t c = 0; c < 4; ++c) {
+            uint32_t bits = c < 3 ? mode[3] : mode[4];
+            for (uint32_t e = 0; e < endpoint_count; ++e) {
+                write_bits(block, &offset, c == 1 ? (1u << (bits - 1)) - 1 : (1u << bits) - 1, bits);
+            }
+        }
+        uint32_t pbit_count = mode[5] ? endpoint_count : mode[6] ? mode[0] : 0;
+        write_bits(block, &offset, (1u << pbit_count) - 1, pbit_count);
+        while (offset < 128) {
+            seed = seed * 1664525u + 1013904223u;
+            write_bits(block, &offset, seed >> 31, 1);
+        }
+
+        // Green's 0111..1, with its p-bit where the mode has them, expanded to eight bits
+        static const uint8_t greens[8] = {0x7B, 0x7E, 0x7B, 0x7F, 0x7B, 0x7E, 0x7F, 0x7D};
+        uint8_t              green = greens[m];
+        memcpy(blocks, block, sizeof(block));
+        VriBlockConvertDesc decode = convert_desc(VRI_FORMAT_BC7_UNORM, 4, 4, VRI_FALSE);
+        TEST_CHECK_RESULT(vri_bc_decode(&decode));
+        for (uint32_t i = 0; i < 16; ++i) {
+            TEST_CHECK(decoded[i * 4] == 255 && decoded[i * 4 + 1] == green && decoded[i * 4 + 2] == 255 && decoded[i * 4 + 3] == 255);
+        }
+    }
+}
+
+static uint16_t decoded_half(uint32_t texel, uint32_t channel) {
+    uint16_t value;
+    memcpy(&value, &decoded[(texel * 4 + channel) * 2], sizeof(value));
+    return value;
+}
+
+// The ends of the endpoint range decode to the largest finite halves, in the
+// single region mode and in a two region mode with delta endpoints
+static void test_bc6h(void) {
+    VriBlockConvertDesc decode = convert_desc(VRI_FORMAT_BC6H_UFLOAT, 4, 4, VRI_FALSE);
+    decode.dst_row_pitch = 4 * 8;
+
+    // Mode 11: ten bit endpoints, w at 0 and x at 1023, texel 0 index 0 and every other texel 15
+    uint8_t  block[16] = {0};
+    uint32_t offset = 0;
+    write_bits(block, &offset, 3, 5);
+    write_bits(block, &offset, 0, 30);
+    for (uint32_t c = 0; c < 3; ++c) {
+        write_bits(block, &offset, 1023, 10);
+    }
+    write_bits(block, &offset, 0, 3);
+    for (uint32_t i = 1; i < 16; ++i) {
+        write_bits(block, &offset, 15, 4);
+    }
+    memcpy(blocks, block, sizeof(block));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+    for (uint32_t c = 0; c < 3; ++c) {
+        TEST_CHECK(decoded_half(0, c) == 0);
+        TEST_CHECK(decoded_half(5, c) == 0x7BFF);
+    }
+    TEST_CHECK(decoded_half(5, 3) == 0x3C00);
+
+    // SFLOAT reads 0x201 as -511, which saturates to the most negative half
+    decode.format = VRI_FORMAT_BC6H_SFLOAT;
+    memset(block, 0, sizeof(block));
+    offset = 0;
+    write_bits(block, &offset, 3, 5);
+    for (uint32_t c = 0; c < 3; ++c) {
+        write_bits(block, &offset, 0x201, 10);
+    }
+    memcpy(blocks, block, sizeof(block));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+    TEST_CHECK(decoded_half(9, 0) == 0xFBFF && decoded_half(9, 2) == 0xFBFF);
+
+    // Mode 1: w at 1023 and zero deltas, so every endpoint of both regions is the maximum
+    decode.format = VRI_FORMAT_BC6H_UFLOAT;
+    uint32_t seed = 3;
+    memset(block, 0, sizeof(block));
+    offset = 0;
+    write_bits(block, &offset, 0, 5);
+    for (uint32_t c = 0; c < 3; ++c) {
+        write_bits(block, &offset, 1023, 10);
+    }
+    offset = 77;
+    while (offset < 128) {
+        seed = seed * 1664525u + 1013904223u;
+        write_bits(block, &offset, seed >> 31, 1);
+    }
+    memcpy(blocks, block, sizeof(block));
+    TEST_CHECK_RESULT(vri_bc_decode(&decode));
+    for (uint32_t i = 0; i < 16; ++i) {
+        TEST_CHECK(decoded_half(i, 0) == 0x7BFF && decoded_half(i, 1) == 0x7BFF && decoded_half(i, 2) == 0x7BFF);
+    }
+}
+
+static void test_unsupported(void) {
+    VriBlockConvertDesc desc = convert_desc(VRI_FORMAT_BC2_UNORM, 4, 4, VRI_TRUE);
+    TEST_CHECK(vri_bc_encode(&desc) == VRI_ERROR_UNSUPPORTED);
+    desc.format = VRI_FORMAT_BC6H_UFLOAT;
+    TEST_CHECK(vri_bc_encode(&desc) == VRI_ERROR_UNSUPPORTED);
+    desc.format = VRI_FORMAT_R8G8B8A8_UNORM;
+    TEST_CHECK(vri_bc_decode(&desc) == VRI_ERROR_UNSUPPORTED);
+    desc.format = VRI_FORMAT_BC1_UNORM;
+    desc.width = 0;
+    TEST_CHECK(vri_bc_encode(&desc) == VRI_ERROR_INVALID_API_USAGE);
+}
+
+int main(void) {
+    test_round_trips();
+    test_flat_blocks();
+    test_bc7_modes();
+    test_bc6h();
+    test_unsupported();
+    return test_finish("test_bc");
+}
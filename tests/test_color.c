@@ -0,0 +1,130 @@
+#include "test_util.h"
+
+#include <math.h>
+#include <string.h>
+
+// Color conversion: the curves hit their reference points, linear light
+// survives a round trip through every curve and gamut, and 8-bit sRGB codes
+// come back exactly.
+
+#define COUNT 256
+
+static VriResult convert(VriFormat src_format, VriColorSpace src_color_space, const void *p_src, VriFormat dst_format, VriColorSpace dst_color_space, void *p_dst) {
+    VriColorConvertDesc desc = {
+        .src_format = src_format,
+        .src_color_space = src_color_space,
+        .dst_format = dst_format,
+        .dst_color_space = dst_color_space,
+        .width = COUNT,
+        .height = 1,
+        .p_src = p_src,
+        .src_row_pitch = COUNT * vri_format_get_info(src_format)->block_size,
+        .p_dst = p_dst,
+        .dst_row_pitch = COUNT * vri_format_get_info(dst_format)->block_size,
+    };
+    return vri_color_convert(&desc);
+}
+
+// Converts one linear sRGB texel and returns the encoded red channel
+static float encode_one(VriColorSpace color_space, float value) {
+    static float src[COUNT * 4], dst[COUNT * 4];
+    for (uint32_t i = 0; i < COUNT * 4; ++i) {
+        src[i] = value;
+    }
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, src, VRI_FORMAT_R32G32B32A32_FLOAT, color_space, dst));
+    return dst[0];
+}
+
+// Gray keeps its value across gamuts, so these are the curves alone
+static void test_reference_points(void) {
+    TEST_CHECK(fabsf(encode_one(VRI_COLORSPACE_SRGB_NONLINEAR, 0.5f) - 0.735357f) < 1e-4f);
+    TEST_CHECK(fabsf(encode_one(VRI_COLORSPACE_SRGB_NONLINEAR, 0.002f) - 0.002f * 12.92f) < 1e-5f);
+    TEST_CHECK(fabsf(encode_one(VRI_COLORSPACE_SRGB_NONLINEAR, 1.0f) - 1.0f) < 1e-5f);
+
+    // Reference white is 203 nits, 58% PQ, and a 75% HLG signal
+    TEST_CHECK(fabsf(encode_one(VRI_COLORSPACE_HDR10_ST2084, 1.0f) - 0.5806f) < 1e-3f);
+    TEST_CHECK(fabsf(encode_one(VRI_COLORSPACE_HDR10_HLG, 1.0f) - 0.75f) < 1e-4f);
+    TEST_CHECK(encode_one(VRI_COLORSPACE_HDR10_ST2084, 0.0f) < 1e-4f);
+    TEST_CHECK(encode_one(VRI_COLORSPACE_HDR10_HLG, 0.0f) < 1e-4f);
+}
+
+// In-gamut linear colors up to well above reference white, through each
+// curve and back, with alpha carried along untouched
+static void test_round_trip(void) {
+    static const VriColorSpace color_spaces[] = {
+        VRI_COLORSPACE_SRGB_NONLINEAR,
+        VRI_COLORSPACE_BT709_NONLINEAR,
+        VRI_COLORSPACE_P3_NONLINEAR,
+        VRI_COLORSPACE_BT2020_NONLINEAR,
+        VRI_COLORSPACE_HDR10_ST2084,
+        VRI_COLORSPACE_HDR10_HLG,
+    };
+    static float src[COUNT * 4], encoded[COUNT * 4], decoded[COUNT * 4];
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        src[i * 4 + 0] = (float)i / (COUNT - 1);
+        src[i * 4 + 1] = (float)((i * 7) % COUNT) / (COUNT - 1);
+        src[i * 4 + 2] = (float)((i * 13) % COUNT) / (COUNT - 1);
+        src[i * 4 + 3] = (float)(COUNT - 1 - i) / (COUNT - 1);
+    }
+
+    for (uint32_t c = 0; c < sizeof(color_spaces) / sizeof(color_spaces[0]); ++c) {
+        TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, src, VRI_FORMAT_R32G32B32A32_FLOAT, color_spaces[c], encoded));
+        TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, color_spaces[c], encoded, VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, decoded));
+
+        float max_error = 0.0f;
+        for (uint32_t i = 0; i < COUNT * 4; ++i) {
+            max_error = fmaxf(max_error, fabsf(decoded[i] - src[i]));
+        }
+        TEST_CHECK(max_error < 1e-3f);
+        for (uint32_t i = 0; i < COUNT; ++i) {
+            TEST_CHECK(encoded[i * 4 + 3] == src[i * 4 + 3]);
+        }
+    }
+
+    // HDR10 has room above reference white, PQ up to its 10000 nit peak
+    for (uint32_t i = 0; i < COUNT * 4; ++i) {
+        src[i] = (float)(i % COUNT) / (COUNT - 1) * 40.0f;
+    }
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, src, VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_HDR10_ST2084, encoded));
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_HDR10_ST2084, encoded, VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, decoded));
+    for (uint32_t i = 0; i < COUNT * 4; ++i) {
+        TEST_CHECK(fabsf(decoded[i] - src[i]) <= 1e-3f * fmaxf(src[i], 1.0f));
+    }
+}
+
+// Every 8-bit sRGB code decodes to linear and encodes back to itself, also
+// when the conversion runs in place
+static void test_srgb8_exact(void) {
+    static uint8_t src[COUNT * 4], dst[COUNT * 4];
+    static float   linear[COUNT * 4];
+    for (uint32_t i = 0; i < COUNT * 4; ++i) {
+        src[i] = (uint8_t)(i / 4);
+    }
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R8G8B8A8_SRGB, VRI_COLORSPACE_SRGB_NONLINEAR, src, VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, linear));
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_COLORSPACE_SRGB_LINEAR, linear, VRI_FORMAT_R8G8B8A8_SRGB, VRI_COLORSPACE_SRGB_NONLINEAR, dst));
+    TEST_CHECK(memcmp(src, dst, sizeof(src)) == 0);
+    TEST_CHECK(fabsf(linear[128 * 4] - 0.215861f) < 1e-4f);
+
+    // In place, RGBA to BGRA swaps red and blue and nothing else
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        dst[i * 4 + 2] = (uint8_t)~dst[i * 4 + 2];
+    }
+    TEST_CHECK_RESULT(convert(VRI_FORMAT_R8G8B8A8_SRGB, VRI_COLORSPACE_SRGB_NONLINEAR, dst, VRI_FORMAT_B8G8R8A8_SRGB, VRI_COLORSPACE_SRGB_NONLINEAR, dst));
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        TEST_CHECK(dst[i * 4 + 0] == (uint8_t)~i && dst[i * 4 + 1] == i && dst[i * 4 + 2] == i && dst[i * 4 + 3] == i);
+    }
+}
+
+static void test_invalid(void) {
+    static uint8_t texels[COUNT * 4];
+    TEST_CHECK(convert(VRI_FORMAT_BC1_UNORM, VRI_COLORSPACE_SRGB_NONLINEAR, texels, VRI_FORMAT_R8G8B8A8_UNORM, VRI_COLORSPACE_SRGB_LINEAR, texels) == VRI_ERROR_UNSUPPORTED);
+    TEST_CHECK(convert(VRI_FORMAT_R8G8B8A8_UNORM, VRI_COLORSPACE_COUNT, texels, VRI_FORMAT_R8G8B8A8_UNORM, VRI_COLORSPACE_SRGB_LINEAR, texels) == VRI_ERROR_INVALID_API_USAGE);
+}
+
+int main(void) {
+    test_reference_points();
+    test_round_trip();
+    test_srgb8_exact();
+    test_invalid();
+    return test_finish("test_color");
+}
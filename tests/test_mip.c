@@ -0,0 +1,127 @@
+#include "test_util.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CPU mip generation: box averages, Kaiser keeps flat images flat, sRGB is
+// filtered in linear space, and threads and row ranges change nothing.
+
+#define SIZE 256
+
+static VriResult generate(VriFormat format, VriMipFilter filter, const void *p_src, uint32_t texel_size, void *p_dst, uint32_t thread_count) {
+    VriMipGenerateDesc desc = {
+        .format = format,
+        .filter = filter,
+        .width = SIZE,
+        .height = SIZE,
+        .p_src = p_src,
+        .src_row_pitch = SIZE * texel_size,
+        .p_dst = p_dst,
+        .dst_row_pitch = SIZE / 2 * texel_size,
+        .thread_count = thread_count,
+    };
+    return vri_mip_generate(&desc);
+}
+
+static void test_box(void) {
+    static uint8_t src[SIZE * SIZE], dst[SIZE / 2 * SIZE / 2];
+    for (uint32_t y = 0; y < SIZE; ++y) {
+        for (uint32_t x = 0; x < SIZE; ++x) {
+            src[y * SIZE + x] = (uint8_t)(10 + (x & 1) * 20 + (y & 1) * 40 + (x / 2 % 4) * 8);
+        }
+    }
+    TEST_CHECK_RESULT(generate(VRI_FORMAT_R8_UNORM, VRI_MIP_FILTER_BOX, src, 1, dst, 0));
+    for (uint32_t i = 0; i < SIZE / 2 * SIZE / 2; ++i) {
+        TEST_CHECK(dst[i] == 40 + (i % (SIZE / 2) % 4) * 8);
+    }
+}
+
+static void test_kaiser_flat(void) {
+    static float src[SIZE * SIZE * 4], dst[SIZE / 2 * SIZE / 2 * 4];
+    for (uint32_t i = 0; i < SIZE * SIZE * 4; ++i) {
+        src[i] = 0.375f;
+    }
+    TEST_CHECK_RESULT(generate(VRI_FORMAT_R32G32B32A32_FLOAT, VRI_MIP_FILTER_KAISER, src, 16, dst, 0));
+    for (uint32_t i = 0; i < SIZE / 2 * SIZE / 2 * 4; ++i) {
+        TEST_CHECK(fabsf(dst[i] - 0.375f) < 1e-5f);
+    }
+}
+
+// Black and white averaged in linear space is 0.5 linear, sRGB code 188, where
+// averaging the codes would give 128. Alpha is linear either way.
+static void test_srgb_linear(void) {
+    static uint8_t src[SIZE * SIZE * 4], dst[SIZE / 2 * SIZE / 2 * 4];
+    for (uint32_t i = 0; i < SIZE * SIZE; ++i) {
+        uint8_t value = (i & 1) ? 255 : 0;
+        memset(&src[i * 4], value, 4);
+    }
+    TEST_CHECK_RESULT(generate(VRI_FORMAT_R8G8B8A8_SRGB, VRI_MIP_FILTER_BOX, src, 4, dst, 0));
+    for (uint32_t i = 0; i < SIZE / 2 * SIZE / 2; ++i) {
+        TEST_CHECK(abs(dst[i * 4] - 188) <= 1 && abs(dst[i * 4 + 2] - 188) <= 1);
+        TEST_CHECK(abs(dst[i * 4 + 3] - 128) <= 1);
+    }
+}
+
+static void test_threads(void) {
+    static uint8_t src[SIZE * SIZE * 4], single[SIZE / 2 * SIZE / 2 * 4], threaded[SIZE / 2 * SIZE / 2 * 4], ranges[SIZE / 2 * SIZE / 2 * 4];
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < SIZE * SIZE * 4; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        src[i] = (uint8_t)(seed >> 24);
+    }
+    TEST_CHECK_RESULT(generate(VRI_FORMAT_R8G8B8A8_SRGB, VRI_MIP_FILTER_KAISER, src, 4, single, 1));
+    TEST_CHECK_RESULT(generate(VRI_FORMAT_R8G8B8A8_SRGB, VRI_MIP_FILTER_KAISER, src, 4, threaded, 4));
+    TEST_CHECK(memcmp(single, threaded, sizeof(single)) == 0);
+
+    // Uneven row ranges, the last one running past the end of the level
+    for (uint32_t first_row = 0; first_row < SIZE / 2; first_row += 37) {
+        VriMipGenerateDesc desc = {
+            .format = VRI_FORMAT_R8G8B8A8_SRGB,
+            .filter = VRI_MIP_FILTER_KAISER,
+            .width = SIZE,
+            .height = SIZE,
+            .p_src = src,
+            .src_row_pitch = SIZE * 4,
+            .p_dst = ranges,
+            .dst_row_pitch = SIZE / 2 * 4,
+            .first_row = first_row,
+            .row_count = 37,
+            .thread_count = 3,
+        };
+        TEST_CHECK_RESULT(vri_mip_generate(&desc));
+    }
+    TEST_CHECK(memcmp(single, ranges, sizeof(single)) == 0);
+}
+
+static void test_invalid(void) {
+    uint8_t texel = 0;
+    VriMipGenerateDesc desc = {
+        .format = VRI_FORMAT_R8_UNORM,
+        .width = 1,
+        .height = 1,
+        .p_src = &texel,
+        .src_row_pitch = 1,
+        .p_dst = &texel,
+        .dst_row_pitch = 1,
+    };
+    TEST_CHECK_RESULT(vri_mip_generate(&desc));
+
+    desc.first_row = 1;
+    TEST_CHECK(vri_mip_generate(&desc) == VRI_ERROR_INVALID_API_USAGE);
+    desc.first_row = 0;
+    desc.filter = VRI_MIP_FILTER_COUNT;
+    TEST_CHECK(vri_mip_generate(&desc) == VRI_ERROR_INVALID_API_USAGE);
+    desc.filter = VRI_MIP_FILTER_BOX;
+    desc.format = VRI_FORMAT_BC1_UNORM;
+    TEST_CHECK(vri_mip_generate(&desc) == VRI_ERROR_UNSUPPORTED);
+}
+
+int main(void) {
+    test_box();
+    test_kaiser_flat();
+    test_srgb_linear();
+    test_threads();
+    test_invalid();
+    return test_finish("test_mip");
+}
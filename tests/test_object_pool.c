@@ -0,0 +1,128 @@
+#include "test_util.h"
+#include "vri_internal.h"
+
+#include <string.h>
+
+// Slot reuse, the quarantine and generations of the per-type object pools,
+// and the validation layer catching a command buffer that outlived what it
+// recorded.
+
+#define SLOT_SIZE 64
+
+static void test_pool_reuse(VriDevice device) {
+    VriObjectPool pool;
+    memset(&pool, 0, sizeof(pool));
+
+    VriObjectBase *first = vri_object_pool_allocate(&pool, &device->allocation_callback, SLOT_SIZE, sizeof(void *));
+    TEST_CHECK(first != NULL);
+    TEST_CHECK(vri_object_pool_owns(&pool, SLOT_SIZE));
+    pool.quarantine = 0; // Tracking builds start quarantined
+
+    first->type = VRI_OBJECT_TYPE_TEXTURE;
+    uint32_t generation = first->generation;
+    vri_object_pool_free(&pool, first);
+    TEST_CHECK(first->type == VRI_OBJECT_TYPE_DESTROYED);
+    TEST_CHECK(first->generation == generation + 1);
+
+    // Without a quarantine the slot just freed comes back first
+    VriObjectBase *second = vri_object_pool_allocate(&pool, &device->allocation_callback, SLOT_SIZE, sizeof(void *));
+    TEST_CHECK(second == first);
+    TEST_CHECK(second->generation == generation + 1);
+
+    // A type has one slot size, anything larger doesn't fit
+    TEST_CHECK(vri_object_pool_allocate(&pool, &device->allocation_callback, pool.slot_size + 1, sizeof(void *)) == NULL);
+    TEST_CHECK(!vri_object_pool_owns(&pool, pool.slot_size + 1));
+
+    vri_object_pool_free(&pool, second);
+
+    // Quarantined slots wait behind fresh ones
+    pool.quarantine = 64;
+    VriObjectBase *quarantined = vri_object_pool_allocate(&pool, &device->allocation_callback, SLOT_SIZE, sizeof(void *));
+    vri_object_pool_free(&pool, quarantined);
+    for (uint32_t i = 0; i < 256; ++i) {
+        VriObjectBase *slot = vri_object_pool_allocate(&pool, &device->allocation_callback, SLOT_SIZE, sizeof(void *));
+        TEST_CHECK(slot != NULL && slot != quarantined);
+    }
+    TEST_CHECK(pool.live_count == 256);
+
+    vri_object_pool_destroy(&pool);
+}
+
+static VriTexture create_texture(VriDevice device) {
+    VriTextureDesc desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = VRI_FORMAT_R8G8B8A8_UNORM,
+        .width = 4,
+        .height = 4,
+        .depth = 1,
+        .usage = VRI_TEXTURE_USAGE_BIT_SHADER_RESOURCE,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+    };
+    VriTexture texture = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_texture_create(device, &desc, &texture));
+    return texture;
+}
+
+static void test_stale_handles(void) {
+#if VRI_SINGLE_BACKEND
+    return; // Single backend builds have no layers to catch stale handles
+#endif
+    VriDevice device = test_device_create(true);
+    VriQueue  queue = VRI_NULL_HANDLE;
+    vri_device_get_queue(device, VRI_QUEUE_TYPE_GRAPHICS, 0, &queue);
+
+    VriCommandPoolDesc pool_desc = {.queue_type = VRI_QUEUE_TYPE_GRAPHICS, .flags = VRI_COMMAND_POOL_FLAG_BIT_RESET_COMMAND_BUFFER};
+    VriCommandPool     command_pool = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_pool_create(device, &pool_desc, &command_pool));
+
+    VriCommandBufferAllocateDesc allocate_desc = {.command_pool = command_pool, .command_buffer_count = 1};
+    VriCommandBuffer             command_buffer = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_buffers_allocate(device, &allocate_desc, &command_buffer));
+
+    uint32_t                  texels[16] = {0};
+    VriTexture                texture = create_texture(device);
+    VriCommandBufferBeginDesc begin_desc = {0};
+    VriTextureUpdateDesc      update = {.width = 4, .height = 4, .depth = 1, .data = {texels, 16, 64}};
+    TEST_CHECK_RESULT(vri_command_buffer_begin(command_buffer, &begin_desc));
+    vri_cmd_update_texture(command_buffer, texture, &update);
+    TEST_CHECK_RESULT(vri_command_buffer_end(command_buffer));
+
+    VriQueueSubmitDesc submit = {.p_command_buffers = &command_buffer, .command_buffer_count = 1};
+    TEST_CHECK_RESULT(vri_queue_submit(queue, &submit, 1));
+    TEST_CHECK(test_take_errors() == 0);
+
+    // The texture's slot isn't handed to the next texture while validation is on
+    vri_texture_destroy(device, texture);
+    VriTexture replacement = create_texture(device);
+    TEST_CHECK(replacement != texture);
+
+    TEST_CHECK(vri_queue_submit(queue, &submit, 1) == VRI_ERROR_INVALID_API_USAGE);
+    TEST_CHECK(test_take_errors() == 1);
+
+    vri_texture_destroy(device, texture);
+    TEST_CHECK(test_take_errors() == 1);
+
+    // Recording again drops what the old recording used
+    TEST_CHECK_RESULT(vri_command_buffer_begin(command_buffer, &begin_desc));
+    vri_cmd_update_texture(command_buffer, replacement, &update);
+    TEST_CHECK_RESULT(vri_command_buffer_end(command_buffer));
+    TEST_CHECK_RESULT(vri_queue_submit(queue, &submit, 1));
+    TEST_CHECK(test_take_errors() == 0);
+
+    vri_queue_wait_idle(queue);
+    vri_texture_destroy(device, replacement);
+    vri_command_buffers_free(device, command_pool, 1, &command_buffer);
+    vri_command_pool_destroy(device, command_pool);
+    vri_device_destroy(device);
+}
+
+int main(void) {
+    VriDevice device = test_device_create(false);
+    test_pool_reuse(device);
+    vri_device_destroy(device);
+
+    test_stale_handles();
+    return test_finish("test_object_pool");
+}
@@ -0,0 +1,102 @@
+#include "test_util.h"
+
+// Linking pipeline libraries shares their state instead of building it again,
+// and a linked pipeline outlives the libraries it was linked from.
+
+static const uint8_t shader_bytecode[64] = {1, 2, 3, 4};
+
+static VriShaderModuleDesc shader_desc = {
+    .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+    .p_bytecode = shader_bytecode,
+    .size = sizeof(shader_bytecode),
+    .p_entry_point = "main",
+};
+
+static VriInputAssemblyDesc input_assembly_desc = {
+    .topology = VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+};
+
+static VriRasterizationStateDesc rasterization_state_desc = {
+    .fill_mode = VRI_FILL_MODE_FILL,
+    .cull_mode = VRI_CULL_MODE_BACK,
+    .front_face = VRI_FRONT_FACE_COUNTER_CLOCKWISE,
+};
+
+static VriMultisampleStateDesc multisample_state_desc = {
+    .sample_mask = 0xFFFFFFFF,
+    .sample_count = 1,
+};
+
+static VriGraphicsPipelineDesc pipeline_desc = {
+    .p_shaders = &shader_desc,
+    .shader_count = 1,
+    .p_input_assembly_state = &input_assembly_desc,
+    .p_rasterization_state = &rasterization_state_desc,
+    .p_multisample_state = &multisample_state_desc,
+};
+
+int main(void) {
+    VriDevice device = test_device_create(true);
+    VriQueue  queue = VRI_NULL_HANDLE;
+    vri_device_get_queue(device, VRI_QUEUE_TYPE_GRAPHICS, 0, &queue);
+
+    const VriPipelineLibraryFlags library_parts[2] = {
+        VRI_PIPELINE_LIBRARY_FLAG_BIT_VERTEX_INPUT | VRI_PIPELINE_LIBRARY_FLAG_BIT_PRE_RASTERIZATION | VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_SHADER,
+        VRI_PIPELINE_LIBRARY_FLAG_BIT_FRAGMENT_OUTPUT,
+    };
+    VriPipelineLibrary libraries[2] = {VRI_NULL_HANDLE};
+    for (uint32_t i = 0; i < 2; ++i) {
+        VriPipelineLibraryDesc library_desc = {.parts = library_parts[i], .p_desc = &pipeline_desc};
+        TEST_CHECK_RESULT(vri_pipeline_library_create(device, &library_desc, &libraries[i]));
+    }
+
+    // Creating builds the state of every part, linking only references the libraries'
+    int64_t     object_allocations = test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT);
+    VriPipeline created = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_pipeline_create_graphics(device, &pipeline_desc, &created));
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) > object_allocations);
+
+    object_allocations = test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT);
+    VriPipelineLinkDesc link_desc = {.p_libraries = libraries, .library_count = 2};
+    VriPipeline         linked = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_pipeline_link(device, &link_desc, &linked));
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == object_allocations);
+
+    // The shared state stays until the last pipeline using it is gone
+    for (uint32_t i = 0; i < 2; ++i) {
+        vri_pipeline_library_destroy(device, libraries[i]);
+    }
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == object_allocations);
+
+    VriCommandPoolDesc pool_desc = {.queue_type = VRI_QUEUE_TYPE_GRAPHICS};
+    VriCommandPool     command_pool = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_pool_create(device, &pool_desc, &command_pool));
+
+    VriCommandBufferAllocateDesc allocate_desc = {.command_pool = command_pool, .command_buffer_count = 1};
+    VriCommandBuffer             command_buffer = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_buffers_allocate(device, &allocate_desc, &command_buffer));
+
+    VriCommandBufferBeginDesc begin_desc = {0};
+    TEST_CHECK_RESULT(vri_command_buffer_begin(command_buffer, &begin_desc));
+    vri_cmd_bind_pipeline(command_buffer, linked);
+    vri_cmd_bind_pipeline(command_buffer, created);
+    TEST_CHECK_RESULT(vri_command_buffer_end(command_buffer));
+
+    VriQueueSubmitDesc submit = {.p_command_buffers = &command_buffer, .command_buffer_count = 1};
+    TEST_CHECK_RESULT(vri_queue_submit(queue, &submit, 1));
+    TEST_CHECK(test_take_errors() == 0);
+
+    vri_command_buffers_free(device, command_pool, 1, &command_buffer);
+    vri_command_pool_destroy(device, command_pool);
+
+    object_allocations = test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT);
+    vri_pipeline_destroy(device, linked);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) < object_allocations);
+    vri_pipeline_destroy(device, created);
+
+    vri_device_destroy(device);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == 0);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_COMMAND) == 0);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_DEVICE) == 0);
+    return test_finish("test_pipeline_library");
+}
@@ -0,0 +1,144 @@
+#include "test_util.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// A recorded manifest parses back into the pipelines it was recorded from:
+// warming it up on a new device turns every create into a warm hit, and the
+// same creates record a byte-identical manifest there. Progress reports come
+// from one thread at a time, only grow, and end at the total.
+
+#define PIPELINE_COUNT 96
+
+static uint8_t shader_bytecode[PIPELINE_COUNT][128];
+
+static VriInputAssemblyDesc      input_assembly_desc = {.topology = VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+static VriRasterizationStateDesc rasterization_state_desc = {.fill_mode = VRI_FILL_MODE_FILL, .cull_mode = VRI_CULL_MODE_BACK};
+static VriMultisampleStateDesc   multisample_state_desc = {.sample_mask = 0xFFFFFFFF, .sample_count = 1};
+
+typedef struct {
+    uint32_t calls;
+    uint32_t last_done;
+    uint32_t inside; // Atomic
+    uint32_t overlaps;
+    uint32_t regressions;
+    uint32_t total;
+} Progress;
+
+static void progress(void *p_user_data, uint32_t done_count, uint32_t total_count) {
+    Progress *p = p_user_data;
+    if (__atomic_fetch_add(&p->inside, 1, __ATOMIC_ACQUIRE)) p->overlaps++;
+
+    if (done_count <= p->last_done) p->regressions++;
+    p->last_done = done_count;
+    p->total = total_count;
+    p->calls++;
+
+    __atomic_fetch_sub(&p->inside, 1, __ATOMIC_RELEASE);
+}
+
+// Every tenth pipeline is a compute pipeline, the others share a fragment shader module
+static void create_pipelines(VriDevice device, VriShaderModule fragment_module) {
+    for (uint32_t i = 0; i < PIPELINE_COUNT; ++i) {
+        VriPipeline pipeline = VRI_NULL_HANDLE;
+        if (i % 10 == 9) {
+            VriShaderModuleDesc    shader = {.stage = VRI_SHADER_STAGE_FLAG_BIT_COMPUTE, .p_bytecode = shader_bytecode[i], .size = 100, .p_entry_point = "cs"};
+            VriComputePipelineDesc desc = {.p_shader = &shader};
+            TEST_CHECK_RESULT(vri_pipeline_create_compute(device, &desc, &pipeline));
+        } else {
+            VriSpecializationConstant constant = {.constant_id = 3, .value = i};
+            VriShaderModuleDesc       shaders[2] = {
+                {.stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX, .p_bytecode = shader_bytecode[i], .size = sizeof(shader_bytecode[i]), .p_entry_point = "vs"},
+                {.stage = VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT, .module = fragment_module, .p_specialization_constants = &constant, .specialization_constant_count = 1},
+            };
+            VriGraphicsPipelineDesc desc = {
+                .p_shaders = shaders,
+                .shader_count = 2,
+                .p_input_assembly_state = &input_assembly_desc,
+                .p_rasterization_state = &rasterization_state_desc,
+                .p_multisample_state = &multisample_state_desc,
+            };
+            TEST_CHECK_RESULT(vri_pipeline_create_graphics(device, &desc, &pipeline));
+        }
+        vri_pipeline_destroy(device, pipeline);
+    }
+}
+
+static VriShaderModule create_fragment_module(VriDevice device) {
+    static const uint8_t bytecode[64] = {9, 8, 7};
+    VriShaderModuleDesc  desc = {.stage = VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT, .p_bytecode = bytecode, .size = sizeof(bytecode), .p_entry_point = "ps"};
+    VriShaderModule      module = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &desc, &module));
+    return module;
+}
+
+// Records a manifest of create_pipelines, run twice to show repeated descs are recorded once
+static void *record(VriDevice device, size_t *p_size) {
+    VriShaderModule     module = create_fragment_module(device);
+    VriPipelineManifest manifest = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_pipeline_manifest_create(device, &manifest));
+
+    create_pipelines(device, module);
+    create_pipelines(device, module);
+
+    TEST_CHECK_RESULT(vri_pipeline_manifest_get_data(manifest, p_size, NULL));
+    void  *p_data = malloc(*p_size);
+    size_t small_size = *p_size - 1;
+    TEST_CHECK(vri_pipeline_manifest_get_data(manifest, &small_size, p_data) == VRI_INCOMPLETE);
+    TEST_CHECK_RESULT(vri_pipeline_manifest_get_data(manifest, p_size, p_data));
+
+    vri_pipeline_manifest_destroy(device, manifest);
+    vri_shader_module_destroy(device, module);
+    return p_data;
+}
+
+int main(void) {
+    for (uint32_t i = 0; i < PIPELINE_COUNT; ++i) {
+        for (uint32_t j = 0; j < sizeof(shader_bytecode[i]); ++j) {
+            shader_bytecode[i][j] = (uint8_t)(i * 31 + j);
+        }
+    }
+
+    VriDevice recording_device = test_device_create(true);
+    size_t    size = 0;
+    void     *p_data = record(recording_device, &size);
+    vri_device_destroy(recording_device);
+    TEST_CHECK(test_take_errors() == 0);
+
+    VriDevice             device = test_device_create(true);
+    Progress              report = {0};
+    VriPipelineWarmUpDesc warm_up_desc = {.p_data = p_data, .size = size, .thread_count = 4, .pfn_progress = progress, .p_user_data = &report};
+    TEST_CHECK_RESULT(vri_pipelines_warm_up(device, &warm_up_desc));
+    TEST_CHECK(report.calls > 0 && report.overlaps == 0 && report.regressions == 0);
+    TEST_CHECK(report.last_done == PIPELINE_COUNT && report.total == PIPELINE_COUNT);
+
+    // Warm pipelines have to be released or taken before warming up again
+    TEST_CHECK(vri_pipelines_warm_up(device, &warm_up_desc) == VRI_ERROR_INVALID_API_USAGE);
+    TEST_CHECK(test_take_errors() == 1);
+
+    // Taken warm pipelines are recorded like created ones, so the manifest comes out the same
+    size_t re_size = 0;
+    void  *p_re_data = record(device, &re_size);
+    TEST_CHECK(re_size == size && memcmp(p_re_data, p_data, size) == 0);
+
+    VriDeviceStatistics statistics;
+    vri_device_get_statistics(device, &statistics);
+    TEST_CHECK(statistics.total.pipeline_warm_hits == PIPELINE_COUNT);
+
+    // Truncated data is refused before anything is created
+    warm_up_desc.size = size - 3;
+    TEST_CHECK(vri_pipelines_warm_up(device, &warm_up_desc) == VRI_ERROR_INVALID_API_USAGE);
+    TEST_CHECK(test_take_errors() == 1);
+
+    // Warm pipelines no create asked for are released, here by the device
+    warm_up_desc.size = size;
+    warm_up_desc.thread_count = 1;
+    TEST_CHECK_RESULT(vri_pipelines_warm_up(device, &warm_up_desc));
+    vri_device_destroy(device);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_DEVICE) == 0);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == 0);
+
+    free(p_re_data);
+    free(p_data);
+    return test_finish("test_pipeline_manifest");
+}
@@ -0,0 +1,132 @@
+#include "test_util.h"
+
+#include <string.h>
+
+// Texture copies land at submit rather than when they're recorded, and a
+// readback ring hands frames back in order, dropping them while it's full.
+
+#define WIDTH  8
+#define HEIGHT 4
+
+static VriTexture create_readback_texture(VriDevice device) {
+    VriTextureDesc desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = VRI_FORMAT_R8G8B8A8_UNORM,
+        .width = WIDTH,
+        .height = HEIGHT,
+        .depth = 1,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+        .memory_type = VRI_MEMORY_TYPE_READBACK,
+    };
+    VriTexture texture = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_texture_create(device, &desc, &texture));
+    return texture;
+}
+
+// Readback textures are the only ones the headless backend keeps texels for, so they stand in for rendered frames
+static void fill(VriDevice device, VriTexture texture, uint8_t value) {
+    VriSubresourceData data;
+    TEST_CHECK_RESULT(vri_texture_map(device, texture, 0, 0, &data));
+    for (uint32_t y = 0; y < HEIGHT; ++y) {
+        memset((uint8_t *)data.p_data + (size_t)y * data.row_pitch, value, WIDTH * 4);
+    }
+    vri_texture_unmap(device, texture, 0, 0);
+}
+
+static uint8_t first_texel(VriDevice device, VriTexture texture) {
+    VriSubresourceData data;
+    TEST_CHECK_RESULT(vri_texture_map(device, texture, 0, 0, &data));
+    uint8_t value = *(const uint8_t *)data.p_data;
+    vri_texture_unmap(device, texture, 0, 0);
+    return value;
+}
+
+static void test_copy_at_submit(VriDevice device, VriQueue queue) {
+    VriTexture src = create_readback_texture(device);
+    VriTexture dst = create_readback_texture(device);
+    fill(device, src, 0x5A);
+
+    VriCommandPoolDesc pool_desc = {.queue_type = VRI_QUEUE_TYPE_GRAPHICS};
+    VriCommandPool     command_pool = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_pool_create(device, &pool_desc, &command_pool));
+
+    VriCommandBufferAllocateDesc allocate_desc = {.command_pool = command_pool, .command_buffer_count = 1};
+    VriCommandBuffer             command_buffer = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_command_buffers_allocate(device, &allocate_desc, &command_buffer));
+
+    VriCommandBufferBeginDesc begin_desc = {0};
+    VriTextureCopyDesc        copy = {.width = WIDTH, .height = HEIGHT, .depth = 1};
+    TEST_CHECK_RESULT(vri_command_buffer_begin(command_buffer, &begin_desc));
+    vri_cmd_copy_texture(command_buffer, src, dst, &copy);
+    TEST_CHECK_RESULT(vri_command_buffer_end(command_buffer));
+    TEST_CHECK(first_texel(device, dst) == 0);
+
+    // The copy reads the source as it is at submit
+    fill(device, src, 0x33);
+    VriQueueSubmitDesc submit = {.p_command_buffers = &command_buffer, .command_buffer_count = 1};
+    TEST_CHECK_RESULT(vri_queue_submit(queue, &submit, 1));
+    TEST_CHECK(first_texel(device, dst) == 0x33);
+
+    vri_command_buffers_free(device, command_pool, 1, &command_buffer);
+    vri_command_pool_destroy(device, command_pool);
+    vri_texture_destroy(device, dst);
+    vri_texture_destroy(device, src);
+}
+
+static void test_ring(VriDevice device, VriQueue queue) {
+    VriReadbackRingDesc desc = {.queue = queue, .width = WIDTH, .height = HEIGHT, .format = VRI_FORMAT_R8G8B8A8_UNORM, .slot_count = 2};
+    VriReadbackRing     ring = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_readback_ring_create(device, &desc, &ring));
+
+    VriReadbackFrame frame;
+    TEST_CHECK(vri_readback_ring_map(ring, &frame) == VRI_INCOMPLETE);
+
+    // Two slots take two frames, the third is dropped instead of waited for
+    VriTexture source = create_readback_texture(device);
+    uint64_t   frame_ids[3] = {0};
+    fill(device, source, 1);
+    TEST_CHECK_RESULT(vri_readback_ring_copy(ring, source, &frame_ids[0]));
+    fill(device, source, 2);
+    TEST_CHECK_RESULT(vri_readback_ring_copy(ring, source, &frame_ids[1]));
+    TEST_CHECK(vri_readback_ring_copy(ring, source, &frame_ids[2]) == VRI_INCOMPLETE);
+    TEST_CHECK(frame_ids[0] && frame_ids[1] == frame_ids[0] + 1);
+
+    // Frames come back oldest first with what the source held when copied
+    VriReadbackFrame first, second;
+    TEST_CHECK_RESULT(vri_readback_ring_map(ring, &first));
+    TEST_CHECK_RESULT(vri_readback_ring_map(ring, &second));
+    TEST_CHECK(first.frame_id == frame_ids[0] && second.frame_id == frame_ids[1]);
+    TEST_CHECK(first.width == WIDTH && first.height == HEIGHT && first.format == VRI_FORMAT_R8G8B8A8_UNORM);
+    TEST_CHECK(*(const uint8_t *)first.data.p_data == 1);
+    TEST_CHECK(*(const uint8_t *)second.data.p_data == 2);
+    TEST_CHECK(vri_readback_ring_map(ring, &frame) == VRI_INCOMPLETE);
+
+    // Unmapping the first frame frees its slot for the next copy
+    TEST_CHECK_RESULT(vri_readback_ring_unmap(ring, first.frame_id));
+    TEST_CHECK(vri_readback_ring_unmap(ring, first.frame_id) == VRI_INCOMPLETE);
+    fill(device, source, 3);
+    TEST_CHECK_RESULT(vri_readback_ring_copy(ring, source, &frame_ids[2]));
+    TEST_CHECK(frame_ids[2] == frame_ids[1] + 1);
+    TEST_CHECK_RESULT(vri_readback_ring_map(ring, &frame));
+    TEST_CHECK(frame.frame_id == frame_ids[2] && *(const uint8_t *)frame.data.p_data == 3);
+
+    TEST_CHECK_RESULT(vri_readback_ring_unmap(ring, second.frame_id));
+    TEST_CHECK_RESULT(vri_readback_ring_unmap(ring, frame.frame_id));
+    vri_readback_ring_destroy(device, ring);
+    vri_texture_destroy(device, source);
+}
+
+int main(void) {
+    VriDevice device = test_device_create(true);
+    VriQueue  queue = VRI_NULL_HANDLE;
+    vri_device_get_queue(device, VRI_QUEUE_TYPE_GRAPHICS, 0, &queue);
+
+    test_copy_at_submit(device, queue);
+    test_ring(device, queue);
+    TEST_CHECK(test_take_errors() == 0);
+
+    vri_device_destroy(device);
+    return test_finish("test_readback");
+}
@@ -0,0 +1,136 @@
+#include "test_util.h"
+#include "vri_internal.h"
+
+#include <string.h>
+
+// Shader modules are shared by stage, entry point and bytecode, hold their own
+// copy of the bytecode, live until their last reference goes, and threads
+// creating the same module at once all end up with the one module.
+
+#define THREAD_COUNT 8
+
+static uint8_t shader_bytecode[64] = {1, 2, 3, 4};
+
+static VriShaderModuleDesc shader_desc = {
+    .stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX,
+    .p_bytecode = shader_bytecode,
+    .size = sizeof(shader_bytecode),
+    .p_entry_point = "main",
+};
+
+static uint64_t reuses(VriDevice device) {
+    VriDeviceStatistics statistics;
+    vri_device_get_statistics(device, &statistics);
+    return statistics.total.shader_module_reuses;
+}
+
+static void test_dedup(VriDevice device) {
+    int64_t  object_allocations = test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT);
+    uint64_t first_reuses = reuses(device);
+
+    VriShaderModule module = VRI_NULL_HANDLE, same = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &shader_desc, &module));
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &shader_desc, &same));
+    TEST_CHECK(module != VRI_NULL_HANDLE && same == module);
+    TEST_CHECK(reuses(device) == first_reuses + 1);
+
+    // The same bytecode from another buffer is the same module, the module has its own copy
+    uint8_t             copy[sizeof(shader_bytecode)];
+    VriShaderModuleDesc copy_desc = shader_desc;
+    memcpy(copy, shader_bytecode, sizeof(copy));
+    copy_desc.p_bytecode = copy;
+    VriShaderModule from_copy = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &copy_desc, &from_copy));
+    TEST_CHECK(from_copy == module);
+
+    // Any difference in stage, entry point or bytecode is another module
+    VriShaderModuleDesc variants[3] = {shader_desc, shader_desc, copy_desc};
+    variants[0].stage = VRI_SHADER_STAGE_FLAG_BIT_FRAGMENT;
+    variants[1].p_entry_point = "main2";
+    copy[sizeof(copy) - 1] ^= 1;
+    VriShaderModule others[3] = {VRI_NULL_HANDLE};
+    for (uint32_t i = 0; i < 3; ++i) {
+        TEST_CHECK_RESULT(vri_shader_module_create(device, &variants[i], &others[i]));
+        TEST_CHECK(others[i] != VRI_NULL_HANDLE && others[i] != module);
+        for (uint32_t j = 0; j < i; ++j) {
+            TEST_CHECK(others[i] != others[j]);
+        }
+    }
+    TEST_CHECK(reuses(device) == first_reuses + 2);
+
+    // Three references to the first module, it stays shared until the last goes
+    vri_shader_module_destroy(device, module);
+    vri_shader_module_destroy(device, same);
+    VriShaderModule again = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &shader_desc, &again));
+    TEST_CHECK(again == module);
+    vri_shader_module_destroy(device, again);
+    vri_shader_module_destroy(device, from_copy);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        vri_shader_module_destroy(device, others[i]);
+    }
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == object_allocations);
+}
+
+// A pipeline keeps what it needs from the module, so the module can go first
+static void test_pipeline_outlives_module(VriDevice device) {
+    VriShaderModule module = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_shader_module_create(device, &shader_desc, &module));
+
+    VriShaderModuleDesc       stage = {.stage = VRI_SHADER_STAGE_FLAG_BIT_VERTEX, .module = module};
+    VriInputAssemblyDesc      input_assembly = {.topology = VRI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+    VriRasterizationStateDesc rasterization = {.fill_mode = VRI_FILL_MODE_FILL, .cull_mode = VRI_CULL_MODE_BACK};
+    VriMultisampleStateDesc   multisample = {.sample_mask = 0xFFFFFFFF, .sample_count = 1};
+
+    VriGraphicsPipelineDesc pipeline_desc = {
+        .p_shaders = &stage,
+        .shader_count = 1,
+        .p_input_assembly_state = &input_assembly,
+        .p_rasterization_state = &rasterization,
+        .p_multisample_state = &multisample,
+    };
+    VriPipeline pipeline = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_pipeline_create_graphics(device, &pipeline_desc, &pipeline));
+
+    vri_shader_module_destroy(device, module);
+    vri_pipeline_destroy(device, pipeline);
+}
+
+typedef struct {
+    VriDevice       device;
+    uint32_t        next_index; // Atomic
+    VriShaderModule modules[VRI_MAX_WORKER_THREADS];
+} CreateJob;
+
+static void create_concurrently(void *p_user_data) {
+    CreateJob *job = p_user_data;
+    uint32_t   index = __atomic_fetch_add(&job->next_index, 1, __ATOMIC_RELAXED);
+    TEST_CHECK_RESULT(vri_shader_module_create(job->device, &shader_desc, &job->modules[index]));
+}
+
+// Whichever thread loses the race drops its copy and takes the winner's module
+static void test_concurrent_create(VriDevice device) {
+    int64_t   object_allocations = test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT);
+    CreateJob job = {.device = device};
+    vri_threads_run(THREAD_COUNT, create_concurrently, &job);
+
+    TEST_CHECK(job.next_index >= 1);
+    for (uint32_t i = 0; i < job.next_index; ++i) {
+        TEST_CHECK(job.modules[i] == job.modules[0]);
+        vri_shader_module_destroy(device, job.modules[i]);
+    }
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == object_allocations);
+}
+
+int main(void) {
+    VriDevice device = test_device_create(true);
+
+    test_dedup(device);
+    test_pipeline_outlives_module(device);
+    test_concurrent_create(device);
+    TEST_CHECK(test_take_errors() == 0);
+
+    vri_device_destroy(device);
+    return test_finish("test_shader_module");
+}
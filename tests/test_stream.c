@@ -0,0 +1,248 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "test_util.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#    include <io.h>
+#endif
+
+// Stream requests are read while process calls come and go, reported once
+// each in priority order with the fence that makes them resident, and a range
+// past the end of the file fails without holding up the rest.
+
+#define SIZE         16
+#define REGION_BYTES (SIZE * 4 * 4) // Four rows of RGBA8
+
+typedef struct {
+    uint32_t        count;
+    VriStreamStatus status[32];
+    uint64_t        fence_value[32];
+    uint32_t        order[32];
+} Outcomes;
+
+typedef struct {
+    Outcomes *p_outcomes;
+    uint32_t  index;
+} Request;
+
+static void on_streamed(void *p_user_data, VriStreamStatus status, uint64_t fence_value) {
+    Request  *request = p_user_data;
+    Outcomes *outcomes = request->p_outcomes;
+    outcomes->status[request->index] = status;
+    outcomes->fence_value[request->index] = fence_value;
+    outcomes->order[outcomes->count++] = request->index;
+}
+
+static intptr_t file_handle(FILE *p_file) {
+#if defined(_WIN32)
+    return (intptr_t)_get_osfhandle(_fileno(p_file));
+#else
+    return fileno(p_file);
+#endif
+}
+
+static VriStreamRequestDesc request_desc(FILE *p_file, VriTexture texture, uint64_t offset, int32_t priority, Request *p_request) {
+    VriStreamRequestDesc desc = {
+        .file = file_handle(p_file),
+        .offset = offset,
+        .texture = texture,
+        .region = {.width = SIZE, .height = 4, .depth = 1, .data = {.row_pitch = SIZE * 4, .slice_pitch = REGION_BYTES}},
+        .priority = priority,
+        .pfn_callback = on_streamed,
+        .p_user_data = p_request,
+    };
+    return desc;
+}
+
+// Processes until nothing is in flight, at most a few thousand calls
+static VriResult process_all(VriStreamQueue stream_queue, uint64_t byte_budget, uint64_t *p_fence_value) {
+    VriResult result = VRI_INCOMPLETE;
+    for (uint32_t i = 0; i < 4096 && result == VRI_INCOMPLETE; ++i) {
+        result = vri_stream_queue_process(stream_queue, byte_budget, p_fence_value);
+    }
+    return result;
+}
+
+// Eight regions through staging room for three, so reads wrap around the
+// staging ring and wait for the ones before them
+static void test_priority_and_wrap(VriDevice device, VriUploadQueue upload_queue, VriTexture texture, FILE *p_file) {
+    VriStreamQueueDesc desc = {.upload_queue = upload_queue, .staging_size = REGION_BYTES * 3, .max_requests = 8};
+    VriStreamQueue     stream_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_stream_queue_create(device, &desc, &stream_queue));
+
+    Outcomes outcomes = {0};
+    Request  requests[8];
+    uint64_t ids[8];
+    for (uint32_t i = 0; i < 8; ++i) {
+        requests[i] = (Request){&outcomes, i};
+        VriStreamRequestDesc request = request_desc(p_file, texture, (uint64_t)i * REGION_BYTES, (int32_t)(i % 4), &requests[i]);
+        TEST_CHECK_RESULT(vri_stream_queue_request(stream_queue, &request, &ids[i]));
+    }
+    TEST_CHECK(ids[1] == ids[0] + 1);
+
+    // A pending request can be cancelled, once
+    TEST_CHECK_RESULT(vri_stream_queue_cancel(stream_queue, ids[5]));
+    TEST_CHECK(vri_stream_queue_cancel(stream_queue, ids[5]) == VRI_INCOMPLETE);
+    TEST_CHECK(outcomes.count == 1 && outcomes.status[5] == VRI_STREAM_STATUS_CANCELLED);
+
+    uint64_t fence_value = 0;
+    TEST_CHECK_RESULT(process_all(stream_queue, UINT64_MAX, &fence_value));
+    TEST_CHECK(outcomes.count == 8);
+    TEST_CHECK(fence_value > 0);
+
+    // Priority 3, 2, 1, 0, equal priorities in request order
+    static const uint32_t expected[7] = {3, 7, 2, 6, 1, 0, 4};
+    for (uint32_t i = 0; i < 7; ++i) {
+        TEST_CHECK(outcomes.order[i + 1] == expected[i]);
+        TEST_CHECK(outcomes.status[expected[i]] == VRI_STREAM_STATUS_SUBMITTED);
+        TEST_CHECK(outcomes.fence_value[expected[i]] > 0 && outcomes.fence_value[expected[i]] <= fence_value);
+    }
+
+    // Resident once the fence gets there
+    VriFence fence = vri_upload_queue_get_fence(upload_queue);
+    TEST_CHECK_RESULT(vri_fences_wait(device, &fence, &fence_value, 1, VRI_TRUE, UINT64_MAX));
+
+    // Nothing left, processing again is a no-op
+    TEST_CHECK_RESULT(vri_stream_queue_process(stream_queue, UINT64_MAX, NULL));
+    TEST_CHECK(outcomes.count == 8);
+    vri_stream_queue_destroy(device, stream_queue);
+}
+
+// A budget of one byte still starts one whole request per call
+static void test_budget(VriDevice device, VriUploadQueue upload_queue, VriTexture texture, FILE *p_file) {
+    VriStreamQueueDesc desc = {.upload_queue = upload_queue};
+    VriStreamQueue     stream_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_stream_queue_create(device, &desc, &stream_queue));
+
+    Outcomes outcomes = {0};
+    Request  requests[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        requests[i] = (Request){&outcomes, i};
+        VriStreamRequestDesc request = request_desc(p_file, texture, (uint64_t)i * REGION_BYTES, 0, &requests[i]);
+        TEST_CHECK_RESULT(vri_stream_queue_request(stream_queue, &request, NULL));
+    }
+
+    uint32_t calls = 0;
+    while (outcomes.count < 3 && calls < 4096) {
+        TEST_CHECK(VRI_OK(vri_stream_queue_process(stream_queue, 1, NULL)));
+        calls++;
+    }
+    TEST_CHECK(outcomes.count == 3 && calls >= 3);
+    TEST_CHECK(outcomes.order[0] == 0 && outcomes.order[1] == 1 && outcomes.order[2] == 2);
+    TEST_CHECK_RESULT(process_all(stream_queue, 1, NULL));
+    vri_stream_queue_destroy(device, stream_queue);
+}
+
+// The file holds eight regions, a ninth fails and the ones around it don't
+static void test_past_end(VriDevice device, VriUploadQueue upload_queue, VriTexture texture, FILE *p_file) {
+    VriStreamQueueDesc desc = {.upload_queue = upload_queue};
+    VriStreamQueue     stream_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_stream_queue_create(device, &desc, &stream_queue));
+
+    Outcomes outcomes = {0};
+    Request  requests[3] = {{&outcomes, 0}, {&outcomes, 1}, {&outcomes, 2}};
+    uint64_t offsets[3] = {0, 8 * REGION_BYTES, 7 * REGION_BYTES + REGION_BYTES / 2};
+    for (uint32_t i = 0; i < 3; ++i) {
+        VriStreamRequestDesc request = request_desc(p_file, texture, offsets[i], 0, &requests[i]);
+        TEST_CHECK_RESULT(vri_stream_queue_request(stream_queue, &request, NULL));
+    }
+
+    TEST_CHECK_RESULT(process_all(stream_queue, UINT64_MAX, NULL));
+    TEST_CHECK(outcomes.count == 3);
+    TEST_CHECK(outcomes.status[0] == VRI_STREAM_STATUS_SUBMITTED);
+    TEST_CHECK(outcomes.status[1] == VRI_STREAM_STATUS_FAILED);
+    TEST_CHECK(outcomes.status[2] == VRI_STREAM_STATUS_FAILED); // Half of it is there
+    vri_stream_queue_destroy(device, stream_queue);
+}
+
+// Destroying cancels what's pending and what's still being read
+static void test_destroy(VriDevice device, VriUploadQueue upload_queue, VriTexture texture, FILE *p_file) {
+    VriStreamQueueDesc desc = {.upload_queue = upload_queue, .staging_size = REGION_BYTES * 2};
+    VriStreamQueue     stream_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_stream_queue_create(device, &desc, &stream_queue));
+
+    Outcomes outcomes = {0};
+    Request  requests[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+        requests[i] = (Request){&outcomes, i};
+        VriStreamRequestDesc request = request_desc(p_file, texture, (uint64_t)i * REGION_BYTES, 0, &requests[i]);
+        TEST_CHECK_RESULT(vri_stream_queue_request(stream_queue, &request, NULL));
+    }
+    TEST_CHECK(VRI_OK(vri_stream_queue_process(stream_queue, UINT64_MAX, NULL)));
+
+    uint32_t reported = outcomes.count;
+    vri_stream_queue_destroy(device, stream_queue);
+    TEST_CHECK(outcomes.count == 4);
+    for (uint32_t i = reported; i < 4; ++i) {
+        TEST_CHECK(outcomes.status[outcomes.order[i]] == VRI_STREAM_STATUS_CANCELLED);
+    }
+}
+
+static void test_invalid(VriDevice device, VriUploadQueue upload_queue, VriTexture texture, FILE *p_file) {
+    VriStreamQueueDesc desc = {.upload_queue = upload_queue, .staging_size = REGION_BYTES / 2};
+    VriStreamQueue     stream_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_stream_queue_create(device, &desc, &stream_queue));
+
+    // Larger than the staging memory
+    Outcomes             outcomes = {0};
+    Request              request = {&outcomes, 0};
+    VriStreamRequestDesc request_too_large = request_desc(p_file, texture, 0, 0, &request);
+    TEST_CHECK(vri_stream_queue_request(stream_queue, &request_too_large, NULL) == VRI_ERROR_INVALID_API_USAGE);
+    TEST_CHECK(test_take_errors() == 1);
+    vri_stream_queue_destroy(device, stream_queue);
+    TEST_CHECK(outcomes.count == 0);
+}
+
+int main(void) {
+    VriDevice device = test_device_create(true);
+    VriQueue  queue = VRI_NULL_HANDLE;
+    vri_device_get_queue(device, VRI_QUEUE_TYPE_GRAPHICS, 0, &queue);
+
+    VriUploadQueueDesc upload_desc = {.queue = queue};
+    VriUploadQueue     upload_queue = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_upload_queue_create(device, &upload_desc, &upload_queue));
+
+    VriTextureDesc texture_desc = {
+        .type = VRI_TEXTURE_TYPE_TEXTURE_2D,
+        .format = VRI_FORMAT_R8G8B8A8_UNORM,
+        .width = SIZE,
+        .height = SIZE,
+        .depth = 1,
+        .usage = VRI_TEXTURE_USAGE_BIT_SHADER_RESOURCE,
+        .sample_count = 1,
+        .mip_count = 1,
+        .layer_count = 1,
+    };
+    VriTexture texture = VRI_NULL_HANDLE;
+    TEST_CHECK_RESULT(vri_texture_create(device, &texture_desc, &texture));
+
+    // Eight regions of distinct bytes
+    FILE *p_file = tmpfile();
+    TEST_CHECK(p_file != NULL);
+    if (p_file) {
+        static uint8_t data[8 * REGION_BYTES];
+        for (uint32_t i = 0; i < sizeof(data); ++i) {
+            data[i] = (uint8_t)(i / REGION_BYTES + 1);
+        }
+        TEST_CHECK(fwrite(data, 1, sizeof(data), p_file) == sizeof(data));
+        TEST_CHECK(fflush(p_file) == 0);
+
+        test_priority_and_wrap(device, upload_queue, texture, p_file);
+        test_budget(device, upload_queue, texture, p_file);
+        test_past_end(device, upload_queue, texture, p_file);
+        test_destroy(device, upload_queue, texture, p_file);
+        test_invalid(device, upload_queue, texture, p_file);
+        fclose(p_file);
+    }
+    TEST_CHECK(test_take_errors() == 0);
+
+    vri_texture_destroy(device, texture);
+    vri_upload_queue_destroy(device, upload_queue);
+    vri_device_destroy(device);
+    TEST_CHECK(test_live_allocations(VRI_ALLOCATION_SCOPE_OBJECT) == 0);
+    return test_finish("test_stream");
+}
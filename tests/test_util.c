@@ -0,0 +1,85 @@
+#include "test_util.h"
+
+#include <stdlib.h>
+
+static uint32_t g_failures;
+static uint32_t g_errors;
+static int64_t  g_live_allocations[VRI_ALLOCATION_SCOPE_DEVICE + 1];
+
+void test_fail(const char *p_file, int line, const char *p_condition) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", p_file, line, p_condition);
+    g_failures++;
+}
+
+static void message_callback(VriMessageSeverity severity, const char *p_message) {
+    if (severity == VRI_MESSAGE_SEVERITY_ERROR) {
+        g_errors++;
+    }
+    (void)p_message;
+}
+
+// The original pointer is kept right in front of the aligned block
+static void *allocate(size_t size, size_t alignment, VriAllocationScope scope) {
+    uint8_t *p_base = malloc(size + alignment + sizeof(void *));
+    if (!p_base) return NULL;
+
+    uintptr_t address = ((uintptr_t)(p_base + sizeof(void *)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    ((void **)address)[-1] = p_base;
+    __atomic_fetch_add(&g_live_allocations[scope], 1, __ATOMIC_RELAXED);
+    return (void *)address;
+}
+
+static void deallocate(void *p_memory, size_t size, size_t alignment, VriAllocationScope scope) {
+    (void)size;
+    (void)alignment;
+    if (!p_memory) return;
+
+    __atomic_fetch_sub(&g_live_allocations[scope], 1, __ATOMIC_RELAXED);
+    free(((void **)p_memory)[-1]);
+}
+
+VriDevice test_device_create(bool validation) {
+    static VriAdapterProps adapter_props;
+    uint32_t               adapter_count = 1;
+    if (vri_adapters_enumerate(&adapter_props, &adapter_count) != VRI_SUCCESS) {
+        fprintf(stderr, "vri_adapters_enumerate failed\n");
+        exit(1);
+    }
+
+    VriQueueDesc  queue_desc = {.type = VRI_QUEUE_TYPE_GRAPHICS, .count = 1};
+    VriDeviceDesc device_desc = {
+        .backend = VRI_BACKEND_NONE,
+        .p_adapter_props = &adapter_props,
+        .p_queue_descs = &queue_desc,
+        .queue_desc_count = 1,
+        .debug_callback = {.pfn_message_callback = message_callback},
+        .allocation_callback = {.pfn_allocate = allocate, .pfn_free = deallocate},
+        .enable_api_validation = validation ? VRI_TRUE : VRI_FALSE,
+    };
+
+    VriDevice device = VRI_NULL_HANDLE;
+    if (vri_device_create(&device_desc, &device) != VRI_SUCCESS) {
+        fprintf(stderr, "vri_device_create failed\n");
+        exit(1);
+    }
+    return device;
+}
+
+uint32_t test_take_errors(void) {
+    uint32_t errors = g_errors;
+    g_errors = 0;
+    return errors;
+}
+
+int64_t test_live_allocations(VriAllocationScope scope) {
+    return __atomic_load_n(&g_live_allocations[scope], __ATOMIC_RELAXED);
+}
+
+int test_finish(const char *p_name) {
+    if (g_failures) {
+        fprintf(stderr, "%s: %u checks failed\n", p_name, g_failures);
+        return 1;
+    }
+    printf("%s: passed\n", p_name);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vri/vri.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Check macros and device setup shared by the VRI test programs. A failed
+// check prints where it failed and the program carries on, test_finish turns
+// the failure count into the exit code.
+
+#define TEST_CHECK(condition)                                                                                                                                  \
+    do {                                                                                                                                                       \
+        if (!(condition)) test_fail(__FILE__, __LINE__, #condition);                                                                                           \
+    } while (0)
+
+#define TEST_CHECK_RESULT(expression) TEST_CHECK((expression) == VRI_SUCCESS)
+
+void test_fail(const char *p_file, int line, const char *p_condition);
+
+// Headless device with one graphics queue. Errors reported through the debug
+// callback are counted, test_take_errors returns the count since the last call.
+// Its allocator counts what's live in every scope.
+VriDevice test_device_create(bool validation);
+uint32_t  test_take_errors(void);
+int64_t   test_live_allocations(VriAllocationScope scope);
+
+// Returns the process exit code, non-zero if any check failed
+int test_finish(const char *p_name);
@@ -7,12 +7,14 @@ set_warnings("all", "error", "extra", "pedantic")
 if is_mode("debug") then
     set_policy("build.sanitizer.address", true)
     set_policy("build.sanitizer.undefined", true)
+    add_defines("VRI_ENABLE_OBJECT_TRACKING")
 end
 
+if is_plat("windows") then
 target("chroma-scopes")
     set_kind("binary")
     add_includedirs("include", "external")
-    add_files("src/**.c", "examples/triangle/*.c", "external/**.c")
+    add_files("src/core/*.c", "src/backends/d3d11/*.c", "examples/triangle/*.c", "external/**.c")
     add_syslinks("d3d11", "d3dcompiler", "dxgi", "uuid", "dxguid", "shcore", "winmm", "gdi32")
 
     add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
@@ -22,3 +24,92 @@ target("chroma-scopes")
     end
 
     set_rundir(os.projectdir())
+target_end()
+end
+
+-- Microbenchmarks over the headless backend, builds on every platform
+target("vri-bench")
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("src/core/*.c", "src/backends/none/*.c", "bench/vri_bench.c", "bench/bench_util.c")
+
+    add_defines("VRI_ENABLE_NONE_SUPPORT")
+    if is_plat("windows") then
+        add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
+    else
+        add_syslinks("pthread", "m")
+    end
+
+    set_rundir(os.projectdir())
+
+-- vri-bench with the public functions calling the backend directly, for comparing against the dispatch tables
+target("vri-bench-single")
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("src/core/*.c", "src/backends/none/*.c", "bench/vri_bench.c", "bench/bench_util.c")
+    set_policy("build.optimization.lto", true)
+
+    add_defines("VRI_ENABLE_NONE_SUPPORT", "VRI_SINGLE_BACKEND")
+    if is_plat("windows") then
+        add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
+    else
+        add_syslinks("pthread", "m")
+    end
+
+    set_rundir(os.projectdir())
+
+-- End-to-end frame benchmark over a synthetic scene, also headless
+target("vri-scene-bench")
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("src/core/*.c", "src/backends/none/*.c", "bench/vri_scene_bench.c", "bench/bench_util.c")
+
+    add_defines("VRI_ENABLE_NONE_SUPPORT")
+    if is_plat("windows") then
+        add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
+    else
+        add_syslinks("pthread", "m")
+    end
+
+    set_rundir(os.projectdir())
+
+-- Replays traces written by the capture layer, headless unless told otherwise
+target("vri-replay")
+    set_kind("binary")
+    add_includedirs("include", "src/core")
+    add_files("src/core/*.c", "src/backends/none/*.c", "bench/vri_replay.c", "bench/bench_util.c")
+
+    add_defines("VRI_ENABLE_NONE_SUPPORT")
+    if is_plat("windows") then
+        add_files("src/backends/d3d11/*.c")
+        add_syslinks("d3d11", "d3dcompiler", "dxgi", "uuid", "dxguid", "user32")
+        add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
+        add_defines("VRI_ENABLE_D3D11_SUPPORT")
+    else
+        add_syslinks("pthread", "m")
+    end
+
+    set_rundir(os.projectdir())
+
+-- Behavior tests over the headless backend, one target per tests/test_*.c, run with `xmake test`
+for _, file in ipairs(os.files("tests/test_*.c")) do
+    local name = path.basename(file)
+    if name ~= "test_util" then
+        target(name:gsub("_", "-"))
+            set_kind("binary")
+            set_default(false)
+            add_includedirs("include", "src/core")
+            add_files("src/core/*.c", "src/backends/none/*.c", file, "tests/test_util.c")
+            add_tests("default")
+
+            add_defines("VRI_ENABLE_NONE_SUPPORT")
+            if is_plat("windows") then
+                add_defines("WINVER=0x0A00", "_WIN32_WINNT=0x0A00")
+            else
+                add_syslinks("pthread", "m")
+            end
+
+            set_rundir(os.projectdir())
+        target_end()
+    end
+end